@@ -29,6 +29,8 @@
 #include <linux/sched.h>            // task_struct
 #include <linux/numa.h>             // NUMA_NO_NODE
 #include <linux/semaphore.h>
+#include <linux/mutex.h>
+#include <linux/wait.h>
 
 #include "conftest.h"
 
@@ -50,6 +52,44 @@ struct nv_kthread_q_item
     struct list_head q_list_node;
     nv_q_func_t function_to_run;
     void *function_args;
+
+    // Only used by nv_kthread_pool: whether the item is queued in any of the
+    // worker deques of the pool, and the flush epoch it was scheduled in.
+    atomic_t q_pending;
+    int q_epoch;
+};
+
+struct nv_kthread_pool_worker
+{
+    // Deque of the items scheduled to this worker. The worker runs items from
+    // the head, and other workers steal items from the tail.
+    struct list_head q_list_head;
+    spinlock_t q_lock;
+
+    struct nv_kthread_pool *pool;
+    struct task_struct *q_kthread;
+    unsigned index;
+    int node;
+};
+
+struct nv_kthread_pool
+{
+    struct nv_kthread_pool_worker *workers;
+    unsigned num_workers;
+    atomic_t next_worker;
+
+    // This is a counting semaphore. It gets incremented and decremented
+    // exactly once for each item that is added to any of the worker deques.
+    struct semaphore q_sem;
+    atomic_t main_loop_should_exit;
+
+    // Number of items scheduled and not yet completed, for each of the two
+    // flush epochs. nv_kthread_pool_flush() switches new items to the other
+    // epoch, and waits for the count of the previous one to drop to zero.
+    atomic_t q_in_flight[2];
+    int flush_epoch;
+    struct mutex flush_lock;
+    wait_queue_head_t flush_wq;
 };
 
 
@@ -26,8 +26,10 @@
 
 struct nv_kthread_q;
 struct nv_kthread_q_item;
+struct nv_kthread_pool;
 typedef struct nv_kthread_q nv_kthread_q_t;
 typedef struct nv_kthread_q_item nv_kthread_q_item_t;
+typedef struct nv_kthread_pool nv_kthread_pool_t;
 
 typedef void (*nv_q_func_t)(void *args);
 
@@ -84,6 +86,21 @@ typedef void (*nv_q_func_t)(void *args);
 //    The nv_kthread_q_stop() routine will flush the queue, and safely stop
 //    the kthread, before returning.
 //
+// 5. Pools
+//
+//    An nv_kthread_pool is serviced by several kthreads ("workers") instead
+//    of one, for callers that need queue items to run in parallel. Each worker
+//    has its own deque of items, and an idle worker steals items from the
+//    deques of the other workers, preferring workers on its own NUMA node. Queue
+//    items can be given a NUMA node hint, in which case they are queued to a
+//    worker running on that node.
+//
+//    The pool API mirrors the queue API: nv_kthread_pool_init(),
+//    nv_kthread_pool_schedule_q_item(), nv_kthread_pool_flush() and
+//    nv_kthread_pool_stop() have the same rules and guarantees as their
+//    nv_kthread_q counterparts, except that items scheduled to a pool are run
+//    concurrently and in no particular order.
+//
 ////////////////////////////////////////////////////////////////////////////////
 
 //
@@ -199,6 +216,74 @@ void nv_kthread_q_item_init(nv_kthread_q_item_t *q_item,
 int nv_kthread_q_schedule_q_item(nv_kthread_q_t *q,
                                  nv_kthread_q_item_t *q_item);
 
+//
+// Initializes a pool serviced by num_workers kthreads, or by one kthread per
+// online CPU if num_workers is 0. Workers are spread across the NUMA nodes
+// that have CPUs, and each of them is restricted to the CPUs of its node. The
+// kthread stacks are preferably allocated on the same node.
+//
+// Like nv_kthread_q_init(), this returns a Linux kernel (negative) errno on
+// failure, and zero on success. It is safe to call nv_kthread_pool_stop() on a
+// pool that nv_kthread_pool_init() failed for, or that has been
+// zero-initialized.
+//
+// The workers show up as qname/<index> via the ps(1) utility.
+//
+int nv_kthread_pool_init(nv_kthread_pool_t *pool,
+                         const char *qname,
+                         unsigned num_workers);
+
+//
+// Same as nv_kthread_pool_init(), except that all of the workers run on, and
+// preferably have their stacks allocated on, the given NUMA node.
+// NV_KTHREAD_NO_NODE is the same as calling nv_kthread_pool_init().
+//
+int nv_kthread_pool_init_on_node(nv_kthread_pool_t *pool,
+                                 const char *qname,
+                                 unsigned num_workers,
+                                 int preferred_node);
+
+//
+// Flushes the pool and stops all of its kthreads, with the same rules as
+// nv_kthread_q_stop().
+//
+void nv_kthread_pool_stop(nv_kthread_pool_t *pool);
+
+//
+// All items that were scheduled to the pool before nv_kthread_pool_flush was
+// called, and all items scheduled by those items, will get run before this
+// function returns. Like nv_kthread_q_flush(), this waits twice, so the same
+// pattern can be used to stop self-rescheduling q_items.
+//
+// Concurrent flushes of the same pool are serialized.
+//
+void nv_kthread_pool_flush(nv_kthread_pool_t *pool);
+
+//
+// Schedules a q_item initialized with nv_kthread_q_item_init() to run on one
+// of the workers of the pool, preferably one running on the given NUMA node.
+// The item is queued to a worker of that node when the pool has one, but it
+// may still be stolen by a worker on another node if those are all busy.
+// NV_KTHREAD_NO_NODE means no preference.
+//
+// The same rules as for nv_kthread_q_schedule_q_item() apply, including
+// calling it from interrupt context and rescheduling the q_item from its own
+// callback. A q_item must not be scheduled to a pool and to a queue at the
+// same time.
+//
+// Returns true (non-zero) if the item was actually scheduled, and false if it
+// was already pending in the pool or the pool is not running.
+//
+int nv_kthread_pool_schedule_q_item_on_node(nv_kthread_pool_t *pool,
+                                            nv_kthread_q_item_t *q_item,
+                                            int preferred_node);
+
+//
+// Same as nv_kthread_pool_schedule_q_item_on_node() with no NUMA preference.
+//
+int nv_kthread_pool_schedule_q_item(nv_kthread_pool_t *pool,
+                                    nv_kthread_q_item_t *q_item);
+
 // Built-in test. Returns -1 if any subtest failed, or 0 upon success.
 int nv_kthread_q_run_self_test(void);
 
@@ -1110,6 +1110,19 @@ static inline void *nv_kmem_cache_zalloc(struct kmem_cache *k, gfp_t flags)
 #endif
 }
 
+static inline void *nv_kmem_cache_zalloc_node(struct kmem_cache *k, gfp_t flags, int node)
+{
+#if defined(NV_KMEM_CACHE_HAS_KOBJ_REMOVE_WORK) && !defined(NV_SYSFS_SLAB_UNLINK_PRESENT)
+    /* See nv_kmem_cache_zalloc() */
+    void *object = kmem_cache_alloc_node(k, flags, node);
+    if (object)
+        memset(object, 0, kmem_cache_size(k));
+    return object;
+#else
+    return kmem_cache_alloc_node(k, flags | __GFP_ZERO, node);
+#endif
+}
+
 static inline int nv_kmem_cache_alloc_stack_atomic(nvidia_stack_t **stack)
 {
     nvidia_stack_t *sp = NULL;
@@ -1601,6 +1614,12 @@ typedef struct nv_linux_state_s {
     NvBool all_mappings_revoked;
     NvBool safe_to_mmap;
     NvBool gpu_wakeup_callback_needed;
+    struct {
+        NvU64 revocations;   /* times the mappings were revoked */
+        NvU64 faults;        /* faults that reinstated mappings */
+        NvU64 mapped_pages;  /* pages reinstated by faults */
+        NvU64 mmapped_pages; /* pages of the VMAs created by mmap() */
+    } mmap_fault_stats;
 
     /* Per-device notifier block for ACPI events */
     struct notifier_block acpi_nb;
@@ -1822,6 +1841,9 @@ extern NvU32 NVreg_EnableUserNUMAManagement;
 extern NvU32 NVreg_RegisterPCIDriver;
 extern NvU32 NVreg_EnableResizableBar;
 extern NvU32 NVreg_EnableNonblockingOpen;
+extern NvU32 NVreg_UncachedPagePoolSize;
+extern NvU32 NVreg_MmapFaultWindowSize;
+extern NvU32 NVreg_P2pPageTableCache;
 
 extern NvU32 num_probed_nv_devices;
 extern NvU32 num_nv_devices;
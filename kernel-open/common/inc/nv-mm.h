@@ -58,6 +58,7 @@ typedef int vm_fault_t;
         #define NV_PIN_USER_PAGES pin_user_pages
     #endif // NV_PIN_USER_PAGES_HAS_ARGS_VMAS
     #define NV_UNPIN_USER_PAGE unpin_user_page
+    #define NV_UNPIN_USER_PAGES_DIRTY_LOCK unpin_user_pages_dirty_lock
 #else
     #define NV_PIN_USER_PAGES NV_GET_USER_PAGES
     #define NV_UNPIN_USER_PAGE put_page
@@ -57,6 +57,7 @@ static inline void nv_free_msix_irq(nv_linux_state_t *nvl)
 
     for (i = 0; i < nvl->num_intr; i++)
     {
+        irq_set_affinity_hint(nvl->msix_entries[i].vector, NULL);
         free_irq(nvl->msix_entries[i].vector, (void *)nvl);
     }
 }
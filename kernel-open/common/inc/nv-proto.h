@@ -51,6 +51,9 @@ NV_STATUS   nv_alloc_contig_pages       (nv_state_t *, nv_alloc_t *);
 void        nv_free_contig_pages        (nv_alloc_t *);
 NV_STATUS   nv_alloc_system_pages       (nv_state_t *, nv_alloc_t *);
 void        nv_free_system_pages        (nv_alloc_t *);
+int         nv_uc_page_pool_init        (void);
+void        nv_uc_page_pool_exit        (void);
+void        nv_uc_page_pool_print       (struct seq_file *);
 
 int         nv_uvm_init                 (void);
 void        nv_uvm_exit                 (void);
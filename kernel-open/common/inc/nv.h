@@ -954,6 +954,9 @@ char*      NV_API_CALL  rm_get_gpu_uuid          (nvidia_stack_t *, nv_state_t *
 const NvU8* NV_API_CALL rm_get_gpu_uuid_raw      (nvidia_stack_t *, nv_state_t *);
 void       NV_API_CALL  rm_set_rm_firmware_requested(nvidia_stack_t *, nv_state_t *);
 void       NV_API_CALL  rm_get_firmware_version  (nvidia_stack_t *, nv_state_t *, char *, NvLength);
+void       NV_API_CALL  rm_get_control_cache_stats(nvidia_stack_t *, char *, NvLength);
+void       NV_API_CALL  rm_get_gpu_lock_times    (nvidia_stack_t *, char *, NvLength);
+void       NV_API_CALL  rm_get_lock_contention   (nvidia_stack_t *, char *, NvLength);
 void       NV_API_CALL  rm_cleanup_file_private  (nvidia_stack_t *, nv_state_t *, nv_file_private_t *);
 void       NV_API_CALL  rm_unbind_lock           (nvidia_stack_t *, nv_state_t *);
 NV_STATUS  NV_API_CALL  rm_read_registry_dword   (nvidia_stack_t *, nv_state_t *, const char *, NvU32 *);
@@ -759,6 +759,8 @@ typedef struct UvmPmaStatistics_tag
     volatile NvU64 numPages2mProtected;       // PMA-wide 2MB pages count in protected memory
     volatile NvU64 numFreePages64kProtected;  // PMA-wide free 64KB page count in protected memory
     volatile NvU64 numFreePages2mProtected;   // PMA-wide free 2MB pages count in protected memory
+    volatile NvU64 numScrubPendingPages64k;   // PMA-wide 64KB page count waiting to be scrubbed
+    volatile NvU64 numScrubbedPages64k;       // PMA-wide 64KB page count scrubbed so far
 } UvmPmaStatistics;
 
 /*******************************************************************************
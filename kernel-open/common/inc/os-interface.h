@@ -75,6 +75,7 @@ NvU64       NV_API_CALL  os_get_current_tick_hr      (void);
 NvU64       NV_API_CALL  os_get_tick_resolution      (void);
 NV_STATUS   NV_API_CALL  os_delay                    (NvU32);
 NV_STATUS   NV_API_CALL  os_delay_us                 (NvU32);
+NV_STATUS   NV_API_CALL  os_sleep_us                 (NvU32);
 NvU64       NV_API_CALL  os_get_cpu_frequency        (void);
 NvU32       NV_API_CALL  os_get_current_process      (void);
 void        NV_API_CALL  os_get_current_process_name (char *, NvU32);
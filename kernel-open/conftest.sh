@@ -626,6 +626,73 @@ compile_test() {
             compile_check_conftest "$CODE" "NV_SET_PAGES_ARRAY_UC_PRESENT" "" "functions"
         ;;
 
+        shrinker_alloc)
+            #
+            # Determine if the shrinker_alloc() function is present.
+            #
+            # Added in v6.7, along with shrinker_register() and
+            # shrinker_free(), replacing register_shrinker() and
+            # unregister_shrinker().
+            #
+            CODE="
+            #include <linux/mm.h>
+            void conftest_shrinker_alloc(void) {
+                shrinker_alloc();
+            }"
+
+            compile_check_conftest "$CODE" "NV_SHRINKER_ALLOC_PRESENT" "" "functions"
+        ;;
+
+        register_shrinker_has_fmt_arg)
+            #
+            # Determine if register_shrinker() takes a format string for the
+            # name of the shrinker, added in v6.0 for the shrinker debugfs
+            # interface.
+            #
+            CODE="
+            #include <linux/mm.h>
+            int conftest_register_shrinker_has_fmt_arg(struct shrinker *s) {
+                return register_shrinker(s, \"%s\", \"conftest\");
+            }"
+
+            compile_check_conftest "$CODE" "NV_REGISTER_SHRINKER_HAS_FMT_ARG" "" "types"
+        ;;
+
+        alloc_pages_bulk_array_node)
+            #
+            # Determine if the alloc_pages_bulk_array_node() function is
+            # present.
+            #
+            # Added in v5.14 for the vmalloc bulk page allocations, and renamed
+            # to alloc_pages_bulk_node() once the list-based interface of the
+            # bulk page allocator was dropped.
+            #
+            CODE="
+            #include <linux/gfp.h>
+            void conftest_alloc_pages_bulk_array_node(void) {
+                alloc_pages_bulk_array_node();
+            }"
+
+            compile_check_conftest "$CODE" "NV_ALLOC_PAGES_BULK_ARRAY_NODE_PRESENT" "" "functions"
+        ;;
+
+        alloc_pages_bulk_node)
+            #
+            # Determine if the alloc_pages_bulk_node() function is present.
+            #
+            # Replaced alloc_pages_bulk_array_node() when the list-based
+            # interface of the bulk page allocator was dropped. Before that, a
+            # list-based alloc_pages_bulk() existed but no node variant of it.
+            #
+            CODE="
+            #include <linux/gfp.h>
+            void conftest_alloc_pages_bulk_node(void) {
+                alloc_pages_bulk_node();
+            }"
+
+            compile_check_conftest "$CODE" "NV_ALLOC_PAGES_BULK_NODE_PRESENT" "" "functions"
+        ;;
+
         flush_cache_all)
             #
             # Determine if flush_cache_all() function is present
@@ -1903,6 +1970,61 @@ compile_test() {
             compile_check_conftest "$CODE" "NV_VMF_INSERT_PFN_PROT_PRESENT" "" "functions"
         ;;
 
+        vmf_insert_pfn_pmd)
+            #
+            # Determine if vmf_insert_pfn_pmd function is present
+            #
+            # Renamed from vm_insert_pfn_pmd() in v4.20, and changed to take
+            # the struct vm_fault pointer instead of the VMA, address and PMD
+            # in v5.2.
+            #
+            CODE="
+            #include <linux/mm.h>
+            #include <linux/huge_mm.h>
+            void conftest_vmf_insert_pfn_pmd() {
+                vmf_insert_pfn_pmd();
+            }"
+
+            compile_check_conftest "$CODE" "NV_VMF_INSERT_PFN_PMD_PRESENT" "" "functions"
+        ;;
+
+        vmf_insert_pfn_pud)
+            #
+            # Determine if vmf_insert_pfn_pud function is present
+            #
+            # Added in v4.20, and changed to take the struct vm_fault pointer
+            # instead of the VMA, address and PUD in v5.2.
+            #
+            CODE="
+            #include <linux/mm.h>
+            #include <linux/huge_mm.h>
+            void conftest_vmf_insert_pfn_pud() {
+                vmf_insert_pfn_pud();
+            }"
+
+            compile_check_conftest "$CODE" "NV_VMF_INSERT_PFN_PUD_PRESENT" "" "functions"
+        ;;
+
+        vmf_insert_pfn_pmd_has_pfn_t_arg)
+            #
+            # Determine if vmf_insert_pfn_pmd() takes a pfn_t or a plain pfn.
+            #
+            # vmf_insert_pfn_pmd() and vmf_insert_pfn_pud() took a pfn_t until
+            # the pfn_t type was removed, after which they take an unsigned
+            # long pfn.
+            #
+            CODE="
+            #include <linux/mm.h>
+            #include <linux/huge_mm.h>
+            #include <linux/pfn_t.h>
+            vm_fault_t conftest_vmf_insert_pfn_pmd_has_pfn_t_arg(struct vm_fault *vmf,
+                                                                  pfn_t pfn) {
+                return vmf_insert_pfn_pmd(vmf, pfn, false);
+            }"
+
+            compile_check_conftest "$CODE" "NV_VMF_INSERT_PFN_PMD_HAS_PFN_T_ARG" "" "types"
+        ;;
+
         drm_atomic_available)
             #
             # Determine if the DRM atomic modesetting subsystem is usable
@@ -3535,6 +3657,26 @@ compile_test() {
             compile_check_conftest "$CODE" "NV_VM_OPS_FAULT_REMOVED_VMA_ARG" "" "types"
         ;;
 
+        vm_ops_huge_fault_has_order_arg)
+            #
+            # Determine if vma.vm_ops.huge_fault takes the order of the fault
+            # instead of an enum page_entry_size.
+            #
+            # enum page_entry_size was removed, and huge_fault changed to take
+            # the order, in v6.6. The redefinition of the enum below fails to
+            # compile on kernels that still have it.
+            #
+            CODE="
+            #include <linux/mm.h>
+            enum page_entry_size { conftest_page_entry_size };
+            void conftest_vm_ops_huge_fault_has_order_arg(void) {
+                struct vm_operations_struct vm_ops;
+                (void)vm_ops.huge_fault;
+            }"
+
+            compile_check_conftest "$CODE" "NV_VM_OPS_HUGE_FAULT_HAS_ORDER_ARG" "" "types"
+        ;;
+
         pnv_npu2_init_context)
             #
             # Determine if the pnv_npu2_init_context() function is
@@ -4071,6 +4213,35 @@ compile_test() {
             fi
         ;;
 
+        dma_buf_ops_has_pin)
+            #
+            # Determine if pin/unpin exist in dma_buf_ops. Exporters that
+            # implement them are dynamic exporters.
+            #
+            # Added along with dynamic DMA-buf handling in v5.7.
+            #
+            echo "$CONFTEST_PREAMBLE
+            #include <linux/dma-buf.h>
+            int conftest_dma_buf_ops_has_pin(void) {
+                return offsetof(struct dma_buf_ops, pin);
+            }
+            int conftest_dma_buf_ops_has_unpin(void) {
+                return offsetof(struct dma_buf_ops, unpin);
+            }" > conftest$$.c
+
+            $CC $CFLAGS -c conftest$$.c > /dev/null 2>&1
+            rm -f conftest$$.c
+
+            if [ -f conftest$$.o ]; then
+                echo "#define NV_DMA_BUF_OPS_HAS_PIN" | append_conftest "types"
+                rm -f conftest$$.o
+                return
+            else
+                echo "#undef NV_DMA_BUF_OPS_HAS_PIN" | append_conftest "types"
+                return
+            fi
+        ;;
+
         dma_buf_attachment_has_peer2peer)
             #
             # Determine if peer2peer is present in struct dma_buf_attachment.
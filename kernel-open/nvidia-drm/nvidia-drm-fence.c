@@ -1408,23 +1408,28 @@ __nv_drm_semsurf_ctx_add_pending(struct nv_drm_semsurf_fence_ctx *ctx,
 
     spin_lock_irqsave(&ctx->lock, flags);
 
-    list_for_each(pending, &ctx->pending_fences) {
+    /*
+     * Fences are usually created in increasing seqno order, so search for the
+     * insertion point from the end of the list. This keeps fences with equal
+     * seqnos in creation order.
+     */
+    list_for_each_prev(pending, &ctx->pending_fences) {
         struct nv_drm_semsurf_fence *pending_fence =
             list_entry(pending, typeof(*pending_fence), pending_node);
-        if (__nv_drm_get_semsurf_fence_seqno(pending_fence) >
+        if (__nv_drm_get_semsurf_fence_seqno(pending_fence) <=
             __nv_drm_get_semsurf_fence_seqno(nv_fence)) {
-            /* Inserts 'nv_fence->pending_node' before 'pending' */
-            list_add_tail(&nv_fence->pending_node, pending);
+            /* Inserts 'nv_fence->pending_node' after 'pending' */
+            list_add(&nv_fence->pending_node, pending);
             break;
         }
     }
 
     if (list_empty(&nv_fence->pending_node)) {
         /*
-         * Inserts 'fence->pending_node' at the end of 'ctx->pending_fences',
-         * or as the head if the list is empty
+         * Inserts 'fence->pending_node' at the head of 'ctx->pending_fences',
+         * as all pending fences have a later seqno or the list is empty
          */
-        list_add_tail(&nv_fence->pending_node, &ctx->pending_fences);
+        list_add(&nv_fence->pending_node, &ctx->pending_fences);
     }
 
     /* Fence is live starting... now! */
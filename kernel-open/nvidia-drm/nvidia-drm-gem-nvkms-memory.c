@@ -78,20 +78,12 @@ static int __nv_drm_gem_nvkms_mmap(struct nv_drm_gem_object *nv_gem,
                 drm_vma_node_size(&nv_gem->base.vma_node) << PAGE_SHIFT, vma);
 }
 
-static vm_fault_t __nv_drm_gem_nvkms_handle_vma_fault(
-    struct nv_drm_gem_object *nv_gem,
-    struct vm_area_struct *vma,
-    struct vm_fault *vmf)
-{
 #if defined(NV_DRM_ATOMIC_MODESET_AVAILABLE)
-    struct nv_drm_gem_nvkms_memory *nv_nvkms_memory =
-        to_nv_nvkms_memory(nv_gem);
-    unsigned long address = nv_page_fault_va(vmf);
-    struct drm_gem_object *gem = vma->vm_private_data;
-    unsigned long page_offset, pfn;
-    vm_fault_t ret;
-
-    page_offset = vmf->pgoff - drm_vma_node_start(&gem->vma_node);
+static unsigned long __nv_drm_gem_nvkms_page_pfn(
+    struct nv_drm_gem_nvkms_memory *nv_nvkms_memory,
+    unsigned long page_offset)
+{
+    unsigned long pfn;
 
     if (nv_nvkms_memory->pages_count == 0) {
         pfn = (unsigned long)(uintptr_t)nv_nvkms_memory->pPhysicalAddress;
@@ -112,6 +104,16 @@ static vm_fault_t __nv_drm_gem_nvkms_handle_vma_fault(
         pfn = page_to_pfn(nv_nvkms_memory->pages[page_offset]);
     }
 
+    return pfn;
+}
+
+static vm_fault_t __nv_drm_gem_nvkms_insert_pfn(
+    struct vm_area_struct *vma,
+    unsigned long address,
+    unsigned long pfn)
+{
+    vm_fault_t ret;
+
 #if defined(NV_VMF_INSERT_PFN_PRESENT)
     ret = vmf_insert_pfn(vma, address, pfn);
 #else
@@ -134,6 +136,57 @@ static vm_fault_t __nv_drm_gem_nvkms_handle_vma_fault(
             break;
     }
 #endif /* defined(NV_VMF_INSERT_PFN_PRESENT) */
+    return ret;
+}
+#endif /* defined(NV_DRM_ATOMIC_MODESET_AVAILABLE) */
+
+static vm_fault_t __nv_drm_gem_nvkms_handle_vma_fault(
+    struct nv_drm_gem_object *nv_gem,
+    struct vm_area_struct *vma,
+    struct vm_fault *vmf)
+{
+#if defined(NV_DRM_ATOMIC_MODESET_AVAILABLE)
+    struct nv_drm_gem_nvkms_memory *nv_nvkms_memory =
+        to_nv_nvkms_memory(nv_gem);
+    unsigned long address = nv_page_fault_va(vmf);
+    struct drm_gem_object *gem = vma->vm_private_data;
+    unsigned long page_offset;
+    vm_fault_t ret;
+
+    page_offset = vmf->pgoff - drm_vma_node_start(&gem->vma_node);
+
+    ret = __nv_drm_gem_nvkms_insert_pfn(
+            vma, address,
+            __nv_drm_gem_nvkms_page_pfn(nv_nvkms_memory, page_offset));
+
+#if defined(NV_LINUX)
+    /*
+     * Also map the pages following the faulting one, within both the VMA and
+     * the object. Failing to map one of them is not an error for this fault,
+     * it just stops the prefault.
+     */
+    if (ret == VM_FAULT_NOPAGE) {
+        unsigned long num_pages = (vma->vm_end - address) >> PAGE_SHIFT;
+        unsigned long obj_pages = (nv_nvkms_memory->pages_count != 0) ?
+                                  nv_nvkms_memory->pages_count :
+                                  (gem->size >> PAGE_SHIFT);
+        unsigned long i;
+
+        num_pages = min(num_pages, obj_pages - page_offset);
+        num_pages = min(num_pages, (unsigned long)NV_DRM_GEM_PREFAULT_PAGES);
+
+        for (i = 1; i < num_pages; i++) {
+            if (__nv_drm_gem_nvkms_insert_pfn(
+                    vma, address + (i << PAGE_SHIFT),
+                    __nv_drm_gem_nvkms_page_pfn(nv_nvkms_memory,
+                                                page_offset + i)) !=
+                VM_FAULT_NOPAGE) {
+                break;
+            }
+        }
+    }
+#endif /* defined(NV_LINUX) */
+
     return ret;
 #endif /* defined(NV_DRM_ATOMIC_MODESET_AVAILABLE) */
     return VM_FAULT_SIGBUS;
@@ -103,25 +103,17 @@ static int __nv_drm_gem_user_memory_mmap(struct nv_drm_gem_object *nv_gem,
     return 0;
 }
 
-static vm_fault_t __nv_drm_gem_user_memory_handle_vma_fault(
-    struct nv_drm_gem_object *nv_gem,
+static vm_fault_t __nv_drm_gem_user_memory_insert_page(
     struct vm_area_struct *vma,
-    struct vm_fault *vmf)
+    unsigned long address,
+    struct page *page)
 {
-    struct nv_drm_gem_user_memory *nv_user_memory = to_nv_user_memory(nv_gem);
-    unsigned long address = nv_page_fault_va(vmf);
-    struct drm_gem_object *gem = vma->vm_private_data;
-    unsigned long page_offset;
     vm_fault_t ret;
 
-    page_offset = vmf->pgoff - drm_vma_node_start(&gem->vma_node);
-
-    BUG_ON(page_offset >= nv_user_memory->pages_count);
-
 #if !defined(NV_LINUX)
-    ret = vmf_insert_pfn(vma, address, page_to_pfn(nv_user_memory->pages[page_offset]));
+    ret = vmf_insert_pfn(vma, address, page_to_pfn(page));
 #else /* !defined(NV_LINUX) */
-    ret = vm_insert_page(vma, address, nv_user_memory->pages[page_offset]);
+    ret = vm_insert_page(vma, address, page);
     switch (ret) {
         case 0:
         case -EBUSY:
@@ -144,6 +136,51 @@ static vm_fault_t __nv_drm_gem_user_memory_handle_vma_fault(
     return ret;
 }
 
+static vm_fault_t __nv_drm_gem_user_memory_handle_vma_fault(
+    struct nv_drm_gem_object *nv_gem,
+    struct vm_area_struct *vma,
+    struct vm_fault *vmf)
+{
+    struct nv_drm_gem_user_memory *nv_user_memory = to_nv_user_memory(nv_gem);
+    unsigned long address = nv_page_fault_va(vmf);
+    struct drm_gem_object *gem = vma->vm_private_data;
+    unsigned long page_offset;
+    vm_fault_t ret;
+
+    page_offset = vmf->pgoff - drm_vma_node_start(&gem->vma_node);
+
+    BUG_ON(page_offset >= nv_user_memory->pages_count);
+
+    ret = __nv_drm_gem_user_memory_insert_page(
+            vma, address, nv_user_memory->pages[page_offset]);
+
+#if defined(NV_LINUX)
+    /*
+     * Also map the pages following the faulting one, within both the VMA and
+     * the object. Failing to map one of them is not an error for this fault,
+     * it just stops the prefault.
+     */
+    if (ret == VM_FAULT_NOPAGE) {
+        unsigned long num_pages = (vma->vm_end - address) >> PAGE_SHIFT;
+        unsigned long i;
+
+        num_pages = min(num_pages, nv_user_memory->pages_count - page_offset);
+        num_pages = min(num_pages, (unsigned long)NV_DRM_GEM_PREFAULT_PAGES);
+
+        for (i = 1; i < num_pages; i++) {
+            if (__nv_drm_gem_user_memory_insert_page(
+                    vma, address + (i << PAGE_SHIFT),
+                    nv_user_memory->pages[page_offset + i]) !=
+                VM_FAULT_NOPAGE) {
+                break;
+            }
+        }
+    }
+#endif /* defined(NV_LINUX) */
+
+    return ret;
+}
+
 static int __nv_drm_gem_user_create_mmap_offset(
     struct nv_drm_device *nv_dev,
     struct nv_drm_gem_object *nv_gem,
@@ -47,6 +47,13 @@
 
 #include "linux/dma-buf.h"
 
+/*
+ * Maximum number of pages handle_vma_fault() maps per fault, starting at the
+ * faulting page, so that linear CPU access to a large object doesn't fault on
+ * every page.
+ */
+#define NV_DRM_GEM_PREFAULT_PAGES 16
+
 struct nv_drm_gem_object;
 
 struct nv_drm_gem_object_funcs {
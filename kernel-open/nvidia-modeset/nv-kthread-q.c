@@ -29,6 +29,8 @@
 #include <linux/completion.h>
 #include <linux/module.h>
 #include <linux/mm.h>
+#include <linux/slab.h>
+#include <linux/cpumask.h>
 
 #if defined(NV_LINUX_BUG_H_PRESENT)
     #include <linux/bug.h>
@@ -47,6 +49,13 @@
 // named kernel thread (kthread). You can then insert arbitrary functions
 // into the queue, and those functions will be run in the context of the
 // queue's kthread.
+//
+// nv_kthread_pool instances are serviced by several kthreads, each with its own
+// deque. An item is added to the tail of the deque of one worker. Each worker
+// runs items from the head of its own deque, and once that is empty, from the
+// tail of the deques of the other workers. A single counting semaphore for the
+// whole pool tracks the total number of queued items, so that any idle worker
+// gets woken up when an item is scheduled, whichever deque it went to.
 
 #ifndef WARN
     // Only *really* old kernels (2.6.9) end up here. Just use a simple printk
@@ -170,7 +179,7 @@ void nv_kthread_q_stop(nv_kthread_q_t *q)
 // This function is never invoked when there is no NUMA preference (preferred
 // node is NUMA_NO_NODE).
 static struct task_struct *thread_create_on_node(int (*threadfn)(void *data),
-                                                 nv_kthread_q_t *q,
+                                                 void *data,
                                                  int preferred_node,
                                                  const char *q_name)
 {
@@ -182,7 +191,7 @@ static struct task_struct *thread_create_on_node(int (*threadfn)(void *data),
     for (i = 0;; i++) {
         struct page *stack;
 
-        thread[i] = kthread_create_on_node(threadfn, q, preferred_node, q_name);
+        thread[i] = kthread_create_on_node(threadfn, data, preferred_node, q_name);
 
         if (unlikely(IS_ERR(thread[i]))) {
 
@@ -281,6 +290,8 @@ void nv_kthread_q_item_init(nv_kthread_q_item_t *q_item,
     INIT_LIST_HEAD(&q_item->q_list_node);
     q_item->function_to_run = function_to_run;
     q_item->function_args   = function_args;
+    atomic_set(&q_item->q_pending, 0);
+    q_item->q_epoch = 0;
 }
 
 // Returns true (non-zero) if the q_item got scheduled, false otherwise.
@@ -332,3 +343,318 @@ void nv_kthread_q_flush(nv_kthread_q_t *q)
     _raw_q_flush(q);
     _raw_q_flush(q);
 }
+
+// Removes an item from the given worker deque: from the head when the worker
+// serves its own deque, and from the tail when stealing from another worker.
+static nv_kthread_q_item_t *_pool_worker_pop(struct nv_kthread_pool_worker *worker,
+                                             int from_head)
+{
+    nv_kthread_q_item_t *q_item = NULL;
+    unsigned long flags;
+
+    // Unlocked peek, to avoid taking the lock of every worker while stealing.
+    // Missing an item that is being added is fine, since the caller retries.
+    if (list_empty(&worker->q_list_head))
+        return NULL;
+
+    spin_lock_irqsave(&worker->q_lock, flags);
+
+    if (!list_empty(&worker->q_list_head)) {
+        if (from_head)
+            q_item = list_first_entry(&worker->q_list_head, nv_kthread_q_item_t, q_list_node);
+        else
+            q_item = list_last_entry(&worker->q_list_head, nv_kthread_q_item_t, q_list_node);
+
+        list_del_init(&q_item->q_list_node);
+    }
+
+    spin_unlock_irqrestore(&worker->q_lock, flags);
+
+    return q_item;
+}
+
+static nv_kthread_q_item_t *_pool_take_q_item(struct nv_kthread_pool_worker *worker)
+{
+    nv_kthread_pool_t *pool = worker->pool;
+    nv_kthread_q_item_t *q_item;
+    unsigned i, pass;
+
+    // The q_sem semaphore guarantees that at least one item is queued, and
+    // reserved for this worker. However, it can race with items moving
+    // between the time a deque is peeked at and the time another one is, so
+    // keep looking until it is found.
+    while (1) {
+        q_item = _pool_worker_pop(worker, 1);
+        if (q_item)
+            return q_item;
+
+        // Steal from the workers on the same node first.
+        for (pass = 0; pass < 2; pass++) {
+            int same_node = (pass == 0);
+
+            for (i = 1; i < pool->num_workers; i++) {
+                struct nv_kthread_pool_worker *victim;
+
+                victim = &pool->workers[(worker->index + i) % pool->num_workers];
+                if ((victim->node == worker->node) != same_node)
+                    continue;
+
+                q_item = _pool_worker_pop(victim, 0);
+                if (q_item)
+                    return q_item;
+            }
+        }
+
+        cpu_relax();
+    }
+}
+
+static int _pool_main_loop(void *args)
+{
+    struct nv_kthread_pool_worker *worker = (struct nv_kthread_pool_worker *)args;
+    nv_kthread_pool_t *pool = worker->pool;
+    nv_kthread_q_item_t *q_item;
+    nv_q_func_t function_to_run;
+    void *function_args;
+    int epoch;
+
+    while (1) {
+        // See _main_loop() for why this is interruptible.
+        while (down_interruptible(&pool->q_sem))
+            NVQ_WARN("Interrupted during semaphore wait\n");
+
+        if (atomic_read(&pool->main_loop_should_exit))
+            break;
+
+        q_item = _pool_take_q_item(worker);
+
+        // The item may be freed, or rescheduled, by its own callback, so
+        // everything needed after it runs is read before. Clearing q_pending
+        // makes it possible to schedule the item again.
+        function_to_run = q_item->function_to_run;
+        function_args = q_item->function_args;
+        epoch = q_item->q_epoch;
+        smp_mb();
+        atomic_set(&q_item->q_pending, 0);
+
+        function_to_run(function_args);
+
+        if (atomic_dec_and_test(&pool->q_in_flight[epoch]))
+            wake_up_all(&pool->flush_wq);
+    }
+
+    while (!kthread_should_stop())
+        schedule();
+
+    return 0;
+}
+
+static void _pool_stop_workers(nv_kthread_pool_t *pool, unsigned num_workers, int started)
+{
+    unsigned i;
+
+    atomic_set(&pool->main_loop_should_exit, 1);
+
+    // Wake up each kthread so that it can see that it needs to stop. Threads
+    // that were never woken up do not take a semaphore count.
+    if (started) {
+        for (i = 0; i < num_workers; i++)
+            up(&pool->q_sem);
+    }
+
+    for (i = 0; i < num_workers; i++) {
+        kthread_stop(pool->workers[i].q_kthread);
+        pool->workers[i].q_kthread = NULL;
+    }
+}
+
+void nv_kthread_pool_stop(nv_kthread_pool_t *pool)
+{
+    unsigned i;
+
+    // check if pool has been properly initialized
+    if (unlikely(!pool->workers))
+        return;
+
+    nv_kthread_pool_flush(pool);
+
+    // Same as in nv_kthread_q_stop(): the API rules were likely broken if this
+    // fires.
+    for (i = 0; i < pool->num_workers; i++) {
+        if (unlikely(!list_empty(&pool->workers[i].q_list_head)))
+            NVQ_WARN("list not empty after flushing\n");
+    }
+
+    _pool_stop_workers(pool, pool->num_workers, 1);
+
+    kfree(pool->workers);
+    pool->workers = NULL;
+}
+
+int nv_kthread_pool_init_on_node(nv_kthread_pool_t *pool,
+                                 const char *qname,
+                                 unsigned num_workers,
+                                 int preferred_node)
+{
+    unsigned i;
+    int node = preferred_node;
+
+    memset(pool, 0, sizeof(*pool));
+
+    if (num_workers == 0)
+        num_workers = num_online_cpus();
+
+    sema_init(&pool->q_sem, 0);
+    mutex_init(&pool->flush_lock);
+    init_waitqueue_head(&pool->flush_wq);
+
+    pool->workers = kcalloc(num_workers, sizeof(*pool->workers), GFP_KERNEL);
+    if (!pool->workers)
+        return -ENOMEM;
+
+    for (i = 0; i < num_workers; i++) {
+        struct nv_kthread_pool_worker *worker = &pool->workers[i];
+        char name[TASK_COMM_LEN];
+
+        INIT_LIST_HEAD(&worker->q_list_head);
+        spin_lock_init(&worker->q_lock);
+        worker->pool = pool;
+        worker->index = i;
+
+        // Without a preferred node, distribute the workers round-robin across
+        // the nodes with CPUs.
+        if ((preferred_node == NV_KTHREAD_NO_NODE) && (num_online_nodes() > 1)) {
+            node = next_node(node, node_states[N_CPU]);
+            if (node >= MAX_NUMNODES)
+                node = first_node(node_states[N_CPU]);
+        }
+        worker->node = node;
+
+        snprintf(name, sizeof(name), "%s/%u", qname, i);
+
+        if (node == NV_KTHREAD_NO_NODE)
+            worker->q_kthread = kthread_create(_pool_main_loop, worker, "%s", name);
+        else
+            worker->q_kthread = thread_create_on_node(_pool_main_loop, worker, node, name);
+
+        if (IS_ERR(worker->q_kthread)) {
+            int err = PTR_ERR(worker->q_kthread);
+
+            // None of the threads have been woken up yet, so they can just be
+            // stopped.
+            worker->q_kthread = NULL;
+            _pool_stop_workers(pool, i, 0);
+            kfree(pool->workers);
+            pool->workers = NULL;
+
+            return err;
+        }
+
+        if (node != NV_KTHREAD_NO_NODE)
+            set_cpus_allowed_ptr(worker->q_kthread, cpumask_of_node(node));
+    }
+
+    pool->num_workers = num_workers;
+
+    for (i = 0; i < num_workers; i++)
+        wake_up_process(pool->workers[i].q_kthread);
+
+    return 0;
+}
+
+int nv_kthread_pool_init(nv_kthread_pool_t *pool, const char *qname, unsigned num_workers)
+{
+    return nv_kthread_pool_init_on_node(pool, qname, num_workers, NV_KTHREAD_NO_NODE);
+}
+
+static struct nv_kthread_pool_worker *_pool_pick_worker(nv_kthread_pool_t *pool,
+                                                        int preferred_node)
+{
+    unsigned start = (unsigned)atomic_inc_return(&pool->next_worker);
+    unsigned i;
+
+    if (preferred_node != NV_KTHREAD_NO_NODE) {
+        for (i = 0; i < pool->num_workers; i++) {
+            struct nv_kthread_pool_worker *worker;
+
+            worker = &pool->workers[(start + i) % pool->num_workers];
+            if (worker->node == preferred_node)
+                return worker;
+        }
+    }
+
+    return &pool->workers[start % pool->num_workers];
+}
+
+int nv_kthread_pool_schedule_q_item_on_node(nv_kthread_pool_t *pool,
+                                            nv_kthread_q_item_t *q_item,
+                                            int preferred_node)
+{
+    struct nv_kthread_pool_worker *worker;
+    unsigned long flags;
+    int epoch;
+
+    if (unlikely(!pool->workers || atomic_read(&pool->main_loop_should_exit))) {
+        NVQ_WARN("Not allowed: nv_kthread_pool_schedule_q_item was "
+                   "called with a non-alive pool: 0x%p\n", pool);
+        return 0;
+    }
+
+    if (atomic_cmpxchg(&q_item->q_pending, 0, 1) != 0)
+        return 0;
+
+    // Account for the item before it becomes visible to the workers, so that
+    // its completion is always matched by this increment.
+    epoch = READ_ONCE(pool->flush_epoch);
+    q_item->q_epoch = epoch;
+    atomic_inc(&pool->q_in_flight[epoch]);
+
+    worker = _pool_pick_worker(pool, preferred_node);
+
+    spin_lock_irqsave(&worker->q_lock, flags);
+    list_add_tail(&q_item->q_list_node, &worker->q_list_head);
+    spin_unlock_irqrestore(&worker->q_lock, flags);
+
+    up(&pool->q_sem);
+
+    return 1;
+}
+
+int nv_kthread_pool_schedule_q_item(nv_kthread_pool_t *pool,
+                                    nv_kthread_q_item_t *q_item)
+{
+    return nv_kthread_pool_schedule_q_item_on_node(pool, q_item, NV_KTHREAD_NO_NODE);
+}
+
+static void _raw_pool_flush(nv_kthread_pool_t *pool)
+{
+    int epoch;
+
+    mutex_lock(&pool->flush_lock);
+
+    // Items scheduled from now on are accounted in the other epoch. Once all
+    // the items of the previous epoch have completed, everything that was
+    // scheduled before this point has run. The previous flush waited for the
+    // other epoch to drain, so it is empty, short of racing schedules.
+    epoch = pool->flush_epoch;
+    WRITE_ONCE(pool->flush_epoch, !epoch);
+    smp_mb();
+
+    wait_event(pool->flush_wq, atomic_read(&pool->q_in_flight[epoch]) == 0);
+
+    mutex_unlock(&pool->flush_lock);
+}
+
+void nv_kthread_pool_flush(nv_kthread_pool_t *pool)
+{
+    if (unlikely(!pool->workers || atomic_read(&pool->main_loop_should_exit))) {
+        NVQ_WARN("Not allowed: nv_kthread_pool_flush was called after "
+                   "nv_kthread_pool_stop. pool: 0x%p\n", pool);
+        return;
+    }
+
+    // Same as nv_kthread_q_flush(): the second flush covers items scheduled
+    // by the items that the first flush waited for.
+    _raw_pool_flush(pool);
+    _raw_pool_flush(pool);
+}
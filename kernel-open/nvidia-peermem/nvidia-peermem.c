@@ -68,6 +68,10 @@ static int persistent_api_support = NV_MEM_PERSISTENT_API_SUPPORT_DEFAULT;
 module_param(persistent_api_support, int, S_IRUGO);
 MODULE_PARM_DESC(persistent_api_support, "Set level of support for persistent APIs, 0 [legacy] or 1 [default]");
 
+static int large_page_support = 1;
+module_param(large_page_support, int, S_IRUGO);
+MODULE_PARM_DESC(large_page_support, "Merge contiguous GPU pages and report 2MB pages when possible, 0 [disabled] or 1 [default]");
+
 #define peer_err(FMT, ARGS...) printk(KERN_ERR "nvidia-peermem" " %s:%d ERROR " FMT, __FUNCTION__, __LINE__, ## ARGS)
 #ifdef NV_MEM_DEBUG
 #define peer_trace(FMT, ARGS...) printk(KERN_DEBUG "nvidia-peermem" " %s:%d TRACE " FMT, __FUNCTION__, __LINE__, ## ARGS)
@@ -90,6 +94,12 @@ MODULE_PARM_DESC(persistent_api_support, "Set level of support for persistent AP
 #define GPU_PAGE_OFFSET  (GPU_PAGE_SIZE-1)
 #define GPU_PAGE_MASK    (~GPU_PAGE_OFFSET)
 
+#define GPU_LARGE_PAGE_SIZE ((u64)1 << 21)
+
+// Largest length of a merged DMA segment, which must fit in sg_dma_len() and
+// be a multiple of GPU_LARGE_PAGE_SIZE.
+#define NV_MEM_MAX_SEG_SIZE ((u64)1 << 31)
+
 invalidate_peer_memory mem_invalidate_callback;
 static void *reg_handle = NULL;
 static void *reg_handle_nc = NULL;
@@ -99,6 +109,7 @@ static void *reg_handle_nc = NULL;
 struct nv_mem_context {
     u64 pad1;
     struct nvidia_p2p_page_table *page_table;
+    struct nvidia_p2p_page_table *acquire_page_table;
     struct nvidia_p2p_dma_mapping *dma_mapping;
     u64 core_context;
     u64 page_virt_start;
@@ -182,21 +193,42 @@ out:
 static void nv_mem_dummy_callback(void *data)
 {
     struct nv_mem_context *nv_mem_context = (struct nv_mem_context *)data;
+    struct nvidia_p2p_page_table *page_table;
     int ret = 0;
 
     __module_get(THIS_MODULE);
 
-    ret = nvidia_p2p_free_page_table(nv_mem_context->page_table);
+    /* Claim the page table, so that nv_mem_put_acquire_pages() doesn't put it
+     * after it has been freed.
+     */
+    page_table = xchg(&nv_mem_context->acquire_page_table, NULL);
+    if (!page_table)
+        goto out;
+
+    ret = nvidia_p2p_free_page_table(page_table);
     if (ret)
         peer_err("nv_mem_dummy_callback -- error %d while calling nvidia_p2p_free_page_table()\n", ret);
 
+out:
     module_put(THIS_MODULE);
     return;
 }
 
+/* Drop the pages still held since nv_mem_acquire(), if any */
+static int nv_mem_put_acquire_pages(struct nv_mem_context *nv_mem_context)
+{
+    struct nvidia_p2p_page_table *page_table;
+
+    page_table = xchg(&nv_mem_context->acquire_page_table, NULL);
+    if (!page_table)
+        return 0;
+
+    return nvidia_p2p_put_pages(0, 0, nv_mem_context->page_virt_start, page_table);
+}
+
 /* acquire return code: 1 mine, 0 - not mine */
-static int nv_mem_acquire(unsigned long addr, size_t size, void *peer_mem_private_data,
-                          char *peer_mem_name, void **client_context)
+static int nv_mem_acquire_common(int nc, unsigned long addr, size_t size,
+                                 void **client_context)
 {
 
     int ret = 0;
@@ -214,13 +246,17 @@ static int nv_mem_acquire(unsigned long addr, size_t size, void *peer_mem_privat
     nv_mem_context->pad2 = NV_MEM_CONTEXT_MAGIC;
 
     ret = nvidia_p2p_get_pages(0, 0, nv_mem_context->page_virt_start, nv_mem_context->mapped_size,
-                               &nv_mem_context->page_table, nv_mem_dummy_callback, nv_mem_context);
+                               &nv_mem_context->acquire_page_table, nv_mem_dummy_callback, nv_mem_context);
 
     if (ret < 0)
         goto err;
 
-    ret = nvidia_p2p_put_pages(0, 0, nv_mem_context->page_virt_start,
-                               nv_mem_context->page_table);
+    /* The pages are kept until nv_mem_get_pages() pins them again, which then
+     * only takes another reference on the page table cached by the NVIDIA
+     * driver instead of going back to RM. The persistent pages of the nc
+     * client are not shared with this page table, so drop it right away.
+     */
+    ret = nc ? nv_mem_put_acquire_pages(nv_mem_context) : 0;
     if (ret < 0) {
         /* Not expected, however in case callback was called on that buffer just before
             put pages we'll expect to fail gracefully (confirmed by NVIDIA) and return an error.
@@ -242,11 +278,74 @@ err:
     return 0;
 }
 
+static int nv_mem_acquire(unsigned long addr, size_t size, void *peer_mem_private_data,
+                          char *peer_mem_name, void **client_context)
+{
+    return nv_mem_acquire_common(0, addr, size, client_context);
+}
+
+static int nv_mem_acquire_nc(unsigned long addr, size_t size, void *peer_mem_private_data,
+                             char *peer_mem_name, void **client_context)
+{
+    return nv_mem_acquire_common(1, addr, size, client_context);
+}
+
+/* Whether DMA address i starts a segment that cannot be merged with the
+ * previous one.
+ */
+static int nv_dma_seg_starts_at(struct nvidia_p2p_dma_mapping *dma_mapping,
+                                u64 seg_start, int i)
+{
+    u64 dma_address = dma_mapping->dma_addresses[i];
+
+    if (i == 0)
+        return 1;
+
+    if (!large_page_support || peerdirect_support == NV_MEM_PEERDIRECT_SUPPORT_LEGACY)
+        return 1;
+
+    if (dma_address != dma_mapping->dma_addresses[i - 1] + GPU_PAGE_SIZE)
+        return 1;
+
+    return (dma_address - seg_start) >= NV_MEM_MAX_SEG_SIZE;
+}
+
+/* 2MB pages can be reported to the IB core if the mapping covers whole 2MB
+ * virtual pages, each backed by a 2MB aligned DMA contiguous range.
+ */
+static int nv_dma_large_pages_ok(struct nv_mem_context *nv_mem_context,
+                                 struct nvidia_p2p_dma_mapping *dma_mapping)
+{
+    const u32 pages_per_large_page = GPU_LARGE_PAGE_SIZE / GPU_PAGE_SIZE;
+    u32 i;
+
+    if (!large_page_support || peerdirect_support == NV_MEM_PEERDIRECT_SUPPORT_LEGACY)
+        return 0;
+
+    if ((nv_mem_context->page_virt_start % GPU_LARGE_PAGE_SIZE) ||
+        (nv_mem_context->page_virt_end % GPU_LARGE_PAGE_SIZE))
+        return 0;
+
+    for (i = 0; i < dma_mapping->entries; i++) {
+        u64 dma_address = dma_mapping->dma_addresses[i];
+
+        if ((i % pages_per_large_page) == 0) {
+            if (dma_address % GPU_LARGE_PAGE_SIZE)
+                return 0;
+        } else if (dma_address != dma_mapping->dma_addresses[i - 1] + GPU_PAGE_SIZE) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
 static int nv_dma_map(struct sg_table *sg_head, void *context,
                       struct device *dma_device, int dmasync,
                       int *nmap)
 {
-    int i, ret;
+    int i, ret, nents;
+    u64 seg_start = 0;
     struct scatterlist *sg;
     struct nv_mem_context *nv_mem_context =
         (struct nv_mem_context *) context;
@@ -278,9 +377,22 @@ static int nv_dma_map(struct sg_table *sg_head, void *context,
         return -EINVAL;
     }
 
-    nv_mem_context->npages = dma_mapping->entries;
+    /* Contiguous GPU pages are merged into a single segment, so that the NIC
+     * needs fewer translation entries for the region.
+     */
+    nents = 0;
+    for (i = 0; i < dma_mapping->entries; i++) {
+        if (nv_dma_seg_starts_at(dma_mapping, seg_start, i)) {
+            seg_start = dma_mapping->dma_addresses[i];
+            nents++;
+        }
+    }
+
+    nv_mem_context->npages = nents;
+    if (nv_dma_large_pages_ok(nv_mem_context, dma_mapping))
+        nv_mem_context->page_size = GPU_LARGE_PAGE_SIZE;
 
-    ret = sg_alloc_table(sg_head, dma_mapping->entries, GFP_KERNEL);
+    ret = sg_alloc_table(sg_head, nents, GFP_KERNEL);
     if (ret) {
         nvidia_p2p_dma_unmap_pages(pdev, page_table, dma_mapping);
         return ret;
@@ -288,14 +400,24 @@ static int nv_dma_map(struct sg_table *sg_head, void *context,
 
     nv_mem_context->dma_mapping = dma_mapping;
     nv_mem_context->sg_allocated = 1;
-    for_each_sg(sg_head->sgl, sg, nv_mem_context->npages, i) {
-        sg_set_page(sg, NULL, nv_mem_context->page_size, 0);
-        sg_dma_address(sg) = dma_mapping->dma_addresses[i];
-        sg_dma_len(sg) = nv_mem_context->page_size;
+    sg = NULL;
+    for (i = 0; i < dma_mapping->entries; i++) {
+        if (nv_dma_seg_starts_at(dma_mapping, seg_start, i)) {
+            seg_start = dma_mapping->dma_addresses[i];
+            sg = sg ? sg_next(sg) : sg_head->sgl;
+            sg_set_page(sg, NULL, 0, 0);
+            sg_dma_address(sg) = seg_start;
+            sg_dma_len(sg) = 0;
+        }
+        sg->length += GPU_PAGE_SIZE;
+        sg_dma_len(sg) += GPU_PAGE_SIZE;
     }
     nv_mem_context->sg_head = *sg_head;
     *nmap = nv_mem_context->npages;
 
+    peer_trace("%u pages mapped as %d segments, page size 0x%lx\n",
+               dma_mapping->entries, nents, nv_mem_context->page_size);
+
     return 0;
 }
 
@@ -384,6 +506,9 @@ static void nv_mem_release(void *context)
 {
     struct nv_mem_context *nv_mem_context =
         (struct nv_mem_context *) context;
+
+    nv_mem_put_acquire_pages(nv_mem_context);
+
     if (nv_mem_context->sg_allocated) {
         sg_free_table(&nv_mem_context->sg_head);
         nv_mem_context->sg_allocated = 0;
@@ -417,6 +542,9 @@ static int nv_mem_get_pages(unsigned long addr,
         return ret;
     }
 
+    /* The pages are now held by the page table above. */
+    nv_mem_put_acquire_pages(nv_mem_context);
+
     /* No extra access to nv_mem_context->page_table here as we are
         called not under a lock and may race with inflight invalidate callback on that buffer.
         Extra handling was delayed to be done under nv_dma_map.
@@ -477,7 +605,7 @@ static int nv_mem_get_pages_nc(unsigned long addr,
 }
 
 static struct peer_memory_client nv_mem_client_nc = {
-    .acquire        = nv_mem_acquire,
+    .acquire        = nv_mem_acquire_nc,
     .get_pages      = nv_mem_get_pages_nc,
     .dma_map        = nv_dma_map,
     .dma_unmap      = nv_dma_unmap,
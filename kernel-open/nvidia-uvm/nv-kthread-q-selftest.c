@@ -541,6 +541,143 @@ static int _check_cpu_affinity_test(void)
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Pool tests
+
+#define NUM_POOL_TEST_WORKERS   4
+#define NUM_POOL_TEST_Q_ITEMS   (10 * 1000)
+
+typedef struct pool_args
+{
+    nv_kthread_pool_t   test_pool;
+    nv_kthread_q_item_t q_item;
+    atomic_t            accumulator;
+    atomic_t            stop_rescheduling_callbacks;
+    int                 test_failure;
+} pool_args_t;
+
+static void _pool_callback(void *args)
+{
+    pool_args_t *pool_args = (pool_args_t*)args;
+    atomic_inc(&pool_args->accumulator);
+}
+
+// Schedule many items across the workers, with and without NUMA hints, and
+// verify that all of them ran once the pool is flushed.
+static int _pool_basic_test(void)
+{
+    int i, node, was_scheduled;
+    int result = 0;
+    int num_scheduled = 0;
+    nv_kthread_q_item_t *q_items;
+    pool_args_t *pool_args;
+
+    pool_args = vmalloc(sizeof(*pool_args));
+    TEST_CHECK_RET(pool_args != NULL);
+    memset(pool_args, 0, sizeof(*pool_args));
+
+    q_items = vmalloc(NUM_POOL_TEST_Q_ITEMS * sizeof(*q_items));
+    if (!q_items) {
+        vfree(pool_args);
+        TEST_CHECK_RET(false);
+    }
+
+    // Stopping a zero-initialized pool is a no-op
+    nv_kthread_pool_stop(&pool_args->test_pool);
+
+    result = nv_kthread_pool_init(&pool_args->test_pool, "pool_test", NUM_POOL_TEST_WORKERS);
+    if (result != 0)
+        goto done;
+
+    node = first_online_node;
+    for (i = 0; i < NUM_POOL_TEST_Q_ITEMS; ++i) {
+        nv_kthread_q_item_init(&q_items[i], _pool_callback, pool_args);
+
+        if (i % 2) {
+            was_scheduled = nv_kthread_pool_schedule_q_item(&pool_args->test_pool, &q_items[i]);
+        }
+        else {
+            was_scheduled = nv_kthread_pool_schedule_q_item_on_node(&pool_args->test_pool,
+                                                                    &q_items[i],
+                                                                    node);
+            node = next_online_node(node);
+            if (node == MAX_NUMNODES)
+                node = first_online_node;
+        }
+
+        result |= !was_scheduled;
+    }
+
+    nv_kthread_pool_flush(&pool_args->test_pool);
+
+    if (atomic_read(&pool_args->accumulator) != NUM_POOL_TEST_Q_ITEMS) {
+        NVQ_TEST_PRINT("accumulator: Expected: %d, actual: %d\n",
+                       NUM_POOL_TEST_Q_ITEMS, atomic_read(&pool_args->accumulator));
+        result = -1;
+    }
+
+    // Same as _same_q_item_test(), but with a pool
+    atomic_set(&pool_args->accumulator, 0);
+    nv_kthread_q_item_init(&pool_args->q_item, _pool_callback, pool_args);
+    for (i = 0; i < 1000; ++i)
+        num_scheduled += nv_kthread_pool_schedule_q_item(&pool_args->test_pool, &pool_args->q_item);
+
+    nv_kthread_pool_stop(&pool_args->test_pool);
+
+    if (atomic_read(&pool_args->accumulator) != num_scheduled || num_scheduled < 1)
+        result = -1;
+
+    // A second stop is a no-op
+    nv_kthread_pool_stop(&pool_args->test_pool);
+
+done:
+    vfree(q_items);
+    vfree(pool_args);
+    TEST_CHECK_RET(result == 0);
+    return 0;
+}
+
+static void _pool_reschedule_callback(void *args)
+{
+    pool_args_t *pool_args = (pool_args_t*)args;
+
+    atomic_inc(&pool_args->accumulator);
+
+    if (atomic_read(&pool_args->stop_rescheduling_callbacks) == 0) {
+        nv_kthread_q_item_init(&pool_args->q_item, _pool_reschedule_callback, pool_args);
+
+        if (!nv_kthread_pool_schedule_q_item(&pool_args->test_pool, &pool_args->q_item))
+            pool_args->test_failure = 1;
+    }
+
+    // Ensure thread relinquishes control else we hang in single-core environments
+    schedule();
+}
+
+// Same as _reschedule_same_item_from_its_own_callback_test(), but with a pool,
+// where the item is likely to be rescheduled to a different worker.
+static int _pool_reschedule_test(void)
+{
+    int result;
+    pool_args_t pool_args;
+
+    memset(&pool_args, 0, sizeof(pool_args));
+
+    result = nv_kthread_pool_init(&pool_args.test_pool, "pool_resched_test", NUM_POOL_TEST_WORKERS);
+    TEST_CHECK_RET(result == 0);
+
+    nv_kthread_q_item_init(&pool_args.q_item, _pool_reschedule_callback, &pool_args);
+    result = !nv_kthread_pool_schedule_q_item(&pool_args.test_pool, &pool_args.q_item);
+
+    while (atomic_read(&pool_args.accumulator) < NUM_RESCHEDULE_CALLBACKS)
+        schedule();
+
+    atomic_set(&pool_args.stop_rescheduling_callbacks, 1);
+    nv_kthread_pool_stop(&pool_args.test_pool);
+
+    return (result || pool_args.test_failure);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Top-level test entry point
 
@@ -563,5 +700,11 @@ int nv_kthread_q_run_self_test(void)
     result = _check_cpu_affinity_test();
     TEST_CHECK_RET(result == 0);
 
+    result = _pool_basic_test();
+    TEST_CHECK_RET(result == 0);
+
+    result = _pool_reschedule_test();
+    TEST_CHECK_RET(result == 0);
+
     return 0;
 }
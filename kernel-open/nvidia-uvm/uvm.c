@@ -1001,6 +1001,12 @@ static long uvm_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
         UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_CLEAN_UP_ZOMBIE_RESOURCES,      uvm_api_clean_up_zombie_resources);
         UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_POPULATE_PAGEABLE,              uvm_api_populate_pageable);
         UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_VALIDATE_VA_RANGE,              uvm_api_validate_va_range);
+        UVM_ROUTE_CMD_ALLOC_INIT_CHECK(UVM_TOOLS_GET_FAULT_LATENCY_HISTOGRAM,
+                                       uvm_api_tools_get_fault_latency_histogram);
+        UVM_ROUTE_CMD_ALLOC_INIT_CHECK(UVM_MIGRATE_BATCH,                  uvm_api_migrate_batch);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_SET_THRASHING_POLICY,           uvm_api_set_thrashing_policy);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_SET_GPU_RESIDENT_RESERVATION,   uvm_api_set_gpu_resident_reservation);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_UNSET_GPU_RESIDENT_RESERVATION, uvm_api_unset_gpu_resident_reservation);
     }
 
     // Try the test ioctls if none of the above matched
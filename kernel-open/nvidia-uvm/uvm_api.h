@@ -240,7 +240,13 @@ NV_STATUS uvm_api_register_channel(UVM_REGISTER_CHANNEL_PARAMS *params, struct f
 NV_STATUS uvm_api_unregister_channel(UVM_UNREGISTER_CHANNEL_PARAMS *params, struct file *filp);
 NV_STATUS uvm_api_enable_read_duplication(const UVM_ENABLE_READ_DUPLICATION_PARAMS *params, struct file *filp);
 NV_STATUS uvm_api_disable_read_duplication(const UVM_DISABLE_READ_DUPLICATION_PARAMS *params, struct file *filp);
+NV_STATUS uvm_api_set_thrashing_policy(const UVM_SET_THRASHING_POLICY_PARAMS *params, struct file *filp);
+NV_STATUS uvm_api_set_gpu_resident_reservation(const UVM_SET_GPU_RESIDENT_RESERVATION_PARAMS *params,
+                                               struct file *filp);
+NV_STATUS uvm_api_unset_gpu_resident_reservation(const UVM_UNSET_GPU_RESIDENT_RESERVATION_PARAMS *params,
+                                                 struct file *filp);
 NV_STATUS uvm_api_migrate(UVM_MIGRATE_PARAMS *params, struct file *filp);
+NV_STATUS uvm_api_migrate_batch(UVM_MIGRATE_BATCH_PARAMS *params, struct file *filp);
 NV_STATUS uvm_api_enable_system_wide_atomics(UVM_ENABLE_SYSTEM_WIDE_ATOMICS_PARAMS *params, struct file *filp);
 NV_STATUS uvm_api_disable_system_wide_atomics(UVM_DISABLE_SYSTEM_WIDE_ATOMICS_PARAMS *params, struct file *filp);
 NV_STATUS uvm_api_tools_init_event_tracker(UVM_TOOLS_INIT_EVENT_TRACKER_PARAMS *params, struct file *filp);
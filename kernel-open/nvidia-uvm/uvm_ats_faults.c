@@ -34,6 +34,16 @@
 #include <linux/hmm.h>
 #endif
 
+// Amount of memory, in KB, to populate and map ahead of a VA block whose ATS
+// faults were serviced up to the end of the block on first touch. The
+// prefetch-ahead region is limited to the next VA block in the same VMA.
+//
+// Valid values 0-2048. 0 disables the prefetch-ahead.
+static unsigned uvm_perf_ats_prefetch_ahead_kb = 0;
+module_param(uvm_perf_ats_prefetch_ahead_kb, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_perf_ats_prefetch_ahead_kb,
+                 "Size in KB of the ATS prefetch-ahead region populated past a fully faulted VA block");
+
 typedef enum
 {
     UVM_ATS_SERVICE_TYPE_FAULTS = 0,
@@ -451,6 +461,63 @@ static NV_STATUS ats_compute_prefetch(uvm_gpu_va_space_t *gpu_va_space,
     return status;
 }
 
+// Populate and map the start of the VA block following base if the faults just
+// serviced look like a first-touch stream that ran into the end of the block.
+// The GPU would otherwise take a whole new batch of faults on the next block.
+// Failures are ignored since this is just an optimization.
+static void ats_prefetch_ahead(uvm_gpu_va_space_t *gpu_va_space,
+                               struct vm_area_struct *vma,
+                               NvU64 base,
+                               uvm_ats_fault_context_t *ats_context)
+{
+    uvm_va_space_t *va_space = gpu_va_space->va_space;
+    uvm_va_block_region_t max_region = uvm_ats_region_from_vma(vma, base);
+    NvU64 start = base + UVM_VA_BLOCK_SIZE;
+    NvU64 length = min((NvU64)uvm_perf_ats_prefetch_ahead_kb * 1024, (NvU64)UVM_VA_BLOCK_SIZE);
+    bool write = (vma->vm_flags & VM_WRITE) && !uvm_page_mask_empty(&ats_context->write_fault_mask);
+    uvm_fault_access_type_t access_type = write ? UVM_FAULT_ACCESS_TYPE_WRITE : UVM_FAULT_ACCESS_TYPE_READ;
+    NV_STATUS status;
+
+    length = PAGE_ALIGN(length);
+    if (length == 0 || !uvm_perf_prefetch_enabled(va_space))
+        return;
+
+    if (!ats_context->prefetch_state.first_touch)
+        return;
+
+    if (!uvm_page_mask_test(&ats_context->faults_serviced_mask, max_region.outer - 1))
+        return;
+
+    if (start >= vma->vm_end)
+        return;
+
+    length = min(length, (NvU64)vma->vm_end - start);
+
+    if (uvm_ats_check_in_gmmu_region(va_space, start, uvm_va_space_iter_first(va_space, start, ~0ULL)) ||
+        uvm_ats_check_in_gmmu_region(va_space,
+                                     start + length - 1,
+                                     uvm_va_space_iter_first(va_space, start + length - 1, ~0ULL)))
+        return;
+
+    status = service_ats_requests(gpu_va_space,
+                                  vma,
+                                  start,
+                                  length,
+                                  access_type,
+                                  UVM_ATS_SERVICE_TYPE_FAULTS,
+                                  ats_context);
+    if (status != NV_OK)
+        return;
+
+    // See the comments in uvm_ats_service_faults() on why newly written
+    // translations are invalidated.
+    if (write)
+        uvm_ats_smmu_invalidate_tlbs(gpu_va_space, start, length);
+
+    if (write || PAGE_SIZE == UVM_PAGE_SIZE_4K)
+        flush_tlb_va_region(gpu_va_space, start, length, ats_context->client_type);
+}
+
 NV_STATUS uvm_ats_service_faults(uvm_gpu_va_space_t *gpu_va_space,
                                  struct vm_area_struct *vma,
                                  NvU64 base,
@@ -564,6 +631,8 @@ NV_STATUS uvm_ats_service_faults(uvm_gpu_va_space_t *gpu_va_space,
 
     }
 
+    ats_prefetch_ahead(gpu_va_space, vma, base, ats_context);
+
     return status;
 }
 
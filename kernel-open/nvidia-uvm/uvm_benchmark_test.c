@@ -0,0 +1,515 @@
+/*******************************************************************************
+    Copyright (c) 2024 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "uvm_common.h"
+#include "uvm_linux.h"
+#include "uvm_test.h"
+#include "uvm_test_ioctl.h"
+#include "uvm_va_block.h"
+#include "uvm_va_space.h"
+#include "uvm_mmu.h"
+#include "uvm_push.h"
+#include "uvm_tracker.h"
+#include "uvm_pmm_gpu.h"
+#include "uvm_kvmalloc.h"
+
+#include <linux/sort.h>
+
+// Each benchmark fills one sample per iteration with the time, in nanoseconds,
+// taken by the operation being measured. Setup and teardown done between
+// samples is never timed.
+
+static int sample_cmp(const void *a, const void *b)
+{
+    NvU64 sample_a = *(const NvU64 *)a;
+    NvU64 sample_b = *(const NvU64 *)b;
+
+    if (sample_a < sample_b)
+        return -1;
+
+    return sample_a > sample_b;
+}
+
+static void benchmark_report(UVM_TEST_BENCHMARK_PARAMS *params, NvU64 *samples)
+{
+    NvU32 n = params->iterations;
+
+    sort(samples, n, sizeof(*samples), sample_cmp, NULL);
+
+    params->min_ns = samples[0];
+    params->median_ns = samples[n / 2];
+    params->p99_ns = samples[min(n - 1, (NvU32)(((NvU64)n * 99) / 100))];
+    params->max_ns = samples[n - 1];
+}
+
+static NV_STATUS benchmark_push_begin_end(uvm_gpu_t *gpu, UVM_TEST_BENCHMARK_PARAMS *params, NvU64 *samples)
+{
+    NV_STATUS status = NV_OK;
+    uvm_tracker_t tracker = UVM_TRACKER_INIT();
+    NvU32 i;
+
+    for (i = 0; i < params->iterations; i++) {
+        uvm_push_t push;
+        NvU64 start = NV_GETTIME();
+
+        status = uvm_push_begin(gpu->channel_manager, UVM_CHANNEL_TYPE_GPU_INTERNAL, &push, "benchmark push");
+        if (status != NV_OK)
+            break;
+
+        uvm_push_end(&push);
+        samples[i] = NV_GETTIME() - start;
+
+        if (params->cold)
+            status = uvm_push_wait(&push);
+        else
+            status = uvm_tracker_add_push_safe(&tracker, &push);
+
+        if (status != NV_OK)
+            break;
+    }
+
+    if (status == NV_OK)
+        status = uvm_tracker_wait_deinit(&tracker);
+    else
+        uvm_tracker_wait_deinit(&tracker);
+
+    return status;
+}
+
+static NV_STATUS benchmark_tracker_wait(uvm_gpu_t *gpu, UVM_TEST_BENCHMARK_PARAMS *params, NvU64 *samples)
+{
+    NvU32 i;
+
+    for (i = 0; i < params->iterations; i++) {
+        NV_STATUS status;
+        uvm_push_t push;
+        uvm_tracker_t tracker = UVM_TRACKER_INIT();
+        NvU64 start;
+
+        status = uvm_push_begin(gpu->channel_manager, UVM_CHANNEL_TYPE_GPU_INTERNAL, &push, "benchmark tracker");
+        if (status != NV_OK)
+            return status;
+
+        uvm_push_end(&push);
+
+        // Adding a push to an empty tracker uses its static entry, so it
+        // cannot fail.
+        status = uvm_tracker_add_push_safe(&tracker, &push);
+        UVM_ASSERT(status == NV_OK);
+
+        if (!params->cold) {
+            status = uvm_push_wait(&push);
+            if (status != NV_OK) {
+                uvm_tracker_deinit(&tracker);
+                return status;
+            }
+        }
+
+        start = NV_GETTIME();
+        status = uvm_tracker_wait(&tracker);
+        samples[i] = NV_GETTIME() - start;
+
+        uvm_tracker_deinit(&tracker);
+        if (status != NV_OK)
+            return status;
+    }
+
+    return NV_OK;
+}
+
+static NV_STATUS benchmark_pmm_alloc_free(uvm_gpu_t *gpu, UVM_TEST_BENCHMARK_PARAMS *params, NvU64 *samples)
+{
+    NV_STATUS status = NV_OK;
+    uvm_chunk_size_t chunk_size = params->chunk_size;
+    uvm_gpu_chunk_t **chunks = NULL;
+    NvU32 num_chunks = 0;
+    NvU32 i;
+
+    if (params->chunk_size != chunk_size ||
+        !is_power_of_2(chunk_size) ||
+        !(gpu->pmm.chunk_sizes[UVM_PMM_GPU_MEMORY_TYPE_KERNEL] & chunk_size))
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if (params->cold) {
+        chunks = uvm_kvmalloc(params->iterations * sizeof(*chunks));
+        if (!chunks)
+            return NV_ERR_NO_MEMORY;
+    }
+
+    for (i = 0; i < params->iterations; i++) {
+        uvm_gpu_chunk_t *chunk;
+        NvU64 start = NV_GETTIME();
+
+        status = uvm_pmm_gpu_alloc_kernel(&gpu->pmm, 1, chunk_size, UVM_PMM_ALLOC_FLAGS_NONE, &chunk, NULL);
+        if (status != NV_OK)
+            break;
+
+        if (params->cold) {
+            samples[i] = NV_GETTIME() - start;
+            chunks[num_chunks++] = chunk;
+        }
+        else {
+            uvm_pmm_gpu_free(&gpu->pmm, chunk, NULL);
+            samples[i] = NV_GETTIME() - start;
+        }
+    }
+
+    for (i = 0; i < num_chunks; i++)
+        uvm_pmm_gpu_free(&gpu->pmm, chunks[i], NULL);
+
+    uvm_kvfree(chunks);
+
+    return status;
+}
+
+static NV_STATUS benchmark_page_tree_get_put(uvm_gpu_t *gpu, UVM_TEST_BENCHMARK_PARAMS *params, NvU64 *samples)
+{
+    NV_STATUS status;
+    uvm_page_tree_t tree;
+    uvm_page_table_range_t neighbor;
+    NvU64 page_size = params->page_size;
+    NvU32 i;
+
+    status = uvm_page_tree_init(gpu,
+                                NULL,
+                                UVM_PAGE_TREE_TYPE_USER,
+                                gpu->big_page.internal_size,
+                                uvm_get_page_tree_location(gpu->parent),
+                                &tree);
+    if (status != NV_OK)
+        return status;
+
+    if (!is_power_of_2(page_size) || !(tree.hal->page_sizes() & page_size)) {
+        status = NV_ERR_INVALID_ARGUMENT;
+        goto out;
+    }
+
+    // Keep the page tables covering the sampled page allocated by holding a
+    // reference on the page next to it.
+    if (!params->cold) {
+        status = uvm_page_tree_get_ptes(&tree, page_size, page_size, page_size, UVM_PMM_ALLOC_FLAGS_NONE, &neighbor);
+        if (status != NV_OK)
+            goto out;
+    }
+
+    for (i = 0; i < params->iterations; i++) {
+        uvm_page_table_range_t range;
+        NvU64 start = NV_GETTIME();
+
+        status = uvm_page_tree_get_ptes(&tree, page_size, 0, page_size, UVM_PMM_ALLOC_FLAGS_NONE, &range);
+        if (status != NV_OK)
+            break;
+
+        uvm_page_tree_put_ptes(&tree, &range);
+        samples[i] = NV_GETTIME() - start;
+    }
+
+    if (!params->cold)
+        uvm_page_tree_put_ptes(&tree, &neighbor);
+
+out:
+    uvm_page_tree_deinit(&tree);
+
+    return status;
+}
+
+static bool benchmark_page_mask_init(uvm_va_block_region_t region, NvU32 pattern, uvm_page_mask_t *page_mask)
+{
+    uvm_page_index_t page_index;
+
+    uvm_page_mask_zero(page_mask);
+
+    switch (pattern) {
+        case UVM_TEST_BENCHMARK_PATTERN_ALL:
+            uvm_page_mask_region_fill(page_mask, region);
+            return true;
+        case UVM_TEST_BENCHMARK_PATTERN_FIRST_HALF:
+            uvm_page_mask_region_fill(page_mask, uvm_va_block_region(0, max(region.outer / 2, 1u)));
+            return true;
+        case UVM_TEST_BENCHMARK_PATTERN_EVERY_OTHER_PAGE:
+            for_each_va_block_page_in_region(page_index, region) {
+                if (page_index % 2 == 0)
+                    uvm_page_mask_set(page_mask, page_index);
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+static NV_STATUS benchmark_make_resident_locked(uvm_va_block_t *block,
+                                                uvm_va_block_retry_t *retry,
+                                                uvm_va_block_context_t *block_context,
+                                                uvm_processor_id_t dest_id,
+                                                const uvm_page_mask_t *page_mask)
+{
+    uvm_va_block_region_t region = uvm_va_block_region_from_block(block);
+    NV_STATUS status;
+
+    // Unmapping UVM_ID_CPU is guaranteed to never fail
+    status = uvm_va_block_unmap(block, block_context, UVM_ID_CPU, region, page_mask, NULL);
+    UVM_ASSERT(status == NV_OK);
+
+    block_context->make_resident.dest_nid = NUMA_NO_NODE;
+
+    status = uvm_va_block_make_resident(block,
+                                        retry,
+                                        block_context,
+                                        dest_id,
+                                        region,
+                                        page_mask,
+                                        NULL,
+                                        UVM_MAKE_RESIDENT_CAUSE_API_MIGRATE);
+    if (status != NV_OK)
+        return status;
+
+    return uvm_tracker_wait(&block->tracker);
+}
+
+static NV_STATUS benchmark_make_resident_sample(uvm_va_block_t *block,
+                                                uvm_va_block_context_t *block_context,
+                                                uvm_processor_id_t dest_id,
+                                                const uvm_page_mask_t *page_mask)
+{
+    uvm_va_block_retry_t retry;
+
+    return UVM_VA_BLOCK_LOCK_RETRY(block,
+                                   &retry,
+                                   benchmark_make_resident_locked(block, &retry, block_context, dest_id, page_mask));
+}
+
+static NV_STATUS benchmark_make_resident(uvm_va_space_t *va_space,
+                                         uvm_gpu_t *gpu,
+                                         UVM_TEST_BENCHMARK_PARAMS *params,
+                                         NvU64 *samples)
+{
+    NV_STATUS status;
+    uvm_va_block_t *block;
+    uvm_va_block_context_t *block_context;
+    uvm_page_mask_t *page_mask;
+    NvU32 i;
+
+    uvm_assert_rwsem_locked_read(&va_space->lock);
+
+    status = uvm_va_block_find_create_managed(va_space, params->va, &block);
+    if (status != NV_OK)
+        return status;
+
+    block_context = uvm_va_block_context_alloc(NULL);
+    page_mask = uvm_kvmalloc(sizeof(*page_mask));
+    if (!block_context || !page_mask) {
+        status = NV_ERR_NO_MEMORY;
+        goto out;
+    }
+
+    if (!benchmark_page_mask_init(uvm_va_block_region_from_block(block), params->pattern, page_mask)) {
+        status = NV_ERR_INVALID_ARGUMENT;
+        goto out;
+    }
+
+    if (!params->cold) {
+        status = benchmark_make_resident_sample(block, block_context, gpu->id, page_mask);
+        if (status != NV_OK)
+            goto out;
+    }
+
+    for (i = 0; i < params->iterations; i++) {
+        NvU64 start;
+
+        if (params->cold) {
+            status = benchmark_make_resident_sample(block, block_context, UVM_ID_CPU, page_mask);
+            if (status != NV_OK)
+                break;
+        }
+
+        start = NV_GETTIME();
+        status = benchmark_make_resident_sample(block, block_context, gpu->id, page_mask);
+        samples[i] = NV_GETTIME() - start;
+        if (status != NV_OK)
+            break;
+    }
+
+out:
+    uvm_kvfree(page_mask);
+    uvm_va_block_context_free(block_context);
+
+    return status;
+}
+
+typedef struct
+{
+    uvm_page_mask_t page_mask;
+    uvm_page_mask_t resident_mask;
+    uvm_page_mask_t result;
+} benchmark_page_mask_ops_t;
+
+static NV_STATUS benchmark_page_mask_ops(UVM_TEST_BENCHMARK_PARAMS *params, NvU64 *samples)
+{
+    NV_STATUS status = NV_OK;
+    benchmark_page_mask_ops_t *masks;
+    uvm_va_block_region_t region = uvm_va_block_region(1, PAGES_PER_UVM_VA_BLOCK - 1);
+    uvm_page_index_t page_index;
+    NvU32 i;
+
+    masks = uvm_kvmalloc_zero(sizeof(*masks));
+    if (!masks)
+        return NV_ERR_NO_MEMORY;
+
+    if (!benchmark_page_mask_init(uvm_va_block_region(0, PAGES_PER_UVM_VA_BLOCK), params->pattern, &masks->page_mask)) {
+        status = NV_ERR_INVALID_ARGUMENT;
+        goto out;
+    }
+
+    // Every third page is resident
+    for (page_index = 0; page_index < PAGES_PER_UVM_VA_BLOCK; page_index += 3)
+        uvm_page_mask_set(&masks->resident_mask, page_index);
+
+    for (i = 0; i < params->iterations; i++) {
+        NvU64 start = NV_GETTIME();
+        NvU32 weight = 0;
+        NvU32 j;
+
+        for (j = 0; j < UVM_TEST_BENCHMARK_PAGE_MASK_OPS_PER_SAMPLE; j++) {
+            if (params->cold) {
+                uvm_page_mask_andnot(&masks->result, &masks->page_mask, &masks->resident_mask);
+                uvm_page_mask_region_clear_outside(&masks->result, region);
+                weight += uvm_page_mask_region_weight(&masks->result, region);
+            }
+            else {
+                weight += uvm_page_mask_region_andnot_weight(&masks->result,
+                                                             region,
+                                                             &masks->page_mask,
+                                                             &masks->resident_mask);
+            }
+
+            // Keep the compiler from hoisting the operations out of the loop
+            barrier();
+        }
+
+        samples[i] = NV_GETTIME() - start;
+
+        UVM_ASSERT(weight == UVM_TEST_BENCHMARK_PAGE_MASK_OPS_PER_SAMPLE * uvm_page_mask_weight(&masks->result));
+    }
+
+out:
+    uvm_kvfree(masks);
+
+    return status;
+}
+
+static NV_STATUS benchmark_fault_sort(UVM_TEST_BENCHMARK_PARAMS *params, NvU64 *samples, struct file *filp)
+{
+    NvU32 i;
+
+    if (params->num_faults == 0 || params->num_faults > UVM_TEST_FAULT_SORT_PERF_MAX_FAULTS)
+        return NV_ERR_INVALID_PARAMETER;
+
+    for (i = 0; i < params->iterations; i++) {
+        UVM_TEST_FAULT_SORT_PERF_PARAMS sort_params = {
+            .iterations = 1,
+            .num_faults = params->num_faults,
+            .num_va_spaces = 1,
+            .disorder_percent = 10,
+            .seed = i,
+        };
+        NV_STATUS status = uvm_test_fault_sort_perf(&sort_params, filp);
+
+        if (status != NV_OK)
+            return status;
+
+        samples[i] = sort_params.radix_sort_ns;
+    }
+
+    return NV_OK;
+}
+
+NV_STATUS uvm_test_benchmark(UVM_TEST_BENCHMARK_PARAMS *params, struct file *filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_gpu_t *gpu = NULL;
+    NvU64 *samples;
+    NV_STATUS status;
+
+    if (params->type >= UVM_TEST_BENCHMARK_COUNT ||
+        params->iterations == 0 ||
+        params->iterations > UVM_TEST_BENCHMARK_MAX_ITERATIONS)
+        return NV_ERR_INVALID_PARAMETER;
+
+    samples = uvm_kvmalloc(params->iterations * sizeof(*samples));
+    if (!samples)
+        return NV_ERR_NO_MEMORY;
+
+    if (params->type == UVM_TEST_BENCHMARK_FAULT_SORT) {
+        status = benchmark_fault_sort(params, samples, filp);
+    }
+    else if (params->type == UVM_TEST_BENCHMARK_PAGE_MASK_OPS) {
+        status = benchmark_page_mask_ops(params, samples);
+    }
+    else if (params->type == UVM_TEST_BENCHMARK_MAKE_RESIDENT) {
+        uvm_va_space_down_read(va_space);
+
+        gpu = uvm_va_space_get_gpu_by_uuid_with_gpu_va_space(va_space, &params->gpu_uuid);
+        if (gpu)
+            status = benchmark_make_resident(va_space, gpu, params, samples);
+        else
+            status = NV_ERR_INVALID_DEVICE;
+
+        uvm_va_space_up_read(va_space);
+    }
+    else {
+        gpu = uvm_va_space_retain_gpu_by_uuid(va_space, &params->gpu_uuid);
+        if (!gpu) {
+            status = NV_ERR_INVALID_DEVICE;
+            goto out;
+        }
+
+        switch (params->type) {
+            case UVM_TEST_BENCHMARK_PUSH_BEGIN_END:
+                status = benchmark_push_begin_end(gpu, params, samples);
+                break;
+            case UVM_TEST_BENCHMARK_TRACKER_WAIT:
+                status = benchmark_tracker_wait(gpu, params, samples);
+                break;
+            case UVM_TEST_BENCHMARK_PMM_ALLOC_FREE:
+                status = benchmark_pmm_alloc_free(gpu, params, samples);
+                break;
+            case UVM_TEST_BENCHMARK_PAGE_TREE_GET_PUT:
+                status = benchmark_page_tree_get_put(gpu, params, samples);
+                break;
+            default:
+                UVM_ASSERT_MSG(0, "Unexpected benchmark type %u\n", params->type);
+                status = NV_ERR_INVALID_PARAMETER;
+                break;
+        }
+
+        uvm_gpu_release(gpu);
+    }
+
+    if (status == NV_OK)
+        benchmark_report(params, samples);
+
+out:
+    uvm_kvfree(samples);
+
+    return status;
+}
@@ -0,0 +1,362 @@
+/*******************************************************************************
+    Copyright (c) 2024 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "uvm_ce_calibration.h"
+#include "uvm_global.h"
+#include "uvm_gpu.h"
+#include "uvm_hal.h"
+#include "uvm_mem.h"
+#include "uvm_push.h"
+
+static unsigned uvm_ce_calibration = 1;
+module_param(uvm_ce_calibration, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_ce_calibration,
+                 "Measure the copy bandwidth of each CE when a GPU is registered and when peer access is enabled.");
+
+// Size of the buffer copied by each calibration copy. Each sample copies the
+// buffer UVM_CE_CALIBRATION_COPIES_PER_SAMPLE times in a single push, so that
+// the push submission and completion overhead is amortized over the copies.
+#define UVM_CE_CALIBRATION_COPY_SIZE (4 * UVM_PAGE_SIZE_2M)
+#define UVM_CE_CALIBRATION_COPIES_PER_SAMPLE 4
+
+// Number of timed samples. An extra untimed sample is done first to warm up
+// the channel and the mappings.
+#define UVM_CE_CALIBRATION_SAMPLES 3
+
+typedef NV_STATUS (*ce_calibration_push_begin_t)(void *data, uvm_push_t *push);
+
+static bool ce_calibration_enabled(uvm_gpu_t *gpu)
+{
+    if (!uvm_ce_calibration)
+        return false;
+
+    if (gpu->parent->rm_info.isSimulated)
+        return false;
+
+    return !g_uvm_global.conf_computing_enabled;
+}
+
+static NvU32 bandwidth_mbyte_per_s(NvU64 size, NvU64 elapsed_ns)
+{
+    NvU64 mbyte_per_s;
+
+    if (elapsed_ns == 0)
+        return 0;
+
+    // Bytes per nanosecond is gigabytes per second
+    mbyte_per_s = (size * 1000) / elapsed_ns;
+
+    return (NvU32)min(mbyte_per_s, (NvU64)NV_U32_MAX);
+}
+
+// Copy the calibration buffer from src to dst. If dst_peer_mem is not NULL,
+// dst is ignored and the buffer is copied to the vidmem of a peer GPU, one
+// physical chunk at a time since the chunks are not contiguous. first and last
+// tell whether this is the first and last copy of the push, which are not
+// pipelined and followed by a membar respectively.
+static void ce_calibration_copy(uvm_push_t *push,
+                                uvm_gpu_address_t dst,
+                                uvm_mem_t *dst_peer_mem,
+                                uvm_gpu_address_t src,
+                                bool first,
+                                bool last)
+{
+    NvU64 copy_size = dst_peer_mem ? dst_peer_mem->chunk_size : UVM_CE_CALIBRATION_COPY_SIZE;
+    NvU64 offset;
+
+    UVM_ASSERT(!dst_peer_mem || dst_peer_mem->size >= UVM_CE_CALIBRATION_COPY_SIZE);
+
+    for (offset = 0; offset < UVM_CE_CALIBRATION_COPY_SIZE; offset += copy_size) {
+        NvU64 size = min_t(NvU64, copy_size, UVM_CE_CALIBRATION_COPY_SIZE - offset);
+        uvm_gpu_address_t piece_dst = dst;
+        uvm_gpu_address_t piece_src = src;
+
+        if (dst_peer_mem)
+            piece_dst = uvm_mem_gpu_address_copy(dst_peer_mem, push->gpu, offset, size);
+        else
+            piece_dst.address += offset;
+
+        piece_src.address += offset;
+
+        if (!first || offset != 0)
+            uvm_push_set_flag(push, UVM_PUSH_FLAG_CE_NEXT_PIPELINED);
+
+        if (!last || offset + size < UVM_CE_CALIBRATION_COPY_SIZE)
+            uvm_push_set_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE);
+
+        push->gpu->parent->ce_hal->memcopy(push, piece_dst, piece_src, size);
+    }
+}
+
+// Time the copies from src to dst (or to dst_peer_mem, see
+// ce_calibration_copy()) done in pushes started by push_begin, and return the
+// best bandwidth observed in out_mbyte_per_s.
+static NV_STATUS ce_calibration_measure(ce_calibration_push_begin_t push_begin,
+                                        void *push_begin_data,
+                                        uvm_gpu_address_t dst,
+                                        uvm_mem_t *dst_peer_mem,
+                                        uvm_gpu_address_t src,
+                                        NvU32 *out_mbyte_per_s)
+{
+    NvU64 best_ns = 0;
+    NvU32 i;
+
+    for (i = 0; i <= UVM_CE_CALIBRATION_SAMPLES; i++) {
+        NV_STATUS status;
+        uvm_push_t push;
+        NvU64 elapsed_ns;
+        NvU64 start;
+        NvU32 j;
+
+        start = NV_GETTIME();
+
+        status = push_begin(push_begin_data, &push);
+        if (status != NV_OK)
+            return status;
+
+        for (j = 0; j < UVM_CE_CALIBRATION_COPIES_PER_SAMPLE; j++)
+            ce_calibration_copy(&push, dst, dst_peer_mem, src, j == 0, j == UVM_CE_CALIBRATION_COPIES_PER_SAMPLE - 1);
+
+        status = uvm_push_end_and_wait(&push);
+        if (status != NV_OK)
+            return status;
+
+        elapsed_ns = NV_GETTIME() - start;
+
+        // Skip the warm up sample
+        if (i != 0 && (best_ns == 0 || elapsed_ns < best_ns))
+            best_ns = elapsed_ns;
+    }
+
+    *out_mbyte_per_s = bandwidth_mbyte_per_s(UVM_CE_CALIBRATION_COPY_SIZE * UVM_CE_CALIBRATION_COPIES_PER_SAMPLE,
+                                             best_ns);
+
+    return NV_OK;
+}
+
+static NV_STATUS ce_calibration_push_begin_on_pool(void *data, uvm_push_t *push)
+{
+    uvm_channel_pool_t *pool = data;
+
+    return uvm_push_begin_on_channel(&pool->channels[0], push, "CE calibration on CE %u", pool->engine_index);
+}
+
+static NV_STATUS ce_calibration_alloc_mem(uvm_gpu_t *gpu, bool is_vidmem, uvm_mem_t **mem_out)
+{
+    NV_STATUS status;
+    uvm_mem_t *mem;
+
+    if (is_vidmem)
+        status = uvm_mem_alloc_vidmem(UVM_CE_CALIBRATION_COPY_SIZE, gpu, &mem);
+    else
+        status = uvm_mem_alloc_sysmem_dma(UVM_CE_CALIBRATION_COPY_SIZE, gpu, NULL, &mem);
+
+    if (status != NV_OK)
+        return status;
+
+    status = uvm_mem_map_gpu_kernel(mem, gpu);
+    if (status != NV_OK) {
+        uvm_mem_free(mem);
+        return status;
+    }
+
+    *mem_out = mem;
+
+    return NV_OK;
+}
+
+NV_STATUS uvm_ce_calibration_gpu(uvm_gpu_t *gpu)
+{
+    NV_STATUS status;
+    uvm_mem_t *sysmem = NULL;
+    uvm_mem_t *vidmem[2] = { NULL, NULL };
+    uvm_gpu_address_t sysmem_addr;
+    uvm_gpu_address_t vidmem_addr[2];
+    uvm_channel_pool_t *pool;
+
+    memset(&gpu->ce_bandwidth, 0, sizeof(gpu->ce_bandwidth));
+
+    if (!ce_calibration_enabled(gpu))
+        return NV_OK;
+
+    status = ce_calibration_alloc_mem(gpu, false, &sysmem);
+    if (status != NV_OK)
+        goto done;
+
+    status = ce_calibration_alloc_mem(gpu, true, &vidmem[0]);
+    if (status != NV_OK)
+        goto done;
+
+    status = ce_calibration_alloc_mem(gpu, true, &vidmem[1]);
+    if (status != NV_OK)
+        goto done;
+
+    sysmem_addr = uvm_mem_gpu_address_virtual_kernel(sysmem, gpu);
+    vidmem_addr[0] = uvm_mem_gpu_address_virtual_kernel(vidmem[0], gpu);
+    vidmem_addr[1] = uvm_mem_gpu_address_virtual_kernel(vidmem[1], gpu);
+
+    uvm_for_each_pool_of_type(pool, gpu->channel_manager, UVM_CHANNEL_POOL_TYPE_CE) {
+        unsigned ce = pool->engine_index;
+
+        UVM_ASSERT(ce < UVM_COPY_ENGINE_COUNT_MAX);
+
+        status = ce_calibration_measure(ce_calibration_push_begin_on_pool,
+                                        pool,
+                                        vidmem_addr[0],
+                                        NULL,
+                                        sysmem_addr,
+                                        &gpu->ce_bandwidth.cpu_to_gpu_mbyte_per_s[ce]);
+        if (status != NV_OK)
+            goto done;
+
+        status = ce_calibration_measure(ce_calibration_push_begin_on_pool,
+                                        pool,
+                                        sysmem_addr,
+                                        NULL,
+                                        vidmem_addr[0],
+                                        &gpu->ce_bandwidth.gpu_to_cpu_mbyte_per_s[ce]);
+        if (status != NV_OK)
+            goto done;
+
+        status = ce_calibration_measure(ce_calibration_push_begin_on_pool,
+                                        pool,
+                                        vidmem_addr[1],
+                                        NULL,
+                                        vidmem_addr[0],
+                                        &gpu->ce_bandwidth.gpu_internal_mbyte_per_s[ce]);
+        if (status != NV_OK)
+            goto done;
+    }
+
+done:
+    // Don't report partial measurements
+    if (status != NV_OK)
+        memset(&gpu->ce_bandwidth, 0, sizeof(gpu->ce_bandwidth));
+
+    uvm_mem_free(vidmem[1]);
+    uvm_mem_free(vidmem[0]);
+    uvm_mem_free(sysmem);
+
+    return status;
+}
+
+typedef struct
+{
+    uvm_gpu_t *src_gpu;
+    uvm_gpu_t *dst_gpu;
+} ce_calibration_peer_data_t;
+
+static NV_STATUS ce_calibration_push_begin_gpu_to_gpu(void *data, uvm_push_t *push)
+{
+    ce_calibration_peer_data_t *peer_data = data;
+
+    return uvm_push_begin_gpu_to_gpu(peer_data->src_gpu->channel_manager,
+                                     peer_data->dst_gpu,
+                                     push,
+                                     "CE calibration to peer %s",
+                                     uvm_gpu_name(peer_data->dst_gpu));
+}
+
+static size_t peer_bandwidth_index(uvm_gpu_t *src_gpu, uvm_gpu_t *dst_gpu)
+{
+    // Same indexing as the peer ids
+    return uvm_id_value(src_gpu->id) < uvm_id_value(dst_gpu->id) ? 0 : 1;
+}
+
+NV_STATUS uvm_ce_calibration_peers(uvm_gpu_t *gpu0, uvm_gpu_t *gpu1)
+{
+    NV_STATUS status;
+    uvm_gpu_peer_t *peer_caps = uvm_gpu_peer_caps(gpu0, gpu1);
+    uvm_mem_t *vidmem[2] = { NULL, NULL };
+    uvm_gpu_t *gpus[2] = { gpu0, gpu1 };
+    NvU32 i;
+
+    uvm_assert_mutex_locked(&g_uvm_global.global_lock);
+
+    memset(peer_caps->copy_bandwidth_mbyte_per_s, 0, sizeof(peer_caps->copy_bandwidth_mbyte_per_s));
+
+    if (!ce_calibration_enabled(gpu0) || !ce_calibration_enabled(gpu1))
+        return NV_OK;
+
+    status = ce_calibration_alloc_mem(gpu0, true, &vidmem[0]);
+    if (status != NV_OK)
+        goto done;
+
+    status = ce_calibration_alloc_mem(gpu1, true, &vidmem[1]);
+    if (status != NV_OK)
+        goto done;
+
+    // Copies are pushed by the source GPU, which writes to the peer vidmem like
+    // migrations to a peer do.
+    for (i = 0; i < 2; i++) {
+        ce_calibration_peer_data_t peer_data = { gpus[i], gpus[1 - i] };
+        uvm_gpu_address_t src = uvm_mem_gpu_address_virtual_kernel(vidmem[i], gpus[i]);
+        uvm_gpu_address_t unused_dst = { 0 };
+        size_t index = peer_bandwidth_index(gpus[i], gpus[1 - i]);
+
+        status = ce_calibration_measure(ce_calibration_push_begin_gpu_to_gpu,
+                                        &peer_data,
+                                        unused_dst,
+                                        vidmem[1 - i],
+                                        src,
+                                        &peer_caps->copy_bandwidth_mbyte_per_s[index]);
+        if (status != NV_OK)
+            goto done;
+    }
+
+done:
+    if (status != NV_OK)
+        memset(peer_caps->copy_bandwidth_mbyte_per_s, 0, sizeof(peer_caps->copy_bandwidth_mbyte_per_s));
+
+    uvm_mem_free(vidmem[1]);
+    uvm_mem_free(vidmem[0]);
+
+    return status;
+}
+
+NvU32 uvm_ce_calibration_bandwidth(uvm_gpu_t *gpu, uvm_channel_type_t type)
+{
+    uvm_channel_pool_t *pool = gpu->channel_manager->pool_to_use.default_for_type[type];
+
+    if (!pool || uvm_channel_pool_is_proxy(pool))
+        return 0;
+
+    switch (type) {
+        case UVM_CHANNEL_TYPE_CPU_TO_GPU:
+            return gpu->ce_bandwidth.cpu_to_gpu_mbyte_per_s[pool->engine_index];
+        case UVM_CHANNEL_TYPE_GPU_TO_CPU:
+            return gpu->ce_bandwidth.gpu_to_cpu_mbyte_per_s[pool->engine_index];
+        case UVM_CHANNEL_TYPE_GPU_INTERNAL:
+            return gpu->ce_bandwidth.gpu_internal_mbyte_per_s[pool->engine_index];
+        default:
+            UVM_ASSERT_MSG(0, "Unexpected channel type %s\n", uvm_channel_type_to_string(type));
+            return 0;
+    }
+}
+
+NvU32 uvm_ce_calibration_peer_bandwidth(uvm_gpu_t *src_gpu, uvm_gpu_t *dst_gpu)
+{
+    uvm_gpu_peer_t *peer_caps = uvm_gpu_peer_caps(src_gpu, dst_gpu);
+
+    return peer_caps->copy_bandwidth_mbyte_per_s[peer_bandwidth_index(src_gpu, dst_gpu)];
+}
@@ -0,0 +1,67 @@
+/*******************************************************************************
+    Copyright (c) 2024 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef __UVM_CE_CALIBRATION_H__
+#define __UVM_CE_CALIBRATION_H__
+
+#include "uvm_linux.h"
+#include "uvm_forward_decl.h"
+#include "uvm_channel.h"
+
+// CE calibration measures the copy bandwidth actually achieved by a GPU, as
+// opposed to the line rate of its links reported by RM. When a GPU is
+// registered, a buffer is copied over each usable CE between sysmem and vidmem
+// in each direction, and within vidmem. When peer access is enabled between two
+// GPUs, a buffer is copied over the GPU to GPU channels in each direction. The
+// best of a few timed copies is kept, in megabytes per second.
+//
+// The calibration is skipped, and all the measurements are left at zero, when
+// the uvm_ce_calibration module parameter is 0, on simulated GPUs and when
+// Confidential Computing is enabled, since copies to unprotected memory are
+// encrypted and would not be representative. They are also left at zero if
+// any of the copies fails; calibration failures are not fatal to callers.
+
+// Measure the bandwidth of the CEs of the given GPU and store it in
+// gpu->ce_bandwidth. The channel manager and the kernel address space of the
+// GPU must be initialized.
+NV_STATUS uvm_ce_calibration_gpu(uvm_gpu_t *gpu);
+
+// Measure the copy bandwidth between the given peer GPUs in each direction and
+// store it in their peer caps. The peer identity mappings must already exist
+// and the peer CEs must be set.
+//
+// LOCKING: the global lock must be held.
+NV_STATUS uvm_ce_calibration_peers(uvm_gpu_t *gpu0, uvm_gpu_t *gpu1);
+
+// Measured bandwidth of the CE used by default for the given channel type, in
+// megabytes per second, or 0 if it was not measured. type must be one of
+// UVM_CHANNEL_TYPE_CPU_TO_GPU, UVM_CHANNEL_TYPE_GPU_TO_CPU or
+// UVM_CHANNEL_TYPE_GPU_INTERNAL.
+NvU32 uvm_ce_calibration_bandwidth(uvm_gpu_t *gpu, uvm_channel_type_t type);
+
+// Measured copy bandwidth from src_gpu to its peer dst_gpu over the channels
+// used by uvm_push_begin_gpu_to_gpu(), in megabytes per second, or 0 if it was
+// not measured.
+NvU32 uvm_ce_calibration_peer_bandwidth(uvm_gpu_t *src_gpu, uvm_gpu_t *dst_gpu);
+
+#endif // __UVM_CE_CALIBRATION_H__
@@ -57,6 +57,40 @@ module_param(uvm_channel_gpfifo_loc, charp, S_IRUGO);
 module_param(uvm_channel_gpput_loc, charp, S_IRUGO);
 module_param(uvm_channel_pushbuffer_loc, charp, S_IRUGO);
 
+typedef enum
+{
+    // Poll, periodically yielding the CPU
+    UVM_CHANNEL_WAIT_MODE_SPIN,
+
+    // Poll for uvm_channel_wait_spin_us, then sleep until another thread
+    // completes work on the channel or a timeout expires. The timeout doubles
+    // on each sleep, from UVM_CHANNEL_WAIT_SLEEP_MIN_US up to
+    // UVM_CHANNEL_WAIT_SLEEP_MAX_US.
+    UVM_CHANNEL_WAIT_MODE_BLOCK,
+
+    UVM_CHANNEL_WAIT_MODE_COUNT
+} uvm_channel_wait_mode_t;
+
+#define UVM_CHANNEL_WAIT_SLEEP_MIN_US 10
+#define UVM_CHANNEL_WAIT_SLEEP_MAX_US 1000
+
+// Maximum number of GPFIFO entries whose GPPUT update can be deferred with
+// UVM_PUSH_FLAG_DEFER_GPU_PUT before GPPUT is updated anyway. Bounds the
+// submission latency of the deferred pushes.
+#define UVM_CHANNEL_MAX_DEFERRED_GPU_PUTS 16
+
+// Number of CEs that transfers over PCIe are striped over by
+// uvm_channel_reserve_ce_stripe()
+#define UVM_CHANNEL_CE_STRIPES_PCIE 2
+
+// How threads wait for channel work to complete, see uvm_channel_wait_mode_t
+static unsigned uvm_channel_wait_mode = UVM_CHANNEL_WAIT_MODE_SPIN;
+module_param(uvm_channel_wait_mode, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_channel_wait_mode, "Wait for channel work by polling (0) or by polling and then sleeping (1).");
+
+static unsigned uvm_channel_wait_spin_us = 20;
+module_param(uvm_channel_wait_spin_us, uint, S_IRUGO);
+
 static NV_STATUS manager_create_procfs_dirs(uvm_channel_manager_t *manager);
 static NV_STATUS manager_create_procfs(uvm_channel_manager_t *manager);
 static NV_STATUS channel_create_procfs(uvm_channel_t *channel);
@@ -120,6 +154,60 @@ static void channel_pool_unlock(uvm_channel_pool_t *pool)
         uvm_spin_unlock(&pool->spinlock);
 }
 
+// Channels in pools using a spinlock have their own lock, so that pushes to
+// different channels of the same pool don't contend. In pools using a mutex the
+// pool lock is used instead, as submission to those channels also relies on
+// pool-wide state, e.g. the push locks of Confidential Computing.
+static void channel_lock(uvm_channel_t *channel)
+{
+    if (uvm_channel_pool_uses_mutex(channel->pool))
+        uvm_mutex_lock(&channel->pool->mutex);
+    else
+        uvm_spin_lock(&channel->lock);
+}
+
+static void channel_unlock(uvm_channel_t *channel)
+{
+    if (uvm_channel_pool_uses_mutex(channel->pool))
+        uvm_mutex_unlock(&channel->pool->mutex);
+    else
+        uvm_spin_unlock(&channel->lock);
+}
+
+static void channel_flush_deferred_gpu_put_locked(uvm_channel_t *channel)
+{
+    uvm_gpu_t *gpu;
+
+    if (channel->num_deferred_gpu_puts == 0)
+        return;
+
+    // Deferral is only done by internal_channel_submit_work()
+    UVM_ASSERT(!uvm_channel_is_proxy(channel));
+    UVM_ASSERT(!g_uvm_global.conf_computing_enabled);
+
+    gpu = uvm_channel_get_gpu(channel);
+
+    // The GPFIFO entries were already ordered with a full barrier at the time
+    // they were written, see internal_channel_submit_work().
+    gpu->parent->host_hal->write_gpu_put(channel, channel->cpu_put);
+    channel->num_deferred_gpu_puts = 0;
+}
+
+void uvm_channel_flush_deferred_gpu_put(uvm_channel_t *channel)
+{
+    // Racy check, callers only care about pushes that ended before the call,
+    // and those are visible here.
+    if (READ_ONCE(channel->num_deferred_gpu_puts) == 0)
+        return;
+
+    channel_lock(channel);
+    channel_flush_deferred_gpu_put_locked(channel);
+    channel_unlock(channel);
+
+    // See the comment in uvm_channel_end_push()
+    wmb();
+}
+
 // Update channel progress, completing up to max_to_complete entries
 static NvU32 uvm_channel_update_progress_with_max(uvm_channel_t *channel,
                                                   NvU32 max_to_complete,
@@ -132,7 +220,7 @@ static NvU32 uvm_channel_update_progress_with_max(uvm_channel_t *channel,
 
     NvU64 completed_value = uvm_channel_update_completed_value(channel);
 
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
 
     // Completed value should never exceed the queued value
     UVM_ASSERT_MSG_RELEASE(completed_value <= channel->tracking_sem.queued_value,
@@ -142,6 +230,9 @@ static NvU32 uvm_channel_update_progress_with_max(uvm_channel_t *channel,
                            completed_value,
                            channel->tracking_sem.queued_value);
 
+    // Anybody checking for progress might be waiting for deferred work
+    channel_flush_deferred_gpu_put_locked(channel);
+
     cpu_put = channel->cpu_put;
     gpu_get = channel->gpu_get;
 
@@ -162,7 +253,17 @@ static NvU32 uvm_channel_update_progress_with_max(uvm_channel_t *channel,
 
     channel->gpu_get = gpu_get;
 
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
+
+    if (completed_count > 0) {
+        atomic64_inc(&channel->wait.completion_seq);
+
+        // Order the sequence update before checking for sleepers. Pairs with
+        // the barrier in prepare_to_wait() on the waiter side.
+        smp_mb__after_atomic();
+        if (waitqueue_active(&channel->wait.wq))
+            wake_up_all(&channel->wait.wq);
+    }
 
     if (cpu_put >= gpu_get)
         pending_gpfifos = cpu_put - gpu_get;
@@ -172,6 +273,52 @@ static NvU32 uvm_channel_update_progress_with_max(uvm_channel_t *channel,
     return pending_gpfifos;
 }
 
+void uvm_channel_waiter_init(uvm_channel_waiter_t *waiter)
+{
+    uvm_spin_loop_init(&waiter->spin);
+    waiter->last_ns = waiter->spin.start_time_ns;
+    waiter->sleep_us = UVM_CHANNEL_WAIT_SLEEP_MIN_US;
+}
+
+static bool waiter_should_sleep(uvm_channel_waiter_t *waiter, NvU64 now)
+{
+    if (uvm_channel_wait_mode != UVM_CHANNEL_WAIT_MODE_BLOCK)
+        return false;
+
+    if (!NV_MAY_SLEEP())
+        return false;
+
+    return now - waiter->spin.start_time_ns >= uvm_channel_wait_spin_us * 1000ULL;
+}
+
+NV_STATUS uvm_channel_waiter_wait(uvm_channel_waiter_t *waiter, uvm_channel_t *channel)
+{
+    NvU64 now = NV_GETTIME();
+
+    atomic64_add(now - waiter->last_ns, &channel->wait.spin_ns);
+    waiter->last_ns = now;
+
+    if (waiter_should_sleep(waiter, now)) {
+        NvU64 seq = atomic64_read(&channel->wait.completion_seq);
+
+        // UVM doesn't get interrupts for channel work completion, so the sleep
+        // ends either when another thread observes progress on the channel or
+        // when the timeout expires. Callers can hold locks that rule out
+        // updating the channel's progress here.
+        wait_event_hrtimeout(channel->wait.wq,
+                             (NvU64)atomic64_read(&channel->wait.completion_seq) != seq,
+                             ns_to_ktime(waiter->sleep_us * 1000ULL));
+
+        waiter->last_ns = NV_GETTIME();
+        atomic64_add(waiter->last_ns - now, &channel->wait.sleep_ns);
+        atomic64_inc(&channel->wait.num_sleeps);
+
+        waiter->sleep_us = min(waiter->sleep_us * 2, (NvU32)UVM_CHANNEL_WAIT_SLEEP_MAX_US);
+    }
+
+    return UVM_SPIN_LOOP(&waiter->spin);
+}
+
 NvU32 uvm_channel_update_progress(uvm_channel_t *channel)
 {
     // By default, don't complete too many entries at a time to spread the cost
@@ -212,7 +359,7 @@ static NvU32 channel_get_available_gpfifo_entries(uvm_channel_t *channel)
 {
     NvU32 available = channel->num_gpfifo_entries;
 
-    uvm_channel_pool_assert_locked(channel->pool);
+    uvm_channel_assert_locked(channel);
 
     // Remove sentinel entry
     available -= 1;
@@ -235,9 +382,9 @@ NvU32 uvm_channel_get_available_gpfifo_entries(uvm_channel_t *channel)
 {
     NvU32 available;
 
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
     available = channel_get_available_gpfifo_entries(channel);
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
 
     return available;
 }
@@ -249,7 +396,7 @@ static bool try_claim_channel_locked(uvm_channel_t *channel, NvU32 num_gpfifo_en
     UVM_ASSERT(num_gpfifo_entries > 0);
     UVM_ASSERT(num_gpfifo_entries < channel->num_gpfifo_entries);
 
-    uvm_channel_pool_assert_locked(channel->pool);
+    uvm_channel_assert_locked(channel);
 
     if (channel_get_available_gpfifo_entries(channel) >= num_gpfifo_entries) {
         channel->current_gpfifo_count += num_gpfifo_entries;
@@ -263,9 +410,9 @@ static bool try_claim_channel(uvm_channel_t *channel, NvU32 num_gpfifo_entries)
 {
     bool claimed;
 
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
     claimed = try_claim_channel_locked(channel, num_gpfifo_entries);
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
 
     return claimed;
 }
@@ -328,7 +475,7 @@ static bool test_claim_and_lock_channel(uvm_channel_t *channel, NvU32 num_gpfifo
 static NV_STATUS channel_reserve_and_lock_in_pool(uvm_channel_pool_t *pool, uvm_channel_t **channel_out)
 {
     uvm_channel_t *channel;
-    uvm_spin_loop_t spin;
+    uvm_channel_waiter_t waiter;
     NvU32 index;
 
     UVM_ASSERT(pool);
@@ -355,7 +502,7 @@ static NV_STATUS channel_reserve_and_lock_in_pool(uvm_channel_pool_t *pool, uvm_
 
     // No channels are available. Update and check errors on all channels until
     // one becomes available.
-    uvm_spin_loop_init(&spin);
+    uvm_channel_waiter_init(&waiter);
     while (1) {
         uvm_for_each_channel_in_pool(channel, pool) {
             NV_STATUS status;
@@ -375,7 +522,7 @@ static NV_STATUS channel_reserve_and_lock_in_pool(uvm_channel_pool_t *pool, uvm_
                 return status;
             }
 
-            UVM_SPIN_LOOP(&spin);
+            uvm_channel_waiter_wait(&waiter, channel);
         }
     }
 
@@ -389,14 +536,23 @@ done:
 static NV_STATUS channel_reserve_in_pool(uvm_channel_pool_t *pool, uvm_channel_t **channel_out)
 {
     uvm_channel_t *channel;
-    uvm_spin_loop_t spin;
+    uvm_channel_waiter_t waiter;
+    NvU32 first;
+    NvU32 i;
 
     UVM_ASSERT(pool);
 
     if (g_uvm_global.conf_computing_enabled)
         return channel_reserve_and_lock_in_pool(pool, channel_out);
 
-    uvm_for_each_channel_in_pool(channel, pool) {
+    // Start the search at a channel picked by the current CPU, so that threads
+    // pushing concurrently from different CPUs tend to use different channels.
+    // Being migrated to a different CPU after this point is harmless.
+    first = raw_smp_processor_id() % pool->num_channels;
+
+    for (i = 0; i < pool->num_channels; i++) {
+        channel = &pool->channels[(first + i) % pool->num_channels];
+
         // TODO: Bug 1764953: Prefer idle/less busy channels
         if (try_claim_channel(channel, 1)) {
             *channel_out = channel;
@@ -404,7 +560,7 @@ static NV_STATUS channel_reserve_in_pool(uvm_channel_pool_t *pool, uvm_channel_t
         }
     }
 
-    uvm_spin_loop_init(&spin);
+    uvm_channel_waiter_init(&waiter);
     while (1) {
         uvm_for_each_channel_in_pool(channel, pool) {
             NV_STATUS status;
@@ -421,7 +577,7 @@ static NV_STATUS channel_reserve_in_pool(uvm_channel_pool_t *pool, uvm_channel_t
             if (status != NV_OK)
                 return status;
 
-            UVM_SPIN_LOOP(&spin);
+            uvm_channel_waiter_wait(&waiter, channel);
         }
     }
 
@@ -477,14 +633,14 @@ static NvU32 channel_get_available_push_info_index(uvm_channel_t *channel)
 {
     uvm_push_info_t *push_info;
 
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
 
     push_info = list_first_entry_or_null(&channel->available_push_infos, uvm_push_info_t, available_list_node);
     UVM_ASSERT(push_info != NULL);
     UVM_ASSERT(push_info->on_complete == NULL && push_info->on_complete_data == NULL);
     list_del(&push_info->available_list_node);
 
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
 
     return push_info - channel->push_infos;
 }
@@ -646,7 +802,7 @@ NV_STATUS uvm_channel_begin_push(uvm_channel_t *channel, uvm_push_t *push)
     return NV_OK;
 }
 
-static void internal_channel_submit_work(uvm_push_t *push, NvU32 push_size, NvU32 new_gpu_put)
+static void internal_channel_submit_work(uvm_push_t *push, NvU32 push_size, NvU32 new_gpu_put, bool defer_gpu_put)
 {
     NvU64 *gpfifo_entry;
     NvU64 pushbuffer_va;
@@ -676,7 +832,16 @@ static void internal_channel_submit_work(uvm_push_t *push, NvU32 push_size, NvU3
     // as the GPPut write happens.
     mb();
 
+    // The GPPUT write, and the doorbell ring that comes with it, is done by
+    // whichever of a later push, uvm_channel_flush_deferred_gpu_put() or the
+    // channel progress update comes first.
+    if (defer_gpu_put && channel->num_deferred_gpu_puts + 1 < UVM_CHANNEL_MAX_DEFERRED_GPU_PUTS) {
+        ++channel->num_deferred_gpu_puts;
+        return;
+    }
+
     gpu->parent->host_hal->write_gpu_put(channel, new_gpu_put);
+    channel->num_deferred_gpu_puts = 0;
 }
 
 static void proxy_channel_submit_work(uvm_push_t *push, NvU32 push_size)
@@ -1125,8 +1290,9 @@ void uvm_channel_end_push(uvm_push_t *push)
     NvU32 new_cpu_put;
     uvm_gpu_t *gpu = uvm_channel_get_gpu(channel);
     bool needs_sec2_work_submit = false;
+    bool defer_gpu_put = uvm_push_get_and_reset_flag(push, UVM_PUSH_FLAG_DEFER_GPU_PUT);
 
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
 
     encrypt_push(push);
 
@@ -1196,7 +1362,7 @@ void uvm_channel_end_push(uvm_push_t *push)
         }
     }
     else {
-        internal_channel_submit_work(push, push_size, new_cpu_put);
+        internal_channel_submit_work(push, push_size, new_cpu_put, defer_gpu_put);
     }
 
     channel->cpu_put = new_cpu_put;
@@ -1208,7 +1374,7 @@ void uvm_channel_end_push(uvm_push_t *push)
     // push must be updated before that. Notably uvm_pushbuffer_end_push() has
     // to be called first.
     unlock_channel_for_push(channel);
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
 
     // This memory barrier is borrowed from CUDA, as it supposedly fixes perf
     // issues on some systems. Comment from CUDA: "fixes throughput-related
@@ -1249,6 +1415,7 @@ static void submit_ctrl_gpfifo(uvm_channel_t *channel, uvm_gpfifo_entry_t *entry
     mb();
 
     gpu->parent->host_hal->write_gpu_put(channel, new_cpu_put);
+    channel->num_deferred_gpu_puts = 0;
 }
 
 static NV_STATUS submit_ctrl_gpfifo_indirect(uvm_channel_t *channel,
@@ -1319,7 +1486,7 @@ static void write_ctrl_gpfifo(uvm_channel_t *channel, NvU64 ctrl_fifo_entry_valu
     NvU32 cpu_put;
     NvU32 new_cpu_put;
 
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
 
     cpu_put = channel->cpu_put;
     new_cpu_put = (cpu_put + 1) % channel->num_gpfifo_entries;
@@ -1348,7 +1515,7 @@ static void write_ctrl_gpfifo(uvm_channel_t *channel, NvU64 ctrl_fifo_entry_valu
     // push must be updated before that. Note that we do not call
     // unlock_channel_for_push() because a control GPFIFO is followed by a
     // semaphore release, where the channel is unlocked.
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
 
     // Trigger indirect submission when needed.
     if (g_uvm_global.conf_computing_enabled && uvm_channel_is_ce(channel)) {
@@ -1502,14 +1669,14 @@ NV_STATUS uvm_channel_reserve(uvm_channel_t *channel, NvU32 num_gpfifo_entries)
 
 void uvm_channel_release(uvm_channel_t *channel, NvU32 num_gpfifo_entries)
 {
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
 
     UVM_ASSERT(uvm_channel_is_locked_for_push(channel));
     unlock_channel_for_push(channel);
 
     UVM_ASSERT(channel->current_gpfifo_count >= num_gpfifo_entries);
     channel->current_gpfifo_count -= num_gpfifo_entries;
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
 }
 
 // Get the first pending GPFIFO entry, if any.
@@ -1522,12 +1689,12 @@ static uvm_gpfifo_entry_t *uvm_channel_get_first_pending_entry(uvm_channel_t *ch
     if (pending_count == 0)
         return NULL;
 
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
 
     if (channel->gpu_get != channel->cpu_put)
         entry = &channel->gpfifo_entries[channel->gpu_get];
 
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
 
     return entry;
 }
@@ -2023,6 +2190,8 @@ static NV_STATUS channel_create(uvm_channel_pool_t *pool, uvm_channel_t *channel
     channel->pool = pool;
     pool->num_channels++;
     INIT_LIST_HEAD(&channel->available_push_infos);
+    init_waitqueue_head(&channel->wait.wq);
+    uvm_spin_lock_init(&channel->lock, UVM_LOCK_ORDER_CHANNEL);
     channel->tools.pending_event_count = 0;
     INIT_LIST_HEAD(&channel->tools.channel_list_node);
 
@@ -2530,6 +2699,11 @@ static void pick_ces_for_channel_types(uvm_channel_manager_t *manager,
         if (type < UVM_CHANNEL_TYPE_CE_COUNT)
             __set_bit(best_ce, manager->ce_mask);
     }
+
+    for (i = 0; i < UVM_COPY_ENGINE_COUNT_MAX; ++i) {
+        if (test_bit(i, manager->ce_mask) && ce_caps[i].nvlinkP2p)
+            __set_bit(i, manager->nvlink_p2p_ce_mask);
+    }
 }
 
 static void pick_ces(uvm_channel_manager_t *manager, const UvmGpuCopyEngineCaps *ce_caps, unsigned *preferred_ce)
@@ -2629,6 +2803,95 @@ static uvm_channel_pool_t *channel_manager_ce_pool(uvm_channel_manager_t *manage
     return pool;
 }
 
+// Return the pool to use for the given stripe of transfers that would use
+// default_pool otherwise. Stripes rotate over the CEs valid for the transfer
+// starting at the one of default_pool, so stripe 0 always maps to default_pool.
+//
+// Transfers to NVLINK peers are only striped over the CEs with NVLINK P2P
+// capabilities, and transfers to PCIe peers over the other ones, which is where
+// the optimal CE for each peer is picked from. Transfers to sysmem can use any
+// usable CE.
+static uvm_channel_pool_t *channel_manager_ce_stripe_pool(uvm_channel_manager_t *manager,
+                                                         uvm_channel_pool_t *default_pool,
+                                                         uvm_gpu_t *dst_gpu,
+                                                         NvU32 stripe)
+{
+    DECLARE_BITMAP(stripe_ce_mask, UVM_COPY_ENGINE_COUNT_MAX);
+    uvm_gpu_link_type_t link;
+    unsigned num_ces;
+    unsigned num_stripes;
+    unsigned index;
+    unsigned ce;
+
+    if (stripe == 0 || default_pool->pool_type != UVM_CHANNEL_POOL_TYPE_CE)
+        return default_pool;
+
+    // Copies done under Confidential Computing are bound to the DMA buffers,
+    // and IVs, of their channel type. Keep them on the default pool.
+    if (g_uvm_global.conf_computing_enabled)
+        return default_pool;
+
+    if (dst_gpu) {
+        link = uvm_gpu_peer_caps(manager->gpu, dst_gpu)->link_type;
+
+        if (link >= UVM_GPU_LINK_NVLINK_1)
+            bitmap_and(stripe_ce_mask, manager->ce_mask, manager->nvlink_p2p_ce_mask, UVM_COPY_ENGINE_COUNT_MAX);
+        else
+            bitmap_andnot(stripe_ce_mask, manager->ce_mask, manager->nvlink_p2p_ce_mask, UVM_COPY_ENGINE_COUNT_MAX);
+    }
+    else {
+        link = manager->gpu->parent->system_bus.link;
+        bitmap_copy(stripe_ce_mask, manager->ce_mask, UVM_COPY_ENGINE_COUNT_MAX);
+    }
+
+    // The default pool was picked with criteria the stripes don't know about
+    if (!test_bit(default_pool->engine_index, stripe_ce_mask))
+        return default_pool;
+
+    // A couple of CEs are enough to saturate a PCIe link, while the faster
+    // NVLINK and C2C links are worth spreading over all of the valid CEs.
+    num_ces = bitmap_weight(stripe_ce_mask, UVM_COPY_ENGINE_COUNT_MAX);
+    if (link >= UVM_GPU_LINK_NVLINK_1)
+        num_stripes = num_ces;
+    else
+        num_stripes = min(num_ces, (unsigned)UVM_CHANNEL_CE_STRIPES_PCIE);
+
+    index = (bitmap_weight(stripe_ce_mask, default_pool->engine_index) + stripe % num_stripes) % num_ces;
+
+    for_each_set_bit(ce, stripe_ce_mask, UVM_COPY_ENGINE_COUNT_MAX) {
+        if (index-- == 0)
+            break;
+    }
+
+    return channel_manager_ce_pool(manager, ce);
+}
+
+NV_STATUS uvm_channel_reserve_ce_stripe(uvm_channel_manager_t *manager,
+                                        uvm_channel_type_t type,
+                                        uvm_gpu_t *dst_gpu,
+                                        NvU32 stripe,
+                                        uvm_channel_t **channel_out)
+{
+    uvm_channel_pool_t *pool;
+
+    UVM_ASSERT(type < UVM_CHANNEL_TYPE_CE_COUNT);
+    UVM_ASSERT((dst_gpu != NULL) == (type == UVM_CHANNEL_TYPE_GPU_TO_GPU));
+
+    if (dst_gpu)
+        pool = manager->pool_to_use.gpu_to_gpu[uvm_id_gpu_index(dst_gpu->id)];
+    else
+        pool = NULL;
+
+    if (pool == NULL)
+        pool = manager->pool_to_use.default_for_type[type];
+
+    UVM_ASSERT(pool != NULL);
+
+    pool = channel_manager_ce_stripe_pool(manager, pool, dst_gpu, stripe);
+
+    return channel_reserve_in_pool(pool, channel_out);
+}
+
 void uvm_channel_manager_set_p2p_ce(uvm_channel_manager_t *manager, uvm_gpu_t *peer, NvU32 optimal_ce)
 {
     const NvU32 peer_gpu_index = uvm_id_gpu_index(peer->id);
@@ -3504,7 +3767,7 @@ static void uvm_channel_print_info(uvm_channel_t *channel, struct seq_file *s)
 {
     UVM_SEQ_OR_DBG_PRINT(s, "Channel %s\n", channel->name);
 
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
 
     UVM_SEQ_OR_DBG_PRINT(s, "completed          %llu\n", uvm_channel_update_completed_value(channel));
     UVM_SEQ_OR_DBG_PRINT(s, "queued             %llu\n", channel->tracking_sem.queued_value);
@@ -3516,7 +3779,11 @@ static void uvm_channel_print_info(uvm_channel_t *channel, struct seq_file *s)
     UVM_SEQ_OR_DBG_PRINT(s, "Semaphore GPU VA   0x%llx\n", uvm_channel_tracking_semaphore_get_gpu_va(channel));
     UVM_SEQ_OR_DBG_PRINT(s, "Semaphore CPU VA   0x%llx\n", (NvU64)uvm_gpu_semaphore_get_cpu_va(&channel->tracking_sem.semaphore));
 
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
+
+    UVM_SEQ_OR_DBG_PRINT(s, "wait spin time     %llu us\n", (NvU64)atomic64_read(&channel->wait.spin_ns) / 1000);
+    UVM_SEQ_OR_DBG_PRINT(s, "wait sleep time    %llu us\n", (NvU64)atomic64_read(&channel->wait.sleep_ns) / 1000);
+    UVM_SEQ_OR_DBG_PRINT(s, "wait sleeps        %llu\n", (NvU64)atomic64_read(&channel->wait.num_sleeps));
 }
 
 static void channel_print_push_acquires(uvm_push_acquire_info_t *push_acquire_info, struct seq_file *seq)
@@ -3560,7 +3827,7 @@ static void channel_print_pushes(uvm_channel_t *channel, NvU32 finished_pushes_c
 
     NvU64 completed_value = uvm_channel_update_completed_value(channel);
 
-    channel_pool_lock(channel->pool);
+    channel_lock(channel);
 
     cpu_put = channel->cpu_put;
 
@@ -3605,7 +3872,7 @@ static void channel_print_pushes(uvm_channel_t *channel, NvU32 finished_pushes_c
                 channel_print_push_acquires(push_acquire_info, seq);
         }
     }
-    channel_pool_unlock(channel->pool);
+    channel_unlock(channel);
 }
 
 void uvm_channel_print_pending_pushes(uvm_channel_t *channel)
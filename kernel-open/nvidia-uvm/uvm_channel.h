@@ -72,6 +72,16 @@
         uvm_assert_spinlock_locked(&(pool)->spinlock);  \
 })
 
+// Assert that the lock protecting the state of the channel is held. That is
+// the channel's own lock, unless the pool uses a mutex.
+#define uvm_channel_assert_locked(channel) (                            \
+{                                                                       \
+    if (uvm_channel_pool_uses_mutex((channel)->pool))                   \
+        uvm_assert_mutex_locked(&(channel)->pool->mutex);               \
+    else                                                                \
+        uvm_assert_spinlock_locked(&(channel)->lock);                   \
+})
+
 // Channel types
 typedef enum
 {
@@ -250,6 +260,11 @@ struct uvm_channel_struct
     // Owning pool
     uvm_channel_pool_t *pool;
 
+    // Lock protecting the state of the channel, unless the pool uses a mutex,
+    // in which case the pool lock is used. Aligned to keep concurrent pushes
+    // to different channels from sharing a cache line.
+    uvm_spinlock_t lock ____cacheline_aligned_in_smp;
+
     // The channel name contains the CE index, and (for UVM internal channels)
     // the HW runlist and channel IDs.
     char name[64];
@@ -265,6 +280,11 @@ struct uvm_channel_struct
     // uvm_channel_end_push().
     NvU32 cpu_put;
 
+    // Number of GPFIFO entries up to cpu_put that have been written, but not
+    // yet exposed to the GPU with a GPPUT update. See
+    // UVM_PUSH_FLAG_DEFER_GPU_PUT.
+    NvU32 num_deferred_gpu_puts;
+
     // Latest GPFIFO entry completed by the GPU
     // Updated by uvm_channel_update_progress() after checking pending GPFIFOs
     // for completion.
@@ -393,6 +413,25 @@ struct uvm_channel_struct
         struct proc_dir_entry *pushes;
     } procfs;
 
+    // Threads waiting for work on the channel to complete. See
+    // uvm_channel_waiter_t.
+    struct
+    {
+        // Woken up whenever uvm_channel_update_progress() completes GPFIFO
+        // entries
+        wait_queue_head_t wq;
+
+        // Incremented whenever GPFIFO entries are completed
+        atomic64_t completion_seq;
+
+        // Time waiters spent polling and sleeping, respectively
+        atomic64_t spin_ns;
+
+        atomic64_t sleep_ns;
+
+        atomic64_t num_sleeps;
+    } wait;
+
     // Information managed by the tools event notification mechanism. Mainly
     // used to keep a list of channels with pending events, which is needed
     // to collect the timestamps of asynchronous operations.
@@ -421,6 +460,10 @@ struct uvm_channel_manager_struct
     // has at least one pool of type UVM_CHANNEL_POOL_TYPE_CE associated with it
     DECLARE_BITMAP(ce_mask, UVM_COPY_ENGINE_COUNT_MAX);
 
+    // Subset of ce_mask containing the CEs with NVLINK P2P capabilities. See
+    // uvm_channel_reserve_ce_stripe().
+    DECLARE_BITMAP(nvlink_p2p_ce_mask, UVM_COPY_ENGINE_COUNT_MAX);
+
     struct
     {
         // Pools to be used by each channel type by default.
@@ -560,6 +603,29 @@ NV_STATUS uvm_channel_manager_check_errors(uvm_channel_manager_t *channel_manage
 // The channel has to be in error state prior to calling this function.
 uvm_gpfifo_entry_t *uvm_channel_get_fatal_entry(uvm_channel_t *channel);
 
+// State of a loop waiting for work submitted to a channel to complete. Each
+// iteration of the loop calls uvm_channel_waiter_wait(), which, depending on
+// the uvm_channel_wait_mode module parameter, either only polls with
+// UVM_SPIN_LOOP(), or polls for a short time and then sleeps on the channel's
+// wait queue with a timeout growing on each iteration.
+typedef struct
+{
+    uvm_spin_loop_t spin;
+
+    // End of the previous sleep, or start of the wait
+    NvU64 last_ns;
+
+    // Timeout of the next sleep
+    NvU32 sleep_us;
+} uvm_channel_waiter_t;
+
+void uvm_channel_waiter_init(uvm_channel_waiter_t *waiter);
+
+// Wait for some progress on the channel. Returns NV_ERR_TIMEOUT_RETRY if the
+// caller should print a warning that it's been waiting too long, like
+// UVM_SPIN_LOOP(), and NV_OK otherwise.
+NV_STATUS uvm_channel_waiter_wait(uvm_channel_waiter_t *waiter, uvm_channel_t *channel);
+
 // Update progress of a specific channel
 // Returns the number of still pending GPFIFO entries for that channel.
 // Notably some of the pending GPFIFO entries might be already completed, but
@@ -567,6 +633,15 @@ uvm_gpfifo_entry_t *uvm_channel_get_fatal_entry(uvm_channel_t *channel);
 // cost of the updates across calls.
 NvU32 uvm_channel_update_progress(uvm_channel_t *channel);
 
+// Update GPPUT of the channel to cover all the GPFIFO entries whose submission
+// was deferred with UVM_PUSH_FLAG_DEFER_GPU_PUT. This is a no-op if there are
+// no deferred entries.
+//
+// Updating the channel progress, waiting on a tracker entry or push and
+// acquiring a tracker entry in a push also flush the deferred entries, so
+// waiting for work never waits for work that hasn't been submitted.
+void uvm_channel_flush_deferred_gpu_put(uvm_channel_t *channel);
+
 // Update progress of all channels
 // Returns the number of still pending GPFIFO entries for all channels.
 // Notably some of the pending GPFIFO entries might be already completed, but
@@ -623,6 +698,22 @@ NV_STATUS uvm_channel_reserve_gpu_to_gpu(uvm_channel_manager_t *channel_manager,
                                          uvm_gpu_t *dst_gpu,
                                          uvm_channel_t **channel_out);
 
+// Select and reserve a channel for a CE transfer of the given type, spreading
+// independent transfers over multiple CEs. Transfers in the same stripe use the
+// same CE, and stripe 0 uses the same channels as uvm_channel_reserve_type()
+// or uvm_channel_reserve_gpu_to_gpu(). The number of distinct stripes depends
+// on the link bandwidth to the destination, and peer transfers are only
+// striped over the CEs valid for the peer link type: the ones with NVLINK P2P
+// capabilities for NVLINK peers, and the other ones for PCIe peers.
+//
+// dst_gpu must be provided for UVM_CHANNEL_TYPE_GPU_TO_GPU, and be NULL for
+// any other type.
+NV_STATUS uvm_channel_reserve_ce_stripe(uvm_channel_manager_t *manager,
+                                        uvm_channel_type_t type,
+                                        uvm_gpu_t *dst_gpu,
+                                        NvU32 stripe,
+                                        uvm_channel_t **channel_out);
+
 // Reserve a specific channel for a push or for a control GPFIFO entry.
 NV_STATUS uvm_channel_reserve(uvm_channel_t *channel, NvU32 num_gpfifo_entries);
 
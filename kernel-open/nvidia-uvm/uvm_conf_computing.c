@@ -56,6 +56,17 @@ static ulong uvm_conf_computing_channel_iv_rotation_limit = UVM_CONF_COMPUTING_I
 
 module_param(uvm_conf_computing_channel_iv_rotation_limit, ulong, S_IRUGO);
 
+// Number of DMA staging buffers created for each GPU at registration time. The
+// pool still grows on demand once all of them are in use. Each buffer is
+// UVM_CONF_COMPUTING_DMA_BUFFER_SIZE bytes of unprotected sysmem.
+#define UVM_CONF_COMPUTING_DMA_BUFFER_POOL_SIZE_DEFAULT 32
+#define UVM_CONF_COMPUTING_DMA_BUFFER_POOL_SIZE_MAX     1024
+
+static unsigned uvm_conf_computing_dma_buffer_pool_size = UVM_CONF_COMPUTING_DMA_BUFFER_POOL_SIZE_DEFAULT;
+module_param(uvm_conf_computing_dma_buffer_pool_size, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_conf_computing_dma_buffer_pool_size,
+                 "Initial number of Confidential Computing DMA staging buffers per GPU");
+
 static UvmGpuConfComputeMode uvm_conf_computing_get_mode(const uvm_parent_gpu_t *parent)
 {
     return parent->rm_info.gpuConfComputeCaps.mode;
@@ -102,6 +113,38 @@ static uvm_gpu_t *dma_buffer_pool_to_gpu(uvm_conf_computing_dma_buffer_pool_t *d
     return container_of(dma_buffer_pool, uvm_gpu_t, conf_computing.dma_buffer_pool);
 }
 
+// Allocate the backing storage of a DMA stage buffer. A single physically
+// contiguous chunk is attempted first, so the buffer can be mapped with a
+// single large GPU page and the CEs can address it physically. If that fails,
+// for example due to fragmentation, fall back to the default page size.
+static NV_STATUS dma_buffer_alloc_sysmem(uvm_gpu_t *dma_owner, uvm_mem_t **mem_out)
+{
+    NV_STATUS status;
+    uvm_mem_t *mem;
+    uvm_mem_alloc_params_t params = { 0 };
+
+    params.size = UVM_CONF_COMPUTING_DMA_BUFFER_SIZE;
+    params.dma_owner = dma_owner;
+    params.page_size = UVM_CONF_COMPUTING_DMA_BUFFER_SIZE;
+
+    status = uvm_mem_alloc(&params, &mem);
+    if (status != NV_OK) {
+        params.page_size = UVM_PAGE_SIZE_DEFAULT;
+        status = uvm_mem_alloc(&params, &mem);
+        if (status != NV_OK)
+            return status;
+    }
+
+    status = uvm_mem_map_cpu_kernel(mem);
+    if (status != NV_OK) {
+        uvm_mem_free(mem);
+        return status;
+    }
+
+    *mem_out = mem;
+    return NV_OK;
+}
+
 // Allocate and map a new DMA stage buffer to CPU and GPU (VA)
 static NV_STATUS dma_buffer_create(uvm_conf_computing_dma_buffer_pool_t *dma_buffer_pool,
                                    uvm_conf_computing_dma_buffer_t **dma_buffer_out)
@@ -120,7 +163,7 @@ static NV_STATUS dma_buffer_create(uvm_conf_computing_dma_buffer_pool_t *dma_buf
     uvm_tracker_init(&dma_buffer->tracker);
     INIT_LIST_HEAD(&dma_buffer->node);
 
-    status = uvm_mem_alloc_sysmem_dma_and_map_cpu_kernel(UVM_CONF_COMPUTING_DMA_BUFFER_SIZE, dma_owner, NULL, &alloc);
+    status = dma_buffer_alloc_sysmem(dma_owner, &alloc);
     if (status != NV_OK)
         goto err;
 
@@ -195,9 +238,16 @@ static void dma_buffer_pool_add(uvm_conf_computing_dma_buffer_pool_t *dma_buffer
 static NV_STATUS conf_computing_dma_buffer_pool_init(uvm_conf_computing_dma_buffer_pool_t *dma_buffer_pool)
 {
     size_t i;
-    size_t num_dma_buffers = 32;
+    size_t num_dma_buffers = uvm_conf_computing_dma_buffer_pool_size;
     NV_STATUS status = NV_OK;
 
+    if (num_dma_buffers == 0 || num_dma_buffers > UVM_CONF_COMPUTING_DMA_BUFFER_POOL_SIZE_MAX) {
+        pr_info("Invalid value for uvm_conf_computing_dma_buffer_pool_size = %u, using %u instead\n",
+                uvm_conf_computing_dma_buffer_pool_size,
+                UVM_CONF_COMPUTING_DMA_BUFFER_POOL_SIZE_DEFAULT);
+        num_dma_buffers = UVM_CONF_COMPUTING_DMA_BUFFER_POOL_SIZE_DEFAULT;
+    }
+
     UVM_ASSERT(dma_buffer_pool->num_dma_buffers == 0);
     UVM_ASSERT(g_uvm_global.conf_computing_enabled);
 
@@ -290,6 +340,7 @@ NV_STATUS uvm_conf_computing_dma_buffer_alloc(uvm_conf_computing_dma_buffer_pool
         goto error;
 
     uvm_page_mask_zero(&dma_buffer->encrypted_page_mask);
+    uvm_page_mask_zero(&dma_buffer->encryption_start_page_mask);
     *dma_buffer_out = dma_buffer;
 
     return status;
@@ -91,7 +91,8 @@ typedef struct
     // writes the authentication tag here. Later when the buffer is decrypted
     // on the CPU the authentication tag is used again (read) for CSL to verify
     // the authenticity. The allocation is big enough for one authentication
-    // tag per PAGE_SIZE page in the alloc buffer.
+    // tag per PAGE_SIZE page in the alloc buffer. An encryption spanning
+    // multiple pages uses the authentication tag of its first page.
     uvm_mem_t *auth_tag;
 
     // CSL supports out-of-order decryption, the decrypt IV is used similarly
@@ -103,6 +104,12 @@ typedef struct
     // Bitmap of the encrypted pages in the backing allocation
     uvm_page_mask_t encrypted_page_mask;
 
+    // Bitmap of the first page of each encryption in the backing allocation.
+    // An encryption covers the pages in encrypted_page_mask from its first
+    // page up to, and excluding, the first page of the next encryption or the
+    // next page not in encrypted_page_mask.
+    uvm_page_mask_t encryption_start_page_mask;
+
     // See uvm_conf_computing_dma_pool lists
     struct list_head node;
 } uvm_conf_computing_dma_buffer_t;
@@ -121,7 +128,8 @@ typedef struct
 // the DMA buffer, the caller is responsible for either acquiring or waiting
 // on out_tracker. If out_tracker is NULL, the wait happens in the allocation
 // itself.
-// Upon success the encrypted_page_mask is cleared as part of the allocation.
+// Upon success the encrypted_page_mask and encryption_start_page_mask are
+// cleared as part of the allocation.
 NV_STATUS uvm_conf_computing_dma_buffer_alloc(uvm_conf_computing_dma_buffer_pool_t *dma_buffer_pool,
                                               uvm_conf_computing_dma_buffer_t **out_dma_buffer,
                                               uvm_tracker_t *out_tracker);
@@ -58,6 +58,7 @@ typedef struct uvm_gpfifo_entry_struct uvm_gpfifo_entry_t;
 typedef struct uvm_va_policy_struct uvm_va_policy_t;
 typedef struct uvm_va_range_struct uvm_va_range_t;
 typedef struct uvm_va_block_struct uvm_va_block_t;
+typedef struct uvm_va_block_context_struct uvm_va_block_context_t;
 typedef struct uvm_va_block_test_struct uvm_va_block_test_t;
 typedef struct uvm_va_block_wrapper_struct uvm_va_block_wrapper_t;
 typedef struct uvm_va_block_retry_struct uvm_va_block_retry_t;
@@ -68,6 +69,8 @@ typedef struct uvm_make_resident_context_struct uvm_make_resident_context_t;
 
 typedef struct uvm_gpu_va_space_struct uvm_gpu_va_space_t;
 
+typedef struct uvm_ext_pte_cache_entry_struct uvm_ext_pte_cache_entry_t;
+
 typedef struct uvm_thread_context_lock_struct uvm_thread_context_lock_t;
 typedef struct uvm_thread_context_struct uvm_thread_context_t;
 typedef struct uvm_thread_context_wrapper_struct uvm_thread_context_wrapper_t;
@@ -112,6 +112,12 @@ NV_STATUS uvm_global_init(void)
         goto error;
     }
 
+    status = uvm_object_cache_procfs_init();
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("uvm_object_cache_procfs_init() failed: %s\n", nvstatusToString(status));
+        goto error;
+    }
+
     status = uvm_rm_locked_call(nvUvmInterfaceSessionCreate(&g_uvm_global.rm_session_handle, &platform_info));
     if (status != NV_OK) {
         UVM_ERR_PRINT("nvUvmInterfaceSessionCreate() failed: %s\n", nvstatusToString(status));
@@ -219,6 +225,10 @@ void uvm_global_exit(void)
     nv_kthread_q_flush(&g_uvm_global.deferred_release_q);
 
     uvm_unregister_callbacks();
+
+    // The preallocated contexts come from the VA block and service context
+    // caches, free them before the caches are destroyed.
+    uvm_thread_context_free_preallocated();
     uvm_service_block_context_exit();
 
     uvm_perf_heuristics_exit();
@@ -235,6 +245,7 @@ void uvm_global_exit(void)
     if (g_uvm_global.rm_session_handle != 0)
         uvm_rm_locked_call_void(nvUvmInterfaceSessionDestroy(g_uvm_global.rm_session_handle));
 
+    uvm_object_cache_procfs_exit();
     uvm_procfs_exit();
 
     nv_kthread_q_stop(&g_uvm_global.deferred_release_q);
@@ -320,6 +331,15 @@ static NV_STATUS uvm_suspend(void)
 
         nv_kthread_q_flush(&gpu->parent->isr.bottom_half_q);
 
+        uvm_perf_prefetch_queue_flush(&gpu->parent->fault_buffer_info.replayable.prefetch_queue);
+
+        if (gpu->parent->access_counters_supported)
+            uvm_parent_gpu_access_counters_promotion_flush(gpu->parent, NULL);
+
+        uvm_pmm_gpu_flush_background_eviction(&gpu->pmm);
+
+        uvm_pmm_gpu_flush_zero_pool(&gpu->pmm);
+
         if (gpu->parent->isr.non_replayable_faults.handling)
             nv_kthread_q_flush(&gpu->parent->isr.kill_channel_q);
     }
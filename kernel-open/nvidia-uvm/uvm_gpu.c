@@ -23,6 +23,7 @@
 
 #include "nv_uvm_interface.h"
 #include "uvm_api.h"
+#include "uvm_ce_calibration.h"
 #include "uvm_channel.h"
 #include "uvm_global.h"
 #include "uvm_gpu.h"
@@ -32,6 +33,7 @@
 #include "uvm_pmm_gpu.h"
 #include "uvm_pmm_sysmem.h"
 #include "uvm_va_space.h"
+#include "uvm_va_range.h"
 #include "uvm_user_channel.h"
 #include "uvm_perf_events.h"
 #include "uvm_perf_heuristics.h"
@@ -39,6 +41,7 @@
 #include "ctrl2080mc.h"
 #include "nv-kthread-q.h"
 #include "uvm_gpu_access_counters.h"
+#include "uvm_map_external.h"
 #include "uvm_ats.h"
 #include "uvm_test.h"
 #include "uvm_conf_computing.h"
@@ -502,6 +505,19 @@ static void gpu_info_print_common(uvm_gpu_t *gpu, struct seq_file *s)
     UVM_SEQ_OR_DBG_PRINT(s, "CPU link bandwidth                     %uMBps\n",
                          gpu->parent->system_bus.link_rate_mbyte_per_s);
 
+    if (gpu->channel_manager) {
+        unsigned long ce;
+
+        UVM_SEQ_OR_DBG_PRINT(s, "ce_bandwidth (MBps)                    cpu_to_gpu gpu_to_cpu gpu_internal\n");
+        for_each_set_bit(ce, gpu->channel_manager->ce_mask, UVM_COPY_ENGINE_COUNT_MAX) {
+            UVM_SEQ_OR_DBG_PRINT(s, "    ce%02lu                               %10u %10u %12u\n",
+                                 ce,
+                                 gpu->ce_bandwidth.cpu_to_gpu_mbyte_per_s[ce],
+                                 gpu->ce_bandwidth.gpu_to_cpu_mbyte_per_s[ce],
+                                 gpu->ce_bandwidth.gpu_internal_mbyte_per_s[ce]);
+        }
+    }
+
     UVM_SEQ_OR_DBG_PRINT(s, "architecture                           0x%X\n", gpu_info->gpuArch);
     UVM_SEQ_OR_DBG_PRINT(s, "implementation                         0x%X\n", gpu_info->gpuImplementation);
     UVM_SEQ_OR_DBG_PRINT(s, "gpcs                                   %u\n", gpu_info->gpcCount);
@@ -548,6 +564,12 @@ static void gpu_info_print_common(uvm_gpu_t *gpu, struct seq_file *s)
                                  cpu,
                                  gpu->parent->isr.replayable_faults.stats.cpu_exec_count[cpu]);
         }
+        UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults_bh_remote_node       %llu\n",
+                             gpu->parent->isr.replayable_faults.stats.remote_node_count);
+        UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults_bh_polls             %llu\n",
+                             gpu->parent->isr.replayable_faults.stats.poll_count);
+        UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults_bh_poll_budget       %u\n",
+                             gpu->parent->isr.replayable_faults.poll_budget);
         UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults_buffer_entries       %u\n",
                              gpu->parent->fault_buffer_info.replayable.max_faults);
         UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults_cached_get           %u\n",
@@ -562,8 +584,10 @@ static void gpu_info_print_common(uvm_gpu_t *gpu, struct seq_file *s)
                              gpu->parent->fault_buffer_info.max_batch_size);
         UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults_replay_policy        %s\n",
                              uvm_perf_fault_replay_policy_string(gpu->parent->fault_buffer_info.replayable.replay_policy));
+        UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults_service_workers      %u\n",
+                             gpu->parent->fault_buffer_info.replayable.service_workers.count);
         UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults_num_faults           %llu\n",
-                             gpu->parent->stats.num_replayable_faults);
+                             (NvU64)atomic64_read(&gpu->parent->stats.num_replayable_faults));
     }
     if (gpu->parent->isr.non_replayable_faults.handling) {
         UVM_SEQ_OR_DBG_PRINT(s, "non_replayable_faults_bh               %llu\n",
@@ -574,10 +598,12 @@ static void gpu_info_print_common(uvm_gpu_t *gpu, struct seq_file *s)
                                  cpu,
                                  gpu->parent->isr.non_replayable_faults.stats.cpu_exec_count[cpu]);
         }
+        UVM_SEQ_OR_DBG_PRINT(s, "non_replayable_faults_bh_remote_node   %llu\n",
+                             gpu->parent->isr.non_replayable_faults.stats.remote_node_count);
         UVM_SEQ_OR_DBG_PRINT(s, "non_replayable_faults_buffer_entries   %u\n",
                              gpu->parent->fault_buffer_info.non_replayable.max_faults);
         UVM_SEQ_OR_DBG_PRINT(s, "non_replayable_faults_num_faults       %llu\n",
-                             gpu->parent->stats.num_non_replayable_faults);
+                             (NvU64)atomic64_read(&gpu->parent->stats.num_non_replayable_faults));
     }
 
     if (gpu->parent->isr.access_counters.handling_ref_count > 0) {
@@ -589,6 +615,8 @@ static void gpu_info_print_common(uvm_gpu_t *gpu, struct seq_file *s)
                                  cpu,
                                  gpu->parent->isr.access_counters.stats.cpu_exec_count[cpu]);
         }
+        UVM_SEQ_OR_DBG_PRINT(s, "access_counters_bh_remote_node         %llu\n",
+                             gpu->parent->isr.access_counters.stats.remote_node_count);
         UVM_SEQ_OR_DBG_PRINT(s, "access_counters_buffer_entries         %u\n",
                              gpu->parent->access_counter_buffer_info.max_notifications);
         UVM_SEQ_OR_DBG_PRINT(s, "access_counters_cached_get             %u\n",
@@ -616,6 +644,92 @@ static void gpu_info_print_common(uvm_gpu_t *gpu, struct seq_file *s)
     UVM_SEQ_OR_DBG_PRINT(s, "mapped_cpu_pages_dma                   %llu (%llu MB)\n",
                          mapped_cpu_pages_size / PAGE_SIZE,
                          mapped_cpu_pages_size / (1024u * 1024u));
+    UVM_SEQ_OR_DBG_PRINT(s, "ext_pte_cache_hits                     %llu\n",
+                         (NvU64)atomic64_read(&gpu->ext_pte_cache.hits));
+    UVM_SEQ_OR_DBG_PRINT(s, "ext_pte_cache_misses                   %llu\n",
+                         (NvU64)atomic64_read(&gpu->ext_pte_cache.misses));
+    UVM_SEQ_OR_DBG_PRINT(s, "remote_node_va_block_states            %llu\n",
+                         (NvU64)atomic64_read(&gpu->parent->stats.num_remote_node_va_block_states));
+
+    if (uvm_parent_gpu_supports_eviction(gpu->parent)) {
+        NvU64 num_evicted_pages = atomic64_read(&gpu->pmm.eviction_stats.num_evicted_pages);
+        NvU64 num_refaulted_pages = atomic64_read(&gpu->pmm.eviction_stats.num_refaulted_pages);
+
+        UVM_SEQ_OR_DBG_PRINT(s, "eviction_policy                        %s\n",
+                             uvm_pmm_gpu_eviction_policy_name(&gpu->pmm));
+        UVM_SEQ_OR_DBG_PRINT(s, "evicted_root_chunks                    %llu\n",
+                             (NvU64)atomic64_read(&gpu->pmm.eviction_stats.num_evicted_root_chunks));
+        UVM_SEQ_OR_DBG_PRINT(s, "eviction_second_chances                %llu\n",
+                             (NvU64)atomic64_read(&gpu->pmm.eviction_stats.num_second_chances));
+        UVM_SEQ_OR_DBG_PRINT(s, "evicted_pages                          %llu (%llu MB)\n",
+                             num_evicted_pages,
+                             (num_evicted_pages * (NvU64)PAGE_SIZE) / (1024u * 1024u));
+        UVM_SEQ_OR_DBG_PRINT(s, "refaulted_evicted_pages                %llu (%llu%%)\n",
+                             num_refaulted_pages,
+                             num_evicted_pages ? (num_refaulted_pages * 100) / num_evicted_pages : 0);
+        UVM_SEQ_OR_DBG_PRINT(s, "gpu_resident_reservation_quota         %llu MB\n",
+                             uvm_va_range_gpu_resident_reservation_quota(gpu) / (1024u * 1024u));
+        UVM_SEQ_OR_DBG_PRINT(s, "gpu_resident_reservations              %llu MB\n",
+                             (NvU64)atomic64_read(&gpu->pmm.root_chunks.reservation_size) / (1024u * 1024u));
+        UVM_SEQ_OR_DBG_PRINT(s, "reserved_root_chunks                   %zu\n",
+                             UVM_READ_ONCE(gpu->pmm.root_chunks.num_reserved));
+
+        if (gpu->pmm.background_eviction.enabled) {
+            UVM_SEQ_OR_DBG_PRINT(s, "background_eviction_watermarks         %llu-%llu\n",
+                                 gpu->pmm.background_eviction.low_watermark,
+                                 gpu->pmm.background_eviction.high_watermark);
+            UVM_SEQ_OR_DBG_PRINT(s, "background_evicted_root_chunks         %llu\n",
+                                 (NvU64)atomic64_read(&gpu->pmm.background_eviction.num_evicted_root_chunks));
+        }
+    }
+
+    if (gpu->pmm.pma_stats) {
+        NvU64 num_scrub_pending = UVM_READ_ONCE(gpu->pmm.pma_stats->numScrubPendingPages64k);
+        NvU64 num_scrubbed = UVM_READ_ONCE(gpu->pmm.pma_stats->numScrubbedPages64k);
+
+        UVM_SEQ_OR_DBG_PRINT(s, "pma_scrub_pending                      %llu MB\n",
+                             (num_scrub_pending * UVM_PAGE_SIZE_64K) / (1024u * 1024u));
+        UVM_SEQ_OR_DBG_PRINT(s, "pma_scrubbed                           %llu MB\n",
+                             (num_scrubbed * UVM_PAGE_SIZE_64K) / (1024u * 1024u));
+    }
+
+    UVM_SEQ_OR_DBG_PRINT(s, "pmm_claim_lock_acquisitions            %llu\n",
+                         UVM_READ_ONCE(gpu->pmm.claim_stats.num_lock_acquisitions));
+    UVM_SEQ_OR_DBG_PRINT(s, "pmm_claim_lock_contended               %llu\n",
+                         UVM_READ_ONCE(gpu->pmm.claim_stats.num_lock_contended));
+    UVM_SEQ_OR_DBG_PRINT(s, "pmm_claimed_chunks                     %llu\n",
+                         UVM_READ_ONCE(gpu->pmm.claim_stats.num_claimed_chunks));
+
+    if (gpu->pmm.chunk_cache.enabled) {
+        UVM_SEQ_OR_DBG_PRINT(s, "pmm_chunk_cache_size                   %u\n", gpu->pmm.chunk_cache.capacity);
+        UVM_SEQ_OR_DBG_PRINT(s, "pmm_chunk_cache_hits                   %llu\n",
+                             uvm_pmm_gpu_chunk_cache_hits(&gpu->pmm));
+        UVM_SEQ_OR_DBG_PRINT(s, "pmm_chunk_cache_drained_chunks         %llu\n",
+                             (NvU64)atomic64_read(&gpu->pmm.chunk_cache.num_drained_chunks));
+    }
+
+    if (gpu->pmm.root_chunk_cache.capacity > 0) {
+        UVM_SEQ_OR_DBG_PRINT(s, "pmm_root_chunk_cache_size              %u\n", gpu->pmm.root_chunk_cache.capacity);
+        UVM_SEQ_OR_DBG_PRINT(s, "pmm_root_chunk_cache_retained_chunks   %llu\n",
+                             (NvU64)atomic64_read(&gpu->pmm.root_chunk_cache.num_retained_chunks));
+        UVM_SEQ_OR_DBG_PRINT(s, "pmm_root_chunk_cache_released_chunks   %llu\n",
+                             (NvU64)atomic64_read(&gpu->pmm.root_chunk_cache.num_released_chunks));
+    }
+
+    if (gpu->pmm.zero_pool.enabled) {
+        UVM_SEQ_OR_DBG_PRINT(s, "zero_pool_target                       %u\n", gpu->pmm.zero_pool.target);
+        UVM_SEQ_OR_DBG_PRINT(s, "zero_pool_zeroed_chunks                %llu\n",
+                             (NvU64)atomic64_read(&gpu->pmm.zero_pool.num_zeroed_chunks));
+        UVM_SEQ_OR_DBG_PRINT(s, "zero_pool_hits                         %llu\n",
+                             (NvU64)atomic64_read(&gpu->pmm.zero_pool.num_zero_hits));
+        UVM_SEQ_OR_DBG_PRINT(s, "zero_pool_misses                       %llu\n",
+                             (NvU64)atomic64_read(&gpu->pmm.zero_pool.num_zero_misses));
+    }
+
+    UVM_SEQ_OR_DBG_PRINT(s, "big_page_promoted_blocks               %llu\n",
+                         (NvU64)atomic64_read(&gpu->big_page_promotion.num_promoted_blocks));
+    UVM_SEQ_OR_DBG_PRINT(s, "big_page_promotion_failures            %llu\n",
+                         (NvU64)atomic64_read(&gpu->big_page_promotion.num_failed));
 
     gpu_info_print_ce_caps(gpu, s);
 
@@ -630,21 +744,26 @@ gpu_fault_stats_print_common(uvm_parent_gpu_t *parent_gpu, struct seq_file *s)
 {
     NvU64 num_pages_in;
     NvU64 num_pages_out;
+    NvU64 num_block_lock_contended;
+    NvU64 block_lock_wait_ns;
+    NvU64 num_faults;
+    NvU64 num_physical_faults;
 
     UVM_ASSERT(uvm_procfs_is_debug_enabled());
 
-    UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults      %llu\n", parent_gpu->stats.num_replayable_faults);
+    UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults      %llu\n",
+                         (NvU64)atomic64_read(&parent_gpu->stats.num_replayable_faults));
     UVM_SEQ_OR_DBG_PRINT(s, "duplicates             %llu\n",
-                         parent_gpu->fault_buffer_info.replayable.stats.num_duplicate_faults);
+                         (NvU64)atomic64_read(&parent_gpu->fault_buffer_info.replayable.stats.num_duplicate_faults));
     UVM_SEQ_OR_DBG_PRINT(s, "faults_by_access_type:\n");
     UVM_SEQ_OR_DBG_PRINT(s, "  prefetch             %llu\n",
-                         parent_gpu->fault_buffer_info.replayable.stats.num_prefetch_faults);
+                         (NvU64)atomic64_read(&parent_gpu->fault_buffer_info.replayable.stats.num_prefetch_faults));
     UVM_SEQ_OR_DBG_PRINT(s, "  read                 %llu\n",
-                         parent_gpu->fault_buffer_info.replayable.stats.num_read_faults);
+                         (NvU64)atomic64_read(&parent_gpu->fault_buffer_info.replayable.stats.num_read_faults));
     UVM_SEQ_OR_DBG_PRINT(s, "  write                %llu\n",
-                         parent_gpu->fault_buffer_info.replayable.stats.num_write_faults);
+                         (NvU64)atomic64_read(&parent_gpu->fault_buffer_info.replayable.stats.num_write_faults));
     UVM_SEQ_OR_DBG_PRINT(s, "  atomic               %llu\n",
-                         parent_gpu->fault_buffer_info.replayable.stats.num_atomic_faults);
+                         (NvU64)atomic64_read(&parent_gpu->fault_buffer_info.replayable.stats.num_atomic_faults));
     num_pages_out = atomic64_read(&parent_gpu->fault_buffer_info.replayable.stats.num_pages_out);
     num_pages_in = atomic64_read(&parent_gpu->fault_buffer_info.replayable.stats.num_pages_in);
     UVM_SEQ_OR_DBG_PRINT(s, "migrations:\n");
@@ -652,25 +771,55 @@ gpu_fault_stats_print_common(uvm_parent_gpu_t *parent_gpu, struct seq_file *s)
                          (num_pages_in * (NvU64)PAGE_SIZE) / (1024u * 1024u));
     UVM_SEQ_OR_DBG_PRINT(s, "  num_pages_out        %llu (%llu MB)\n", num_pages_out,
                          (num_pages_out * (NvU64)PAGE_SIZE) / (1024u * 1024u));
+    num_block_lock_contended = atomic64_read(&parent_gpu->fault_buffer_info.replayable.stats.num_block_lock_contended);
+    block_lock_wait_ns = atomic64_read(&parent_gpu->fault_buffer_info.replayable.stats.block_lock_wait_ns);
+    UVM_SEQ_OR_DBG_PRINT(s, "block_lock_contention:\n");
+    UVM_SEQ_OR_DBG_PRINT(s, "  contended            %llu\n", num_block_lock_contended);
+    UVM_SEQ_OR_DBG_PRINT(s, "  wait_us              %llu\n", block_lock_wait_ns / 1000);
+    if (uvm_hmm_is_enabled_system_wide()) {
+        uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+
+        UVM_SEQ_OR_DBG_PRINT(s, "hmm:\n");
+        UVM_SEQ_OR_DBG_PRINT(s, "  blocks               %llu\n",
+                             (NvU64)atomic64_read(&replayable_faults->stats.hmm.num_blocks));
+        UVM_SEQ_OR_DBG_PRINT(s, "  cpu_fault_retries    %llu\n",
+                             (NvU64)atomic64_read(&replayable_faults->stats.hmm.num_cpu_fault_retries));
+        UVM_SEQ_OR_DBG_PRINT(s, "  migrate_setup_us     %llu\n",
+                             (NvU64)atomic64_read(&replayable_faults->stats.hmm.migrate_setup_ns) / 1000);
+        UVM_SEQ_OR_DBG_PRINT(s, "  copy_us              %llu\n",
+                             (NvU64)atomic64_read(&replayable_faults->stats.hmm.copy_ns) / 1000);
+        UVM_SEQ_OR_DBG_PRINT(s, "  finalize_us          %llu\n",
+                             (NvU64)atomic64_read(&replayable_faults->stats.hmm.finalize_ns) / 1000);
+        UVM_SEQ_OR_DBG_PRINT(s, "  cpu_fault_us         %llu\n",
+                             (NvU64)atomic64_read(&replayable_faults->stats.hmm.cpu_fault_ns) / 1000);
+    }
     UVM_SEQ_OR_DBG_PRINT(s, "replays:\n");
     UVM_SEQ_OR_DBG_PRINT(s, "  start                %llu\n",
                          parent_gpu->fault_buffer_info.replayable.stats.num_replays);
     UVM_SEQ_OR_DBG_PRINT(s, "  start_ack_all        %llu\n",
                          parent_gpu->fault_buffer_info.replayable.stats.num_replays_ack_all);
-    UVM_SEQ_OR_DBG_PRINT(s, "non_replayable_faults  %llu\n", parent_gpu->stats.num_non_replayable_faults);
+    if (parent_gpu->fault_buffer_info.replayable.prefetch_queue.enabled) {
+        uvm_perf_prefetch_queue_t *prefetch_queue = &parent_gpu->fault_buffer_info.replayable.prefetch_queue;
+
+        UVM_SEQ_OR_DBG_PRINT(s, "deferred_prefetches:\n");
+        UVM_SEQ_OR_DBG_PRINT(s, "  posted               %llu\n", prefetch_queue->stats.num_posted);
+        UVM_SEQ_OR_DBG_PRINT(s, "  queue_full           %llu\n", prefetch_queue->stats.num_full);
+        UVM_SEQ_OR_DBG_PRINT(s, "  serviced             %llu\n", prefetch_queue->stats.num_serviced);
+    }
+    num_faults = atomic64_read(&parent_gpu->stats.num_non_replayable_faults);
+    num_physical_faults = atomic64_read(&parent_gpu->fault_buffer_info.non_replayable.stats.num_physical_faults);
+    UVM_SEQ_OR_DBG_PRINT(s, "non_replayable_faults  %llu\n", num_faults);
     UVM_SEQ_OR_DBG_PRINT(s, "faults_by_access_type:\n");
     UVM_SEQ_OR_DBG_PRINT(s, "  read                 %llu\n",
-                         parent_gpu->fault_buffer_info.non_replayable.stats.num_read_faults);
+                         (NvU64)atomic64_read(&parent_gpu->fault_buffer_info.non_replayable.stats.num_read_faults));
     UVM_SEQ_OR_DBG_PRINT(s, "  write                %llu\n",
-                         parent_gpu->fault_buffer_info.non_replayable.stats.num_write_faults);
+                         (NvU64)atomic64_read(&parent_gpu->fault_buffer_info.non_replayable.stats.num_write_faults));
     UVM_SEQ_OR_DBG_PRINT(s, "  atomic               %llu\n",
-                         parent_gpu->fault_buffer_info.non_replayable.stats.num_atomic_faults);
+                         (NvU64)atomic64_read(&parent_gpu->fault_buffer_info.non_replayable.stats.num_atomic_faults));
     UVM_SEQ_OR_DBG_PRINT(s, "faults_by_addressing:\n");
     UVM_SEQ_OR_DBG_PRINT(s, "  virtual              %llu\n",
-                         parent_gpu->stats.num_non_replayable_faults -
-                         parent_gpu->fault_buffer_info.non_replayable.stats.num_physical_faults);
-    UVM_SEQ_OR_DBG_PRINT(s, "  physical             %llu\n",
-                         parent_gpu->fault_buffer_info.non_replayable.stats.num_physical_faults);
+                         num_faults - num_physical_faults);
+    UVM_SEQ_OR_DBG_PRINT(s, "  physical             %llu\n", num_physical_faults);
     num_pages_out = atomic64_read(&parent_gpu->fault_buffer_info.non_replayable.stats.num_pages_out);
     num_pages_in = atomic64_read(&parent_gpu->fault_buffer_info.non_replayable.stats.num_pages_in);
     UVM_SEQ_OR_DBG_PRINT(s, "migrations:\n");
@@ -680,6 +829,113 @@ gpu_fault_stats_print_common(uvm_parent_gpu_t *parent_gpu, struct seq_file *s)
                          (num_pages_out * (NvU64)PAGE_SIZE) / (1024u * 1024u));
 }
 
+static void gpu_fault_batch_print_common(uvm_parent_gpu_t *parent_gpu, struct seq_file *s)
+{
+    NvU32 i;
+    NvU32 first;
+    NvU32 history_count;
+
+    UVM_ASSERT(uvm_procfs_is_debug_enabled());
+
+    if (!parent_gpu->replayable_faults_supported)
+        return;
+
+    history_count = parent_gpu->fault_buffer_info.replayable.adaptive_batch.history_count;
+    first = history_count > UVM_FAULT_BATCH_COUNT_HISTORY_LENGTH?
+                history_count - UVM_FAULT_BATCH_COUNT_HISTORY_LENGTH : 0;
+
+    UVM_SEQ_OR_DBG_PRINT(s, "adaptive               %s\n",
+                         parent_gpu->fault_buffer_info.replayable.adaptive_batch.enabled? "yes" : "no");
+    UVM_SEQ_OR_DBG_PRINT(s, "batch_count            %u\n",
+                         parent_gpu->fault_buffer_info.replayable.adaptive_batch.batch_count);
+    UVM_SEQ_OR_DBG_PRINT(s, "max_batch_count        %u\n", parent_gpu->fault_buffer_info.max_batch_size);
+    UVM_SEQ_OR_DBG_PRINT(s, "avg_service_time_ns    %llu\n",
+                         parent_gpu->fault_buffer_info.replayable.adaptive_batch.avg_service_time_ns);
+    UVM_SEQ_OR_DBG_PRINT(s, "num_changes            %u\n", history_count);
+    UVM_SEQ_OR_DBG_PRINT(s, "history:\n");
+
+    for (i = first; i < history_count; ++i) {
+        NvU32 index = i % UVM_FAULT_BATCH_COUNT_HISTORY_LENGTH;
+
+        UVM_SEQ_OR_DBG_PRINT(s, "  time_ns %llu batch_count %u avg_service_time_ns %llu duplicates %u%%\n",
+                             parent_gpu->fault_buffer_info.replayable.adaptive_batch.history[index].timestamp_ns,
+                             parent_gpu->fault_buffer_info.replayable.adaptive_batch.history[index].batch_count,
+                             parent_gpu->fault_buffer_info.replayable.adaptive_batch.history[index].avg_service_time_ns,
+                             parent_gpu->fault_buffer_info.replayable.adaptive_batch.history[index].duplicate_ratio);
+    }
+}
+
+// Returns the upper bound, in nanoseconds, of the latency histogram bucket that
+// contains the given percentile of the samples
+static NvU64 fault_latency_percentile_ns(const NvU64 *counts, NvU64 total, NvU32 percentile)
+{
+    NvU64 threshold = (total * percentile + 99) / 100;
+    NvU64 sum = 0;
+    NvU32 bucket;
+
+    for (bucket = 0; bucket < UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS - 1; ++bucket) {
+        sum += counts[bucket];
+        if (sum >= threshold)
+            break;
+    }
+
+    return 1ULL << (bucket + 1);
+}
+
+static void gpu_fault_latency_print_common(uvm_parent_gpu_t *parent_gpu, struct seq_file *s)
+{
+    static const char *phase_names[UvmFaultLatencyPhaseCount] =
+    {
+        [UvmFaultLatencyPhaseFetch]      = "fetch",
+        [UvmFaultLatencyPhasePreprocess] = "preprocess",
+        [UvmFaultLatencyPhaseService]    = "service",
+        [UvmFaultLatencyPhaseReplay]     = "replay",
+    };
+    NvU64 (*histogram)[UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS];
+    NvU32 phase;
+    NvU32 bucket;
+
+    UVM_ASSERT(uvm_procfs_is_debug_enabled());
+
+    if (!parent_gpu->replayable_faults_supported)
+        return;
+
+    histogram = uvm_kvmalloc(UvmFaultLatencyPhaseCount * sizeof(*histogram));
+    if (!histogram)
+        return;
+
+    uvm_parent_gpu_fault_latency_histogram(parent_gpu, histogram);
+
+    for (phase = 0; phase < UvmFaultLatencyPhaseCount; ++phase) {
+        NvU64 total = 0;
+
+        for (bucket = 0; bucket < UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS; ++bucket)
+            total += histogram[phase][bucket];
+
+        UVM_SEQ_OR_DBG_PRINT(s, "%s:\n", phase_names[phase]);
+        UVM_SEQ_OR_DBG_PRINT(s, "  num_batches          %llu\n", total);
+        if (total == 0)
+            continue;
+
+        UVM_SEQ_OR_DBG_PRINT(s, "  p50_ns               < %llu\n",
+                             fault_latency_percentile_ns(histogram[phase], total, 50));
+        UVM_SEQ_OR_DBG_PRINT(s, "  p99_ns               < %llu\n",
+                             fault_latency_percentile_ns(histogram[phase], total, 99));
+
+        for (bucket = 0; bucket < UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS; ++bucket) {
+            if (histogram[phase][bucket] == 0)
+                continue;
+
+            UVM_SEQ_OR_DBG_PRINT(s, "  [%llu, %llu) %llu\n",
+                                 bucket == 0 ? 0ULL : 1ULL << bucket,
+                                 1ULL << (bucket + 1),
+                                 histogram[phase][bucket]);
+        }
+    }
+
+    uvm_kvfree(histogram);
+}
+
 static void gpu_access_counters_print_common(uvm_parent_gpu_t *parent_gpu, struct seq_file *s)
 {
     NvU64 num_pages_in;
@@ -694,6 +950,19 @@ static void gpu_access_counters_print_common(uvm_parent_gpu_t *parent_gpu, struc
                          (num_pages_in * (NvU64)PAGE_SIZE) / (1024u * 1024u));
     UVM_SEQ_OR_DBG_PRINT(s, "  num_pages_out        %llu (%llu MB)\n", num_pages_out,
                          (num_pages_out * (NvU64)PAGE_SIZE) / (1024u * 1024u));
+    if (parent_gpu->access_counter_buffer_info.promotion.enabled) {
+        uvm_access_counter_promotion_t *promotion = &parent_gpu->access_counter_buffer_info.promotion;
+
+        UVM_SEQ_OR_DBG_PRINT(s, "promotion:\n");
+        UVM_SEQ_OR_DBG_PRINT(s, "  recorded             %llu\n", promotion->stats.num_recorded);
+        UVM_SEQ_OR_DBG_PRINT(s, "  table_full           %llu\n", promotion->stats.num_full);
+        UVM_SEQ_OR_DBG_PRINT(s, "  windows              %llu\n", promotion->stats.num_windows);
+        UVM_SEQ_OR_DBG_PRINT(s, "  promoted             %llu (%llu MB)\n",
+                             promotion->stats.num_promoted_regions,
+                             promotion->stats.num_promoted_bytes / (1024u * 1024u));
+        UVM_SEQ_OR_DBG_PRINT(s, "  over_budget          %llu\n", promotion->stats.num_over_budget);
+        UVM_SEQ_OR_DBG_PRINT(s, "  fault_yields         %llu\n", promotion->stats.num_fault_yields);
+    }
 }
 
 void uvm_gpu_print(uvm_gpu_t *gpu)
@@ -718,11 +987,79 @@ static void gpu_peer_caps_print(uvm_gpu_t **gpu_pair, struct seq_file *s)
     nvswitch_connected = uvm_gpus_are_nvswitch_connected(local, remote);
     UVM_SEQ_OR_DBG_PRINT(s, "Link type                      %s\n", uvm_gpu_link_type_string(peer_caps->link_type));
     UVM_SEQ_OR_DBG_PRINT(s, "Bandwidth                      %uMBps\n", peer_caps->total_link_line_rate_mbyte_per_s);
+    UVM_SEQ_OR_DBG_PRINT(s, "Measured copy bandwidth        %uMBps\n",
+                         uvm_ce_calibration_peer_bandwidth(local, remote));
     UVM_SEQ_OR_DBG_PRINT(s, "Aperture                       %s\n", uvm_aperture_string(aperture));
     UVM_SEQ_OR_DBG_PRINT(s, "Connected through NVSWITCH     %s\n", nvswitch_connected ? "True" : "False");
     UVM_SEQ_OR_DBG_PRINT(s, "Refcount                       %llu\n", UVM_READ_ONCE(peer_caps->ref_count));
 }
 
+static void gpu_perf_sample(uvm_gpu_t *gpu, uvm_gpu_perf_sample_t *sample)
+{
+    uvm_parent_gpu_t *parent_gpu = gpu->parent;
+
+    sample->timestamp_ns = NV_GETTIME();
+    sample->num_replayable_faults = atomic64_read(&parent_gpu->stats.num_replayable_faults);
+    sample->num_non_replayable_faults = atomic64_read(&parent_gpu->stats.num_non_replayable_faults);
+    sample->num_replays = UVM_READ_ONCE(parent_gpu->fault_buffer_info.replayable.stats.num_replays);
+    sample->num_pages_in = atomic64_read(&parent_gpu->stats.num_pages_in);
+    sample->num_pages_out = atomic64_read(&parent_gpu->stats.num_pages_out);
+    sample->num_evicted_pages = atomic64_read(&gpu->pmm.eviction_stats.num_evicted_pages);
+}
+
+// Per-second rate of a counter which went from old_value to new_value in
+// elapsed_ns
+static NvU64 gpu_perf_rate(NvU64 old_value, NvU64 new_value, NvU64 elapsed_ns)
+{
+    if (elapsed_ns == 0)
+        return 0;
+
+    return ((new_value - old_value) * NSEC_PER_SEC) / elapsed_ns;
+}
+
+static NvU64 gpu_perf_pages_rate_mb(NvU64 old_value, NvU64 new_value, NvU64 elapsed_ns)
+{
+    return (gpu_perf_rate(old_value, new_value, elapsed_ns) * (NvU64)PAGE_SIZE) / (1024u * 1024u);
+}
+
+// The counters are cumulative and only updated when debug procfs is enabled.
+// Report their rates over the interval since the previous read, or since the
+// GPU was registered for the first read, so that they can be polled to
+// monitor the GPU.
+static void gpu_perf_print_common(uvm_gpu_t *gpu, struct seq_file *s)
+{
+    uvm_gpu_perf_sample_t last;
+    uvm_gpu_perf_sample_t now;
+    NvU64 elapsed_ns;
+
+    UVM_ASSERT(uvm_procfs_is_debug_enabled());
+
+    uvm_spin_lock(&gpu->perf_samples.lock);
+    gpu_perf_sample(gpu, &now);
+    last = gpu->perf_samples.last;
+    gpu->perf_samples.last = now;
+    uvm_spin_unlock(&gpu->perf_samples.lock);
+
+    elapsed_ns = now.timestamp_ns - last.timestamp_ns;
+
+    UVM_SEQ_OR_DBG_PRINT(s, "interval_ms                    %llu\n", elapsed_ns / (1000 * 1000));
+    UVM_SEQ_OR_DBG_PRINT(s, "replayable_faults/s            %llu\n",
+                         gpu_perf_rate(last.num_replayable_faults, now.num_replayable_faults, elapsed_ns));
+    UVM_SEQ_OR_DBG_PRINT(s, "non_replayable_faults/s        %llu\n",
+                         gpu_perf_rate(last.num_non_replayable_faults, now.num_non_replayable_faults, elapsed_ns));
+    UVM_SEQ_OR_DBG_PRINT(s, "replays/s                      %llu\n",
+                         gpu_perf_rate(last.num_replays, now.num_replays, elapsed_ns));
+    UVM_SEQ_OR_DBG_PRINT(s, "migrated_in_MB/s               %llu\n",
+                         gpu_perf_pages_rate_mb(last.num_pages_in, now.num_pages_in, elapsed_ns));
+    UVM_SEQ_OR_DBG_PRINT(s, "migrated_out_MB/s              %llu\n",
+                         gpu_perf_pages_rate_mb(last.num_pages_out, now.num_pages_out, elapsed_ns));
+
+    if (uvm_parent_gpu_supports_eviction(gpu->parent)) {
+        UVM_SEQ_OR_DBG_PRINT(s, "evicted_MB/s                   %llu\n",
+                             gpu_perf_pages_rate_mb(last.num_evicted_pages, now.num_evicted_pages, elapsed_ns));
+    }
+}
+
 static int nv_procfs_read_gpu_info(struct seq_file *s, void *v)
 {
     uvm_gpu_t *gpu = (uvm_gpu_t *)s->private;
@@ -742,6 +1079,25 @@ static int nv_procfs_read_gpu_info_entry(struct seq_file *s, void *v)
     UVM_ENTRY_RET(nv_procfs_read_gpu_info(s, v));
 }
 
+static int nv_procfs_read_gpu_perf(struct seq_file *s, void *v)
+{
+    uvm_gpu_t *gpu = (uvm_gpu_t *)s->private;
+
+    if (!uvm_down_read_trylock(&g_uvm_global.pm.lock))
+            return -EAGAIN;
+
+    gpu_perf_print_common(gpu, s);
+
+    uvm_up_read(&g_uvm_global.pm.lock);
+
+    return 0;
+}
+
+static int nv_procfs_read_gpu_perf_entry(struct seq_file *s, void *v)
+{
+    UVM_ENTRY_RET(nv_procfs_read_gpu_perf(s, v));
+}
+
 static int nv_procfs_read_gpu_fault_stats(struct seq_file *s, void *v)
 {
     uvm_parent_gpu_t *parent_gpu = (uvm_parent_gpu_t *)s->private;
@@ -761,6 +1117,44 @@ static int nv_procfs_read_gpu_fault_stats_entry(struct seq_file *s, void *v)
     UVM_ENTRY_RET(nv_procfs_read_gpu_fault_stats(s, v));
 }
 
+static int nv_procfs_read_gpu_fault_batch(struct seq_file *s, void *v)
+{
+    uvm_parent_gpu_t *parent_gpu = (uvm_parent_gpu_t *)s->private;
+
+    if (!uvm_down_read_trylock(&g_uvm_global.pm.lock))
+            return -EAGAIN;
+
+    gpu_fault_batch_print_common(parent_gpu, s);
+
+    uvm_up_read(&g_uvm_global.pm.lock);
+
+    return 0;
+}
+
+static int nv_procfs_read_gpu_fault_batch_entry(struct seq_file *s, void *v)
+{
+    UVM_ENTRY_RET(nv_procfs_read_gpu_fault_batch(s, v));
+}
+
+static int nv_procfs_read_gpu_fault_latency(struct seq_file *s, void *v)
+{
+    uvm_parent_gpu_t *parent_gpu = (uvm_parent_gpu_t *)s->private;
+
+    if (!uvm_down_read_trylock(&g_uvm_global.pm.lock))
+            return -EAGAIN;
+
+    gpu_fault_latency_print_common(parent_gpu, s);
+
+    uvm_up_read(&g_uvm_global.pm.lock);
+
+    return 0;
+}
+
+static int nv_procfs_read_gpu_fault_latency_entry(struct seq_file *s, void *v)
+{
+    UVM_ENTRY_RET(nv_procfs_read_gpu_fault_latency(s, v));
+}
+
 static int nv_procfs_read_gpu_access_counters(struct seq_file *s, void *v)
 {
     uvm_parent_gpu_t *parent_gpu = (uvm_parent_gpu_t *)s->private;
@@ -781,7 +1175,10 @@ static int nv_procfs_read_gpu_access_counters_entry(struct seq_file *s, void *v)
 }
 
 UVM_DEFINE_SINGLE_PROCFS_FILE(gpu_info_entry);
+UVM_DEFINE_SINGLE_PROCFS_FILE(gpu_perf_entry);
 UVM_DEFINE_SINGLE_PROCFS_FILE(gpu_fault_stats_entry);
+UVM_DEFINE_SINGLE_PROCFS_FILE(gpu_fault_batch_entry);
+UVM_DEFINE_SINGLE_PROCFS_FILE(gpu_fault_latency_entry);
 UVM_DEFINE_SINGLE_PROCFS_FILE(gpu_access_counters_entry);
 
 static NV_STATUS init_parent_procfs_dir(uvm_parent_gpu_t *parent_gpu)
@@ -825,6 +1222,20 @@ static NV_STATUS init_parent_procfs_files(uvm_parent_gpu_t *parent_gpu)
     if (parent_gpu->procfs.fault_stats_file == NULL)
         return NV_ERR_OPERATING_SYSTEM;
 
+    parent_gpu->procfs.fault_batch_file = NV_CREATE_PROC_FILE("fault_batch",
+                                                              parent_gpu->procfs.dir,
+                                                              gpu_fault_batch_entry,
+                                                              parent_gpu);
+    if (parent_gpu->procfs.fault_batch_file == NULL)
+        return NV_ERR_OPERATING_SYSTEM;
+
+    parent_gpu->procfs.fault_latency_file = NV_CREATE_PROC_FILE("fault_latency",
+                                                                parent_gpu->procfs.dir,
+                                                                gpu_fault_latency_entry,
+                                                                parent_gpu);
+    if (parent_gpu->procfs.fault_latency_file == NULL)
+        return NV_ERR_OPERATING_SYSTEM;
+
     parent_gpu->procfs.access_counters_file = NV_CREATE_PROC_FILE("access_counters",
                                                                   parent_gpu->procfs.dir,
                                                                   gpu_access_counters_entry,
@@ -838,6 +1249,8 @@ static NV_STATUS init_parent_procfs_files(uvm_parent_gpu_t *parent_gpu)
 static void deinit_parent_procfs_files(uvm_parent_gpu_t *parent_gpu)
 {
     proc_remove(parent_gpu->procfs.access_counters_file);
+    proc_remove(parent_gpu->procfs.fault_latency_file);
+    proc_remove(parent_gpu->procfs.fault_batch_file);
     proc_remove(parent_gpu->procfs.fault_stats_file);
 }
 
@@ -911,11 +1324,22 @@ static NV_STATUS init_procfs_files(uvm_gpu_t *gpu)
     if (gpu->procfs.info_file == NULL)
         return NV_ERR_OPERATING_SYSTEM;
 
+    // The counters reported by the perf file are only updated in debug mode
+    if (!uvm_procfs_is_debug_enabled())
+        return NV_OK;
+
+    gpu_perf_sample(gpu, &gpu->perf_samples.last);
+
+    gpu->procfs.perf_file = NV_CREATE_PROC_FILE("perf", gpu->procfs.dir, gpu_perf_entry, gpu);
+    if (gpu->procfs.perf_file == NULL)
+        return NV_ERR_OPERATING_SYSTEM;
+
     return NV_OK;
 }
 
 static void deinit_procfs_files(uvm_gpu_t *gpu)
 {
+    proc_remove(gpu->procfs.perf_file);
     proc_remove(gpu->procfs.info_file);
 }
 
@@ -1044,6 +1468,8 @@ static uvm_gpu_t *alloc_gpu(uvm_parent_gpu_t *parent_gpu, uvm_gpu_id_t gpu_id)
     // Initialize enough of the gpu struct for remove_gpu to be called
     gpu->magic = UVM_GPU_MAGIC_VALUE;
     uvm_spin_lock_init(&gpu->peer_info.peer_gpus_lock, UVM_LOCK_ORDER_LEAF);
+    uvm_spin_lock_init(&gpu->perf_samples.lock, UVM_LOCK_ORDER_LEAF);
+    uvm_ext_pte_cache_init(gpu);
 
     sub_processor_index = uvm_id_sub_processor_index(gpu_id);
     parent_gpu->gpus[sub_processor_index] = gpu;
@@ -1356,6 +1782,18 @@ static NV_STATUS init_gpu(uvm_gpu_t *gpu, const UvmGpuInfo *gpu_info)
         return status;
     }
 
+    status = uvm_pmm_gpu_zero_pool_init(&gpu->pmm);
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("Failed to init the PMM zero pool: %s, GPU %s\n", nvstatusToString(status), uvm_gpu_name(gpu));
+        return status;
+    }
+
+    // CE calibration is best effort. If it fails, the measurements are left
+    // at zero, as if calibration was disabled.
+    status = uvm_ce_calibration_gpu(gpu);
+    if (status != NV_OK)
+        UVM_ERR_PRINT("CE calibration failed: %s, GPU %s\n", nvstatusToString(status), uvm_gpu_name(gpu));
+
     status = init_procfs_files(gpu);
     if (status != NV_OK) {
         UVM_ERR_PRINT("Failed to init procfs files: %s, GPU %s\n", nvstatusToString(status), uvm_gpu_name(gpu));
@@ -1523,7 +1961,7 @@ static void sync_parent_gpu_trackers(uvm_parent_gpu_t *parent_gpu,
     // VA block trackers, too.
     if (sync_clear_faulted_tracker) {
         uvm_parent_gpu_non_replayable_faults_isr_lock(parent_gpu);
-        status = uvm_tracker_wait(&parent_gpu->fault_buffer_info.non_replayable.clear_faulted_tracker);
+        status = uvm_tracker_wait(&parent_gpu->fault_buffer_info.non_replayable.service_context.clear_faulted_tracker);
         uvm_parent_gpu_non_replayable_faults_isr_unlock(parent_gpu);
 
         if (status != NV_OK)
@@ -1611,6 +2049,10 @@ static void deinit_gpu(uvm_gpu_t *gpu)
 
     deinit_procfs_files(gpu);
 
+    // The zero pool kthread pushes memsets, stop it before tearing down the
+    // flat mappings and channels.
+    uvm_pmm_gpu_zero_pool_deinit(&gpu->pmm);
+
     // TODO Bug 3429163: [UVM] Move uvm_mmu_destroy_flat_mapping() to the
     // correct spot
     uvm_mmu_destroy_flat_mappings(gpu);
@@ -1631,6 +2073,8 @@ static void deinit_gpu(uvm_gpu_t *gpu)
 
     uvm_pmm_sysmem_mappings_deinit(&gpu->pmm_reverse_sysmem_mappings);
 
+    uvm_ext_pte_cache_deinit(gpu);
+
     uvm_pmm_gpu_deinit(&gpu->pmm);
 
     if (gpu->rm_address_space != 0)
@@ -1749,14 +2193,14 @@ static void update_stats_parent_gpu_fault_instance(uvm_parent_gpu_t *parent_gpu,
         switch (fault_entry->fault_access_type)
         {
             case UVM_FAULT_ACCESS_TYPE_READ:
-                ++parent_gpu->fault_buffer_info.non_replayable.stats.num_read_faults;
+                atomic64_inc(&parent_gpu->fault_buffer_info.non_replayable.stats.num_read_faults);
                 break;
             case UVM_FAULT_ACCESS_TYPE_WRITE:
-                ++parent_gpu->fault_buffer_info.non_replayable.stats.num_write_faults;
+                atomic64_inc(&parent_gpu->fault_buffer_info.non_replayable.stats.num_write_faults);
                 break;
             case UVM_FAULT_ACCESS_TYPE_ATOMIC_WEAK:
             case UVM_FAULT_ACCESS_TYPE_ATOMIC_STRONG:
-                ++parent_gpu->fault_buffer_info.non_replayable.stats.num_atomic_faults;
+                atomic64_inc(&parent_gpu->fault_buffer_info.non_replayable.stats.num_atomic_faults);
                 break;
             default:
                 UVM_ASSERT_MSG(false, "Invalid access type for non-replayable faults\n");
@@ -1764,9 +2208,9 @@ static void update_stats_parent_gpu_fault_instance(uvm_parent_gpu_t *parent_gpu,
         }
 
         if (!fault_entry->is_virtual)
-            ++parent_gpu->fault_buffer_info.non_replayable.stats.num_physical_faults;
+            atomic64_inc(&parent_gpu->fault_buffer_info.non_replayable.stats.num_physical_faults);
 
-        ++parent_gpu->stats.num_non_replayable_faults;
+        atomic64_inc(&parent_gpu->stats.num_non_replayable_faults);
 
         return;
     }
@@ -1776,25 +2220,25 @@ static void update_stats_parent_gpu_fault_instance(uvm_parent_gpu_t *parent_gpu,
     switch (fault_entry->fault_access_type)
     {
         case UVM_FAULT_ACCESS_TYPE_PREFETCH:
-            ++parent_gpu->fault_buffer_info.replayable.stats.num_prefetch_faults;
+            atomic64_inc(&parent_gpu->fault_buffer_info.replayable.stats.num_prefetch_faults);
             break;
         case UVM_FAULT_ACCESS_TYPE_READ:
-            ++parent_gpu->fault_buffer_info.replayable.stats.num_read_faults;
+            atomic64_inc(&parent_gpu->fault_buffer_info.replayable.stats.num_read_faults);
             break;
         case UVM_FAULT_ACCESS_TYPE_WRITE:
-            ++parent_gpu->fault_buffer_info.replayable.stats.num_write_faults;
+            atomic64_inc(&parent_gpu->fault_buffer_info.replayable.stats.num_write_faults);
             break;
         case UVM_FAULT_ACCESS_TYPE_ATOMIC_WEAK:
         case UVM_FAULT_ACCESS_TYPE_ATOMIC_STRONG:
-            ++parent_gpu->fault_buffer_info.replayable.stats.num_atomic_faults;
+            atomic64_inc(&parent_gpu->fault_buffer_info.replayable.stats.num_atomic_faults);
             break;
         default:
             break;
     }
     if (is_duplicate || fault_entry->filtered)
-        ++parent_gpu->fault_buffer_info.replayable.stats.num_duplicate_faults;
+        atomic64_inc(&parent_gpu->fault_buffer_info.replayable.stats.num_duplicate_faults);
 
-    ++parent_gpu->stats.num_replayable_faults;
+    atomic64_inc(&parent_gpu->stats.num_replayable_faults);
 }
 
 static void update_stats_fault_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data)
@@ -2374,6 +2818,15 @@ static NV_STATUS init_peer_access(uvm_gpu_t *gpu0,
 
     set_optimal_p2p_write_ces(p2p_caps_params, peer_caps, gpu0, gpu1);
 
+    // Best effort, like the calibration of each GPU
+    status = uvm_ce_calibration_peers(gpu0, gpu1);
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("CE calibration failed: %s, GPU0 %s GPU1 %s\n",
+                      nvstatusToString(status),
+                      uvm_gpu_name(gpu0),
+                      uvm_gpu_name(gpu1));
+    }
+
     UVM_ASSERT(uvm_gpu_get(gpu0->id) == gpu0);
     UVM_ASSERT(uvm_gpu_get(gpu1->id) == gpu1);
 
@@ -3240,26 +3693,41 @@ static NvU64 dma_addr_to_gpu_addr(uvm_parent_gpu_t *parent_gpu, NvU64 dma_addr)
     return gpu_addr;
 }
 
-void *uvm_parent_gpu_dma_alloc_page(uvm_parent_gpu_t *parent_gpu, gfp_t gfp_flags, NvU64 *dma_address_out)
+void *uvm_parent_gpu_dma_alloc(uvm_parent_gpu_t *parent_gpu, size_t size, gfp_t gfp_flags, NvU64 *dma_address_out)
 {
     NvU64 dma_addr;
     void *cpu_addr;
+    unsigned long attrs = 0;
+
+    UVM_ASSERT(PAGE_ALIGNED(size));
 
-    cpu_addr = dma_alloc_coherent(&parent_gpu->pci_dev->dev, PAGE_SIZE, &dma_addr, gfp_flags);
+    // Callers compute the struct page of any offset within the allocation from
+    // its first page, so allocations larger than a page must not be assembled
+    // from scattered pages behind an IOMMU.
+    if (size > PAGE_SIZE)
+        attrs |= DMA_ATTR_FORCE_CONTIGUOUS;
+
+    // The DMA API rejects compound page requests.
+    cpu_addr = dma_alloc_attrs(&parent_gpu->pci_dev->dev, size, &dma_addr, gfp_flags & ~__GFP_COMP, attrs);
 
     if (!cpu_addr)
         return cpu_addr;
 
     *dma_address_out = dma_addr_to_gpu_addr(parent_gpu, dma_addr);
-    atomic64_add(PAGE_SIZE, &parent_gpu->mapped_cpu_pages_size);
+    atomic64_add(size, &parent_gpu->mapped_cpu_pages_size);
     return cpu_addr;
 }
 
-void uvm_parent_gpu_dma_free_page(uvm_parent_gpu_t *parent_gpu, void *va, NvU64 dma_address)
+void uvm_parent_gpu_dma_free(uvm_parent_gpu_t *parent_gpu, size_t size, void *va, NvU64 dma_address)
 {
+    unsigned long attrs = 0;
+
+    if (size > PAGE_SIZE)
+        attrs |= DMA_ATTR_FORCE_CONTIGUOUS;
+
     dma_address = gpu_addr_to_dma_addr(parent_gpu, dma_address);
-    dma_free_coherent(&parent_gpu->pci_dev->dev, PAGE_SIZE, va, dma_address);
-    atomic64_sub(PAGE_SIZE, &parent_gpu->mapped_cpu_pages_size);
+    dma_free_attrs(&parent_gpu->pci_dev->dev, size, va, dma_address, attrs);
+    atomic64_sub(size, &parent_gpu->mapped_cpu_pages_size);
 }
 
 NV_STATUS uvm_parent_gpu_map_cpu_pages(uvm_parent_gpu_t *parent_gpu,
@@ -252,6 +252,29 @@ typedef struct
 
 } uvm_ats_fault_context_t;
 
+typedef struct
+{
+    NvU64 counts[UvmFaultLatencyPhaseCount][UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS];
+} uvm_fault_latency_histogram_t;
+
+// Number of batch size changes kept in the adaptive fault batch sizing history
+#define UVM_FAULT_BATCH_COUNT_HISTORY_LENGTH 16
+
+// Fault entries are sorted during fault batch preprocessing using a radix sort
+// on packed keys. Keys are compared as unsigned 128-bit integers {hi, lo} and
+// sorted one UVM_FAULT_SORT_RADIX_BITS-wide digit at a time.
+#define UVM_FAULT_SORT_RADIX_BITS   8
+#define UVM_FAULT_SORT_RADIX_SIZE   (1 << UVM_FAULT_SORT_RADIX_BITS)
+#define UVM_FAULT_SORT_RADIX_DIGITS ((2 * sizeof(NvU64) * 8) / UVM_FAULT_SORT_RADIX_BITS)
+
+typedef struct
+{
+    NvU64 hi;
+    NvU64 lo;
+
+    uvm_fault_buffer_entry_t *entry;
+} uvm_fault_sort_key_t;
+
 struct uvm_fault_service_batch_context_struct
 {
     // Array of elements fetched from the GPU fault buffer. The number of
@@ -263,6 +286,13 @@ struct uvm_fault_service_batch_context_struct
     // max_batch_size
     uvm_fault_buffer_entry_t **ordered_fault_cache;
 
+    // Scratch buffers used to sort ordered_fault_cache. The number of elements
+    // in sort_keys and sort_tmp_keys is exactly max_batch_size, and
+    // sort_histograms holds one histogram per radix digit.
+    uvm_fault_sort_key_t *sort_keys;
+    uvm_fault_sort_key_t *sort_tmp_keys;
+    NvU32 (*sort_histograms)[UVM_FAULT_SORT_RADIX_SIZE];
+
     // Per uTLB fault information. Used for replay policies and fault
     // cancellation on Pascal
     uvm_fault_utlb_info_t *utlbs;
@@ -298,6 +328,16 @@ struct uvm_fault_service_batch_context_struct
 
     uvm_tracker_t tracker;
 
+    // Structure used to coalesce fault servicing in a VA block. This points to
+    // the parent GPU's replayable block_service_context, unless the context is
+    // owned by a fault service worker, in which case it points to the worker's
+    // private block service context.
+    uvm_service_block_context_t *block_service_context;
+
+    // Time at which the fetch of the batch started, used to measure the
+    // service time of the batch for adaptive batch sizing.
+    NvU64 fetch_timestamp_ns;
+
     // Boolean used to avoid sorting the fault batch by instance_ptr if we
     // determine at fetch time that all the faults in the batch report the same
     // instance_ptr
@@ -313,6 +353,88 @@ struct uvm_ats_fault_invalidate_struct
     uvm_tlb_batch_t tlb_batch;
 };
 
+// Worker thread that services the faults of a subset of the VA spaces in a
+// replayable fault batch, concurrently with the rest of workers of the same
+// parent GPU. See uvm_perf_fault_service_workers in
+// uvm_gpu_replayable_faults.c.
+typedef struct
+{
+    uvm_parent_gpu_t *parent_gpu;
+
+    // Position of the worker in the parent GPU's worker array. The worker
+    // services the VA spaces whose position in the sorted batch is congruent
+    // to this index, modulo the number of active workers.
+    NvU32 index;
+
+    // Queue whose thread runs the worker. The thread is bound to the NUMA node
+    // closest to the GPU.
+    nv_kthread_q_t q;
+
+    nv_kthread_q_item_t q_item;
+
+    // Private view of the batch being serviced. It shares the fault cache and
+    // the uTLB array with the parent GPU's batch context, but has its own
+    // counters, fatal fault information and tracker. These are merged into
+    // the parent GPU's batch context once all the workers are done. Workers
+    // only ever set the has_fatal_faults flag of the shared uTLB entries.
+    uvm_fault_service_batch_context_t batch_context;
+
+    uvm_service_block_context_t block_service_context;
+
+    uvm_ats_fault_invalidate_t ats_invalidate;
+
+    // Result of servicing the VA spaces assigned to the worker
+    NV_STATUS status;
+} uvm_fault_service_worker_t;
+
+// State used to service non-replayable faults. Faults serviced by the bottom
+// half use the context embedded in the parent GPU's non-replayable fault
+// buffer info, and each non-replayable fault service worker has its own.
+typedef struct
+{
+    // Tracker which temporarily holds the work pushed to service faults
+    uvm_tracker_t fault_service_tracker;
+
+    // Tracker used to aggregate clear faulted operations, needed for GPU
+    // removal. The trackers of the workers are merged into the one of the
+    // parent GPU once they are done.
+    uvm_tracker_t clear_faulted_tracker;
+
+    // Structure used to coalesce fault servicing in a VA block
+    uvm_service_block_context_t block_service_context;
+
+    // Tools event batch id of the fault being serviced
+    NvU32 batch_id;
+} uvm_non_replayable_fault_service_context_t;
+
+// Worker thread that services the non-replayable faults of a subset of the VA
+// spaces found in the shadow buffer, concurrently with the rest of workers of
+// the same parent GPU. See uvm_perf_non_replayable_fault_service_workers in
+// uvm_gpu_non_replayable_faults.c.
+typedef struct
+{
+    uvm_parent_gpu_t *parent_gpu;
+
+    // Position of the worker in the parent GPU's worker array. The worker
+    // services the faults whose worker_index matches this index.
+    NvU32 index;
+
+    // Queue whose thread runs the worker. The thread is bound to the NUMA node
+    // closest to the GPU.
+    nv_kthread_q_t q;
+
+    nv_kthread_q_item_t q_item;
+
+    // Number of faults fetched from the shadow buffer. The fault cache of the
+    // parent GPU is shared by all the workers.
+    NvU32 num_cached_faults;
+
+    uvm_non_replayable_fault_service_context_t service_context;
+
+    // Result of servicing the faults assigned to the worker
+    NV_STATUS status;
+} uvm_non_replayable_fault_service_worker_t;
+
 typedef struct
 {
     // Fault buffer information and structures provided by RM
@@ -348,26 +470,53 @@ typedef struct
         // that comes before the replay method.
         NvU32 replay_update_put_ratio;
 
-        // Fault statistics. These fields are per-GPU and most of them are only
-        // updated during fault servicing, and can be safely incremented.
-        // Migrations may be triggered by different GPUs and need to be
-        // incremented using atomics
+        // Fault statistics. These fields are per-GPU. Fault counters are
+        // updated during fault servicing, which may run concurrently on the
+        // fault service workers. Migrations may be triggered by different
+        // GPUs. Both need to be incremented using atomics. The rest of fields
+        // are only updated by the bottom half and can be safely incremented.
         struct
         {
-            NvU64 num_prefetch_faults;
+            atomic64_t num_prefetch_faults;
 
-            NvU64 num_read_faults;
+            atomic64_t num_read_faults;
 
-            NvU64 num_write_faults;
+            atomic64_t num_write_faults;
 
-            NvU64 num_atomic_faults;
+            atomic64_t num_atomic_faults;
 
-            NvU64 num_duplicate_faults;
+            atomic64_t num_duplicate_faults;
 
             atomic64_t num_pages_out;
 
             atomic64_t num_pages_in;
 
+            // Number of VA blocks whose lock was held by another thread when
+            // fault servicing tried to take it, and total time spent waiting
+            // for those locks
+            atomic64_t num_block_lock_contended;
+
+            atomic64_t block_lock_wait_ns;
+
+            // HMM VA block servicing breakdown. Times are cumulative over all
+            // serviced blocks. num_cpu_fault_retries counts the blocks that had
+            // to be faulted in on the CPU first, which drops all locks and
+            // restarts servicing from the faulting entry.
+            struct
+            {
+                atomic64_t num_blocks;
+
+                atomic64_t num_cpu_fault_retries;
+
+                atomic64_t migrate_setup_ns;
+
+                atomic64_t copy_ns;
+
+                atomic64_t finalize_ns;
+
+                atomic64_t cpu_fault_ns;
+            } hmm;
+
             NvU64 num_replays;
 
             NvU64 num_replays_ack_all;
@@ -384,6 +533,66 @@ typedef struct
 
         // Information required to invalidate stale ATS PTEs from the GPU TLBs
         uvm_ats_fault_invalidate_t ats_invalidate;
+
+        // Adaptive fault batch sizing state. See uvm_perf_fault_batch_adaptive
+        // in uvm_gpu_replayable_faults.c. Only updated by the bottom half.
+        struct
+        {
+            bool enabled;
+
+            // Number of entries to be fetched from the fault buffer in the next
+            // batch. If adaptive batch sizing is disabled, this is always
+            // max_batch_size.
+            NvU32 batch_count;
+
+            // Exponentially weighted moving average of the batch service time
+            // in nanoseconds
+            NvU64 avg_service_time_ns;
+
+            // Circular log of the most recent batch_count changes
+            struct
+            {
+                NvU64 timestamp_ns;
+
+                NvU32 batch_count;
+
+                // avg_service_time_ns and percentage of duplicate faults in
+                // the batch that triggered the change
+                NvU64 avg_service_time_ns;
+
+                NvU32 duplicate_ratio;
+            } history[UVM_FAULT_BATCH_COUNT_HISTORY_LENGTH];
+
+            // Total number of changes recorded in history
+            NvU32 history_count;
+        } adaptive_batch;
+
+        // Pool of workers used to service the VA spaces in a batch in
+        // parallel. count is 0 if the faults are serviced serially by the
+        // bottom half.
+        struct
+        {
+            NvU32 count;
+
+            uvm_fault_service_worker_t *workers;
+
+            // Number of workers servicing the current batch
+            NvU32 num_active;
+
+            // Number of active workers that have not finished yet. The last
+            // worker to finish signals done.
+            atomic_t pending;
+
+            struct completion done;
+        } service_workers;
+
+        // Per-CPU fault batch servicing latency histograms. See
+        // UvmFaultLatencyPhase.
+        uvm_fault_latency_histogram_t __percpu *latency_histogram;
+
+        // Queue of prefetches deferred out of fault servicing. See
+        // uvm_perf_prefetch_deferred in uvm_perf_prefetch.c.
+        uvm_perf_prefetch_queue_t prefetch_queue;
     } replayable;
 
     struct uvm_non_replayable_fault_buffer_info_struct
@@ -391,10 +600,6 @@ typedef struct
         // Maximum number of faults entries that can be stored in the buffer
         NvU32 max_faults;
 
-        // Tracker used to aggregate clear faulted operations, needed for GPU
-        // removal
-        uvm_tracker_t clear_faulted_tracker;
-
         // Buffer used to store elements popped out from the queue shared with
         // RM for fault servicing.
         void *shadow_buffer_copy;
@@ -406,33 +611,50 @@ typedef struct
         // Fault statistics. See replayable fault stats for more details.
         struct
         {
-            NvU64 num_read_faults;
+            atomic64_t num_read_faults;
 
-            NvU64 num_write_faults;
+            atomic64_t num_write_faults;
 
-            NvU64 num_atomic_faults;
+            atomic64_t num_atomic_faults;
 
-            NvU64 num_physical_faults;
+            atomic64_t num_physical_faults;
 
             atomic64_t num_pages_out;
 
             atomic64_t num_pages_in;
         } stats;
 
-        // Tracker which temporarily holds the work pushed to service faults
-        uvm_tracker_t fault_service_tracker;
+        // Context used to service faults from the bottom half
+        uvm_non_replayable_fault_service_context_t service_context;
 
-        // Structure used to coalesce fault servicing in a VA block
-        uvm_service_block_context_t block_service_context;
+        // Unique id (per-GPU) generated for tools events recording. Faults may
+        // be serviced concurrently by the fault service workers, so it is
+        // incremented using atomics.
+        atomic_t batch_id;
 
-        // Unique id (per-GPU) generated for tools events recording
-        NvU32 batch_id;
-
-        // Information required to service ATS faults.
+        // Information required to service ATS faults. Faults are never
+        // serviced by the workers when ATS is enabled, so these are only used
+        // by the bottom half.
         uvm_ats_fault_context_t ats_context;
 
         // Information required to invalidate stale ATS PTEs from the GPU TLBs
         uvm_ats_fault_invalidate_t ats_invalidate;
+
+        // Pool of workers used to service the faults of different VA spaces
+        // in parallel. count is 0 if the faults are serviced serially by the
+        // bottom half.
+        struct
+        {
+            NvU32 count;
+
+            uvm_non_replayable_fault_service_worker_t *workers;
+
+            // Number of active workers that have not finished yet. The last
+            // worker to finish signals done.
+            atomic_t pending;
+
+            struct completion done;
+        } service_workers;
     } non_replayable;
 
     // Flag that tells if prefetch faults are enabled in HW
@@ -486,6 +708,76 @@ struct uvm_access_counter_service_batch_context_struct
     NvU32 batch_id;
 };
 
+// Region gathered by the access counter promotion pipeline. It covers the
+// pages of a single managed VA block reported by the notifications of a GPU.
+typedef struct
+{
+    uvm_va_space_t *va_space;
+
+    // GPU which received the notifications, and destination of the promotion
+    uvm_gpu_id_t gpu_id;
+
+    NvU64 base;
+
+    NvU64 length;
+
+    // Sum of the counter values of the notifications in the region
+    NvU64 count;
+} uvm_access_counter_promotion_region_t;
+
+// Hot regions resident in sysmem are not migrated by the access counter
+// bottom half when promotion is enabled. Instead, they are gathered over a time
+// window, and the hottest ones are migrated by a dedicated kthread with one
+// batched migration per VA space and destination GPU. See
+// uvm_perf_access_counter_promotion_enable in uvm_gpu_access_counters.c.
+typedef struct
+{
+    bool enabled;
+
+    // Protects regions, num_regions, window_start and the stats updated by the
+    // bottom half
+    uvm_spinlock_t lock;
+
+    // Regions gathered in the current window
+    uvm_access_counter_promotion_region_t *regions;
+
+    NvU32 num_regions;
+
+    NvU32 max_regions;
+
+    // Only used by the promotion thread, which moves the gathered regions here
+    // when the window closes
+    uvm_access_counter_promotion_region_t *pending_regions;
+
+    NvU64 window_start;
+
+    nv_kthread_q_t q;
+
+    nv_kthread_q_item_t q_item;
+
+    struct
+    {
+        NvU64 num_recorded;
+
+        // Notifications serviced inline because the region table was full
+        NvU64 num_full;
+
+        // The remaining stats are only updated by the promotion thread
+        NvU64 num_windows;
+
+        NvU64 num_promoted_regions;
+
+        NvU64 num_promoted_bytes;
+
+        // Regions dropped because they did not fit in the window budget
+        NvU64 num_over_budget;
+
+        // Regions dropped because the destination GPU had pending replayable
+        // faults
+        NvU64 num_fault_yields;
+    } stats;
+} uvm_access_counter_promotion_t;
+
 typedef struct
 {
     // Values used to configure access counters in RM
@@ -555,6 +847,9 @@ typedef struct
     // Context structure used to service a GPU access counter batch
     uvm_access_counter_service_batch_context_t batch_service_context;
 
+    // Hot page promotion state. See uvm_access_counter_promotion_t.
+    uvm_access_counter_promotion_t promotion;
+
     // VA space that reconfigured the access counters configuration, if any.
     // Used in builtin tests only, to avoid reconfigurations from different
     // processes
@@ -589,6 +884,24 @@ typedef struct
     NvU32 num_mapped_pages;
 } uvm_gpu_root_chunk_mapping_t;
 
+// Sample of the GPU counters reported as rates by the perf procfs file
+typedef struct
+{
+    NvU64 timestamp_ns;
+
+    NvU64 num_replayable_faults;
+
+    NvU64 num_non_replayable_faults;
+
+    NvU64 num_replays;
+
+    NvU64 num_pages_in;
+
+    NvU64 num_pages_out;
+
+    NvU64 num_evicted_pages;
+} uvm_gpu_perf_sample_t;
+
 typedef enum
 {
     UVM_GPU_LINK_INVALID = 0,
@@ -692,6 +1005,26 @@ struct uvm_gpu_struct
         NvU32 internal_size;
     } big_page;
 
+    // Copy bandwidth measured over each CE when the GPU was registered, in
+    // megabytes per second, indexed by CE. Entries of CEs without a CE
+    // channel pool, and all entries if the calibration was skipped, are zero.
+    // See uvm_ce_calibration.h.
+    struct
+    {
+        NvU32 cpu_to_gpu_mbyte_per_s[UVM_COPY_ENGINE_COUNT_MAX];
+        NvU32 gpu_to_cpu_mbyte_per_s[UVM_COPY_ENGINE_COUNT_MAX];
+        NvU32 gpu_internal_mbyte_per_s[UVM_COPY_ENGINE_COUNT_MAX];
+    } ce_bandwidth;
+
+    // Statistics of the background promotion of VA block mappings to 2M PTEs.
+    // See uvm_perf_promote.h.
+    struct
+    {
+        atomic64_t num_promoted_blocks;
+
+        atomic64_t num_failed;
+    } big_page_promotion;
+
     // Mapped registers needed to obtain the current GPU timestamp
     struct
     {
@@ -799,6 +1132,22 @@ struct uvm_gpu_struct
     // mappings (instead of kernel), and it is used in most configurations.
     uvm_pmm_sysmem_mappings_t pmm_reverse_sysmem_mappings;
 
+    // Cache of the PTEs queried from RM for external allocations mapped on
+    // this GPU, shared by all VA spaces. See uvm_map_external.c.
+    struct
+    {
+        // List of uvm_ext_pte_cache_entry_t, protected by lock.
+        struct list_head entries;
+
+        // Leaf lock, never held across RM calls.
+        uvm_mutex_t lock;
+
+        // Number of external mappings which were created from cached PTEs,
+        // and which had to query their PTEs from RM.
+        atomic64_t hits;
+        atomic64_t misses;
+    } ext_pte_cache;
+
     struct
     {
         uvm_conf_computing_dma_buffer_pool_t dma_buffer_pool;
@@ -868,9 +1217,21 @@ struct uvm_gpu_struct
 
         struct proc_dir_entry *info_file;
 
+        struct proc_dir_entry *perf_file;
+
         struct proc_dir_entry *dir_peers;
     } procfs;
 
+    // Counters sampled by the previous read of the perf procfs file, which
+    // reports their rates over the interval since then.
+    struct
+    {
+        // Protects last
+        uvm_spinlock_t lock;
+
+        uvm_gpu_perf_sample_t last;
+    } perf_samples;
+
     // Placeholder for per-GPU performance heuristics information
     uvm_perf_module_data_desc_t perf_modules_data[UVM_PERF_MODULE_TYPE_COUNT];
 
@@ -1091,6 +1452,10 @@ struct uvm_parent_gpu_struct
 
         struct proc_dir_entry *fault_stats_file;
 
+        struct proc_dir_entry *fault_batch_file;
+
+        struct proc_dir_entry *fault_latency_file;
+
         struct proc_dir_entry *access_counters_file;
     } procfs;
 
@@ -1168,15 +1533,21 @@ struct uvm_parent_gpu_struct
 
     // Global statistics. These fields are per-GPU and most of them are only
     // updated during fault servicing, and can be safely incremented.
+    // Faults may be serviced concurrently by the fault service workers, so
+    // their counters need to be incremented using atomics.
     struct
     {
-        NvU64          num_replayable_faults;
+        atomic64_t     num_replayable_faults;
 
-        NvU64      num_non_replayable_faults;
+        atomic64_t     num_non_replayable_faults;
 
         atomic64_t             num_pages_out;
 
         atomic64_t              num_pages_in;
+
+        // Number of VA block GPU states for this GPU that could not be
+        // allocated on the NUMA node closest to the GPU.
+        atomic64_t              num_remote_node_va_block_states;
     } stats;
 
     // Structure to hold nvswitch specific information. In an nvswitch
@@ -1282,6 +1653,11 @@ struct uvm_gpu_peer_struct
     // See UvmGpuP2PCapsParams.
     NvU32 total_link_line_rate_mbyte_per_s;
 
+    // Copy bandwidth measured between the peers when peer access was enabled,
+    // in megabytes per second, or zero if the calibration was skipped. Indexed
+    // like peer_ids. See uvm_ce_calibration.h.
+    NvU32 copy_bandwidth_mbyte_per_s[2];
+
     // For PCIe, the number of times that this has been retained by a VA space.
     // For NVLINK this will always be 1.
     NvU64 ref_count;
@@ -1516,19 +1892,36 @@ static void uvm_parent_gpu_unmap_cpu_page(uvm_parent_gpu_t *parent_gpu, NvU64 dm
     uvm_parent_gpu_unmap_cpu_pages(parent_gpu, dma_address, PAGE_SIZE);
 }
 
-// Allocate and map a page of system DMA memory on the GPU for physical access
+// Allocate and map size bytes of physically contiguous system DMA memory on
+// the GPU for physical access. size must be a multiple of PAGE_SIZE.
 //
 // Returns
-// - the address of the page that can be used to access them on
-//   the GPU in the dma_address_out parameter.
+// - the address of the memory that can be used to access it on the GPU in the
+//   dma_address_out parameter.
 // - the address of allocated memory in CPU virtual address space.
-void *uvm_parent_gpu_dma_alloc_page(uvm_parent_gpu_t *parent_gpu,
-                                    gfp_t gfp_flags,
-                                    NvU64 *dma_address_out);
+void *uvm_parent_gpu_dma_alloc(uvm_parent_gpu_t *parent_gpu,
+                               size_t size,
+                               gfp_t gfp_flags,
+                               NvU64 *dma_address_out);
 
 // Unmap and free size bytes of contiguous sysmem DMA previously allocated
-// with uvm_parent_gpu_map_cpu_pages().
-void uvm_parent_gpu_dma_free_page(uvm_parent_gpu_t *parent_gpu, void *va, NvU64 dma_address);
+// with uvm_parent_gpu_dma_alloc().
+void uvm_parent_gpu_dma_free(uvm_parent_gpu_t *parent_gpu, size_t size, void *va, NvU64 dma_address);
+
+// Allocate and map a page of system DMA memory on the GPU for physical access
+static void *uvm_parent_gpu_dma_alloc_page(uvm_parent_gpu_t *parent_gpu,
+                                           gfp_t gfp_flags,
+                                           NvU64 *dma_address_out)
+{
+    return uvm_parent_gpu_dma_alloc(parent_gpu, PAGE_SIZE, gfp_flags, dma_address_out);
+}
+
+// Unmap and free a page of sysmem DMA previously allocated with
+// uvm_parent_gpu_dma_alloc_page().
+static void uvm_parent_gpu_dma_free_page(uvm_parent_gpu_t *parent_gpu, void *va, NvU64 dma_address)
+{
+    uvm_parent_gpu_dma_free(parent_gpu, PAGE_SIZE, va, dma_address);
+}
 
 // Returns whether the given range is within the GPU's addressable VA ranges.
 // It requires the input 'addr' to be in canonical form for platforms compliant
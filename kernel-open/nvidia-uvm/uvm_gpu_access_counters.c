@@ -25,8 +25,11 @@
 #include "uvm_gpu_access_counters.h"
 #include "uvm_global.h"
 #include "uvm_gpu.h"
+#include "uvm_gpu_isr.h"
 #include "uvm_hal.h"
 #include "uvm_kvmalloc.h"
+#include "uvm_migrate.h"
+#include "uvm_gpu_replayable_faults.h"
 #include "uvm_tools.h"
 #include "uvm_va_block.h"
 #include "uvm_va_range.h"
@@ -43,6 +46,14 @@
 #define UVM_PERF_ACCESS_COUNTER_THRESHOLD_MAX       ((1 << 16) - 1)
 #define UVM_PERF_ACCESS_COUNTER_THRESHOLD_DEFAULT   256
 
+#define UVM_PERF_ACCESS_COUNTER_PROMOTION_WINDOW_USEC_MIN       100
+#define UVM_PERF_ACCESS_COUNTER_PROMOTION_WINDOW_USEC_DEFAULT   1000
+#define UVM_PERF_ACCESS_COUNTER_PROMOTION_WINDOW_USEC_MAX       (1000 * 1000)
+#define UVM_PERF_ACCESS_COUNTER_PROMOTION_MAX_REGIONS_MIN       1
+#define UVM_PERF_ACCESS_COUNTER_PROMOTION_MAX_REGIONS_DEFAULT   256
+#define UVM_PERF_ACCESS_COUNTER_PROMOTION_MAX_REGIONS_MAX       4096
+#define UVM_PERF_ACCESS_COUNTER_PROMOTION_BANDWIDTH_DEFAULT     8192
+
 #define UVM_ACCESS_COUNTER_ACTION_CLEAR     0x1
 #define UVM_ACCESS_COUNTER_PHYS_ON_MANAGED  0x2
 
@@ -84,6 +95,24 @@ static unsigned uvm_perf_access_counter_batch_count = UVM_PERF_ACCESS_COUNTER_BA
 // See module param documentation below
 static unsigned uvm_perf_access_counter_threshold = UVM_PERF_ACCESS_COUNTER_THRESHOLD_DEFAULT;
 
+// Enable/disable the batched promotion of hot regions resident in sysmem. See
+// uvm_access_counter_promotion_t.
+static unsigned uvm_perf_access_counter_promotion_enable = 0;
+
+// Length of the window over which regions are gathered and ranked before
+// being promoted
+static unsigned uvm_perf_access_counter_promotion_window_usec = UVM_PERF_ACCESS_COUNTER_PROMOTION_WINDOW_USEC_DEFAULT;
+
+// Maximum number of regions gathered per window and GPU
+static unsigned uvm_perf_access_counter_promotion_max_regions = UVM_PERF_ACCESS_COUNTER_PROMOTION_MAX_REGIONS_DEFAULT;
+
+// Maximum promotion bandwidth per GPU, in MB/s
+static unsigned uvm_perf_access_counter_promotion_max_mbyte_per_s = UVM_PERF_ACCESS_COUNTER_PROMOTION_BANDWIDTH_DEFAULT;
+
+static NvU64 g_uvm_access_counter_promotion_window_ns;
+static NvU64 g_uvm_access_counter_promotion_budget_bytes;
+static unsigned g_uvm_access_counter_promotion_max_regions;
+
 // Module parameters for the tunables
 module_param(uvm_perf_access_counter_mimc_migration_enable, int, S_IRUGO);
 MODULE_PARM_DESC(uvm_perf_access_counter_mimc_migration_enable,
@@ -98,6 +127,23 @@ module_param(uvm_perf_access_counter_threshold, uint, S_IRUGO);
 MODULE_PARM_DESC(uvm_perf_access_counter_threshold,
                  "Number of remote accesses on a region required to trigger a notification."
                  "Valid values: [1, 65535]");
+module_param(uvm_perf_access_counter_promotion_enable, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_perf_access_counter_promotion_enable,
+                 "Whether hot regions resident in sysmem are promoted in batches at the end of each window"
+                 " instead of being migrated as their notifications are serviced. Only applies to VA spaces"
+                 " with access counter migrations enabled.");
+module_param(uvm_perf_access_counter_promotion_window_usec, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_perf_access_counter_promotion_window_usec,
+                 "Length of the access counter promotion window in microseconds."
+                 "Valid values: [100, 1000000]");
+module_param(uvm_perf_access_counter_promotion_max_regions, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_perf_access_counter_promotion_max_regions,
+                 "Maximum number of regions gathered per promotion window and GPU."
+                 "Valid values: [1, 4096]");
+module_param(uvm_perf_access_counter_promotion_max_mbyte_per_s, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_perf_access_counter_promotion_max_mbyte_per_s,
+                 "Maximum access counter promotion bandwidth per GPU in MB/s. At least one VA block is promoted"
+                 " per window.");
 
 static void access_counter_buffer_flush_locked(uvm_parent_gpu_t *parent_gpu,
                                                uvm_gpu_buffer_flush_mode_t flush_mode);
@@ -341,6 +387,349 @@ static void init_access_counter_types_config(const UvmGpuAccessCntrConfig *confi
     UVM_ASSERT(counter_type_config->sub_granularity_regions_per_translation <= UVM_SUB_GRANULARITY_REGIONS);
 }
 
+// Sort comparator for promotion regions that sorts by VA space, GPU ID and
+// address
+static int cmp_sort_promotion_regions_by_va_space_gpu_address(const void *_a, const void *_b)
+{
+    const uvm_access_counter_promotion_region_t *a = _a;
+    const uvm_access_counter_promotion_region_t *b = _b;
+    int result;
+
+    result = UVM_CMP_DEFAULT(a->va_space, b->va_space);
+    if (result != 0)
+        return result;
+
+    result = UVM_CMP_DEFAULT(uvm_id_value(a->gpu_id), uvm_id_value(b->gpu_id));
+    if (result != 0)
+        return result;
+
+    return UVM_CMP_DEFAULT(a->base, b->base);
+}
+
+// Sort comparator for promotion regions that sorts by descending count
+static int cmp_sort_promotion_regions_by_count(const void *_a, const void *_b)
+{
+    const uvm_access_counter_promotion_region_t *a = _a;
+    const uvm_access_counter_promotion_region_t *b = _b;
+
+    return UVM_CMP_DEFAULT(b->count, a->count);
+}
+
+// Merge the regions of the same VA block reported to the same GPU, which may
+// have been recorded by different batches of the window. The regions must be
+// sorted by VA space, GPU ID and address. Returns the new number of regions.
+static NvU32 promotion_merge_regions(uvm_access_counter_promotion_region_t *regions, NvU32 num_regions)
+{
+    NvU32 i;
+    NvU32 num_merged = 0;
+
+    for (i = 0; i < num_regions; i++) {
+        uvm_access_counter_promotion_region_t *prev = num_merged > 0 ? &regions[num_merged - 1] : NULL;
+        uvm_access_counter_promotion_region_t *region = &regions[i];
+
+        if (prev &&
+            prev->va_space == region->va_space &&
+            uvm_id_equal(prev->gpu_id, region->gpu_id) &&
+            UVM_VA_BLOCK_ALIGN_DOWN(prev->base) == UVM_VA_BLOCK_ALIGN_DOWN(region->base)) {
+            NvU64 end = max(prev->base + prev->length, region->base + region->length);
+
+            prev->length = end - prev->base;
+            prev->count += region->count;
+        }
+        else {
+            regions[num_merged++] = *region;
+        }
+    }
+
+    return num_merged;
+}
+
+// Promote the regions of a single VA space to a single GPU. The regions are
+// sorted by address, and their copies are pipelined on a shared tracker.
+static void promotion_service_gpu(uvm_access_counter_promotion_t *promotion,
+                                  uvm_va_space_t *va_space,
+                                  struct mm_struct *mm,
+                                  const uvm_access_counter_promotion_region_t *regions,
+                                  NvU32 num_regions)
+{
+    uvm_tracker_t tracker = UVM_TRACKER_INIT();
+    uvm_gpu_id_t gpu_id = regions[0].gpu_id;
+    uvm_gpu_t *gpu;
+    NvU32 i;
+
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    // The GPU may have been unregistered from the VA space, which also happens
+    // during VA space teardown
+    if (!uvm_processor_mask_test(&va_space->registered_gpu_va_spaces, gpu_id))
+        return;
+
+    gpu = uvm_va_space_get_gpu(va_space, gpu_id);
+
+    // Promotions are not urgent, so yield the copy engines to the demand
+    // faults of the destination GPU. The regions are still hot if they keep
+    // generating notifications.
+    if (gpu->parent->replayable_faults_supported && uvm_parent_gpu_replayable_faults_pending(gpu->parent)) {
+        promotion->stats.num_fault_yields += num_regions;
+        return;
+    }
+
+    for (i = 0; i < num_regions; i++) {
+        NV_STATUS status = uvm_migrate_managed_range(va_space,
+                                                     mm,
+                                                     regions[i].base,
+                                                     regions[i].length,
+                                                     gpu,
+                                                     &tracker);
+
+        // Promotion is best-effort: the VA range may have been freed or
+        // changed since the region was recorded.
+        if (status == NV_OK) {
+            ++promotion->stats.num_promoted_regions;
+            promotion->stats.num_promoted_bytes += regions[i].length;
+        }
+    }
+
+    // The VA space lock must be held while waiting, to prevent the GPU from
+    // being unregistered.
+    (void)uvm_tracker_wait_deinit(&tracker);
+}
+
+static void promotion_service_va_space(uvm_access_counter_promotion_t *promotion,
+                                       const uvm_access_counter_promotion_region_t *regions,
+                                       NvU32 num_regions)
+{
+    uvm_va_space_t *va_space = regions[0].va_space;
+    struct mm_struct *mm;
+    NvU32 i = 0;
+
+    mm = uvm_va_space_mm_retain_lock(va_space);
+    uvm_va_space_down_read(va_space);
+
+    while (i < num_regions) {
+        NvU32 j;
+
+        for (j = i + 1; j < num_regions; j++) {
+            if (!uvm_id_equal(regions[j].gpu_id, regions[i].gpu_id))
+                break;
+        }
+
+        promotion_service_gpu(promotion, va_space, mm, &regions[i], j - i);
+        i = j;
+    }
+
+    uvm_va_space_up_read(va_space);
+    uvm_va_space_mm_release_unlock(va_space, mm);
+}
+
+static void promotion_service(void *args)
+{
+    uvm_access_counter_promotion_t *promotion = (uvm_access_counter_promotion_t *)args;
+    uvm_access_counter_promotion_region_t *regions = promotion->pending_regions;
+    NvU64 budget = g_uvm_access_counter_promotion_budget_bytes;
+    NvU32 num_regions;
+    NvU32 num_selected;
+    NvU32 i;
+
+    uvm_spin_lock(&promotion->lock);
+
+    num_regions = promotion->num_regions;
+    memcpy(regions, promotion->regions, num_regions * sizeof(*regions));
+    promotion->num_regions = 0;
+    promotion->window_start = NV_GETTIME();
+
+    uvm_spin_unlock(&promotion->lock);
+
+    if (num_regions == 0)
+        return;
+
+    ++promotion->stats.num_windows;
+
+    sort(regions, num_regions, sizeof(*regions), cmp_sort_promotion_regions_by_va_space_gpu_address, NULL);
+    num_regions = promotion_merge_regions(regions, num_regions);
+
+    // Pick the hottest regions that fit in the budget of the window. The
+    // budget covers at least one VA block so that promotion always makes
+    // progress.
+    sort(regions, num_regions, sizeof(*regions), cmp_sort_promotion_regions_by_count, NULL);
+
+    for (num_selected = 0; num_selected < num_regions; num_selected++) {
+        if (regions[num_selected].length > budget)
+            break;
+
+        budget -= regions[num_selected].length;
+    }
+
+    promotion->stats.num_over_budget += num_regions - num_selected;
+
+    sort(regions, num_selected, sizeof(*regions), cmp_sort_promotion_regions_by_va_space_gpu_address, NULL);
+
+    i = 0;
+    while (i < num_selected) {
+        NvU32 j;
+
+        for (j = i + 1; j < num_selected; j++) {
+            if (regions[j].va_space != regions[i].va_space)
+                break;
+        }
+
+        promotion_service_va_space(promotion, &regions[i], j - i);
+        i = j;
+    }
+
+    uvm_tools_flush_events();
+}
+
+static void promotion_service_entry(void *args)
+{
+    UVM_ENTRY_VOID(promotion_service(args));
+}
+
+static NV_STATUS promotion_init(uvm_parent_gpu_t *parent_gpu)
+{
+    uvm_access_counter_promotion_t *promotion = &parent_gpu->access_counter_buffer_info.promotion;
+    char kthread_name[TASK_COMM_LEN + 1];
+    NV_STATUS status;
+
+    if (!uvm_perf_access_counter_promotion_enable)
+        return NV_OK;
+
+    uvm_spin_lock_init(&promotion->lock, UVM_LOCK_ORDER_LEAF);
+
+    promotion->max_regions = g_uvm_access_counter_promotion_max_regions;
+    promotion->regions = uvm_kvmalloc_zero(promotion->max_regions * sizeof(*promotion->regions));
+    promotion->pending_regions = uvm_kvmalloc_zero(promotion->max_regions * sizeof(*promotion->pending_regions));
+    if (!promotion->regions || !promotion->pending_regions)
+        return NV_ERR_NO_MEMORY;
+
+    nv_kthread_q_item_init(&promotion->q_item, promotion_service_entry, promotion);
+
+    snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u AC", uvm_parent_id_value(parent_gpu->id));
+    status = uvm_kthread_q_init_on_node(&promotion->q, kthread_name, parent_gpu->closest_cpu_numa_node);
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("Failed in nv_kthread_q_init for access counter promotion: %s, GPU %s\n",
+                      nvstatusToString(status),
+                      uvm_parent_gpu_name(parent_gpu));
+        return status;
+    }
+
+    // Like deferred prefetches, promotions are speculative
+    set_user_nice(promotion->q.q_kthread, 19);
+
+    promotion->window_start = NV_GETTIME();
+    promotion->enabled = true;
+
+    return NV_OK;
+}
+
+static void promotion_deinit(uvm_parent_gpu_t *parent_gpu)
+{
+    uvm_access_counter_promotion_t *promotion = &parent_gpu->access_counter_buffer_info.promotion;
+
+    if (promotion->enabled) {
+        promotion->enabled = false;
+        nv_kthread_q_stop(&promotion->q);
+    }
+
+    uvm_kvfree(promotion->regions);
+    uvm_kvfree(promotion->pending_regions);
+    promotion->regions = NULL;
+    promotion->pending_regions = NULL;
+    promotion->num_regions = 0;
+}
+
+void uvm_parent_gpu_access_counters_promotion_flush(uvm_parent_gpu_t *parent_gpu, uvm_va_space_t *va_space)
+{
+    uvm_access_counter_promotion_t *promotion = &parent_gpu->access_counter_buffer_info.promotion;
+    NvU32 i;
+    NvU32 num_kept = 0;
+
+    if (!promotion->enabled)
+        return;
+
+    uvm_spin_lock(&promotion->lock);
+
+    for (i = 0; i < promotion->num_regions; i++) {
+        if (va_space && promotion->regions[i].va_space != va_space)
+            promotion->regions[num_kept++] = promotion->regions[i];
+    }
+
+    promotion->num_regions = num_kept;
+
+    uvm_spin_unlock(&promotion->lock);
+
+    nv_kthread_q_flush(&promotion->q);
+}
+
+// Record the accessed pages of va_block for promotion to gpu, if they are all
+// resident in sysmem and the policy of the block allows it. Returns false if
+// the pages must be serviced inline.
+static bool promotion_record(uvm_gpu_t *gpu,
+                             uvm_va_block_t *va_block,
+                             const uvm_page_mask_t *accessed_pages,
+                             uvm_access_counter_buffer_entry_t **notifications,
+                             NvU32 num_notifications)
+{
+    uvm_access_counter_promotion_t *promotion = &gpu->parent->access_counter_buffer_info.promotion;
+    uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
+    uvm_va_policy_t *policy;
+    uvm_va_block_region_t region;
+    NvU64 count = 0;
+    bool recorded = false;
+    bool window_closed;
+    NvU32 i;
+
+    uvm_assert_mutex_locked(&va_block->lock);
+
+    if (!promotion->enabled || uvm_va_block_is_hmm(va_block) || uvm_page_mask_empty(accessed_pages))
+        return false;
+
+    policy = uvm_va_range_get_policy(va_block->va_range);
+    if (uvm_va_policy_is_read_duplicate(policy, va_space) ||
+        (UVM_ID_IS_VALID(policy->preferred_location) && !uvm_id_equal(policy->preferred_location, gpu->id)))
+        return false;
+
+    if (!uvm_page_mask_subset(accessed_pages, uvm_va_block_resident_mask_get(va_block, UVM_ID_CPU, NUMA_NO_NODE)))
+        return false;
+
+    for (i = 0; i < num_notifications; i++)
+        count += notifications[i]->counter_value;
+
+    region = uvm_va_block_region_from_mask(va_block, accessed_pages);
+
+    uvm_spin_lock(&promotion->lock);
+
+    if (promotion->num_regions < promotion->max_regions) {
+        uvm_access_counter_promotion_region_t *promotion_region = &promotion->regions[promotion->num_regions++];
+
+        promotion_region->va_space = va_space;
+        promotion_region->gpu_id = gpu->id;
+        promotion_region->base = uvm_va_block_region_start(va_block, region);
+        promotion_region->length = uvm_va_block_region_size(region);
+        promotion_region->count = count;
+
+        ++promotion->stats.num_recorded;
+        recorded = true;
+    }
+    else {
+        ++promotion->stats.num_full;
+    }
+
+    // A window is closed by the first notification recorded after it expires,
+    // or earlier if the region table fills up.
+    window_closed = promotion->num_regions == promotion->max_regions ||
+                    NV_GETTIME() - promotion->window_start >= g_uvm_access_counter_promotion_window_ns;
+
+    uvm_spin_unlock(&promotion->lock);
+
+    // The queue item may already be pending, in which case it picks up the
+    // new region too.
+    if (window_closed)
+        nv_kthread_q_schedule_q_item(&promotion->q, &promotion->q_item);
+
+    return recorded;
+}
+
 NV_STATUS uvm_parent_gpu_init_access_counters(uvm_parent_gpu_t *parent_gpu)
 {
     NV_STATUS status = NV_OK;
@@ -414,34 +803,42 @@ NV_STATUS uvm_parent_gpu_init_access_counters(uvm_parent_gpu_t *parent_gpu)
                 access_counters->max_batch_size);
     }
 
-    batch_context->notification_cache = uvm_kvmalloc_zero(access_counters->max_notifications *
-                                                          sizeof(*batch_context->notification_cache));
+    batch_context->notification_cache = uvm_kvmalloc_zero_node(access_counters->max_notifications *
+                                                               sizeof(*batch_context->notification_cache),
+                                                               parent_gpu->closest_cpu_numa_node);
     if (!batch_context->notification_cache) {
         status = NV_ERR_NO_MEMORY;
         goto fail;
     }
 
-    batch_context->virt.notifications = uvm_kvmalloc_zero(access_counters->max_notifications *
-                                                          sizeof(*batch_context->virt.notifications));
+    batch_context->virt.notifications = uvm_kvmalloc_zero_node(access_counters->max_notifications *
+                                                               sizeof(*batch_context->virt.notifications),
+                                                               parent_gpu->closest_cpu_numa_node);
     if (!batch_context->virt.notifications) {
         status = NV_ERR_NO_MEMORY;
         goto fail;
     }
 
-    batch_context->phys.notifications = uvm_kvmalloc_zero(access_counters->max_notifications *
-                                                          sizeof(*batch_context->phys.notifications));
+    batch_context->phys.notifications = uvm_kvmalloc_zero_node(access_counters->max_notifications *
+                                                               sizeof(*batch_context->phys.notifications),
+                                                               parent_gpu->closest_cpu_numa_node);
     if (!batch_context->phys.notifications) {
         status = NV_ERR_NO_MEMORY;
         goto fail;
     }
 
-    batch_context->phys.translations = uvm_kvmalloc_zero((UVM_MAX_TRANSLATION_SIZE / PAGE_SIZE) *
-                                                         sizeof(*batch_context->phys.translations));
+    batch_context->phys.translations = uvm_kvmalloc_zero_node((UVM_MAX_TRANSLATION_SIZE / PAGE_SIZE) *
+                                                              sizeof(*batch_context->phys.translations),
+                                                              parent_gpu->closest_cpu_numa_node);
     if (!batch_context->phys.translations) {
         status = NV_ERR_NO_MEMORY;
         goto fail;
     }
 
+    status = promotion_init(parent_gpu);
+    if (status != NV_OK)
+        goto fail;
+
     return NV_OK;
 
 fail:
@@ -457,6 +854,8 @@ void uvm_parent_gpu_deinit_access_counters(uvm_parent_gpu_t *parent_gpu)
 
     UVM_ASSERT(parent_gpu->isr.access_counters.handling_ref_count == 0);
 
+    promotion_deinit(parent_gpu);
+
     if (access_counters->rm_info.accessCntrBufferHandle) {
         NV_STATUS status = uvm_rm_locked_call(nvUvmInterfaceDestroyAccessCntrInfo(parent_gpu->rm_device,
                                                                                   &access_counters->rm_info));
@@ -1052,6 +1451,10 @@ static NV_STATUS service_va_block_locked(uvm_processor_id_t processor,
     if (!uvm_processor_mask_test(&va_block->mapped, processor))
         return NV_OK;
 
+    // Let the eviction policy know that the GPU memory backing the pages is
+    // being accessed, even if the notifications don't trigger migrations.
+    uvm_va_block_mark_gpu_chunks_accessed(va_block, accessed_pages);
+
     if (uvm_processor_mask_test(&va_block->resident, processor))
         residency_mask = uvm_va_block_resident_mask_get(va_block, processor, NUMA_NO_NODE);
     else
@@ -1687,7 +2090,10 @@ static NV_STATUS service_virt_notifications_in_block(uvm_gpu_va_space_t *gpu_va_
     // Atleast one notification should have been processed.
     UVM_ASSERT(index < *out_index);
 
-    status = service_notification_va_block_helper(mm, va_block, gpu->id, batch_context);
+    // Regions resident in sysmem may be left to the promotion thread, in which
+    // case the notifications are cleared as if they had been serviced.
+    if (!promotion_record(gpu, va_block, accessed_pages, &notifications[index], *out_index - index))
+        status = service_notification_va_block_helper(mm, va_block, gpu->id, batch_context);
 
     uvm_mutex_unlock(&va_block->lock);
 
@@ -2019,6 +2425,38 @@ bool uvm_va_space_has_access_counter_migrations(uvm_va_space_t *va_space)
 
 NV_STATUS uvm_perf_access_counters_init(void)
 {
+    unsigned window_usec = uvm_perf_access_counter_promotion_window_usec;
+    unsigned max_mbyte_per_s = uvm_perf_access_counter_promotion_max_mbyte_per_s;
+
+    if (window_usec < UVM_PERF_ACCESS_COUNTER_PROMOTION_WINDOW_USEC_MIN ||
+        window_usec > UVM_PERF_ACCESS_COUNTER_PROMOTION_WINDOW_USEC_MAX) {
+        window_usec = UVM_PERF_ACCESS_COUNTER_PROMOTION_WINDOW_USEC_DEFAULT;
+        pr_info("Invalid value %u for uvm_perf_access_counter_promotion_window_usec. Using %u instead\n",
+                uvm_perf_access_counter_promotion_window_usec,
+                window_usec);
+    }
+
+    g_uvm_access_counter_promotion_max_regions = uvm_perf_access_counter_promotion_max_regions;
+    if (g_uvm_access_counter_promotion_max_regions < UVM_PERF_ACCESS_COUNTER_PROMOTION_MAX_REGIONS_MIN ||
+        g_uvm_access_counter_promotion_max_regions > UVM_PERF_ACCESS_COUNTER_PROMOTION_MAX_REGIONS_MAX) {
+        g_uvm_access_counter_promotion_max_regions = UVM_PERF_ACCESS_COUNTER_PROMOTION_MAX_REGIONS_DEFAULT;
+        pr_info("Invalid value %u for uvm_perf_access_counter_promotion_max_regions. Using %u instead\n",
+                uvm_perf_access_counter_promotion_max_regions,
+                g_uvm_access_counter_promotion_max_regions);
+    }
+
+    if (max_mbyte_per_s == 0) {
+        max_mbyte_per_s = UVM_PERF_ACCESS_COUNTER_PROMOTION_BANDWIDTH_DEFAULT;
+        pr_info("Invalid value 0 for uvm_perf_access_counter_promotion_max_mbyte_per_s. Using %u instead\n",
+                max_mbyte_per_s);
+    }
+
+    g_uvm_access_counter_promotion_window_ns = window_usec * 1000ULL;
+
+    // 1 MB/s is one byte per microsecond
+    g_uvm_access_counter_promotion_budget_bytes = max((NvU64)max_mbyte_per_s * window_usec,
+                                                      (NvU64)UVM_VA_BLOCK_SIZE);
+
     uvm_perf_module_init("perf_access_counters",
                          UVM_PERF_MODULE_TYPE_ACCESS_COUNTERS,
                          g_callbacks_access_counters,
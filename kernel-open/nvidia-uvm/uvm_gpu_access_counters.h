@@ -35,6 +35,14 @@ void uvm_parent_gpu_service_access_counters(uvm_parent_gpu_t *parent_gpu);
 
 void uvm_parent_gpu_access_counter_buffer_flush(uvm_parent_gpu_t *parent_gpu);
 
+// Drop the regions gathered for promotion in the given VA space, or in all VA
+// spaces if va_space is NULL, and wait for the promotion in progress, if any.
+// This must be called before a VA space that may have received access counter
+// notifications is freed. This is a no-op if promotion is disabled.
+//
+// Locking: The caller must not hold any VA space lock.
+void uvm_parent_gpu_access_counters_promotion_flush(uvm_parent_gpu_t *parent_gpu, uvm_va_space_t *va_space);
+
 // Ignore or unignore access counters notifications. Ignoring means that the
 // bottom half is a no-op which just leaves notifications in the HW buffer
 // without being serviced and without inspecting any SW state.
@@ -51,6 +51,30 @@
 // re-evaluated by writing to GET. Non-replayable faults work the same way, but
 // they are currently owned by RM, so UVM doesn't have to do anything.
 
+// Polling of replayable faults
+// ============================
+// During fault storms, re-enabling interrupts after each service pass only for
+// the next interrupt to arrive immediately wastes time in the top half and in
+// bottom half scheduling. Similarly to NAPI in network drivers, the replayable
+// faults bottom half keeps servicing the fault buffer with interrupts still
+// disabled while new faults keep showing up, up to a budget of additional
+// passes. Interrupts are re-enabled once the buffer is found empty or the budget
+// is exhausted, so that other bottom halves and power management get a chance
+// to run.
+//
+// The budget adapts to the load: it doubles, up to uvm_fault_poll_budget_max,
+// when a bottom half exhausts it, and halves, down to UVM_ISR_POLL_BUDGET_MIN,
+// when a bottom half finds the buffer empty before using half of it. Setting
+// uvm_fault_poll_budget_max to 0 disables polling.
+#define UVM_ISR_POLL_BUDGET_MIN 1
+#define UVM_ISR_POLL_BUDGET_MAX_DEFAULT 16
+
+static unsigned uvm_fault_poll_budget_max = UVM_ISR_POLL_BUDGET_MAX_DEFAULT;
+module_param(uvm_fault_poll_budget_max, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_fault_poll_budget_max,
+                 "Maximum number of replayable fault buffer passes a bottom half performs with interrupts disabled. "
+                 "0 disables polling.");
+
 // For use by the nv_kthread_q that is servicing the replayable fault bottom
 // half, only.
 static void replayable_faults_isr_bottom_half_entry(void *args);
@@ -271,7 +295,7 @@ NV_STATUS uvm_isr_top_half_entry(const NvProcessorUuid *gpu_uuid)
     UVM_ENTRY_RET(uvm_isr_top_half(gpu_uuid));
 }
 
-static NV_STATUS init_queue_on_node(nv_kthread_q_t *queue, const char *name, int node)
+NV_STATUS uvm_kthread_q_init_on_node(nv_kthread_q_t *queue, const char *name, int node)
 {
 #if UVM_THREAD_AFFINITY_SUPPORTED()
     if (node != -1 && !cpumask_empty(uvm_cpumask_of_node(node))) {
@@ -312,6 +336,9 @@ NV_STATUS uvm_parent_gpu_init_isr(uvm_parent_gpu_t *parent_gpu)
         if (!parent_gpu->isr.replayable_faults.stats.cpu_exec_count)
             return NV_ERR_NO_MEMORY;
 
+        parent_gpu->isr.replayable_faults.poll_budget = min(uvm_fault_poll_budget_max,
+                                                            (unsigned)UVM_ISR_POLL_BUDGET_MIN);
+
         block_context = uvm_va_block_context_alloc(NULL);
         if (!block_context)
             return NV_ERR_NO_MEMORY;
@@ -321,7 +348,7 @@ NV_STATUS uvm_parent_gpu_init_isr(uvm_parent_gpu_t *parent_gpu)
         parent_gpu->isr.replayable_faults.handling = true;
 
         snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u BH", uvm_parent_id_value(parent_gpu->id));
-        status = init_queue_on_node(&parent_gpu->isr.bottom_half_q, kthread_name, parent_gpu->closest_cpu_numa_node);
+        status = uvm_kthread_q_init_on_node(&parent_gpu->isr.bottom_half_q, kthread_name, parent_gpu->closest_cpu_numa_node);
         if (status != NV_OK) {
             UVM_ERR_PRINT("Failed in nv_kthread_q_init for bottom_half_q: %s, GPU %s\n",
                           nvstatusToString(status),
@@ -329,6 +356,14 @@ NV_STATUS uvm_parent_gpu_init_isr(uvm_parent_gpu_t *parent_gpu)
             return status;
         }
 
+        status = uvm_perf_prefetch_queue_init(&parent_gpu->fault_buffer_info.replayable.prefetch_queue, parent_gpu);
+        if (status != NV_OK) {
+            UVM_ERR_PRINT("Failed to initialize the prefetch queue: %s, GPU %s\n",
+                          nvstatusToString(status),
+                          uvm_parent_gpu_name(parent_gpu));
+            return status;
+        }
+
         if (parent_gpu->non_replayable_faults_supported) {
             nv_kthread_q_item_init(&parent_gpu->isr.non_replayable_faults.bottom_half_q_item,
                                    non_replayable_faults_isr_bottom_half_entry,
@@ -344,14 +379,15 @@ NV_STATUS uvm_parent_gpu_init_isr(uvm_parent_gpu_t *parent_gpu)
             if (!block_context)
                 return NV_ERR_NO_MEMORY;
 
-            parent_gpu->fault_buffer_info.non_replayable.block_service_context.block_context = block_context;
+            parent_gpu->fault_buffer_info.non_replayable.service_context.block_service_context.block_context =
+                block_context;
 
             parent_gpu->isr.non_replayable_faults.handling = true;
 
             snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u KC", uvm_parent_id_value(parent_gpu->id));
-            status = init_queue_on_node(&parent_gpu->isr.kill_channel_q,
-                                        kthread_name,
-                                        parent_gpu->closest_cpu_numa_node);
+            status = uvm_kthread_q_init_on_node(&parent_gpu->isr.kill_channel_q,
+                                                kthread_name,
+                                                parent_gpu->closest_cpu_numa_node);
             if (status != NV_OK) {
                 UVM_ERR_PRINT("Failed in nv_kthread_q_init for kill_channel_q: %s, GPU %s\n",
                               nvstatusToString(status),
@@ -426,6 +462,10 @@ void uvm_parent_gpu_disable_isr(uvm_parent_gpu_t *parent_gpu)
     // nv_kthread_q_init() failed in uvm_parent_gpu_init_isr().
     nv_kthread_q_stop(&parent_gpu->isr.bottom_half_q);
     nv_kthread_q_stop(&parent_gpu->isr.kill_channel_q);
+
+    // The bottom half is the only producer of deferred prefetch requests, so
+    // the queue can be torn down once it is stopped.
+    uvm_perf_prefetch_queue_deinit(&parent_gpu->fault_buffer_info.replayable.prefetch_queue);
 }
 
 void uvm_parent_gpu_deinit_isr(uvm_parent_gpu_t *parent_gpu)
@@ -468,7 +508,8 @@ void uvm_parent_gpu_deinit_isr(uvm_parent_gpu_t *parent_gpu)
     }
 
     if (parent_gpu->non_replayable_faults_supported) {
-        block_context = parent_gpu->fault_buffer_info.non_replayable.block_service_context.block_context;
+        block_context =
+            parent_gpu->fault_buffer_info.non_replayable.service_context.block_service_context.block_context;
         uvm_va_block_context_free(block_context);
     }
 
@@ -512,6 +553,57 @@ uvm_gpu_t *uvm_parent_gpu_find_first_valid_gpu(uvm_parent_gpu_t *parent_gpu)
     return gpu;
 }
 
+static bool replayable_faults_should_poll(uvm_parent_gpu_t *parent_gpu)
+{
+    bool should_poll;
+
+    uvm_spin_lock_irqsave(&parent_gpu->isr.interrupts_lock);
+
+    should_poll = !parent_gpu->isr.is_suspended &&
+                  parent_gpu->isr.replayable_faults.handling &&
+                  uvm_parent_gpu_replayable_faults_pending(parent_gpu);
+
+    uvm_spin_unlock_irqrestore(&parent_gpu->isr.interrupts_lock);
+
+    return should_poll;
+}
+
+// Keep servicing the replayable fault buffer with interrupts disabled while it
+// is not empty, up to the current poll budget. See "Polling of replayable
+// faults" above.
+static void replayable_faults_poll(uvm_parent_gpu_t *parent_gpu)
+{
+    uvm_intr_handler_t *replayable_faults = &parent_gpu->isr.replayable_faults;
+    NvU32 budget = replayable_faults->poll_budget;
+    NvU32 num_polls = 0;
+
+    if (uvm_fault_poll_budget_max == 0)
+        return;
+
+    while (num_polls < budget && replayable_faults_should_poll(parent_gpu)) {
+        cond_resched();
+
+        uvm_parent_gpu_service_replayable_faults(parent_gpu);
+        ++num_polls;
+    }
+
+    replayable_faults->stats.poll_count += num_polls;
+
+    if (num_polls == budget)
+        replayable_faults->poll_budget = min(budget * 2, uvm_fault_poll_budget_max);
+    else if (num_polls < budget / 2)
+        replayable_faults->poll_budget = max(budget / 2, (NvU32)UVM_ISR_POLL_BUDGET_MIN);
+}
+
+// Whether a bottom half running on the given CPU is executing away from the
+// NUMA node closest to the GPU, which usually means that the kthread was
+// migrated by the scheduler.
+static bool bottom_half_cpu_is_remote(uvm_parent_gpu_t *parent_gpu, unsigned int cpu)
+{
+    return parent_gpu->closest_cpu_numa_node != NUMA_NO_NODE &&
+           cpu_to_node(cpu) != parent_gpu->closest_cpu_numa_node;
+}
+
 static void replayable_faults_isr_bottom_half(void *args)
 {
     uvm_parent_gpu_t *parent_gpu = (uvm_parent_gpu_t *)args;
@@ -535,10 +627,14 @@ static void replayable_faults_isr_bottom_half(void *args)
     ++parent_gpu->isr.replayable_faults.stats.bottom_half_count;
     cpumask_set_cpu(cpu, &parent_gpu->isr.replayable_faults.stats.cpus_used_mask);
     ++parent_gpu->isr.replayable_faults.stats.cpu_exec_count[cpu];
+    if (bottom_half_cpu_is_remote(parent_gpu, cpu))
+        ++parent_gpu->isr.replayable_faults.stats.remote_node_count;
     put_cpu();
 
     uvm_parent_gpu_service_replayable_faults(parent_gpu);
 
+    replayable_faults_poll(parent_gpu);
+
     uvm_parent_gpu_replayable_faults_isr_unlock(parent_gpu);
 
     // It is OK to drop a reference on the parent GPU if a bottom half has
@@ -568,6 +664,8 @@ static void non_replayable_faults_isr_bottom_half(void *args)
     ++parent_gpu->isr.non_replayable_faults.stats.bottom_half_count;
     cpumask_set_cpu(cpu, &parent_gpu->isr.non_replayable_faults.stats.cpus_used_mask);
     ++parent_gpu->isr.non_replayable_faults.stats.cpu_exec_count[cpu];
+    if (bottom_half_cpu_is_remote(parent_gpu, cpu))
+        ++parent_gpu->isr.non_replayable_faults.stats.remote_node_count;
     put_cpu();
 
     uvm_parent_gpu_service_non_replayable_fault_buffer(parent_gpu);
@@ -598,6 +696,8 @@ static void access_counters_isr_bottom_half(void *args)
     ++parent_gpu->isr.access_counters.stats.bottom_half_count;
     cpumask_set_cpu(cpu, &parent_gpu->isr.access_counters.stats.cpus_used_mask);
     ++parent_gpu->isr.access_counters.stats.cpu_exec_count[cpu];
+    if (bottom_half_cpu_is_remote(parent_gpu, cpu))
+        ++parent_gpu->isr.access_counters.stats.remote_node_count;
     put_cpu();
 
     uvm_parent_gpu_service_access_counters(parent_gpu);
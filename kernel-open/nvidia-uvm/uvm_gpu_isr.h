@@ -84,8 +84,25 @@ typedef struct
         // An array (one per possible CPU), which holds the number of times the
         // bottom half has executed on that CPU.
         NvU64 *cpu_exec_count;
+
+        // Number of bottom-half invocations that executed on a CPU outside of
+        // the NUMA node closest to the GPU. Not updated if the GPU has no
+        // closest NUMA node.
+        NvU64 remote_node_count;
+
+        // Number of additional fault buffer service passes performed by bottom
+        // halves while polling with interrupts disabled. Only used for
+        // replayable faults.
+        NvU64 poll_count;
     } stats;
 
+    // Maximum number of additional fault buffer service passes the next bottom
+    // half may perform before re-enabling interrupts. It adapts to the load
+    // between UVM_ISR_POLL_BUDGET_MIN and the value of the
+    // uvm_fault_poll_budget_max module parameter. Only used for replayable
+    // faults, and only accessed with the service_lock held.
+    NvU32 poll_budget;
+
     // This is the number of times the function that disables this type of
     // interrupt has been called without a corresponding call to the function
     // that enables it. If this is > 0, interrupts are disabled. This field is
@@ -133,6 +150,10 @@ NV_STATUS uvm_isr_top_half_entry(const NvProcessorUuid *gpu_uuid);
 // Initialize ISR handling state
 NV_STATUS uvm_parent_gpu_init_isr(uvm_parent_gpu_t *parent_gpu);
 
+// Initialize the given queue. If thread affinity is supported and node is not
+// -1, the queue's thread is restricted to the CPUs in the given NUMA node.
+NV_STATUS uvm_kthread_q_init_on_node(nv_kthread_q_t *queue, const char *name, int node);
+
 // Flush any currently scheduled bottom halves.  This is called during GPU
 // removal.
 void uvm_parent_gpu_flush_bottom_halves(uvm_parent_gpu_t *parent_gpu);
@@ -114,6 +114,126 @@
 // uvm_va_block_service_locked. Another similarity between the two types of
 // faults is that they use the same entry format, uvm_fault_buffer_entry_t.
 
+#define UVM_PERF_NON_REPLAYABLE_FAULT_SERVICE_WORKERS_MAX 16
+
+// Number of worker threads used to service the non-replayable faults of
+// different VA spaces in parallel. Faults within a VA space are always serviced
+// by a single thread, in the order in which they were fetched from the shadow
+// buffer, so a VA space with many faults, for example a channel faulting
+// heavily during an external allocation import, does not delay the faults of
+// other VA spaces. 0 and 1 mean that faults are serviced serially by the bottom
+// half.
+//
+// Parallel servicing is not supported if ATS is enabled. The faults are
+// serviced serially in that case.
+static unsigned uvm_perf_non_replayable_fault_service_workers = 0;
+module_param(uvm_perf_non_replayable_fault_service_workers, uint, S_IRUGO);
+
+static void service_faults_worker_entry(void *args);
+
+static void service_context_init(uvm_non_replayable_fault_service_context_t *service_context)
+{
+    uvm_tracker_init(&service_context->clear_faulted_tracker);
+    uvm_tracker_init(&service_context->fault_service_tracker);
+}
+
+static void service_context_deinit(uvm_non_replayable_fault_service_context_t *service_context)
+{
+    UVM_ASSERT(uvm_tracker_is_empty(&service_context->clear_faulted_tracker));
+    uvm_tracker_deinit(&service_context->clear_faulted_tracker);
+
+    UVM_ASSERT(uvm_tracker_is_empty(&service_context->fault_service_tracker));
+    uvm_tracker_deinit(&service_context->fault_service_tracker);
+}
+
+static NV_STATUS init_service_workers(uvm_parent_gpu_t *parent_gpu)
+{
+    NV_STATUS status;
+    NvU32 i;
+    uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &parent_gpu->fault_buffer_info.non_replayable;
+    NvU32 num_workers = min(uvm_perf_non_replayable_fault_service_workers,
+                            (unsigned)UVM_PERF_NON_REPLAYABLE_FAULT_SERVICE_WORKERS_MAX);
+
+    if (num_workers != uvm_perf_non_replayable_fault_service_workers) {
+        pr_info("Invalid uvm_perf_non_replayable_fault_service_workers value on GPU %s: %u. Valid range [0:%u] "
+                "Using %u instead\n",
+                uvm_parent_gpu_name(parent_gpu),
+                uvm_perf_non_replayable_fault_service_workers,
+                UVM_PERF_NON_REPLAYABLE_FAULT_SERVICE_WORKERS_MAX,
+                num_workers);
+    }
+
+    if (num_workers <= 1)
+        return NV_OK;
+
+    if (g_uvm_global.ats.enabled) {
+        pr_info("Parallel non-replayable fault servicing is not supported on GPU %s, faults will be serviced "
+                "serially\n",
+                uvm_parent_gpu_name(parent_gpu));
+        return NV_OK;
+    }
+
+    non_replayable_faults->service_workers.workers =
+        uvm_kvmalloc_zero_node(num_workers * sizeof(*non_replayable_faults->service_workers.workers),
+                               parent_gpu->closest_cpu_numa_node);
+    if (!non_replayable_faults->service_workers.workers)
+        return NV_ERR_NO_MEMORY;
+
+    non_replayable_faults->service_workers.count = num_workers;
+    init_completion(&non_replayable_faults->service_workers.done);
+
+    // Initialize the trackers first so that they can be unconditionally
+    // deinitialized on failure
+    for (i = 0; i < num_workers; ++i)
+        service_context_init(&non_replayable_faults->service_workers.workers[i].service_context);
+
+    for (i = 0; i < num_workers; ++i) {
+        uvm_non_replayable_fault_service_worker_t *worker = &non_replayable_faults->service_workers.workers[i];
+        uvm_service_block_context_t *block_service_context = &worker->service_context.block_service_context;
+        char kthread_name[TASK_COMM_LEN + 1];
+
+        worker->parent_gpu = parent_gpu;
+        worker->index = i;
+
+        block_service_context->block_context = uvm_va_block_context_alloc(NULL);
+        if (!block_service_context->block_context)
+            return NV_ERR_NO_MEMORY;
+
+        nv_kthread_q_item_init(&worker->q_item, service_faults_worker_entry, worker);
+
+        snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u NR%u", uvm_parent_id_value(parent_gpu->id), i);
+        status = uvm_kthread_q_init_on_node(&worker->q, kthread_name, parent_gpu->closest_cpu_numa_node);
+        if (status != NV_OK) {
+            UVM_ERR_PRINT("Failed in nv_kthread_q_init for non-replayable fault service worker %u: %s, GPU %s\n",
+                          i,
+                          nvstatusToString(status),
+                          uvm_parent_gpu_name(parent_gpu));
+            return status;
+        }
+    }
+
+    return NV_OK;
+}
+
+static void deinit_service_workers(uvm_parent_gpu_t *parent_gpu)
+{
+    NvU32 i;
+    uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &parent_gpu->fault_buffer_info.non_replayable;
+
+    for (i = 0; i < non_replayable_faults->service_workers.count; ++i) {
+        uvm_non_replayable_fault_service_worker_t *worker = &non_replayable_faults->service_workers.workers[i];
+
+        // It is safe to stop a queue that failed to initialize
+        nv_kthread_q_stop(&worker->q);
+
+        service_context_deinit(&worker->service_context);
+        uvm_va_block_context_free(worker->service_context.block_service_context.block_context);
+    }
+
+    uvm_kvfree(non_replayable_faults->service_workers.workers);
+    non_replayable_faults->service_workers.workers = NULL;
+    non_replayable_faults->service_workers.count = 0;
+}
 
 // There is no error handling in this function. The caller is in charge of
 // calling uvm_parent_gpu_fault_buffer_deinit_non_replayable_faults on failure.
@@ -129,33 +249,33 @@ NV_STATUS uvm_parent_gpu_fault_buffer_init_non_replayable_faults(uvm_parent_gpu_
     non_replayable_faults->max_faults = parent_gpu->fault_buffer_info.rm_info.nonReplayable.bufferSize /
                                         parent_gpu->fault_buffer_hal->entry_size(parent_gpu);
 
+    // The buffers are only accessed by the bottom half and the fault service
+    // workers, which run on the CPUs closest to the GPU.
     non_replayable_faults->shadow_buffer_copy =
-        uvm_kvmalloc_zero(parent_gpu->fault_buffer_info.rm_info.nonReplayable.bufferSize);
+        uvm_kvmalloc_zero_node(parent_gpu->fault_buffer_info.rm_info.nonReplayable.bufferSize,
+                               parent_gpu->closest_cpu_numa_node);
     if (!non_replayable_faults->shadow_buffer_copy)
         return NV_ERR_NO_MEMORY;
 
-    non_replayable_faults->fault_cache = uvm_kvmalloc_zero(non_replayable_faults->max_faults *
-                                                           sizeof(*non_replayable_faults->fault_cache));
+    non_replayable_faults->fault_cache = uvm_kvmalloc_zero_node(non_replayable_faults->max_faults *
+                                                                sizeof(*non_replayable_faults->fault_cache),
+                                                                parent_gpu->closest_cpu_numa_node);
     if (!non_replayable_faults->fault_cache)
         return NV_ERR_NO_MEMORY;
 
-    uvm_tracker_init(&non_replayable_faults->clear_faulted_tracker);
-    uvm_tracker_init(&non_replayable_faults->fault_service_tracker);
+    service_context_init(&non_replayable_faults->service_context);
 
-    return NV_OK;
+    return init_service_workers(parent_gpu);
 }
 
 void uvm_parent_gpu_fault_buffer_deinit_non_replayable_faults(uvm_parent_gpu_t *parent_gpu)
 {
     uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &parent_gpu->fault_buffer_info.non_replayable;
 
-    if (non_replayable_faults->fault_cache) {
-        UVM_ASSERT(uvm_tracker_is_empty(&non_replayable_faults->clear_faulted_tracker));
-        uvm_tracker_deinit(&non_replayable_faults->clear_faulted_tracker);
+    deinit_service_workers(parent_gpu);
 
-        UVM_ASSERT(uvm_tracker_is_empty(&non_replayable_faults->fault_service_tracker));
-        uvm_tracker_deinit(&non_replayable_faults->fault_service_tracker);
-    }
+    if (non_replayable_faults->fault_cache)
+        service_context_deinit(&non_replayable_faults->service_context);
 
     uvm_kvfree(non_replayable_faults->shadow_buffer_copy);
     uvm_kvfree(non_replayable_faults->fault_cache);
@@ -261,19 +381,17 @@ static bool use_clear_faulted_channel_sw_method(uvm_parent_gpu_t *parent_gpu)
 
 static NV_STATUS clear_faulted_method_on_gpu(uvm_user_channel_t *user_channel,
                                              const uvm_fault_buffer_entry_t *fault_entry,
-                                             NvU32 batch_id,
-                                             uvm_tracker_t *tracker)
+                                             uvm_non_replayable_fault_service_context_t *service_context)
 {
     uvm_gpu_t *gpu = user_channel->gpu;
     NV_STATUS status;
     uvm_push_t push;
-    uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &gpu->parent->fault_buffer_info.non_replayable;
 
     UVM_ASSERT(!fault_entry->is_fatal);
 
     status = uvm_push_begin_acquire(gpu->channel_manager,
                                     UVM_CHANNEL_TYPE_MEMOPS,
-                                    tracker,
+                                    &service_context->fault_service_tracker,
                                     &push,
                                     "Clearing set bit for address 0x%llx",
                                     fault_entry->fault_address);
@@ -289,13 +407,13 @@ static NV_STATUS clear_faulted_method_on_gpu(uvm_user_channel_t *user_channel,
     else
         gpu->parent->host_hal->clear_faulted_channel_method(&push, user_channel, fault_entry);
 
-    uvm_tools_broadcast_replay(gpu, &push, batch_id, fault_entry->fault_source.client_type);
+    uvm_tools_broadcast_replay(gpu, &push, service_context->batch_id, fault_entry->fault_source.client_type);
 
     uvm_push_end(&push);
 
-    // Add this push to the GPU's clear_faulted_tracker so GPU removal can wait
-    // on it.
-    status = uvm_tracker_add_push_safe(&non_replayable_faults->clear_faulted_tracker, &push);
+    // Add this push to the clear_faulted_tracker of the service context, which
+    // ends up in the GPU's one, so GPU removal can wait on it.
+    status = uvm_tracker_add_push_safe(&service_context->clear_faulted_tracker, &push);
 
     // Add this push to the channel's clear_faulted_tracker so user channel
     // removal can wait on it instead of using the per-GPU tracker, which would
@@ -308,8 +426,7 @@ static NV_STATUS clear_faulted_method_on_gpu(uvm_user_channel_t *user_channel,
 
 static NV_STATUS clear_faulted_register_on_gpu(uvm_user_channel_t *user_channel,
                                                const uvm_fault_buffer_entry_t *fault_entry,
-                                               NvU32 batch_id,
-                                               uvm_tracker_t *tracker)
+                                               uvm_non_replayable_fault_service_context_t *service_context)
 {
     uvm_gpu_t *gpu = user_channel->gpu;
     NV_STATUS status;
@@ -318,36 +435,36 @@ static NV_STATUS clear_faulted_register_on_gpu(uvm_user_channel_t *user_channel,
 
     // We need to wait for all pending work before writing to the channel
     // register
-    status = uvm_tracker_wait(tracker);
+    status = uvm_tracker_wait(&service_context->fault_service_tracker);
     if (status != NV_OK)
         return status;
 
     gpu->parent->host_hal->clear_faulted_channel_register(user_channel, fault_entry);
 
-    uvm_tools_broadcast_replay_sync(gpu, batch_id, fault_entry->fault_source.client_type);
+    uvm_tools_broadcast_replay_sync(gpu, service_context->batch_id, fault_entry->fault_source.client_type);
 
     return NV_OK;
 }
 
 static NV_STATUS clear_faulted_on_gpu(uvm_user_channel_t *user_channel,
                                       const uvm_fault_buffer_entry_t *fault_entry,
-                                      NvU32 batch_id,
-                                      uvm_tracker_t *tracker)
+                                      uvm_non_replayable_fault_service_context_t *service_context)
 {
     uvm_gpu_t *gpu = user_channel->gpu;
 
     if (gpu->parent->has_clear_faulted_channel_method || use_clear_faulted_channel_sw_method(gpu->parent))
-        return clear_faulted_method_on_gpu(user_channel, fault_entry, batch_id, tracker);
+        return clear_faulted_method_on_gpu(user_channel, fault_entry, service_context);
 
-    return clear_faulted_register_on_gpu(user_channel, fault_entry, batch_id, tracker);
+    return clear_faulted_register_on_gpu(user_channel, fault_entry, service_context);
 }
 
 static NV_STATUS service_managed_fault_in_block_locked(uvm_va_block_t *va_block,
                                                        uvm_va_block_retry_t *va_block_retry,
                                                        uvm_fault_buffer_entry_t *fault_entry,
-                                                       uvm_service_block_context_t *service_context,
+                                                       uvm_non_replayable_fault_service_context_t *fault_context,
                                                        const bool hmm_migratable)
 {
+    uvm_service_block_context_t *service_context = &fault_context->block_service_context;
     uvm_gpu_t *gpu = fault_entry->gpu;
     NV_STATUS status = NV_OK;
     uvm_page_index_t page_index;
@@ -372,12 +489,13 @@ static NV_STATUS service_managed_fault_in_block_locked(uvm_va_block_t *va_block,
         // notify event to tools/performance heuristics. For now we use a
         // unique batch id per fault, since we clear the faulted channel for
         // each fault.
+        fault_context->batch_id = atomic_inc_return(&non_replayable_faults->batch_id);
         uvm_perf_event_notify_gpu_fault(&va_space->perf_events,
                                         va_block,
                                         gpu->id,
                                         policy->preferred_location,
                                         fault_entry,
-                                        ++non_replayable_faults->batch_id,
+                                        fault_context->batch_id,
                                         false);
     }
 
@@ -445,12 +563,12 @@ static NV_STATUS service_managed_fault_in_block_locked(uvm_va_block_t *va_block,
 
 static NV_STATUS service_managed_fault_in_block(uvm_va_block_t *va_block,
                                                 uvm_fault_buffer_entry_t *fault_entry,
+                                                uvm_non_replayable_fault_service_context_t *fault_context,
                                                 const bool hmm_migratable)
 {
     NV_STATUS status, tracker_status;
     uvm_va_block_retry_t va_block_retry;
-    uvm_gpu_t *gpu = fault_entry->gpu;
-    uvm_service_block_context_t *service_context = &gpu->parent->fault_buffer_info.non_replayable.block_service_context;
+    uvm_service_block_context_t *service_context = &fault_context->block_service_context;
 
     service_context->operation = UVM_SERVICE_OPERATION_NON_REPLAYABLE_FAULTS;
     service_context->num_retries = 0;
@@ -464,11 +582,10 @@ static NV_STATUS service_managed_fault_in_block(uvm_va_block_t *va_block,
                                        service_managed_fault_in_block_locked(va_block,
                                                                              &va_block_retry,
                                                                              fault_entry,
-                                                                             service_context,
+                                                                             fault_context,
                                                                              hmm_migratable));
 
-    tracker_status = uvm_tracker_add_tracker_safe(&gpu->parent->fault_buffer_info.non_replayable.fault_service_tracker,
-                                                  &va_block->tracker);
+    tracker_status = uvm_tracker_add_tracker_safe(&fault_context->fault_service_tracker, &va_block->tracker);
 
     uvm_mutex_unlock(&va_block->lock);
 
@@ -547,6 +664,7 @@ static void service_fault_fatal(uvm_fault_buffer_entry_t *fault_entry, NV_STATUS
 static NV_STATUS service_non_managed_fault(uvm_gpu_va_space_t *gpu_va_space,
                                            struct mm_struct *mm,
                                            uvm_fault_buffer_entry_t *fault_entry,
+                                           uvm_non_replayable_fault_service_context_t *fault_context,
                                            NV_STATUS lookup_status)
 {
     uvm_va_space_t *va_space = gpu_va_space->va_space;
@@ -561,12 +679,13 @@ static NV_STATUS service_non_managed_fault(uvm_gpu_va_space_t *gpu_va_space,
     UVM_ASSERT(fault_entry->gpu == gpu);
 
     // Avoid dropping fault events when the VA block is not found or cannot be created
+    fault_context->batch_id = atomic_inc_return(&non_replayable_faults->batch_id);
     uvm_perf_event_notify_gpu_fault(&va_space->perf_events,
                                     NULL,
                                     gpu->id,
                                     UVM_ID_INVALID,
                                     fault_entry,
-                                    ++non_replayable_faults->batch_id,
+                                    fault_context->batch_id,
                                     false);
 
     if (status != NV_ERR_INVALID_ADDRESS)
@@ -574,6 +693,10 @@ static NV_STATUS service_non_managed_fault(uvm_gpu_va_space_t *gpu_va_space,
 
     if (uvm_ats_can_service_faults(gpu_va_space, mm)) {
         struct vm_area_struct *vma;
+
+        // ATS faults are only serviced from the bottom half, see
+        // uvm_perf_non_replayable_fault_service_workers.
+        UVM_ASSERT(fault_context == &non_replayable_faults->service_context);
         uvm_va_range_t *va_range_next;
         NvU64 fault_address = fault_entry->fault_address;
         uvm_fault_access_type_t fault_access_type = fault_entry->fault_access_type;
@@ -611,7 +734,7 @@ static NV_STATUS service_non_managed_fault(uvm_gpu_va_space_t *gpu_va_space,
                 if (uvm_page_mask_test(faults_serviced_mask, page_index)) {
                     status = uvm_ats_invalidate_tlbs(gpu_va_space,
                                                      ats_invalidate,
-                                                     &non_replayable_faults->fault_service_tracker);
+                                                     &fault_context->fault_service_tracker);
                     fatal_fault_status = NV_OK;
                 }
             }
@@ -635,6 +758,7 @@ static NV_STATUS service_non_managed_fault(uvm_gpu_va_space_t *gpu_va_space,
 
 static NV_STATUS service_fault_once(uvm_parent_gpu_t *parent_gpu,
                                     uvm_fault_buffer_entry_t *fault_entry,
+                                    uvm_non_replayable_fault_service_context_t *fault_context,
                                     const bool hmm_migratable)
 {
     NV_STATUS status;
@@ -644,8 +768,7 @@ static NV_STATUS service_fault_once(uvm_parent_gpu_t *parent_gpu,
     struct mm_struct *mm;
     uvm_gpu_va_space_t *gpu_va_space;
     uvm_gpu_t *gpu;
-    uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &parent_gpu->fault_buffer_info.non_replayable;
-    uvm_va_block_context_t *va_block_context = non_replayable_faults->block_service_context.block_context;
+    uvm_va_block_context_t *va_block_context = fault_context->block_service_context.block_context;
 
     status = uvm_parent_gpu_fault_entry_to_va_space(parent_gpu,
                                                     fault_entry,
@@ -712,18 +835,15 @@ static NV_STATUS service_fault_once(uvm_parent_gpu_t *parent_gpu,
                                                       &va_block);
         }
         if (status == NV_OK)
-            status = service_managed_fault_in_block(va_block, fault_entry, hmm_migratable);
+            status = service_managed_fault_in_block(va_block, fault_entry, fault_context, hmm_migratable);
         else
-            status = service_non_managed_fault(gpu_va_space, mm, fault_entry, status);
+            status = service_non_managed_fault(gpu_va_space, mm, fault_entry, fault_context, status);
 
         // We are done, we clear the faulted bit on the channel, so it can be
         // re-scheduled again
         if (status == NV_OK && !fault_entry->is_fatal) {
-            status = clear_faulted_on_gpu(user_channel,
-                                          fault_entry,
-                                          non_replayable_faults->batch_id,
-                                          &non_replayable_faults->fault_service_tracker);
-            uvm_tracker_clear(&non_replayable_faults->fault_service_tracker);
+            status = clear_faulted_on_gpu(user_channel, fault_entry, fault_context);
+            uvm_tracker_clear(&fault_context->fault_service_tracker);
         }
     }
 
@@ -749,17 +869,17 @@ exit_no_channel:
     return status;
 }
 
-static NV_STATUS service_fault(uvm_parent_gpu_t *parent_gpu, uvm_fault_buffer_entry_t *fault_entry)
+static NV_STATUS service_fault(uvm_parent_gpu_t *parent_gpu,
+                               uvm_fault_buffer_entry_t *fault_entry,
+                               uvm_non_replayable_fault_service_context_t *fault_context)
 {
-    uvm_service_block_context_t *service_context =
-        &parent_gpu->fault_buffer_info.non_replayable.block_service_context;
     NV_STATUS status;
     bool hmm_migratable = true;
 
-    service_context->num_retries = 0;
+    fault_context->block_service_context.num_retries = 0;
 
     do {
-        status = service_fault_once(parent_gpu, fault_entry, hmm_migratable);
+        status = service_fault_once(parent_gpu, fault_entry, fault_context, hmm_migratable);
         if (status == NV_WARN_MISMATCHED_TARGET) {
             hmm_migratable = false;
             status = NV_WARN_MORE_PROCESSING_REQUIRED;
@@ -769,9 +889,127 @@ static NV_STATUS service_fault(uvm_parent_gpu_t *parent_gpu, uvm_fault_buffer_en
     return status;
 }
 
+static void service_faults_worker(uvm_non_replayable_fault_service_worker_t *worker)
+{
+    NV_STATUS status = NV_OK;
+    uvm_parent_gpu_t *parent_gpu = worker->parent_gpu;
+    uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &parent_gpu->fault_buffer_info.non_replayable;
+    NvU32 i;
+
+    for (i = 0; i < worker->num_cached_faults; ++i) {
+        uvm_fault_buffer_entry_t *fault_entry = &non_replayable_faults->fault_cache[i];
+
+        if (fault_entry->non_replayable.worker_index != worker->index)
+            continue;
+
+        status = service_fault(parent_gpu, fault_entry, &worker->service_context);
+        if (status != NV_OK)
+            break;
+    }
+
+    worker->status = status;
+
+    if (atomic_dec_and_test(&non_replayable_faults->service_workers.pending))
+        complete(&non_replayable_faults->service_workers.done);
+}
+
+static void service_faults_worker_entry(void *args)
+{
+    UVM_ENTRY_VOID(service_faults_worker((uvm_non_replayable_fault_service_worker_t *)args));
+}
+
+// Assign each fetched fault to a fault service worker. The VA spaces are
+// distributed among the workers in round-robin order of first appearance in
+// the shadow buffer. Faults whose VA space cannot be found are serviced by the
+// first worker, which just skips them. Returns the number of distinct VA
+// spaces.
+static NvU32 assign_faults_to_workers(uvm_parent_gpu_t *parent_gpu, NvU32 cached_faults)
+{
+    uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &parent_gpu->fault_buffer_info.non_replayable;
+    NvU32 num_workers = non_replayable_faults->service_workers.count;
+    NvU32 num_va_spaces = 0;
+    NvU32 i;
+
+    for (i = 0; i < cached_faults; ++i) {
+        uvm_fault_buffer_entry_t *fault_entry = &non_replayable_faults->fault_cache[i];
+        uvm_va_space_t *va_space;
+        uvm_gpu_t *gpu;
+        NvU32 j;
+
+        fault_entry->non_replayable.worker_index = 0;
+
+        // The VA space is only used as a sharding key here. It is looked up
+        // again, with the appropriate locking, when the fault is serviced.
+        if (uvm_parent_gpu_fault_entry_to_va_space(parent_gpu, fault_entry, &va_space, &gpu) != NV_OK)
+            continue;
+
+        fault_entry->va_space = va_space;
+
+        // The shadow buffer is small enough for a linear search over the
+        // previous faults to be cheap.
+        for (j = 0; j < i; ++j) {
+            uvm_fault_buffer_entry_t *prev_entry = &non_replayable_faults->fault_cache[j];
+
+            if (prev_entry->va_space == va_space) {
+                fault_entry->non_replayable.worker_index = prev_entry->non_replayable.worker_index;
+                break;
+            }
+        }
+
+        if (j == i)
+            fault_entry->non_replayable.worker_index = num_va_spaces++ % num_workers;
+    }
+
+    // Reset the VA spaces, which must be NULL on entry to service_fault().
+    for (i = 0; i < cached_faults; ++i)
+        non_replayable_faults->fault_cache[i].va_space = NULL;
+
+    return num_va_spaces;
+}
+
+// Service the fetched faults with the fault service workers, and wait for all
+// of them to finish.
+static NV_STATUS service_faults_parallel(uvm_parent_gpu_t *parent_gpu, NvU32 cached_faults)
+{
+    NV_STATUS status = NV_OK;
+    NvU32 i;
+    uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &parent_gpu->fault_buffer_info.non_replayable;
+    NvU32 num_workers = non_replayable_faults->service_workers.count;
+
+    atomic_set(&non_replayable_faults->service_workers.pending, num_workers);
+    reinit_completion(&non_replayable_faults->service_workers.done);
+
+    for (i = 0; i < num_workers; ++i) {
+        uvm_non_replayable_fault_service_worker_t *worker = &non_replayable_faults->service_workers.workers[i];
+
+        worker->num_cached_faults = cached_faults;
+        worker->status = NV_OK;
+
+        nv_kthread_q_schedule_q_item(&worker->q, &worker->q_item);
+    }
+
+    wait_for_completion(&non_replayable_faults->service_workers.done);
+
+    for (i = 0; i < num_workers; ++i) {
+        uvm_non_replayable_fault_service_worker_t *worker = &non_replayable_faults->service_workers.workers[i];
+        uvm_tracker_t *worker_tracker = &worker->service_context.clear_faulted_tracker;
+        NV_STATUS tracker_status;
+
+        tracker_status = uvm_tracker_add_tracker_safe(&non_replayable_faults->service_context.clear_faulted_tracker,
+                                                      worker_tracker);
+        uvm_tracker_clear(worker_tracker);
+
+        if (status == NV_OK)
+            status = worker->status != NV_OK? worker->status : tracker_status;
+    }
+
+    return status;
+}
+
 void uvm_parent_gpu_service_non_replayable_fault_buffer(uvm_parent_gpu_t *parent_gpu)
 {
     NvU32 cached_faults;
+    uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &parent_gpu->fault_buffer_info.non_replayable;
 
     // If this handler is modified to handle fewer than all of the outstanding
     // faults, then special handling will need to be added to uvm_suspend()
@@ -785,11 +1023,26 @@ void uvm_parent_gpu_service_non_replayable_fault_buffer(uvm_parent_gpu_t *parent
         if (status != NV_OK)
             return;
 
+        // Faults from different VA spaces are independent, so they can be
+        // serviced in parallel if there is more than one VA space in the
+        // shadow buffer.
+        if (non_replayable_faults->service_workers.count > 0 &&
+            cached_faults > 1 &&
+            assign_faults_to_workers(parent_gpu, cached_faults) > 1) {
+            status = service_faults_parallel(parent_gpu, cached_faults);
+            if (status != NV_OK)
+                return;
+
+            continue;
+        }
+
         // Differently to replayable faults, we do not batch up and preprocess
         // non-replayable faults since getting multiple faults on the same
         // memory region is not very likely
         for (i = 0; i < cached_faults; ++i) {
-            status = service_fault(parent_gpu, &parent_gpu->fault_buffer_info.non_replayable.fault_cache[i]);
+            status = service_fault(parent_gpu,
+                                   &non_replayable_faults->fault_cache[i],
+                                   &non_replayable_faults->service_context);
             if (status != NV_OK)
                 return;
         }
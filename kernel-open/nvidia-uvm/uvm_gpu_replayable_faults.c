@@ -39,6 +39,7 @@
 #include "uvm_gpu_non_replayable_faults.h"
 #include "uvm_ats_faults.h"
 #include "uvm_test.h"
+#include "uvm_test_rng.h"
 
 // The documentation at the beginning of uvm_gpu_non_replayable_faults.c
 // provides some background for understanding replayable faults, non-replayable
@@ -77,6 +78,24 @@ module_param(uvm_perf_reenable_prefetch_faults_lapse_msec, uint, S_IRUGO);
 static unsigned uvm_perf_fault_batch_count = UVM_PERF_FAULT_BATCH_COUNT_DEFAULT;
 module_param(uvm_perf_fault_batch_count, uint, S_IRUGO);
 
+#define UVM_PERF_FAULT_BATCH_ADAPTIVE_MIN 32
+
+// When enabled, the number of entries fetched per batch is adjusted at runtime
+// between UVM_PERF_FAULT_BATCH_ADAPTIVE_MIN and uvm_perf_fault_batch_count.
+// The batch count shrinks when the average batch service time exceeds
+// uvm_perf_fault_batch_target_usec or when the ratio of duplicate faults in a
+// batch exceeds uvm_perf_fault_replay_update_put_ratio, so that replays are
+// issued earlier. It grows when batches are full and are serviced well within
+// the target time.
+static unsigned uvm_perf_fault_batch_adaptive = 0;
+module_param(uvm_perf_fault_batch_adaptive, uint, S_IRUGO);
+
+#define UVM_PERF_FAULT_BATCH_TARGET_USEC_DEFAULT 500
+
+// Target batch service time in microseconds for adaptive batch sizing
+static unsigned uvm_perf_fault_batch_target_usec = UVM_PERF_FAULT_BATCH_TARGET_USEC_DEFAULT;
+module_param(uvm_perf_fault_batch_target_usec, uint, S_IRUGO);
+
 #define UVM_PERF_FAULT_REPLAY_POLICY_DEFAULT UVM_PERF_FAULT_REPLAY_POLICY_BATCH_FLUSH
 
 // Policy that determines when to issue fault replays
@@ -115,6 +134,139 @@ module_param(uvm_perf_fault_max_throttle_per_service, uint, S_IRUGO);
 static unsigned uvm_perf_fault_coalesce = 1;
 module_param(uvm_perf_fault_coalesce, uint, S_IRUGO);
 
+#define UVM_PERF_FAULT_SERVICE_WORKERS_MAX 16
+
+// Number of worker threads used to service the faults of different VA spaces
+// in a batch in parallel. Faults within a VA space are always serviced by a
+// single thread, and a single replay is issued once all the workers are done.
+// 0 and 1 mean that faults are serviced serially by the bottom half.
+//
+// Parallel servicing is not supported with the BLOCK replay policy, on GPUs
+// that cannot cancel faults by VA, or if ATS is enabled. The faults are
+// serviced serially in those cases.
+static unsigned uvm_perf_fault_service_workers = 0;
+module_param(uvm_perf_fault_service_workers, uint, S_IRUGO);
+
+static void service_fault_batch_worker_entry(void *args);
+
+static NV_STATUS fault_buffer_init_service_workers(uvm_parent_gpu_t *parent_gpu)
+{
+    NV_STATUS status;
+    NvU32 i;
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+    NvU32 num_workers = min(uvm_perf_fault_service_workers, (unsigned)UVM_PERF_FAULT_SERVICE_WORKERS_MAX);
+
+    if (num_workers != uvm_perf_fault_service_workers) {
+        pr_info("Invalid uvm_perf_fault_service_workers value on GPU %s: %u. Valid range [0:%u] Using %u instead\n",
+                uvm_parent_gpu_name(parent_gpu),
+                uvm_perf_fault_service_workers,
+                UVM_PERF_FAULT_SERVICE_WORKERS_MAX,
+                num_workers);
+    }
+
+    if (num_workers <= 1)
+        return NV_OK;
+
+    if (replayable_faults->replay_policy == UVM_PERF_FAULT_REPLAY_POLICY_BLOCK ||
+        !parent_gpu->fault_cancel_va_supported ||
+        g_uvm_global.ats.enabled) {
+        pr_info("Parallel fault servicing is not supported on GPU %s, faults will be serviced serially\n",
+                uvm_parent_gpu_name(parent_gpu));
+        return NV_OK;
+    }
+
+    replayable_faults->service_workers.workers =
+        uvm_kvmalloc_zero_node(num_workers * sizeof(*replayable_faults->service_workers.workers),
+                               parent_gpu->closest_cpu_numa_node);
+    if (!replayable_faults->service_workers.workers)
+        return NV_ERR_NO_MEMORY;
+
+    replayable_faults->service_workers.count = num_workers;
+    init_completion(&replayable_faults->service_workers.done);
+
+    // Initialize the trackers first so that they can be unconditionally
+    // deinitialized on failure
+    for (i = 0; i < num_workers; ++i)
+        uvm_tracker_init(&replayable_faults->service_workers.workers[i].batch_context.tracker);
+
+    for (i = 0; i < num_workers; ++i) {
+        uvm_fault_service_worker_t *worker = &replayable_faults->service_workers.workers[i];
+        char kthread_name[TASK_COMM_LEN + 1];
+
+        worker->parent_gpu = parent_gpu;
+        worker->index = i;
+        worker->batch_context.block_service_context = &worker->block_service_context;
+
+        worker->block_service_context.block_context = uvm_va_block_context_alloc(NULL);
+        if (!worker->block_service_context.block_context)
+            return NV_ERR_NO_MEMORY;
+
+        nv_kthread_q_item_init(&worker->q_item, service_fault_batch_worker_entry, worker);
+
+        snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u FS%u", uvm_parent_id_value(parent_gpu->id), i);
+        status = uvm_kthread_q_init_on_node(&worker->q, kthread_name, parent_gpu->closest_cpu_numa_node);
+        if (status != NV_OK) {
+            UVM_ERR_PRINT("Failed in nv_kthread_q_init for fault service worker %u: %s, GPU %s\n",
+                          i,
+                          nvstatusToString(status),
+                          uvm_parent_gpu_name(parent_gpu));
+            return status;
+        }
+    }
+
+    return NV_OK;
+}
+
+static void fault_buffer_deinit_service_workers(uvm_parent_gpu_t *parent_gpu)
+{
+    NvU32 i;
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+
+    for (i = 0; i < replayable_faults->service_workers.count; ++i) {
+        uvm_fault_service_worker_t *worker = &replayable_faults->service_workers.workers[i];
+
+        // It is safe to stop a queue that failed to initialize
+        nv_kthread_q_stop(&worker->q);
+
+        UVM_ASSERT(uvm_tracker_is_empty(&worker->batch_context.tracker));
+        uvm_tracker_deinit(&worker->batch_context.tracker);
+        uvm_va_block_context_free(worker->block_service_context.block_context);
+    }
+
+    uvm_kvfree(replayable_faults->service_workers.workers);
+    replayable_faults->service_workers.workers = NULL;
+    replayable_faults->service_workers.count = 0;
+}
+
+static NV_STATUS fault_batch_sort_init(uvm_fault_service_batch_context_t *batch_context, NvU32 max_faults, int node)
+{
+    batch_context->sort_keys = uvm_kvmalloc_node(max_faults * sizeof(*batch_context->sort_keys), node);
+    if (!batch_context->sort_keys)
+        return NV_ERR_NO_MEMORY;
+
+    batch_context->sort_tmp_keys = uvm_kvmalloc_node(max_faults * sizeof(*batch_context->sort_tmp_keys), node);
+    if (!batch_context->sort_tmp_keys)
+        return NV_ERR_NO_MEMORY;
+
+    batch_context->sort_histograms = uvm_kvmalloc_node(UVM_FAULT_SORT_RADIX_DIGITS *
+                                                       sizeof(*batch_context->sort_histograms),
+                                                       node);
+    if (!batch_context->sort_histograms)
+        return NV_ERR_NO_MEMORY;
+
+    return NV_OK;
+}
+
+static void fault_batch_sort_deinit(uvm_fault_service_batch_context_t *batch_context)
+{
+    uvm_kvfree(batch_context->sort_keys);
+    uvm_kvfree(batch_context->sort_tmp_keys);
+    uvm_kvfree(batch_context->sort_histograms);
+    batch_context->sort_keys       = NULL;
+    batch_context->sort_tmp_keys   = NULL;
+    batch_context->sort_histograms = NULL;
+}
+
 // This function is used for both the initial fault buffer initialization and
 // the power management resume path.
 static void fault_buffer_reinit_replayable_faults(uvm_parent_gpu_t *parent_gpu)
@@ -142,6 +294,7 @@ static NV_STATUS fault_buffer_init_replayable_faults(uvm_parent_gpu_t *parent_gp
     NV_STATUS status = NV_OK;
     uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
     uvm_fault_service_batch_context_t *batch_context = &replayable_faults->batch_service_context;
+    int node = parent_gpu->closest_cpu_numa_node;
 
     UVM_ASSERT(parent_gpu->fault_buffer_info.rm_info.replayable.bufferSize %
                parent_gpu->fault_buffer_hal->entry_size(parent_gpu) == 0);
@@ -164,27 +317,47 @@ static NV_STATUS fault_buffer_init_replayable_faults(uvm_parent_gpu_t *parent_gp
                 parent_gpu->fault_buffer_info.max_batch_size);
     }
 
-    batch_context->fault_cache = uvm_kvmalloc_zero(replayable_faults->max_faults * sizeof(*batch_context->fault_cache));
+    replayable_faults->adaptive_batch.enabled = uvm_perf_fault_batch_adaptive != 0;
+    replayable_faults->adaptive_batch.batch_count = parent_gpu->fault_buffer_info.max_batch_size;
+    replayable_faults->adaptive_batch.avg_service_time_ns = 0;
+    replayable_faults->adaptive_batch.history_count = 0;
+
+    // The batch buffers are only accessed by the bottom half and the fault
+    // service workers, which run on the CPUs closest to the GPU.
+    batch_context->fault_cache = uvm_kvmalloc_zero_node(replayable_faults->max_faults *
+                                                        sizeof(*batch_context->fault_cache),
+                                                        node);
     if (!batch_context->fault_cache)
         return NV_ERR_NO_MEMORY;
 
     // fault_cache is used to signal that the tracker was initialized.
     uvm_tracker_init(&replayable_faults->replay_tracker);
 
-    batch_context->ordered_fault_cache = uvm_kvmalloc_zero(replayable_faults->max_faults *
-                                                           sizeof(*batch_context->ordered_fault_cache));
+    batch_context->ordered_fault_cache = uvm_kvmalloc_zero_node(replayable_faults->max_faults *
+                                                                sizeof(*batch_context->ordered_fault_cache),
+                                                                node);
     if (!batch_context->ordered_fault_cache)
         return NV_ERR_NO_MEMORY;
 
+    status = fault_batch_sort_init(batch_context, replayable_faults->max_faults, node);
+    if (status != NV_OK)
+        return status;
+
+    replayable_faults->latency_histogram = alloc_percpu(uvm_fault_latency_histogram_t);
+    if (!replayable_faults->latency_histogram)
+        return NV_ERR_NO_MEMORY;
+
     // This value must be initialized by HAL
     UVM_ASSERT(replayable_faults->utlb_count > 0);
 
-    batch_context->utlbs = uvm_kvmalloc_zero(replayable_faults->utlb_count * sizeof(*batch_context->utlbs));
+    batch_context->utlbs = uvm_kvmalloc_zero_node(replayable_faults->utlb_count * sizeof(*batch_context->utlbs), node);
     if (!batch_context->utlbs)
         return NV_ERR_NO_MEMORY;
 
     batch_context->max_utlb_id = 0;
 
+    batch_context->block_service_context = &replayable_faults->block_service_context;
+
     status = uvm_rm_locked_call(nvUvmInterfaceOwnPageFaultIntr(parent_gpu->rm_device, NV_TRUE));
     if (status != NV_OK) {
         UVM_ERR_PRINT("Failed to take page fault ownership from RM: %s, GPU %s\n",
@@ -212,6 +385,10 @@ static NV_STATUS fault_buffer_init_replayable_faults(uvm_parent_gpu_t *parent_gp
                 replayable_faults->replay_update_put_ratio);
     }
 
+    status = fault_buffer_init_service_workers(parent_gpu);
+    if (status != NV_OK)
+        return status;
+
     // Re-enable fault prefetching just in case it was disabled in a previous run
     parent_gpu->fault_buffer_info.prefetch_faults_enabled = parent_gpu->prefetch_fault_supported;
 
@@ -225,6 +402,8 @@ static void fault_buffer_deinit_replayable_faults(uvm_parent_gpu_t *parent_gpu)
     uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
     uvm_fault_service_batch_context_t *batch_context = &replayable_faults->batch_service_context;
 
+    fault_buffer_deinit_service_workers(parent_gpu);
+
     if (batch_context->fault_cache) {
         UVM_ASSERT(uvm_tracker_is_empty(&replayable_faults->replay_tracker));
         uvm_tracker_deinit(&replayable_faults->replay_tracker);
@@ -236,6 +415,11 @@ static void fault_buffer_deinit_replayable_faults(uvm_parent_gpu_t *parent_gpu)
             parent_gpu->arch_hal->enable_prefetch_faults(parent_gpu);
     }
 
+    fault_batch_sort_deinit(batch_context);
+
+    free_percpu(replayable_faults->latency_histogram);
+    replayable_faults->latency_histogram = NULL;
+
     uvm_kvfree(batch_context->fault_cache);
     uvm_kvfree(batch_context->ordered_fault_cache);
     uvm_kvfree(batch_context->utlbs);
@@ -862,6 +1046,7 @@ static NV_STATUS fetch_fault_buffer_entries(uvm_parent_gpu_t *parent_gpu,
 
     batch_context->is_single_instance_ptr = true;
     batch_context->last_fault = NULL;
+    batch_context->fetch_timestamp_ns = NV_GETTIME();
 
     fault_index = 0;
     num_coalesced_faults = 0;
@@ -878,7 +1063,7 @@ static NV_STATUS fetch_fault_buffer_entries(uvm_parent_gpu_t *parent_gpu,
 
     // Parse until get != put and have enough space to cache.
     while ((get != put) &&
-           (fetch_mode == FAULT_FETCH_MODE_ALL || fault_index < parent_gpu->fault_buffer_info.max_batch_size)) {
+           (fetch_mode == FAULT_FETCH_MODE_ALL || fault_index < replayable_faults->adaptive_batch.batch_count)) {
         bool is_same_instance_ptr = true;
         uvm_fault_buffer_entry_t *current_entry = &fault_cache[fault_index];
         uvm_fault_utlb_info_t *current_tlb;
@@ -1101,6 +1286,200 @@ static NV_STATUS translate_instance_ptrs(uvm_parent_gpu_t *parent_gpu,
     return NV_OK;
 }
 
+// Fault batches are sorted twice during preprocessing. Rather than calling
+// sort() with the comparators above, each entry is packed into a 128-bit key
+// whose unsigned integer order matches the comparator order. Batches that are
+// already sorted, which is common for streaming access patterns, are detected
+// with a single pass over the keys. Nearly sorted batches are handled with a
+// bounded insertion sort, and the rest with an LSD radix sort. Entries with
+// equal keys compare equal with the comparators too, so any order among them is
+// valid.
+
+// Number of faults below which the keys are always insertion sorted
+#define FAULT_SORT_INSERTION_MAX 16
+
+// Bits of the low key word used by each field of the {va_space, GPU, address,
+// access type} key. The GPU id and the access type take their bits from the
+// top and bottom of the word, and the 4K page number of the fault address uses
+// the rest.
+#define FAULT_SORT_GPU_ID_BITS      9
+#define FAULT_SORT_ACCESS_TYPE_BITS 3
+
+static inline bool fault_sort_key_less(const uvm_fault_sort_key_t *a, const uvm_fault_sort_key_t *b)
+{
+    return a->hi < b->hi || (a->hi == b->hi && a->lo < b->lo);
+}
+
+static inline NvU32 fault_sort_key_digit(const uvm_fault_sort_key_t *key, NvU32 digit)
+{
+    const NvU32 digits_per_word = UVM_FAULT_SORT_RADIX_DIGITS / 2;
+    NvU64 word = digit < digits_per_word ? key->lo : key->hi;
+
+    return (word >> ((digit % digits_per_word) * UVM_FAULT_SORT_RADIX_BITS)) & (UVM_FAULT_SORT_RADIX_SIZE - 1);
+}
+
+// Insertion sort the keys, giving up after max_moves key moves. The keys are a
+// permutation of the input in both cases. Returns true if the keys were fully
+// sorted.
+static bool fault_sort_keys_insertion(uvm_fault_sort_key_t *keys, NvU32 num_keys, NvU32 max_moves)
+{
+    NvU32 i;
+    NvU32 num_moves = 0;
+
+    for (i = 1; i < num_keys; ++i) {
+        uvm_fault_sort_key_t key = keys[i];
+        NvU32 j = i;
+
+        while (j > 0 && fault_sort_key_less(&key, &keys[j - 1])) {
+            if (num_moves++ == max_moves) {
+                keys[j] = key;
+                return false;
+            }
+
+            keys[j] = keys[j - 1];
+            --j;
+        }
+
+        keys[j] = key;
+    }
+
+    return true;
+}
+
+// LSD radix sort of the keys. All the digit histograms are computed in a
+// single pass, and digits in which all the keys have the same value are
+// skipped. Returns the buffer holding the sorted keys, which is either
+// sort_keys or sort_tmp_keys.
+static uvm_fault_sort_key_t *fault_sort_keys_radix(uvm_fault_service_batch_context_t *batch_context, NvU32 num_keys)
+{
+    uvm_fault_sort_key_t *src = batch_context->sort_keys;
+    uvm_fault_sort_key_t *dst = batch_context->sort_tmp_keys;
+    NvU32 (*histograms)[UVM_FAULT_SORT_RADIX_SIZE] = batch_context->sort_histograms;
+    NvU32 i, digit;
+
+    memset(histograms, 0, UVM_FAULT_SORT_RADIX_DIGITS * sizeof(*histograms));
+
+    for (i = 0; i < num_keys; ++i) {
+        for (digit = 0; digit < UVM_FAULT_SORT_RADIX_DIGITS; ++digit)
+            ++histograms[digit][fault_sort_key_digit(&src[i], digit)];
+    }
+
+    for (digit = 0; digit < UVM_FAULT_SORT_RADIX_DIGITS; ++digit) {
+        NvU32 *histogram = histograms[digit];
+        NvU32 offset = 0;
+        NvU32 bucket;
+
+        if (histogram[fault_sort_key_digit(&src[0], digit)] == num_keys)
+            continue;
+
+        for (bucket = 0; bucket < UVM_FAULT_SORT_RADIX_SIZE; ++bucket) {
+            NvU32 count = histogram[bucket];
+
+            histogram[bucket] = offset;
+            offset += count;
+        }
+
+        for (i = 0; i < num_keys; ++i)
+            dst[histogram[fault_sort_key_digit(&src[i], digit)]++] = src[i];
+
+        swap(src, dst);
+    }
+
+    return src;
+}
+
+// Sort ordered_fault_cache using the keys previously stored in sort_keys
+static void fault_sort_keys(uvm_fault_service_batch_context_t *batch_context)
+{
+    NvU32 num_keys = batch_context->num_coalesced_faults;
+    uvm_fault_sort_key_t *keys = batch_context->sort_keys;
+    NvU32 num_descents = 0;
+    NvU32 i;
+
+    for (i = 1; i < num_keys; ++i) {
+        if (fault_sort_key_less(&keys[i], &keys[i - 1]))
+            ++num_descents;
+    }
+
+    // ordered_fault_cache is already in order
+    if (num_descents == 0)
+        return;
+
+    if (num_keys <= FAULT_SORT_INSERTION_MAX) {
+        fault_sort_keys_insertion(keys, num_keys, num_keys * num_keys);
+    }
+    else if (num_descents > num_keys / FAULT_SORT_INSERTION_MAX ||
+             !fault_sort_keys_insertion(keys, num_keys, num_keys * 4)) {
+        keys = fault_sort_keys_radix(batch_context, num_keys);
+    }
+
+    for (i = 0; i < num_keys; ++i)
+        batch_context->ordered_fault_cache[i] = keys[i].entry;
+}
+
+// Sort ordered_fault_cache by instance pointer. This produces the same order as
+// cmp_sort_fault_entry_by_instance_ptr.
+static void sort_fault_batch_by_instance_ptr(uvm_fault_service_batch_context_t *batch_context)
+{
+    NvU32 i;
+
+    for (i = 0; i < batch_context->num_coalesced_faults; ++i) {
+        uvm_fault_buffer_entry_t *entry = batch_context->ordered_fault_cache[i];
+        uvm_fault_sort_key_t *key = &batch_context->sort_keys[i];
+
+        // Instance blocks are 4K-aligned, which leaves room for the subcontext
+        // id in the low bits of the address. Fall back to the comparison sort
+        // if that is ever not the case.
+        if (unlikely(entry->instance_ptr.address & (UVM_PAGE_SIZE_4K - 1))) {
+            sort(batch_context->ordered_fault_cache,
+                 batch_context->num_coalesced_faults,
+                 sizeof(*batch_context->ordered_fault_cache),
+                 cmp_sort_fault_entry_by_instance_ptr,
+                 NULL);
+            return;
+        }
+
+        key->hi = entry->instance_ptr.aperture;
+        key->lo = entry->instance_ptr.address | entry->fault_source.ve_id;
+        key->entry = entry;
+    }
+
+    fault_sort_keys(batch_context);
+}
+
+// Sort ordered_fault_cache by va_space, GPU ID, fault address and access type.
+// This produces the same order as
+// cmp_sort_fault_entry_by_va_space_gpu_address_access_type.
+static void sort_fault_batch_by_va_space_gpu_address_access_type(uvm_fault_service_batch_context_t *batch_context)
+{
+    NvU32 i;
+
+    BUILD_BUG_ON(sizeof(uvm_fault_buffer_entry_t *) > sizeof(NvU64));
+    BUILD_BUG_ON(UVM_ID_MAX_PROCESSORS > (1 << FAULT_SORT_GPU_ID_BITS));
+    BUILD_BUG_ON(UVM_FAULT_ACCESS_TYPE_COUNT > (1 << FAULT_SORT_ACCESS_TYPE_BITS));
+    BUILD_BUG_ON(FAULT_SORT_GPU_ID_BITS + FAULT_SORT_ACCESS_TYPE_BITS > 12);
+
+    for (i = 0; i < batch_context->num_coalesced_faults; ++i) {
+        uvm_fault_buffer_entry_t *entry = batch_context->ordered_fault_cache[i];
+        uvm_fault_sort_key_t *key = &batch_context->sort_keys[i];
+        NvU64 gpu_id = entry->gpu ? uvm_id_value(entry->gpu->id) : 0;
+
+        UVM_ASSERT(IS_ALIGNED(entry->fault_address, UVM_PAGE_SIZE_4K));
+        UVM_ASSERT(entry->fault_access_type < UVM_FAULT_ACCESS_TYPE_COUNT);
+
+        key->hi = (NvU64)(NvUPtr)entry->va_space;
+
+        // Access types are sorted in descending order of intrusiveness, see
+        // cmp_access_type
+        key->lo = (gpu_id << (64 - FAULT_SORT_GPU_ID_BITS)) |
+                  ((entry->fault_address >> 12) << FAULT_SORT_ACCESS_TYPE_BITS) |
+                  (UVM_FAULT_ACCESS_TYPE_COUNT - 1 - entry->fault_access_type);
+        key->entry = entry;
+    }
+
+    fault_sort_keys(batch_context);
+}
+
 // Fault cache preprocessing for fault coalescing
 //
 // This function generates an ordered view of the given fault_cache in which
@@ -1139,13 +1518,8 @@ static NV_STATUS preprocess_fault_batch(uvm_parent_gpu_t *parent_gpu,
     UVM_ASSERT(j == batch_context->num_coalesced_faults);
 
     // 1) if the fault batch contains more than one, sort by instance_ptr
-    if (!batch_context->is_single_instance_ptr) {
-        sort(ordered_fault_cache,
-             batch_context->num_coalesced_faults,
-             sizeof(*ordered_fault_cache),
-             cmp_sort_fault_entry_by_instance_ptr,
-             NULL);
-    }
+    if (!batch_context->is_single_instance_ptr)
+        sort_fault_batch_by_instance_ptr(batch_context);
 
     // 2) translate all instance_ptrs to VA spaces
     status = translate_instance_ptrs(parent_gpu, batch_context);
@@ -1154,11 +1528,7 @@ static NV_STATUS preprocess_fault_batch(uvm_parent_gpu_t *parent_gpu,
 
     // 3) sort by va_space, GPU ID, fault address (GPU already reports
     // 4K-aligned address), and access type.
-    sort(ordered_fault_cache,
-         batch_context->num_coalesced_faults,
-         sizeof(*ordered_fault_cache),
-         cmp_sort_fault_entry_by_va_space_gpu_address_access_type,
-         NULL);
+    sort_fault_batch_by_va_space_gpu_address_access_type(batch_context);
 
     return NV_OK;
 }
@@ -1372,10 +1742,9 @@ static NV_STATUS service_fault_batch_block_locked(uvm_gpu_t *gpu,
     uvm_page_index_t last_page_index;
     NvU32 page_fault_count = 0;
     uvm_range_group_range_iter_t iter;
-    uvm_replayable_fault_buffer_info_t *replayable_faults = &gpu->parent->fault_buffer_info.replayable;
     uvm_fault_buffer_entry_t **ordered_fault_cache = batch_context->ordered_fault_cache;
     uvm_fault_buffer_entry_t *first_fault_entry = ordered_fault_cache[first_fault_index];
-    uvm_service_block_context_t *block_context = &replayable_faults->block_service_context;
+    uvm_service_block_context_t *block_context = batch_context->block_service_context;
     uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
     const uvm_va_policy_t *policy;
     NvU64 end;
@@ -1599,8 +1968,7 @@ static NV_STATUS service_fault_batch_block(uvm_gpu_t *gpu,
     NV_STATUS status;
     uvm_va_block_retry_t va_block_retry;
     NV_STATUS tracker_status;
-    uvm_replayable_fault_buffer_info_t *replayable_faults = &gpu->parent->fault_buffer_info.replayable;
-    uvm_service_block_context_t *fault_block_context = &replayable_faults->block_service_context;
+    uvm_service_block_context_t *fault_block_context = batch_context->block_service_context;
 
     fault_block_context->operation = UVM_SERVICE_OPERATION_REPLAYABLE_FAULTS;
     fault_block_context->num_retries = 0;
@@ -1608,7 +1976,17 @@ static NV_STATUS service_fault_batch_block(uvm_gpu_t *gpu,
     if (uvm_va_block_is_hmm(va_block))
         uvm_hmm_migrate_begin_wait(va_block);
 
-    uvm_mutex_lock(&va_block->lock);
+    // Faults from other GPUs, CPU faults and migrations on the same VA block
+    // serialize on its lock. Account for that contention in the fault stats.
+    if (!uvm_mutex_trylock(&va_block->lock)) {
+        uvm_replayable_fault_buffer_info_t *replayable_faults = &gpu->parent->fault_buffer_info.replayable;
+        NvU64 lock_start = NV_GETTIME();
+
+        uvm_mutex_lock(&va_block->lock);
+
+        atomic64_inc(&replayable_faults->stats.num_block_lock_contended);
+        atomic64_add(NV_GETTIME() - lock_start, &replayable_faults->stats.block_lock_wait_ns);
+    }
 
     status = UVM_VA_BLOCK_RETRY_LOCKED(va_block, &va_block_retry,
                                        service_fault_batch_block_locked(gpu,
@@ -1929,8 +2307,7 @@ static NV_STATUS service_fault_batch_dispatch(uvm_va_space_t *va_space,
     uvm_va_range_t *va_range_next = NULL;
     uvm_va_block_t *va_block;
     uvm_gpu_t *gpu = gpu_va_space->gpu;
-    uvm_va_block_context_t *va_block_context =
-        gpu->parent->fault_buffer_info.replayable.block_service_context.block_context;
+    uvm_va_block_context_t *va_block_context = batch_context->block_service_context->block_context;
     uvm_fault_buffer_entry_t *current_entry = batch_context->ordered_fault_cache[fault_index];
     struct mm_struct *mm = va_block_context->mm;
     NvU64 fault_address = current_entry->fault_address;
@@ -2021,8 +2398,7 @@ static NV_STATUS service_fault_batch_for_cancel(uvm_fault_service_batch_context_
     uvm_gpu_va_space_t *gpu_va_space = NULL;
     struct mm_struct *mm;
     uvm_replayable_fault_buffer_info_t *replayable_faults = &gpu->parent->fault_buffer_info.replayable;
-    uvm_service_block_context_t *service_context = &gpu->parent->fault_buffer_info.replayable.block_service_context;
-    uvm_va_block_context_t *va_block_context = service_context->block_context;
+    uvm_va_block_context_t *va_block_context = batch_context->block_service_context->block_context;
 
     UVM_ASSERT(va_space);
     UVM_ASSERT(gpu);
@@ -2196,34 +2572,43 @@ done:
     return status;
 }
 
-// Scan the ordered view of faults and group them by different va_blocks
-// (managed faults) and service faults for each va_block, in batch.
-// Service non-managed faults one at a time as they are encountered during the
-// scan.
+// Scan the faults of the VA space of the fault at first_fault_index in the
+// ordered view and group them by different va_blocks (managed faults) and
+// service faults for each va_block, in batch. Service non-managed faults one
+// at a time as they are encountered during the scan.
+//
+// On return, next_fault_index contains the index of the first fault that was
+// not serviced. If the call succeeded, this is the first fault of the next VA
+// space in the ordered view, or num_coalesced_faults.
 //
 // Fatal faults are marked for later processing by the caller.
-static NV_STATUS service_fault_batch(uvm_parent_gpu_t *parent_gpu,
-                                     fault_service_mode_t service_mode,
-                                     uvm_fault_service_batch_context_t *batch_context)
+static NV_STATUS service_fault_batch_va_space(uvm_parent_gpu_t *parent_gpu,
+                                              uvm_fault_service_batch_context_t *batch_context,
+                                              uvm_ats_fault_invalidate_t *ats_invalidate,
+                                              bool replay_per_va_block,
+                                              NvU32 first_fault_index,
+                                              NvU32 *next_fault_index)
 {
     NV_STATUS status = NV_OK;
-    NvU32 i;
-    uvm_va_space_t *va_space = NULL;
+    NvU32 i = first_fault_index;
+    uvm_va_space_t *va_space = batch_context->ordered_fault_cache[first_fault_index]->va_space;
     uvm_gpu_va_space_t *prev_gpu_va_space = NULL;
-    uvm_ats_fault_invalidate_t *ats_invalidate = &parent_gpu->fault_buffer_info.replayable.ats_invalidate;
-    struct mm_struct *mm = NULL;
-    const bool replay_per_va_block = service_mode != FAULT_SERVICE_MODE_CANCEL &&
-                                     parent_gpu->fault_buffer_info.replayable.replay_policy == UVM_PERF_FAULT_REPLAY_POLICY_BLOCK;
-    uvm_service_block_context_t *service_context =
-        &parent_gpu->fault_buffer_info.replayable.block_service_context;
-    uvm_va_block_context_t *va_block_context = service_context->block_context;
+    uvm_va_block_context_t *va_block_context = batch_context->block_service_context->block_context;
+    struct mm_struct *mm;
     bool hmm_migratable = true;
 
-    UVM_ASSERT(parent_gpu->replayable_faults_supported);
+    UVM_ASSERT(va_space);
 
-    ats_invalidate->tlb_batch_pending = false;
+    // If an mm is registered with the VA space, we have to retain it in order
+    // to lock it before locking the VA space. It is guaranteed to remain valid
+    // until we release. If no mm is registered, we can only service managed
+    // faults, not ATS/HMM faults.
+    mm = uvm_va_space_mm_retain_lock(va_space);
+    uvm_va_block_context_init(va_block_context, mm);
 
-    for (i = 0; i < batch_context->num_coalesced_faults;) {
+    uvm_va_space_down_read(va_space);
+
+    while (i < batch_context->num_coalesced_faults) {
         NvU32 block_faults;
         uvm_fault_buffer_entry_t *current_entry = batch_context->ordered_fault_cache[i];
         uvm_fault_utlb_info_t *utlb = &batch_context->utlbs[current_entry->fault_source.utlb_id];
@@ -2231,36 +2616,8 @@ static NV_STATUS service_fault_batch(uvm_parent_gpu_t *parent_gpu,
 
         UVM_ASSERT(current_entry->va_space);
 
-        if (current_entry->va_space != va_space) {
-            if (prev_gpu_va_space) {
-                // TLB entries are invalidated per GPU VA space
-                status = uvm_ats_invalidate_tlbs(prev_gpu_va_space, ats_invalidate, &batch_context->tracker);
-                if (status != NV_OK)
-                    goto fail;
-
-                prev_gpu_va_space = NULL;
-            }
-
-            // Fault on a different va_space, drop the lock of the old one...
-            if (va_space) {
-                uvm_va_space_up_read(va_space);
-                uvm_va_space_mm_release_unlock(va_space, mm);
-                mm = NULL;
-            }
-
-            va_space = current_entry->va_space;
-
-            // ... and take the lock of the new one
-
-            // If an mm is registered with the VA space, we have to retain it
-            // in order to lock it before locking the VA space. It is guaranteed
-            // to remain valid until we release. If no mm is registered, we
-            // can only service managed faults, not ATS/HMM faults.
-            mm = uvm_va_space_mm_retain_lock(va_space);
-            uvm_va_block_context_init(va_block_context, mm);
-
-            uvm_va_space_down_read(va_space);
-        }
+        if (current_entry->va_space != va_space)
+            break;
 
         // Some faults could be already fatal if they cannot be handled by
         // the UVM driver
@@ -2279,6 +2636,7 @@ static NV_STATUS service_fault_batch(uvm_parent_gpu_t *parent_gpu,
         gpu_va_space = uvm_gpu_va_space_get(va_space, current_entry->gpu);
 
         if (prev_gpu_va_space && prev_gpu_va_space != gpu_va_space) {
+            // TLB entries are invalidated per GPU VA space
             status = uvm_ats_invalidate_tlbs(prev_gpu_va_space, ats_invalidate, &batch_context->tracker);
             if (status != NV_OK)
                 goto fail;
@@ -2306,12 +2664,16 @@ static NV_STATUS service_fault_batch(uvm_parent_gpu_t *parent_gpu,
         if (status == NV_WARN_MORE_PROCESSING_REQUIRED || status == NV_WARN_MISMATCHED_TARGET) {
             if (status == NV_WARN_MISMATCHED_TARGET)
                 hmm_migratable = false;
+
+            // Drop the locks and retry from the same fault
             uvm_va_space_up_read(va_space);
             uvm_va_space_mm_release_unlock(va_space, mm);
-            mm = NULL;
-            va_space = NULL;
             prev_gpu_va_space = NULL;
             status = NV_OK;
+
+            mm = uvm_va_space_mm_retain_lock(va_space);
+            uvm_va_block_context_init(va_block_context, mm);
+            uvm_va_space_down_read(va_space);
             continue;
         }
 
@@ -2334,21 +2696,265 @@ static NV_STATUS service_fault_batch(uvm_parent_gpu_t *parent_gpu,
         }
     }
 
-    if (prev_gpu_va_space) {
-        NV_STATUS invalidate_status = uvm_ats_invalidate_tlbs(prev_gpu_va_space, ats_invalidate, &batch_context->tracker);
-        if (invalidate_status != NV_OK)
-            status = invalidate_status;
-    }
+    if (prev_gpu_va_space)
+        status = uvm_ats_invalidate_tlbs(prev_gpu_va_space, ats_invalidate, &batch_context->tracker);
 
 fail:
-    if (va_space) {
-        uvm_va_space_up_read(va_space);
-        uvm_va_space_mm_release_unlock(va_space, mm);
+    uvm_va_space_up_read(va_space);
+    uvm_va_space_mm_release_unlock(va_space, mm);
+
+    *next_fault_index = i;
+
+    return status;
+}
+
+// Returns the index of the first fault in the ordered view that belongs to a
+// different VA space than the fault at fault_index, or num_coalesced_faults if
+// there is none.
+static NvU32 next_va_space_fault_index(uvm_fault_service_batch_context_t *batch_context, NvU32 fault_index)
+{
+    uvm_va_space_t *va_space = batch_context->ordered_fault_cache[fault_index]->va_space;
+
+    while (fault_index < batch_context->num_coalesced_faults &&
+           batch_context->ordered_fault_cache[fault_index]->va_space == va_space)
+        ++fault_index;
+
+    return fault_index;
+}
+
+static NvU32 count_batch_va_spaces(uvm_fault_service_batch_context_t *batch_context)
+{
+    NvU32 i = 0;
+    NvU32 num_va_spaces = 0;
+
+    while (i < batch_context->num_coalesced_faults) {
+        i = next_va_space_fault_index(batch_context, i);
+        ++num_va_spaces;
+    }
+
+    return num_va_spaces;
+}
+
+static void service_fault_batch_worker(uvm_fault_service_worker_t *worker)
+{
+    NV_STATUS status = NV_OK;
+    uvm_parent_gpu_t *parent_gpu = worker->parent_gpu;
+    uvm_fault_service_batch_context_t *batch_context = &worker->batch_context;
+    NvU32 num_active = parent_gpu->fault_buffer_info.replayable.service_workers.num_active;
+    NvU32 va_space_index = 0;
+    NvU32 i = 0;
+
+    worker->ats_invalidate.tlb_batch_pending = false;
+
+    while (i < batch_context->num_coalesced_faults) {
+        NvU32 next_fault_index;
+
+        // VA spaces are distributed among the active workers in round-robin
+        // order
+        if ((va_space_index++ % num_active) != worker->index) {
+            i = next_va_space_fault_index(batch_context, i);
+            continue;
+        }
+
+        status = service_fault_batch_va_space(parent_gpu,
+                                              batch_context,
+                                              &worker->ats_invalidate,
+                                              false,
+                                              i,
+                                              &next_fault_index);
+        if (status != NV_OK)
+            break;
+
+        i = next_fault_index;
+    }
+
+    worker->status = status;
+
+    if (atomic_dec_and_test(&parent_gpu->fault_buffer_info.replayable.service_workers.pending))
+        complete(&parent_gpu->fault_buffer_info.replayable.service_workers.done);
+}
+
+static void service_fault_batch_worker_entry(void *args)
+{
+    UVM_ENTRY_VOID(service_fault_batch_worker((uvm_fault_service_worker_t *)args));
+}
+
+// Distribute the VA spaces in the batch among the fault service workers, and
+// wait for all of them to finish. The per-worker results are then merged into
+// the given batch context so that the caller can proceed as if the batch had
+// been serviced serially.
+static NV_STATUS service_fault_batch_parallel(uvm_parent_gpu_t *parent_gpu,
+                                              uvm_fault_service_batch_context_t *batch_context,
+                                              NvU32 num_va_spaces)
+{
+    NV_STATUS status = NV_OK;
+    NvU32 i;
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+    NvU32 num_active = min(num_va_spaces, replayable_faults->service_workers.count);
+
+    UVM_ASSERT(num_active > 1);
+
+    replayable_faults->service_workers.num_active = num_active;
+    atomic_set(&replayable_faults->service_workers.pending, num_active);
+    reinit_completion(&replayable_faults->service_workers.done);
+
+    for (i = 0; i < num_active; ++i) {
+        uvm_fault_service_worker_t *worker = &replayable_faults->service_workers.workers[i];
+        uvm_fault_service_batch_context_t *worker_context = &worker->batch_context;
+
+        UVM_ASSERT(uvm_tracker_is_empty(&worker_context->tracker));
+
+        worker_context->fault_cache                 = batch_context->fault_cache;
+        worker_context->ordered_fault_cache         = batch_context->ordered_fault_cache;
+        worker_context->utlbs                       = batch_context->utlbs;
+        worker_context->max_utlb_id                 = batch_context->max_utlb_id;
+        worker_context->num_cached_faults           = batch_context->num_cached_faults;
+        worker_context->num_coalesced_faults        = batch_context->num_coalesced_faults;
+        worker_context->batch_id                    = batch_context->batch_id;
+        worker_context->is_single_instance_ptr      = batch_context->is_single_instance_ptr;
+        worker_context->num_invalid_prefetch_faults = 0;
+        worker_context->num_duplicate_faults        = 0;
+        worker_context->num_replays                 = 0;
+        worker_context->fatal_va_space              = NULL;
+        worker_context->fatal_gpu                   = NULL;
+        worker_context->has_throttled_faults        = false;
+
+        worker->status = NV_OK;
+
+        nv_kthread_q_schedule_q_item(&worker->q, &worker->q_item);
+    }
+
+    wait_for_completion(&replayable_faults->service_workers.done);
+
+    for (i = 0; i < num_active; ++i) {
+        uvm_fault_service_worker_t *worker = &replayable_faults->service_workers.workers[i];
+        uvm_fault_service_batch_context_t *worker_context = &worker->batch_context;
+        NV_STATUS tracker_status;
+
+        batch_context->num_invalid_prefetch_faults += worker_context->num_invalid_prefetch_faults;
+        batch_context->num_duplicate_faults += worker_context->num_duplicate_faults;
+
+        if (worker_context->has_throttled_faults)
+            batch_context->has_throttled_faults = true;
+
+        if (!batch_context->fatal_va_space && worker_context->fatal_va_space) {
+            batch_context->fatal_va_space = worker_context->fatal_va_space;
+            batch_context->fatal_gpu = worker_context->fatal_gpu;
+        }
+
+        tracker_status = uvm_tracker_add_tracker_safe(&batch_context->tracker, &worker_context->tracker);
+        uvm_tracker_clear(&worker_context->tracker);
+
+        if (status == NV_OK)
+            status = worker->status != NV_OK? worker->status : tracker_status;
     }
 
     return status;
 }
 
+// Adjust the number of entries fetched in the next batch based on the service
+// time and the ratio of duplicates of the batch that was just serviced.
+static void update_adaptive_batch_count(uvm_parent_gpu_t *parent_gpu,
+                                        uvm_fault_service_batch_context_t *batch_context)
+{
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+    NvU32 batch_count = replayable_faults->adaptive_batch.batch_count;
+    NvU32 max_count = parent_gpu->fault_buffer_info.max_batch_size;
+    NvU32 min_count = min((NvU32)UVM_PERF_FAULT_BATCH_ADAPTIVE_MIN, max_count);
+    NvU64 target_ns = (NvU64)uvm_perf_fault_batch_target_usec * 1000;
+    NvU64 service_time_ns = NV_GETTIME() - batch_context->fetch_timestamp_ns;
+    NvU64 avg_service_time_ns = replayable_faults->adaptive_batch.avg_service_time_ns;
+    NvU32 new_count = batch_count;
+    NvU32 duplicate_ratio;
+
+    if (!replayable_faults->adaptive_batch.enabled || batch_context->num_cached_faults == 0)
+        return;
+
+    // Moving average with a 1/8 weight for the new sample
+    if (avg_service_time_ns == 0)
+        avg_service_time_ns = service_time_ns;
+    else
+        avg_service_time_ns = avg_service_time_ns - (avg_service_time_ns / 8) + (service_time_ns / 8);
+
+    replayable_faults->adaptive_batch.avg_service_time_ns = avg_service_time_ns;
+
+    duplicate_ratio = (batch_context->num_duplicate_faults * 100) / batch_context->num_cached_faults;
+
+    if (avg_service_time_ns > target_ns || duplicate_ratio > replayable_faults->replay_update_put_ratio) {
+        // Either batches take too long to service and replays get delayed, or
+        // a large fraction of each batch is spent on faults that would have
+        // gone away with an earlier replay.
+        new_count = max(batch_count / 2, min_count);
+    }
+    else if (avg_service_time_ns < target_ns / 2 && batch_context->num_cached_faults >= batch_count) {
+        // The batch was full, so more faults are likely pending, and there is
+        // room in the latency budget to service them in the same batch.
+        new_count = min(batch_count + max(batch_count / 4, 1u), max_count);
+    }
+
+    if (new_count != batch_count) {
+        NvU32 index = replayable_faults->adaptive_batch.history_count % UVM_FAULT_BATCH_COUNT_HISTORY_LENGTH;
+
+        replayable_faults->adaptive_batch.history[index].timestamp_ns = NV_GETTIME();
+        replayable_faults->adaptive_batch.history[index].batch_count = new_count;
+        replayable_faults->adaptive_batch.history[index].avg_service_time_ns = avg_service_time_ns;
+        replayable_faults->adaptive_batch.history[index].duplicate_ratio = duplicate_ratio;
+        ++replayable_faults->adaptive_batch.history_count;
+
+        replayable_faults->adaptive_batch.batch_count = new_count;
+    }
+}
+
+// Service all the faults in the ordered view of the batch, one VA space at a
+// time. If fault service workers are available, and the batch contains faults
+// from more than one VA space, the VA spaces are serviced in parallel.
+//
+// Fatal faults are marked for later processing by the caller.
+static NV_STATUS service_fault_batch(uvm_parent_gpu_t *parent_gpu,
+                                     fault_service_mode_t service_mode,
+                                     uvm_fault_service_batch_context_t *batch_context)
+{
+    NV_STATUS status = NV_OK;
+    NvU32 i = 0;
+    uvm_ats_fault_invalidate_t *ats_invalidate = &parent_gpu->fault_buffer_info.replayable.ats_invalidate;
+    const bool replay_per_va_block = service_mode != FAULT_SERVICE_MODE_CANCEL &&
+                                     parent_gpu->fault_buffer_info.replayable.replay_policy == UVM_PERF_FAULT_REPLAY_POLICY_BLOCK;
+
+    UVM_ASSERT(parent_gpu->replayable_faults_supported);
+
+    // Parallel servicing is only used in the regular path. The cancel path
+    // needs to see the faults in order.
+    if (service_mode == FAULT_SERVICE_MODE_REGULAR &&
+        parent_gpu->fault_buffer_info.replayable.service_workers.count > 0 &&
+        !batch_context->is_single_instance_ptr) {
+        NvU32 num_va_spaces = count_batch_va_spaces(batch_context);
+
+        if (num_va_spaces > 1) {
+            status = service_fault_batch_parallel(parent_gpu, batch_context, num_va_spaces);
+            goto done;
+        }
+    }
+
+    ats_invalidate->tlb_batch_pending = false;
+
+    while (i < batch_context->num_coalesced_faults) {
+        status = service_fault_batch_va_space(parent_gpu,
+                                              batch_context,
+                                              ats_invalidate,
+                                              replay_per_va_block,
+                                              i,
+                                              &i);
+        if (status != NV_OK)
+            break;
+    }
+
+done:
+    if (status == NV_OK && service_mode == FAULT_SERVICE_MODE_REGULAR)
+        update_adaptive_batch_count(parent_gpu, batch_context);
+
+    return status;
+}
+
 // Tells if the given fault entry is the first one in its uTLB
 static bool is_first_fault_in_utlb(uvm_fault_service_batch_context_t *batch_context, NvU32 fault_index)
 {
@@ -2860,7 +3466,8 @@ static void enable_disable_prefetch_faults(uvm_parent_gpu_t *parent_gpu,
     // fault reporting. If the logic changes, the tests will have to be changed.
     if (parent_gpu->fault_buffer_info.prefetch_faults_enabled &&
         uvm_perf_reenable_prefetch_faults_lapse_msec > 0 &&
-        ((batch_context->num_invalid_prefetch_faults * 3 > parent_gpu->fault_buffer_info.max_batch_size * 2) ||
+        ((batch_context->num_invalid_prefetch_faults * 3 >
+          parent_gpu->fault_buffer_info.replayable.adaptive_batch.batch_count * 2) ||
          (uvm_enable_builtin_tests &&
           parent_gpu->rm_info.isSimulated &&
           batch_context->num_invalid_prefetch_faults > 5))) {
@@ -2875,11 +3482,59 @@ static void enable_disable_prefetch_faults(uvm_parent_gpu_t *parent_gpu,
     }
 }
 
+// Record the time elapsed since start_ns in the given phase histogram of the
+// GPU. Returns the current time.
+static NvU64 record_fault_latency(uvm_parent_gpu_t *parent_gpu, UvmFaultLatencyPhase phase, NvU64 start_ns)
+{
+    uvm_fault_latency_histogram_t __percpu *histogram = parent_gpu->fault_buffer_info.replayable.latency_histogram;
+    NvU64 now = NV_GETTIME();
+    NvU64 latency_ns = now - start_ns;
+    NvU32 bucket = 0;
+
+    if (latency_ns > 0)
+        bucket = min((NvU32)ilog2(latency_ns), (NvU32)UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS - 1);
+
+    this_cpu_inc(histogram->counts[phase][bucket]);
+
+    return now;
+}
+
+void uvm_parent_gpu_fault_latency_histogram(uvm_parent_gpu_t *parent_gpu,
+                                            NvU64 histogram[UvmFaultLatencyPhaseCount]
+                                                           [UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS])
+{
+    uvm_fault_latency_histogram_t __percpu *latency_histogram;
+    int cpu;
+
+    memset(histogram, 0, sizeof(NvU64) * UvmFaultLatencyPhaseCount * UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS);
+
+    if (!parent_gpu->replayable_faults_supported)
+        return;
+
+    latency_histogram = parent_gpu->fault_buffer_info.replayable.latency_histogram;
+    if (!latency_histogram)
+        return;
+
+    // The per-CPU counts are read without synchronization, so the sum may miss
+    // batches that are being recorded concurrently.
+    for_each_possible_cpu(cpu) {
+        const uvm_fault_latency_histogram_t *cpu_histogram = per_cpu_ptr(latency_histogram, cpu);
+        NvU32 phase;
+        NvU32 bucket;
+
+        for (phase = 0; phase < UvmFaultLatencyPhaseCount; ++phase) {
+            for (bucket = 0; bucket < UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS; ++bucket)
+                histogram[phase][bucket] += READ_ONCE(cpu_histogram->counts[phase][bucket]);
+        }
+    }
+}
+
 void uvm_parent_gpu_service_replayable_faults(uvm_parent_gpu_t *parent_gpu)
 {
     NvU32 num_replays = 0;
     NvU32 num_batches = 0;
     NvU32 num_throttled = 0;
+    NvU64 phase_end;
     NV_STATUS status = NV_OK;
     uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
     uvm_fault_service_batch_context_t *batch_context = &replayable_faults->batch_service_context;
@@ -2909,10 +3564,14 @@ void uvm_parent_gpu_service_replayable_faults(uvm_parent_gpu_t *parent_gpu)
         if (batch_context->num_cached_faults == 0)
             break;
 
+        phase_end = record_fault_latency(parent_gpu, UvmFaultLatencyPhaseFetch, batch_context->fetch_timestamp_ns);
+
         ++batch_context->batch_id;
 
         status = preprocess_fault_batch(parent_gpu, batch_context);
 
+        phase_end = record_fault_latency(parent_gpu, UvmFaultLatencyPhasePreprocess, phase_end);
+
         num_replays += batch_context->num_replays;
 
         if (status == NV_WARN_MORE_PROCESSING_REQUIRED)
@@ -2922,6 +3581,8 @@ void uvm_parent_gpu_service_replayable_faults(uvm_parent_gpu_t *parent_gpu)
 
         status = service_fault_batch(parent_gpu, FAULT_SERVICE_MODE_REGULAR, batch_context);
 
+        record_fault_latency(parent_gpu, UvmFaultLatencyPhaseService, phase_end);
+
         // We may have issued replays even if status != NV_OK if
         // UVM_PERF_FAULT_REPLAY_POLICY_BLOCK is being used or the fault buffer
         // was flushed
@@ -2955,11 +3616,14 @@ void uvm_parent_gpu_service_replayable_faults(uvm_parent_gpu_t *parent_gpu)
             break;
         }
 
+        phase_end = NV_GETTIME();
+
         if (replayable_faults->replay_policy == UVM_PERF_FAULT_REPLAY_POLICY_BATCH) {
             status = push_replay_on_parent_gpu(parent_gpu, UVM_FAULT_REPLAY_TYPE_START, batch_context);
             if (status != NV_OK)
                 break;
             ++num_replays;
+            record_fault_latency(parent_gpu, UvmFaultLatencyPhaseReplay, phase_end);
         }
         else if (replayable_faults->replay_policy == UVM_PERF_FAULT_REPLAY_POLICY_BATCH_FLUSH) {
             uvm_gpu_buffer_flush_mode_t flush_mode = UVM_GPU_BUFFER_FLUSH_MODE_CACHED_PUT;
@@ -2976,6 +3640,7 @@ void uvm_parent_gpu_service_replayable_faults(uvm_parent_gpu_t *parent_gpu)
             status = uvm_tracker_wait(&replayable_faults->replay_tracker);
             if (status != NV_OK)
                 break;
+            record_fault_latency(parent_gpu, UvmFaultLatencyPhaseReplay, phase_end);
         }
 
         if (batch_context->has_throttled_faults)
@@ -3088,3 +3753,135 @@ NV_STATUS uvm_test_drain_replayable_faults(UVM_TEST_DRAIN_REPLAYABLE_FAULTS_PARA
 
     return status;
 }
+
+static NV_STATUS fault_sort_perf_iteration(UVM_TEST_FAULT_SORT_PERF_PARAMS *params,
+                                           uvm_fault_service_batch_context_t *batch_context,
+                                           uvm_fault_buffer_entry_t **comparison_cache,
+                                           NvU8 *va_space_tags,
+                                           uvm_test_rng_t *rng)
+{
+    NV_STATUS status = NV_OK;
+    NvU32 num_faults = params->num_faults;
+    NvU32 num_swaps = (NvU32)(((NvU64)num_faults * params->disorder_percent) / 100);
+    NvU64 start;
+    NvU32 i;
+
+    // Generate a batch ordered by instance pointer, VA space and address
+    for (i = 0; i < num_faults; ++i) {
+        uvm_fault_buffer_entry_t *entry = &batch_context->fault_cache[i];
+        NvU32 va_space_index = (NvU32)(((NvU64)i * params->num_va_spaces) / num_faults);
+
+        memset(entry, 0, sizeof(*entry));
+
+        entry->instance_ptr = uvm_gpu_phys_address(UVM_APERTURE_VID, (NvU64)(va_space_index + 1) * UVM_PAGE_SIZE_4K);
+        entry->fault_address = (NvU64)i * UVM_PAGE_SIZE_4K;
+        entry->fault_access_type = uvm_test_rng_range_32(rng, 0, UVM_FAULT_ACCESS_TYPE_COUNT - 1);
+
+        // The VA space pointers are only used as sort keys, they are never
+        // dereferenced
+        entry->va_space = (uvm_va_space_t *)&va_space_tags[va_space_index];
+
+        batch_context->ordered_fault_cache[i] = entry;
+    }
+
+    for (i = 0; i < num_swaps; ++i) {
+        NvU32 a = uvm_test_rng_range_32(rng, 0, num_faults - 1);
+        NvU32 b = uvm_test_rng_range_32(rng, 0, num_faults - 1);
+
+        swap(batch_context->ordered_fault_cache[a], batch_context->ordered_fault_cache[b]);
+    }
+
+    memcpy(comparison_cache, batch_context->ordered_fault_cache, num_faults * sizeof(*comparison_cache));
+
+    batch_context->num_coalesced_faults = num_faults;
+
+    start = NV_GETTIME();
+    sort_fault_batch_by_instance_ptr(batch_context);
+    sort_fault_batch_by_va_space_gpu_address_access_type(batch_context);
+    params->radix_sort_ns += NV_GETTIME() - start;
+
+    start = NV_GETTIME();
+    sort(comparison_cache,
+         num_faults,
+         sizeof(*comparison_cache),
+         cmp_sort_fault_entry_by_instance_ptr,
+         NULL);
+    sort(comparison_cache,
+         num_faults,
+         sizeof(*comparison_cache),
+         cmp_sort_fault_entry_by_va_space_gpu_address_access_type,
+         NULL);
+    params->comparison_sort_ns += NV_GETTIME() - start;
+
+    for (i = 0; i < num_faults; ++i) {
+        uvm_fault_buffer_entry_t **ordered_fault_cache = batch_context->ordered_fault_cache;
+
+        TEST_CHECK_GOTO(cmp_sort_fault_entry_by_va_space_gpu_address_access_type(&ordered_fault_cache[i],
+                                                                                 &comparison_cache[i]) == 0,
+                        done);
+    }
+
+done:
+    return status;
+}
+
+NV_STATUS uvm_test_fault_sort_perf(UVM_TEST_FAULT_SORT_PERF_PARAMS *params, struct file *filp)
+{
+    NV_STATUS status = NV_OK;
+    uvm_fault_service_batch_context_t *batch_context;
+    uvm_fault_buffer_entry_t **comparison_cache = NULL;
+    NvU8 *va_space_tags = NULL;
+    uvm_test_rng_t rng;
+    NvU32 i;
+
+    if (params->iterations == 0 ||
+        params->num_faults == 0 ||
+        params->num_faults > UVM_TEST_FAULT_SORT_PERF_MAX_FAULTS ||
+        params->num_va_spaces == 0 ||
+        params->num_va_spaces > params->num_faults ||
+        params->disorder_percent > 100)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    batch_context = uvm_kvmalloc_zero(sizeof(*batch_context));
+    if (!batch_context)
+        return NV_ERR_NO_MEMORY;
+
+    batch_context->fault_cache = uvm_kvmalloc(params->num_faults * sizeof(*batch_context->fault_cache));
+    batch_context->ordered_fault_cache = uvm_kvmalloc(params->num_faults *
+                                                      sizeof(*batch_context->ordered_fault_cache));
+    comparison_cache = uvm_kvmalloc(params->num_faults * sizeof(*comparison_cache));
+    va_space_tags = uvm_kvmalloc(params->num_va_spaces * sizeof(*va_space_tags));
+    if (!batch_context->fault_cache || !batch_context->ordered_fault_cache || !comparison_cache || !va_space_tags) {
+        status = NV_ERR_NO_MEMORY;
+        goto done;
+    }
+
+    status = fault_batch_sort_init(batch_context, params->num_faults, NUMA_NO_NODE);
+    if (status != NV_OK)
+        goto done;
+
+    uvm_test_rng_init(&rng, params->seed);
+
+    params->radix_sort_ns = 0;
+    params->comparison_sort_ns = 0;
+
+    for (i = 0; i < params->iterations; ++i) {
+        status = fault_sort_perf_iteration(params, batch_context, comparison_cache, va_space_tags, &rng);
+        if (status != NV_OK)
+            goto done;
+    }
+
+    // Report average iteration times
+    params->radix_sort_ns /= params->iterations;
+    params->comparison_sort_ns /= params->iterations;
+
+done:
+    fault_batch_sort_deinit(batch_context);
+    uvm_kvfree(va_space_tags);
+    uvm_kvfree(comparison_cache);
+    uvm_kvfree(batch_context->ordered_fault_cache);
+    uvm_kvfree(batch_context->fault_cache);
+    uvm_kvfree(batch_context);
+
+    return status;
+}
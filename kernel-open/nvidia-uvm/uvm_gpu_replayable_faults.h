@@ -74,4 +74,11 @@ void uvm_parent_gpu_disable_prefetch_faults(uvm_parent_gpu_t *parent_gpu);
 // Service pending replayable faults on the given GPU. This function must be
 // only called from the ISR bottom half
 void uvm_parent_gpu_service_replayable_faults(uvm_parent_gpu_t *parent_gpu);
+
+// Sum the per-CPU fault servicing latency histograms of the given GPU into
+// histogram. All the counts are 0 if the GPU does not support replayable
+// faults.
+void uvm_parent_gpu_fault_latency_histogram(uvm_parent_gpu_t *parent_gpu,
+                                            NvU64 histogram[UvmFaultLatencyPhaseCount]
+                                                           [UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS]);
 #endif // __UVM_GPU_PAGE_FAULT_H__
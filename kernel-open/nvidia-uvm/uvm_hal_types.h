@@ -437,6 +437,10 @@ struct uvm_fault_buffer_entry_struct
         struct
         {
             NvU32                         buffer_index;
+
+            // Fault service worker the fault is assigned to, if faults are
+            // serviced in parallel
+            NvU32                         worker_index;
         } non_replayable;
     };
 
@@ -417,7 +417,7 @@ static bool hmm_invalidate(uvm_va_block_t *va_block,
          range->owner == &g_uvm_global))
         return true;
 
-    va_block_context = uvm_va_block_context_alloc(mm);
+    va_block_context = uvm_thread_context_block_context_get(mm);
     if (!va_block_context)
         return true;
 
@@ -479,7 +479,7 @@ static bool hmm_invalidate(uvm_va_block_t *va_block,
 unlock:
     uvm_mutex_unlock(&va_block->lock);
 
-    uvm_va_block_context_free(va_block_context);
+    uvm_thread_context_block_context_put(va_block_context);
 
     UVM_ASSERT(status == NV_OK);
     return true;
@@ -2883,6 +2883,25 @@ static NV_STATUS uvm_hmm_gpu_fault_finalize_and_map(uvm_hmm_gpu_fault_event_t *u
     return status == NV_OK ? tracker_status : status;
 }
 
+// Return the replayable fault state of the GPU to which HMM GPU fault servicing
+// time is accounted, or NULL if the servicing is not for a replayable fault.
+static uvm_replayable_fault_buffer_info_t *hmm_replayable_faults(uvm_processor_id_t processor_id,
+                                                                 uvm_service_block_context_t *service_context)
+{
+    if (!UVM_ID_IS_GPU(processor_id) || service_context->operation != UVM_SERVICE_OPERATION_REPLAYABLE_FAULTS)
+        return NULL;
+
+    return &uvm_gpu_get(processor_id)->parent->fault_buffer_info.replayable;
+}
+
+static void hmm_account_time(atomic64_t *stat, NvU64 *start)
+{
+    NvU64 now = NV_GETTIME();
+
+    atomic64_add(now - *start, stat);
+    *start = now;
+}
+
 NV_STATUS uvm_hmm_va_block_service_locked(uvm_processor_id_t processor_id,
                                           uvm_processor_id_t new_residency,
                                           uvm_va_block_t *va_block,
@@ -2894,6 +2913,8 @@ NV_STATUS uvm_hmm_va_block_service_locked(uvm_processor_id_t processor_id,
     uvm_va_block_region_t region = service_context->region;
     uvm_hmm_gpu_fault_event_t uvm_hmm_gpu_fault_event;
     struct migrate_vma *args = &service_context->block_context->hmm.migrate_vma_args;
+    uvm_replayable_fault_buffer_info_t *replayable_faults;
+    NvU64 start = 0;
     int ret;
     NV_STATUS status = NV_ERR_INVALID_ADDRESS;
 
@@ -2925,9 +2946,18 @@ NV_STATUS uvm_hmm_va_block_service_locked(uvm_processor_id_t processor_id,
     args->pgmap_owner = &g_uvm_global;
     args->fault_page = NULL;
 
+    replayable_faults = hmm_replayable_faults(processor_id, service_context);
+    if (replayable_faults) {
+        atomic64_inc(&replayable_faults->stats.hmm.num_blocks);
+        start = NV_GETTIME();
+    }
+
     ret = migrate_vma_setup_locked(args, va_block);
     UVM_ASSERT(!ret);
 
+    if (replayable_faults)
+        hmm_account_time(&replayable_faults->stats.hmm.migrate_setup_ns, &start);
+
     // The overall process here is to migrate pages from the CPU or GPUs to the
     // faulting GPU.
     // This is safe because we hold the va_block lock across the calls to
@@ -2943,8 +2973,12 @@ NV_STATUS uvm_hmm_va_block_service_locked(uvm_processor_id_t processor_id,
     // tables. TODO: Bug 3901904: there might be better ways of handling no
     // page being migrated.
     status = uvm_hmm_gpu_fault_alloc_and_copy(vma, &uvm_hmm_gpu_fault_event);
+    if (replayable_faults)
+        hmm_account_time(&replayable_faults->stats.hmm.copy_ns, &start);
     if (status == NV_WARN_MORE_PROCESSING_REQUIRED) {
         migrate_vma_finalize(args);
+        if (replayable_faults)
+            hmm_account_time(&replayable_faults->stats.hmm.finalize_ns, &start);
 
         // migrate_vma_setup() might have not been able to lock/isolate any
         // pages because they are swapped out or are device exclusive.
@@ -2957,6 +2991,11 @@ NV_STATUS uvm_hmm_va_block_service_locked(uvm_processor_id_t processor_id,
                                        region,
                                        service_context->access_type,
                                        NULL);
+        if (replayable_faults) {
+            atomic64_inc(&replayable_faults->stats.hmm.num_cpu_fault_retries);
+            hmm_account_time(&replayable_faults->stats.hmm.cpu_fault_ns, &start);
+        }
+
         return NV_WARN_MORE_PROCESSING_REQUIRED;
     }
 
@@ -2966,6 +3005,8 @@ NV_STATUS uvm_hmm_va_block_service_locked(uvm_processor_id_t processor_id,
     }
 
     migrate_vma_finalize(args);
+    if (replayable_faults)
+        hmm_account_time(&replayable_faults->stats.hmm.finalize_ns, &start);
 
     if (status == NV_WARN_NOTHING_TO_DO)
         status = NV_OK;
@@ -761,10 +761,24 @@ typedef struct
 // The UVM driver must have builtin tests enabled for the API to use this flag.
 #define UVM_MIGRATE_FLAG_NO_GPU_VA_SPACE    0x00000004
 
+// If UVM_MIGRATE_FLAG_DEFERRED is 1, the ioctl only validates the arguments
+// and queues the migration, which is then performed by a driver thread in the
+// order it was queued with the other deferred migrations of the VA space. The
+// flag requires UVM_MIGRATE_FLAG_ASYNC, a non-zero semaphoreAddress and a
+// non-zero length covering only managed allocations.
+//
+// The VA space is not locked for the whole migration, so changes done to the
+// range while the migration is in progress (e.g. freeing parts of it) stop
+// the migration early. Errors hit after the ioctl returns are not reported:
+// semaphorePayload is written to semaphoreAddress once the work is done
+// regardless, unless the semaphore pool itself no longer exists.
+#define UVM_MIGRATE_FLAG_DEFERRED           0x00000008
+
 #define UVM_MIGRATE_FLAGS_TEST_ALL              (UVM_MIGRATE_FLAG_SKIP_CPU_MAP      | \
                                                  UVM_MIGRATE_FLAG_NO_GPU_VA_SPACE)
 
-#define UVM_MIGRATE_FLAGS_ALL                   (UVM_MIGRATE_FLAG_ASYNC | \
+#define UVM_MIGRATE_FLAGS_ALL                   (UVM_MIGRATE_FLAG_ASYNC    | \
+                                                 UVM_MIGRATE_FLAG_DEFERRED | \
                                                  UVM_MIGRATE_FLAGS_TEST_ALL)
 
 // If NV_ERR_INVALID_ARGUMENT is returned it is because cpuMemoryNode is not
@@ -1097,6 +1111,185 @@ typedef struct
     NV_STATUS               rmStatus; // OUT
 } UVM_MM_INITIALIZE_PARAMS;
 
+//
+// UvmToolsGetFaultLatencyHistogram
+//
+// Returns the replayable fault servicing latency histograms of the given GPU,
+// accumulated since the GPU was registered with UVM. See UvmFaultLatencyPhase.
+// The GPU must be registered in the VA space.
+//
+#define UVM_TOOLS_GET_FAULT_LATENCY_HISTOGRAM                         UVM_IOCTL_BASE(76)
+typedef struct
+{
+    NvProcessorUuid         gpuUuid;                                                    // IN
+    NvU64                   histogram[UvmFaultLatencyPhaseCount]
+                                     [UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS] NV_ALIGN_BYTES(8); // OUT
+    NV_STATUS               rmStatus;                                                   // OUT
+} UVM_TOOLS_GET_FAULT_LATENCY_HISTOGRAM_PARAMS;
+
+//
+// UvmMigrateBatch
+//
+// Migrate a batch of ranges, each one to its own destination, with a single
+// call. The ranges are migrated in order, as if by UVM_MIGRATE with the same
+// flags, but they share the locking and the tracking of the copies, so the
+// migrations of a batch are pipelined with each other.
+//
+// flags accepts the same flags as UVM_MIGRATE except for
+// UVM_MIGRATE_FLAG_DEFERRED, and semaphoreAddress and semaphorePayload follow
+// the same rules. The semaphore is released once all the ranges are migrated.
+//
+// Unlike UVM_MIGRATE, ranges of pageable memory that may need to be migrated
+// by user-space are not supported and fail the batch with
+// NV_ERR_INVALID_ADDRESS.
+//
+// The batch stops at the first range that fails. numMigratedRanges returns
+// the number of ranges migrated before that.
+//
+#define UVM_MIGRATE_BATCH_MAX_RANGES                                  256
+
+typedef struct
+{
+    NvU64           base               NV_ALIGN_BYTES(8); // IN
+    NvU64           length             NV_ALIGN_BYTES(8); // IN
+    NvProcessorUuid destinationUuid;                      // IN
+    NvS32           cpuNumaNode;                          // IN
+} UVM_MIGRATE_BATCH_RANGE;
+
+#define UVM_MIGRATE_BATCH                                             UVM_IOCTL_BASE(77)
+typedef struct
+{
+    UVM_MIGRATE_BATCH_RANGE ranges[UVM_MIGRATE_BATCH_MAX_RANGES];          // IN
+    NvU32                   numRanges;                                     // IN
+    NvU32                   flags;                                         // IN
+    NvU64                   semaphoreAddress             NV_ALIGN_BYTES(8); // IN
+    NvU32                   semaphorePayload;                              // IN
+    NvU32                   numMigratedRanges;                             // OUT
+    NV_STATUS               rmStatus;                                      // OUT
+} UVM_MIGRATE_BATCH_PARAMS;
+
+//
+// UvmSetThrashingPolicy
+//
+// Override the thrashing mitigation parameters of the VA space on the managed
+// allocations within [requestedBase, requestedBase + length). Fields set to 0
+// keep the VA space value, so a call with all fields and flags set to 0
+// restores the VA space parameters on the range. Any thrashing tracking state
+// of the range is discarded, and pages pinned due to thrashing are unpinned.
+//
+// threshold is the number of consecutive thrashing events that trigger
+// thrashing mitigation, and must not exceed 7. pinThreshold is the number of
+// throttling periods after which a page is pinned, and must not exceed 255.
+// lapseUsec is the time within which consecutive events are considered
+// thrashing, napUsec the time for which a processor is throttled and pinUsec
+// the time after which a pinned page is unpinned.
+//
+// If UVM_THRASHING_POLICY_FLAG_DISABLE is set, thrashing mitigation is
+// disabled on the range and the rest of fields are ignored.
+//
+// If UVM_THRASHING_POLICY_FLAG_COST_MODEL is set, a page that would otherwise
+// keep being throttled is pinned on its current residency and mapped remotely
+// by the faulting processor as soon as the link between them makes remote
+// accesses cheaper than migrating the page back and forth.
+//
+// The range must be fully covered by managed allocations. Ranges of pageable
+// memory accessed through ATS are ignored, and HMM ranges fail with
+// NV_ERR_NOT_SUPPORTED.
+//
+// Error codes:
+//     NV_ERR_INVALID_ADDRESS:
+//         requestedBase and length are not page-aligned, length is 0, or the
+//         range is not fully covered by managed allocations.
+//
+//     NV_ERR_INVALID_ARGUMENT:
+//         Unknown flags, or threshold or pinThreshold are out of bounds.
+//
+//     NV_ERR_INVALID_STATE:
+//         Thrashing mitigation is disabled on the VA space.
+//
+#define UVM_THRASHING_POLICY_FLAG_DISABLE                             0x00000001
+#define UVM_THRASHING_POLICY_FLAG_COST_MODEL                          0x00000002
+#define UVM_THRASHING_POLICY_FLAGS_ALL                                (UVM_THRASHING_POLICY_FLAG_DISABLE | \
+                                                                       UVM_THRASHING_POLICY_FLAG_COST_MODEL)
+
+#define UVM_SET_THRASHING_POLICY                                      UVM_IOCTL_BASE(78)
+typedef struct
+{
+    NvU64           requestedBase NV_ALIGN_BYTES(8); // IN
+    NvU64           length        NV_ALIGN_BYTES(8); // IN
+    NvU32           flags;                           // IN
+    NvU32           threshold;                       // IN
+    NvU32           pinThreshold;                    // IN
+    NvU32           lapseUsec;                       // IN
+    NvU32           napUsec;                         // IN
+    NvU32           pinUsec;                         // IN
+    NV_STATUS       rmStatus;                        // OUT
+} UVM_SET_THRASHING_POLICY_PARAMS;
+
+//
+// UvmSetGpuResidentReservation
+//
+// Reserve the GPU memory backing the managed allocations within
+// [requestedBase, requestedBase + length) on the GPU with the given UUID. Pages
+// of the range resident on that GPU are not evicted to make room for other
+// allocations, and the root chunks backing them are not handed back to RM
+// through PMA eviction. The reservation does not migrate any data: it only
+// protects the pages that become resident on the GPU, either before or after
+// the call. A range can only be reserved on one GPU at a time, and setting a
+// reservation on a range already reserved on a different GPU moves the
+// reservation.
+//
+// The length of the reserved ranges is accounted against a per GPU quota,
+// which is a percentage of the GPU memory set by the
+// uvm_gpu_resident_reservation_percent module parameter.
+//
+// The reservation is dropped when the range is destroyed or when the GPU is
+// unregistered from the VA space.
+//
+// The range must be fully covered by managed allocations. Ranges of pageable
+// memory accessed through ATS are ignored, and HMM ranges fail with
+// NV_ERR_NOT_SUPPORTED.
+//
+// Error codes:
+//     NV_ERR_INVALID_ADDRESS:
+//         requestedBase and length are not page-aligned, length is 0, or the
+//         range is not fully covered by managed allocations.
+//
+//     NV_ERR_INVALID_DEVICE:
+//         The GPU is not registered in the VA space.
+//
+//     NV_ERR_INSUFFICIENT_RESOURCES:
+//         The reservation would exceed the quota of the GPU.
+//
+#define UVM_SET_GPU_RESIDENT_RESERVATION                              UVM_IOCTL_BASE(79)
+typedef struct
+{
+    NvU64           requestedBase NV_ALIGN_BYTES(8); // IN
+    NvU64           length        NV_ALIGN_BYTES(8); // IN
+    NvProcessorUuid gpuUuid;                         // IN
+    NV_STATUS       rmStatus;                        // OUT
+} UVM_SET_GPU_RESIDENT_RESERVATION_PARAMS;
+
+//
+// UvmUnsetGpuResidentReservation
+//
+// Drop the GPU resident reservation of the managed allocations within
+// [requestedBase, requestedBase + length), if any. Pages resident on the GPU
+// become evictable again.
+//
+// Error codes:
+//     NV_ERR_INVALID_ADDRESS:
+//         requestedBase and length are not page-aligned, length is 0, or the
+//         range is not fully covered by managed allocations.
+//
+#define UVM_UNSET_GPU_RESIDENT_RESERVATION                            UVM_IOCTL_BASE(80)
+typedef struct
+{
+    NvU64           requestedBase NV_ALIGN_BYTES(8); // IN
+    NvU64           length        NV_ALIGN_BYTES(8); // IN
+    NV_STATUS       rmStatus;                        // OUT
+} UVM_UNSET_GPU_RESIDENT_RESERVATION_PARAMS;
+
 //
 // Temporary ioctls which should be removed before UVM 8 release
 // Number backwards from 2047 - highest custom ioctl function number
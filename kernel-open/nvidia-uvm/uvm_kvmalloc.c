@@ -23,8 +23,10 @@
 
 #include "uvm_common.h"
 #include "uvm_linux.h"
+#include "uvm_api.h"
 #include "uvm_global.h"
 #include "uvm_kvmalloc.h"
+#include "uvm_procfs.h"
 #include "uvm_rb_tree.h"
 
 // To implement realloc for vmalloc-based allocations we need to track the size
@@ -90,8 +92,58 @@ MODULE_PARM_DESC(uvm_leak_checker,
                  "Enable uvm memory leak checking. "
                  "0 = disabled, 1 = count total bytes allocated and freed, 2 = per-allocation origin tracking.");
 
+typedef struct
+{
+    // Free objects, already constructed
+    void *objects[UVM_OBJECT_CACHE_MAX_PER_CPU_OBJECTS];
+    NvU32 count;
+
+    // Allocations served from, and missing, the stash
+    NvU64 hits;
+    NvU64 misses;
+} uvm_object_cache_cpu_t;
+
+struct uvm_object_cache_struct
+{
+    const char *name;
+
+    size_t size;
+
+    // NULL for objects larger than UVM_KMALLOC_THRESHOLD, which are allocated
+    // with uvm_kvmalloc() instead.
+    struct kmem_cache *kmem_cache;
+
+    uvm_object_cache_ctor_t ctor;
+    uvm_object_cache_dtor_t dtor;
+
+    NvU32 per_cpu_objects;
+
+    uvm_object_cache_cpu_t __percpu *cpu_caches;
+
+    // Number of objects allocated and not yet freed by the users of the cache
+    atomic_long_t outstanding;
+
+    // Node in g_uvm_object_caches.list
+    struct list_head list_node;
+};
+
+static struct
+{
+    // Protects list. Use a raw spinlock for the same reasons as the leak
+    // checker.
+    spinlock_t lock;
+
+    // List of all the object caches, for procfs reporting
+    struct list_head list;
+
+    struct proc_dir_entry *procfs_file;
+} g_uvm_object_caches;
+
 NV_STATUS uvm_kvmalloc_init(void)
 {
+    spin_lock_init(&g_uvm_object_caches.lock);
+    INIT_LIST_HEAD(&g_uvm_object_caches.list);
+
     if (uvm_leak_checker >= UVM_KVMALLOC_LEAK_CHECK_ORIGIN) {
         spin_lock_init(&g_uvm_leak_checker.lock);
         uvm_rb_tree_init(&g_uvm_leak_checker.allocation_info);
@@ -110,6 +162,8 @@ void uvm_kvmalloc_exit(void)
     if (!g_malloc_initialized)
         return;
 
+    UVM_ASSERT(list_empty(&g_uvm_object_caches.list));
+
     if (atomic_long_read(&g_uvm_leak_checker.bytes_allocated) > 0) {
         printk(KERN_ERR NVIDIA_UVM_PRETTY_PRINTING_PREFIX "!!!!!!!!!!!!!!!!!!!!!!!!!!!!\n");
         printk(KERN_ERR NVIDIA_UVM_PRETTY_PRINTING_PREFIX "Memory leak of %lu bytes detected.%s\n",
@@ -246,7 +300,7 @@ static uvm_vmalloc_hdr_t *get_hdr(void *p)
     return hdr;
 }
 
-static void *alloc_internal(size_t size, bool zero_memory)
+static void *alloc_internal(size_t size, int node, bool zero_memory)
 {
     uvm_vmalloc_hdr_t *hdr;
 
@@ -259,14 +313,14 @@ static void *alloc_internal(size_t size, bool zero_memory)
 
     if (size <= UVM_KMALLOC_THRESHOLD) {
         if (zero_memory)
-            return kzalloc(size, NV_UVM_GFP_FLAGS);
-        return kmalloc(size, NV_UVM_GFP_FLAGS);
+            return kzalloc_node(size, NV_UVM_GFP_FLAGS, node);
+        return kmalloc_node(size, NV_UVM_GFP_FLAGS, node);
     }
 
     if (zero_memory)
-        hdr = vzalloc(sizeof(*hdr) + size);
+        hdr = vzalloc_node(sizeof(*hdr) + size, node);
     else
-        hdr = vmalloc(sizeof(*hdr) + size);
+        hdr = vmalloc_node(sizeof(*hdr) + size, node);
 
     if (!hdr)
         return NULL;
@@ -277,7 +331,7 @@ static void *alloc_internal(size_t size, bool zero_memory)
 
 void *__uvm_kvmalloc(size_t size, const char *file, int line, const char *function)
 {
-    void *p = alloc_internal(size, false);
+    void *p = alloc_internal(size, NUMA_NO_NODE, false);
 
     if (uvm_leak_checker && p)
         alloc_tracking_add(p, file, line, function);
@@ -287,7 +341,27 @@ void *__uvm_kvmalloc(size_t size, const char *file, int line, const char *functi
 
 void *__uvm_kvmalloc_zero(size_t size, const char *file, int line, const char *function)
 {
-    void *p = alloc_internal(size, true);
+    void *p = alloc_internal(size, NUMA_NO_NODE, true);
+
+    if (uvm_leak_checker && p)
+        alloc_tracking_add(p, file, line, function);
+
+    return p;
+}
+
+void *__uvm_kvmalloc_node(size_t size, int node, const char *file, int line, const char *function)
+{
+    void *p = alloc_internal(size, node, false);
+
+    if (uvm_leak_checker && p)
+        alloc_tracking_add(p, file, line, function);
+
+    return p;
+}
+
+void *__uvm_kvmalloc_zero_node(size_t size, int node, const char *file, int line, const char *function)
+{
+    void *p = alloc_internal(size, node, true);
 
     if (uvm_leak_checker && p)
         alloc_tracking_add(p, file, line, function);
@@ -319,7 +393,7 @@ static void *realloc_from_kmalloc(void *p, size_t new_size)
         return krealloc(p, new_size, NV_UVM_GFP_FLAGS);
 
     // kmalloc -> vmalloc
-    new_p = alloc_internal(new_size, false);
+    new_p = alloc_internal(new_size, NUMA_NO_NODE, false);
     if (!new_p)
         return NULL;
     memcpy(new_p, p, min(ksize(p), new_size));
@@ -343,7 +417,7 @@ static void *realloc_from_vmalloc(void *p, size_t new_size)
 
     // vmalloc has no realloc functionality so we need to do a separate alloc +
     // copy.
-    new_p = alloc_internal(new_size, false);
+    new_p = alloc_internal(new_size, NUMA_NO_NODE, false);
     if (!new_p)
         return NULL;
 
@@ -410,3 +484,241 @@ size_t uvm_kvsize(void *p)
         return get_hdr(p)->alloc_size;
     return ksize(p);
 }
+
+uvm_object_cache_t *uvm_object_cache_create(const char *name,
+                                            size_t size,
+                                            NvU32 per_cpu_objects,
+                                            uvm_object_cache_ctor_t ctor,
+                                            uvm_object_cache_dtor_t dtor)
+{
+    uvm_object_cache_t *cache;
+    unsigned long irq_flags;
+
+    UVM_ASSERT(g_malloc_initialized);
+    UVM_ASSERT(per_cpu_objects <= UVM_OBJECT_CACHE_MAX_PER_CPU_OBJECTS);
+
+    cache = uvm_kvmalloc_zero(sizeof(*cache));
+    if (!cache)
+        return NULL;
+
+    if (size <= UVM_KMALLOC_THRESHOLD) {
+        cache->kmem_cache = nv_kmem_cache_create(name, size, 0);
+        if (!cache->kmem_cache)
+            goto error;
+    }
+
+    cache->cpu_caches = alloc_percpu(uvm_object_cache_cpu_t);
+    if (!cache->cpu_caches)
+        goto error;
+
+    cache->name = name;
+    cache->size = size;
+    cache->ctor = ctor;
+    cache->dtor = dtor;
+    cache->per_cpu_objects = min_t(size_t,
+                                   per_cpu_objects,
+                                   max_t(size_t, UVM_OBJECT_CACHE_MAX_PER_CPU_BYTES / size, 1));
+    atomic_long_set(&cache->outstanding, 0);
+
+    spin_lock_irqsave(&g_uvm_object_caches.lock, irq_flags);
+    list_add_tail(&cache->list_node, &g_uvm_object_caches.list);
+    spin_unlock_irqrestore(&g_uvm_object_caches.lock, irq_flags);
+
+    return cache;
+
+error:
+    kmem_cache_destroy_safe(&cache->kmem_cache);
+    uvm_kvfree(cache);
+    return NULL;
+}
+
+static void *object_cache_backing_alloc(uvm_object_cache_t *cache)
+{
+    if (cache->kmem_cache)
+        return kmem_cache_alloc(cache->kmem_cache, NV_UVM_GFP_FLAGS);
+
+    return uvm_kvmalloc(cache->size);
+}
+
+static void object_cache_backing_free(uvm_object_cache_t *cache, void *object)
+{
+    if (cache->kmem_cache)
+        kmem_cache_free(cache->kmem_cache, object);
+    else
+        uvm_kvfree(object);
+}
+
+static void object_cache_release(uvm_object_cache_t *cache, void *object)
+{
+    if (cache->dtor)
+        cache->dtor(object);
+
+    object_cache_backing_free(cache, object);
+}
+
+void uvm_object_cache_destroy_safe(uvm_object_cache_t **cache_ptr)
+{
+    uvm_object_cache_t *cache = *cache_ptr;
+    unsigned long irq_flags;
+    int cpu;
+
+    if (!cache)
+        return;
+
+    UVM_ASSERT_MSG(atomic_long_read(&cache->outstanding) == 0,
+                   "%s: %ld objects outstanding\n",
+                   cache->name,
+                   atomic_long_read(&cache->outstanding));
+
+    spin_lock_irqsave(&g_uvm_object_caches.lock, irq_flags);
+    list_del(&cache->list_node);
+    spin_unlock_irqrestore(&g_uvm_object_caches.lock, irq_flags);
+
+    // No other users of the cache can be left at this point, so the stashes
+    // can be drained from any CPU.
+    for_each_possible_cpu(cpu) {
+        uvm_object_cache_cpu_t *cpu_cache = per_cpu_ptr(cache->cpu_caches, cpu);
+
+        while (cpu_cache->count > 0)
+            object_cache_release(cache, cpu_cache->objects[--cpu_cache->count]);
+    }
+
+    free_percpu(cache->cpu_caches);
+    kmem_cache_destroy_safe(&cache->kmem_cache);
+    uvm_kvfree(cache);
+
+    *cache_ptr = NULL;
+}
+
+void *uvm_object_cache_alloc(uvm_object_cache_t *cache)
+{
+    uvm_object_cache_cpu_t *cpu_cache;
+    unsigned long irq_flags;
+    void *object = NULL;
+
+    // Interrupts are disabled, rather than just preemption, so that the stash
+    // can also be used from interrupt context.
+    local_irq_save(irq_flags);
+
+    cpu_cache = this_cpu_ptr(cache->cpu_caches);
+    if (cpu_cache->count > 0) {
+        object = cpu_cache->objects[--cpu_cache->count];
+        cpu_cache->hits++;
+    }
+    else {
+        cpu_cache->misses++;
+    }
+
+    local_irq_restore(irq_flags);
+
+    if (!object) {
+        object = object_cache_backing_alloc(cache);
+        if (!object)
+            return NULL;
+
+        if (cache->ctor && cache->ctor(object) != NV_OK) {
+            object_cache_backing_free(cache, object);
+            return NULL;
+        }
+    }
+
+    atomic_long_inc(&cache->outstanding);
+
+    return object;
+}
+
+void uvm_object_cache_free(uvm_object_cache_t *cache, void *object)
+{
+    uvm_object_cache_cpu_t *cpu_cache;
+    unsigned long irq_flags;
+    bool stashed = false;
+
+    if (!object)
+        return;
+
+    UVM_ASSERT(atomic_long_read(&cache->outstanding) > 0);
+    atomic_long_dec(&cache->outstanding);
+
+    local_irq_save(irq_flags);
+
+    cpu_cache = this_cpu_ptr(cache->cpu_caches);
+    if (cpu_cache->count < cache->per_cpu_objects) {
+        cpu_cache->objects[cpu_cache->count++] = object;
+        stashed = true;
+    }
+
+    local_irq_restore(irq_flags);
+
+    if (!stashed)
+        object_cache_release(cache, object);
+}
+
+static int nv_procfs_read_object_caches(struct seq_file *s, void *v)
+{
+    uvm_object_cache_t *cache;
+    unsigned long irq_flags;
+
+    spin_lock_irqsave(&g_uvm_object_caches.lock, irq_flags);
+
+    UVM_SEQ_OR_DBG_PRINT(s, "%-40s %12s %12s %8s %8s %12s\n", "name", "hits", "misses", "hit%", "stashed",
+                         "outstanding");
+
+    list_for_each_entry(cache, &g_uvm_object_caches.list, list_node) {
+        NvU64 hits = 0;
+        NvU64 misses = 0;
+        NvU32 stashed = 0;
+        int cpu;
+
+        // The per-CPU counters are read without synchronization, so the
+        // values may be slightly stale.
+        for_each_possible_cpu(cpu) {
+            uvm_object_cache_cpu_t *cpu_cache = per_cpu_ptr(cache->cpu_caches, cpu);
+
+            hits += READ_ONCE(cpu_cache->hits);
+            misses += READ_ONCE(cpu_cache->misses);
+            stashed += READ_ONCE(cpu_cache->count);
+        }
+
+        UVM_SEQ_OR_DBG_PRINT(s,
+                             "%-40s %12llu %12llu %8llu %8u %12ld\n",
+                             cache->name,
+                             hits,
+                             misses,
+                             hits + misses ? (hits * 100) / (hits + misses) : 0,
+                             stashed,
+                             atomic_long_read(&cache->outstanding));
+    }
+
+    spin_unlock_irqrestore(&g_uvm_object_caches.lock, irq_flags);
+
+    return 0;
+}
+
+static int nv_procfs_read_object_caches_entry(struct seq_file *s, void *v)
+{
+    UVM_ENTRY_RET(nv_procfs_read_object_caches(s, v));
+}
+
+UVM_DEFINE_SINGLE_PROCFS_FILE(object_caches_entry);
+
+NV_STATUS uvm_object_cache_procfs_init(void)
+{
+    if (!uvm_procfs_is_debug_enabled())
+        return NV_OK;
+
+    UVM_ASSERT(!g_uvm_object_caches.procfs_file);
+    g_uvm_object_caches.procfs_file = NV_CREATE_PROC_FILE("object_caches",
+                                                          uvm_procfs_get_base_dir(),
+                                                          object_caches_entry,
+                                                          NULL);
+    if (!g_uvm_object_caches.procfs_file)
+        return NV_ERR_OPERATING_SYSTEM;
+
+    return NV_OK;
+}
+
+void uvm_object_cache_procfs_exit(void)
+{
+    proc_remove(g_uvm_object_caches.procfs_file);
+    g_uvm_object_caches.procfs_file = NULL;
+}
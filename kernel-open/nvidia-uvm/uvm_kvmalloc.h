@@ -53,6 +53,16 @@ void *__uvm_kvmalloc_zero(size_t size, const char *file, int line, const char *f
 #define uvm_kvmalloc(__size) __uvm_kvmalloc(__size, __FILE__, __LINE__, __FUNCTION__)
 #define uvm_kvmalloc_zero(__size) __uvm_kvmalloc_zero(__size, __FILE__, __LINE__, __FUNCTION__)
 
+// Same as uvm_kvmalloc and uvm_kvmalloc_zero, but preferring memory from the
+// given NUMA node. NUMA_NO_NODE has no preference. The memory may still come
+// from a different node if the preferred one is out of memory.
+void *__uvm_kvmalloc_node(size_t size, int node, const char *file, int line, const char *function);
+void *__uvm_kvmalloc_zero_node(size_t size, int node, const char *file, int line, const char *function);
+
+#define uvm_kvmalloc_node(__size, __node) __uvm_kvmalloc_node(__size, __node, __FILE__, __LINE__, __FUNCTION__)
+#define uvm_kvmalloc_zero_node(__size, __node) \
+        __uvm_kvmalloc_zero_node(__size, __node, __FILE__, __LINE__, __FUNCTION__)
+
 void uvm_kvfree(void *p);
 
 // Follows standard realloc semantics:
@@ -70,6 +80,67 @@ void *__uvm_kvrealloc(void *p, size_t new_size, const char *file, int line, cons
 // p must not be NULL.
 size_t uvm_kvsize(void *p);
 
+// Typed object caches
+//
+// An object cache is a kmem_cache with a small per-CPU stash of free objects
+// in front of it. Objects in the stash keep whatever state they were freed
+// with, so an optional constructor can be used to set up expensive state (for
+// example, secondary allocations owned by the object) once per object instead
+// of once per allocation. This makes allocating and freeing the same type of
+// object in hot paths much cheaper, as long as the caller restores the state
+// set up by the constructor before freeing the object.
+//
+// The constructor is called when a new object is allocated from the backing
+// kmem_cache, and the destructor right before the object is returned to it.
+// Both are optional. The constructor may fail, in which case the allocation
+// fails too.
+//
+// Allocations and frees are served from the stash of the current CPU when
+// possible. The per-cache count of hits and misses in the stash is reported in
+// the object_caches debug procfs file.
+//
+// Objects larger than UVM_KMALLOC_THRESHOLD are not backed by a kmem_cache,
+// which would need high-order pages for its slabs, but allocated with
+// uvm_kvmalloc() like any other large allocation.
+typedef struct uvm_object_cache_struct uvm_object_cache_t;
+
+typedef NV_STATUS (*uvm_object_cache_ctor_t)(void *object);
+typedef void (*uvm_object_cache_dtor_t)(void *object);
+
+// Max number of objects kept in the per-CPU stash of a cache
+#define UVM_OBJECT_CACHE_MAX_PER_CPU_OBJECTS 8
+
+// Max number of bytes of objects kept in the per-CPU stash of a cache. The
+// stash of caches of large objects is shallower than requested, but always
+// holds at least one object.
+#define UVM_OBJECT_CACHE_MAX_PER_CPU_BYTES (64 * 1024)
+
+// name must be a string literal, or otherwise outlive the cache.
+// per_cpu_objects is the depth of the per-CPU stash, at most
+// UVM_OBJECT_CACHE_MAX_PER_CPU_OBJECTS, and further limited by
+// UVM_OBJECT_CACHE_MAX_PER_CPU_BYTES, since the stashed objects are only
+// released when the cache is destroyed.
+uvm_object_cache_t *uvm_object_cache_create(const char *name,
+                                            size_t size,
+                                            NvU32 per_cpu_objects,
+                                            uvm_object_cache_ctor_t ctor,
+                                            uvm_object_cache_dtor_t dtor);
+
+#define UVM_OBJECT_CACHE_CREATE(name, type, per_cpu_objects, ctor, dtor) \
+    uvm_object_cache_create(name, sizeof(type), per_cpu_objects, ctor, dtor)
+
+// Destroy the cache and set the pointer to NULL. All objects must have been
+// freed. Does nothing if the cache pointer is NULL.
+void uvm_object_cache_destroy_safe(uvm_object_cache_t **cache_ptr);
+
+void *uvm_object_cache_alloc(uvm_object_cache_t *cache);
+void uvm_object_cache_free(uvm_object_cache_t *cache, void *object);
+
+// Create and remove the object_caches debug procfs file. These have to be
+// called after uvm_procfs_init and before uvm_procfs_exit, respectively.
+NV_STATUS uvm_object_cache_procfs_init(void);
+void uvm_object_cache_procfs_exit(void);
+
 NV_STATUS uvm_test_kvmalloc(UVM_TEST_KVMALLOC_PARAMS *params, struct file *filp);
 
 #endif // __UVM_KVMALLOC_H__
@@ -175,10 +175,154 @@ static NV_STATUS test_uvm_kvrealloc(void)
     return NV_OK;
 }
 
+#define TEST_OBJECT_MAGIC 0x0bec7cac4eULL
+
+typedef struct
+{
+    NvU64 magic;
+    NvU64 payload[7];
+} test_object_t;
+
+static atomic_t g_test_object_ctors;
+static atomic_t g_test_object_dtors;
+static bool g_test_object_ctor_fail;
+
+static NV_STATUS test_object_ctor(void *object)
+{
+    test_object_t *test_object = object;
+
+    if (g_test_object_ctor_fail)
+        return NV_ERR_NO_MEMORY;
+
+    test_object->magic = TEST_OBJECT_MAGIC;
+    atomic_inc(&g_test_object_ctors);
+
+    return NV_OK;
+}
+
+static void test_object_dtor(void *object)
+{
+    test_object_t *test_object = object;
+
+    UVM_ASSERT(test_object->magic == TEST_OBJECT_MAGIC);
+    test_object->magic = 0;
+    atomic_inc(&g_test_object_dtors);
+}
+
+static NV_STATUS test_object_cache(void)
+{
+    uvm_object_cache_t *cache;
+    test_object_t *objects[UVM_OBJECT_CACHE_MAX_PER_CPU_OBJECTS * 2];
+    test_object_t *object = NULL;
+    NV_STATUS status = NV_OK;
+    size_t i, j;
+
+    atomic_set(&g_test_object_ctors, 0);
+    atomic_set(&g_test_object_dtors, 0);
+    g_test_object_ctor_fail = false;
+
+    cache = UVM_OBJECT_CACHE_CREATE("uvm_test_object_t", test_object_t, 2, test_object_ctor, test_object_dtor);
+    if (!cache)
+        return NV_ERR_NO_MEMORY;
+
+    memset(objects, 0, sizeof(objects));
+
+    for (i = 0; i < 4; i++) {
+        // Objects are constructed, whether they come from the stash or not
+        for (j = 0; j < ARRAY_SIZE(objects); j++) {
+            objects[j] = uvm_object_cache_alloc(cache);
+            TEST_CHECK_GOTO(objects[j], done);
+            TEST_CHECK_GOTO(objects[j]->magic == TEST_OBJECT_MAGIC, done);
+            memset(objects[j]->payload, (int)(i + j), sizeof(objects[j]->payload));
+        }
+
+        for (j = 0; j < ARRAY_SIZE(objects); j++) {
+            uvm_object_cache_free(cache, objects[j]);
+            objects[j] = NULL;
+        }
+
+        // Only the stashed objects can still be constructed
+        TEST_CHECK_GOTO(atomic_read(&g_test_object_ctors) >= atomic_read(&g_test_object_dtors), done);
+    }
+
+    // A failing constructor fails the allocation, unless the object comes
+    // from the stash. Drain the stash of this CPU first. The test could be
+    // migrated to a different CPU in between, in which case the stash may be
+    // hit anyway.
+    for (j = 0; j < ARRAY_SIZE(objects); j++) {
+        objects[j] = uvm_object_cache_alloc(cache);
+        TEST_CHECK_GOTO(objects[j], done);
+    }
+
+    g_test_object_ctor_fail = true;
+    object = uvm_object_cache_alloc(cache);
+    g_test_object_ctor_fail = false;
+
+    if (object)
+        TEST_CHECK_GOTO(object->magic == TEST_OBJECT_MAGIC, done);
+
+done:
+    g_test_object_ctor_fail = false;
+
+    uvm_object_cache_free(cache, object);
+
+    for (j = 0; j < ARRAY_SIZE(objects); j++)
+        uvm_object_cache_free(cache, objects[j]);
+
+    uvm_object_cache_destroy_safe(&cache);
+    TEST_CHECK_RET(!cache);
+
+    // Every object constructed was destroyed
+    if (status == NV_OK)
+        TEST_CHECK_RET(atomic_read(&g_test_object_ctors) == atomic_read(&g_test_object_dtors));
+
+    return status;
+}
+
+// Objects too large for a kmem_cache are allocated with uvm_kvmalloc
+static NV_STATUS test_object_cache_large(void)
+{
+    uvm_object_cache_t *cache;
+    void *objects[UVM_OBJECT_CACHE_MAX_PER_CPU_OBJECTS * 2];
+    size_t size = UVM_KMALLOC_THRESHOLD * 2;
+    NV_STATUS status = NV_OK;
+    size_t i;
+
+    cache = uvm_object_cache_create("uvm_test_large_object", size, UVM_OBJECT_CACHE_MAX_PER_CPU_OBJECTS, NULL, NULL);
+    if (!cache)
+        return NV_ERR_NO_MEMORY;
+
+    memset(objects, 0, sizeof(objects));
+
+    for (i = 0; i < ARRAY_SIZE(objects); i++) {
+        objects[i] = uvm_object_cache_alloc(cache);
+        TEST_CHECK_GOTO(objects[i], done);
+        TEST_CHECK_GOTO(uvm_kvsize(objects[i]) >= size, done);
+        memset(objects[i], (int)i, size);
+    }
+
+done:
+    for (i = 0; i < ARRAY_SIZE(objects); i++)
+        uvm_object_cache_free(cache, objects[i]);
+
+    uvm_object_cache_destroy_safe(&cache);
+
+    return status;
+}
+
 NV_STATUS uvm_test_kvmalloc(UVM_TEST_KVMALLOC_PARAMS *params, struct file *filp)
 {
     NV_STATUS status = test_uvm_kvmalloc();
     if (status != NV_OK)
         return status;
-    return test_uvm_kvrealloc();
+
+    status = test_uvm_kvrealloc();
+    if (status != NV_OK)
+        return status;
+
+    status = test_object_cache();
+    if (status != NV_OK)
+        return status;
+
+    return test_object_cache_large();
 }
@@ -409,7 +409,9 @@
 //
 //      Lock protecting the state of all the channels in a channel pool. The
 //      channel pool lock documentation contains the guidelines about which lock
-//      type (mutex or spinlock) to use.
+//      type (mutex or spinlock) to use. In pools using a spinlock, each channel
+//      is protected by its own spinlock of the same order instead, and no more
+//      than one channel lock is held at a time.
 //
 // - WLC Channel lock
 //      Order: UVM_LOCK_ORDER_WLC_CHANNEL
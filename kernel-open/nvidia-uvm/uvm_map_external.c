@@ -46,6 +46,68 @@
 // Assume almost all of the push space can be used for PTEs leaving 1K of margin.
 #define MAX_COPY_SIZE_PER_PUSH ((size_t)(UVM_MAX_PUSH_SIZE - 1024))
 
+// Maximum size in bytes of the PTEs cached for a single external mapping. 0
+// disables the external PTE cache.
+static unsigned uvm_ext_pte_cache_max_size = 2 * 1024 * 1024;
+module_param(uvm_ext_pte_cache_max_size, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_ext_pte_cache_max_size,
+                 "Maximum size in bytes of the PTEs cached for an external mapping, so that mapping "
+                 "the same allocation again, in any VA space, doesn't query them from RM. 0 disables the cache.");
+
+// The external PTE cache keeps the PTEs returned by RM for a mapping of an
+// external allocation, so that mapping the same physical allocation again on
+// the same GPU, with the same attributes, from any VA space, can skip
+// nvUvmInterfaceGetExternalAllocPtes.
+//
+// RM handles don't identify allocations across clients, and user handles can
+// be freed and reused at any time, so entries are keyed on the physical
+// identity returned by nvUvmInterfaceDupMemory instead. Only contiguous
+// allocations have one, the others are never cached.
+//
+// Entries are referenced by the duped handles (uvm_ext_gpu_mem_handle) of the
+// mappings created from them, and are removed when the last one is freed. The
+// allocation can only be freed by RM once all the duped handles are gone, so
+// the physical memory of a cached entry can't be recycled under it.
+struct uvm_ext_pte_cache_entry_struct
+{
+    // Node in the GPU's ext_pte_cache.entries list. Empty until the entry is
+    // fully filled and inserted.
+    struct list_head list_node;
+
+    // Number of uvm_ext_gpu_mem_handle referencing the entry. Protected by
+    // the cache lock.
+    NvU64 ref_count;
+
+    // Physical identity of the allocation.
+    bool sysmem;
+    bool egm;
+    bool device_descendant;
+    NvProcessorUuid uuid;
+    NvU64 phys_addr;
+    NvU64 alloc_size;
+    NvU32 kind;
+
+    // Mapping attributes the PTEs were queried with.
+    UvmGpuMappingType mapping_type;
+    UvmGpuCachingType caching_type;
+    UvmGpuFormatType format_type;
+    UvmGpuFormatElementBits element_bits;
+    UvmGpuCompressionType compression_type;
+    NvU64 page_size;
+    NvU32 pte_size;
+
+    // The PTEs cover [pte_offset, pte_offset + num_ptes) in page_size units
+    // from the start of the allocation.
+    size_t pte_offset;
+    size_t num_ptes;
+
+    // Number of PTEs from pte_offset already copied to ptes while the entry
+    // is being filled.
+    size_t num_filled_ptes;
+
+    NvU64 *ptes;
+};
+
 typedef struct
 {
     // The VA range the buffer is for
@@ -77,6 +139,12 @@ typedef struct
 
     // PTE offset at which the currently buffered PTEs start.
     size_t pte_offset;
+
+    // External PTE cache entry covering the mapping. If cache_hit is set, the
+    // PTEs are read from it and RM is never called. Otherwise the PTEs
+    // returned by RM are copied to it. NULL if the PTEs are not cached.
+    uvm_ext_pte_cache_entry_t *cache_entry;
+    bool cache_hit;
 } uvm_pte_buffer_t;
 
 // Max PTE buffer size is the size of the buffer used for querying PTEs from RM.
@@ -87,8 +155,260 @@ typedef struct
 // some benchmarking on more systems though.
 #define MAX_PTE_BUFFER_SIZE ((size_t)96 * 1024)
 
+void uvm_ext_pte_cache_init(uvm_gpu_t *gpu)
+{
+    INIT_LIST_HEAD(&gpu->ext_pte_cache.entries);
+    uvm_mutex_init(&gpu->ext_pte_cache.lock, UVM_LOCK_ORDER_LEAF);
+}
+
+void uvm_ext_pte_cache_deinit(uvm_gpu_t *gpu)
+{
+    // Entries are only referenced by external mappings.
+    UVM_ASSERT(list_empty(&gpu->ext_pte_cache.entries));
+}
+
+static void ext_pte_cache_entry_free(uvm_ext_pte_cache_entry_t *entry)
+{
+    if (!entry)
+        return;
+
+    uvm_kvfree(entry->ptes);
+    uvm_kvfree(entry);
+}
+
+// Fill the key of the entry from the allocation and mapping attributes.
+static void ext_pte_cache_entry_set_key(uvm_ext_pte_cache_entry_t *entry,
+                                        const UvmGpuMemoryInfo *mem_info,
+                                        const uvm_map_rm_params_t *map_rm_params,
+                                        NvU64 page_size,
+                                        NvU32 pte_size,
+                                        size_t pte_offset,
+                                        size_t num_ptes)
+{
+    memset(entry, 0, sizeof(*entry));
+
+    INIT_LIST_HEAD(&entry->list_node);
+    entry->sysmem = mem_info->sysmem;
+    entry->egm = mem_info->egm;
+    entry->device_descendant = mem_info->deviceDescendant;
+    if (mem_info->deviceDescendant)
+        entry->uuid = mem_info->uuid;
+    entry->phys_addr = mem_info->physAddr;
+    entry->alloc_size = mem_info->size;
+    entry->kind = mem_info->kind;
+
+    entry->mapping_type = map_rm_params->mapping_type;
+    entry->caching_type = map_rm_params->caching_type;
+    entry->format_type = map_rm_params->format_type;
+    entry->element_bits = map_rm_params->element_bits;
+    entry->compression_type = map_rm_params->compression_type;
+    entry->page_size = page_size;
+    entry->pte_size = pte_size;
+
+    entry->pte_offset = pte_offset;
+    entry->num_ptes = num_ptes;
+}
+
+// Returns true if cached can provide the PTEs described by the key of wanted.
+static bool ext_pte_cache_entry_matches(const uvm_ext_pte_cache_entry_t *cached,
+                                        const uvm_ext_pte_cache_entry_t *wanted)
+{
+    if (cached->sysmem != wanted->sysmem ||
+        cached->egm != wanted->egm ||
+        cached->device_descendant != wanted->device_descendant ||
+        !uvm_uuid_eq(&cached->uuid, &wanted->uuid) ||
+        cached->phys_addr != wanted->phys_addr ||
+        cached->alloc_size != wanted->alloc_size ||
+        cached->kind != wanted->kind)
+        return false;
+
+    if (cached->mapping_type != wanted->mapping_type ||
+        cached->caching_type != wanted->caching_type ||
+        cached->format_type != wanted->format_type ||
+        cached->element_bits != wanted->element_bits ||
+        cached->compression_type != wanted->compression_type ||
+        cached->page_size != wanted->page_size ||
+        cached->pte_size != wanted->pte_size)
+        return false;
+
+    return cached->pte_offset <= wanted->pte_offset &&
+           cached->pte_offset + cached->num_ptes >= wanted->pte_offset + wanted->num_ptes;
+}
+
+static uvm_ext_pte_cache_entry_t *ext_pte_cache_find_locked(uvm_gpu_t *gpu, const uvm_ext_pte_cache_entry_t *wanted)
+{
+    uvm_ext_pte_cache_entry_t *entry;
+
+    uvm_assert_mutex_locked(&gpu->ext_pte_cache.lock);
+
+    list_for_each_entry(entry, &gpu->ext_pte_cache.entries, list_node) {
+        if (ext_pte_cache_entry_matches(entry, wanted))
+            return entry;
+    }
+
+    return NULL;
+}
+
+// Drop a reference on an entry inserted in the GPU's cache, removing and
+// freeing it when it was the last one.
+static void ext_pte_cache_entry_release(uvm_gpu_t *gpu, uvm_ext_pte_cache_entry_t *entry)
+{
+    bool last;
+
+    uvm_mutex_lock(&gpu->ext_pte_cache.lock);
+    UVM_ASSERT(entry->ref_count > 0);
+    last = (--entry->ref_count == 0);
+    if (last)
+        list_del_init(&entry->list_node);
+    uvm_mutex_unlock(&gpu->ext_pte_cache.lock);
+
+    if (last)
+        ext_pte_cache_entry_free(entry);
+}
+
+// Look up the PTEs of the mapping in the GPU's cache. On a hit, a reference is
+// taken on the matching entry and it is returned in pte_buffer->cache_entry.
+// On a miss, a new entry to be filled while querying the PTEs from RM is
+// allocated, unless the mapping can't be cached. Failing to allocate the entry
+// is not an error, the mapping is just not cached.
+static void ext_pte_cache_lookup(uvm_pte_buffer_t *pte_buffer,
+                                 const UvmGpuMemoryInfo *mem_info,
+                                 const uvm_map_rm_params_t *map_rm_params,
+                                 size_t num_ptes)
+{
+    uvm_gpu_t *gpu = pte_buffer->gpu;
+    uvm_ext_pte_cache_entry_t *entry;
+    uvm_ext_pte_cache_entry_t *cached;
+
+    if (uvm_ext_pte_cache_max_size == 0)
+        return;
+
+    // Only contiguous allocations can be identified by their physical
+    // address. Fabric allocations are neither sysmem nor device descendants,
+    // and their physical address is not meaningful to UVM.
+    if (!mem_info->contig || (!mem_info->sysmem && !mem_info->deviceDescendant))
+        return;
+
+    if ((NvU64)num_ptes * pte_buffer->pte_size > uvm_ext_pte_cache_max_size)
+        return;
+
+    entry = uvm_kvmalloc(sizeof(*entry));
+    if (!entry)
+        return;
+
+    ext_pte_cache_entry_set_key(entry,
+                                mem_info,
+                                map_rm_params,
+                                pte_buffer->page_size,
+                                pte_buffer->pte_size,
+                                pte_buffer->max_pte_offset - num_ptes,
+                                num_ptes);
+
+    uvm_mutex_lock(&gpu->ext_pte_cache.lock);
+    cached = ext_pte_cache_find_locked(gpu, entry);
+    if (cached)
+        ++cached->ref_count;
+    uvm_mutex_unlock(&gpu->ext_pte_cache.lock);
+
+    if (cached) {
+        uvm_kvfree(entry);
+        pte_buffer->cache_entry = cached;
+        pte_buffer->cache_hit = true;
+        atomic64_inc(&gpu->ext_pte_cache.hits);
+        return;
+    }
+
+    atomic64_inc(&gpu->ext_pte_cache.misses);
+
+    entry->ptes = uvm_kvmalloc(num_ptes * pte_buffer->pte_size);
+    if (!entry->ptes) {
+        uvm_kvfree(entry);
+        return;
+    }
+
+    pte_buffer->cache_entry = entry;
+}
+
+// Copy the PTEs just returned by RM to the cache entry being filled.
+static void ext_pte_cache_entry_fill(uvm_pte_buffer_t *pte_buffer)
+{
+    uvm_ext_pte_cache_entry_t *entry = pte_buffer->cache_entry;
+    size_t start = pte_buffer->pte_offset;
+    size_t end = start + pte_buffer->num_ptes;
+
+    UVM_ASSERT(!pte_buffer->cache_hit);
+    UVM_ASSERT(start >= entry->pte_offset);
+    UVM_ASSERT(end <= entry->pte_offset + entry->num_ptes);
+
+    // The PTEs are queried in increasing offset order, so any gap would mean
+    // that the entry can't be completed. Give up on caching this mapping.
+    if (start > entry->pte_offset + entry->num_filled_ptes) {
+        ext_pte_cache_entry_free(entry);
+        pte_buffer->cache_entry = NULL;
+        return;
+    }
+
+    memcpy((char *)entry->ptes + (start - entry->pte_offset) * entry->pte_size,
+           pte_buffer->mapping_info.pteBuffer,
+           pte_buffer->num_ptes * entry->pte_size);
+
+    entry->num_filled_ptes = max(entry->num_filled_ptes, end - entry->pte_offset);
+}
+
+// Called once the mapping is done. On success, the entry is attached to the
+// mem_handle of the mapping, inserting it into the cache first if it was just
+// filled. On failure, the reference taken or the entry allocated by
+// ext_pte_cache_lookup() is dropped.
+static void ext_pte_cache_complete(uvm_pte_buffer_t *pte_buffer, uvm_ext_gpu_mem_handle *mem_handle, NV_STATUS status)
+{
+    uvm_gpu_t *gpu = pte_buffer->gpu;
+    uvm_ext_pte_cache_entry_t *entry = pte_buffer->cache_entry;
+    uvm_ext_pte_cache_entry_t *cached;
+
+    if (!entry)
+        return;
+
+    pte_buffer->cache_entry = NULL;
+
+    if (status != NV_OK || (!pte_buffer->cache_hit && entry->num_filled_ptes != entry->num_ptes)) {
+        if (pte_buffer->cache_hit)
+            ext_pte_cache_entry_release(gpu, entry);
+        else
+            ext_pte_cache_entry_free(entry);
+        return;
+    }
+
+    UVM_ASSERT(!mem_handle->pte_cache_entry);
+
+    if (pte_buffer->cache_hit) {
+        mem_handle->pte_cache_entry = entry;
+        return;
+    }
+
+    // Another thread may have inserted an equivalent entry while this one was
+    // being filled. Share it rather than caching the same PTEs twice.
+    uvm_mutex_lock(&gpu->ext_pte_cache.lock);
+    cached = ext_pte_cache_find_locked(gpu, entry);
+    if (cached) {
+        ++cached->ref_count;
+    }
+    else {
+        entry->ref_count = 1;
+        list_add(&entry->list_node, &gpu->ext_pte_cache.entries);
+    }
+    uvm_mutex_unlock(&gpu->ext_pte_cache.lock);
+
+    if (cached) {
+        ext_pte_cache_entry_free(entry);
+        entry = cached;
+    }
+
+    mem_handle->pte_cache_entry = entry;
+}
+
 static NV_STATUS uvm_pte_buffer_init(uvm_va_range_t *va_range,
                                      uvm_gpu_t *gpu,
+                                     const UvmGpuMemoryInfo *mem_info,
                                      const uvm_map_rm_params_t *map_rm_params,
                                      NvU64 length,
                                      NvU64 page_size,
@@ -116,15 +436,27 @@ static NV_STATUS uvm_pte_buffer_init(uvm_va_range_t *va_range,
     pte_buffer->max_pte_offset = uvm_div_pow2_64(map_rm_params->map_offset, page_size) + num_all_ptes;
     pte_buffer->buffer_size = min(MAX_PTE_BUFFER_SIZE, num_all_ptes * pte_buffer->pte_size);
 
+    if (va_range->type == UVM_VA_RANGE_TYPE_EXTERNAL)
+        ext_pte_cache_lookup(pte_buffer, mem_info, map_rm_params, num_all_ptes);
+
+    // The PTEs of a cache hit are read directly from the cache entry
+    if (pte_buffer->cache_hit)
+        return NV_OK;
+
     pte_buffer->mapping_info.pteBuffer = uvm_kvmalloc(pte_buffer->buffer_size);
-    if (!pte_buffer->mapping_info.pteBuffer)
+    if (!pte_buffer->mapping_info.pteBuffer) {
+        ext_pte_cache_entry_free(pte_buffer->cache_entry);
+        pte_buffer->cache_entry = NULL;
         return NV_ERR_NO_MEMORY;
+    }
 
     return NV_OK;
 }
 
 static void uvm_pte_buffer_deinit(uvm_pte_buffer_t *pte_buffer)
 {
+    UVM_ASSERT(!pte_buffer->cache_entry);
+
     uvm_kvfree(pte_buffer->mapping_info.pteBuffer);
 }
 
@@ -150,6 +482,17 @@ static NV_STATUS uvm_pte_buffer_get(uvm_pte_buffer_t *pte_buffer,
 
     UVM_ASSERT(num_ptes <= pte_buffer->buffer_size / pte_buffer->pte_size);
 
+    if (pte_buffer->cache_hit) {
+        uvm_ext_pte_cache_entry_t *entry = pte_buffer->cache_entry;
+
+        UVM_ASSERT(pte_offset >= entry->pte_offset);
+        UVM_ASSERT(pte_offset + num_ptes <= entry->pte_offset + entry->num_ptes);
+
+        pte_offset -= entry->pte_offset;
+        *ptes_out = (NvU64 *)((char *)entry->ptes + pte_offset * entry->pte_size);
+        return NV_OK;
+    }
+
     // If the requested range is already fully cached, just calculate its
     // offset within the buffer and return.
     if (pte_buffer->pte_offset <= pte_offset && pte_buffer->pte_offset + pte_buffer->num_ptes >= pte_offset + num_ptes) {
@@ -198,6 +541,9 @@ static NV_STATUS uvm_pte_buffer_get(uvm_pte_buffer_t *pte_buffer,
         return status;
     }
 
+    if (pte_buffer->cache_entry)
+        ext_pte_cache_entry_fill(pte_buffer);
+
     *ptes_out = pte_buffer->mapping_info.pteBuffer;
 
     return NV_OK;
@@ -424,6 +770,7 @@ NV_STATUS uvm_va_range_map_rm_allocation(uvm_va_range_t *va_range,
 
     status = uvm_pte_buffer_init(va_range,
                                  mapping_gpu,
+                                 mem_info,
                                  map_rm_params,
                                  uvm_range_tree_node_size(node),
                                  mem_info->pageSize,
@@ -485,6 +832,9 @@ out:
         }
     }
 
+    if (ext_gpu_map)
+        ext_pte_cache_complete(&pte_buffer, ext_gpu_map->mem_handle, status);
+
     uvm_pte_buffer_deinit(&pte_buffer);
     uvm_tracker_deinit(&local_tracker);
     return status;
@@ -581,6 +931,10 @@ static void uvm_release_rm_handle(struct nv_kref *ref)
 {
     uvm_ext_gpu_mem_handle *mem_handle = container_of(ref, uvm_ext_gpu_mem_handle, ref_count);
 
+    // Drop the cached PTEs before the RM allocation can be freed
+    if (mem_handle->pte_cache_entry)
+        ext_pte_cache_entry_release(mem_handle->gpu, mem_handle->pte_cache_entry);
+
     if (mem_handle->rm_handle) {
         NV_STATUS status;
 
@@ -148,4 +148,9 @@ void uvm_ext_gpu_map_destroy(uvm_va_range_t *va_range,
 // Deferred free function which frees the RM handle and the object itself.
 void uvm_ext_gpu_map_free(uvm_ext_gpu_map_t *ext_gpu_map);
 
+// Initialize and tear down the external PTE cache of the GPU. All the external
+// mappings on the GPU must have been freed before the cache is torn down.
+void uvm_ext_pte_cache_init(uvm_gpu_t *gpu);
+void uvm_ext_pte_cache_deinit(uvm_gpu_t *gpu);
+
 #endif // __UVM_MAP_EXTERNAL_H__
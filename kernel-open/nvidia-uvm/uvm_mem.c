@@ -375,9 +375,10 @@ static void mem_free_sysmem_dma_chunks(uvm_mem_t *mem)
         if (!mem->sysmem.va[i])
             break;
 
-        uvm_parent_gpu_dma_free_page(mem->dma_owner->parent,
-                                     mem->sysmem.va[i],
-                                     mem->sysmem.dma_addrs[gpu_index][i]);
+        uvm_parent_gpu_dma_free(mem->dma_owner->parent,
+                                mem->chunk_size,
+                                mem->sysmem.va[i],
+                                mem->sysmem.dma_addrs[gpu_index][i]);
     }
 
 end:
@@ -458,6 +459,10 @@ static gfp_t sysmem_allocation_gfp_flags(int order, bool zero)
 // allocator UVM must use. Hence, this function does the equivalent of
 // uvm_mem_map_gpu_phys().
 //
+// Chunks larger than PAGE_SIZE are physically contiguous. Their allocation is
+// more likely to fail, so it is not retried and callers are expected to fall
+// back to the default page size.
+//
 // In case of failure, the caller is required to handle cleanup by calling
 // uvm_mem_free
 static NV_STATUS mem_alloc_sysmem_dma_chunks(uvm_mem_t *mem, gfp_t gfp_flags)
@@ -466,11 +471,14 @@ static NV_STATUS mem_alloc_sysmem_dma_chunks(uvm_mem_t *mem, gfp_t gfp_flags)
     NV_STATUS status;
     NvU64 *dma_addrs;
 
-    UVM_ASSERT_MSG(mem->chunk_size == PAGE_SIZE,
-                   "mem->chunk_size is 0x%llx. PAGE_SIZE is only supported.",
+    UVM_ASSERT_MSG(mem->chunk_size >= PAGE_SIZE && PAGE_ALIGNED(mem->chunk_size),
+                   "mem->chunk_size is 0x%llx. Only multiples of PAGE_SIZE are supported.",
                    mem->chunk_size);
     UVM_ASSERT(uvm_mem_is_sysmem_dma(mem));
 
+    if (mem->chunk_size > PAGE_SIZE)
+        gfp_flags |= __GFP_NORETRY | __GFP_NOWARN;
+
     mem->sysmem.pages = uvm_kvmalloc_zero(sizeof(*mem->sysmem.pages) * mem->chunks_count);
     mem->sysmem.va = uvm_kvmalloc_zero(sizeof(*mem->sysmem.va) * mem->chunks_count);
     if (!mem->sysmem.pages || !mem->sysmem.va)
@@ -483,7 +491,10 @@ static NV_STATUS mem_alloc_sysmem_dma_chunks(uvm_mem_t *mem, gfp_t gfp_flags)
     dma_addrs = mem->sysmem.dma_addrs[uvm_id_gpu_index(mem->dma_owner->id)];
 
     for (i = 0; i < mem->chunks_count; ++i) {
-        mem->sysmem.va[i] = uvm_parent_gpu_dma_alloc_page(mem->dma_owner->parent, gfp_flags, &dma_addrs[i]);
+        mem->sysmem.va[i] = uvm_parent_gpu_dma_alloc(mem->dma_owner->parent,
+                                                      mem->chunk_size,
+                                                      gfp_flags,
+                                                      &dma_addrs[i]);
         if (!mem->sysmem.va[i])
             goto err_no_mem;
 
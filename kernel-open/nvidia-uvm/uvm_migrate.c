@@ -40,6 +40,7 @@
 #include "uvm_migrate.h"
 #include "uvm_migrate_pageable.h"
 #include "uvm_va_space_mm.h"
+#include "uvm_kvmalloc.h"
 #include "nv_speculation_barrier.h"
 
 typedef enum
@@ -56,7 +57,13 @@ module_param(uvm_perf_migrate_cpu_preunmap_enable, int, S_IRUGO);
 static unsigned uvm_perf_migrate_cpu_preunmap_block_order = UVM_PERF_MIGRATE_CPU_PREUNMAP_BLOCK_ORDER_DEFAULT;
 module_param(uvm_perf_migrate_cpu_preunmap_block_order, uint, S_IRUGO);
 
+// Spread the block copies of migrations spanning multiple VA blocks over the
+// CEs of the copying GPU. See uvm_channel_reserve_ce_stripe().
+static int uvm_perf_migrate_ce_stripe_enable = 0;
+module_param(uvm_perf_migrate_ce_stripe_enable, int, S_IRUGO);
+
 // Global post-processed values of the module parameters
+static bool g_uvm_perf_migrate_ce_stripe_enable __read_mostly;
 static bool g_uvm_perf_migrate_cpu_preunmap_enable __read_mostly;
 static NvU64 g_uvm_perf_migrate_cpu_preunmap_size __read_mostly;
 
@@ -449,6 +456,8 @@ static NV_STATUS uvm_va_range_migrate_multi_block(uvm_va_range_t *va_range,
     size_t i;
     const size_t first_block_index = uvm_va_range_block_index(va_range, start);
     const size_t last_block_index = uvm_va_range_block_index(va_range, end);
+    uvm_va_block_context_t *block_context = service_context->block_context;
+    bool ce_stripe = g_uvm_perf_migrate_ce_stripe_enable && first_block_index != last_block_index;
 
     UVM_ASSERT(start >= va_range->node.start);
     UVM_ASSERT(end  <= va_range->node.end);
@@ -471,6 +480,11 @@ static NV_STATUS uvm_va_range_migrate_multi_block(uvm_va_range_t *va_range,
                                                     max(start, va_block->start),
                                                     min(end, va_block->end));
 
+        // Contiguous blocks are copied round-robin over the CEs. Their
+        // completion is joined in out_tracker.
+        if (ce_stripe)
+            block_context->make_resident.ce_stripe = i;
+
         status = UVM_VA_BLOCK_LOCK_RETRY(va_block,
                                          &va_block_retry,
                                          uvm_va_block_migrate_locked(va_block,
@@ -480,6 +494,8 @@ static NV_STATUS uvm_va_range_migrate_multi_block(uvm_va_range_t *va_range,
                                                                      dest_id,
                                                                      mode,
                                                                      out_tracker));
+        block_context->make_resident.ce_stripe = 0;
+
         if (status != NV_OK)
             return status;
     }
@@ -652,7 +668,7 @@ static NV_STATUS uvm_migrate(uvm_va_space_t *va_space,
     else if (!first_va_range)
         return NV_ERR_INVALID_ADDRESS;
 
-    service_context = uvm_service_block_context_alloc(mm);
+    service_context = uvm_thread_context_service_context_get(mm);
     if (!service_context)
         return NV_ERR_NO_MEMORY;
 
@@ -714,11 +730,40 @@ static NV_STATUS uvm_migrate(uvm_va_space_t *va_space,
                                     out_tracker);
     }
 
-    uvm_service_block_context_free(service_context);
+    uvm_thread_context_service_context_put(service_context);
 
     return status;
 }
 
+NV_STATUS uvm_migrate_managed_range(uvm_va_space_t *va_space,
+                                    struct mm_struct *mm,
+                                    NvU64 base,
+                                    NvU64 length,
+                                    uvm_gpu_t *dest_gpu,
+                                    uvm_tracker_t *out_tracker)
+{
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    if (uvm_api_range_invalid(base, length))
+        return NV_ERR_INVALID_ADDRESS;
+
+    if (!uvm_gpu_can_address(dest_gpu, base, length))
+        return NV_ERR_OUT_OF_RANGE;
+
+    if (uvm_api_range_type_check(va_space, mm, base, length) != UVM_API_RANGE_TYPE_MANAGED)
+        return NV_ERR_INVALID_ADDRESS;
+
+    return uvm_migrate(va_space,
+                       mm,
+                       base,
+                       length,
+                       dest_gpu->id,
+                       NUMA_NO_NODE,
+                       0,
+                       uvm_va_space_iter_first(va_space, base, base),
+                       out_tracker);
+}
+
 static NV_STATUS semaphore_release_from_gpu(uvm_gpu_t *gpu,
                                             uvm_va_range_semaphore_pool_t *semaphore_va_range,
                                             NvU64 semaphore_user_addr,
@@ -835,13 +880,336 @@ static NV_STATUS semaphore_release(NvU64 semaphore_address,
     return semaphore_release_from_gpu(gpu, semaphore_pool, semaphore_address, semaphore_payload, tracker_ptr);
 }
 
+// Look up the destination GPU of a migration, NULL if the GPU can't be used as
+// a destination
+static uvm_gpu_t *migrate_dest_gpu(uvm_va_space_t *va_space, const NvProcessorUuid *dest_uuid, NvU32 flags)
+{
+    if (flags & UVM_MIGRATE_FLAG_NO_GPU_VA_SPACE)
+        return uvm_va_space_get_gpu_by_uuid(va_space, dest_uuid);
+
+    return uvm_va_space_get_gpu_by_uuid_with_gpu_va_space(va_space, dest_uuid);
+}
+
+// Look up the semaphore pool VA range containing a migration's semaphore, NULL
+// if the address is not valid for a semaphore
+static uvm_va_range_t *migrate_semaphore_va_range(uvm_va_space_t *va_space, NvU64 semaphore_address)
+{
+    uvm_va_range_t *va_range;
+
+    if (!IS_ALIGNED(semaphore_address, sizeof(NvU32)))
+        return NULL;
+
+    va_range = uvm_va_range_find(va_space, semaphore_address);
+    if (!va_range || va_range->type != UVM_VA_RANGE_TYPE_SEMAPHORE_POOL)
+        return NULL;
+
+    return va_range;
+}
+
+// If cpu_numa_node is not -1, we only check that it is a valid node in the
+// system, it has memory, and it doesn't correspond to a GPU node.
+//
+// For pageable memory, this is fine because alloc_pages_node will clamp the
+// allocation to cpuset_current_mems_allowed when uvm_migrate_pageable is called
+// from process context (uvm_migrate) when dst_id is CPU. UVM bottom half calls
+// uvm_migrate_pageable with CPU dst_id only when the VMA memory policy is set
+// to dst_node_id and dst_node_id is not NUMA_NO_NODE.
+static bool migrate_cpu_numa_node_valid(uvm_va_space_t *va_space, int cpu_numa_node)
+{
+    if (cpu_numa_node == -1)
+        return true;
+
+    return nv_numa_node_has_memory(cpu_numa_node) &&
+           node_isset(cpu_numa_node, node_possible_map) &&
+           !uvm_va_space_find_gpu_with_memory_node_id(va_space, cpu_numa_node);
+}
+
+// Migration queued with UVM_MIGRATE_FLAG_DEFERRED
+typedef struct
+{
+    // Node in va_space->deferred_migrations.list
+    struct list_head list_node;
+
+    NvU64 base;
+    NvU64 length;
+    NvProcessorUuid dest_uuid;
+    NvU32 flags;
+    int cpu_numa_node;
+    NvU64 semaphore_address;
+    NvU32 semaphore_payload;
+
+    // GPUs retained while the migration is in progress. The work tracked by
+    // the migration can reference any of them after the VA space lock is
+    // dropped, and they need to stay alive until the tracker is done with.
+    uvm_processor_mask_t retained_gpus;
+
+    // Scratch mask of GPUs to retain
+    uvm_processor_mask_t new_gpus;
+} uvm_migrate_deferred_t;
+
+// Deferred migrations are done in pieces of this size, the VA space lock is
+// dropped in between.
+#define UVM_MIGRATE_DEFERRED_CHUNK_SIZE (16 * UVM_VA_BLOCK_SIZE)
+
+static nv_kthread_q_t g_uvm_migrate_deferred_q;
+
+static bool migrate_deferred_stopped(uvm_va_space_t *va_space)
+{
+    bool stopped;
+
+    uvm_spin_lock(&va_space->deferred_migrations.lock);
+    stopped = va_space->deferred_migrations.stopped;
+    uvm_spin_unlock(&va_space->deferred_migrations.lock);
+
+    return stopped;
+}
+
+// Migrate [base, base + length) on behalf of the deferred migration. All the
+// changes the VA space may have gone through since the migration was queued,
+// or since the previous chunk, are revalidated.
+static NV_STATUS migrate_deferred_chunk(uvm_va_space_t *va_space,
+                                        struct mm_struct *mm,
+                                        uvm_migrate_deferred_t *deferred,
+                                        NvU64 base,
+                                        NvU64 length,
+                                        uvm_gpu_t **dest_gpu_out,
+                                        uvm_tracker_t *tracker)
+{
+    uvm_processor_id_t dest_id = UVM_ID_CPU;
+    uvm_gpu_t *dest_gpu = NULL;
+
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    // Make sure that any GPU registered since the last chunk stays alive too
+    if (uvm_processor_mask_andnot(&deferred->new_gpus, &va_space->registered_gpus, &deferred->retained_gpus)) {
+        uvm_global_gpu_retain(&deferred->new_gpus);
+        uvm_processor_mask_or(&deferred->retained_gpus, &deferred->retained_gpus, &deferred->new_gpus);
+    }
+
+    if (!uvm_uuid_is_cpu(&deferred->dest_uuid)) {
+        dest_gpu = migrate_dest_gpu(va_space, &deferred->dest_uuid, deferred->flags);
+        if (!dest_gpu)
+            return NV_ERR_INVALID_DEVICE;
+
+        dest_id = dest_gpu->id;
+    }
+
+    *dest_gpu_out = dest_gpu;
+
+    if (uvm_api_range_type_check(va_space, mm, base, length) != UVM_API_RANGE_TYPE_MANAGED)
+        return NV_ERR_INVALID_ADDRESS;
+
+    return uvm_migrate(va_space,
+                       mm,
+                       base,
+                       length,
+                       dest_id,
+                       (UVM_ID_IS_CPU(dest_id) ? deferred->cpu_numa_node : NUMA_NO_NODE),
+                       deferred->flags,
+                       uvm_va_space_iter_first(va_space, base, base),
+                       tracker);
+}
+
+static void migrate_deferred_release_semaphore(uvm_va_space_t *va_space,
+                                               uvm_migrate_deferred_t *deferred,
+                                               uvm_gpu_t *dest_gpu,
+                                               NV_STATUS status,
+                                               uvm_tracker_t *tracker)
+{
+    uvm_va_range_t *sema_va_range;
+
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    // The semaphore is released even if the migration failed, as there is no
+    // other way to notify the waiters. Wait for the work that was pushed in
+    // that case, so the release doesn't depend on a destination GPU that may
+    // be gone.
+    if (status != NV_OK) {
+        uvm_tracker_wait(tracker);
+        dest_gpu = NULL;
+    }
+
+    sema_va_range = migrate_semaphore_va_range(va_space, deferred->semaphore_address);
+    if (!sema_va_range)
+        return;
+
+    status = semaphore_release(deferred->semaphore_address,
+                               deferred->semaphore_payload,
+                               &sema_va_range->semaphore_pool,
+                               dest_gpu,
+                               tracker);
+    if (status != NV_OK)
+        UVM_DBG_PRINT("Deferred migration semaphore release failed: %s\n", nvstatusToString(status));
+}
+
+static void migrate_deferred(uvm_va_space_t *va_space, uvm_migrate_deferred_t *deferred)
+{
+    NV_STATUS status = NV_OK;
+    uvm_tracker_t tracker = UVM_TRACKER_INIT();
+    uvm_gpu_t *dest_gpu = NULL;
+    const NvU64 end = deferred->base + deferred->length - 1;
+    NvU64 start = deferred->base;
+    bool done = false;
+
+    while (!done) {
+        NvU64 chunk_end = min(UVM_ALIGN_DOWN(start, UVM_MIGRATE_DEFERRED_CHUNK_SIZE) +
+                              UVM_MIGRATE_DEFERRED_CHUNK_SIZE - 1,
+                              end);
+        struct mm_struct *mm;
+
+        // Same lock order as the ioctl path
+        uvm_down_read(&g_uvm_global.pm.lock);
+        mm = uvm_va_space_mm_retain_lock(va_space);
+        uvm_va_space_down_read(va_space);
+
+        if (migrate_deferred_stopped(va_space))
+            status = NV_ERR_INVALID_STATE;
+        else
+            status = migrate_deferred_chunk(va_space,
+                                            mm,
+                                            deferred,
+                                            start,
+                                            chunk_end - start + 1,
+                                            &dest_gpu,
+                                            &tracker);
+
+        done = (status != NV_OK) || (chunk_end == end);
+        if (done && status != NV_ERR_INVALID_STATE)
+            migrate_deferred_release_semaphore(va_space, deferred, dest_gpu, status, &tracker);
+
+        if (done)
+            uvm_tracker_deinit(&tracker);
+        else
+            uvm_tracker_remove_completed(&tracker);
+
+        uvm_va_space_up_read(va_space);
+        uvm_va_space_mm_release_unlock(va_space, mm);
+        uvm_up_read(&g_uvm_global.pm.lock);
+
+        start = chunk_end + 1;
+    }
+
+    uvm_global_gpu_release(&deferred->retained_gpus);
+}
+
+static void migrate_deferred_process(void *args)
+{
+    uvm_va_space_t *va_space = (uvm_va_space_t *)args;
+
+    while (1) {
+        uvm_migrate_deferred_t *deferred;
+
+        uvm_spin_lock(&va_space->deferred_migrations.lock);
+        deferred = list_first_entry_or_null(&va_space->deferred_migrations.list,
+                                            uvm_migrate_deferred_t,
+                                            list_node);
+        if (deferred)
+            list_del(&deferred->list_node);
+        uvm_spin_unlock(&va_space->deferred_migrations.lock);
+
+        if (!deferred)
+            break;
+
+        migrate_deferred(va_space, deferred);
+        uvm_kvfree(deferred);
+    }
+
+    // Dispatch the events of the completed migrations like the synchronous
+    // path does.
+    uvm_tools_flush_events();
+}
+
+static void migrate_deferred_process_entry(void *args)
+{
+    UVM_ENTRY_VOID(migrate_deferred_process(args));
+}
+
+static NV_STATUS migrate_deferred_queue(uvm_va_space_t *va_space, const UVM_MIGRATE_PARAMS *params)
+{
+    uvm_migrate_deferred_t *deferred;
+    NV_STATUS status = NV_OK;
+
+    uvm_assert_rwsem_locked(&va_space->lock);
+    UVM_ASSERT(params->flags & UVM_MIGRATE_FLAG_ASYNC);
+    UVM_ASSERT(params->semaphoreAddress != 0);
+
+    deferred = uvm_kvmalloc_zero(sizeof(*deferred));
+    if (!deferred)
+        return NV_ERR_NO_MEMORY;
+
+    deferred->base = params->base;
+    deferred->length = params->length;
+    deferred->dest_uuid = params->destinationUuid;
+    deferred->flags = params->flags;
+    deferred->cpu_numa_node = (int)params->cpuNumaNode;
+    deferred->semaphore_address = params->semaphoreAddress;
+    deferred->semaphore_payload = params->semaphorePayload;
+
+    uvm_spin_lock(&va_space->deferred_migrations.lock);
+
+    if (va_space->deferred_migrations.stopped)
+        status = NV_ERR_INVALID_STATE;
+    else
+        list_add_tail(&deferred->list_node, &va_space->deferred_migrations.list);
+
+    uvm_spin_unlock(&va_space->deferred_migrations.lock);
+
+    if (status != NV_OK) {
+        uvm_kvfree(deferred);
+        return status;
+    }
+
+    // The queue item may already be pending, in which case it picks up the
+    // new migration too.
+    nv_kthread_q_schedule_q_item(&g_uvm_migrate_deferred_q, &va_space->deferred_migrations.q_item);
+
+    return NV_OK;
+}
+
+void uvm_migrate_va_space_init(uvm_va_space_t *va_space)
+{
+    uvm_spin_lock_init(&va_space->deferred_migrations.lock, UVM_LOCK_ORDER_LEAF);
+    INIT_LIST_HEAD(&va_space->deferred_migrations.list);
+    va_space->deferred_migrations.stopped = false;
+    nv_kthread_q_item_init(&va_space->deferred_migrations.q_item, migrate_deferred_process_entry, va_space);
+}
+
+void uvm_migrate_va_space_destroy(uvm_va_space_t *va_space)
+{
+    uvm_migrate_deferred_t *deferred, *deferred_next;
+    LIST_HEAD(pending);
+
+    uvm_spin_lock(&va_space->deferred_migrations.lock);
+    va_space->deferred_migrations.stopped = true;
+    list_splice_init(&va_space->deferred_migrations.list, &pending);
+    uvm_spin_unlock(&va_space->deferred_migrations.lock);
+
+    // The semaphores of the dropped migrations are not released, as the
+    // semaphore pools are about to be destroyed with the VA space.
+    list_for_each_entry_safe(deferred, deferred_next, &pending, list_node) {
+        list_del(&deferred->list_node);
+        uvm_kvfree(deferred);
+    }
+
+    // Wait for the migration in progress, which will notice that the VA space
+    // is stopped at its next chunk.
+    nv_kthread_q_flush(&g_uvm_migrate_deferred_q);
+}
+
 NV_STATUS uvm_migrate_init(void)
 {
     NV_STATUS status = uvm_migrate_pageable_init();
     if (status != NV_OK)
         return status;
 
+    status = errno_to_nv_status(nv_kthread_q_init(&g_uvm_migrate_deferred_q, "UVM deferred migrate"));
+    if (status != NV_OK) {
+        uvm_migrate_pageable_exit();
+        return status;
+    }
+
     g_uvm_perf_migrate_cpu_preunmap_enable = uvm_perf_migrate_cpu_preunmap_enable != 0;
+    g_uvm_perf_migrate_ce_stripe_enable = uvm_perf_migrate_ce_stripe_enable != 0;
 
     BUILD_BUG_ON((UVM_VA_BLOCK_SIZE) & (UVM_VA_BLOCK_SIZE - 1));
 
@@ -863,6 +1231,7 @@ NV_STATUS uvm_migrate_init(void)
 
 void uvm_migrate_exit(void)
 {
+    nv_kthread_q_stop(&g_uvm_migrate_deferred_q);
     uvm_migrate_pageable_exit();
 }
 
@@ -893,6 +1262,10 @@ NV_STATUS uvm_api_migrate(UVM_MIGRATE_PARAMS *params, struct file *filp)
     if (params->flags & ~UVM_MIGRATE_FLAGS_ALL)
         return NV_ERR_INVALID_ARGUMENT;
 
+    if ((params->flags & UVM_MIGRATE_FLAG_DEFERRED) &&
+        (synchronous || params->semaphoreAddress == 0 || params->length == 0))
+        return NV_ERR_INVALID_ARGUMENT;
+
     if ((params->flags & UVM_MIGRATE_FLAGS_TEST_ALL) && !uvm_enable_builtin_tests) {
         UVM_INFO_PRINT("Test flag set for UVM_MIGRATE. Did you mean to insmod with uvm_enable_builtin_tests=1?\n");
         UVM_INFO_PRINT("TEMP\n");
@@ -917,9 +1290,8 @@ NV_STATUS uvm_api_migrate(UVM_MIGRATE_PARAMS *params, struct file *filp)
             }
         }
         else {
-            sema_va_range = uvm_va_range_find(va_space, params->semaphoreAddress);
-            if (!IS_ALIGNED(params->semaphoreAddress, sizeof(params->semaphorePayload)) ||
-                    !sema_va_range || sema_va_range->type != UVM_VA_RANGE_TYPE_SEMAPHORE_POOL) {
+            sema_va_range = migrate_semaphore_va_range(va_space, params->semaphoreAddress);
+            if (!sema_va_range) {
                 status = NV_ERR_INVALID_ADDRESS;
                 goto done;
             }
@@ -927,11 +1299,7 @@ NV_STATUS uvm_api_migrate(UVM_MIGRATE_PARAMS *params, struct file *filp)
     }
 
     if (!uvm_uuid_is_cpu(&params->destinationUuid)) {
-        if (params->flags & UVM_MIGRATE_FLAG_NO_GPU_VA_SPACE)
-            dest_gpu = uvm_va_space_get_gpu_by_uuid(va_space, &params->destinationUuid);
-        else
-            dest_gpu = uvm_va_space_get_gpu_by_uuid_with_gpu_va_space(va_space, &params->destinationUuid);
-
+        dest_gpu = migrate_dest_gpu(va_space, &params->destinationUuid, params->flags);
         if (!dest_gpu) {
             status = NV_ERR_INVALID_DEVICE;
             goto done;
@@ -942,27 +1310,22 @@ NV_STATUS uvm_api_migrate(UVM_MIGRATE_PARAMS *params, struct file *filp)
             goto done;
         }
     }
-    else {
-        // If cpu_numa_node is not -1, we only check that it is a valid node in
-        // the system, it has memory, and it doesn't correspond to a GPU node.
-        //
-        // For pageable memory, this is fine because alloc_pages_node will clamp
-        // the allocation to cpuset_current_mems_allowed when uvm_migrate
-        //_pageable is called from process context (uvm_migrate) when dst_id is
-        // CPU. UVM bottom half calls uvm_migrate_pageable with CPU dst_id only
-        // when the VMA memory policy is set to dst_node_id and dst_node_id is
-        // not NUMA_NO_NODE.
-        if (cpu_numa_node != -1 &&
-            (!nv_numa_node_has_memory(cpu_numa_node) ||
-             !node_isset(cpu_numa_node, node_possible_map) ||
-             uvm_va_space_find_gpu_with_memory_node_id(va_space, cpu_numa_node))) {
-            status = NV_ERR_INVALID_ARGUMENT;
-            goto done;
-        }
+    else if (!migrate_cpu_numa_node_valid(va_space, cpu_numa_node)) {
+        status = NV_ERR_INVALID_ARGUMENT;
+        goto done;
     }
 
     UVM_ASSERT(status == NV_OK);
 
+    if (params->flags & UVM_MIGRATE_FLAG_DEFERRED) {
+        if (uvm_api_range_type_check(va_space, mm, params->base, params->length) != UVM_API_RANGE_TYPE_MANAGED)
+            status = NV_ERR_INVALID_ADDRESS;
+        else
+            status = migrate_deferred_queue(va_space, params);
+
+        goto done;
+    }
+
     // If we're synchronous or if we need to release a semaphore, use a tracker.
     if (synchronous || params->semaphoreAddress)
         tracker_ptr = &tracker;
@@ -1058,6 +1421,138 @@ done:
     return status;
 }
 
+// Migrate a single range of UVM_MIGRATE_BATCH. Unlike UVM_MIGRATE, pageable
+// memory that may need to be migrated by user-space is not supported.
+static NV_STATUS migrate_batch_range(uvm_va_space_t *va_space,
+                                     struct mm_struct *mm,
+                                     const UVM_MIGRATE_BATCH_RANGE *range,
+                                     NvU32 flags,
+                                     uvm_gpu_t **dest_gpu_out,
+                                     uvm_tracker_t *tracker)
+{
+    uvm_gpu_t *dest_gpu = NULL;
+    uvm_processor_id_t dest_id = UVM_ID_CPU;
+    int cpu_numa_node = (int)range->cpuNumaNode;
+    uvm_api_range_type_t type;
+
+    if (uvm_api_range_invalid(range->base, range->length))
+        return NV_ERR_INVALID_ADDRESS;
+
+    if (!uvm_uuid_is_cpu(&range->destinationUuid)) {
+        dest_gpu = migrate_dest_gpu(va_space, &range->destinationUuid, flags);
+        if (!dest_gpu)
+            return NV_ERR_INVALID_DEVICE;
+
+        if (!uvm_gpu_can_address(dest_gpu, range->base, range->length))
+            return NV_ERR_OUT_OF_RANGE;
+
+        dest_id = dest_gpu->id;
+    }
+    else if (!migrate_cpu_numa_node_valid(va_space, cpu_numa_node)) {
+        return NV_ERR_INVALID_ARGUMENT;
+    }
+
+    type = uvm_api_range_type_check(va_space, mm, range->base, range->length);
+    if (type == UVM_API_RANGE_TYPE_INVALID || type == UVM_API_RANGE_TYPE_ATS)
+        return NV_ERR_INVALID_ADDRESS;
+
+    *dest_gpu_out = dest_gpu;
+
+    return uvm_migrate(va_space,
+                       mm,
+                       range->base,
+                       range->length,
+                       dest_id,
+                       (UVM_ID_IS_CPU(dest_id) ? cpu_numa_node : NUMA_NO_NODE),
+                       flags,
+                       uvm_va_space_iter_first(va_space, range->base, range->base),
+                       tracker);
+}
+
+NV_STATUS uvm_api_migrate_batch(UVM_MIGRATE_BATCH_PARAMS *params, struct file *filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_tracker_t tracker = UVM_TRACKER_INIT();
+    uvm_gpu_t *dest_gpu = NULL;
+    uvm_va_range_t *sema_va_range = NULL;
+    struct mm_struct *mm;
+    NV_STATUS status = NV_OK;
+    NV_STATUS tracker_status;
+    const bool synchronous = !(params->flags & UVM_MIGRATE_FLAG_ASYNC);
+    NvU32 i;
+
+    params->numMigratedRanges = 0;
+
+    if (params->numRanges > UVM_MIGRATE_BATCH_MAX_RANGES)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if (params->flags & ~UVM_MIGRATE_FLAGS_ALL)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if (params->flags & UVM_MIGRATE_FLAG_DEFERRED)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if ((params->flags & UVM_MIGRATE_FLAGS_TEST_ALL) && !uvm_enable_builtin_tests) {
+        UVM_INFO_PRINT("Test flag set for UVM_MIGRATE_BATCH. "
+                       "Did you mean to insmod with uvm_enable_builtin_tests=1?\n");
+        return NV_ERR_INVALID_ARGUMENT;
+    }
+
+    if (synchronous && params->semaphoreAddress != 0)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if (params->semaphoreAddress == 0 && params->semaphorePayload != 0)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    // mmap_lock will be needed if we have to create CPU mappings
+    mm = uvm_va_space_mm_or_current_retain_lock(va_space);
+    uvm_va_space_down_read(va_space);
+
+    if (params->semaphoreAddress) {
+        sema_va_range = migrate_semaphore_va_range(va_space, params->semaphoreAddress);
+        if (!sema_va_range)
+            status = NV_ERR_INVALID_ADDRESS;
+    }
+
+    // All the ranges share the VA space lock acquisition and the tracker, so
+    // the copies of a range don't wait for those of the previous ones.
+    for (i = 0; i < params->numRanges && status == NV_OK; i++) {
+        status = migrate_batch_range(va_space, mm, &params->ranges[i], params->flags, &dest_gpu, &tracker);
+        if (status == NV_OK)
+            params->numMigratedRanges++;
+    }
+
+    // We only need to hold mmap_lock to create new CPU mappings, so drop it if
+    // we need to wait for the tracker to finish.
+    if (mm)
+        uvm_up_read_mmap_lock_out_of_order(mm);
+
+    if (sema_va_range && status == NV_OK)
+        status = semaphore_release(params->semaphoreAddress,
+                                   params->semaphorePayload,
+                                   &sema_va_range->semaphore_pool,
+                                   dest_gpu,
+                                   &tracker);
+
+    // Wait on the tracker if we are synchronous or there was an error. The VA
+    // space lock must be held to prevent GPUs from being unregistered.
+    if (synchronous || status != NV_OK) {
+        tracker_status = uvm_tracker_wait(&tracker);
+        if (status == NV_OK)
+            status = tracker_status;
+    }
+
+    uvm_tracker_deinit(&tracker);
+
+    uvm_va_space_up_read(va_space);
+    uvm_va_space_mm_or_current_release(va_space, mm);
+
+    if (synchronous || status != NV_OK)
+        uvm_tools_flush_events();
+
+    return status;
+}
+
 NV_STATUS uvm_api_migrate_range_group(UVM_MIGRATE_RANGE_GROUP_PARAMS *params, struct file *filp)
 {
     NV_STATUS status = NV_OK;
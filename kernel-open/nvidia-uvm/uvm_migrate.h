@@ -21,5 +21,30 @@
 
 *******************************************************************************/
 
+#include "uvm_forward_decl.h"
+#include "uvm_linux.h"
+#include "uvm_tracker.h"
+
 NV_STATUS uvm_migrate_init(void);
 void uvm_migrate_exit(void);
+
+// Set up and tear down the state of the migrations queued with
+// UVM_MIGRATE_FLAG_DEFERRED in the VA space. Teardown drops the queued
+// migrations and waits for the one in progress, if any, to finish.
+void uvm_migrate_va_space_init(uvm_va_space_t *va_space);
+void uvm_migrate_va_space_destroy(uvm_va_space_t *va_space);
+
+// Migrate [base, base + length), which must be fully covered by managed VA
+// ranges, to dest_gpu and map it there using the same multi-block path as
+// UVM_MIGRATE. This function does not wait for the copies: the pushed work is
+// added to out_tracker, so the caller can pipeline several migrations with a
+// shared tracker and wait for all of them at once.
+//
+// Locking: the VA space lock must be held, and mm, if not NULL, must have been
+// retained and locked with uvm_va_space_mm_retain_lock.
+NV_STATUS uvm_migrate_managed_range(uvm_va_space_t *va_space,
+                                    struct mm_struct *mm,
+                                    NvU64 base,
+                                    NvU64 length,
+                                    uvm_gpu_t *dest_gpu,
+                                    uvm_tracker_t *out_tracker);
@@ -1387,6 +1387,107 @@ static NV_STATUS test_tlb_batch_invalidates_case(uvm_page_tree_t *tree,
     return status;
 }
 
+// Contiguous ranges with the same page sizes are merged into a single range,
+// so queueing more of them than UVM_TLB_BATCH_MAX_ENTRIES doesn't fall back to
+// invalidate all.
+static NV_STATUS test_tlb_batch_invalidates_contiguous_case(uvm_page_tree_t *tree,
+                                                            NvU64 base,
+                                                            NvU64 size,
+                                                            NvU64 min_page_size,
+                                                            NvU64 max_page_size)
+{
+    uvm_push_t push;
+    uvm_tlb_batch_t batch;
+    uvm_gpu_t *gpu = tree->gpu;
+    NvU32 expected_depth = tree->hal->page_table_depth(max_page_size);
+    NvU32 count = UVM_TLB_BATCH_MAX_ENTRIES * 2;
+    NvU64 total_pages = (size / min_page_size) * count;
+    bool allow_inval_all = (total_pages > gpu->parent->tlb_batch.max_pages) ||
+                           !gpu->parent->tlb_batch.va_invalidate_supported;
+    bool result;
+    NvU32 i;
+
+    MEM_NV_CHECK_RET(uvm_push_begin_fake(gpu, &push), NV_OK);
+
+    fake_tlb_invals_enable();
+
+    uvm_tlb_batch_begin(tree, &batch);
+
+    for (i = 0; i < count; ++i)
+        uvm_tlb_batch_invalidate(&batch, base + i * size, size, min_page_size | max_page_size, UVM_MEMBAR_NONE);
+
+    uvm_tlb_batch_end(&batch, &push, UVM_MEMBAR_NONE);
+
+    result = (g_fake_invals_count == 1) && assert_invalidate_range(base,
+                                                                   size * count,
+                                                                   min_page_size,
+                                                                   allow_inval_all,
+                                                                   expected_depth,
+                                                                   expected_depth,
+                                                                   false);
+
+    fake_tlb_invals_disable();
+
+    uvm_push_end_fake(&push);
+
+    return result ? NV_OK : NV_ERR_INVALID_STATE;
+}
+
+// Same as test_tlb_batch_invalidates_contiguous_case, but with each range
+// queued up in its own batch and merged into a single one.
+static NV_STATUS test_tlb_batch_merge_contiguous_case(uvm_page_tree_t *tree,
+                                                      NvU64 base,
+                                                      NvU64 size,
+                                                      NvU64 min_page_size,
+                                                      NvU64 max_page_size)
+{
+    uvm_push_t push;
+    uvm_tlb_batch_t batch;
+    uvm_tlb_batch_t other;
+    uvm_gpu_t *gpu = tree->gpu;
+    NvU32 expected_depth = tree->hal->page_table_depth(max_page_size);
+    NvU32 count = UVM_TLB_BATCH_MAX_ENTRIES * 2;
+    NvU64 total_pages = (size / min_page_size) * count;
+    bool allow_inval_all = (total_pages > gpu->parent->tlb_batch.max_pages) ||
+                           !gpu->parent->tlb_batch.va_invalidate_supported;
+    bool result;
+    NvU32 i;
+
+    MEM_NV_CHECK_RET(uvm_push_begin_fake(gpu, &push), NV_OK);
+
+    fake_tlb_invals_enable();
+
+    uvm_tlb_batch_begin(tree, &batch);
+
+    for (i = 0; i < count; ++i) {
+        uvm_tlb_batch_begin(tree, &other);
+        uvm_tlb_batch_invalidate(&other, base + i * size, size, min_page_size | max_page_size, UVM_MEMBAR_NONE);
+        uvm_tlb_batch_merge(&batch, &other, UVM_MEMBAR_NONE);
+    }
+
+    // Merging an empty batch is a no-op
+    uvm_tlb_batch_begin(tree, &other);
+    uvm_tlb_batch_merge(&batch, &other, UVM_MEMBAR_NONE);
+
+    result = (g_fake_invals_count == 0);
+
+    uvm_tlb_batch_end(&batch, &push, UVM_MEMBAR_NONE);
+
+    result = result && (g_fake_invals_count == 1) && assert_invalidate_range(base,
+                                                                             size * count,
+                                                                             min_page_size,
+                                                                             allow_inval_all,
+                                                                             expected_depth,
+                                                                             expected_depth,
+                                                                             false);
+
+    fake_tlb_invals_disable();
+
+    uvm_push_end_fake(&push);
+
+    return result ? NV_OK : NV_ERR_INVALID_STATE;
+}
+
 static NV_STATUS test_tlb_batch_invalidates(uvm_gpu_t *gpu, const NvU64 *page_sizes, const NvU32 page_sizes_count)
 {
     NV_STATUS status = NV_OK;
@@ -1412,6 +1513,16 @@ static NV_STATUS test_tlb_batch_invalidates(uvm_gpu_t *gpu, const NvU64 *page_si
                                                                 size,
                                                                 min_page_size,
                                                                 max_page_size) == NV_OK, done);
+                TEST_CHECK_GOTO(test_tlb_batch_invalidates_contiguous_case(&tree,
+                                                                           (NvU64)min_index * max_page_size,
+                                                                           size,
+                                                                           min_page_size,
+                                                                           max_page_size) == NV_OK, done);
+                TEST_CHECK_GOTO(test_tlb_batch_merge_contiguous_case(&tree,
+                                                                     (NvU64)min_index * max_page_size,
+                                                                     size,
+                                                                     min_page_size,
+                                                                     max_page_size) == NV_OK, done);
             }
         }
     }
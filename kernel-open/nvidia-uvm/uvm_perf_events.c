@@ -53,6 +53,22 @@ static callback_desc_t *event_list_find_callback(uvm_perf_va_space_events_t *va_
     return NULL;
 }
 
+// Return the index of the callback in the static callbacks of the event, or -1
+// if not found.
+static int static_callbacks_find(uvm_perf_va_space_events_t *va_space_events,
+                                 uvm_perf_event_t event_id,
+                                 uvm_perf_event_callback_t callback)
+{
+    unsigned i;
+
+    for (i = 0; i < va_space_events->static_callbacks[event_id].count; ++i) {
+        if (va_space_events->static_callbacks[event_id].callbacks[i] == callback)
+            return i;
+    }
+
+    return -1;
+}
+
 NV_STATUS uvm_perf_register_event_callback_locked(uvm_perf_va_space_events_t *va_space_events,
                                                   uvm_perf_event_t event_id,
                                                   uvm_perf_event_callback_t callback)
@@ -68,6 +84,18 @@ NV_STATUS uvm_perf_register_event_callback_locked(uvm_perf_va_space_events_t *va
     callback_list = &va_space_events->event_callbacks[event_id];
 
     UVM_ASSERT(!event_list_find_callback(va_space_events, callback_list, callback));
+    UVM_ASSERT(static_callbacks_find(va_space_events, event_id, callback) < 0);
+
+    // No events can be notified yet, so the callback can be added to the
+    // static callbacks if there's room left. Otherwise use the list.
+    if (!va_space_events->sealed &&
+        va_space_events->static_callbacks[event_id].count < UVM_PERF_EVENT_MAX_STATIC_CALLBACKS) {
+        unsigned index = va_space_events->static_callbacks[event_id].count++;
+
+        va_space_events->static_callbacks[event_id].callbacks[index] = callback;
+
+        return NV_OK;
+    }
 
     callback_desc = kmem_cache_alloc(g_callback_desc_cache, NV_UVM_GFP_FLAGS);
     if (!callback_desc)
@@ -96,12 +124,26 @@ void uvm_perf_unregister_event_callback_locked(uvm_perf_va_space_events_t *va_sp
 {
     callback_desc_t *callback_desc;
     struct list_head *callback_list;
+    int index;
 
     UVM_ASSERT(event_id >= 0 && event_id < UVM_PERF_EVENT_COUNT);
     UVM_ASSERT(callback);
 
     uvm_assert_rwsem_locked_write(&va_space_events->lock);
 
+    index = static_callbacks_find(va_space_events, event_id, callback);
+    if (index >= 0) {
+        unsigned count = --va_space_events->static_callbacks[event_id].count;
+        uvm_perf_event_callback_t *callbacks = va_space_events->static_callbacks[event_id].callbacks;
+
+        // Static callbacks are called without the lock
+        UVM_ASSERT(!va_space_events->sealed);
+
+        // Keep the registration order
+        memmove(&callbacks[index], &callbacks[index + 1], (count - index) * sizeof(callbacks[0]));
+        return;
+    }
+
     callback_list = &va_space_events->event_callbacks[event_id];
     callback_desc = event_list_find_callback(va_space_events, callback_list, callback);
 
@@ -126,12 +168,24 @@ void uvm_perf_event_notify(uvm_perf_va_space_events_t *va_space_events, uvm_perf
 {
     callback_desc_t *callback_desc;
     struct list_head *callback_list;
+    unsigned i;
 
     UVM_ASSERT(event_id >= 0 && event_id < UVM_PERF_EVENT_COUNT);
     UVM_ASSERT(event_data);
 
+    // The static callbacks can't change while events are being notified, so
+    // they can be called without the lock.
+    for (i = 0; i < va_space_events->static_callbacks[event_id].count; ++i)
+        va_space_events->static_callbacks[event_id].callbacks[i](event_id, event_data);
+
     callback_list = &va_space_events->event_callbacks[event_id];
 
+    // Skip the lock in the common case of nothing else being registered. A
+    // callback registered concurrently with this check just misses this event,
+    // as it would if it was registered right after the notification.
+    if (list_empty(callback_list))
+        return;
+
     uvm_down_read(&va_space_events->lock);
 
     // Invoke all registered callbacks for the events
@@ -151,12 +205,31 @@ bool uvm_perf_is_event_callback_registered(uvm_perf_va_space_events_t *va_space_
 
     uvm_assert_rwsem_locked(&va_space_events->lock);
 
+    if (static_callbacks_find(va_space_events, event_id, callback) >= 0)
+        return true;
+
     callback_list = &va_space_events->event_callbacks[event_id];
     callback_desc = event_list_find_callback(va_space_events, callback_list, callback);
 
     return callback_desc != NULL;
 }
 
+void uvm_perf_seal_va_space_events(uvm_perf_va_space_events_t *va_space_events)
+{
+    uvm_assert_rwsem_locked_write(&va_space_events->va_space->lock);
+    UVM_ASSERT(!va_space_events->sealed);
+
+    va_space_events->sealed = true;
+}
+
+void uvm_perf_unseal_va_space_events(uvm_perf_va_space_events_t *va_space_events)
+{
+    uvm_assert_rwsem_locked_write(&va_space_events->va_space->lock);
+    UVM_ASSERT(va_space_events->sealed);
+
+    va_space_events->sealed = false;
+}
+
 NV_STATUS uvm_perf_init_va_space_events(uvm_va_space_t *va_space, uvm_perf_va_space_events_t *va_space_events)
 {
     unsigned event_id;
@@ -164,8 +237,12 @@ NV_STATUS uvm_perf_init_va_space_events(uvm_va_space_t *va_space, uvm_perf_va_sp
     uvm_init_rwsem(&va_space_events->lock, UVM_LOCK_ORDER_VA_SPACE_EVENTS);
 
     // Initialize event callback lists
-    for (event_id = 0; event_id < UVM_PERF_EVENT_COUNT; ++event_id)
+    for (event_id = 0; event_id < UVM_PERF_EVENT_COUNT; ++event_id) {
         INIT_LIST_HEAD(&va_space_events->event_callbacks[event_id]);
+        va_space_events->static_callbacks[event_id].count = 0;
+    }
+
+    va_space_events->sealed = false;
 
     va_space_events->va_space = va_space;
 
@@ -192,6 +269,8 @@ void uvm_perf_destroy_va_space_events(uvm_perf_va_space_events_t *va_space_event
             list_del(&callback_desc->callback_list_node);
             kmem_cache_free(g_callback_desc_cache, callback_desc);
         }
+
+        va_space_events->static_callbacks[event_id].count = 0;
     }
 
     va_space_events->va_space = NULL;
@@ -230,12 +230,16 @@ typedef union
 //             is declared in the uvm_perf_event_data_t union
 typedef void (*uvm_perf_event_callback_t)(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data);
 
+// Max number of callbacks per event that can be registered in the static
+// callback arrays. See uvm_perf_va_space_events_t.
+#define UVM_PERF_EVENT_MAX_STATIC_CALLBACKS 8
+
 typedef struct
 {
     // Lock protecting the events
     //
     // Held for write during registration/unregistration of callbacks and for
-    // read during notification of events.
+    // read during notification of events registered in event_callbacks.
     //
     // Also used by tools to protect their state and registration of perf event callbacks.
     uvm_rw_semaphore_t lock;
@@ -243,6 +247,23 @@ typedef struct
     // Array of callbacks for event notification
     struct list_head event_callbacks[UVM_PERF_EVENT_COUNT];
 
+    // Callbacks registered before the events are sealed, which in practice
+    // are the callbacks of the perf modules loaded during VA space creation.
+    // These can't change while events may be notified, so they are called
+    // directly by uvm_perf_event_notify without taking the lock or walking
+    // any list. The lock and event_callbacks are only used for the callbacks
+    // registered later, like the tools ones.
+    struct
+    {
+        uvm_perf_event_callback_t callbacks[UVM_PERF_EVENT_MAX_STATIC_CALLBACKS];
+        unsigned count;
+    } static_callbacks[UVM_PERF_EVENT_COUNT];
+
+    // Whether callbacks registered from now on go to event_callbacks, and
+    // static callbacks can't be unregistered. See
+    // uvm_perf_seal_va_space_events.
+    bool sealed;
+
     uvm_va_space_t *va_space;
 } uvm_perf_va_space_events_t;
 
@@ -252,6 +273,18 @@ NV_STATUS uvm_perf_init_va_space_events(uvm_va_space_t *va_space, uvm_perf_va_sp
 // Finalize event notifiction for a va_space. Caller must hold va_space lock in write mode
 void uvm_perf_destroy_va_space_events(uvm_perf_va_space_events_t *va_space_events);
 
+// Seal the static callbacks of the VA space events. This must be called at
+// the end of VA space creation, before any event can be notified. Callbacks
+// registered before this are notified without taking the va_space_events lock.
+// Caller must hold the va_space lock in write mode.
+void uvm_perf_seal_va_space_events(uvm_perf_va_space_events_t *va_space_events);
+
+// Allow the static callbacks to be unregistered again. This must be called
+// during VA space teardown, once no more events can be notified other than the
+// ones generated by uvm_perf_module_unload. Caller must hold the va_space lock
+// in write mode.
+void uvm_perf_unseal_va_space_events(uvm_perf_va_space_events_t *va_space_events);
+
 // Register a callback to be executed under the given event. The given callback cannot have been already registered for
 // the same event, although the same callback can be registered for different events.
 NV_STATUS uvm_perf_register_event_callback(uvm_perf_va_space_events_t *va_space_events,
@@ -272,7 +305,8 @@ void uvm_perf_unregister_event_callback_locked(uvm_perf_va_space_events_t *va_sp
                                                uvm_perf_event_callback_t callback);
 
 // Invoke the callbacks registered for the given event. Callbacks cannot fail.
-// Acquires the va_space_events lock internally
+// Acquires the va_space_events lock internally, only if any callbacks
+// were registered after the events were sealed.
 void uvm_perf_event_notify(uvm_perf_va_space_events_t *va_space_events, uvm_perf_event_t event_id,
                            uvm_perf_event_data_t *event_data);
 
@@ -78,6 +78,70 @@ done:
     return status;
 }
 
+// Check that callbacks registered before sealing the events are called
+// directly, and that those registered after are still called through the list.
+static NV_STATUS test_static_events(uvm_va_space_t *va_space)
+{
+    NV_STATUS status;
+    uvm_perf_event_data_t event_data;
+    uvm_perf_va_space_events_t *va_space_events;
+
+    va_space_events = uvm_kvmalloc_zero(sizeof(*va_space_events));
+    if (!va_space_events)
+        return NV_ERR_NO_MEMORY;
+
+    test_data = 0;
+    memset(&event_data, 0, sizeof(event_data));
+    event_data.fault.proc_id = UVM_ID_CPU;
+
+    status = uvm_perf_init_va_space_events(va_space, va_space_events);
+    if (status != NV_OK) {
+        uvm_kvfree(va_space_events);
+        return status;
+    }
+
+    uvm_va_space_down_write(va_space);
+
+    status = uvm_perf_register_event_callback(va_space_events, UVM_PERF_EVENT_FAULT, callback_inc_1);
+    TEST_CHECK_GOTO(status == NV_OK, done);
+    TEST_CHECK_GOTO(va_space_events->static_callbacks[UVM_PERF_EVENT_FAULT].count == 1, done);
+
+    uvm_perf_seal_va_space_events(va_space_events);
+
+    status = uvm_perf_register_event_callback(va_space_events, UVM_PERF_EVENT_FAULT, callback_inc_2);
+    TEST_CHECK_GOTO(status == NV_OK, done);
+    TEST_CHECK_GOTO(va_space_events->static_callbacks[UVM_PERF_EVENT_FAULT].count == 1, done);
+    TEST_CHECK_GOTO(!list_empty(&va_space_events->event_callbacks[UVM_PERF_EVENT_FAULT]), done);
+
+    uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_FAULT, &event_data);
+    TEST_CHECK_GOTO(test_data == 3, done);
+
+    // Only the static callback is left
+    uvm_perf_unregister_event_callback(va_space_events, UVM_PERF_EVENT_FAULT, callback_inc_2);
+    TEST_CHECK_GOTO(list_empty(&va_space_events->event_callbacks[UVM_PERF_EVENT_FAULT]), done);
+
+    uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_FAULT, &event_data);
+    TEST_CHECK_GOTO(test_data == 4, done);
+
+    uvm_perf_unseal_va_space_events(va_space_events);
+
+    uvm_perf_unregister_event_callback(va_space_events, UVM_PERF_EVENT_FAULT, callback_inc_1);
+    TEST_CHECK_GOTO(va_space_events->static_callbacks[UVM_PERF_EVENT_FAULT].count == 0, done);
+
+    uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_FAULT, &event_data);
+    TEST_CHECK_GOTO(test_data == 4, done);
+
+done:
+    // Destroying the events drops any callbacks left
+    uvm_perf_destroy_va_space_events(va_space_events);
+
+    uvm_va_space_up_write(va_space);
+
+    uvm_kvfree(va_space_events);
+
+    return status;
+}
+
 NV_STATUS uvm_test_perf_events_sanity(UVM_TEST_PERF_EVENTS_SANITY_PARAMS *params, struct file *filp)
 {
     NV_STATUS status;
@@ -89,6 +153,10 @@ NV_STATUS uvm_test_perf_events_sanity(UVM_TEST_PERF_EVENTS_SANITY_PARAMS *params
     if (status != NV_OK)
         goto done;
 
+    status = test_static_events(va_space);
+    if (status != NV_OK)
+        goto done;
+
 done:
     return status;
 }
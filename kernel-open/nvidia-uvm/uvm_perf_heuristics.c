@@ -25,6 +25,9 @@
 #include "uvm_perf_heuristics.h"
 #include "uvm_perf_thrashing.h"
 #include "uvm_perf_prefetch.h"
+#include "uvm_perf_stride_prefetch.h"
+#include "uvm_perf_read_mostly.h"
+#include "uvm_perf_promote.h"
 #include "uvm_gpu_access_counters.h"
 #include "uvm_va_space.h"
 
@@ -44,11 +47,26 @@ NV_STATUS uvm_perf_heuristics_init(void)
     if (status != NV_OK)
         return status;
 
+    status = uvm_perf_stride_prefetch_init();
+    if (status != NV_OK)
+        return status;
+
+    status = uvm_perf_read_mostly_init();
+    if (status != NV_OK)
+        return status;
+
+    status = uvm_perf_promote_init();
+    if (status != NV_OK)
+        return status;
+
     return NV_OK;
 }
 
 void uvm_perf_heuristics_exit(void)
 {
+    uvm_perf_promote_exit();
+    uvm_perf_read_mostly_exit();
+    uvm_perf_stride_prefetch_exit();
     uvm_perf_access_counters_exit();
     uvm_perf_thrashing_exit();
 }
@@ -75,6 +93,15 @@ NV_STATUS uvm_perf_heuristics_load(uvm_va_space_t *va_space)
     if (status != NV_OK)
         return status;
     status = uvm_perf_access_counters_load(va_space);
+    if (status != NV_OK)
+        return status;
+    status = uvm_perf_stride_prefetch_load(va_space);
+    if (status != NV_OK)
+        return status;
+    status = uvm_perf_read_mostly_load(va_space);
+    if (status != NV_OK)
+        return status;
+    status = uvm_perf_promote_load(va_space);
     if (status != NV_OK)
         return status;
 
@@ -92,7 +119,9 @@ void uvm_perf_heuristics_stop(uvm_va_space_t *va_space)
 {
     uvm_assert_lockable_order(UVM_LOCK_ORDER_VA_SPACE);
 
-    // Prefetch heuristics don't need a stop operation for now
+    // The bitmap-tree prefetch heuristics don't need a stop operation for now
+    uvm_perf_promote_stop(va_space);
+    uvm_perf_stride_prefetch_stop(va_space);
     uvm_perf_thrashing_stop(va_space);
 }
 
@@ -100,6 +129,9 @@ void uvm_perf_heuristics_unload(uvm_va_space_t *va_space)
 {
     uvm_assert_rwsem_locked_write(&va_space->lock);
 
+    uvm_perf_promote_unload(va_space);
+    uvm_perf_read_mostly_unload(va_space);
+    uvm_perf_stride_prefetch_unload(va_space);
     uvm_perf_access_counters_unload(va_space);
     uvm_perf_thrashing_unload(va_space);
 }
@@ -47,6 +47,12 @@
 // provides thrashing prevention mechanisms
 // - UVM_PERF_MODULE_TYPE_ACCESS_COUNTERS: migrates memory using access counter
 // notifications
+// - UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH: detects strided fault patterns across
+// VA blocks and prefetches the predicted blocks asynchronously
+// - UVM_PERF_MODULE_TYPE_READ_MOSTLY: detects read-mostly VA blocks and
+// read-duplicates them automatically
+// - UVM_PERF_MODULE_TYPE_PROMOTE: periodically remaps fully-resident VA blocks
+// with 2M GPU PTEs. It only uses the per-VA space data slot.
 typedef enum
 {
     UVM_PERF_MODULE_FIRST_TYPE     = 0,
@@ -54,6 +60,9 @@ typedef enum
     UVM_PERF_MODULE_TYPE_TEST      = UVM_PERF_MODULE_FIRST_TYPE,
     UVM_PERF_MODULE_TYPE_THRASHING,
     UVM_PERF_MODULE_TYPE_ACCESS_COUNTERS,
+    UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH,
+    UVM_PERF_MODULE_TYPE_READ_MOSTLY,
+    UVM_PERF_MODULE_TYPE_PROMOTE,
 
     UVM_PERF_MODULE_TYPE_COUNT,
 } uvm_perf_module_type_t;
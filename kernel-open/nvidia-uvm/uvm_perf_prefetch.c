@@ -26,9 +26,12 @@
 #include "uvm_perf_module.h"
 #include "uvm_perf_prefetch.h"
 #include "uvm_perf_utils.h"
+#include "uvm_gpu.h"
+#include "uvm_gpu_isr.h"
 #include "uvm_kvmalloc.h"
 #include "uvm_va_block.h"
 #include "uvm_va_range.h"
+#include "uvm_va_space.h"
 #include "uvm_test.h"
 
 //
@@ -55,14 +58,29 @@ static unsigned uvm_perf_prefetch_threshold  = UVM_PREFETCH_THRESHOLD_DEFAULT;
 // logic
 static unsigned uvm_perf_prefetch_min_faults = UVM_PREFETCH_MIN_FAULTS_DEFAULT;
 
+// Enable/disable deferring the migration of prefetched pages on replayable
+// faults to a per-GPU queue serviced outside of the fault batch
+static unsigned uvm_perf_prefetch_deferred = 0;
+
+#define UVM_PREFETCH_DEFERRED_QUEUE_SIZE_MIN     16
+#define UVM_PREFETCH_DEFERRED_QUEUE_SIZE_DEFAULT 256
+#define UVM_PREFETCH_DEFERRED_QUEUE_SIZE_MAX     4096
+
+// Maximum number of pending deferred prefetch requests per GPU
+static unsigned uvm_perf_prefetch_deferred_queue_size = UVM_PREFETCH_DEFERRED_QUEUE_SIZE_DEFAULT;
+
 // Module parameters for the tunables
 module_param(uvm_perf_prefetch_enable, uint, S_IRUGO);
 module_param(uvm_perf_prefetch_threshold, uint, S_IRUGO);
 module_param(uvm_perf_prefetch_min_faults, uint, S_IRUGO);
+module_param(uvm_perf_prefetch_deferred, uint, S_IRUGO);
+module_param(uvm_perf_prefetch_deferred_queue_size, uint, S_IRUGO);
 
 static bool g_uvm_perf_prefetch_enable;
 static unsigned g_uvm_perf_prefetch_threshold;
 static unsigned g_uvm_perf_prefetch_min_faults;
+static bool g_uvm_perf_prefetch_deferred;
+static unsigned g_uvm_perf_prefetch_deferred_queue_size;
 
 void uvm_perf_prefetch_bitmap_tree_iter_init(const uvm_perf_prefetch_bitmap_tree_t *bitmap_tree,
                                              uvm_page_index_t page_index,
@@ -501,6 +519,215 @@ void uvm_perf_prefetch_get_hint_va_block(uvm_va_block_t *va_block,
     }
 }
 
+static NV_STATUS prefetch_queue_block_locked(uvm_va_block_t *va_block,
+                                             uvm_va_block_retry_t *va_block_retry,
+                                             uvm_perf_prefetch_queue_t *queue,
+                                             const uvm_perf_prefetch_request_t *request)
+{
+    uvm_va_block_context_t *block_context = queue->block_context;
+    uvm_va_policy_t *policy = uvm_va_range_get_policy(va_block->va_range);
+    uvm_page_mask_t *pages = &block_context->caller_page_mask;
+    NV_STATUS status;
+
+    // The policy may have changed since the request was posted
+    if (policy->read_duplication != UVM_READ_DUPLICATION_DISABLED ||
+        (UVM_ID_IS_VALID(policy->preferred_location) &&
+         !uvm_id_equal(policy->preferred_location, request->residency)))
+        return NV_OK;
+
+    if (!uvm_page_mask_andnot(pages,
+                              &request->pages,
+                              uvm_va_block_resident_mask_get(va_block, request->residency, NUMA_NO_NODE)))
+        return NV_OK;
+
+    status = uvm_va_block_make_resident(va_block,
+                                        va_block_retry,
+                                        block_context,
+                                        request->residency,
+                                        uvm_va_block_region_from_mask(va_block, pages),
+                                        pages,
+                                        NULL,
+                                        UVM_MAKE_RESIDENT_CAUSE_PREFETCH);
+    if (status != NV_OK)
+        return status;
+
+    return uvm_tracker_add_tracker_safe(&queue->tracker, &va_block->tracker);
+}
+
+// Service a deferred prefetch request. Prefetching is best-effort, so errors
+// are ignored.
+static void prefetch_queue_service_request(uvm_perf_prefetch_queue_t *queue,
+                                           const uvm_perf_prefetch_request_t *request)
+{
+    uvm_va_space_t *va_space = request->va_space;
+    uvm_va_block_retry_t va_block_retry;
+    uvm_va_block_t *va_block;
+    NV_STATUS status;
+
+    uvm_va_space_down_read(va_space);
+
+    // The GPU may have been unregistered from the VA space, which also happens
+    // during VA space teardown
+    if (!uvm_processor_mask_test(&va_space->registered_gpu_va_spaces, request->residency))
+        goto done;
+
+    status = uvm_va_block_find(va_space, request->block_start, &va_block);
+    if (status != NV_OK || va_block->start != request->block_start || uvm_va_block_is_hmm(va_block))
+        goto done;
+
+    if (!uvm_range_group_all_migratable(va_space, va_block->start, va_block->end))
+        goto done;
+
+    uvm_va_block_context_init(queue->block_context, NULL);
+
+    status = UVM_VA_BLOCK_LOCK_RETRY(va_block,
+                                     &va_block_retry,
+                                     prefetch_queue_block_locked(va_block, &va_block_retry, queue, request));
+    if (status == NV_OK)
+        ++queue->stats.num_serviced;
+
+done:
+    uvm_va_space_up_read(va_space);
+}
+
+static void prefetch_queue_service(void *args)
+{
+    uvm_perf_prefetch_queue_t *queue = (uvm_perf_prefetch_queue_t *)args;
+
+    while (1) {
+        uvm_perf_prefetch_request_t request;
+        bool found = false;
+
+        uvm_spin_lock(&queue->lock);
+
+        if (queue->count > 0) {
+            request = queue->requests[queue->head];
+            queue->head = (queue->head + 1) % queue->max_requests;
+            --queue->count;
+            found = true;
+        }
+
+        uvm_spin_unlock(&queue->lock);
+
+        if (!found)
+            break;
+
+        prefetch_queue_service_request(queue, &request);
+    }
+
+    // Wait for the copies pushed by this run so that the amount of speculative
+    // work in flight stays bounded. The copy work is also tracked by the VA
+    // blocks, so subsequent faults on them wait for it as needed.
+    (void)uvm_tracker_wait(&queue->tracker);
+}
+
+static void prefetch_queue_service_entry(void *args)
+{
+    UVM_ENTRY_VOID(prefetch_queue_service(args));
+}
+
+NV_STATUS uvm_perf_prefetch_queue_init(uvm_perf_prefetch_queue_t *queue, uvm_parent_gpu_t *parent_gpu)
+{
+    char kthread_name[TASK_COMM_LEN + 1];
+    NV_STATUS status;
+
+    if (!g_uvm_perf_prefetch_enable || !g_uvm_perf_prefetch_deferred)
+        return NV_OK;
+
+    uvm_spin_lock_init(&queue->lock, UVM_LOCK_ORDER_LEAF);
+    uvm_tracker_init(&queue->tracker);
+
+    queue->max_requests = g_uvm_perf_prefetch_deferred_queue_size;
+    queue->requests = uvm_kvmalloc_zero(sizeof(*queue->requests) * queue->max_requests);
+    if (!queue->requests)
+        return NV_ERR_NO_MEMORY;
+
+    queue->block_context = uvm_va_block_context_alloc(NULL);
+    if (!queue->block_context)
+        return NV_ERR_NO_MEMORY;
+
+    nv_kthread_q_item_init(&queue->q_item, prefetch_queue_service_entry, queue);
+
+    snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u PF", uvm_parent_id_value(parent_gpu->id));
+    status = uvm_kthread_q_init_on_node(&queue->q, kthread_name, parent_gpu->closest_cpu_numa_node);
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("Failed in nv_kthread_q_init for prefetch queue: %s, GPU %s\n",
+                      nvstatusToString(status),
+                      uvm_parent_gpu_name(parent_gpu));
+        return status;
+    }
+
+    // Prefetches are speculative, so the queue thread runs at the lowest
+    // priority to stay out of the way of the fault servicing threads.
+    set_user_nice(queue->q.q_kthread, 19);
+
+    queue->enabled = true;
+
+    return NV_OK;
+}
+
+void uvm_perf_prefetch_queue_deinit(uvm_perf_prefetch_queue_t *queue)
+{
+    queue->enabled = false;
+
+    nv_kthread_q_stop(&queue->q);
+
+    if (queue->block_context) {
+        uvm_va_block_context_free(queue->block_context);
+        queue->block_context = NULL;
+    }
+
+    if (queue->requests) {
+        uvm_tracker_deinit(&queue->tracker);
+        uvm_kvfree(queue->requests);
+        queue->requests = NULL;
+    }
+}
+
+void uvm_perf_prefetch_queue_flush(uvm_perf_prefetch_queue_t *queue)
+{
+    if (queue->enabled)
+        nv_kthread_q_flush(&queue->q);
+}
+
+bool uvm_perf_prefetch_queue_post(uvm_perf_prefetch_queue_t *queue,
+                                  uvm_va_block_t *va_block,
+                                  uvm_processor_id_t residency,
+                                  const uvm_page_mask_t *pages)
+{
+    uvm_perf_prefetch_request_t *request;
+    bool posted = false;
+
+    uvm_assert_mutex_locked(&va_block->lock);
+
+    if (!queue->enabled || uvm_va_block_is_hmm(va_block))
+        return false;
+
+    uvm_spin_lock(&queue->lock);
+
+    if (queue->count < queue->max_requests) {
+        request = &queue->requests[(queue->head + queue->count) % queue->max_requests];
+        request->va_space = uvm_va_block_get_va_space(va_block);
+        request->block_start = va_block->start;
+        request->residency = residency;
+        uvm_page_mask_copy(&request->pages, pages);
+
+        ++queue->count;
+        ++queue->stats.num_posted;
+        posted = true;
+    }
+    else {
+        ++queue->stats.num_full;
+    }
+
+    uvm_spin_unlock(&queue->lock);
+
+    if (posted)
+        nv_kthread_q_schedule_q_item(&queue->q, &queue->q_item);
+
+    return posted;
+}
+
 NV_STATUS uvm_perf_prefetch_init(void)
 {
     g_uvm_perf_prefetch_enable = uvm_perf_prefetch_enable != 0;
@@ -508,6 +735,19 @@ NV_STATUS uvm_perf_prefetch_init(void)
     if (!g_uvm_perf_prefetch_enable)
         return NV_OK;
 
+    g_uvm_perf_prefetch_deferred = uvm_perf_prefetch_deferred != 0;
+
+    if (uvm_perf_prefetch_deferred_queue_size >= UVM_PREFETCH_DEFERRED_QUEUE_SIZE_MIN &&
+        uvm_perf_prefetch_deferred_queue_size <= UVM_PREFETCH_DEFERRED_QUEUE_SIZE_MAX) {
+        g_uvm_perf_prefetch_deferred_queue_size = uvm_perf_prefetch_deferred_queue_size;
+    }
+    else {
+        pr_info("Invalid value %u for uvm_perf_prefetch_deferred_queue_size. Using %u instead\n",
+                uvm_perf_prefetch_deferred_queue_size, UVM_PREFETCH_DEFERRED_QUEUE_SIZE_DEFAULT);
+
+        g_uvm_perf_prefetch_deferred_queue_size = UVM_PREFETCH_DEFERRED_QUEUE_SIZE_DEFAULT;
+    }
+
     if (uvm_perf_prefetch_threshold <= 100) {
         g_uvm_perf_prefetch_threshold = uvm_perf_prefetch_threshold;
     }
@@ -550,3 +790,133 @@ NV_STATUS uvm_test_set_page_prefetch_policy(UVM_TEST_SET_PAGE_PREFETCH_POLICY_PA
 
     return NV_OK;
 }
+
+typedef struct
+{
+    uvm_page_mask_t resident;
+
+    uvm_page_mask_t faulted;
+
+    uvm_page_mask_t prefetch;
+
+    uvm_perf_prefetch_bitmap_tree_t bitmap_tree;
+
+    // Serviced faults since the start of the trace, like
+    // prefetch_info.fault_migrations_to_last_proc of a VA block
+    NvU32 fault_migrations;
+} prefetch_replay_state_t;
+
+// Service the faults accumulated in state->faulted in the same way
+// uvm_perf_prefetch_get_hint_va_block() does for a block without thrashing
+// pages, and make them resident together with the pages to prefetch.
+//
+// The block is assumed to start at a VA block aligned address and to migrate
+// to a processor with 64K big pages, so the big pages start at the first page
+// of the block and the bitmap tree needs no offset.
+static void prefetch_replay_service_batch(prefetch_replay_state_t *state,
+                                          uvm_va_block_region_t block_region,
+                                          bool prefetch_enabled,
+                                          UVM_TEST_PREFETCH_REPLAY_PARAMS *params)
+{
+    uvm_va_block_region_t big_pages_region;
+    NvU32 faulted_count;
+
+    uvm_page_mask_andnot(&state->faulted, &state->faulted, &state->resident);
+    faulted_count = uvm_page_mask_weight(&state->faulted);
+    if (faulted_count == 0)
+        return;
+
+    params->serviced_faults += faulted_count;
+    params->serviced_batches++;
+    state->fault_migrations += faulted_count;
+
+    if (prefetch_enabled) {
+        init_bitmap_tree_from_region(&state->bitmap_tree, block_region, &state->resident, &state->faulted);
+
+        big_pages_region = uvm_va_block_region(block_region.first,
+                                               UVM_ALIGN_DOWN(block_region.outer, UVM_PAGE_SIZE_64K / PAGE_SIZE));
+        grow_fault_granularity(&state->bitmap_tree,
+                               UVM_PAGE_SIZE_64K,
+                               big_pages_region,
+                               block_region,
+                               &state->faulted,
+                               NULL);
+
+        compute_prefetch_mask(block_region, block_region, &state->bitmap_tree, &state->faulted, &state->prefetch);
+
+        uvm_page_mask_andnot(&state->prefetch, &state->prefetch, &state->faulted);
+        uvm_page_mask_andnot(&state->prefetch, &state->prefetch, &state->resident);
+
+        if (state->fault_migrations >= g_uvm_perf_prefetch_min_faults) {
+            params->prefetched_pages += uvm_page_mask_weight(&state->prefetch);
+            uvm_page_mask_or(&state->resident, &state->resident, &state->prefetch);
+        }
+    }
+
+    uvm_page_mask_or(&state->resident, &state->resident, &state->faulted);
+    uvm_page_mask_zero(&state->faulted);
+}
+
+NV_STATUS uvm_test_prefetch_replay(UVM_TEST_PREFETCH_REPLAY_PARAMS *params, struct file *filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    const NvU32 __user *trace = (const NvU32 __user *)params->trace;
+    prefetch_replay_state_t *state;
+    uvm_va_block_region_t block_region;
+    NvU32 entries[64];
+    bool prefetch_enabled;
+    NV_STATUS status = NV_OK;
+    NvU32 i;
+
+    if (params->block_pages == 0 || params->block_pages > PAGES_PER_UVM_VA_BLOCK || params->batch_size == 0)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    state = uvm_kvmalloc_zero(sizeof(*state));
+    if (!state)
+        return NV_ERR_NO_MEMORY;
+
+    // The VA space lock is not held while replaying, since copying the trace
+    // may fault.
+    uvm_va_space_down_read(va_space);
+    prefetch_enabled = uvm_perf_prefetch_enabled(va_space);
+    uvm_va_space_up_read(va_space);
+
+    block_region = uvm_va_block_region(0, params->block_pages);
+
+    params->serviced_faults = 0;
+    params->serviced_batches = 0;
+    params->prefetched_pages = 0;
+
+    for (i = 0; i < params->trace_length; i++) {
+        NvU32 entry_index = i % ARRAY_SIZE(entries);
+
+        if (entry_index == 0) {
+            NvU32 count = min_t(NvU32, params->trace_length - i, ARRAY_SIZE(entries));
+
+            if (nv_copy_from_user(entries, trace + i, count * sizeof(entries[0]))) {
+                status = NV_ERR_INVALID_ADDRESS;
+                goto done;
+            }
+
+            cond_resched();
+        }
+
+        if (entries[entry_index] >= params->block_pages) {
+            status = NV_ERR_INVALID_ARGUMENT;
+            goto done;
+        }
+
+        uvm_page_mask_set(&state->faulted, entries[entry_index]);
+
+        if ((i + 1) % params->batch_size == 0)
+            prefetch_replay_service_batch(state, block_region, prefetch_enabled, params);
+    }
+
+    // Service the last, partial batch
+    prefetch_replay_service_batch(state, block_region, prefetch_enabled, params);
+
+done:
+    uvm_kvfree(state);
+
+    return status;
+}
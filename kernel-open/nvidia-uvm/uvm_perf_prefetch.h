@@ -25,8 +25,11 @@
 #define __UVM_PERF_PREFETCH_H__
 
 #include "uvm_linux.h"
+#include "uvm_lock.h"
 #include "uvm_processors.h"
+#include "uvm_tracker.h"
 #include "uvm_va_block_types.h"
+#include "nv-kthread-q.h"
 
 typedef struct
 {
@@ -58,9 +61,93 @@ typedef struct
     uvm_page_index_t node_idx;
 } uvm_perf_prefetch_bitmap_tree_iter_t;
 
+// Pending deferred prefetch of a set of pages in a VA block
+typedef struct
+{
+    uvm_va_space_t *va_space;
+
+    // The VA block is looked up again when the request is serviced, since it
+    // may have been destroyed or split in the meantime.
+    NvU64 block_start;
+
+    uvm_processor_id_t residency;
+
+    uvm_page_mask_t pages;
+} uvm_perf_prefetch_request_t;
+
+// Per-GPU queue of prefetch hints whose migrations are deferred out of the
+// fault servicing path. Requests are posted by the fault servicing code and
+// drained by a dedicated low-priority kthread, so speculative copies do not
+// delay the replay of the faulting batch.
+typedef struct
+{
+    // Whether deferred prefetching is enabled for this GPU
+    bool enabled;
+
+    // Protects the circular request queue and the stats
+    uvm_spinlock_t lock;
+
+    uvm_perf_prefetch_request_t *requests;
+
+    NvU32 max_requests;
+
+    NvU32 head;
+
+    NvU32 count;
+
+    nv_kthread_q_t q;
+
+    nv_kthread_q_item_t q_item;
+
+    // Only used by the queue thread. Aggregates the work pushed to service
+    // the requests drained in one run of the queue thread, which waits for it
+    // before returning.
+    uvm_tracker_t tracker;
+
+    uvm_va_block_context_t *block_context;
+
+    struct
+    {
+        NvU64 num_posted;
+
+        // Requests dropped because the queue was full. Those pages are
+        // prefetched inline by the fault servicing code instead.
+        NvU64 num_full;
+
+        // Updated only by the queue thread
+        NvU64 num_serviced;
+    } stats;
+} uvm_perf_prefetch_queue_t;
+
 // Global initialization function (no clean up needed).
 NV_STATUS uvm_perf_prefetch_init(void);
 
+// Initialize the deferred prefetch queue of the given GPU. This is a no-op
+// returning NV_OK if deferred prefetching is disabled.
+NV_STATUS uvm_perf_prefetch_queue_init(uvm_perf_prefetch_queue_t *queue, uvm_parent_gpu_t *parent_gpu);
+
+// Flush all pending requests and stop the queue thread. It is safe to call
+// this function even if uvm_perf_prefetch_queue_init failed or was never
+// called on the zero-initialized queue.
+void uvm_perf_prefetch_queue_deinit(uvm_perf_prefetch_queue_t *queue);
+
+// Wait for all pending requests to be serviced. This must be called before a
+// VA space that may have posted requests is freed.
+//
+// Locking: The caller must not hold any VA space lock.
+void uvm_perf_prefetch_queue_flush(uvm_perf_prefetch_queue_t *queue);
+
+// Post a request to make the given pages of va_block resident on residency.
+// Returns false if the queue is disabled or full, in which case the caller
+// must service the prefetch inline. Requests are only accepted for managed
+// VA blocks.
+//
+// Locking: The caller must hold the va_space lock and va_block lock.
+bool uvm_perf_prefetch_queue_post(uvm_perf_prefetch_queue_t *queue,
+                                  uvm_va_block_t *va_block,
+                                  uvm_processor_id_t residency,
+                                  const uvm_page_mask_t *pages);
+
 // Returns whether prefetching is enabled in the VA space.
 // va_space cannot be NULL.
 bool uvm_perf_prefetch_enabled(uvm_va_space_t *va_space);
@@ -0,0 +1,295 @@
+/*******************************************************************************
+    Copyright (c) 2024 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "uvm_linux.h"
+#include "uvm_perf_module.h"
+#include "uvm_perf_promote.h"
+#include "uvm_gpu.h"
+#include "uvm_kvmalloc.h"
+#include "uvm_va_block.h"
+#include "uvm_va_range.h"
+#include "uvm_va_space.h"
+
+//
+// Tunables for 2M GPU mapping promotion (configurable via module parameters)
+//
+
+#define UVM_PERF_PROMOTE_ENABLE_DEFAULT 0
+
+// Enable/disable the background promotion of GPU mappings to 2M PTEs
+static unsigned uvm_perf_promote_enable = UVM_PERF_PROMOTE_ENABLE_DEFAULT;
+
+#define UVM_PERF_PROMOTE_PERIOD_MSEC_DEFAULT 1000
+#define UVM_PERF_PROMOTE_PERIOD_MSEC_MIN     10
+#define UVM_PERF_PROMOTE_PERIOD_MSEC_MAX     60000
+
+// Time between consecutive scans of a VA space
+static unsigned uvm_perf_promote_period_msec = UVM_PERF_PROMOTE_PERIOD_MSEC_DEFAULT;
+
+#define UVM_PERF_PROMOTE_MAX_BLOCKS_DEFAULT 64
+#define UVM_PERF_PROMOTE_MAX_BLOCKS_MAX     4096
+
+// Maximum number of VA blocks inspected by each scan. The next scan resumes
+// where the previous one stopped.
+static unsigned uvm_perf_promote_max_blocks = UVM_PERF_PROMOTE_MAX_BLOCKS_DEFAULT;
+
+// Module parameters for the tunables
+module_param(uvm_perf_promote_enable, uint, S_IRUGO);
+module_param(uvm_perf_promote_period_msec, uint, S_IRUGO);
+module_param(uvm_perf_promote_max_blocks, uint, S_IRUGO);
+
+static bool g_uvm_perf_promote_enable;
+static unsigned g_uvm_perf_promote_period_msec;
+static unsigned g_uvm_perf_promote_max_blocks;
+
+// Per-VA space promotion state
+typedef struct
+{
+    uvm_va_space_t *va_space;
+
+    // Work item that performs the periodic scans
+    struct delayed_work dwork;
+
+    // Set during VA space teardown to prevent further work from being
+    // scheduled. Protected by the VA space lock.
+    bool in_va_space_teardown;
+
+    // Address at which the next scan starts. Only used by the work item.
+    NvU64 next_addr;
+
+    // Only used by the work item
+    uvm_va_block_context_t *va_block_context;
+} va_space_promote_info_t;
+
+static va_space_promote_info_t *va_space_promote_info_get_or_null(uvm_va_space_t *va_space)
+{
+    return uvm_perf_module_type_data(va_space->perf_modules_data, UVM_PERF_MODULE_TYPE_PROMOTE);
+}
+
+static NV_STATUS promote_block_locked(uvm_va_block_t *va_block, uvm_va_block_context_t *va_block_context)
+{
+    uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
+    NV_STATUS status = NV_OK;
+    uvm_gpu_t *gpu;
+
+    // Skip blocks with pending operations to avoid delaying them
+    if (!uvm_tracker_is_completed(&va_block->tracker))
+        return NV_OK;
+
+    for_each_va_space_gpu_in_mask(gpu, va_space, &va_space->registered_gpu_va_spaces) {
+        bool promoted;
+
+        // Mappings of UVM-Lite GPUs always point to the preferred location and
+        // are managed separately
+        if (uvm_processor_mask_test(&va_block->va_range->uvm_lite_gpus, gpu->id))
+            continue;
+
+        status = uvm_va_block_gpu_promote_2m(va_block, va_block_context, gpu, &promoted);
+        if (status != NV_OK) {
+            atomic64_inc(&gpu->big_page_promotion.num_failed);
+            break;
+        }
+
+        if (promoted)
+            atomic64_inc(&gpu->big_page_promotion.num_promoted_blocks);
+    }
+
+    return status;
+}
+
+// Inspect up to g_uvm_perf_promote_max_blocks existing VA blocks of managed
+// VA ranges, starting at va_space_promote->next_addr.
+static void promote_scan(va_space_promote_info_t *va_space_promote)
+{
+    uvm_va_space_t *va_space = va_space_promote->va_space;
+    uvm_va_block_context_t *va_block_context = va_space_promote->va_block_context;
+    uvm_va_range_t *va_range;
+    unsigned num_scanned = 0;
+
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    uvm_for_each_va_range_in(va_range, va_space, va_space_promote->next_addr, ULLONG_MAX) {
+        size_t block_index;
+        size_t num_blocks;
+
+        if (va_range->type != UVM_VA_RANGE_TYPE_MANAGED)
+            continue;
+
+        num_blocks = uvm_va_range_num_blocks(va_range);
+        block_index = uvm_va_range_block_index(va_range, max(va_range->node.start, va_space_promote->next_addr));
+
+        for (; block_index < num_blocks; ++block_index) {
+            uvm_va_block_t *va_block = uvm_va_range_block(va_range, block_index);
+            uvm_va_block_retry_t va_block_retry;
+
+            if (num_scanned == g_uvm_perf_promote_max_blocks)
+                return;
+
+            if (!va_block)
+                continue;
+
+            ++num_scanned;
+            va_space_promote->next_addr = va_block->end + 1;
+
+            if (uvm_va_block_size(va_block) != UVM_PAGE_SIZE_2M)
+                continue;
+
+            uvm_va_block_context_init(va_block_context, NULL);
+
+            // Promotion is best-effort, so errors are ignored
+            (void)UVM_VA_BLOCK_LOCK_RETRY(va_block,
+                                          &va_block_retry,
+                                          promote_block_locked(va_block, va_block_context));
+        }
+
+        va_space_promote->next_addr = va_range->node.end + 1;
+
+        // The end of the VA space was reached
+        if (va_space_promote->next_addr == 0)
+            return;
+    }
+
+    // Wrap around
+    va_space_promote->next_addr = 0;
+}
+
+static void promote_work(struct work_struct *work)
+{
+    va_space_promote_info_t *va_space_promote = container_of(work, va_space_promote_info_t, dwork.work);
+    uvm_va_space_t *va_space = va_space_promote->va_space;
+
+    // Take the VA space lock so that VA ranges and GPUs don't go away during
+    // this operation
+    uvm_va_space_down_read(va_space);
+
+    if (!va_space_promote->in_va_space_teardown) {
+        promote_scan(va_space_promote);
+
+        schedule_delayed_work(&va_space_promote->dwork, msecs_to_jiffies(g_uvm_perf_promote_period_msec));
+    }
+
+    uvm_va_space_up_read(va_space);
+}
+
+static void promote_work_entry(struct work_struct *work)
+{
+    UVM_ENTRY_VOID(promote_work(work));
+}
+
+NV_STATUS uvm_perf_promote_load(uvm_va_space_t *va_space)
+{
+    va_space_promote_info_t *va_space_promote;
+
+    uvm_assert_rwsem_locked_write(&va_space->lock);
+
+    if (!g_uvm_perf_promote_enable)
+        return NV_OK;
+
+    va_space_promote = uvm_kvmalloc_zero(sizeof(*va_space_promote));
+    if (!va_space_promote)
+        return NV_ERR_NO_MEMORY;
+
+    va_space_promote->va_block_context = uvm_va_block_context_alloc(NULL);
+    if (!va_space_promote->va_block_context) {
+        uvm_kvfree(va_space_promote);
+        return NV_ERR_NO_MEMORY;
+    }
+
+    va_space_promote->va_space = va_space;
+    INIT_DELAYED_WORK(&va_space_promote->dwork, promote_work_entry);
+
+    uvm_perf_module_type_set_data(va_space->perf_modules_data, va_space_promote, UVM_PERF_MODULE_TYPE_PROMOTE);
+
+    schedule_delayed_work(&va_space_promote->dwork, msecs_to_jiffies(g_uvm_perf_promote_period_msec));
+
+    return NV_OK;
+}
+
+void uvm_perf_promote_stop(uvm_va_space_t *va_space)
+{
+    va_space_promote_info_t *va_space_promote;
+
+    uvm_va_space_down_write(va_space);
+
+    va_space_promote = va_space_promote_info_get_or_null(va_space);
+
+    // Prevent the work item from being rescheduled
+    if (va_space_promote)
+        va_space_promote->in_va_space_teardown = true;
+
+    uvm_va_space_up_write(va_space);
+
+    // va_space_promote can be safely accessed because it is only freed by
+    // uvm_perf_promote_unload, which is called later in the teardown path.
+    if (va_space_promote)
+        (void)cancel_delayed_work_sync(&va_space_promote->dwork);
+}
+
+void uvm_perf_promote_unload(uvm_va_space_t *va_space)
+{
+    va_space_promote_info_t *va_space_promote;
+
+    uvm_assert_rwsem_locked_write(&va_space->lock);
+
+    va_space_promote = va_space_promote_info_get_or_null(va_space);
+    if (va_space_promote) {
+        uvm_perf_module_type_unset_data(va_space->perf_modules_data, UVM_PERF_MODULE_TYPE_PROMOTE);
+        uvm_va_block_context_free(va_space_promote->va_block_context);
+        uvm_kvfree(va_space_promote);
+    }
+}
+
+#define INIT_PROMOTE_PARAMETER_MIN_MAX(_v, _d, _mi, _ma)                        \
+    do {                                                                        \
+        if ((_v) >= (_mi) && (_v) <= (_ma)) {                                   \
+            g_##_v = (_v);                                                      \
+        }                                                                       \
+        else {                                                                  \
+            pr_info("Invalid value %u for " #_v ". Using %u instead\n",         \
+                    (_v), (unsigned)(_d));                                      \
+            g_##_v = (_d);                                                      \
+        }                                                                       \
+    } while (0)
+
+NV_STATUS uvm_perf_promote_init(void)
+{
+    g_uvm_perf_promote_enable = uvm_perf_promote_enable != 0;
+    if (!g_uvm_perf_promote_enable)
+        return NV_OK;
+
+    INIT_PROMOTE_PARAMETER_MIN_MAX(uvm_perf_promote_period_msec,
+                                   UVM_PERF_PROMOTE_PERIOD_MSEC_DEFAULT,
+                                   UVM_PERF_PROMOTE_PERIOD_MSEC_MIN,
+                                   UVM_PERF_PROMOTE_PERIOD_MSEC_MAX);
+
+    INIT_PROMOTE_PARAMETER_MIN_MAX(uvm_perf_promote_max_blocks,
+                                   UVM_PERF_PROMOTE_MAX_BLOCKS_DEFAULT,
+                                   1u,
+                                   UVM_PERF_PROMOTE_MAX_BLOCKS_MAX);
+
+    return NV_OK;
+}
+
+void uvm_perf_promote_exit(void)
+{
+}
@@ -0,0 +1,51 @@
+/*******************************************************************************
+    Copyright (c) 2024 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef __UVM_PERF_PROMOTE_H__
+#define __UVM_PERF_PROMOTE_H__
+
+#include "uvm_linux.h"
+#include "uvm_forward_decl.h"
+
+// GPU mappings of a VA block use 4K, big or 2M PTEs depending on the residency
+// and protections of its pages when each mapping operation is performed. A
+// block that is populated and mapped piecewise (for example when pages are
+// made resident by a prefetch without being mapped, or faulted with different
+// access types) may remain mapped with a mix of smaller PTEs even after the
+// whole block is resident in a single 2M chunk. The promotion work
+// periodically scans the VA space and remaps such blocks with a single 2M PTE
+// using uvm_va_block_gpu_promote_2m(), which reduces TLB pressure on long
+// running workloads. The scan is rate-limited to a number of blocks per
+// period to bound the time spent holding the VA space lock.
+
+// Global initialization/cleanup functions
+NV_STATUS uvm_perf_promote_init(void);
+void uvm_perf_promote_exit(void);
+
+// VA space Initialization/cleanup functions. See comments in
+// uvm_perf_heuristics.h
+NV_STATUS uvm_perf_promote_load(uvm_va_space_t *va_space);
+void uvm_perf_promote_stop(uvm_va_space_t *va_space);
+void uvm_perf_promote_unload(uvm_va_space_t *va_space);
+
+#endif
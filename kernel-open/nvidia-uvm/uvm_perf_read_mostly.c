@@ -0,0 +1,273 @@
+/*******************************************************************************
+    Copyright (c) 2024 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "uvm_linux.h"
+#include "uvm_perf_events.h"
+#include "uvm_perf_module.h"
+#include "uvm_perf_read_mostly.h"
+#include "uvm_kvmalloc.h"
+#include "uvm_va_block.h"
+#include "uvm_va_policy.h"
+#include "uvm_va_space.h"
+
+//
+// Tunables for read-mostly detection (configurable via module parameters)
+//
+
+#define UVM_PERF_READ_MOSTLY_ENABLE_DEFAULT 0
+
+// Enable/disable automatic read duplication of read-mostly VA blocks
+static unsigned uvm_perf_read_mostly_enable = UVM_PERF_READ_MOSTLY_ENABLE_DEFAULT;
+
+#define UVM_PERF_READ_MOSTLY_THRESHOLD_DEFAULT 8
+#define UVM_PERF_READ_MOSTLY_THRESHOLD_MAX     1024
+
+// Number of read faults that must be observed on a VA block since the last
+// write fault before the block is considered read-mostly
+static unsigned uvm_perf_read_mostly_threshold = UVM_PERF_READ_MOSTLY_THRESHOLD_DEFAULT;
+
+#define UVM_PERF_READ_MOSTLY_MIN_READERS_DEFAULT 2
+
+// Number of distinct processors that must have read the VA block since the
+// last write fault before the block is considered read-mostly
+static unsigned uvm_perf_read_mostly_min_readers = UVM_PERF_READ_MOSTLY_MIN_READERS_DEFAULT;
+
+// Module parameters for the tunables
+module_param(uvm_perf_read_mostly_enable, uint, S_IRUGO);
+module_param(uvm_perf_read_mostly_threshold, uint, S_IRUGO);
+module_param(uvm_perf_read_mostly_min_readers, uint, S_IRUGO);
+
+static bool g_uvm_perf_read_mostly_enable;
+static unsigned g_uvm_perf_read_mostly_threshold;
+static unsigned g_uvm_perf_read_mostly_min_readers;
+
+// Per-VA block read-mostly tracking state. Protected by the block lock.
+typedef struct
+{
+    // Processors that faulted for reading on the block since the last write
+    // fault
+    uvm_processor_mask_t readers;
+
+    // Number of read faults since the last write fault. Saturates at
+    // g_uvm_perf_read_mostly_threshold.
+    NvU16 num_read_faults;
+
+    // Set once the block has been detected as read-mostly. Cleared by the
+    // next write fault.
+    bool is_read_mostly;
+} block_read_mostly_info_t;
+
+static struct kmem_cache *g_va_block_read_mostly_info_cache __read_mostly;
+
+static uvm_perf_module_t g_module_read_mostly;
+
+static void read_mostly_fault_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data);
+static void read_mostly_block_destroy_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data);
+
+static uvm_perf_module_event_callback_desc_t g_callbacks_read_mostly[] = {
+    { UVM_PERF_EVENT_BLOCK_DESTROY, read_mostly_block_destroy_cb },
+    { UVM_PERF_EVENT_MODULE_UNLOAD, read_mostly_block_destroy_cb },
+    { UVM_PERF_EVENT_BLOCK_SHRINK , read_mostly_block_destroy_cb },
+    { UVM_PERF_EVENT_FAULT,         read_mostly_fault_cb         },
+};
+
+static block_read_mostly_info_t *read_mostly_info_get(uvm_va_block_t *va_block)
+{
+    uvm_assert_mutex_locked(&va_block->lock);
+    return uvm_perf_module_type_data(va_block->perf_modules_data, UVM_PERF_MODULE_TYPE_READ_MOSTLY);
+}
+
+static block_read_mostly_info_t *read_mostly_info_get_create(uvm_va_block_t *va_block)
+{
+    block_read_mostly_info_t *block_read_mostly = read_mostly_info_get(va_block);
+
+    BUILD_BUG_ON((1 << 8 * sizeof(block_read_mostly->num_read_faults)) <= UVM_PERF_READ_MOSTLY_THRESHOLD_MAX);
+
+    if (!block_read_mostly) {
+        block_read_mostly = nv_kmem_cache_zalloc(g_va_block_read_mostly_info_cache, NV_UVM_GFP_FLAGS);
+        if (!block_read_mostly)
+            return NULL;
+
+        uvm_perf_module_type_set_data(va_block->perf_modules_data,
+                                      block_read_mostly,
+                                      UVM_PERF_MODULE_TYPE_READ_MOSTLY);
+    }
+
+    return block_read_mostly;
+}
+
+void read_mostly_block_destroy_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data)
+{
+    uvm_va_block_t *va_block;
+    block_read_mostly_info_t *block_read_mostly;
+
+    UVM_ASSERT(g_uvm_perf_read_mostly_enable);
+
+    UVM_ASSERT(event_id == UVM_PERF_EVENT_BLOCK_DESTROY ||
+               event_id == UVM_PERF_EVENT_BLOCK_SHRINK ||
+               event_id == UVM_PERF_EVENT_MODULE_UNLOAD);
+
+    if (event_id == UVM_PERF_EVENT_BLOCK_DESTROY)
+        va_block = event_data->block_destroy.block;
+    else if (event_id == UVM_PERF_EVENT_BLOCK_SHRINK)
+        va_block = event_data->block_shrink.block;
+    else
+        va_block = event_data->module_unload.block;
+
+    if (!va_block)
+        return;
+
+    // Shrunk blocks just restart the detection
+    block_read_mostly = read_mostly_info_get(va_block);
+    if (!block_read_mostly)
+        return;
+
+    uvm_perf_module_type_unset_data(va_block->perf_modules_data, UVM_PERF_MODULE_TYPE_READ_MOSTLY);
+    kmem_cache_free(g_va_block_read_mostly_info_cache, block_read_mostly);
+}
+
+void read_mostly_fault_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data)
+{
+    uvm_va_block_t *va_block = event_data->fault.block;
+    uvm_processor_id_t proc_id = event_data->fault.proc_id;
+    block_read_mostly_info_t *block_read_mostly;
+    bool is_write;
+
+    UVM_ASSERT(g_uvm_perf_read_mostly_enable);
+    UVM_ASSERT(event_id == UVM_PERF_EVENT_FAULT);
+
+    // HMM blocks keep their default policy
+    if (!va_block || uvm_va_block_is_hmm(va_block))
+        return;
+
+    if (UVM_ID_IS_CPU(proc_id)) {
+        is_write = event_data->fault.cpu.is_write;
+    }
+    else {
+        if (event_data->fault.gpu.is_duplicate)
+            return;
+
+        is_write = event_data->fault.gpu.buffer_entry->fault_access_type > UVM_FAULT_ACCESS_TYPE_READ;
+    }
+
+    // Fault events are notified with the block lock held
+    if (is_write) {
+        // Do not allocate tracking state for blocks that have never been read
+        block_read_mostly = read_mostly_info_get(va_block);
+        if (block_read_mostly)
+            memset(block_read_mostly, 0, sizeof(*block_read_mostly));
+
+        return;
+    }
+
+    block_read_mostly = read_mostly_info_get_create(va_block);
+    if (!block_read_mostly || block_read_mostly->is_read_mostly)
+        return;
+
+    uvm_processor_mask_set(&block_read_mostly->readers, proc_id);
+    if (block_read_mostly->num_read_faults < g_uvm_perf_read_mostly_threshold)
+        ++block_read_mostly->num_read_faults;
+
+    if (block_read_mostly->num_read_faults >= g_uvm_perf_read_mostly_threshold &&
+        uvm_processor_mask_get_count(&block_read_mostly->readers) >= g_uvm_perf_read_mostly_min_readers)
+        block_read_mostly->is_read_mostly = true;
+}
+
+bool uvm_perf_read_mostly_block_is_read_mostly(uvm_va_block_t *va_block)
+{
+    block_read_mostly_info_t *block_read_mostly;
+
+    if (!g_uvm_perf_read_mostly_enable)
+        return false;
+
+    block_read_mostly = read_mostly_info_get(va_block);
+
+    return block_read_mostly && block_read_mostly->is_read_mostly;
+}
+
+NV_STATUS uvm_perf_read_mostly_load(uvm_va_space_t *va_space)
+{
+    uvm_assert_rwsem_locked_write(&va_space->lock);
+
+    if (!g_uvm_perf_read_mostly_enable)
+        return NV_OK;
+
+    return uvm_perf_module_load(&g_module_read_mostly, va_space);
+}
+
+void uvm_perf_read_mostly_unload(uvm_va_space_t *va_space)
+{
+    uvm_assert_rwsem_locked_write(&va_space->lock);
+
+    if (!g_uvm_perf_read_mostly_enable)
+        return;
+
+    uvm_perf_module_unload(&g_module_read_mostly, va_space);
+}
+
+#define INIT_READ_MOSTLY_PARAMETER_MIN_MAX(_v, _d, _mi, _ma)                    \
+    do {                                                                        \
+        if ((_v) >= (_mi) && (_v) <= (_ma)) {                                   \
+            g_##_v = (_v);                                                      \
+        }                                                                       \
+        else {                                                                  \
+            pr_info("Invalid value %u for " #_v ". Using %u instead\n",         \
+                    (_v), (unsigned)(_d));                                      \
+            g_##_v = (_d);                                                      \
+        }                                                                       \
+    } while (0)
+
+NV_STATUS uvm_perf_read_mostly_init(void)
+{
+    g_uvm_perf_read_mostly_enable = uvm_perf_read_mostly_enable != 0;
+    if (!g_uvm_perf_read_mostly_enable)
+        return NV_OK;
+
+    uvm_perf_module_init("perf_read_mostly",
+                         UVM_PERF_MODULE_TYPE_READ_MOSTLY,
+                         g_callbacks_read_mostly,
+                         ARRAY_SIZE(g_callbacks_read_mostly),
+                         &g_module_read_mostly);
+
+    INIT_READ_MOSTLY_PARAMETER_MIN_MAX(uvm_perf_read_mostly_threshold,
+                                       UVM_PERF_READ_MOSTLY_THRESHOLD_DEFAULT,
+                                       1u,
+                                       UVM_PERF_READ_MOSTLY_THRESHOLD_MAX);
+
+    INIT_READ_MOSTLY_PARAMETER_MIN_MAX(uvm_perf_read_mostly_min_readers,
+                                       UVM_PERF_READ_MOSTLY_MIN_READERS_DEFAULT,
+                                       2u,
+                                       (unsigned)UVM_ID_MAX_PROCESSORS);
+
+    g_va_block_read_mostly_info_cache = NV_KMEM_CACHE_CREATE("uvm_block_read_mostly_info_t",
+                                                             block_read_mostly_info_t);
+    if (!g_va_block_read_mostly_info_cache)
+        return NV_ERR_NO_MEMORY;
+
+    return NV_OK;
+}
+
+void uvm_perf_read_mostly_exit(void)
+{
+    kmem_cache_destroy_safe(&g_va_block_read_mostly_info_cache);
+}
@@ -0,0 +1,52 @@
+/*******************************************************************************
+    Copyright (c) 2024 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef __UVM_PERF_READ_MOSTLY_H__
+#define __UVM_PERF_READ_MOSTLY_H__
+
+#include "uvm_linux.h"
+#include "uvm_forward_decl.h"
+
+// The read-mostly detector enables read duplication automatically on VA blocks
+// whose read duplication policy is unset. It watches the faults reported on
+// each VA block and flags the block once a number of read faults from several
+// distinct processors have been observed without any intervening write. The
+// first write fault clears the flag, so that the write collapses the existing
+// copies through the regular read duplication breaking path and the block
+// goes back to migrating on fault until it becomes read-mostly again.
+
+// Global initialization/cleanup functions
+NV_STATUS uvm_perf_read_mostly_init(void);
+void uvm_perf_read_mostly_exit(void);
+
+// VA space Initialization/cleanup functions. See comments in
+// uvm_perf_heuristics.h
+NV_STATUS uvm_perf_read_mostly_load(uvm_va_space_t *va_space);
+void uvm_perf_read_mostly_unload(uvm_va_space_t *va_space);
+
+// Returns true if the given block has been detected as read-mostly and pages
+// faulted for reading should be read-duplicated. Locking: the block lock must
+// be held.
+bool uvm_perf_read_mostly_block_is_read_mostly(uvm_va_block_t *va_block);
+
+#endif
@@ -0,0 +1,617 @@
+/*******************************************************************************
+    Copyright (c) 2024 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "uvm_linux.h"
+#include "uvm_perf_events.h"
+#include "uvm_perf_module.h"
+#include "uvm_perf_stride_prefetch.h"
+#include "uvm_perf_thrashing.h"
+#include "uvm_kvmalloc.h"
+#include "uvm_range_group.h"
+#include "uvm_va_block.h"
+#include "uvm_va_range.h"
+#include "uvm_va_space.h"
+
+//
+// Tunables for stride prefetching (configurable via module parameters)
+//
+
+#define UVM_PERF_STRIDE_PREFETCH_ENABLE_DEFAULT 0
+
+// Enable/disable the stride prefetcher
+static unsigned uvm_perf_stride_prefetch_enable = UVM_PERF_STRIDE_PREFETCH_ENABLE_DEFAULT;
+
+#define UVM_PERF_STRIDE_PREFETCH_CONFIDENCE_DEFAULT 2
+#define UVM_PERF_STRIDE_PREFETCH_CONFIDENCE_MAX     16
+
+// Number of consecutive VA block transitions with the same stride required
+// before the next blocks are prefetched
+static unsigned uvm_perf_stride_prefetch_confidence = UVM_PERF_STRIDE_PREFETCH_CONFIDENCE_DEFAULT;
+
+#define UVM_PERF_STRIDE_PREFETCH_DISTANCE_DEFAULT 2
+#define UVM_PERF_STRIDE_PREFETCH_DISTANCE_MAX     8
+
+// Number of predicted VA blocks prefetched ahead of the faulting block
+static unsigned uvm_perf_stride_prefetch_distance = UVM_PERF_STRIDE_PREFETCH_DISTANCE_DEFAULT;
+
+#define UVM_PERF_STRIDE_PREFETCH_BACKOFF_DEFAULT 32
+#define UVM_PERF_STRIDE_PREFETCH_BACKOFF_MAX     1024
+
+// Number of VA block transitions during which predictions are suppressed after
+// thrashing is detected on a faulting block
+static unsigned uvm_perf_stride_prefetch_backoff = UVM_PERF_STRIDE_PREFETCH_BACKOFF_DEFAULT;
+
+// Module parameters for the tunables
+module_param(uvm_perf_stride_prefetch_enable, uint, S_IRUGO);
+module_param(uvm_perf_stride_prefetch_confidence, uint, S_IRUGO);
+module_param(uvm_perf_stride_prefetch_distance, uint, S_IRUGO);
+module_param(uvm_perf_stride_prefetch_backoff, uint, S_IRUGO);
+
+static bool g_uvm_perf_stride_prefetch_enable;
+static unsigned g_uvm_perf_stride_prefetch_confidence;
+static unsigned g_uvm_perf_stride_prefetch_distance;
+static unsigned g_uvm_perf_stride_prefetch_backoff;
+
+// Maximum number of pending prefetch requests per VA space. Requests posted
+// while the queue is full are dropped.
+#define STRIDE_PREFETCH_QUEUE_SIZE 64
+
+// Per-VA range stride tracking state
+typedef struct
+{
+    // GPU whose faults are being tracked. Faults from a different processor
+    // restart the detection.
+    uvm_processor_id_t proc_id;
+
+    // Index of the last VA block faulted on by proc_id
+    NvS64 last_block_index;
+
+    // Distance, in blocks, between the last two faulted blocks
+    NvS64 stride;
+
+    // Number of consecutive block transitions that matched stride
+    NvU32 confidence;
+
+    // Number of block transitions left before predictions are issued again
+    NvU32 backoff;
+
+    // Furthest block already requested along the current stride. Only valid
+    // if has_prefetched is true.
+    NvS64 last_prefetch_index;
+    bool has_prefetched;
+} range_stride_info_t;
+
+typedef struct
+{
+    // Start address of the VA range. The range may have been destroyed or
+    // split by the time the request is processed, so it is looked up again.
+    NvU64 range_start;
+
+    size_t block_index;
+
+    uvm_processor_id_t dst;
+} stride_prefetch_request_t;
+
+// Per-VA space stride prefetching state
+typedef struct
+{
+    uvm_va_space_t *va_space;
+
+    // Protects the per-range tracking state and the request queue. Fault
+    // callbacks only hold the VA space lock in read mode, so faults on
+    // different VA blocks of the same range can be reported concurrently.
+    uvm_spinlock_t lock;
+
+    // Circular queue of pending prefetch requests
+    struct
+    {
+        stride_prefetch_request_t entries[STRIDE_PREFETCH_QUEUE_SIZE];
+
+        NvU32 head;
+
+        NvU32 count;
+    } queue;
+
+    // Work item that services the queue outside of the fault path
+    struct work_struct work;
+
+    // Set during VA space teardown to prevent further work from being
+    // scheduled
+    bool in_va_space_teardown;
+
+    // Only used by the work item
+    uvm_va_block_context_t *va_block_context;
+} va_space_stride_prefetch_info_t;
+
+static uvm_perf_module_t g_module_stride_prefetch;
+
+static void stride_prefetch_fault_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data);
+static void stride_prefetch_range_destroy_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data);
+
+static uvm_perf_module_event_callback_desc_t g_callbacks_stride_prefetch[] = {
+    { UVM_PERF_EVENT_FAULT,         stride_prefetch_fault_cb         },
+    { UVM_PERF_EVENT_RANGE_DESTROY, stride_prefetch_range_destroy_cb },
+    { UVM_PERF_EVENT_RANGE_SHRINK,  stride_prefetch_range_destroy_cb },
+    { UVM_PERF_EVENT_MODULE_UNLOAD, stride_prefetch_range_destroy_cb },
+};
+
+static va_space_stride_prefetch_info_t *va_space_stride_prefetch_info_get_or_null(uvm_va_space_t *va_space)
+{
+    return uvm_perf_module_type_data(va_space->perf_modules_data, UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH);
+}
+
+static range_stride_info_t *range_stride_info_get_or_null(uvm_va_range_t *va_range)
+{
+    return uvm_perf_module_type_data(va_range->managed.perf_modules_data, UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH);
+}
+
+// Get the stride tracking state of the given VA range or create it if it does
+// not exist. The caller must hold va_space_stride->lock, which may be dropped
+// and re-acquired to perform the allocation.
+static range_stride_info_t *range_stride_info_get_create(va_space_stride_prefetch_info_t *va_space_stride,
+                                                         uvm_va_range_t *va_range)
+{
+    range_stride_info_t *range_stride = range_stride_info_get_or_null(va_range);
+    range_stride_info_t *new_range_stride;
+
+    if (range_stride)
+        return range_stride;
+
+    uvm_spin_unlock(&va_space_stride->lock);
+
+    new_range_stride = uvm_kvmalloc_zero(sizeof(*new_range_stride));
+    if (new_range_stride)
+        new_range_stride->proc_id = UVM_ID_INVALID;
+
+    uvm_spin_lock(&va_space_stride->lock);
+
+    // Another thread may have created the state while the lock was dropped
+    range_stride = range_stride_info_get_or_null(va_range);
+    if (!range_stride && new_range_stride) {
+        uvm_perf_module_type_set_data(va_range->managed.perf_modules_data,
+                                      new_range_stride,
+                                      UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH);
+        return new_range_stride;
+    }
+
+    uvm_kvfree(new_range_stride);
+
+    return range_stride;
+}
+
+void stride_prefetch_range_destroy_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data)
+{
+    uvm_va_range_t *va_range;
+    range_stride_info_t *range_stride;
+
+    UVM_ASSERT(g_uvm_perf_stride_prefetch_enable);
+
+    UVM_ASSERT(event_id == UVM_PERF_EVENT_RANGE_DESTROY ||
+               event_id == UVM_PERF_EVENT_RANGE_SHRINK ||
+               event_id == UVM_PERF_EVENT_MODULE_UNLOAD);
+
+    if (event_id == UVM_PERF_EVENT_RANGE_DESTROY)
+        va_range = event_data->range_destroy.range;
+    else if (event_id == UVM_PERF_EVENT_RANGE_SHRINK)
+        va_range = event_data->range_shrink.range;
+    else if (event_data->module_unload.module == &g_module_stride_prefetch)
+        va_range = event_data->module_unload.range;
+    else
+        return;
+
+    // All these events are notified with the VA space lock held in write mode,
+    // so no fault callback can be accessing the state concurrently. Shrunk
+    // ranges just restart the detection.
+    if (!va_range || va_range->type != UVM_VA_RANGE_TYPE_MANAGED)
+        return;
+
+    range_stride = range_stride_info_get_or_null(va_range);
+    if (!range_stride)
+        return;
+
+    uvm_perf_module_type_unset_data(va_range->managed.perf_modules_data, UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH);
+    uvm_kvfree(range_stride);
+}
+
+// Add a prefetch request to the queue and schedule the work item that services
+// it. Requests are dropped if the queue is full. The caller must hold
+// va_space_stride->lock.
+static void stride_prefetch_post(va_space_stride_prefetch_info_t *va_space_stride,
+                                 uvm_va_range_t *va_range,
+                                 size_t block_index,
+                                 uvm_processor_id_t dst)
+{
+    stride_prefetch_request_t *request;
+
+    uvm_assert_spinlock_locked(&va_space_stride->lock);
+
+    if (va_space_stride->queue.count == STRIDE_PREFETCH_QUEUE_SIZE)
+        return;
+
+    request = &va_space_stride->queue.entries[(va_space_stride->queue.head + va_space_stride->queue.count) %
+                                              STRIDE_PREFETCH_QUEUE_SIZE];
+    request->range_start = va_range->node.start;
+    request->block_index = block_index;
+    request->dst = dst;
+
+    ++va_space_stride->queue.count;
+
+    schedule_work(&va_space_stride->work);
+}
+
+// Update the stride detector of the VA range with a fault from proc_id on the
+// given block and post prefetch requests for the predicted blocks. The caller
+// must hold va_space_stride->lock.
+static void stride_prefetch_update(va_space_stride_prefetch_info_t *va_space_stride,
+                                   uvm_va_range_t *va_range,
+                                   range_stride_info_t *range_stride,
+                                   NvS64 block_index,
+                                   uvm_processor_id_t proc_id,
+                                   bool is_thrashing)
+{
+    NvS64 num_blocks = uvm_va_range_num_blocks(va_range);
+    NvS64 stride;
+    NvU32 i;
+
+    uvm_assert_spinlock_locked(&va_space_stride->lock);
+
+    if (!uvm_id_equal(range_stride->proc_id, proc_id)) {
+        memset(range_stride, 0, sizeof(*range_stride));
+        range_stride->proc_id = proc_id;
+        range_stride->last_block_index = block_index;
+        return;
+    }
+
+    // Only transitions between blocks are tracked
+    if (block_index == range_stride->last_block_index)
+        return;
+
+    stride = block_index - range_stride->last_block_index;
+    range_stride->last_block_index = block_index;
+
+    // Back off when pages bounce between processors. Prefetching whole blocks
+    // in that case would only make thrashing worse.
+    if (is_thrashing) {
+        range_stride->confidence = 0;
+        range_stride->backoff = g_uvm_perf_stride_prefetch_backoff;
+        range_stride->has_prefetched = false;
+        return;
+    }
+
+    if (stride == range_stride->stride) {
+        if (range_stride->confidence < g_uvm_perf_stride_prefetch_confidence)
+            ++range_stride->confidence;
+    }
+    else {
+        range_stride->stride = stride;
+        range_stride->confidence = 0;
+        range_stride->has_prefetched = false;
+    }
+
+    if (range_stride->backoff > 0) {
+        --range_stride->backoff;
+        return;
+    }
+
+    if (range_stride->confidence < g_uvm_perf_stride_prefetch_confidence)
+        return;
+
+    for (i = 1; i <= g_uvm_perf_stride_prefetch_distance; ++i) {
+        NvS64 target = block_index + i * stride;
+
+        if (target < 0 || target >= num_blocks)
+            break;
+
+        // Skip blocks that have already been requested
+        if (range_stride->has_prefetched &&
+            ((stride > 0 && target <= range_stride->last_prefetch_index) ||
+             (stride < 0 && target >= range_stride->last_prefetch_index)))
+            continue;
+
+        stride_prefetch_post(va_space_stride, va_range, target, proc_id);
+
+        range_stride->last_prefetch_index = target;
+        range_stride->has_prefetched = true;
+    }
+}
+
+void stride_prefetch_fault_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data)
+{
+    va_space_stride_prefetch_info_t *va_space_stride;
+    range_stride_info_t *range_stride;
+    uvm_va_block_t *va_block = event_data->fault.block;
+    uvm_processor_id_t proc_id = event_data->fault.proc_id;
+    uvm_va_range_t *va_range;
+    bool is_thrashing;
+
+    UVM_ASSERT(g_uvm_perf_stride_prefetch_enable);
+    UVM_ASSERT(event_id == UVM_PERF_EVENT_FAULT);
+
+    if (!va_block || UVM_ID_IS_CPU(proc_id) || event_data->fault.gpu.is_duplicate)
+        return;
+
+    // HMM blocks are not backed by a managed VA range
+    va_range = va_block->va_range;
+    if (!va_range || va_range->type != UVM_VA_RANGE_TYPE_MANAGED)
+        return;
+
+    va_space_stride = va_space_stride_prefetch_info_get_or_null(event_data->fault.space);
+    if (!va_space_stride)
+        return;
+
+    // The fault callback is invoked with the block lock held, which is
+    // required to query the thrashing state
+    is_thrashing = uvm_perf_thrashing_get_thrashing_pages(va_block) != NULL;
+
+    uvm_spin_lock(&va_space_stride->lock);
+
+    if (va_space_stride->in_va_space_teardown)
+        goto done;
+
+    range_stride = range_stride_info_get_create(va_space_stride, va_range);
+    if (!range_stride)
+        goto done;
+
+    stride_prefetch_update(va_space_stride,
+                           va_range,
+                           range_stride,
+                           uvm_va_range_block_index(va_range, va_block->start),
+                           proc_id,
+                           is_thrashing);
+
+done:
+    uvm_spin_unlock(&va_space_stride->lock);
+}
+
+static NV_STATUS stride_prefetch_block_locked(uvm_va_block_t *va_block,
+                                              uvm_va_block_retry_t *va_block_retry,
+                                              uvm_va_block_context_t *va_block_context,
+                                              uvm_processor_id_t dst)
+{
+    // The block may have started thrashing since the request was posted
+    if (uvm_perf_thrashing_get_thrashing_pages(va_block))
+        return NV_OK;
+
+    return uvm_va_block_make_resident(va_block,
+                                      va_block_retry,
+                                      va_block_context,
+                                      dst,
+                                      uvm_va_block_region_from_block(va_block),
+                                      NULL,
+                                      NULL,
+                                      UVM_MAKE_RESIDENT_CAUSE_PREFETCH);
+}
+
+// Migrate the block described by the request to its destination. Prefetching
+// is best-effort, so errors are ignored. Pages are only made resident on the
+// destination; they are mapped by the fault, if any, that eventually
+// touches them.
+static void stride_prefetch_block(va_space_stride_prefetch_info_t *va_space_stride,
+                                  const stride_prefetch_request_t *request)
+{
+    uvm_va_space_t *va_space = va_space_stride->va_space;
+    uvm_va_block_context_t *va_block_context = va_space_stride->va_block_context;
+    uvm_va_block_retry_t va_block_retry;
+    uvm_va_range_t *va_range;
+    uvm_va_policy_t *policy;
+    uvm_va_block_t *va_block;
+    NV_STATUS status;
+
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    va_range = uvm_va_range_find(va_space, request->range_start);
+    if (!va_range || va_range->type != UVM_VA_RANGE_TYPE_MANAGED || va_range->node.start != request->range_start)
+        return;
+
+    if (request->block_index >= uvm_va_range_num_blocks(va_range))
+        return;
+
+    if (!uvm_processor_mask_test(&va_space->registered_gpu_va_spaces, request->dst) ||
+        !uvm_va_space_processor_has_memory(va_space, request->dst))
+        return;
+
+    // Do not override explicit placement policies
+    policy = uvm_va_range_get_policy(va_range);
+    if (UVM_ID_IS_VALID(policy->preferred_location) && !uvm_id_equal(policy->preferred_location, request->dst))
+        return;
+
+    if (uvm_va_policy_is_read_duplicate(policy, va_space) || !uvm_processor_mask_empty(&va_range->uvm_lite_gpus))
+        return;
+
+    status = uvm_va_range_block_create(va_range, request->block_index, &va_block);
+    if (status != NV_OK)
+        return;
+
+    if (!uvm_range_group_all_migratable(va_space, va_block->start, va_block->end))
+        return;
+
+    uvm_va_block_context_init(va_block_context, NULL);
+
+    (void)UVM_VA_BLOCK_LOCK_RETRY(va_block,
+                                  &va_block_retry,
+                                  stride_prefetch_block_locked(va_block,
+                                                               &va_block_retry,
+                                                               va_block_context,
+                                                               request->dst));
+}
+
+static void stride_prefetch_work(struct work_struct *work)
+{
+    va_space_stride_prefetch_info_t *va_space_stride = container_of(work, va_space_stride_prefetch_info_t, work);
+    uvm_va_space_t *va_space = va_space_stride->va_space;
+
+    // Take the VA space lock so that VA ranges and GPUs don't go away during
+    // this operation
+    uvm_va_space_down_read(va_space);
+
+    while (1) {
+        stride_prefetch_request_t request;
+        bool found = false;
+
+        uvm_spin_lock(&va_space_stride->lock);
+
+        if (!va_space_stride->in_va_space_teardown && va_space_stride->queue.count > 0) {
+            request = va_space_stride->queue.entries[va_space_stride->queue.head];
+            va_space_stride->queue.head = (va_space_stride->queue.head + 1) % STRIDE_PREFETCH_QUEUE_SIZE;
+            --va_space_stride->queue.count;
+            found = true;
+        }
+
+        uvm_spin_unlock(&va_space_stride->lock);
+
+        if (!found)
+            break;
+
+        stride_prefetch_block(va_space_stride, &request);
+    }
+
+    uvm_va_space_up_read(va_space);
+}
+
+static void stride_prefetch_work_entry(struct work_struct *work)
+{
+    UVM_ENTRY_VOID(stride_prefetch_work(work));
+}
+
+NV_STATUS uvm_perf_stride_prefetch_load(uvm_va_space_t *va_space)
+{
+    va_space_stride_prefetch_info_t *va_space_stride;
+    NV_STATUS status;
+
+    uvm_assert_rwsem_locked_write(&va_space->lock);
+
+    if (!g_uvm_perf_stride_prefetch_enable)
+        return NV_OK;
+
+    va_space_stride = uvm_kvmalloc_zero(sizeof(*va_space_stride));
+    if (!va_space_stride)
+        return NV_ERR_NO_MEMORY;
+
+    va_space_stride->va_block_context = uvm_va_block_context_alloc(NULL);
+    if (!va_space_stride->va_block_context) {
+        uvm_kvfree(va_space_stride);
+        return NV_ERR_NO_MEMORY;
+    }
+
+    va_space_stride->va_space = va_space;
+    uvm_spin_lock_init(&va_space_stride->lock, UVM_LOCK_ORDER_LEAF);
+    INIT_WORK(&va_space_stride->work, stride_prefetch_work_entry);
+
+    uvm_perf_module_type_set_data(va_space->perf_modules_data, va_space_stride, UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH);
+
+    status = uvm_perf_module_load(&g_module_stride_prefetch, va_space);
+    if (status != NV_OK) {
+        uvm_perf_module_type_unset_data(va_space->perf_modules_data, UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH);
+        uvm_va_block_context_free(va_space_stride->va_block_context);
+        uvm_kvfree(va_space_stride);
+        return status;
+    }
+
+    return NV_OK;
+}
+
+void uvm_perf_stride_prefetch_stop(uvm_va_space_t *va_space)
+{
+    va_space_stride_prefetch_info_t *va_space_stride;
+
+    uvm_va_space_down_write(va_space);
+
+    va_space_stride = va_space_stride_prefetch_info_get_or_null(va_space);
+
+    // Prevent further prefetches from being scheduled
+    if (va_space_stride) {
+        uvm_spin_lock(&va_space_stride->lock);
+        va_space_stride->in_va_space_teardown = true;
+        uvm_spin_unlock(&va_space_stride->lock);
+    }
+
+    uvm_va_space_up_write(va_space);
+
+    // Cancel any pending work. va_space_stride can be safely accessed because
+    // it is only freed by uvm_perf_stride_prefetch_unload, which is called
+    // later in the teardown path.
+    if (va_space_stride)
+        (void)cancel_work_sync(&va_space_stride->work);
+}
+
+void uvm_perf_stride_prefetch_unload(uvm_va_space_t *va_space)
+{
+    va_space_stride_prefetch_info_t *va_space_stride;
+
+    uvm_assert_rwsem_locked_write(&va_space->lock);
+
+    uvm_perf_module_unload(&g_module_stride_prefetch, va_space);
+
+    va_space_stride = va_space_stride_prefetch_info_get_or_null(va_space);
+    if (va_space_stride) {
+        uvm_perf_module_type_unset_data(va_space->perf_modules_data, UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH);
+        uvm_va_block_context_free(va_space_stride->va_block_context);
+        uvm_kvfree(va_space_stride);
+    }
+}
+
+#define INIT_STRIDE_PREFETCH_PARAMETER_MIN_MAX(_v, _d, _mi, _ma)                \
+    do {                                                                        \
+        if ((_v) >= (_mi) && (_v) <= (_ma)) {                                   \
+            g_##_v = (_v);                                                      \
+        }                                                                       \
+        else {                                                                  \
+            pr_info("Invalid value %u for " #_v ". Using %u instead\n",         \
+                    (_v), (unsigned)(_d));                                      \
+            g_##_v = (_d);                                                      \
+        }                                                                       \
+    } while (0)
+
+NV_STATUS uvm_perf_stride_prefetch_init(void)
+{
+    g_uvm_perf_stride_prefetch_enable = uvm_perf_stride_prefetch_enable != 0;
+    if (!g_uvm_perf_stride_prefetch_enable)
+        return NV_OK;
+
+    uvm_perf_module_init("perf_stride_prefetch",
+                         UVM_PERF_MODULE_TYPE_STRIDE_PREFETCH,
+                         g_callbacks_stride_prefetch,
+                         ARRAY_SIZE(g_callbacks_stride_prefetch),
+                         &g_module_stride_prefetch);
+
+    INIT_STRIDE_PREFETCH_PARAMETER_MIN_MAX(uvm_perf_stride_prefetch_confidence,
+                                           UVM_PERF_STRIDE_PREFETCH_CONFIDENCE_DEFAULT,
+                                           1u,
+                                           UVM_PERF_STRIDE_PREFETCH_CONFIDENCE_MAX);
+
+    INIT_STRIDE_PREFETCH_PARAMETER_MIN_MAX(uvm_perf_stride_prefetch_distance,
+                                           UVM_PERF_STRIDE_PREFETCH_DISTANCE_DEFAULT,
+                                           1u,
+                                           UVM_PERF_STRIDE_PREFETCH_DISTANCE_MAX);
+
+    INIT_STRIDE_PREFETCH_PARAMETER_MIN_MAX(uvm_perf_stride_prefetch_backoff,
+                                           UVM_PERF_STRIDE_PREFETCH_BACKOFF_DEFAULT,
+                                           0u,
+                                           UVM_PERF_STRIDE_PREFETCH_BACKOFF_MAX);
+
+    return NV_OK;
+}
+
+void uvm_perf_stride_prefetch_exit(void)
+{
+}
@@ -0,0 +1,48 @@
+/*******************************************************************************
+    Copyright (c) 2024 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef __UVM_PERF_STRIDE_PREFETCH_H__
+#define __UVM_PERF_STRIDE_PREFETCH_H__
+
+#include "uvm_linux.h"
+#include "uvm_forward_decl.h"
+
+// The stride prefetcher complements the per-block prefetcher in
+// uvm_perf_prefetch.c, which only prefetches pages within the VA block being
+// serviced. It watches the sequence of VA blocks faulted on by a GPU within
+// each managed VA range and, once the same block stride has been observed a
+// number of consecutive times, it asynchronously migrates the next predicted
+// blocks to the faulting GPU. Predictions stop for a while when thrashing is
+// detected in the faulting block.
+
+// Global initialization/cleanup functions
+NV_STATUS uvm_perf_stride_prefetch_init(void);
+void uvm_perf_stride_prefetch_exit(void);
+
+// VA space Initialization/cleanup functions. See comments in
+// uvm_perf_heuristics.h
+NV_STATUS uvm_perf_stride_prefetch_load(uvm_va_space_t *va_space);
+void uvm_perf_stride_prefetch_stop(uvm_va_space_t *va_space);
+void uvm_perf_stride_prefetch_unload(uvm_va_space_t *va_space);
+
+#endif
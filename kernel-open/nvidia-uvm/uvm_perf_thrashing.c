@@ -104,6 +104,10 @@ typedef struct
     // Stats
     NvU32                           throttling_count;
 
+    NvU32                            pin_local_count;
+
+    NvU32                           pin_remote_count;
+
     uvm_page_mask_t                  thrashing_pages;
 
     struct
@@ -139,6 +143,36 @@ typedef struct
     struct list_head             va_block_list_entry;
 } pinned_page_t;
 
+// Thrashing mitigation parameters. The VA space holds the defaults, which can
+// be overridden per VA range. See thrashing_params_get.
+typedef struct
+{
+    // Whether thrashing mitigation is enabled
+    bool                                      enable;
+
+    // true if the thrashing mitigation parameters have been modified using
+    // test ioctls
+    bool                              test_overrides;
+
+    // Whether the link cost model is used to pin pages before reaching
+    // pin_threshold
+    bool                                  cost_model;
+
+    unsigned                               threshold;
+
+    unsigned                           pin_threshold;
+
+    NvU64                                   lapse_ns;
+
+    NvU64                                     nap_ns;
+
+    NvU64                                   epoch_ns;
+
+    unsigned                              max_resets;
+
+    NvU64                                     pin_ns;
+} thrashing_params_t;
+
 // Per-VA space data structures and policy configuration
 typedef struct
 {
@@ -150,13 +184,11 @@ typedef struct
         // Work descriptor that is executed asynchronously by a helper thread
         struct delayed_work                    dwork;
 
-        // List of pinned pages. They are (mostly) ordered by unpin deadline.
-        // New entries are inserted blindly at the tail since the expectation
-        // is that they will have the largest deadline value. However, given
-        // the drift between when multiple threads query their timestamps and
-        // add those pages to the list under the lock, it might not be
-        // strictly ordered. But this is OK since the difference will be very
-        // small and they will be eventually removed from the list.
+        // List of pinned pages, ordered by unpin deadline. VA range policies
+        // can override the pinning timeout, so a new entry does not
+        // necessarily have the largest deadline value. New entries are
+        // inserted in order, searching from the tail, where entries pinned
+        // with the same timeout go.
         //
         // Entries are removed when they reach the deadline by the function
         // configured in dwork. This list is protected by lock.
@@ -171,32 +203,7 @@ typedef struct
         bool                    in_va_space_teardown;
     } pinned_pages;
 
-    struct
-    {
-        // Whether thrashing mitigation is enabled on this VA space
-        bool                                  enable;
-
-        // true if the thrashing mitigation parameters have been modified using
-        // test ioctls
-        bool                          test_overrides;
-
-        //
-        // Fields below are the thrashing mitigation parameters on the VA space
-        //
-        unsigned                           threshold;
-
-        unsigned                       pin_threshold;
-
-        NvU64                               lapse_ns;
-
-        NvU64                                 nap_ns;
-
-        NvU64                               epoch_ns;
-
-        unsigned                          max_resets;
-
-        NvU64                                 pin_ns;
-    } params;
+    thrashing_params_t                       params;
 
     uvm_va_space_t                         *va_space;
 } va_space_thrashing_info_t;
@@ -303,6 +310,30 @@ static unsigned uvm_perf_thrashing_pin = UVM_PERF_THRASHING_PIN_DEFAULT;
 
 static unsigned uvm_perf_thrashing_max_resets = UVM_PERF_THRASHING_MAX_RESETS_DEFAULT;
 
+// Cost model used to decide whether a thrashing page is pinned and mapped
+// remotely instead of throttling the processors that fight over it. Each
+// throttling period ends up migrating the page back and forth across the link
+// between the processors, which costs twice the fixed overhead of a fault
+// driven migration plus the transfer time at the link rate. Mapping the page
+// remotely instead costs the transfer time plus the remote access latency.
+// The link rates are the ones reported for the sysmem and peer links of the
+// GPUs. The cost model can be enabled on the whole VA space or per VA range
+// with UVM_SET_THRASHING_POLICY.
+#define UVM_PERF_THRASHING_COST_MODEL_DEFAULT 0
+
+static unsigned uvm_perf_thrashing_cost_model = UVM_PERF_THRASHING_COST_MODEL_DEFAULT;
+
+#define UVM_PERF_THRASHING_MIGRATION_OVERHEAD_USEC_DEFAULT 20
+
+// Fixed cost in microseconds of migrating a page on fault, not including the
+// copy itself
+static unsigned uvm_perf_thrashing_migration_overhead_usec = UVM_PERF_THRASHING_MIGRATION_OVERHEAD_USEC_DEFAULT;
+
+#define UVM_PERF_THRASHING_REMOTE_LATENCY_NSEC_DEFAULT 1000
+
+// Latency in nanoseconds of remote accesses over the link
+static unsigned uvm_perf_thrashing_remote_latency_nsec = UVM_PERF_THRASHING_REMOTE_LATENCY_NSEC_DEFAULT;
+
 // Module parameters for the tunables
 module_param(uvm_perf_thrashing_enable,        uint, S_IRUGO);
 module_param(uvm_perf_thrashing_threshold,     uint, S_IRUGO);
@@ -312,6 +343,9 @@ module_param(uvm_perf_thrashing_nap,           uint, S_IRUGO);
 module_param(uvm_perf_thrashing_epoch,         uint, S_IRUGO);
 module_param(uvm_perf_thrashing_pin,           uint, S_IRUGO);
 module_param(uvm_perf_thrashing_max_resets,    uint, S_IRUGO);
+module_param(uvm_perf_thrashing_cost_model,    uint, S_IRUGO);
+module_param(uvm_perf_thrashing_migration_overhead_usec, uint, S_IRUGO);
+module_param(uvm_perf_thrashing_remote_latency_nsec,     uint, S_IRUGO);
 
 // See map_remote_on_atomic_fault uvm_va_block.c
 unsigned uvm_perf_map_remote_on_native_atomics_fault = 0;
@@ -327,6 +361,9 @@ static NvU64 g_uvm_perf_thrashing_nap;
 static NvU64 g_uvm_perf_thrashing_epoch;
 static NvU64 g_uvm_perf_thrashing_pin;
 static unsigned g_uvm_perf_thrashing_max_resets;
+static bool g_uvm_perf_thrashing_cost_model;
+static unsigned g_uvm_perf_thrashing_migration_overhead_usec;
+static unsigned g_uvm_perf_thrashing_remote_latency_nsec;
 
 // Helper macros to initialize thrashing parameters from module parameters
 //
@@ -586,6 +623,46 @@ static void va_space_thrashing_info_init_params(va_space_thrashing_info_t *va_sp
     }
 
     va_space_thrashing->params.max_resets    = g_uvm_perf_thrashing_max_resets;
+
+    va_space_thrashing->params.cost_model    = g_uvm_perf_thrashing_cost_model;
+}
+
+// Get the thrashing mitigation parameters that apply to the given VA block,
+// which are the VA space parameters with the overrides of the VA range policy
+// applied. HMM policies do not support overrides.
+static void thrashing_params_get(va_space_thrashing_info_t *va_space_thrashing,
+                                 uvm_va_block_t *va_block,
+                                 thrashing_params_t *params)
+{
+    const uvm_va_policy_thrashing_t *policy;
+
+    *params = va_space_thrashing->params;
+
+    if (uvm_va_block_is_hmm(va_block) || !va_block->va_range)
+        return;
+
+    policy = &uvm_va_range_get_policy(va_block->va_range)->thrashing;
+
+    if (policy->disable)
+        params->enable = false;
+
+    if (policy->cost_model)
+        params->cost_model = true;
+
+    if (policy->threshold)
+        params->threshold = policy->threshold;
+
+    if (policy->pin_threshold)
+        params->pin_threshold = policy->pin_threshold;
+
+    if (policy->lapse_ns)
+        params->lapse_ns = policy->lapse_ns;
+
+    if (policy->nap_ns)
+        params->nap_ns = policy->nap_ns;
+
+    if (policy->pin_ns)
+        params->pin_ns = policy->pin_ns;
 }
 
 // Create the thrashing detection struct for the given VA space
@@ -725,12 +802,15 @@ static bool thrashing_state_checks(uvm_va_block_t *va_block,
 {
     uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
     va_space_thrashing_info_t *va_space_thrashing = va_space_thrashing_info_get(va_space);
+    thrashing_params_t params;
 
     if (!block_thrashing) {
         UVM_ASSERT(!page_thrashing);
         return true;
     }
 
+    thrashing_params_get(va_space_thrashing, va_block, &params);
+
     UVM_ASSERT(uvm_page_mask_subset(&block_thrashing->pinned_pages.mask, &block_thrashing->thrashing_pages));
 
     if (page_thrashing) {
@@ -746,7 +826,7 @@ static bool thrashing_state_checks(uvm_va_block_t *va_block,
                                          &page_thrashing->processors));
 
     if (uvm_page_mask_test(&block_thrashing->thrashing_pages, page_index))
-        UVM_ASSERT(page_thrashing->num_thrashing_events >= va_space_thrashing->params.threshold);
+        UVM_ASSERT(page_thrashing->num_thrashing_events >= params.threshold);
 
     if (page_thrashing->pinned) {
         UVM_ASSERT(uvm_page_mask_test(&block_thrashing->pinned_pages.mask, page_index));
@@ -769,7 +849,7 @@ static bool thrashing_state_checks(uvm_va_block_t *va_block,
 // Update throttling heuristics. Mainly check if a new throttling period has
 // started and choose the next processor not to be throttled. This function
 // is executed before the thrashing mitigation logic kicks in.
-static void thrashing_throttle_update(va_space_thrashing_info_t *va_space_thrashing,
+static void thrashing_throttle_update(const thrashing_params_t *params,
                                       uvm_va_block_t *va_block,
                                       page_thrashing_info_t *page_thrashing,
                                       uvm_processor_id_t processor,
@@ -780,7 +860,7 @@ static void thrashing_throttle_update(va_space_thrashing_info_t *va_space_thrash
     uvm_assert_mutex_locked(&va_block->lock);
 
     if (time_stamp > current_end_time_stamp) {
-        NvU64 throttling_end_time_stamp = time_stamp + va_space_thrashing->params.nap_ns;
+        NvU64 throttling_end_time_stamp = time_stamp + params->nap_ns;
         page_thrashing_set_throttling_end_time_stamp(page_thrashing, throttling_end_time_stamp);
 
         // Avoid choosing the same processor in consecutive thrashing periods
@@ -900,6 +980,7 @@ static pinned_page_t *find_pinned_page(block_thrashing_info_t *block_thrashing,
 // - Requesting processor cannot be throttled
 //
 static NV_STATUS thrashing_pin_page(va_space_thrashing_info_t *va_space_thrashing,
+                                    const thrashing_params_t *params,
                                     uvm_va_block_t *va_block,
                                     uvm_va_block_context_t *va_block_context,
                                     block_thrashing_info_t *block_thrashing,
@@ -923,31 +1004,48 @@ static NV_STATUS thrashing_pin_page(va_space_thrashing_info_t *va_space_thrashin
         thrashing_throttling_reset_page(va_block, block_thrashing, page_thrashing, page_index);
 
     if (!page_thrashing->pinned) {
-        if (va_space_thrashing->params.pin_ns > 0) {
+        if (params->pin_ns > 0) {
             pinned_page_t *pinned_page = nv_kmem_cache_zalloc(g_pinned_page_cache, NV_UVM_GFP_FLAGS);
+            pinned_page_t *iter;
+
             if (!pinned_page)
                 return NV_ERR_NO_MEMORY;
 
             pinned_page->va_block = va_block;
             pinned_page->page_index = page_index;
-            pinned_page->deadline = time_stamp + va_space_thrashing->params.pin_ns;
+            pinned_page->deadline = time_stamp + params->pin_ns;
 
             uvm_spin_lock(&va_space_thrashing->pinned_pages.lock);
 
-            list_add_tail(&pinned_page->va_space_list_entry, &va_space_thrashing->pinned_pages.list);
+            // If the loop completes, iter refers to the list head, and the page
+            // is added first.
+            list_for_each_entry_reverse(iter, &va_space_thrashing->pinned_pages.list, va_space_list_entry) {
+                if (iter->deadline <= pinned_page->deadline)
+                    break;
+            }
+            list_add(&pinned_page->va_space_list_entry, &iter->va_space_list_entry);
             list_add_tail(&pinned_page->va_block_list_entry, &block_thrashing->pinned_pages.list);
 
             // We only schedule the delayed work if the list was empty before
-            // adding this page. Otherwise, we just add it to the list. The
-            // unpinning helper will remove from the list those pages with
-            // deadline prior to its wakeup timestamp and will reschedule
-            // itself if there are remaining pages in the list.
-            if (list_is_singular(&va_space_thrashing->pinned_pages.list) &&
-                !va_space_thrashing->pinned_pages.in_va_space_teardown) {
-                int scheduled;
-                scheduled = schedule_delayed_work(&va_space_thrashing->pinned_pages.dwork,
-                                                  usecs_to_jiffies(va_space_thrashing->params.pin_ns / 1000));
-                UVM_ASSERT(scheduled != 0);
+            // adding this page, or move it earlier if the page has the earliest
+            // deadline. Otherwise, we just add it to the list. The unpinning
+            // helper will remove from the list those pages with deadline prior
+            // to its wakeup timestamp and will reschedule itself if there are
+            // remaining pages in the list.
+            if (!va_space_thrashing->pinned_pages.in_va_space_teardown) {
+                if (list_is_singular(&va_space_thrashing->pinned_pages.list)) {
+                    int scheduled;
+                    scheduled = schedule_delayed_work(&va_space_thrashing->pinned_pages.dwork,
+                                                      usecs_to_jiffies(params->pin_ns / 1000));
+                    UVM_ASSERT(scheduled != 0);
+                }
+                else if (list_first_entry(&va_space_thrashing->pinned_pages.list,
+                                          pinned_page_t,
+                                          va_space_list_entry) == pinned_page) {
+                    mod_delayed_work(system_wq,
+                                     &va_space_thrashing->pinned_pages.dwork,
+                                     usecs_to_jiffies(params->pin_ns / 1000));
+                }
             }
 
             uvm_spin_unlock(&va_space_thrashing->pinned_pages.lock);
@@ -977,14 +1075,18 @@ static void thrashing_unpin_page(va_space_thrashing_info_t *va_space_thrashing,
                                  page_thrashing_info_t *page_thrashing,
                                  uvm_page_index_t page_index)
 {
+    pinned_page_t *pinned_page;
+
     uvm_assert_mutex_locked(&va_block->lock);
     UVM_ASSERT(page_thrashing->pinned);
 
-    if (va_space_thrashing->params.pin_ns > 0) {
+    // Whether the page has a descriptor depends on the pinning timeout that
+    // applied when it was pinned, so look it up rather than checking the
+    // current timeout.
+    pinned_page = find_pinned_page(block_thrashing, page_index);
+    if (pinned_page) {
         bool do_free = false;
-        pinned_page_t *pinned_page = find_pinned_page(block_thrashing, page_index);
 
-        UVM_ASSERT(pinned_page);
         UVM_ASSERT(pinned_page->page_index == page_index);
         UVM_ASSERT(pinned_page->va_block == va_block);
 
@@ -1028,14 +1130,25 @@ static void thrashing_detected(uvm_va_block_t *va_block,
 {
     uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
     NvU64 address = uvm_va_block_cpu_page_address(va_block, page_index);
+    uvm_va_block_stats_t *block_stats;
 
     // Thrashing detected, record the event
-    uvm_tools_record_thrashing(va_space, address, PAGE_SIZE, &page_thrashing->processors);
+    uvm_tools_record_thrashing(va_space,
+                               address,
+                               PAGE_SIZE,
+                               &page_thrashing->processors,
+                               block_thrashing->throttling_count,
+                               block_thrashing->pin_local_count,
+                               block_thrashing->pin_remote_count);
     if (!uvm_page_mask_test_and_set(&block_thrashing->thrashing_pages, page_index))
         ++block_thrashing->num_thrashing_pages;
 
     PROCESSOR_THRASHING_STATS_INC(va_space, processor_id, num_thrashing);
 
+    block_stats = uvm_va_block_stats_get(va_block, processor_id);
+    if (block_stats)
+        ++block_stats->thrashing_events;
+
     UVM_ASSERT(thrashing_state_checks(va_block, block_thrashing, page_thrashing, page_index));
 }
 
@@ -1240,6 +1353,7 @@ void thrashing_event_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_
     NvU64 time_stamp;
     uvm_va_block_region_t region;
     uvm_read_duplication_policy_t read_duplication;
+    thrashing_params_t params;
 
     UVM_ASSERT(g_uvm_perf_thrashing_enable);
 
@@ -1262,7 +1376,8 @@ void thrashing_event_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_
 
         va_space = uvm_va_block_get_va_space(va_block);
         va_space_thrashing = va_space_thrashing_info_get(va_space);
-        if (!va_space_thrashing->params.enable)
+        thrashing_params_get(va_space_thrashing, va_block, &params);
+        if (!params.enable)
             return;
 
         // TODO: Bug 3660922: HMM will need to look up the policy when
@@ -1304,7 +1419,8 @@ void thrashing_event_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_
 
         va_space = uvm_va_block_get_va_space(va_block);
         va_space_thrashing = va_space_thrashing_info_get(va_space);
-        if (!va_space_thrashing->params.enable)
+        thrashing_params_get(va_space_thrashing, va_block, &params);
+        if (!params.enable)
             return;
     }
 
@@ -1320,7 +1436,7 @@ void thrashing_event_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_
 
         if (block_thrashing->last_time_stamp == 0 ||
             uvm_id_equal(block_thrashing->last_processor, processor_id) ||
-            time_stamp - block_thrashing->last_time_stamp > va_space_thrashing->params.lapse_ns)
+            time_stamp - block_thrashing->last_time_stamp > params.lapse_ns)
             goto done;
 
         num_block_pages = uvm_va_block_size(va_block) / PAGE_SIZE;
@@ -1355,12 +1471,12 @@ void thrashing_event_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_
         if (last_time_stamp == 0)
             continue;
 
-        if (time_stamp - last_time_stamp <= va_space_thrashing->params.lapse_ns) {
+        if (time_stamp - last_time_stamp <= params.lapse_ns) {
             UVM_PERF_SATURATING_INC(page_thrashing->num_thrashing_events);
-            if (page_thrashing->num_thrashing_events == va_space_thrashing->params.threshold)
+            if (page_thrashing->num_thrashing_events == params.threshold)
                 thrashing_detected(va_block, block_thrashing, page_thrashing, page_index, processor_id);
 
-            if (page_thrashing->num_thrashing_events >= va_space_thrashing->params.threshold)
+            if (page_thrashing->num_thrashing_events >= params.threshold)
                 block_thrashing->last_thrashing_time_stamp = time_stamp;
 
             if (event_id == UVM_PERF_EVENT_MIGRATION)
@@ -1368,7 +1484,7 @@ void thrashing_event_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_
             else
                 page_thrashing->has_revocation_events = true;
         }
-        else if (page_thrashing->num_thrashing_events >= va_space_thrashing->params.threshold &&
+        else if (page_thrashing->num_thrashing_events >= params.threshold &&
                  !page_thrashing->pinned) {
             thrashing_reset_page(va_space_thrashing, va_block, block_thrashing, page_index);
         }
@@ -1441,7 +1557,50 @@ static bool preferred_location_is_thrashing(uvm_processor_id_t preferred_locatio
     return uvm_processor_mask_test(&page_thrashing->processors, preferred_location);
 }
 
-static uvm_perf_thrashing_hint_t get_hint_for_migration_thrashing(va_space_thrashing_info_t *va_space_thrashing,
+// Rate in megabytes per second of the link between the given processors, or 0
+// if unknown
+static NvU32 thrashing_link_rate_mbyte_per_s(uvm_va_space_t *va_space, uvm_processor_id_t id0, uvm_processor_id_t id1)
+{
+    if (UVM_ID_IS_CPU(id0))
+        return uvm_va_space_get_gpu(va_space, id1)->parent->system_bus.link_rate_mbyte_per_s;
+
+    if (UVM_ID_IS_CPU(id1))
+        return uvm_va_space_get_gpu(va_space, id0)->parent->system_bus.link_rate_mbyte_per_s;
+
+    if (uvm_parent_id_equal(uvm_parent_gpu_id_from_gpu_id(id0), uvm_parent_gpu_id_from_gpu_id(id1)))
+        return 0;
+
+    return uvm_gpu_index_peer_caps(id0, id1)->total_link_line_rate_mbyte_per_s;
+}
+
+// Returns true if, according to the cost model described in
+// uvm_perf_thrashing_cost_model, mapping the page resident on residency from
+// requester is cheaper than migrating it back and forth between them.
+static bool thrashing_remote_map_is_cheaper(uvm_va_space_t *va_space,
+                                            uvm_processor_id_t residency,
+                                            uvm_processor_id_t requester)
+{
+    NvU32 link_rate_mbyte_per_s;
+    NvU64 transfer_ns;
+    NvU64 migration_ns;
+    NvU64 remote_ns;
+
+    if (UVM_ID_IS_INVALID(residency) || uvm_id_equal(residency, requester))
+        return false;
+
+    link_rate_mbyte_per_s = thrashing_link_rate_mbyte_per_s(va_space, residency, requester);
+    if (link_rate_mbyte_per_s == 0)
+        return false;
+
+    // bytes / (MB/s) gives microseconds
+    transfer_ns  = (PAGE_SIZE * 1000ULL) / link_rate_mbyte_per_s;
+    migration_ns = 2 * (g_uvm_perf_thrashing_migration_overhead_usec * 1000ULL + transfer_ns);
+    remote_ns    = transfer_ns + g_uvm_perf_thrashing_remote_latency_nsec;
+
+    return remote_ns < migration_ns;
+}
+
+static uvm_perf_thrashing_hint_t get_hint_for_migration_thrashing(const thrashing_params_t *params,
                                                                   uvm_va_block_t *va_block,
                                                                   uvm_va_block_context_t *va_block_context,
                                                                   uvm_page_index_t page_index,
@@ -1527,7 +1686,7 @@ static uvm_perf_thrashing_hint_t get_hint_for_migration_thrashing(va_space_thras
         else if (!uvm_id_equal(preferred_location, do_not_throttle_processor)) {
             hint.type = UVM_PERF_THRASHING_HINT_TYPE_THROTTLE;
         }
-        else if (page_thrashing->throttling_count >= va_space_thrashing->params.pin_threshold) {
+        else if (page_thrashing->throttling_count >= params->pin_threshold) {
             hint.type = UVM_PERF_THRASHING_HINT_TYPE_PIN;
             hint.pin.residency = preferred_location;
         }
@@ -1569,10 +1728,19 @@ static uvm_perf_thrashing_hint_t get_hint_for_migration_thrashing(va_space_thras
             hint.type = UVM_PERF_THRASHING_HINT_TYPE_THROTTLE;
         }
     }
+    else if (params->cost_model &&
+             thrashing_processors_can_access(va_space, page_thrashing, closest_resident_id) &&
+             thrashing_remote_map_is_cheaper(va_space, closest_resident_id, requester)) {
+        // Pin the page where it is and map it remotely from the thrashing
+        // processors instead of throttling them until pin_threshold is
+        // reached.
+        hint.type = UVM_PERF_THRASHING_HINT_TYPE_PIN;
+        hint.pin.residency = closest_resident_id;
+    }
     else if (!uvm_id_equal(requester, do_not_throttle_processor)) {
         hint.type = UVM_PERF_THRASHING_HINT_TYPE_THROTTLE;
     }
-    else if (page_thrashing->throttling_count >= va_space_thrashing->params.pin_threshold) {
+    else if (page_thrashing->throttling_count >= params->pin_threshold) {
         hint.type = UVM_PERF_THRASHING_HINT_TYPE_PIN;
         hint.pin.residency = requester;
     }
@@ -1615,10 +1783,12 @@ uvm_perf_thrashing_hint_t uvm_perf_thrashing_get_hint(uvm_va_block_t *va_block,
     uvm_page_index_t page_index = uvm_va_block_cpu_page_index(va_block, address);
     NvU64 time_stamp;
     NvU64 last_time_stamp;
+    thrashing_params_t params;
 
     hint.type = UVM_PERF_THRASHING_HINT_TYPE_NONE;
 
-    if (!va_space_thrashing->params.enable)
+    thrashing_params_get(va_space_thrashing, va_block, &params);
+    if (!params.enable)
         return hint;
 
     // If we don't have enough memory to store thrashing information, we assume
@@ -1635,9 +1805,9 @@ uvm_perf_thrashing_hint_t uvm_perf_thrashing_get_hint(uvm_va_block_t *va_block,
     time_stamp = NV_GETTIME();
 
     if (block_thrashing->last_thrashing_time_stamp != 0 &&
-        (time_stamp - block_thrashing->last_thrashing_time_stamp > va_space_thrashing->params.epoch_ns) &&
+        (time_stamp - block_thrashing->last_thrashing_time_stamp > params.epoch_ns) &&
         block_thrashing->pinned_pages.count == 0 &&
-        block_thrashing->thrashing_reset_count < va_space_thrashing->params.max_resets) {
+        block_thrashing->thrashing_reset_count < params.max_resets) {
         uvm_page_index_t reset_page_index;
 
         ++block_thrashing->thrashing_reset_count;
@@ -1667,7 +1837,7 @@ uvm_perf_thrashing_hint_t uvm_perf_thrashing_get_hint(uvm_va_block_t *va_block,
     page_thrashing = &block_thrashing->pages[page_index];
 
     // Not enough thrashing events yet
-    if (page_thrashing->num_thrashing_events < va_space_thrashing->params.threshold)
+    if (page_thrashing->num_thrashing_events < params.threshold)
         goto done;
 
     // If the requesting processor is throttled, check the throttling end time
@@ -1689,7 +1859,7 @@ uvm_perf_thrashing_hint_t uvm_perf_thrashing_get_hint(uvm_va_block_t *va_block,
 
     // If the lapse since the last thrashing event is longer than a thrashing
     // lapse we are no longer thrashing
-    if (time_stamp - last_time_stamp > va_space_thrashing->params.lapse_ns &&
+    if (time_stamp - last_time_stamp > params.lapse_ns &&
         !page_thrashing->pinned) {
         goto done;
     }
@@ -1700,7 +1870,7 @@ uvm_perf_thrashing_hint_t uvm_perf_thrashing_get_hint(uvm_va_block_t *va_block,
     UVM_ASSERT(page_thrashing->has_migration_events || page_thrashing->has_revocation_events);
 
     // Update throttling heuristics
-    thrashing_throttle_update(va_space_thrashing, va_block, page_thrashing, requester, time_stamp);
+    thrashing_throttle_update(&params, va_block, page_thrashing, requester, time_stamp);
 
     if (page_thrashing->pinned &&
         page_thrashing->has_revocation_events &&
@@ -1714,7 +1884,7 @@ uvm_perf_thrashing_hint_t uvm_perf_thrashing_get_hint(uvm_va_block_t *va_block,
         hint.type = UVM_PERF_THRASHING_HINT_TYPE_THROTTLE;
     }
     else {
-        hint = get_hint_for_migration_thrashing(va_space_thrashing,
+        hint = get_hint_for_migration_thrashing(&params,
                                                 va_block,
                                                 va_block_context,
                                                 page_index,
@@ -1725,6 +1895,7 @@ uvm_perf_thrashing_hint_t uvm_perf_thrashing_get_hint(uvm_va_block_t *va_block,
 done:
     if (hint.type == UVM_PERF_THRASHING_HINT_TYPE_PIN) {
         NV_STATUS status = thrashing_pin_page(va_space_thrashing,
+                                              &params,
                                               va_block,
                                               va_block_context,
                                               block_thrashing,
@@ -1740,10 +1911,14 @@ done:
             hint.type = UVM_PERF_THRASHING_HINT_TYPE_THROTTLE;
         }
         else {
-            if (uvm_id_equal(hint.pin.residency, requester))
+            if (uvm_id_equal(hint.pin.residency, requester)) {
                 PROCESSOR_THRASHING_STATS_INC(va_space, requester, num_pin_local);
-            else
+                UVM_PERF_SATURATING_INC(block_thrashing->pin_local_count);
+            }
+            else {
                 PROCESSOR_THRASHING_STATS_INC(va_space, requester, num_pin_remote);
+                UVM_PERF_SATURATING_INC(block_thrashing->pin_remote_count);
+            }
 
             uvm_processor_mask_copy(&hint.pin.processors, &page_thrashing->processors);
         }
@@ -1776,9 +1951,12 @@ uvm_processor_mask_t *uvm_perf_thrashing_get_thrashing_processors(uvm_va_block_t
     block_thrashing_info_t *block_thrashing = NULL;
     page_thrashing_info_t *page_thrashing = NULL;
     uvm_page_index_t page_index = uvm_va_block_cpu_page_index(va_block, address);
+    thrashing_params_t params;
 
     UVM_ASSERT(g_uvm_perf_thrashing_enable);
-    UVM_ASSERT(va_space_thrashing->params.enable);
+
+    thrashing_params_get(va_space_thrashing, va_block, &params);
+    UVM_ASSERT(params.enable);
 
     block_thrashing = thrashing_info_get(va_block);
     UVM_ASSERT(block_thrashing);
@@ -1795,8 +1973,10 @@ const uvm_page_mask_t *uvm_perf_thrashing_get_thrashing_pages(uvm_va_block_t *va
     uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
     va_space_thrashing_info_t *va_space_thrashing = va_space_thrashing_info_get(va_space);
     block_thrashing_info_t *block_thrashing = NULL;
+    thrashing_params_t params;
 
-    if (!va_space_thrashing->params.enable)
+    thrashing_params_get(va_space_thrashing, va_block, &params);
+    if (!params.enable)
         return NULL;
 
     block_thrashing = thrashing_info_get(va_block);
@@ -1999,6 +2179,13 @@ NV_STATUS uvm_perf_thrashing_init(void)
 
     INIT_THRASHING_PARAMETER(uvm_perf_thrashing_max_resets, UVM_PERF_THRASHING_MAX_RESETS_DEFAULT);
 
+    INIT_THRASHING_PARAMETER_TOGGLE(uvm_perf_thrashing_cost_model, UVM_PERF_THRASHING_COST_MODEL_DEFAULT);
+
+    INIT_THRASHING_PARAMETER(uvm_perf_thrashing_migration_overhead_usec,
+                             UVM_PERF_THRASHING_MIGRATION_OVERHEAD_USEC_DEFAULT);
+
+    INIT_THRASHING_PARAMETER(uvm_perf_thrashing_remote_latency_nsec, UVM_PERF_THRASHING_REMOTE_LATENCY_NSEC_DEFAULT);
+
     g_va_block_thrashing_info_cache = NV_KMEM_CACHE_CREATE("uvm_block_thrashing_info_t", block_thrashing_info_t);
     if (!g_va_block_thrashing_info_cache) {
         status = NV_ERR_NO_MEMORY;
@@ -2044,6 +2231,40 @@ void uvm_perf_thrashing_remove_gpu(uvm_gpu_t *gpu)
     gpu_thrashing_stats_destroy(gpu);
 }
 
+NV_STATUS uvm_perf_thrashing_policy_check(uvm_va_space_t *va_space, const uvm_va_policy_thrashing_t *policy)
+{
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    if (!g_uvm_perf_thrashing_enable || !va_space_thrashing_info_get(va_space)->params.enable)
+        return NV_ERR_INVALID_STATE;
+
+    if (policy->threshold > UVM_PERF_THRASHING_THRESHOLD_MAX ||
+        policy->pin_threshold > UVM_PERF_THRASHING_PIN_THRESHOLD_MAX)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    return NV_OK;
+}
+
+NV_STATUS uvm_perf_thrashing_reset_block(uvm_va_block_t *va_block, uvm_va_block_context_t *va_block_context)
+{
+    NV_STATUS status;
+
+    uvm_mutex_lock(&va_block->lock);
+
+    // Unmap may split PTEs and require a retry. Needs to be called before the
+    // pinned pages information is destroyed.
+    status = UVM_VA_BLOCK_RETRY_LOCKED(va_block, NULL,
+                 uvm_perf_thrashing_unmap_remote_pinned_pages_all(va_block,
+                                                                  va_block_context,
+                                                                  uvm_va_block_region_from_block(va_block)));
+
+    uvm_perf_thrashing_info_destroy(va_block);
+
+    uvm_mutex_unlock(&va_block->lock);
+
+    return status;
+}
+
 NV_STATUS uvm_test_get_page_thrashing_policy(UVM_TEST_GET_PAGE_THRASHING_POLICY_PARAMS *params, struct file *filp)
 {
     uvm_va_space_t *va_space = uvm_va_space_get(filp);
@@ -2111,21 +2332,9 @@ NV_STATUS uvm_test_set_page_thrashing_policy(UVM_TEST_SET_PAGE_THRASHING_POLICY_
                 continue;
 
             for_each_va_block_in_va_range(va_range, va_block) {
-                uvm_va_block_region_t va_block_region = uvm_va_block_region_from_block(va_block);
                 uvm_va_block_context_t *block_context = uvm_va_space_block_context(va_space, NULL);
 
-                uvm_mutex_lock(&va_block->lock);
-
-                // Unmap may split PTEs and require a retry. Needs to be called
-                // before the pinned pages information is destroyed.
-                status = UVM_VA_BLOCK_RETRY_LOCKED(va_block, NULL,
-                             uvm_perf_thrashing_unmap_remote_pinned_pages_all(va_block,
-                                                                              block_context,
-                                                                              va_block_region));
-
-                uvm_perf_thrashing_info_destroy(va_block);
-
-                uvm_mutex_unlock(&va_block->lock);
+                status = uvm_perf_thrashing_reset_block(va_block, block_context);
 
                 // Re-enable thrashing on failure to avoid getting asserts
                 // about having state while thrashing is disabled
@@ -29,6 +29,7 @@
 #include "uvm_forward_decl.h"
 #include "uvm_processors.h"
 #include "uvm_va_block_types.h"
+#include "uvm_va_policy.h"
 
 typedef enum
 {
@@ -114,4 +115,17 @@ NV_STATUS uvm_perf_thrashing_unmap_remote_pinned_pages_all(uvm_va_block_t *va_bl
                                                            uvm_va_block_context_t *va_block_context,
                                                            uvm_va_block_region_t region);
 
+// Check that the given VA range thrashing policy can be applied on the VA
+// space. Returns NV_ERR_INVALID_STATE if thrashing mitigation is disabled on
+// the VA space, and NV_ERR_INVALID_ARGUMENT if any thresholds are out of
+// bounds. Locking: the VA space lock must be held.
+NV_STATUS uvm_perf_thrashing_policy_check(uvm_va_space_t *va_space, const uvm_va_policy_thrashing_t *policy);
+
+// Unmap the remote mappings of the pinned pages of the given block and destroy
+// its thrashing detection struct. This is used to discard the state tracked
+// under the previous thrashing mitigation parameters when they change.
+// Locking: the VA space lock must be held in write mode, and the va_block
+// lock must not be held.
+NV_STATUS uvm_perf_thrashing_reset_block(uvm_va_block_t *va_block, uvm_va_block_context_t *va_block_context);
+
 #endif
@@ -100,17 +100,43 @@
 // All allocated user memory root chunks are tracked in an LRU list
 // (root_chunks.va_block_used). A root chunk is moved to the tail of that list
 // whenever any of its subchunks is allocated (unpinned) by a VA block (see
-// uvm_pmm_gpu_unpin_allocated()). When a root chunk is selected for eviction,
-// it has the eviction flag set (see pick_root_chunk_to_evict()). This flag
-// affects many of the PMM operations on all of the subchunks of the root chunk
-// being evicted. See usage of (root_)chunk_is_in_eviction(), in particular in
-// chunk_free_locked() and claim_free_chunk().
+// uvm_pmm_gpu_unpin_allocated()). Which chunk of that list gets evicted is
+// decided by the eviction policy (see uvm_pmm_eviction_policy). The default
+// LRU policy evicts the chunk at the head of the list. The opt-in CLOCK policy
+// gives a second chance to the chunks marked as accessed by GPU mappings and
+// access counter notifications since they were last considered (see
+// uvm_pmm_gpu_mark_root_chunk_accessed()). When a root chunk is selected
+// for eviction, it has the eviction flag set (see pick_root_chunk_to_evict()).
+// This flag affects many of the PMM operations on all of the subchunks of the
+// root chunk being evicted. See usage of (root_)chunk_is_in_eviction(), in
+// particular in chunk_free_locked() and claim_free_chunk().
 //
 // To evict a root chunk, all of its free subchunks are pinned, then all
 // resident pages backed by it are moved to the CPU one VA block at a time.
 // After all of them are moved, the root chunk is merged and returned to the
 // caller. See evict_root_chunk() for details.
 //
+// Root chunks holding memory of VA blocks with a GPU resident reservation are
+// kept on a separate list (root_chunks.va_block_reserved) which is never
+// considered for eviction, and PMA eviction of their physical range fails. See
+// root_chunk_update_reserved().
+//
+// Optionally, a per-GPU kthread evicts root chunks ahead of demand whenever the
+// number of free pages in PMA drops below a watermark, so that allocations
+// rarely have to evict synchronously. See uvm_pmm_evict_low_watermark.
+//
+// Free chunks are kept in separate lists depending on whether they are known to
+// be zero (see uvm_gpu_chunk_t::is_zero). Chunks freed by VA blocks are
+// non-zero, and the VA block zeroes them again when they are reused on first
+// touch. Optionally, a per-GPU kthread zeroes free root chunks ahead of time to
+// maintain a pool of zero chunks. See uvm_pmm_zero_pool_target.
+//
+// Optionally, free 4K and 64K user chunks are claimed in batches into per-CPU
+// caches, so that most allocations of those sizes don't have to take the list
+// lock. Cached chunks are pinned and given back to the free lists whenever
+// their root chunks may need to be evicted. See chunk_cache_alloc() and
+// chunk_cache_drain().
+//
 // Eviction is also possible to be triggered by PMA. This makes it possible for
 // other PMA clients (most importantly RM which CUDA uses for non-UVM
 // allocations) to successfully allocate memory from the user memory pool
@@ -185,6 +211,90 @@ MODULE_PARM_DESC(uvm_global_oversubscription, "Enable (1) or disable (0) global
 static unsigned uvm_perf_pma_batch_nonpinned_order = UVM_PERF_PMA_BATCH_NONPINNED_ORDER_DEFAULT;
 module_param(uvm_perf_pma_batch_nonpinned_order, uint, S_IRUGO);
 
+typedef enum
+{
+    UVM_PMM_EVICTION_POLICY_LRU,
+    UVM_PMM_EVICTION_POLICY_CLOCK,
+    UVM_PMM_EVICTION_POLICY_COUNT
+} uvm_pmm_eviction_policy_type_t;
+
+// Policy used to pick the root chunk to evict among the chunks used by VA
+// blocks:
+// 0 - LRU (default): evict the chunk least recently allocated to a VA block
+// 1 - CLOCK: same as LRU, but chunks accessed since they were last considered
+//     are given a second chance
+static unsigned uvm_pmm_eviction_policy = UVM_PMM_EVICTION_POLICY_LRU;
+module_param(uvm_pmm_eviction_policy, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_pmm_eviction_policy, "Root chunk eviction policy: LRU (0, default) or CLOCK (1).");
+
+// Watermarks, in number of free 2M pages in PMA, for background eviction. When
+// the number of free pages drops below uvm_pmm_evict_low_watermark, a per-GPU
+// kthread evicts root chunks until it reaches uvm_pmm_evict_high_watermark, so
+// that allocations don't have to evict synchronously. A low watermark of 0
+// disables background eviction. A high watermark lower than the low watermark
+// is replaced by twice the low watermark.
+#define UVM_PMM_EVICT_WATERMARK_MAX 4096
+
+static unsigned uvm_pmm_evict_low_watermark = 0;
+module_param(uvm_pmm_evict_low_watermark, uint, S_IRUGO);
+
+static unsigned uvm_pmm_evict_high_watermark = 0;
+module_param(uvm_pmm_evict_high_watermark, uint, S_IRUGO);
+
+// Number of zero free root chunks that a per-GPU kthread tries to maintain by
+// zeroing non-zero free root chunks with CE memsets. Only chunks already freed
+// to PMM are zeroed, no memory is allocated from PMA for the pool. 0 disables
+// the pool.
+#define UVM_PMM_ZERO_POOL_TARGET_MAX 1024
+
+static unsigned uvm_pmm_zero_pool_target = 0;
+module_param(uvm_pmm_zero_pool_target, uint, S_IRUGO);
+
+// Number of free 4K and 64K user chunks, each, that can be cached per CPU.
+// Caches are refilled from the free lists in batches to reduce the contention
+// on the list lock. 0 disables the caches.
+#define UVM_PMM_CHUNK_CACHE_MAX 32
+#define UVM_PMM_CHUNK_CACHE_SIZES 2
+
+static unsigned uvm_pmm_chunk_cache_size = 0;
+module_param(uvm_pmm_chunk_cache_size, uint, S_IRUGO);
+
+// Number of free user root chunks kept on the PMM free lists instead of being
+// returned to PMA when they are freed, so that steady-state allocations and
+// frees don't have to call into PMA. The chunks are still returned to PMA when
+// PMA runs low on free memory, and PMA evictions pick them first. 0 returns
+// free root chunks to PMA right away.
+#define UVM_PMM_ROOT_CHUNK_CACHE_MAX 1024
+
+static unsigned uvm_pmm_root_chunk_cache_size = 0;
+module_param(uvm_pmm_root_chunk_cache_size, uint, S_IRUGO);
+
+struct uvm_pmm_gpu_eviction_policy_struct
+{
+    const char *name;
+
+    // Return the root chunk to evict from the root_chunks.va_block_used list,
+    // or NULL if the list is empty. Called with the list lock held.
+    uvm_gpu_chunk_t *(*pick_used_root_chunk)(uvm_pmm_gpu_t *pmm);
+};
+
+// Per-CPU cache of free user chunks smaller than the root chunk size. Cached
+// chunks have been claimed from the free lists, so, exactly like chunks
+// returned by claim_free_chunk(), they are temporarily pinned and accounted as
+// allocated in their parent's suballoc. Slot 0 caches 4K chunks and slot 1
+// caches 64K chunks. See chunk_cache_index().
+struct uvm_pmm_gpu_chunk_cache_struct
+{
+    uvm_spinlock_t lock;
+
+    NvU32 count[UVM_PMM_CHUNK_CACHE_SIZES];
+
+    uvm_gpu_chunk_t *chunks[UVM_PMM_CHUNK_CACHE_SIZES][UVM_PMM_CHUNK_CACHE_MAX];
+
+    // Number of allocations served from the cache
+    NvU64 num_hits;
+};
+
 // Helper type for refcounting cache
 typedef struct
 {
@@ -310,6 +420,9 @@ static NV_STATUS split_gpu_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 static void free_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 static void free_chunk_with_merges(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 static bool free_next_available_root_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type);
+static void free_or_retain_root_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type);
+static NvU32 chunk_cache_drain(uvm_pmm_gpu_t *pmm);
+static NvU32 root_chunk_cache_drain(uvm_pmm_gpu_t *pmm);
 static struct list_head *find_free_list(uvm_pmm_gpu_t *pmm,
                                         uvm_pmm_gpu_memory_type_t type,
                                         uvm_chunk_size_t chunk_size,
@@ -317,6 +430,9 @@ static struct list_head *find_free_list(uvm_pmm_gpu_t *pmm,
 static bool check_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 static struct list_head *find_free_list_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 static void chunk_free_locked(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
+static void zero_pool_check(uvm_pmm_gpu_t *pmm);
+static bool try_chunk_free(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
+static NV_STATUS chunk_walk_pre_order(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *start, chunk_walk_func_t func, void *data);
 
 static size_t root_chunk_index(uvm_pmm_gpu_t *pmm, uvm_gpu_root_chunk_t *root_chunk)
 {
@@ -396,6 +512,17 @@ static bool chunk_is_root_chunk_pinned(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chun
     return chunk->suballoc->pinned_leaf_chunks > 0;
 }
 
+// Whether the chunk is a free user root chunk counted in
+// root_chunk_cache.num_free_chunks. Free root chunks picked for eviction are
+// not counted, as they are being taken off the free lists.
+static bool chunk_is_counted_free_root_chunk(uvm_gpu_chunk_t *chunk)
+{
+    return chunk->state == UVM_PMM_GPU_CHUNK_STATE_FREE &&
+           chunk_is_root_chunk(chunk) &&
+           uvm_pmm_gpu_memory_type_is_user(chunk->type) &&
+           !chunk->in_eviction;
+}
+
 // Pin a chunk and update its root chunk's pinned leaf chunks count if the
 // chunk is not a root chunk.
 static void chunk_pin(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
@@ -404,6 +531,13 @@ static void chunk_pin(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
 
     uvm_assert_spinlock_locked(&pmm->list_lock);
     UVM_ASSERT(chunk->state != UVM_PMM_GPU_CHUNK_STATE_TEMP_PINNED);
+
+    // Pinning takes the chunk off the free lists
+    if (chunk_is_counted_free_root_chunk(chunk)) {
+        UVM_ASSERT(pmm->root_chunk_cache.num_free_chunks > 0);
+        --pmm->root_chunk_cache.num_free_chunks;
+    }
+
     chunk->state = UVM_PMM_GPU_CHUNK_STATE_TEMP_PINNED;
 
     if (chunk_is_root_chunk(chunk))
@@ -575,6 +709,20 @@ NV_STATUS uvm_pmm_gpu_alloc(uvm_pmm_gpu_t *pmm,
         uvm_gpu_root_chunk_t *root_chunk;
 
         status = alloc_chunk(pmm, mem_type, chunk_size, flags, &chunks[i]);
+
+        // Chunks held by the per-CPU caches can prevent their root chunks from
+        // being evicted. Give them back and retry once before failing.
+        if (status == NV_ERR_NO_MEMORY && chunk_cache_drain(pmm) > 0)
+            status = alloc_chunk(pmm, mem_type, chunk_size, flags, &chunks[i]);
+
+        // Free user root chunks retained by PMM can't be used for kernel
+        // allocations when eviction isn't possible. Return them to PMA and
+        // retry once.
+        if (status == NV_ERR_NO_MEMORY &&
+            uvm_pmm_gpu_memory_type_is_kernel(mem_type) &&
+            root_chunk_cache_drain(pmm) > 0)
+            status = alloc_chunk(pmm, mem_type, chunk_size, flags, &chunks[i]);
+
         if (status != NV_OK)
             goto error;
 
@@ -645,6 +793,105 @@ static NV_STATUS pmm_gpu_alloc_kernel(uvm_pmm_gpu_t *pmm,
     return NV_OK;
 }
 
+// Eviction list to move the given root chunk to when it's used by a VA block.
+// Reserved root chunks always go to the reserved list, regardless of the list
+// requested by the caller.
+static struct list_head *root_chunk_eviction_list(uvm_pmm_gpu_t *pmm,
+                                                  uvm_gpu_root_chunk_t *root_chunk,
+                                                  struct list_head *list)
+{
+    uvm_assert_spinlock_locked(&pmm->list_lock);
+
+    if (root_chunk->reserved)
+        return &pmm->root_chunks.va_block_reserved;
+
+    return list;
+}
+
+// Whether the chunk is allocated to a VA block with a GPU resident reservation
+// on the GPU. The caller must either own the chunk or hold the list lock, so
+// that the VA block can't go away.
+static bool chunk_is_resident_reserved(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
+{
+    uvm_va_block_gpu_state_t *gpu_state;
+
+    if (chunk->state != UVM_PMM_GPU_CHUNK_STATE_ALLOCATED || !chunk->va_block)
+        return false;
+
+    gpu_state = uvm_va_block_gpu_state_get(chunk->va_block, uvm_pmm_to_gpu(pmm)->id);
+
+    return gpu_state && gpu_state->resident_reserved;
+}
+
+static void root_chunk_set_reserved_locked(uvm_pmm_gpu_t *pmm, uvm_gpu_root_chunk_t *root_chunk, bool reserved)
+{
+    uvm_gpu_chunk_t *chunk = &root_chunk->chunk;
+
+    uvm_assert_spinlock_locked(&pmm->list_lock);
+
+    if (root_chunk->reserved == reserved)
+        return;
+
+    root_chunk->reserved = reserved;
+    if (reserved)
+        ++pmm->root_chunks.num_reserved;
+    else
+        --pmm->root_chunks.num_reserved;
+
+    // Move the root chunk between the reserved and used lists if it's on one
+    // of the eviction lists. Otherwise, chunk_update_lists_locked() picks the
+    // right list once the root chunk is unpinned.
+    if ((chunk->state == UVM_PMM_GPU_CHUNK_STATE_ALLOCATED || chunk->state == UVM_PMM_GPU_CHUNK_STATE_IS_SPLIT) &&
+        !chunk_is_root_chunk_pinned(pmm, chunk) &&
+        !chunk_is_in_eviction(pmm, chunk)) {
+        UVM_ASSERT(!list_empty(&chunk->list));
+
+        list_move_tail(&chunk->list, reserved ? &pmm->root_chunks.va_block_reserved : &pmm->root_chunks.va_block_used);
+    }
+}
+
+static NV_STATUS find_resident_reserved_chunk_func(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, void *data)
+{
+    bool reserved;
+
+    uvm_spin_lock(&pmm->list_lock);
+    reserved = chunk_is_resident_reserved(pmm, chunk);
+    uvm_spin_unlock(&pmm->list_lock);
+
+    // Stop the walk at the first reserved chunk
+    return reserved ? NV_ERR_MORE_DATA_AVAILABLE : NV_OK;
+}
+
+// Recompute whether the root chunk is reserved from the VA blocks its chunks
+// are allocated to. This has to be called after any chunk of the root chunk
+// becomes allocated to, or stops being allocated to, a VA block with a GPU
+// resident reservation, and after any such VA block changes its reservation.
+//
+// The PMM lock serializes the updates, so that a walk can't overwrite the
+// result of a more recent update of another chunk of the same root chunk.
+static void root_chunk_update_reserved(uvm_pmm_gpu_t *pmm, uvm_gpu_root_chunk_t *root_chunk)
+{
+    NV_STATUS status;
+
+    uvm_mutex_lock(&pmm->lock);
+
+    status = chunk_walk_pre_order(pmm, &root_chunk->chunk, find_resident_reserved_chunk_func, NULL);
+    UVM_ASSERT(status == NV_OK || status == NV_ERR_MORE_DATA_AVAILABLE);
+
+    uvm_spin_lock(&pmm->list_lock);
+    root_chunk_set_reserved_locked(pmm, root_chunk, status == NV_ERR_MORE_DATA_AVAILABLE);
+    uvm_spin_unlock(&pmm->list_lock);
+
+    uvm_mutex_unlock(&pmm->lock);
+}
+
+void uvm_pmm_gpu_update_root_chunk_reservation(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
+{
+    UVM_ASSERT(uvm_pmm_gpu_memory_type_is_user(chunk->type));
+
+    root_chunk_update_reserved(pmm, root_chunk_from_chunk(pmm, chunk));
+}
+
 static void chunk_update_lists_locked(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
 {
     uvm_gpu_root_chunk_t *root_chunk = root_chunk_from_chunk(pmm, chunk);
@@ -660,13 +907,18 @@ static void chunk_update_lists_locked(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk
         else if (root_chunk->chunk.state != UVM_PMM_GPU_CHUNK_STATE_FREE) {
             UVM_ASSERT(root_chunk->chunk.state == UVM_PMM_GPU_CHUNK_STATE_IS_SPLIT ||
                        root_chunk->chunk.state == UVM_PMM_GPU_CHUNK_STATE_ALLOCATED);
-            list_move_tail(&root_chunk->chunk.list, &pmm->root_chunks.va_block_used);
+            list_move_tail(&root_chunk->chunk.list,
+                           root_chunk_eviction_list(pmm, root_chunk, &pmm->root_chunks.va_block_used));
         }
     }
 
     // TODO: Bug 1757148: Improve fragmentation of split chunks
-    if (chunk->state == UVM_PMM_GPU_CHUNK_STATE_FREE)
+    if (chunk->state == UVM_PMM_GPU_CHUNK_STATE_FREE) {
         list_move_tail(&chunk->list, find_free_list_chunk(pmm, chunk));
+
+        if (chunk_is_counted_free_root_chunk(chunk))
+            ++pmm->root_chunk_cache.num_free_chunks;
+    }
     else if (chunk->state == UVM_PMM_GPU_CHUNK_STATE_TEMP_PINNED)
         list_del_init(&chunk->list);
 }
@@ -693,6 +945,9 @@ static void gpu_unpin_temp(uvm_pmm_gpu_t *pmm,
     chunk_update_lists_locked(pmm, chunk);
 
     uvm_spin_unlock(&pmm->list_lock);
+
+    if (chunk_is_resident_reserved(pmm, chunk))
+        root_chunk_update_reserved(pmm, root_chunk_from_chunk(pmm, chunk));
 }
 
 void uvm_pmm_gpu_unpin_allocated(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, uvm_va_block_t *va_block)
@@ -708,6 +963,8 @@ void uvm_pmm_gpu_unpin_referenced(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, uv
 void uvm_pmm_gpu_free(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, uvm_tracker_t *tracker)
 {
     NV_STATUS status;
+    uvm_gpu_root_chunk_t *reserved_root_chunk = NULL;
+    bool is_user;
 
     if (!chunk)
         return;
@@ -734,7 +991,19 @@ void uvm_pmm_gpu_free(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, uvm_tracker_t
         root_chunk_unlock(pmm, root_chunk);
     }
 
+    is_user = uvm_pmm_gpu_memory_type_is_user(chunk->type);
+
+    if (is_user && chunk_is_resident_reserved(pmm, chunk))
+        reserved_root_chunk = root_chunk_from_chunk(pmm, chunk);
+
     free_chunk(pmm, chunk);
+
+    // The root chunk may not be reserved any more
+    if (reserved_root_chunk)
+        root_chunk_update_reserved(pmm, reserved_root_chunk);
+
+    if (is_user)
+        zero_pool_check(pmm);
 }
 
 static NvU32 num_subchunks(uvm_gpu_chunk_t *parent)
@@ -1388,10 +1657,16 @@ static NV_STATUS evict_root_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_root_chunk_t *root
     UVM_ASSERT(chunk->state == UVM_PMM_GPU_CHUNK_STATE_TEMP_PINNED);
     uvm_gpu_chunk_set_in_eviction(chunk, false);
 
+    // The root chunk could have become reserved after it was picked for
+    // eviction. None of its memory is used by VA blocks any more.
+    root_chunk_set_reserved_locked(pmm, root_chunk, false);
+
     chunk->is_zero = false;
 
     uvm_spin_unlock(&pmm->list_lock);
 
+    atomic64_inc(&pmm->eviction_stats.num_evicted_root_chunks);
+
     // Bug 2085760: Check if there is any page within the evicted chunk with an
     // elevated refcount. In such case there is another holder of the page,
     // which prevents us from reusing it. This can happen on systems where
@@ -1452,6 +1727,9 @@ static bool chunk_is_evictable(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
     if (chunk_is_in_eviction(pmm, chunk))
         return false;
 
+    if (root_chunk->reserved)
+        return false;
+
     // An evictable chunk's root should be on one of the eviction lists.
     UVM_ASSERT(!list_empty(&root_chunk->chunk.list));
 
@@ -1468,8 +1746,14 @@ static void chunk_start_eviction(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
     UVM_ASSERT(chunk_is_evictable(pmm, chunk));
     UVM_ASSERT(!list_empty(&chunk->list));
 
+    if (chunk_is_counted_free_root_chunk(chunk)) {
+        UVM_ASSERT(pmm->root_chunk_cache.num_free_chunks > 0);
+        --pmm->root_chunk_cache.num_free_chunks;
+    }
+
     list_del_init(&chunk->list);
     uvm_gpu_chunk_set_in_eviction(chunk, true);
+    atomic_set(&root_chunk->accessed, 0);
 }
 
 static void root_chunk_update_eviction_list(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, struct list_head *list)
@@ -1486,7 +1770,7 @@ static void root_chunk_update_eviction_list(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t
         // eviction lists.
         UVM_ASSERT(!list_empty(&chunk->list));
 
-        list_move_tail(&chunk->list, list);
+        list_move_tail(&chunk->list, root_chunk_eviction_list(pmm, root_chunk_from_chunk(pmm, chunk), list));
     }
 
     uvm_spin_unlock(&pmm->list_lock);
@@ -1502,22 +1786,92 @@ void uvm_pmm_gpu_mark_root_chunk_unused(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chu
     root_chunk_update_eviction_list(pmm, chunk, &pmm->root_chunks.va_block_unused);
 }
 
-static uvm_gpu_root_chunk_t *pick_root_chunk_to_evict(uvm_pmm_gpu_t *pmm)
+void uvm_pmm_gpu_mark_root_chunk_accessed(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
+{
+    uvm_gpu_root_chunk_t *root_chunk = root_chunk_from_chunk(pmm, chunk);
+
+    UVM_ASSERT(uvm_pmm_gpu_memory_type_is_user(chunk->type));
+
+    // Avoid dirtying the cache line if the chunk is already marked
+    if (!atomic_read(&root_chunk->accessed))
+        atomic_set(&root_chunk->accessed, 1);
+}
+
+static uvm_gpu_chunk_t *eviction_lru_pick_used_root_chunk(uvm_pmm_gpu_t *pmm)
+{
+    uvm_assert_spinlock_locked(&pmm->list_lock);
+
+    return list_first_chunk(&pmm->root_chunks.va_block_used);
+}
+
+static uvm_gpu_chunk_t *eviction_clock_pick_used_root_chunk(uvm_pmm_gpu_t *pmm)
 {
     uvm_gpu_chunk_t *chunk;
+    size_t i;
+
+    uvm_assert_spinlock_locked(&pmm->list_lock);
+
+    // The head of the list acts as the clock hand. Accessed chunks get their
+    // flag cleared and are moved to the tail. Each chunk is on the list at most
+    // once, so after a full revolution all flags are clear and the chunk at
+    // the head is picked.
+    for (i = 0; i < pmm->root_chunks.count; ++i) {
+        uvm_gpu_root_chunk_t *root_chunk;
+
+        chunk = list_first_chunk(&pmm->root_chunks.va_block_used);
+        if (!chunk)
+            return NULL;
+
+        root_chunk = root_chunk_from_chunk(pmm, chunk);
+        if (!atomic_xchg(&root_chunk->accessed, 0))
+            return chunk;
+
+        list_move_tail(&chunk->list, &pmm->root_chunks.va_block_used);
+        atomic64_inc(&pmm->eviction_stats.num_second_chances);
+    }
+
+    return list_first_chunk(&pmm->root_chunks.va_block_used);
+}
+
+static const uvm_pmm_gpu_eviction_policy_t g_pmm_eviction_policies[UVM_PMM_EVICTION_POLICY_COUNT] =
+{
+    [UVM_PMM_EVICTION_POLICY_LRU] =
+    {
+        .name = "lru",
+        .pick_used_root_chunk = eviction_lru_pick_used_root_chunk,
+    },
+    [UVM_PMM_EVICTION_POLICY_CLOCK] =
+    {
+        .name = "clock",
+        .pick_used_root_chunk = eviction_clock_pick_used_root_chunk,
+    },
+};
+
+const char *uvm_pmm_gpu_eviction_policy_name(uvm_pmm_gpu_t *pmm)
+{
+    return pmm->eviction_policy->name;
+}
+
+// Pick a root chunk to evict and mark it as in eviction. Free root chunks are
+// only considered if include_free is true.
+static uvm_gpu_root_chunk_t *pick_root_chunk_to_evict(uvm_pmm_gpu_t *pmm, bool include_free)
+{
+    uvm_gpu_chunk_t *chunk = NULL;
 
     uvm_spin_lock(&pmm->list_lock);
 
     // Check if there are root chunks sitting in the free lists. Non-zero
     // chunks are preferred.
-    chunk = list_first_chunk(find_free_list(pmm,
-                                            UVM_PMM_GPU_MEMORY_TYPE_USER,
-                                            UVM_CHUNK_SIZE_MAX,
-                                            UVM_PMM_LIST_NO_ZERO));
-    if (chunk)
-        UVM_ASSERT(!chunk->is_zero);
+    if (include_free) {
+        chunk = list_first_chunk(find_free_list(pmm,
+                                                UVM_PMM_GPU_MEMORY_TYPE_USER,
+                                                UVM_CHUNK_SIZE_MAX,
+                                                UVM_PMM_LIST_NO_ZERO));
+        if (chunk)
+            UVM_ASSERT(!chunk->is_zero);
+    }
 
-    if (!chunk) {
+    if (!chunk && include_free) {
         chunk = list_first_chunk(find_free_list(pmm,
                                                 UVM_PMM_GPU_MEMORY_TYPE_USER,
                                                 UVM_CHUNK_SIZE_MAX,
@@ -1529,10 +1883,8 @@ static uvm_gpu_root_chunk_t *pick_root_chunk_to_evict(uvm_pmm_gpu_t *pmm)
     if (!chunk)
         chunk = list_first_chunk(&pmm->root_chunks.va_block_unused);
 
-    // TODO: Bug 1765193: Move the chunks to the tail of the used list whenever
-    // they get mapped.
     if (!chunk)
-        chunk = list_first_chunk(&pmm->root_chunks.va_block_used);
+        chunk = pmm->eviction_policy->pick_used_root_chunk(pmm);
 
     if (chunk)
         chunk_start_eviction(pmm, chunk);
@@ -1558,7 +1910,7 @@ static NV_STATUS pick_and_evict_root_chunk(uvm_pmm_gpu_t *pmm,
 
     uvm_assert_mutex_locked(&pmm->lock);
 
-    root_chunk = pick_root_chunk_to_evict(pmm);
+    root_chunk = pick_root_chunk_to_evict(pmm, true);
     if (!root_chunk)
         return NV_ERR_NO_MEMORY;
 
@@ -1619,6 +1971,123 @@ static NV_STATUS pick_and_evict_root_chunk_retry(uvm_pmm_gpu_t *pmm,
     return status;
 }
 
+static NvU64 pma_free_root_chunks(uvm_pmm_gpu_t *pmm)
+{
+    return UVM_READ_ONCE(pmm->pma_stats->numFreePages2m);
+}
+
+static void background_eviction(void *args)
+{
+    uvm_pmm_gpu_t *pmm = (uvm_pmm_gpu_t *)args;
+    NvU64 i;
+
+    // Chunks held by the per-CPU caches are pinned, which keeps their root
+    // chunks from being evicted or freed. Give them back first, and return the
+    // root chunks that became free to PMA so that they count towards the
+    // watermark. Draining doesn't free root chunks by itself.
+    if (chunk_cache_drain(pmm) > 0) {
+        while (free_next_available_root_chunk(pmm, UVM_PMM_GPU_MEMORY_TYPE_USER))
+            ;
+    }
+
+    // Free root chunks retained by PMM are given back to PMA before anything
+    // gets evicted.
+    root_chunk_cache_drain(pmm);
+
+    // Bound the amount of work done per wake-up, in case other PMA clients
+    // keep allocating the memory freed here.
+    for (i = 0; i < pmm->background_eviction.high_watermark; ++i) {
+        uvm_gpu_root_chunk_t *root_chunk;
+        NV_STATUS status;
+
+        if (pma_free_root_chunks(pmm) >= pmm->background_eviction.high_watermark)
+            break;
+
+        uvm_mutex_lock(&pmm->lock);
+
+        // Free root chunks are left alone as they are immediately available to
+        // allocations.
+        root_chunk = pick_root_chunk_to_evict(pmm, false);
+        if (!root_chunk) {
+            uvm_mutex_unlock(&pmm->lock);
+            break;
+        }
+
+        status = evict_root_chunk(pmm, root_chunk, PMM_CONTEXT_DEFAULT);
+        if (status == NV_OK)
+            free_root_chunk(pmm, root_chunk, FREE_ROOT_CHUNK_MODE_DEFAULT);
+
+        uvm_mutex_unlock(&pmm->lock);
+
+        // NV_ERR_IN_USE means the chunk had to be given back to PMA because
+        // of an elevated page refcount, which still frees memory.
+        if (status != NV_OK && status != NV_ERR_IN_USE)
+            break;
+
+        atomic64_inc(&pmm->background_eviction.num_evicted_root_chunks);
+    }
+}
+
+static void background_eviction_entry(void *args)
+{
+    UVM_ENTRY_VOID(background_eviction(args));
+}
+
+// Wake up the background eviction kthread if the number of free root chunks
+// dropped below the low watermark
+static void background_eviction_check(uvm_pmm_gpu_t *pmm)
+{
+    if (!pmm->background_eviction.enabled)
+        return;
+
+    if (pma_free_root_chunks(pmm) < pmm->background_eviction.low_watermark)
+        nv_kthread_q_schedule_q_item(&pmm->background_eviction.q, &pmm->background_eviction.q_item);
+}
+
+void uvm_pmm_gpu_flush_background_eviction(uvm_pmm_gpu_t *pmm)
+{
+    if (pmm->background_eviction.enabled)
+        nv_kthread_q_flush(&pmm->background_eviction.q);
+}
+
+static NV_STATUS background_eviction_init(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+    char kthread_name[TASK_COMM_LEN + 1];
+    NV_STATUS status;
+
+    if (uvm_pmm_evict_low_watermark == 0 || !pmm->pma_stats || !uvm_parent_gpu_supports_eviction(gpu->parent))
+        return NV_OK;
+
+    pmm->background_eviction.low_watermark = min_t(NvU64, uvm_pmm_evict_low_watermark, UVM_PMM_EVICT_WATERMARK_MAX);
+
+    if (uvm_pmm_evict_high_watermark >= pmm->background_eviction.low_watermark)
+        pmm->background_eviction.high_watermark = min_t(NvU64,
+                                                        uvm_pmm_evict_high_watermark,
+                                                        2 * UVM_PMM_EVICT_WATERMARK_MAX);
+    else
+        pmm->background_eviction.high_watermark = 2 * pmm->background_eviction.low_watermark;
+
+    nv_kthread_q_item_init(&pmm->background_eviction.q_item, background_eviction_entry, pmm);
+
+    snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u EV", uvm_id_value(gpu->id));
+    status = uvm_kthread_q_init_on_node(&pmm->background_eviction.q, kthread_name, gpu->parent->closest_cpu_numa_node);
+    if (status != NV_OK)
+        return status;
+
+    pmm->background_eviction.enabled = true;
+
+    return NV_OK;
+}
+
+static void background_eviction_deinit(uvm_pmm_gpu_t *pmm)
+{
+    pmm->background_eviction.enabled = false;
+
+    // Safe to call even if the queue was never initialized
+    nv_kthread_q_stop(&pmm->background_eviction.q);
+}
+
 static uvm_gpu_chunk_t *find_free_chunk_locked(uvm_pmm_gpu_t *pmm,
                                                uvm_pmm_gpu_memory_type_t type,
                                                uvm_chunk_size_t chunk_size,
@@ -1659,11 +2128,13 @@ static uvm_gpu_chunk_t *find_free_chunk_locked(uvm_pmm_gpu_t *pmm,
     return NULL;
 }
 
-static uvm_gpu_chunk_t *claim_free_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type, uvm_chunk_size_t chunk_size)
+static uvm_gpu_chunk_t *claim_free_chunk_locked(uvm_pmm_gpu_t *pmm,
+                                                uvm_pmm_gpu_memory_type_t type,
+                                                uvm_chunk_size_t chunk_size)
 {
     uvm_gpu_chunk_t *chunk;
 
-    uvm_spin_lock(&pmm->list_lock);
+    uvm_assert_spinlock_locked(&pmm->list_lock);
 
     // Prefer zero free chunks as they are likely going to be used for a new
     // allocation.
@@ -1676,7 +2147,14 @@ static uvm_gpu_chunk_t *claim_free_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_
         chunk = find_free_chunk_locked(pmm, type, chunk_size, UVM_PMM_LIST_NO_ZERO);
 
     if (!chunk)
-        goto out;
+        return NULL;
+
+    if (pmm->zero_pool.enabled && uvm_pmm_gpu_memory_type_is_user(type)) {
+        if (chunk->is_zero)
+            atomic64_inc(&pmm->zero_pool.num_zero_hits);
+        else
+            atomic64_inc(&pmm->zero_pool.num_zero_misses);
+    }
 
     UVM_ASSERT_MSG(uvm_gpu_chunk_get_size(chunk) == chunk_size,
                    "chunk size %u expected %u\n",
@@ -1697,12 +2175,445 @@ static uvm_gpu_chunk_t *claim_free_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_
     chunk_pin(pmm, chunk);
     chunk_update_lists_locked(pmm, chunk);
 
-out:
+    ++pmm->claim_stats.num_claimed_chunks;
+
+    return chunk;
+}
+
+// Take the list lock for claiming free chunks and account for its contention
+static void claim_lock(uvm_pmm_gpu_t *pmm)
+{
+    // spin_is_locked() is racy, but good enough for statistics
+    bool contended = spin_is_locked(&pmm->list_lock.lock);
+
+    uvm_spin_lock(&pmm->list_lock);
+
+    ++pmm->claim_stats.num_lock_acquisitions;
+    if (contended)
+        ++pmm->claim_stats.num_lock_contended;
+}
+
+static uvm_gpu_chunk_t *claim_free_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type, uvm_chunk_size_t chunk_size)
+{
+    uvm_gpu_chunk_t *chunk;
+
+    claim_lock(pmm);
+    chunk = claim_free_chunk_locked(pmm, type, chunk_size);
     uvm_spin_unlock(&pmm->list_lock);
 
+    // Refill the pool if a zero chunk was consumed
+    if (chunk && chunk->is_zero && uvm_pmm_gpu_memory_type_is_user(type))
+        zero_pool_check(pmm);
+
     return chunk;
 }
 
+// Claim up to num_chunks free chunks with a single acquisition of the list
+// lock. Returns the number of chunks claimed.
+static NvU32 claim_free_chunks(uvm_pmm_gpu_t *pmm,
+                               uvm_pmm_gpu_memory_type_t type,
+                               uvm_chunk_size_t chunk_size,
+                               NvU32 num_chunks,
+                               uvm_gpu_chunk_t **chunks)
+{
+    bool claimed_zero = false;
+    NvU32 i;
+
+    claim_lock(pmm);
+
+    for (i = 0; i < num_chunks; ++i) {
+        chunks[i] = claim_free_chunk_locked(pmm, type, chunk_size);
+        if (!chunks[i])
+            break;
+
+        claimed_zero = claimed_zero || chunks[i]->is_zero;
+    }
+
+    uvm_spin_unlock(&pmm->list_lock);
+
+    if (claimed_zero && uvm_pmm_gpu_memory_type_is_user(type))
+        zero_pool_check(pmm);
+
+    return i;
+}
+
+// Index of the per-CPU cache slots used for chunks of the given type and size,
+// or -1 if such chunks are not cached.
+static int chunk_cache_index(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type, uvm_chunk_size_t chunk_size)
+{
+    if (!pmm->chunk_cache.enabled || type != UVM_PMM_GPU_MEMORY_TYPE_USER)
+        return -1;
+
+    if (chunk_size == UVM_CHUNK_SIZE_4K)
+        return 0;
+
+    if (chunk_size == UVM_CHUNK_SIZE_64K)
+        return 1;
+
+    return -1;
+}
+
+// Give a chunk held by a per-CPU cache back to the free lists. Unlike
+// free_chunk(), this never frees root chunks back to PMA, so it's safe to call
+// from the PMA eviction callbacks.
+static void chunk_cache_release_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
+{
+    UVM_ASSERT(chunk->state == UVM_PMM_GPU_CHUNK_STATE_TEMP_PINNED);
+
+    if (!try_chunk_free(pmm, chunk)) {
+        uvm_mutex_lock(&pmm->lock);
+        free_chunk_with_merges(pmm, chunk);
+        uvm_mutex_unlock(&pmm->lock);
+    }
+}
+
+// Allocate a chunk from the current CPU's cache. The cache is refilled from
+// the free lists in a batch when empty. Returns NULL if no free chunk of the
+// given size is available, in which case the caller has to split a bigger
+// chunk or allocate from PMA.
+static uvm_gpu_chunk_t *chunk_cache_alloc(uvm_pmm_gpu_t *pmm, int index, uvm_chunk_size_t chunk_size)
+{
+    uvm_gpu_chunk_t *chunks[UVM_PMM_CHUNK_CACHE_MAX];
+    uvm_pmm_gpu_chunk_cache_t *cache;
+    uvm_gpu_chunk_t *chunk = NULL;
+    NvU32 num_chunks;
+    NvU32 i;
+
+    // The thread can migrate to another CPU after getting the pointer, which
+    // is fine as the cache is protected by its lock. Preemption can't stay
+    // disabled as the refill below may block on the list lock for long.
+    cache = raw_cpu_ptr(pmm->chunk_cache.caches);
+
+    uvm_spin_lock(&cache->lock);
+    if (cache->count[index] > 0) {
+        chunk = cache->chunks[index][--cache->count[index]];
+        ++cache->num_hits;
+    }
+    uvm_spin_unlock(&cache->lock);
+
+    if (chunk)
+        return chunk;
+
+    num_chunks = claim_free_chunks(pmm, UVM_PMM_GPU_MEMORY_TYPE_USER, chunk_size, pmm->chunk_cache.batch, chunks);
+    if (num_chunks == 0)
+        return NULL;
+
+    // Keep the first chunk and stash the rest
+    uvm_spin_lock(&cache->lock);
+    for (i = 1; i < num_chunks && cache->count[index] < pmm->chunk_cache.capacity; ++i)
+        cache->chunks[index][cache->count[index]++] = chunks[i];
+    uvm_spin_unlock(&cache->lock);
+
+    // The cache could have been refilled by another thread in the meantime
+    for (; i < num_chunks; ++i)
+        chunk_cache_release_chunk(pmm, chunks[i]);
+
+    return chunks[0];
+}
+
+// Give all the chunks held by all the per-CPU caches back to the free lists.
+// Cached chunks are pinned, which prevents their root chunks from being
+// evicted. Returns the number of chunks released.
+static NvU32 chunk_cache_drain(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_chunk_t *chunks[UVM_PMM_CHUNK_CACHE_MAX];
+    NvU32 num_released = 0;
+    int cpu;
+
+    if (!pmm->chunk_cache.enabled)
+        return 0;
+
+    for_each_possible_cpu(cpu) {
+        uvm_pmm_gpu_chunk_cache_t *cache = per_cpu_ptr(pmm->chunk_cache.caches, cpu);
+        int index;
+
+        for (index = 0; index < UVM_PMM_CHUNK_CACHE_SIZES; ++index) {
+            NvU32 num_chunks;
+            NvU32 i;
+
+            uvm_spin_lock(&cache->lock);
+            num_chunks = cache->count[index];
+            memcpy(chunks, cache->chunks[index], num_chunks * sizeof(chunks[0]));
+            cache->count[index] = 0;
+            uvm_spin_unlock(&cache->lock);
+
+            for (i = 0; i < num_chunks; ++i)
+                chunk_cache_release_chunk(pmm, chunks[i]);
+
+            num_released += num_chunks;
+        }
+    }
+
+    atomic64_add(num_released, &pmm->chunk_cache.num_drained_chunks);
+
+    return num_released;
+}
+
+NvU64 uvm_pmm_gpu_chunk_cache_hits(uvm_pmm_gpu_t *pmm)
+{
+    NvU64 num_hits = 0;
+    int cpu;
+
+    if (!pmm->chunk_cache.enabled)
+        return 0;
+
+    for_each_possible_cpu(cpu) {
+        uvm_pmm_gpu_chunk_cache_t *cache = per_cpu_ptr(pmm->chunk_cache.caches, cpu);
+
+        uvm_spin_lock(&cache->lock);
+        num_hits += cache->num_hits;
+        uvm_spin_unlock(&cache->lock);
+    }
+
+    return num_hits;
+}
+
+static NV_STATUS chunk_cache_init(uvm_pmm_gpu_t *pmm)
+{
+    int cpu;
+
+    if (uvm_pmm_chunk_cache_size == 0)
+        return NV_OK;
+
+    if (!(pmm->chunk_sizes[UVM_PMM_GPU_MEMORY_TYPE_USER] & (UVM_CHUNK_SIZE_4K | UVM_CHUNK_SIZE_64K)))
+        return NV_OK;
+
+    if (uvm_pmm_chunk_cache_size > UVM_PMM_CHUNK_CACHE_MAX) {
+        pr_info("Invalid value %u for uvm_pmm_chunk_cache_size. Using %u instead\n",
+                uvm_pmm_chunk_cache_size,
+                UVM_PMM_CHUNK_CACHE_MAX);
+        pmm->chunk_cache.capacity = UVM_PMM_CHUNK_CACHE_MAX;
+    }
+    else {
+        pmm->chunk_cache.capacity = uvm_pmm_chunk_cache_size;
+    }
+
+    // Refill half of the cache at a time, so that alternating allocations and
+    // frees on a CPU don't keep hitting the list lock.
+    pmm->chunk_cache.batch = max(pmm->chunk_cache.capacity / 2, 1u);
+
+    pmm->chunk_cache.caches = alloc_percpu(uvm_pmm_gpu_chunk_cache_t);
+    if (!pmm->chunk_cache.caches)
+        return NV_ERR_NO_MEMORY;
+
+    for_each_possible_cpu(cpu) {
+        uvm_pmm_gpu_chunk_cache_t *cache = per_cpu_ptr(pmm->chunk_cache.caches, cpu);
+
+        uvm_spin_lock_init(&cache->lock, UVM_LOCK_ORDER_LEAF);
+    }
+
+    pmm->chunk_cache.enabled = true;
+
+    return NV_OK;
+}
+
+static void root_chunk_cache_init(uvm_pmm_gpu_t *pmm)
+{
+    if (uvm_pmm_root_chunk_cache_size == 0 || !pmm->pma)
+        return;
+
+    if (uvm_pmm_root_chunk_cache_size > UVM_PMM_ROOT_CHUNK_CACHE_MAX) {
+        pr_info("Invalid value %u for uvm_pmm_root_chunk_cache_size. Using %u instead\n",
+                uvm_pmm_root_chunk_cache_size,
+                UVM_PMM_ROOT_CHUNK_CACHE_MAX);
+        pmm->root_chunk_cache.capacity = UVM_PMM_ROOT_CHUNK_CACHE_MAX;
+    }
+    else {
+        pmm->root_chunk_cache.capacity = uvm_pmm_root_chunk_cache_size;
+    }
+}
+
+static void chunk_cache_deinit(uvm_pmm_gpu_t *pmm)
+{
+    chunk_cache_drain(pmm);
+
+    pmm->chunk_cache.enabled = false;
+
+    free_percpu(pmm->chunk_cache.caches);
+    pmm->chunk_cache.caches = NULL;
+}
+
+// Number of zero free root chunks in the pool, capped to the pool target
+static NvU32 zero_pool_size_locked(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_chunk_t *chunk;
+    NvU32 count = 0;
+
+    uvm_assert_spinlock_locked(&pmm->list_lock);
+
+    list_for_each_entry(chunk,
+                        find_free_list(pmm, UVM_PMM_GPU_MEMORY_TYPE_USER, UVM_CHUNK_SIZE_MAX, UVM_PMM_LIST_ZERO),
+                        list) {
+        if (++count == pmm->zero_pool.target)
+            break;
+    }
+
+    return count;
+}
+
+// Claim a non-zero free root chunk to be zeroed, unless the pool is already
+// full. The chunk is temporarily pinned, which removes it from the free lists
+// and protects it from eviction while it's being zeroed.
+static uvm_gpu_chunk_t *zero_pool_claim_chunk(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_chunk_t *chunk = NULL;
+
+    uvm_spin_lock(&pmm->list_lock);
+
+    if (zero_pool_size_locked(pmm) < pmm->zero_pool.target) {
+        chunk = find_free_chunk_locked(pmm, UVM_PMM_GPU_MEMORY_TYPE_USER, UVM_CHUNK_SIZE_MAX, UVM_PMM_LIST_NO_ZERO);
+        if (chunk) {
+            UVM_ASSERT(chunk->state == UVM_PMM_GPU_CHUNK_STATE_FREE);
+            UVM_ASSERT(!chunk_is_in_eviction(pmm, chunk));
+
+            chunk_pin(pmm, chunk);
+            chunk_update_lists_locked(pmm, chunk);
+        }
+    }
+
+    uvm_spin_unlock(&pmm->list_lock);
+
+    return chunk;
+}
+
+static NV_STATUS zero_pool_zero_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+    uvm_gpu_root_chunk_t *root_chunk = root_chunk_from_chunk(pmm, chunk);
+    uvm_tracker_t tracker = UVM_TRACKER_INIT();
+    uvm_push_t push;
+    NV_STATUS status;
+
+    // The chunk may still have pending work from its previous owner
+    root_chunk_lock(pmm, root_chunk);
+    uvm_tracker_remove_completed(&root_chunk->tracker);
+    status = uvm_tracker_add_tracker_safe(&tracker, &root_chunk->tracker);
+    root_chunk_unlock(pmm, root_chunk);
+
+    if (status != NV_OK)
+        goto out;
+
+    status = uvm_push_begin_acquire(gpu->channel_manager,
+                                    UVM_CHANNEL_TYPE_GPU_INTERNAL,
+                                    &tracker,
+                                    &push,
+                                    "Zero free root chunk 0x%llx",
+                                    chunk->address);
+    if (status != NV_OK)
+        goto out;
+
+    gpu->parent->ce_hal->memset_8(&push,
+                                  uvm_gpu_address_copy(gpu, uvm_gpu_phys_address(UVM_APERTURE_VID, chunk->address)),
+                                  0,
+                                  UVM_CHUNK_SIZE_MAX);
+
+    // The end of the push provides the membar required before the chunk gets
+    // mapped, and waiting for it lets the chunk be handed out without a
+    // tracker.
+    status = uvm_push_end_and_wait(&push);
+
+out:
+    uvm_tracker_deinit(&tracker);
+
+    return status;
+}
+
+// Return the chunk claimed by zero_pool_claim_chunk() to the free lists
+static void zero_pool_release_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, bool is_zero)
+{
+    uvm_spin_lock(&pmm->list_lock);
+
+    UVM_ASSERT(chunk->state == UVM_PMM_GPU_CHUNK_STATE_TEMP_PINNED);
+
+    chunk_unpin(pmm, chunk, UVM_PMM_GPU_CHUNK_STATE_FREE);
+    chunk->is_zero = is_zero;
+    chunk_update_lists_locked(pmm, chunk);
+
+    uvm_spin_unlock(&pmm->list_lock);
+}
+
+static void zero_pool_fill(void *args)
+{
+    uvm_pmm_gpu_t *pmm = (uvm_pmm_gpu_t *)args;
+    NvU32 i;
+
+    for (i = 0; i < pmm->zero_pool.target; ++i) {
+        uvm_gpu_chunk_t *chunk;
+        NV_STATUS status;
+
+        chunk = zero_pool_claim_chunk(pmm);
+        if (!chunk)
+            break;
+
+        status = zero_pool_zero_chunk(pmm, chunk);
+        zero_pool_release_chunk(pmm, chunk, status == NV_OK);
+
+        if (status != NV_OK)
+            break;
+
+        atomic64_inc(&pmm->zero_pool.num_zeroed_chunks);
+    }
+}
+
+static void zero_pool_fill_entry(void *args)
+{
+    UVM_ENTRY_VOID(zero_pool_fill(args));
+}
+
+// Wake up the zeroing kthread. It checks whether the pool needs to be refilled
+// itself, so that this can be called from the allocation and free paths
+// without taking the list lock.
+static void zero_pool_check(uvm_pmm_gpu_t *pmm)
+{
+    if (pmm->zero_pool.enabled)
+        nv_kthread_q_schedule_q_item(&pmm->zero_pool.q, &pmm->zero_pool.q_item);
+}
+
+void uvm_pmm_gpu_flush_zero_pool(uvm_pmm_gpu_t *pmm)
+{
+    if (pmm->zero_pool.enabled)
+        nv_kthread_q_flush(&pmm->zero_pool.q);
+}
+
+NV_STATUS uvm_pmm_gpu_zero_pool_init(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+    char kthread_name[TASK_COMM_LEN + 1];
+    NV_STATUS status;
+
+    if (uvm_pmm_zero_pool_target == 0 || !pmm->initialized || gpu->mem_info.size == 0)
+        return NV_OK;
+
+    if (uvm_pmm_zero_pool_target > UVM_PMM_ZERO_POOL_TARGET_MAX) {
+        pr_info("Invalid value %u for uvm_pmm_zero_pool_target. Using %u instead\n",
+                uvm_pmm_zero_pool_target,
+                UVM_PMM_ZERO_POOL_TARGET_MAX);
+        pmm->zero_pool.target = UVM_PMM_ZERO_POOL_TARGET_MAX;
+    }
+    else {
+        pmm->zero_pool.target = uvm_pmm_zero_pool_target;
+    }
+
+    nv_kthread_q_item_init(&pmm->zero_pool.q_item, zero_pool_fill_entry, pmm);
+
+    snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u ZR", uvm_id_value(gpu->id));
+    status = uvm_kthread_q_init_on_node(&pmm->zero_pool.q, kthread_name, gpu->parent->closest_cpu_numa_node);
+    if (status != NV_OK)
+        return status;
+
+    pmm->zero_pool.enabled = true;
+
+    return NV_OK;
+}
+
+void uvm_pmm_gpu_zero_pool_deinit(uvm_pmm_gpu_t *pmm)
+{
+    pmm->zero_pool.enabled = false;
+
+    // Safe to call even if the queue was never initialized
+    nv_kthread_q_stop(&pmm->zero_pool.q);
+}
+
 static NV_STATUS alloc_or_evict_root_chunk(uvm_pmm_gpu_t *pmm,
                                            uvm_pmm_gpu_memory_type_t type,
                                            uvm_pmm_alloc_flags_t flags,
@@ -1713,6 +2624,7 @@ static NV_STATUS alloc_or_evict_root_chunk(uvm_pmm_gpu_t *pmm,
     uvm_gpu_chunk_t *chunk;
 
     status = alloc_root_chunk(pmm, type, flags, &chunk);
+    background_eviction_check(pmm);
     if (status != NV_OK) {
         if ((flags & UVM_PMM_ALLOC_FLAGS_EVICT) && uvm_parent_gpu_supports_eviction(gpu->parent))
             status = pick_and_evict_root_chunk_retry(pmm, type, PMM_CONTEXT_DEFAULT, chunk_out);
@@ -1735,6 +2647,7 @@ static NV_STATUS alloc_or_evict_root_chunk_unlocked(uvm_pmm_gpu_t *pmm,
     uvm_gpu_chunk_t *chunk;
 
     status = alloc_root_chunk(pmm, type, flags, &chunk);
+    background_eviction_check(pmm);
     if (status != NV_OK) {
         if ((flags & UVM_PMM_ALLOC_FLAGS_EVICT) && uvm_parent_gpu_supports_eviction(gpu->parent)) {
             uvm_mutex_lock(&pmm->lock);
@@ -1846,8 +2759,13 @@ NV_STATUS alloc_chunk(uvm_pmm_gpu_t *pmm,
 {
     NV_STATUS status;
     uvm_gpu_chunk_t *chunk;
+    int cache_index = chunk_cache_index(pmm, type, chunk_size);
+
+    if (cache_index >= 0)
+        chunk = chunk_cache_alloc(pmm, cache_index, chunk_size);
+    else
+        chunk = claim_free_chunk(pmm, type, chunk_size);
 
-    chunk = claim_free_chunk(pmm, type, chunk_size);
     if (chunk) {
         // A free chunk could be claimed, we are done.
         goto out;
@@ -2439,7 +3357,7 @@ static void free_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
     // root chunk to free, without assuming that one is actually there.
 
     if (try_free)
-        (void)free_next_available_root_chunk(pmm, type);
+        free_or_retain_root_chunk(pmm, type);
 }
 
 // Finds and frees the next root chunk of the given type (if any) that can be
@@ -2487,6 +3405,72 @@ bool free_next_available_root_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_
     return false;
 }
 
+// Number of free user root chunks in the free lists
+static NvU32 root_chunk_cache_size_locked(uvm_pmm_gpu_t *pmm)
+{
+    uvm_assert_spinlock_locked(&pmm->list_lock);
+
+    return pmm->root_chunk_cache.num_free_chunks;
+}
+
+// PMA is considered to be low on memory when it has fewer free root chunks
+// than the root chunk cache can hold, or when the background eviction low
+// watermark is crossed.
+static bool root_chunk_cache_pma_is_low(uvm_pmm_gpu_t *pmm)
+{
+    NvU64 num_free;
+
+    if (!pmm->pma_stats)
+        return false;
+
+    num_free = pma_free_root_chunks(pmm);
+    if (pmm->background_eviction.enabled && num_free < pmm->background_eviction.low_watermark)
+        return true;
+
+    return num_free < pmm->root_chunk_cache.capacity;
+}
+
+// Called after a chunk of the given type is freed. Return a free root chunk to
+// PMA, unless it can be retained by the root chunk cache.
+static void free_or_retain_root_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type)
+{
+    if (pmm->root_chunk_cache.capacity > 0 &&
+        type == UVM_PMM_GPU_MEMORY_TYPE_USER &&
+        !root_chunk_cache_pma_is_low(pmm)) {
+        NvU32 num_free;
+
+        uvm_spin_lock(&pmm->list_lock);
+        num_free = root_chunk_cache_size_locked(pmm);
+        uvm_spin_unlock(&pmm->list_lock);
+
+        if (num_free <= pmm->root_chunk_cache.capacity) {
+            if (num_free > 0)
+                atomic64_inc(&pmm->root_chunk_cache.num_retained_chunks);
+
+            return;
+        }
+    }
+
+    (void)free_next_available_root_chunk(pmm, type);
+}
+
+// Return all the free user root chunks retained by the root chunk cache to
+// PMA. Returns the number of chunks released.
+static NvU32 root_chunk_cache_drain(uvm_pmm_gpu_t *pmm)
+{
+    NvU32 num_released = 0;
+
+    if (pmm->root_chunk_cache.capacity == 0)
+        return 0;
+
+    while (free_next_available_root_chunk(pmm, UVM_PMM_GPU_MEMORY_TYPE_USER))
+        ++num_released;
+
+    atomic64_add(num_released, &pmm->root_chunk_cache.num_released_chunks);
+
+    return num_released;
+}
+
 // Get free list for the given chunk size and type
 struct list_head *find_free_list(uvm_pmm_gpu_t *pmm,
                                  uvm_pmm_gpu_memory_type_t type,
@@ -2544,6 +3528,9 @@ static NV_STATUS uvm_pmm_gpu_pma_evict_pages(void *void_pmm,
     if (g_uvm_global.conf_computing_enabled && (mem_type != UVM_PMA_GPU_MEMORY_TYPE_PROTECTED))
         return NV_ERR_INVALID_ARGUMENT;
 
+    // Make the root chunks pinned by the per-CPU caches evictable
+    chunk_cache_drain(pmm);
+
     while (num_pages_left_to_evict > 0) {
         uvm_gpu_root_chunk_t *root_chunk;
         uvm_page_index_t page_index;
@@ -2694,6 +3681,7 @@ static NV_STATUS uvm_pmm_gpu_pma_evict_range(void *void_pmm,
         uvm_gpu_root_chunk_t *root_chunk = root_chunk_from_address(pmm, address);
         uvm_gpu_chunk_t *chunk = &root_chunk->chunk;
         bool eviction_started = false;
+        bool reserved = false;
         uvm_spin_loop_t spin;
         bool should_inject_error;
 
@@ -2710,10 +3698,23 @@ static NV_STATUS uvm_pmm_gpu_pma_evict_range(void *void_pmm,
                     chunk_start_eviction(pmm, chunk);
                     eviction_started = true;
                 }
+                else if (root_chunk->reserved && !chunk_is_in_eviction(pmm, chunk)) {
+                    reserved = true;
+                }
             }
 
             uvm_spin_unlock(&pmm->list_lock);
 
+            // Memory covered by a GPU resident reservation is guaranteed to
+            // stay resident, and it won't be unreserved by waiting.
+            if (reserved)
+                return NV_ERR_NO_MEMORY;
+
+            // The chunk might be pinned by the per-CPU caches, which don't
+            // release it on their own.
+            if (!eviction_started && chunk->state != UVM_PMM_GPU_CHUNK_STATE_PMA_OWNED)
+                chunk_cache_drain(pmm);
+
             // TODO: Bug 1795559: Replace this with a wait queue.
             if (UVM_SPIN_LOOP(&spin) == NV_ERR_TIMEOUT_RETRY) {
                 UVM_ERR_PRINT("Stuck waiting for root chunk 0x%llx to be unpinned, giving up\n", chunk->address);
@@ -3360,6 +4361,7 @@ NV_STATUS uvm_pmm_gpu_init(uvm_pmm_gpu_t *pmm)
     }
     INIT_LIST_HEAD(&pmm->root_chunks.va_block_used);
     INIT_LIST_HEAD(&pmm->root_chunks.va_block_unused);
+    INIT_LIST_HEAD(&pmm->root_chunks.va_block_reserved);
     INIT_LIST_HEAD(&pmm->root_chunks.va_block_lazy_free);
     nv_kthread_q_item_init(&pmm->root_chunks.va_block_lazy_free_q_item, process_lazy_free_entry, pmm);
 
@@ -3367,6 +4369,16 @@ NV_STATUS uvm_pmm_gpu_init(uvm_pmm_gpu_t *pmm)
     uvm_init_rwsem(&pmm->pma_lock, UVM_LOCK_ORDER_PMM_PMA);
     uvm_spin_lock_init(&pmm->list_lock, UVM_LOCK_ORDER_LEAF);
 
+    if (uvm_pmm_eviction_policy < UVM_PMM_EVICTION_POLICY_COUNT) {
+        pmm->eviction_policy = &g_pmm_eviction_policies[uvm_pmm_eviction_policy];
+    }
+    else {
+        pr_info("Invalid value %u for uvm_pmm_eviction_policy. Using %u instead\n",
+                uvm_pmm_eviction_policy,
+                UVM_PMM_EVICTION_POLICY_LRU);
+        pmm->eviction_policy = &g_pmm_eviction_policies[UVM_PMM_EVICTION_POLICY_LRU];
+    }
+
     pmm->initialized = true;
 
     for (i = 0; i < UVM_PMM_GPU_MEMORY_TYPE_COUNT; i++) {
@@ -3437,6 +4449,16 @@ NV_STATUS uvm_pmm_gpu_init(uvm_pmm_gpu_t *pmm)
         }
     }
 
+    status = background_eviction_init(pmm);
+    if (status != NV_OK)
+        goto cleanup;
+
+    status = chunk_cache_init(pmm);
+    if (status != NV_OK)
+        goto cleanup;
+
+    root_chunk_cache_init(pmm);
+
     status = devmem_init(pmm);
     if (status != NV_OK)
         goto cleanup;
@@ -3464,6 +4486,8 @@ static void release_free_root_chunks(uvm_pmm_gpu_t *pmm)
         for (zero_type = 0; zero_type < UVM_PMM_LIST_ZERO_COUNT; ++zero_type)
             UVM_ASSERT(list_empty(find_free_list(pmm, type, UVM_CHUNK_SIZE_MAX, zero_type)));
     }
+
+    UVM_ASSERT(pmm->root_chunk_cache.num_free_chunks == 0);
 }
 
 void uvm_pmm_gpu_deinit(uvm_pmm_gpu_t *pmm)
@@ -3476,6 +4500,13 @@ void uvm_pmm_gpu_deinit(uvm_pmm_gpu_t *pmm)
 
     gpu = uvm_pmm_to_gpu(pmm);
 
+    background_eviction_deinit(pmm);
+    uvm_pmm_gpu_zero_pool_deinit(pmm);
+    chunk_cache_deinit(pmm);
+
+    // Stop retaining free root chunks, all of them are returned to PMA below
+    pmm->root_chunk_cache.capacity = 0;
+
     UVM_ASSERT(uvm_pmm_gpu_check_orphan_pages(pmm));
     nv_kthread_q_flush(&gpu->parent->lazy_free_q);
     UVM_ASSERT(list_empty(&pmm->root_chunks.va_block_lazy_free));
@@ -3627,7 +4658,7 @@ NV_STATUS uvm_test_evict_chunk(UVM_TEST_EVICT_CHUNK_PARAMS *params, struct file
             root_chunk = NULL;
     }
     else if (params->eviction_mode == UvmTestEvictModeDefault) {
-        root_chunk = pick_root_chunk_to_evict(pmm);
+        root_chunk = pick_root_chunk_to_evict(pmm, true);
     }
     else {
         UVM_DBG_PRINT("Invalid eviction mode: 0x%x\n", params->eviction_mode);
@@ -3862,6 +4893,8 @@ NV_STATUS uvm_test_pmm_query_pma_stats(UVM_TEST_PMM_QUERY_PMA_STATS_PARAMS *para
 
     params->pma_stats.numFreePages64k = UVM_READ_ONCE(gpu->pmm.pma_stats->numFreePages64k);
     params->pma_stats.numFreePages2m = UVM_READ_ONCE(gpu->pmm.pma_stats->numFreePages2m);
+    params->pma_stats.numScrubPendingPages64k = UVM_READ_ONCE(gpu->pmm.pma_stats->numScrubPendingPages64k);
+    params->pma_stats.numScrubbedPages64k = UVM_READ_ONCE(gpu->pmm.pma_stats->numScrubbedPages64k);
 
     uvm_gpu_release(gpu);
     return NV_OK;
@@ -304,8 +304,25 @@ typedef struct uvm_gpu_root_chunk_struct
     //
     // Protected by the corresponding root chunk bit lock.
     uvm_tracker_t tracker;
+
+    // Set when pages backed by the root chunk are mapped or reported by access
+    // counter notifications, and cleared by the eviction policy. Updated
+    // atomically without holding the list lock.
+    atomic_t accessed;
+
+    // Set when any chunk under the root chunk is allocated to a VA block with a
+    // GPU resident reservation on the GPU (see
+    // uvm_va_block_gpu_state_t::resident_reserved). Reserved root chunks are
+    // kept on the root_chunks.va_block_reserved list and are never evicted.
+    //
+    // Protected by the list lock. Only updated with the PMM lock held too, see
+    // root_chunk_update_reserved().
+    bool reserved;
 } uvm_gpu_root_chunk_t;
 
+typedef struct uvm_pmm_gpu_eviction_policy_struct uvm_pmm_gpu_eviction_policy_t;
+typedef struct uvm_pmm_gpu_chunk_cache_struct uvm_pmm_gpu_chunk_cache_t;
+
 typedef struct uvm_pmm_gpu_struct
 {
     // Sizes of the MMU
@@ -345,6 +362,17 @@ typedef struct uvm_pmm_gpu_struct
         // List of root chunks used by VA blocks
         struct list_head va_block_used;
 
+        // List of root chunks used by VA blocks with a GPU resident
+        // reservation. These are never picked for eviction.
+        struct list_head va_block_reserved;
+
+        // Number of reserved root chunks. Protected by the list lock.
+        size_t num_reserved;
+
+        // Total size of the VA ranges of all VA spaces with a GPU resident
+        // reservation on this GPU, see UVM_SET_GPU_RESIDENT_RESERVATION.
+        atomic64_t reservation_size;
+
         // List of chunks needing to be lazily freed and a queue for processing
         // the list. TODO: Bug 3881835: revisit whether to use nv_kthread_q_t
         // or workqueue.
@@ -368,6 +396,123 @@ typedef struct uvm_pmm_gpu_struct
     // Free chunk lists. There are separate lists for non-zero and zero chunks.
     struct list_head free_list[UVM_PMM_GPU_MEMORY_TYPE_COUNT][UVM_MAX_CHUNK_SIZES][UVM_PMM_LIST_ZERO_COUNT];
 
+    // Policy used to pick the root chunks used by VA blocks to be evicted. See
+    // uvm_pmm_eviction_policy in uvm_pmm_gpu.c.
+    const uvm_pmm_gpu_eviction_policy_t *eviction_policy;
+
+    struct
+    {
+        // Number of root chunks evicted, including evictions requested by PMA
+        atomic64_t num_evicted_root_chunks;
+
+        // Number of times a recently accessed root chunk was skipped by the
+        // eviction policy
+        atomic64_t num_second_chances;
+
+        // Number of pages evicted to sysmem
+        atomic64_t num_evicted_pages;
+
+        // Number of evicted pages that were migrated back to the GPU
+        atomic64_t num_refaulted_pages;
+    } eviction_stats;
+
+    // Proactive eviction performed by a per-GPU kthread, off the allocation
+    // path. See uvm_pmm_evict_low_watermark in uvm_pmm_gpu.c.
+    struct
+    {
+        bool enabled;
+
+        // The kthread is woken up when the number of free 2M pages in PMA drops
+        // below low_watermark, and evicts root chunks until it reaches
+        // high_watermark.
+        NvU64 low_watermark;
+
+        NvU64 high_watermark;
+
+        nv_kthread_q_t q;
+
+        nv_kthread_q_item_t q_item;
+
+        // Number of root chunks evicted by the kthread
+        atomic64_t num_evicted_root_chunks;
+    } background_eviction;
+
+    // Pool of free root chunks zeroed ahead of time by a per-GPU kthread, so
+    // that first-touch allocations don't have to zero the chunk inline. See
+    // uvm_pmm_zero_pool_target in uvm_pmm_gpu.c.
+    struct
+    {
+        bool enabled;
+
+        // Number of zero free root chunks the kthread tries to maintain
+        NvU32 target;
+
+        nv_kthread_q_t q;
+
+        nv_kthread_q_item_t q_item;
+
+        // Number of root chunks zeroed by the kthread
+        atomic64_t num_zeroed_chunks;
+
+        // Number of user chunks claimed from the free lists that were already
+        // zero, and that had to be zeroed by the caller, respectively
+        atomic64_t num_zero_hits;
+
+        atomic64_t num_zero_misses;
+    } zero_pool;
+
+    // Per-CPU caches of free 4K and 64K user chunks, so that most allocations
+    // of those sizes don't need to take the list lock. See
+    // uvm_pmm_chunk_cache_size in uvm_pmm_gpu.c.
+    struct
+    {
+        bool enabled;
+
+        // Maximum number of chunks of each size held by a CPU's cache
+        NvU32 capacity;
+
+        // Number of chunks claimed from the free lists when a cache is empty
+        NvU32 batch;
+
+        uvm_pmm_gpu_chunk_cache_t __percpu *caches;
+
+        // Number of cached chunks given back to the free lists, e.g. to make
+        // their root chunks evictable
+        atomic64_t num_drained_chunks;
+    } chunk_cache;
+
+    // Free user root chunks retained by PMM instead of being returned to PMA.
+    // See uvm_pmm_root_chunk_cache_size in uvm_pmm_gpu.c.
+    struct
+    {
+        // Maximum number of free user root chunks retained. 0 if disabled.
+        NvU32 capacity;
+
+        // Number of free user root chunks on the free lists, not counting the
+        // ones picked for eviction. Maintained even when the cache is disabled
+        // so that its size can be checked without walking the lists.
+        // Protected by the list lock.
+        NvU32 num_free_chunks;
+
+        // Number of root chunk frees that kept the chunk on the free lists
+        atomic64_t num_retained_chunks;
+
+        // Number of retained chunks returned to PMA because of memory pressure
+        atomic64_t num_released_chunks;
+    } root_chunk_cache;
+
+    // Statistics of the acquisitions of the list lock done to claim free
+    // chunks. Protected by the list lock.
+    struct
+    {
+        NvU64 num_lock_acquisitions;
+
+        // Number of acquisitions that found the lock already taken
+        NvU64 num_lock_contended;
+
+        NvU64 num_claimed_chunks;
+    } claim_stats;
+
     // Inject an error after evicting a number of chunks. 0 means no error left
     // to be injected.
     NvU32 inject_pma_evict_error_after_num_chunks;
@@ -578,6 +723,40 @@ void uvm_pmm_gpu_mark_root_chunk_used(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk
 // Mark an allocated user chunk as unused
 void uvm_pmm_gpu_mark_root_chunk_unused(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 
+// Mark the root chunk containing the given allocated chunk as recently
+// accessed, which makes it less likely to be picked for eviction.
+//
+// The caller must own the chunk, e.g. by holding the lock of the VA block
+// the chunk is allocated to.
+void uvm_pmm_gpu_mark_root_chunk_accessed(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
+
+// Update whether the root chunk containing the given chunk, allocated to a VA
+// block, is protected from eviction after the GPU resident reservation of the
+// VA block changed. See uvm_va_block_gpu_state_t::resident_reserved.
+//
+// The caller must own the chunk, e.g. by holding the lock of the VA block the
+// chunk is allocated to. Takes the PMM lock.
+void uvm_pmm_gpu_update_root_chunk_reservation(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
+
+// Name of the eviction policy used by the PMM
+const char *uvm_pmm_gpu_eviction_policy_name(uvm_pmm_gpu_t *pmm);
+
+// Wait for any pending background eviction to complete
+void uvm_pmm_gpu_flush_background_eviction(uvm_pmm_gpu_t *pmm);
+
+// Start and stop the kthread maintaining the pool of zero root chunks. The
+// kthread pushes memsets, so it has to be started after the GPU's channel
+// manager and flat mappings are created, and stopped before they are
+// destroyed.
+NV_STATUS uvm_pmm_gpu_zero_pool_init(uvm_pmm_gpu_t *pmm);
+void uvm_pmm_gpu_zero_pool_deinit(uvm_pmm_gpu_t *pmm);
+
+// Wait for any pending background zeroing to complete
+void uvm_pmm_gpu_flush_zero_pool(uvm_pmm_gpu_t *pmm);
+
+// Number of allocations served from the per-CPU chunk caches
+NvU64 uvm_pmm_gpu_chunk_cache_hits(uvm_pmm_gpu_t *pmm);
+
 static bool uvm_gpu_chunk_same_root(uvm_gpu_chunk_t *chunk1, uvm_gpu_chunk_t *chunk2)
 {
     return UVM_ALIGN_DOWN(chunk1->address, UVM_CHUNK_SIZE_MAX) == UVM_ALIGN_DOWN(chunk2->address, UVM_CHUNK_SIZE_MAX);
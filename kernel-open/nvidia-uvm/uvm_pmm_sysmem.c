@@ -31,10 +31,188 @@ static int uvm_cpu_chunk_allocation_sizes = UVM_CPU_CHUNK_SIZES;
 module_param(uvm_cpu_chunk_allocation_sizes, uint, S_IRUGO | S_IWUSR);
 MODULE_PARM_DESC(uvm_cpu_chunk_allocation_sizes, "OR'ed value of all CPU chunk allocation sizes.");
 
+// Number of 2MB pages kept in reserve on each NUMA node with memory. 2MB CPU
+// chunk allocations are served from the reserve first, which is refilled in
+// the background, so that they don't fall back to smaller chunks whenever the
+// kernel can't immediately satisfy a high order allocation. Reserved pages
+// are not charged to any memory cgroup, so allocations that need to be
+// accounted always bypass the reserve. 0 disables the reserve.
+static unsigned uvm_cpu_chunk_reserve_2m_per_node = 0;
+module_param(uvm_cpu_chunk_reserve_2m_per_node, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_cpu_chunk_reserve_2m_per_node,
+                 "Number of 2MB CPU chunks kept in reserve per NUMA node. 0 disables the reserve.");
+
 static struct kmem_cache *g_reverse_page_map_cache __read_mostly;
 
+typedef struct
+{
+    // Protects pages and count
+    uvm_spinlock_t lock;
+
+    // Reserved 2MB compound pages, linked through page->lru
+    struct list_head pages;
+
+    NvU32 count;
+
+    // Queued on g_uvm_global.global_q to refill the reserve in the background
+    nv_kthread_q_item_t refill_q_item;
+
+    int nid;
+} uvm_cpu_chunk_reserve_t;
+
+// Array of nr_node_ids reserves. NULL if the reserve is disabled.
+static uvm_cpu_chunk_reserve_t *g_cpu_chunk_reserves __read_mostly;
+
+static void cpu_chunk_reserve_refill(void *args)
+{
+    uvm_cpu_chunk_reserve_t *reserve = (uvm_cpu_chunk_reserve_t *)args;
+
+    // Unlike uvm_cpu_chunk_alloc_page(), don't use __GFP_NORETRY. The refill
+    // runs in the background so it can afford to let the kernel compact memory
+    // to satisfy the request.
+    gfp_t kernel_alloc_flags = NV_UVM_GFP_FLAGS |
+                               GFP_HIGHUSER |
+                               __GFP_THISNODE |
+                               __GFP_COMP |
+                               __GFP_ZERO |
+                               __GFP_NOWARN;
+
+    while (true) {
+        struct page *page;
+        bool full;
+
+        uvm_spin_lock(&reserve->lock);
+        full = reserve->count >= uvm_cpu_chunk_reserve_2m_per_node;
+        uvm_spin_unlock(&reserve->lock);
+
+        if (full)
+            break;
+
+        page = alloc_pages_node(reserve->nid, kernel_alloc_flags, get_order(UVM_CHUNK_SIZE_2M));
+        if (!page)
+            break;
+
+        uvm_spin_lock(&reserve->lock);
+        list_add(&page->lru, &reserve->pages);
+        reserve->count++;
+        uvm_spin_unlock(&reserve->lock);
+    }
+}
+
+static void cpu_chunk_reserve_refill_entry(void *args)
+{
+    UVM_ENTRY_VOID(cpu_chunk_reserve_refill(args));
+}
+
+// Take a zeroed 2MB page from the reserve of the given node, or the local node
+// if nid is NUMA_NO_NODE. Returns NULL if the reserve can't be used for the
+// allocation or is empty. Either way, a refill is scheduled if the reserve is
+// below its target size.
+static struct page *cpu_chunk_reserve_get(int nid, uvm_cpu_chunk_alloc_flags_t alloc_flags)
+{
+    uvm_cpu_chunk_reserve_t *reserve;
+    struct page *page = NULL;
+    bool refill;
+
+    if (!g_cpu_chunk_reserves)
+        return NULL;
+
+    if (alloc_flags & UVM_CPU_CHUNK_ALLOC_FLAGS_ACCOUNT)
+        return NULL;
+
+    if (nid == NUMA_NO_NODE)
+        nid = numa_mem_id();
+
+    if (nid < 0 || nid >= nr_node_ids || !node_state(nid, N_MEMORY))
+        return NULL;
+
+    reserve = &g_cpu_chunk_reserves[nid];
+
+    uvm_spin_lock(&reserve->lock);
+
+    if (!list_empty(&reserve->pages)) {
+        page = list_first_entry(&reserve->pages, struct page, lru);
+        list_del(&page->lru);
+        reserve->count--;
+    }
+
+    refill = reserve->count < uvm_cpu_chunk_reserve_2m_per_node;
+
+    uvm_spin_unlock(&reserve->lock);
+
+    if (refill)
+        nv_kthread_q_schedule_q_item(&g_uvm_global.global_q, &reserve->refill_q_item);
+
+    // Reserved pages are always zeroed. Match uvm_cpu_chunk_alloc_page() in
+    // marking them dirty if zeroing was requested.
+    if (page && (alloc_flags & UVM_CPU_CHUNK_ALLOC_FLAGS_ZERO))
+        SetPageDirty(page);
+
+    return page;
+}
+
+static NV_STATUS cpu_chunk_reserve_init(void)
+{
+    int nid;
+
+    if (uvm_cpu_chunk_reserve_2m_per_node == 0)
+        return NV_OK;
+
+    if (!(uvm_cpu_chunk_allocation_sizes & UVM_CHUNK_SIZE_2M)) {
+        pr_info("uvm_cpu_chunk_reserve_2m_per_node = %u requires 2MB CPU chunks, disabling the reserve\n",
+                uvm_cpu_chunk_reserve_2m_per_node);
+        uvm_cpu_chunk_reserve_2m_per_node = 0;
+        return NV_OK;
+    }
+
+    g_cpu_chunk_reserves = uvm_kvmalloc_zero(nr_node_ids * sizeof(*g_cpu_chunk_reserves));
+    if (!g_cpu_chunk_reserves)
+        return NV_ERR_NO_MEMORY;
+
+    for (nid = 0; nid < nr_node_ids; nid++) {
+        uvm_cpu_chunk_reserve_t *reserve = &g_cpu_chunk_reserves[nid];
+
+        uvm_spin_lock_init(&reserve->lock, UVM_LOCK_ORDER_LEAF);
+        INIT_LIST_HEAD(&reserve->pages);
+        nv_kthread_q_item_init(&reserve->refill_q_item, cpu_chunk_reserve_refill_entry, reserve);
+        reserve->nid = nid;
+    }
+
+    for_each_node_state(nid, N_MEMORY)
+        nv_kthread_q_schedule_q_item(&g_uvm_global.global_q, &g_cpu_chunk_reserves[nid].refill_q_item);
+
+    return NV_OK;
+}
+
+static void cpu_chunk_reserve_exit(void)
+{
+    int nid;
+
+    if (!g_cpu_chunk_reserves)
+        return;
+
+    // Wait for any pending refills. No new ones can be scheduled as there are
+    // no more allocations at this point.
+    nv_kthread_q_flush(&g_uvm_global.global_q);
+
+    for (nid = 0; nid < nr_node_ids; nid++) {
+        uvm_cpu_chunk_reserve_t *reserve = &g_cpu_chunk_reserves[nid];
+        struct page *page, *next;
+
+        list_for_each_entry_safe(page, next, &reserve->pages, lru) {
+            list_del(&page->lru);
+            __free_pages(page, get_order(UVM_CHUNK_SIZE_2M));
+        }
+    }
+
+    uvm_kvfree(g_cpu_chunk_reserves);
+    g_cpu_chunk_reserves = NULL;
+}
+
 NV_STATUS uvm_pmm_sysmem_init(void)
 {
+    NV_STATUS status;
+
     g_reverse_page_map_cache = NV_KMEM_CACHE_CREATE("uvm_pmm_sysmem_page_reverse_map_t",
                                                     uvm_reverse_map_t);
     if (!g_reverse_page_map_cache)
@@ -49,11 +227,16 @@ NV_STATUS uvm_pmm_sysmem_init(void)
         uvm_cpu_chunk_allocation_sizes = UVM_CPU_CHUNK_SIZES;
     }
 
-    return NV_OK;
+    status = cpu_chunk_reserve_init();
+    if (status != NV_OK)
+        kmem_cache_destroy_safe(&g_reverse_page_map_cache);
+
+    return status;
 }
 
 void uvm_pmm_sysmem_exit(void)
 {
+    cpu_chunk_reserve_exit();
     kmem_cache_destroy_safe(&g_reverse_page_map_cache);
 }
 
@@ -480,10 +663,38 @@ static uvm_page_index_t cpu_chunk_get_phys_index(uvm_cpu_logical_chunk_t *chunk)
     return (uvm_page_index_t)(chunk->common.page - phys_chunk->common.page);
 }
 
+// Grow the array of DMA mapping addresses of the chunk so that it can hold at
+// least num_entries entries.
+static NV_STATUS chunk_phys_mappings_reserve(uvm_cpu_physical_chunk_t *chunk, NvU32 num_entries)
+{
+    uvm_cpu_phys_mapping_t *new_entries;
+
+    uvm_assert_mutex_locked(&chunk->lock);
+
+    if (num_entries <= chunk->gpu_mappings.max_entries)
+        return NV_OK;
+
+    if (chunk->gpu_mappings.max_entries == 1) {
+        new_entries = uvm_kvmalloc(sizeof(*new_entries) * num_entries);
+        if (new_entries)
+            new_entries[0] = chunk->gpu_mappings.static_entry;
+    }
+    else {
+        new_entries = uvm_kvrealloc(chunk->gpu_mappings.dynamic_entries, sizeof(*new_entries) * num_entries);
+    }
+
+    if (!new_entries)
+        return NV_ERR_NO_MEMORY;
+
+    chunk->gpu_mappings.max_entries = num_entries;
+    chunk->gpu_mappings.dynamic_entries = new_entries;
+
+    return NV_OK;
+}
+
 static uvm_cpu_phys_mapping_t *chunk_phys_mapping_alloc(uvm_cpu_physical_chunk_t *chunk, uvm_parent_gpu_id_t id)
 {
     NvU32 num_active_entries = uvm_parent_processor_mask_get_gpu_count(&chunk->gpu_mappings.dma_addrs_mask);
-    uvm_cpu_phys_mapping_t *new_entries;
     NvU32 array_index;
 
     uvm_assert_mutex_locked(&chunk->lock);
@@ -492,23 +703,8 @@ static uvm_cpu_phys_mapping_t *chunk_phys_mapping_alloc(uvm_cpu_physical_chunk_t
         return &chunk->gpu_mappings.static_entry;
 
     if (num_active_entries == chunk->gpu_mappings.max_entries) {
-        NvU32 num_new_entries = chunk->gpu_mappings.max_entries * 2;
-
-        if (chunk->gpu_mappings.max_entries == 1) {
-            new_entries = uvm_kvmalloc(sizeof(*new_entries) * num_new_entries);
-            if (new_entries)
-                new_entries[0] = chunk->gpu_mappings.static_entry;
-        }
-        else {
-            new_entries = uvm_kvrealloc(chunk->gpu_mappings.dynamic_entries,
-                                        sizeof(*new_entries) * num_new_entries);
-        }
-
-        if (!new_entries)
+        if (chunk_phys_mappings_reserve(chunk, chunk->gpu_mappings.max_entries * 2) != NV_OK)
             return NULL;
-
-        chunk->gpu_mappings.max_entries = num_new_entries;
-        chunk->gpu_mappings.dynamic_entries = new_entries;
     }
 
     array_index = compute_gpu_mappings_entry_index(&chunk->gpu_mappings.dma_addrs_mask, id);
@@ -716,6 +912,21 @@ NV_STATUS uvm_cpu_chunk_map_gpu(uvm_cpu_chunk_t *chunk, uvm_gpu_t *gpu)
     return status;
 }
 
+NV_STATUS uvm_cpu_chunk_reserve_gpu_mappings(uvm_cpu_chunk_t *chunk, NvU32 num_gpus)
+{
+    uvm_cpu_physical_chunk_t *phys_chunk = get_physical_parent(chunk);
+    NV_STATUS status;
+
+    // The array only holds one entry per parent GPU
+    num_gpus = min(num_gpus, (NvU32)UVM_PARENT_ID_MAX_GPUS);
+
+    uvm_mutex_lock(&phys_chunk->lock);
+    status = chunk_phys_mappings_reserve(phys_chunk, num_gpus);
+    uvm_mutex_unlock(&phys_chunk->lock);
+
+    return status;
+}
+
 void uvm_cpu_chunk_unmap_gpu(uvm_cpu_chunk_t *chunk, uvm_gpu_t *gpu)
 {
     cpu_chunk_unmap_gpu_phys(chunk, gpu->id);
@@ -864,11 +1075,13 @@ static struct page *uvm_cpu_chunk_alloc_page(uvm_chunk_size_t alloc_size,
     return page;
 }
 
-static uvm_cpu_physical_chunk_t *uvm_cpu_chunk_create(uvm_chunk_size_t alloc_size)
+// The chunk metadata is allocated on the NUMA node of the chunk's page, since
+// it is accessed whenever the page is mapped or its dirty state is tracked.
+static uvm_cpu_physical_chunk_t *uvm_cpu_chunk_create(uvm_chunk_size_t alloc_size, int nid)
 {
     uvm_cpu_physical_chunk_t *chunk;
 
-    chunk = uvm_kvmalloc_zero(sizeof(*chunk));
+    chunk = uvm_kvmalloc_zero_node(sizeof(*chunk), nid);
     if (!chunk)
         return NULL;
 
@@ -877,7 +1090,9 @@ static uvm_cpu_physical_chunk_t *uvm_cpu_chunk_create(uvm_chunk_size_t alloc_siz
     uvm_mutex_init(&chunk->lock, UVM_LOCK_ORDER_LEAF);
     chunk->gpu_mappings.max_entries = 1;
     if (alloc_size > PAGE_SIZE) {
-        chunk->dirty_bitmap = uvm_kvmalloc_zero(BITS_TO_LONGS(alloc_size / PAGE_SIZE) * sizeof(*chunk->dirty_bitmap));
+        chunk->dirty_bitmap = uvm_kvmalloc_zero_node(BITS_TO_LONGS(alloc_size / PAGE_SIZE) *
+                                                     sizeof(*chunk->dirty_bitmap),
+                                                     nid);
         if (!chunk->dirty_bitmap) {
             uvm_kvfree(chunk);
             return NULL;
@@ -897,11 +1112,17 @@ NV_STATUS uvm_cpu_chunk_alloc(uvm_chunk_size_t alloc_size,
 
     UVM_ASSERT(new_chunk);
 
-    page = uvm_cpu_chunk_alloc_page(alloc_size, nid, alloc_flags);
+    page = NULL;
+    if (alloc_size == UVM_CHUNK_SIZE_2M)
+        page = cpu_chunk_reserve_get(nid, alloc_flags);
+
+    if (!page)
+        page = uvm_cpu_chunk_alloc_page(alloc_size, nid, alloc_flags);
+
     if (!page)
         return NV_ERR_NO_MEMORY;
 
-    chunk = uvm_cpu_chunk_create(alloc_size);
+    chunk = uvm_cpu_chunk_create(alloc_size, page_to_nid(page));
     if (!chunk) {
         __free_pages(page, get_order(alloc_size));
         return NV_ERR_NO_MEMORY;
@@ -921,7 +1142,7 @@ NV_STATUS uvm_cpu_chunk_alloc_hmm(struct page *page,
 
     UVM_ASSERT(new_chunk);
 
-    chunk = uvm_cpu_chunk_create(PAGE_SIZE);
+    chunk = uvm_cpu_chunk_create(PAGE_SIZE, page_to_nid(page));
     if (!chunk)
         return NV_ERR_NO_MEMORY;
 
@@ -373,6 +373,12 @@ void uvm_cpu_chunk_free(uvm_cpu_chunk_t *chunk);
 // For more details see uvm_mmu_sysmem_map().
 NV_STATUS uvm_cpu_chunk_map_gpu(uvm_cpu_chunk_t *chunk, uvm_gpu_t *gpu);
 
+// Make room in the chunk for DMA mappings on num_gpus GPUs. Mapping a chunk
+// on several GPUs one at a time otherwise grows the chunk's array of DMA
+// addresses repeatedly. Calling this is optional: uvm_cpu_chunk_map_gpu()
+// grows the array as needed.
+NV_STATUS uvm_cpu_chunk_reserve_gpu_mappings(uvm_cpu_chunk_t *chunk, NvU32 num_gpus);
+
 // Destroy a CPU chunk's DMA mapping for the given GPU.
 // If chunk is a logical chunk, this call may not necessarily destroy the DMA
 // mapping of the parent physical chunk since all logical chunks and MIG
@@ -795,7 +795,7 @@ done:
     return status;
 }
 
-static NV_STATUS test_cpu_chunk_mapping_array(uvm_gpu_t *gpu0, uvm_gpu_t *gpu1, uvm_gpu_t *gpu2)
+static NV_STATUS test_cpu_chunk_mapping_array(uvm_gpu_t *gpu0, uvm_gpu_t *gpu1, uvm_gpu_t *gpu2, bool reserve)
 {
     NV_STATUS status = NV_OK;
     uvm_cpu_chunk_t *chunk;
@@ -805,6 +805,12 @@ static NV_STATUS test_cpu_chunk_mapping_array(uvm_gpu_t *gpu0, uvm_gpu_t *gpu1,
     TEST_NV_CHECK_RET(test_cpu_chunk_alloc(PAGE_SIZE, UVM_CPU_CHUNK_ALLOC_FLAGS_NONE, NUMA_NO_NODE, &chunk));
     phys_chunk = uvm_cpu_chunk_to_physical(chunk);
 
+    // Pre-sizing the mapping array must not change the results below
+    if (reserve) {
+        TEST_NV_CHECK_GOTO(uvm_cpu_chunk_reserve_gpu_mappings(chunk, 3), done);
+        TEST_CHECK_GOTO(phys_chunk->gpu_mappings.max_entries == 3, done);
+    }
+
     TEST_NV_CHECK_GOTO(uvm_cpu_chunk_map_gpu(chunk, gpu1), done);
     TEST_NV_CHECK_GOTO(test_cpu_chunk_mapping_access(chunk, gpu1), done);
     TEST_NV_CHECK_GOTO(uvm_cpu_chunk_map_gpu(chunk, gpu2), done);
@@ -1429,8 +1435,10 @@ NV_STATUS uvm_test_cpu_chunk_api(UVM_TEST_CPU_CHUNK_API_PARAMS *params, struct f
             // Look for a third physical GPU.
             gpu3 = find_next_parent_gpu(test_gpus, va_space, gpu2);
 
-            if (gpu3)
-                TEST_NV_CHECK_GOTO(test_cpu_chunk_mapping_array(gpu, gpu2, gpu3), done);
+            if (gpu3) {
+                TEST_NV_CHECK_GOTO(test_cpu_chunk_mapping_array(gpu, gpu2, gpu3, false), done);
+                TEST_NV_CHECK_GOTO(test_cpu_chunk_mapping_array(gpu, gpu2, gpu3, true), done);
+            }
         }
 
         // Look for a pair of GPUs that share a common parent.
@@ -30,6 +30,7 @@
 #include "uvm_gpu.h"
 #include "uvm_va_space_mm.h"
 #include "uvm_processors.h"
+#include "uvm_perf_thrashing.h"
 
 static bool uvm_is_valid_vma_range(struct mm_struct *mm, NvU64 start, NvU64 length)
 {
@@ -302,6 +303,26 @@ static NV_STATUS preferred_location_set(uvm_va_space_t *va_space,
                                           out_tracker);
 }
 
+// Wait for the work pushed by a policy change and release the VA space lock,
+// which is held in write mode. By the time this is called all the VA range and
+// VA block state has been updated, and the pushed work is also tracked by the
+// VA blocks it applies to. The lock is thus downgraded before waiting, so that
+// faults and migrations in the VA space are not stalled by the GPU processing
+// the unmaps and membars. The read lock still prevents the GPUs from being
+// unregistered until the wait completes.
+static NV_STATUS policy_tracker_wait_deinit_up_write(uvm_va_space_t *va_space, uvm_tracker_t *tracker)
+{
+    NV_STATUS status;
+
+    uvm_va_space_downgrade_write(va_space);
+
+    status = uvm_tracker_wait_deinit(tracker);
+
+    uvm_va_space_up_read(va_space);
+
+    return status;
+}
+
 NV_STATUS uvm_api_set_preferred_location(const UVM_SET_PREFERRED_LOCATION_PARAMS *params, struct file *filp)
 {
     NV_STATUS status = NV_OK;
@@ -414,12 +435,13 @@ NV_STATUS uvm_api_set_preferred_location(const UVM_SET_PREFERRED_LOCATION_PARAMS
     }
 
 done:
-    tracker_status = uvm_tracker_wait_deinit(&local_tracker);
-
-    if (has_va_space_write_lock)
-        uvm_va_space_up_write(va_space);
-    else
+    if (has_va_space_write_lock) {
+        tracker_status = policy_tracker_wait_deinit_up_write(va_space, &local_tracker);
+    }
+    else {
+        tracker_status = uvm_tracker_wait_deinit(&local_tracker);
         uvm_va_space_up_read(va_space);
+    }
 
     uvm_va_space_mm_or_current_release_unlock(va_space, mm);
 
@@ -466,9 +488,7 @@ NV_STATUS uvm_api_unset_preferred_location(const UVM_UNSET_PREFERRED_LOCATION_PA
                                     &local_tracker);
 
 done:
-    tracker_status = uvm_tracker_wait_deinit(&local_tracker);
-
-    uvm_va_space_up_write(va_space);
+    tracker_status = policy_tracker_wait_deinit_up_write(va_space, &local_tracker);
     uvm_va_space_mm_or_current_release_unlock(va_space, mm);
     return status == NV_OK ? tracker_status : status;
 }
@@ -641,9 +661,7 @@ static NV_STATUS accessed_by_set(uvm_va_space_t *va_space,
     }
 
 done:
-    tracker_status = uvm_tracker_wait_deinit(&local_tracker);
-
-    uvm_va_space_up_write(va_space);
+    tracker_status = policy_tracker_wait_deinit_up_write(va_space, &local_tracker);
     uvm_va_space_mm_or_current_release_unlock(va_space, mm);
 
     return status == NV_OK ? tracker_status : status;
@@ -921,6 +939,241 @@ NV_STATUS uvm_api_disable_read_duplication(const UVM_DISABLE_READ_DUPLICATION_PA
     return read_duplication_set(va_space, params->requestedBase, params->length, false);
 }
 
+static bool thrashing_policy_is_split_needed(const uvm_va_policy_t *policy, void *data)
+{
+    const uvm_va_policy_thrashing_t *new_policy;
+
+    UVM_ASSERT(data);
+
+    new_policy = (const uvm_va_policy_thrashing_t *)data;
+
+    return policy->thrashing.disable != new_policy->disable ||
+           policy->thrashing.cost_model != new_policy->cost_model ||
+           policy->thrashing.threshold != new_policy->threshold ||
+           policy->thrashing.pin_threshold != new_policy->pin_threshold ||
+           policy->thrashing.lapse_ns != new_policy->lapse_ns ||
+           policy->thrashing.nap_ns != new_policy->nap_ns ||
+           policy->thrashing.pin_ns != new_policy->pin_ns;
+}
+
+NV_STATUS uvm_api_set_thrashing_policy(const UVM_SET_THRASHING_POLICY_PARAMS *params, struct file *filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    const NvU64 base = params->requestedBase;
+    const NvU64 last_address = base + params->length - 1;
+    uvm_va_policy_thrashing_t new_policy;
+    uvm_va_range_t *va_range;
+    uvm_va_range_t *va_range_last = NULL;
+    struct mm_struct *mm;
+    uvm_api_range_type_t type;
+    NV_STATUS status;
+
+    if (params->flags & ~UVM_THRASHING_POLICY_FLAGS_ALL)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    memset(&new_policy, 0, sizeof(new_policy));
+
+    if (params->flags & UVM_THRASHING_POLICY_FLAG_DISABLE) {
+        new_policy.disable = true;
+    }
+    else {
+        new_policy.cost_model    = !!(params->flags & UVM_THRASHING_POLICY_FLAG_COST_MODEL);
+        new_policy.threshold     = params->threshold;
+        new_policy.pin_threshold = params->pinThreshold;
+        new_policy.lapse_ns      = params->lapseUsec * 1000ULL;
+        new_policy.nap_ns        = params->napUsec * 1000ULL;
+        new_policy.pin_ns        = params->pinUsec * 1000ULL;
+    }
+
+    // mmap_lock is needed to tell ATS and HMM ranges apart from invalid ones
+    mm = uvm_va_space_mm_or_current_retain_lock(va_space);
+    uvm_va_space_down_write(va_space);
+
+    status = uvm_perf_thrashing_policy_check(va_space, &new_policy);
+    if (status != NV_OK)
+        goto done;
+
+    type = uvm_api_range_type_check(va_space, mm, base, params->length);
+    if (type == UVM_API_RANGE_TYPE_INVALID) {
+        status = NV_ERR_INVALID_ADDRESS;
+        goto done;
+    }
+    else if (type == UVM_API_RANGE_TYPE_ATS) {
+        status = NV_OK;
+        goto done;
+    }
+    else if (type == UVM_API_RANGE_TYPE_HMM) {
+        status = NV_ERR_NOT_SUPPORTED;
+        goto done;
+    }
+
+    status = split_span_as_needed(va_space,
+                                  base,
+                                  last_address + 1,
+                                  thrashing_policy_is_split_needed,
+                                  &new_policy);
+    if (status != NV_OK)
+        goto done;
+
+    uvm_for_each_managed_va_range_in_contig(va_range, va_space, base, last_address) {
+        uvm_va_block_context_t *block_context = uvm_va_space_block_context(va_space, mm);
+        uvm_va_block_t *va_block;
+
+        va_range_last = va_range;
+
+        // If we didn't split the ends, check that they match
+        if (va_range->node.start < base || va_range->node.end > last_address)
+            UVM_ASSERT(!thrashing_policy_is_split_needed(uvm_va_range_get_policy(va_range), &new_policy));
+
+        uvm_va_range_get_policy(va_range)->thrashing = new_policy;
+
+        // The tracking state of the blocks was built with the previous
+        // parameters. Drop it so that, for example, pages marked as thrashing
+        // do not fall below a higher threshold.
+        for_each_va_block_in_va_range(va_range, va_block) {
+            status = uvm_perf_thrashing_reset_block(va_block, block_context);
+            if (status != NV_OK)
+                goto done;
+        }
+    }
+
+    UVM_ASSERT(va_range_last);
+    UVM_ASSERT(va_range_last->node.end >= last_address);
+
+done:
+    uvm_va_space_up_write(va_space);
+    uvm_va_space_mm_or_current_release_unlock(va_space, mm);
+    return status;
+}
+
+static bool gpu_resident_reservation_is_split_needed(const uvm_va_policy_t *policy, void *data)
+{
+    const uvm_processor_id_t *gpu_id;
+
+    UVM_ASSERT(data);
+
+    gpu_id = (const uvm_processor_id_t *)data;
+
+    return !uvm_id_equal(policy->gpu_resident_reservation, *gpu_id);
+}
+
+// Length of [base, last_address] that would be newly reserved on the GPU,
+// that is, not counting the parts of the span already reserved on it.
+static NvU64 gpu_resident_reservation_new_size(uvm_va_space_t *va_space,
+                                               uvm_gpu_t *gpu,
+                                               NvU64 base,
+                                               NvU64 last_address)
+{
+    uvm_va_range_t *va_range;
+    NvU64 size = 0;
+
+    uvm_for_each_managed_va_range_in_contig(va_range, va_space, base, last_address) {
+        if (uvm_id_equal(uvm_va_range_get_policy(va_range)->gpu_resident_reservation, gpu->id))
+            continue;
+
+        size += min(va_range->node.end, last_address) - max(va_range->node.start, base) + 1;
+    }
+
+    return size;
+}
+
+// Set the GPU resident reservation of the span to the given GPU, or drop it if
+// gpu_uuid is NULL.
+static NV_STATUS gpu_resident_reservation_set(uvm_va_space_t *va_space,
+                                              NvU64 base,
+                                              NvU64 length,
+                                              const NvProcessorUuid *gpu_uuid)
+{
+    const NvU64 last_address = base + length - 1;
+    uvm_processor_id_t gpu_id = UVM_ID_INVALID;
+    uvm_va_range_t *va_range;
+    uvm_va_range_t *va_range_last = NULL;
+    struct mm_struct *mm;
+    uvm_api_range_type_t type;
+    NV_STATUS status;
+
+    // mmap_lock is needed to tell ATS and HMM ranges apart from invalid ones
+    mm = uvm_va_space_mm_or_current_retain_lock(va_space);
+    uvm_va_space_down_write(va_space);
+
+    type = uvm_api_range_type_check(va_space, mm, base, length);
+    if (type == UVM_API_RANGE_TYPE_INVALID) {
+        status = NV_ERR_INVALID_ADDRESS;
+        goto done;
+    }
+    else if (type == UVM_API_RANGE_TYPE_ATS) {
+        status = NV_OK;
+        goto done;
+    }
+    else if (type == UVM_API_RANGE_TYPE_HMM) {
+        status = NV_ERR_NOT_SUPPORTED;
+        goto done;
+    }
+
+    if (gpu_uuid) {
+        uvm_gpu_t *gpu = uvm_va_space_get_gpu_by_uuid(va_space, gpu_uuid);
+        NvU64 new_size;
+
+        if (!gpu) {
+            status = NV_ERR_INVALID_DEVICE;
+            goto done;
+        }
+
+        // Check the quota before splitting so that a failed call leaves the
+        // ranges untouched.
+        new_size = gpu_resident_reservation_new_size(va_space, gpu, base, last_address);
+        if (va_space->gpu_resident_reservation_size[uvm_id_gpu_index(gpu->id)] + new_size >
+            uvm_va_range_gpu_resident_reservation_quota(gpu)) {
+            status = NV_ERR_INSUFFICIENT_RESOURCES;
+            goto done;
+        }
+
+        gpu_id = gpu->id;
+    }
+
+    status = split_span_as_needed(va_space,
+                                  base,
+                                  last_address + 1,
+                                  gpu_resident_reservation_is_split_needed,
+                                  &gpu_id);
+    if (status != NV_OK)
+        goto done;
+
+    uvm_for_each_managed_va_range_in_contig(va_range, va_space, base, last_address) {
+        va_range_last = va_range;
+
+        // If we didn't split the ends, check that they match
+        if (va_range->node.start < base || va_range->node.end > last_address)
+            UVM_ASSERT(!gpu_resident_reservation_is_split_needed(uvm_va_range_get_policy(va_range), &gpu_id));
+
+        uvm_va_range_set_gpu_resident_reservation(va_range, gpu_id);
+    }
+
+    UVM_ASSERT(va_range_last);
+    UVM_ASSERT(va_range_last->node.end >= last_address);
+
+done:
+    uvm_va_space_up_write(va_space);
+    uvm_va_space_mm_or_current_release_unlock(va_space, mm);
+    return status;
+}
+
+NV_STATUS uvm_api_set_gpu_resident_reservation(const UVM_SET_GPU_RESIDENT_RESERVATION_PARAMS *params,
+                                               struct file *filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+
+    return gpu_resident_reservation_set(va_space, params->requestedBase, params->length, &params->gpuUuid);
+}
+
+NV_STATUS uvm_api_unset_gpu_resident_reservation(const UVM_UNSET_GPU_RESIDENT_RESERVATION_PARAMS *params,
+                                                 struct file *filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+
+    return gpu_resident_reservation_set(va_space, params->requestedBase, params->length, NULL);
+}
+
 static NV_STATUS system_wide_atomics_set(uvm_va_space_t *va_space, const NvProcessorUuid *gpu_uuid, bool enable)
 {
     NV_STATUS status = NV_OK;
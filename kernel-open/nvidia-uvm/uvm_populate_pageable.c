@@ -26,10 +26,36 @@
 #include "uvm_linux.h"
 #include "uvm_lock.h"
 #include "uvm_api.h"
+#include "uvm_gpu_isr.h"
+#include "uvm_kvmalloc.h"
 #include "uvm_va_range.h"
 #include "uvm_va_space.h"
 #include "uvm_populate_pageable.h"
 
+// Number of worker threads used by UVM_POPULATE_PAGEABLE to populate ranges of
+// at least UVM_POPULATE_PAGEABLE_PARALLEL_MIN_SIZE. The workers are bound to
+// the NUMA node of the calling thread, so that pages are allocated on the same
+// node as they would be if the caller populated them itself, and their number
+// is capped by the number of CPUs in that node. 0 or 1 populate the range
+// serially on the calling thread.
+#define UVM_POPULATE_PAGEABLE_WORKERS_MAX 64
+
+static unsigned uvm_populate_pageable_workers = 8;
+module_param(uvm_populate_pageable_workers, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_populate_pageable_workers,
+                 "Number of threads used to populate large ranges in UVM_POPULATE_PAGEABLE. 0 or 1 disable "
+                 "parallel population.");
+
+#define UVM_POPULATE_PAGEABLE_PARALLEL_MIN_SIZE UVM_SIZE_1GB
+
+// Each worker populates its part of the range in chunks of this size, dropping
+// mmap_lock in between so that writers are not starved, and checking whether
+// the population was aborted.
+#define UVM_POPULATE_PAGEABLE_WORKER_CHUNK_SIZE (64 * UVM_SIZE_1MB)
+
+// How often the progress of a parallel population is reported
+#define UVM_POPULATE_PAGEABLE_PROGRESS_PERIOD_MS 5000
+
 #if defined(NV_HANDLE_MM_FAULT_HAS_MM_ARG)
 #define UVM_HANDLE_MM_FAULT(vma, addr, flags)       handle_mm_fault(vma->vm_mm, vma, addr, flags)
 #elif defined(NV_HANDLE_MM_FAULT_HAS_PT_REGS_ARG)
@@ -217,12 +243,236 @@ NV_STATUS uvm_populate_pageable(struct mm_struct *mm,
     return NV_ERR_INVALID_ADDRESS;
 }
 
+typedef struct uvm_populate_pageable_parallel_struct uvm_populate_pageable_parallel_t;
+
+typedef struct
+{
+    uvm_populate_pageable_parallel_t *parallel;
+
+    nv_kthread_q_t q;
+
+    nv_kthread_q_item_t q_item;
+
+    // [start, end) part of the range populated by this worker. Both ends are
+    // 2MB-aligned, except at the ends of the whole range, so that the huge
+    // pages of a VMA are not faulted in by multiple workers.
+    unsigned long start;
+    unsigned long end;
+
+    NV_STATUS status;
+} uvm_populate_pageable_worker_t;
+
+struct uvm_populate_pageable_parallel_struct
+{
+    uvm_va_space_t *va_space;
+
+    struct mm_struct *mm;
+
+    int min_prot;
+
+    bool allow_managed;
+
+    // Set when a worker fails or the caller is killed, so that the rest of
+    // workers stop at their next chunk.
+    bool abort;
+
+    atomic64_t populated_size;
+
+    atomic_t pending;
+
+    struct completion done;
+
+    NvU32 num_workers;
+
+    uvm_populate_pageable_worker_t *workers;
+};
+
+static NV_STATUS populate_pageable_chunk(uvm_populate_pageable_parallel_t *parallel,
+                                         unsigned long start,
+                                         unsigned long length)
+{
+    NV_STATUS status;
+
+    uvm_down_read_mmap_lock(parallel->mm);
+
+    // The lock was dropped since the previous chunk, so the managed ranges
+    // have to be looked up again.
+    if (parallel->allow_managed || uvm_va_space_range_empty(parallel->va_space, start, start + length - 1)) {
+        status = uvm_populate_pageable(parallel->mm,
+                                       start,
+                                       length,
+                                       parallel->min_prot,
+                                       false,
+                                       UVM_POPULATE_PERMISSIONS_INHERIT);
+    }
+    else {
+        status = NV_ERR_INVALID_ADDRESS;
+    }
+
+    uvm_up_read_mmap_lock(parallel->mm);
+
+    return status;
+}
+
+static void populate_pageable_worker(uvm_populate_pageable_worker_t *worker)
+{
+    uvm_populate_pageable_parallel_t *parallel = worker->parallel;
+    unsigned long start = worker->start;
+    NV_STATUS status = NV_OK;
+
+    while (start < worker->end && !UVM_READ_ONCE(parallel->abort)) {
+        unsigned long end = min(worker->end,
+                                (unsigned long)UVM_ALIGN_DOWN(start, UVM_POPULATE_PAGEABLE_WORKER_CHUNK_SIZE) +
+                                UVM_POPULATE_PAGEABLE_WORKER_CHUNK_SIZE);
+
+        status = populate_pageable_chunk(parallel, start, end - start);
+        if (status != NV_OK) {
+            UVM_WRITE_ONCE(parallel->abort, true);
+            break;
+        }
+
+        atomic64_add(end - start, &parallel->populated_size);
+        start = end;
+    }
+
+    worker->status = status;
+
+    if (atomic_dec_and_test(&parallel->pending))
+        complete(&parallel->done);
+}
+
+static void populate_pageable_worker_entry(void *args)
+{
+    UVM_ENTRY_VOID(populate_pageable_worker((uvm_populate_pageable_worker_t *)args));
+}
+
+static NvU32 populate_pageable_num_workers(unsigned long length, int node)
+{
+    NvU32 num_workers = min(uvm_populate_pageable_workers, (unsigned)UVM_POPULATE_PAGEABLE_WORKERS_MAX);
+
+    if (length < UVM_POPULATE_PAGEABLE_PARALLEL_MIN_SIZE)
+        return 1;
+
+#if UVM_THREAD_AFFINITY_SUPPORTED()
+    if (!cpumask_empty(uvm_cpumask_of_node(node)))
+        num_workers = min(num_workers, cpumask_weight(uvm_cpumask_of_node(node)));
+#endif
+
+    return num_workers;
+}
+
+// Populate [start, start + length) with worker threads bound to the given NUMA
+// node. Each worker takes mmap_lock on its own, so the caller must not
+// hold it. The range is split into as many 2MB-aligned parts as workers, which
+// are populated in chunks of UVM_POPULATE_PAGEABLE_WORKER_CHUNK_SIZE. On
+// failure, the status of the lowest failing part of the range is returned, and
+// the rest of the range may have been partially populated, as is the case with
+// serial population.
+static NV_STATUS populate_pageable_parallel(uvm_va_space_t *va_space,
+                                           struct mm_struct *mm,
+                                           unsigned long start,
+                                           unsigned long length,
+                                           int min_prot,
+                                           bool allow_managed,
+                                           int node,
+                                           NvU32 num_workers)
+{
+    uvm_populate_pageable_parallel_t parallel;
+    const unsigned long end = start + length;
+    const unsigned long aligned_start = UVM_ALIGN_DOWN(start, UVM_PAGE_SIZE_2M);
+    unsigned long worker_size;
+    NV_STATUS status = NV_OK;
+    NvU32 i;
+
+    memset(&parallel, 0, sizeof(parallel));
+    parallel.va_space = va_space;
+    parallel.mm = mm;
+    parallel.min_prot = min_prot;
+    parallel.allow_managed = allow_managed;
+    atomic64_set(&parallel.populated_size, 0);
+    init_completion(&parallel.done);
+
+    worker_size = UVM_ALIGN_UP(DIV_ROUND_UP(end - aligned_start, num_workers), UVM_PAGE_SIZE_2M);
+    num_workers = DIV_ROUND_UP(end - aligned_start, worker_size);
+
+    parallel.workers = uvm_kvmalloc_zero(num_workers * sizeof(*parallel.workers));
+    if (!parallel.workers)
+        return NV_ERR_NO_MEMORY;
+
+    parallel.num_workers = num_workers;
+
+    for (i = 0; i < num_workers; i++) {
+        uvm_populate_pageable_worker_t *worker = &parallel.workers[i];
+        char kthread_name[TASK_COMM_LEN + 1];
+
+        worker->parallel = &parallel;
+        worker->start = max(start, aligned_start + i * worker_size);
+        worker->end = min(end, aligned_start + (i + 1) * worker_size);
+        worker->status = NV_OK;
+
+        nv_kthread_q_item_init(&worker->q_item, populate_pageable_worker_entry, worker);
+
+        snprintf(kthread_name, sizeof(kthread_name), "UVM populate %u", i);
+        status = uvm_kthread_q_init_on_node(&worker->q, kthread_name, node);
+        if (status != NV_OK) {
+            UVM_DBG_PRINT("Failed in nv_kthread_q_init for populate worker %u: %s\n", i, nvstatusToString(status));
+            break;
+        }
+    }
+
+    if (status == NV_OK) {
+        long ret;
+
+        atomic_set(&parallel.pending, num_workers);
+
+        for (i = 0; i < num_workers; i++)
+            nv_kthread_q_schedule_q_item(&parallel.workers[i].q, &parallel.workers[i].q_item);
+
+        do {
+            ret = wait_for_completion_killable_timeout(&parallel.done,
+                                                       msecs_to_jiffies(UVM_POPULATE_PAGEABLE_PROGRESS_PERIOD_MS));
+            if (ret == 0) {
+                UVM_DBG_PRINT("Populated %llu of %lu MB of [0x%lx, 0x%lx) with %u workers\n",
+                              (NvU64)atomic64_read(&parallel.populated_size) / UVM_SIZE_1MB,
+                              length / UVM_SIZE_1MB,
+                              start,
+                              end,
+                              num_workers);
+            }
+        } while (ret == 0);
+
+        // The workers reference the state on this stack, so they must finish
+        // even if the caller is being killed.
+        if (ret < 0) {
+            UVM_WRITE_ONCE(parallel.abort, true);
+            wait_for_completion(&parallel.done);
+            status = NV_ERR_SIGNAL_PENDING;
+        }
+    }
+
+    for (i = 0; i < num_workers; i++) {
+        uvm_populate_pageable_worker_t *worker = &parallel.workers[i];
+
+        // It is safe to stop a queue that failed to initialize
+        nv_kthread_q_stop(&worker->q);
+
+        if (status == NV_OK)
+            status = worker->status;
+    }
+
+    uvm_kvfree(parallel.workers);
+
+    return status;
+}
+
 NV_STATUS uvm_api_populate_pageable(const UVM_POPULATE_PAGEABLE_PARAMS *params, struct file *filp)
 {
     NV_STATUS status;
     bool allow_managed;
     bool skip_prot_check;
     int min_prot;
+    NvU32 num_workers;
+    int node;
     uvm_va_space_t *va_space = uvm_va_space_get(filp);
 
     if (params->flags & ~UVM_POPULATE_PAGEABLE_FLAGS_ALL)
@@ -253,6 +503,21 @@ NV_STATUS uvm_api_populate_pageable(const UVM_POPULATE_PAGEABLE_PARAMS *params,
     if (uvm_api_range_invalid(params->base, params->length))
         return NV_ERR_INVALID_ADDRESS;
 
+    // Large ranges are split among worker threads, which take mmap_lock on
+    // their own. Like the serial path below, they only work on current->mm.
+    node = numa_node_id();
+    num_workers = populate_pageable_num_workers(params->length, node);
+    if (num_workers > 1) {
+        return populate_pageable_parallel(va_space,
+                                          current->mm,
+                                          params->base,
+                                          params->length,
+                                          min_prot,
+                                          allow_managed,
+                                          node,
+                                          num_workers);
+    }
+
     // mmap_lock is needed to traverse the vmas in the input range and call
     // into get_user_pages. Unlike most UVM APIs, this one is defined to only
     // work on current->mm, not the mm associated with the VA space (if any).
@@ -31,6 +31,7 @@
 #define UVM_PROC_DIR_NAME "driver/nvidia-uvm"
 #define UVM_PROC_GPUS_DIR_NAME "gpus"
 #define UVM_PROC_CPU_DIR_NAME "cpu"
+#define UVM_PROC_VA_SPACES_DIR_NAME "va_spaces"
 
 #if defined(CONFIG_PROC_FS)
   // This parameter enables additional debug procfs entries. It's enabled by
@@ -45,6 +46,7 @@
 static struct proc_dir_entry *uvm_proc_dir;
 static struct proc_dir_entry *uvm_proc_gpus;
 static struct proc_dir_entry *uvm_proc_cpu;
+static struct proc_dir_entry *uvm_proc_va_spaces;
 
 NV_STATUS uvm_procfs_init(void)
 {
@@ -63,6 +65,12 @@ NV_STATUS uvm_procfs_init(void)
     if (uvm_proc_cpu == NULL)
         return NV_ERR_OPERATING_SYSTEM;
 
+    // The VA space files expose the address space layout of the processes
+    // using UVM, so only the owner of the directory can look them up.
+    uvm_proc_va_spaces = NV_PROC_MKDIR_MODE(UVM_PROC_VA_SPACES_DIR_NAME, S_IFDIR | S_IRUSR | S_IXUSR, uvm_proc_dir);
+    if (uvm_proc_va_spaces == NULL)
+        return NV_ERR_OPERATING_SYSTEM;
+
     return NV_OK;
 }
 
@@ -71,6 +79,11 @@ void uvm_procfs_exit(void)
     proc_remove(uvm_proc_dir);
 }
 
+struct proc_dir_entry *uvm_procfs_get_base_dir(void)
+{
+    return uvm_proc_dir;
+}
+
 struct proc_dir_entry *uvm_procfs_get_gpu_base_dir(void)
 {
     return uvm_proc_gpus;
@@ -81,3 +94,8 @@ struct proc_dir_entry *uvm_procfs_get_cpu_base_dir(void)
     return uvm_proc_cpu;
 }
 
+struct proc_dir_entry *uvm_procfs_get_va_space_base_dir(void)
+{
+    return uvm_proc_va_spaces;
+}
+
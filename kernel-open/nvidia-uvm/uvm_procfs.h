@@ -50,8 +50,10 @@ static bool uvm_procfs_is_debug_enabled(void)
     return uvm_enable_debug_procfs != 0;
 }
 
+struct proc_dir_entry *uvm_procfs_get_base_dir(void);
 struct proc_dir_entry *uvm_procfs_get_gpu_base_dir(void);
 struct proc_dir_entry *uvm_procfs_get_cpu_base_dir(void);
+struct proc_dir_entry *uvm_procfs_get_va_space_base_dir(void);
 
 int uvm_procfs_open_callback(void);
 void uvm_procfs_close_callback(void);
@@ -92,6 +92,10 @@ static void push_acquire_tracker_entry(uvm_push_t *push,
     if (gpu != uvm_tracker_entry_gpu(tracker_entry))
         UVM_ASSERT(uvm_push_allow_dependencies_across_gpus());
 
+    // The acquired push may have its submission to the GPU deferred, which
+    // has to be done before the acquire can ever be satisfied.
+    uvm_channel_flush_deferred_gpu_put(entry_channel);
+
     semaphore_va = uvm_channel_tracking_semaphore_get_gpu_va_in_channel(entry_channel, channel);
     gpu->parent->host_hal->semaphore_acquire(push, semaphore_va, (NvU32)tracker_entry->value);
 
@@ -138,6 +142,7 @@ void uvm_push_acquire_tracker(uvm_push_t *push, uvm_tracker_t *tracker)
 static NV_STATUS push_reserve_channel(uvm_channel_manager_t *manager,
                                       uvm_channel_type_t channel_type,
                                       uvm_gpu_t *dst_gpu,
+                                      NvU32 ce_stripe,
                                       uvm_channel_t **channel)
 {
     NV_STATUS status;
@@ -145,7 +150,9 @@ static NV_STATUS push_reserve_channel(uvm_channel_manager_t *manager,
     // Pick a channel and reserve a GPFIFO entry
     // TODO: Bug 1764953: use the dependencies in the tracker to pick a channel
     //       in a smarter way.
-    if (dst_gpu == NULL)
+    if (ce_stripe != 0)
+        status = uvm_channel_reserve_ce_stripe(manager, channel_type, dst_gpu, ce_stripe, channel);
+    else if (dst_gpu == NULL)
         status = uvm_channel_reserve_type(manager, channel_type, channel);
     else
         status = uvm_channel_reserve_gpu_to_gpu(manager, dst_gpu, channel);
@@ -238,18 +245,18 @@ static NV_STATUS push_begin_acquire_with_info(uvm_channel_t *channel,
     return NV_OK;
 }
 
-__attribute__ ((format(printf, 9, 10)))
-NV_STATUS __uvm_push_begin_acquire_with_info(uvm_channel_manager_t *manager,
-                                             uvm_channel_type_t type,
-                                             uvm_gpu_t *dst_gpu,
-                                             uvm_tracker_t *tracker,
-                                             uvm_push_t *push,
-                                             const char *filename,
-                                             const char *function,
-                                             int line,
-                                             const char *format, ...)
+static NV_STATUS push_begin_acquire_in_manager(uvm_channel_manager_t *manager,
+                                               uvm_channel_type_t type,
+                                               uvm_gpu_t *dst_gpu,
+                                               NvU32 ce_stripe,
+                                               uvm_tracker_t *tracker,
+                                               uvm_push_t *push,
+                                               const char *filename,
+                                               const char *function,
+                                               int line,
+                                               const char *format,
+                                               va_list args)
 {
-    va_list args;
     NV_STATUS status;
     uvm_channel_t *channel;
 
@@ -262,22 +269,82 @@ NV_STATUS __uvm_push_begin_acquire_with_info(uvm_channel_manager_t *manager,
     if (status != NV_OK)
         return status;
 
-    status = push_reserve_channel(manager, type, dst_gpu, &channel);
+    status = push_reserve_channel(manager, type, dst_gpu, ce_stripe, &channel);
     if (status != NV_OK)
         return status;
 
     UVM_ASSERT(channel);
 
-    va_start(args, format);
     status = push_begin_acquire_with_info(channel, tracker, push, filename, function, line, format, args);
-    va_end(args);
-
     if (status != NV_OK)
         uvm_channel_release(channel, 1);
 
     return status;
 }
 
+__attribute__ ((format(printf, 9, 10)))
+NV_STATUS __uvm_push_begin_acquire_with_info(uvm_channel_manager_t *manager,
+                                             uvm_channel_type_t type,
+                                             uvm_gpu_t *dst_gpu,
+                                             uvm_tracker_t *tracker,
+                                             uvm_push_t *push,
+                                             const char *filename,
+                                             const char *function,
+                                             int line,
+                                             const char *format, ...)
+{
+    va_list args;
+    NV_STATUS status;
+
+    va_start(args, format);
+    status = push_begin_acquire_in_manager(manager,
+                                           type,
+                                           dst_gpu,
+                                           0,
+                                           tracker,
+                                           push,
+                                           filename,
+                                           function,
+                                           line,
+                                           format,
+                                           args);
+    va_end(args);
+
+    return status;
+}
+
+__attribute__ ((format(printf, 10, 11)))
+NV_STATUS __uvm_push_begin_acquire_ce_stripe_with_info(uvm_channel_manager_t *manager,
+                                                       uvm_channel_type_t type,
+                                                       uvm_gpu_t *dst_gpu,
+                                                       NvU32 ce_stripe,
+                                                       uvm_tracker_t *tracker,
+                                                       uvm_push_t *push,
+                                                       const char *filename,
+                                                       const char *function,
+                                                       int line,
+                                                       const char *format, ...)
+{
+    va_list args;
+    NV_STATUS status;
+
+    va_start(args, format);
+    status = push_begin_acquire_in_manager(manager,
+                                           type,
+                                           dst_gpu,
+                                           ce_stripe,
+                                           tracker,
+                                           push,
+                                           filename,
+                                           function,
+                                           line,
+                                           format,
+                                           args);
+    va_end(args);
+
+    return status;
+}
+
 __attribute__ ((format(printf, 7, 8)))
 NV_STATUS __uvm_push_begin_acquire_on_channel_with_info(uvm_channel_t *channel,
                                                         uvm_tracker_t *tracker,
@@ -308,6 +375,63 @@ NV_STATUS __uvm_push_begin_acquire_on_channel_with_info(uvm_channel_t *channel,
     return status;
 }
 
+__attribute__ ((format(printf, 9, 10)))
+NV_STATUS __uvm_push_begin_acquire_in_batch_with_info(uvm_push_batch_t *batch,
+                                                      uvm_channel_manager_t *manager,
+                                                      uvm_channel_type_t type,
+                                                      uvm_tracker_t *tracker,
+                                                      uvm_push_t *push,
+                                                      const char *filename,
+                                                      const char *function,
+                                                      int line,
+                                                      const char *format, ...)
+{
+    va_list args;
+    NV_STATUS status;
+    uvm_channel_t *channel = batch->channel;
+
+    status = wait_for_other_gpus_if_needed(tracker, manager->gpu);
+    if (status != NV_OK)
+        return status;
+
+    if (channel) {
+        UVM_ASSERT(channel->pool->manager == manager);
+        UVM_ASSERT(batch->type == type);
+
+        status = uvm_channel_reserve(channel, 1);
+    }
+    else {
+        status = push_reserve_channel(manager, type, NULL, 0, &channel);
+    }
+
+    if (status != NV_OK)
+        return status;
+
+    va_start(args, format);
+    status = push_begin_acquire_with_info(channel, tracker, push, filename, function, line, format, args);
+    va_end(args);
+
+    if (status != NV_OK) {
+        uvm_channel_release(channel, 1);
+        return status;
+    }
+
+    batch->channel = channel;
+    batch->type = type;
+
+    uvm_push_set_flag(push, UVM_PUSH_FLAG_DEFER_GPU_PUT);
+
+    return NV_OK;
+}
+
+void uvm_push_batch_end(uvm_push_batch_t *batch)
+{
+    if (batch->channel)
+        uvm_channel_flush_deferred_gpu_put(batch->channel);
+
+    uvm_push_batch_init(batch);
+}
+
 __attribute__ ((format(printf, 6, 7)))
 NV_STATUS __uvm_push_begin_on_reserved_channel_with_info(uvm_channel_t *channel,
                                                          uvm_push_t *push,
@@ -61,6 +61,14 @@ typedef enum
     // comments in uvm_channel_end_push().
     UVM_PUSH_FLAG_NEXT_MEMBAR_GPU,
 
+    // By default ending a push updates GPPUT of the channel, making the push
+    // visible to the GPU right away.
+    // This flag indicates that the GPPUT update can be deferred, so that it
+    // can be coalesced with the GPPUT update of a later push on the same
+    // channel. Only applies to channels that update GPPUT directly and is
+    // ignored otherwise. See uvm_push_batch_t.
+    UVM_PUSH_FLAG_DEFER_GPU_PUT,
+
     UVM_PUSH_FLAG_COUNT,
 } uvm_push_flag_t;
 
@@ -174,6 +182,30 @@ typedef struct
     char *next_data;
 } uvm_push_inline_data_t;
 
+// A batch of back-to-back pushes on a single channel, coalescing their GPPUT
+// updates. See uvm_push_begin_in_batch().
+//
+// The batch needs to be ended with uvm_push_batch_end() before its pushes are
+// relied upon by anybody that doesn't go through the channel or a tracker,
+// e.g. before dropping a lock that other threads use to observe the work.
+typedef struct
+{
+    // Channel of the first push in the batch, NULL if none started yet
+    uvm_channel_t *channel;
+
+    // Channel type requested for the batch
+    uvm_channel_type_t type;
+} uvm_push_batch_t;
+
+static void uvm_push_batch_init(uvm_push_batch_t *batch)
+{
+    memset(batch, 0, sizeof(*batch));
+}
+
+// Submit all the pushes of the batch to the GPU. The batch can be reused
+// after this.
+void uvm_push_batch_end(uvm_push_batch_t *batch);
+
 // Set the push description after the push already begun. This is useful if
 // the description includes data generated after the push started.
 void uvm_push_set_description(uvm_push_t *push, const char *format, ...);
@@ -196,6 +228,19 @@ NV_STATUS __uvm_push_begin_acquire_with_info(uvm_channel_manager_t *manager,
                                              int line,
                                              const char *format, ...);
 
+// Internal helper for uvm_push_begin_acquire_ce_stripe
+__attribute__ ((format(printf, 10, 11)))
+NV_STATUS __uvm_push_begin_acquire_ce_stripe_with_info(uvm_channel_manager_t *manager,
+                                                       uvm_channel_type_t type,
+                                                       uvm_gpu_t *dst_gpu,
+                                                       NvU32 ce_stripe,
+                                                       uvm_tracker_t *tracker,
+                                                       uvm_push_t *push,
+                                                       const char *filename,
+                                                       const char *function,
+                                                       int line,
+                                                       const char *format, ...);
+
 // Internal helper for uvm_push_begin_on_channel and
 // uvm_push_begin_acquire_on_channel
 __attribute__ ((format(printf, 7, 8)))
@@ -215,6 +260,19 @@ NV_STATUS __uvm_push_begin_on_reserved_channel_with_info(uvm_channel_t *channel,
                                                          const char *function,
                                                          int line,
                                                          const char *format, ...);
+// Internal helper for uvm_push_begin_in_batch and
+// uvm_push_begin_acquire_in_batch
+__attribute__ ((format(printf, 9, 10)))
+NV_STATUS __uvm_push_begin_acquire_in_batch_with_info(uvm_push_batch_t *batch,
+                                                      uvm_channel_manager_t *manager,
+                                                      uvm_channel_type_t type,
+                                                      uvm_tracker_t *tracker,
+                                                      uvm_push_t *push,
+                                                      const char *filename,
+                                                      const char *function,
+                                                      int line,
+                                                      const char *format, ...);
+
 // Begin a push on a channel of channel_type type
 // Picks the first available channel. If all channels of the given type are
 // busy, spin waits for one to become available.
@@ -255,6 +313,14 @@ NV_STATUS __uvm_push_begin_on_reserved_channel_with_info(uvm_channel_t *channel,
     __uvm_push_begin_acquire_with_info((manager), UVM_CHANNEL_TYPE_GPU_TO_GPU, (dst_gpu), (tracker), (push), \
         __FILE__, __FUNCTION__, __LINE__, (format), ##__VA_ARGS__)
 
+// Same as uvm_push_begin_acquire, except that the channel is picked in the
+// given CE stripe of the channel type. See uvm_channel_reserve_ce_stripe().
+// dst_gpu must be provided for UVM_CHANNEL_TYPE_GPU_TO_GPU, and be NULL
+// otherwise.
+#define uvm_push_begin_acquire_ce_stripe(manager, type, dst_gpu, ce_stripe, tracker, push, format, ...)       \
+    __uvm_push_begin_acquire_ce_stripe_with_info((manager), (type), (dst_gpu), (ce_stripe), (tracker), (push), \
+        __FILE__, __FUNCTION__, __LINE__, (format), ##__VA_ARGS__)
+
 // Begin a push on a specific channel
 // If the channel is busy, spin wait for it to become available.
 //
@@ -278,6 +344,29 @@ NV_STATUS __uvm_push_begin_on_reserved_channel_with_info(uvm_channel_t *channel,
     __uvm_push_begin_acquire_on_channel_with_info((channel), (tracker), (push), \
         __FILE__, __FUNCTION__, __LINE__, (format), ##__VA_ARGS__)
 
+// Begin a push that is part of a push batch
+// The first push in the batch picks a channel like uvm_push_begin(), all the
+// following pushes are done on the same channel. The GPPUT update of each push
+// is deferred (see UVM_PUSH_FLAG_DEFER_GPU_PUT) until a subsequent push that
+// is not deferred, the end of the batch, or until the number of deferred
+// GPFIFO entries reaches a limit.
+//
+// Each push still gets its own GPFIFO entry and tracking semaphore value, so
+// pushes in a batch can be added to trackers and waited on as usual. Waiting
+// for or acquiring a push that hasn't been submitted yet flushes the deferred
+// GPPUT update first.
+//
+// Locking: same as uvm_push_begin()
+#define uvm_push_begin_in_batch(batch, manager, type, push, format, ...)                            \
+    __uvm_push_begin_acquire_in_batch_with_info((batch), (manager), (type), NULL, (push),           \
+        __FILE__, __FUNCTION__, __LINE__, (format), ##__VA_ARGS__)
+
+// Same as uvm_push_begin_in_batch except it also acquires the input tracker
+// for the caller
+#define uvm_push_begin_acquire_in_batch(batch, manager, type, tracker, push, format, ...)           \
+    __uvm_push_begin_acquire_in_batch_with_info((batch), (manager), (type), (tracker), (push),      \
+        __FILE__, __FUNCTION__, __LINE__, (format), ##__VA_ARGS__)
+
 // End a push
 // Finishes the push and submits the methods to the GPU.
 //
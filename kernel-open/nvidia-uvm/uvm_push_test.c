@@ -347,6 +347,68 @@ done:
     return status;
 }
 
+// Test that pushes in a batch can be depended on and waited for before the
+// batch ends, and that the deferred GPPUT updates are bounded.
+static NV_STATUS test_push_batch(uvm_va_space_t *va_space)
+{
+    NV_STATUS status = NV_OK;
+    uvm_gpu_t *gpu;
+    uvm_tracker_t tracker;
+
+    uvm_tracker_init(&tracker);
+
+    for_each_va_space_gpu(gpu, va_space) {
+        uvm_push_batch_t batch;
+        uvm_push_t push;
+        NvU32 i;
+
+        uvm_push_batch_init(&batch);
+
+        // Enough pushes to go over the limit of deferred GPPUT updates
+        for (i = 0; i < 64; ++i) {
+            status = uvm_push_begin_in_batch(&batch,
+                                             gpu->channel_manager,
+                                             UVM_CHANNEL_TYPE_GPU_INTERNAL,
+                                             &push,
+                                             "batched push %u",
+                                             i);
+            TEST_CHECK_GOTO(status == NV_OK, done);
+
+            uvm_push_end(&push);
+            TEST_CHECK_GOTO(push.channel == batch.channel, done);
+            uvm_tracker_overwrite_with_push(&tracker, &push);
+        }
+
+        // Depend on the last push from a different channel before ending the
+        // batch.
+        status = uvm_push_begin_acquire(gpu->channel_manager,
+                                        UVM_CHANNEL_TYPE_CPU_TO_GPU,
+                                        &tracker,
+                                        &push,
+                                        "acquire batched push");
+        TEST_CHECK_GOTO(status == NV_OK, done);
+        TEST_NV_CHECK_GOTO(uvm_push_end_and_wait(&push), done);
+
+        status = uvm_push_begin_in_batch(&batch,
+                                         gpu->channel_manager,
+                                         UVM_CHANNEL_TYPE_GPU_INTERNAL,
+                                         &push,
+                                         "batched push to wait on");
+        TEST_CHECK_GOTO(status == NV_OK, done);
+
+        uvm_push_end(&push);
+        TEST_NV_CHECK_GOTO(uvm_push_wait(&push), done);
+
+        uvm_push_batch_end(&batch);
+        TEST_CHECK_GOTO(batch.channel == NULL, done);
+    }
+
+done:
+    uvm_tracker_deinit(&tracker);
+
+    return status;
+}
+
 static void add_to_counter(void* ptr, int value)
 {
     atomic_t *atomic = (atomic_t*) ptr;
@@ -985,6 +1047,10 @@ NV_STATUS uvm_test_push_sanity(UVM_TEST_PUSH_SANITY_PARAMS *params, struct file
     if (status != NV_OK)
         goto done;
 
+    status = test_push_batch(va_space);
+    if (status != NV_OK)
+        goto done;
+
     status = test_push_gpu_to_gpu(va_space);
     if (status != NV_OK)
         goto done;
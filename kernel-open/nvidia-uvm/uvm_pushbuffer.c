@@ -613,7 +613,7 @@ void uvm_pushbuffer_end_push(uvm_pushbuffer_t *pushbuffer, uvm_push_t *push, uvm
 
     chunk = gpfifo_to_chunk(pushbuffer, gpfifo);
 
-    uvm_channel_pool_assert_locked(push->channel->pool);
+    uvm_channel_assert_locked(push->channel);
 
     uvm_spin_lock(&pushbuffer->lock);
 
@@ -210,7 +210,19 @@ uvm_range_tree_node_t *uvm_range_tree_merge_next(uvm_range_tree_t *tree, uvm_ran
 
 uvm_range_tree_node_t *uvm_range_tree_find(uvm_range_tree_t *tree, NvU64 addr)
 {
-    return range_node_find(tree, addr, NULL, NULL);
+    uvm_range_tree_node_t *node = READ_ONCE(tree->cached_node);
+
+    // Nodes only change bounds with exclusive access to the tree, so the
+    // cached node can be checked like any other node.
+    if (node && addr >= node->start && addr <= node->end)
+        return node;
+
+    node = range_node_find(tree, addr, NULL, NULL);
+
+    if (node)
+        WRITE_ONCE(tree->cached_node, node);
+
+    return node;
 }
 
 uvm_range_tree_node_t *uvm_range_tree_iter_first(uvm_range_tree_t *tree, NvU64 start, NvU64 end)
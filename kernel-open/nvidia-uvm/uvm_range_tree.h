@@ -41,6 +41,13 @@ typedef struct uvm_range_tree_struct
     // to avoid calling rb_next and rb_prev frequently, particularly while
     // iterating.
     struct list_head head;
+
+    // Last node found by uvm_range_tree_find, or NULL. Consecutive lookups,
+    // like the ones made while servicing faults, usually land in the same
+    // node. Some trees are looked up with only shared locks held, so the
+    // pointer is accessed with READ_ONCE/WRITE_ONCE. It is cleared when the
+    // node is removed, which requires exclusive access to the tree.
+    struct uvm_range_tree_node_struct *cached_node;
 } uvm_range_tree_t;
 
 typedef struct uvm_range_tree_node_struct
@@ -63,6 +70,9 @@ NV_STATUS uvm_range_tree_add(uvm_range_tree_t *tree, uvm_range_tree_node_t *node
 
 static void uvm_range_tree_remove(uvm_range_tree_t *tree, uvm_range_tree_node_t *node)
 {
+    if (tree->cached_node == node)
+        WRITE_ONCE(tree->cached_node, NULL);
+
     rb_erase(&node->rb_node, &tree->rb_root);
     list_del(&node->list);
 }
@@ -92,7 +102,8 @@ void uvm_range_tree_split(uvm_range_tree_t *tree,
 uvm_range_tree_node_t *uvm_range_tree_merge_prev(uvm_range_tree_t *tree, uvm_range_tree_node_t *node);
 uvm_range_tree_node_t *uvm_range_tree_merge_next(uvm_range_tree_t *tree, uvm_range_tree_node_t *node);
 
-// Returns the node containing addr, if any
+// Returns the node containing addr, if any. The last node found is cached in
+// the tree, so repeated lookups in the same node skip the tree walk.
 uvm_range_tree_node_t *uvm_range_tree_find(uvm_range_tree_t *tree, NvU64 addr);
 
 // Find the largest hole containing addr but not containing any nodes. If addr
@@ -928,6 +928,16 @@ static NV_STATUS rtt_directed(rtt_state_t *state)
     MEM_NV_CHECK_RET(rtt_range_add_check_val(state,  7,          ULLONG_MAX), NV_ERR_UVM_ADDRESS_IN_USE);
     MEM_NV_CHECK_RET(rtt_remove_all_check(state),                             NV_OK);
 
+    // The node cached by lookups follows shrinks and is dropped on removal
+    MEM_NV_CHECK_RET(rtt_range_add_check_val(state, 0, 99), NV_OK);
+    TEST_CHECK_RET(uvm_range_tree_find(&state->tree, 50) == state->nodes[0]);
+    MEM_NV_CHECK_RET(rtt_node_shrink_check_val(state, 0, 9), NV_OK);
+    TEST_CHECK_RET(uvm_range_tree_find(&state->tree, 50) == NULL);
+    TEST_CHECK_RET(uvm_range_tree_find(&state->tree, 5) == state->nodes[0]);
+    MEM_NV_CHECK_RET(rtt_index_remove_check_val(state, 5), NV_OK);
+    TEST_CHECK_RET(uvm_range_tree_find(&state->tree, 5) == NULL);
+    TEST_CHECK_RET(state->tree.cached_node == NULL);
+
     // Two non-overlapping ranges
     MEM_NV_CHECK_RET(rtt_range_add_check_val(state, 10,    20), NV_OK);
     MEM_NV_CHECK_RET(rtt_range_add_check_val(state,  0,     5), NV_OK); // Non-adjacent left
@@ -1713,3 +1723,77 @@ NV_STATUS uvm_test_range_tree_random(UVM_TEST_RANGE_TREE_RANDOM_PARAMS *params,
     rtt_state_destroy(state);
     return status;
 }
+
+// Number of precomputed addresses used by the random lookups, so that the
+// random number generator stays out of the measurements
+#define RTT_LOOKUP_PERF_ADDRESSES 4096
+
+// Size of the ranges, which are placed every 2MB
+#define RTT_LOOKUP_PERF_RANGE_SIZE (UVM_PAGE_SIZE_2M / 2)
+
+// Number of consecutive lookups made in the same node by the repeated lookup
+// pattern, one per 4K page, like the faults of a batch on the same VA block
+#define RTT_LOOKUP_PERF_REPEAT (RTT_LOOKUP_PERF_RANGE_SIZE / UVM_PAGE_SIZE_4K)
+
+NV_STATUS uvm_test_range_tree_lookup_perf(UVM_TEST_RANGE_TREE_LOOKUP_PERF_PARAMS *params, struct file *filp)
+{
+    NV_STATUS status = NV_OK;
+    uvm_range_tree_t tree;
+    uvm_range_tree_node_t *nodes;
+    NvU64 *addresses;
+    uvm_test_rng_t rng;
+    NvU64 start;
+    NvU32 i;
+
+    if (params->num_ranges == 0 ||
+        params->num_ranges > UVM_TEST_RANGE_TREE_LOOKUP_PERF_MAX_RANGES ||
+        params->iterations == 0)
+        return NV_ERR_INVALID_PARAMETER;
+
+    nodes = uvm_kvmalloc_zero(params->num_ranges * sizeof(*nodes));
+    addresses = uvm_kvmalloc(RTT_LOOKUP_PERF_ADDRESSES * sizeof(*addresses));
+    if (!nodes || !addresses) {
+        status = NV_ERR_NO_MEMORY;
+        goto done;
+    }
+
+    uvm_range_tree_init(&tree);
+    uvm_test_rng_init(&rng, params->seed);
+
+    // Leave a hole between ranges, like sparse allocations do
+    for (i = 0; i < params->num_ranges; i++) {
+        nodes[i].start = (NvU64)i * UVM_PAGE_SIZE_2M;
+        nodes[i].end = nodes[i].start + RTT_LOOKUP_PERF_RANGE_SIZE - 1;
+        TEST_NV_CHECK_GOTO(uvm_range_tree_add(&tree, &nodes[i]), done);
+    }
+
+    for (i = 0; i < RTT_LOOKUP_PERF_ADDRESSES; i++) {
+        NvU32 index = uvm_test_rng_range_32(&rng, 0, params->num_ranges - 1);
+
+        addresses[i] = nodes[index].start + uvm_test_rng_range_64(&rng, 0, RTT_LOOKUP_PERF_RANGE_SIZE - 1);
+    }
+
+    start = NV_GETTIME();
+    for (i = 0; i < params->iterations; i++) {
+        NvU64 addr = addresses[i % RTT_LOOKUP_PERF_ADDRESSES];
+
+        TEST_CHECK_GOTO(uvm_range_tree_find(&tree, addr) == &nodes[addr / UVM_PAGE_SIZE_2M], done);
+    }
+    params->random_lookups_ns = NV_GETTIME() - start;
+
+    start = NV_GETTIME();
+    for (i = 0; i < params->iterations; i++) {
+        NvU64 base = UVM_ALIGN_DOWN(addresses[(i / RTT_LOOKUP_PERF_REPEAT) % RTT_LOOKUP_PERF_ADDRESSES],
+                                    UVM_PAGE_SIZE_2M);
+        NvU64 addr = base + (i % RTT_LOOKUP_PERF_REPEAT) * UVM_PAGE_SIZE_4K;
+
+        TEST_CHECK_GOTO(uvm_range_tree_find(&tree, addr) == &nodes[addr / UVM_PAGE_SIZE_2M], done);
+    }
+    params->repeated_lookups_ns = NV_GETTIME() - start;
+
+done:
+    uvm_kvfree(addresses);
+    uvm_kvfree(nodes);
+
+    return status;
+}
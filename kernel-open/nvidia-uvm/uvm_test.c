@@ -309,6 +309,10 @@ long uvm_test_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
         UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_TEST_VA_SPACE_ALLOW_MOVABLE_ALLOCATIONS,
                                        uvm_test_va_space_allow_movable_allocations);
         UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_TEST_SKIP_MIGRATE_VMA, uvm_test_skip_migrate_vma);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_TEST_FAULT_SORT_PERF, uvm_test_fault_sort_perf);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_TEST_RANGE_TREE_LOOKUP_PERF, uvm_test_range_tree_lookup_perf);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_TEST_BENCHMARK, uvm_test_benchmark);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_TEST_PREFETCH_REPLAY, uvm_test_prefetch_replay);
     }
 
     return -EINVAL;
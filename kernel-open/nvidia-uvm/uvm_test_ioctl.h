@@ -1462,6 +1462,204 @@ typedef struct
     NV_STATUS rmStatus;                                  // Out
 } UVM_TEST_SKIP_MIGRATE_VMA_PARAMS;
 
+// Sort synthetic replayable fault batches with both the radix sort used during
+// fault batch preprocessing and the comparison sort it replaces, and check that
+// they produce the same order.
+#define UVM_TEST_FAULT_SORT_PERF                         UVM_TEST_IOCTL_BASE(104)
+typedef struct
+{
+    // Iterations to run. A new batch is generated in each iteration.
+    NvU32                           iterations;                                         // In
+
+    // Number of faults in each batch. Must not exceed
+    // UVM_TEST_FAULT_SORT_PERF_MAX_FAULTS.
+    NvU32                           num_faults;                                         // In
+
+    // Number of distinct VA spaces and instance pointers the faults are spread
+    // across.
+    NvU32                           num_va_spaces;                                      // In
+
+    // Percentage of faults swapped out of order after generating an ordered
+    // batch. 0 generates already sorted batches.
+    NvU32                           disorder_percent;                                   // In
+
+    NvU32                           seed;                                               // In
+
+    // Average time, in nanoseconds, spent sorting a batch with each method
+    NvU64                           radix_sort_ns NV_ALIGN_BYTES(8);                    // Out
+    NvU64                           comparison_sort_ns NV_ALIGN_BYTES(8);               // Out
+
+    NV_STATUS                       rmStatus;                                           // Out
+} UVM_TEST_FAULT_SORT_PERF_PARAMS;
+
+#define UVM_TEST_FAULT_SORT_PERF_MAX_FAULTS              (64 * 1024)
+
+// Look up addresses in a range tree of num_ranges nodes, and report the time
+// taken by lookups in random nodes and by runs of consecutive lookups in the
+// same node, which are served by the node cache of the tree. Comparing runs
+// with different num_ranges shows how the lookup cost scales with the size of
+// the tree.
+#define UVM_TEST_RANGE_TREE_LOOKUP_PERF                  UVM_TEST_IOCTL_BASE(105)
+typedef struct
+{
+    // Must not exceed UVM_TEST_RANGE_TREE_LOOKUP_PERF_MAX_RANGES
+    NvU32                           num_ranges;                                         // In
+
+    // Number of lookups made with each pattern
+    NvU32                           iterations;                                         // In
+
+    NvU32                           seed;                                               // In
+
+    // Total time, in nanoseconds, spent in the lookups of each pattern
+    NvU64                           random_lookups_ns NV_ALIGN_BYTES(8);                // Out
+    NvU64                           repeated_lookups_ns NV_ALIGN_BYTES(8);              // Out
+
+    NV_STATUS                       rmStatus;                                           // Out
+} UVM_TEST_RANGE_TREE_LOOKUP_PERF_PARAMS;
+
+#define UVM_TEST_RANGE_TREE_LOOKUP_PERF_MAX_RANGES       (1024 * 1024)
+
+typedef enum
+{
+    // Time uvm_push_begin() followed by uvm_push_end() of an empty push on a
+    // GPU internal channel. The cold variant waits for each push to complete
+    // before starting the next one, without timing the wait.
+    UVM_TEST_BENCHMARK_PUSH_BEGIN_END = 0,
+
+    // Time uvm_tracker_wait() on a tracker with a single empty push. The cold
+    // variant waits right after ending the push, so it includes the GPU round
+    // trip. The warm variant waits for the push to complete first, so only
+    // the completed tracker path is timed.
+    UVM_TEST_BENCHMARK_TRACKER_WAIT,
+
+    // Time the allocation and free of a single kernel chunk of chunk_size.
+    // The warm variant times an allocation and free pair repeatedly. The cold
+    // variant times each allocation while keeping all the previous chunks
+    // allocated, and frees them all at the end.
+    UVM_TEST_BENCHMARK_PMM_ALLOC_FREE,
+
+    // Time uvm_page_tree_get_ptes() followed by uvm_page_tree_put_ptes() for a
+    // single page of page_size in a new page tree. The warm variant keeps a
+    // reference on the page next to it so that the page tables stay
+    // allocated. The cold variant allocates and frees the whole hierarchy of
+    // page tables in each sample.
+    UVM_TEST_BENCHMARK_PAGE_TREE_GET_PUT,
+
+    // Time uvm_va_block_make_resident() of the pages selected by pattern in
+    // the managed VA block containing va, to the GPU, including waiting for
+    // the copies to complete. The cold variant moves the pages back to the
+    // CPU before each sample, without timing it. The warm variant times
+    // making resident pages which are already resident on the GPU.
+    UVM_TEST_BENCHMARK_MAKE_RESIDENT,
+
+    // Time the sort of a synthetic fault batch of num_faults faults, as done
+    // by UVM_TEST_FAULT_SORT_PERF with disorder_percent of 10. There is no
+    // cold variant.
+    UVM_TEST_BENCHMARK_FAULT_SORT,
+
+    // Time UVM_TEST_BENCHMARK_PAGE_MASK_OPS_PER_SAMPLE computations of the
+    // pages selected by pattern which are not resident, restricted to a region
+    // covering all but the first and last pages of a block, and of their
+    // count. One in every three pages is resident. The warm variant uses the
+    // fused uvm_page_mask_region_andnot_weight(). The cold variant uses the
+    // equivalent sequence of uvm_page_mask_andnot(),
+    // uvm_page_mask_region_clear_outside() and uvm_page_mask_region_weight().
+    // No GPU is used.
+    UVM_TEST_BENCHMARK_PAGE_MASK_OPS,
+
+    UVM_TEST_BENCHMARK_COUNT
+} UVM_TEST_BENCHMARK_TYPE;
+
+typedef enum
+{
+    UVM_TEST_BENCHMARK_PATTERN_ALL = 0,
+    UVM_TEST_BENCHMARK_PATTERN_FIRST_HALF,
+    UVM_TEST_BENCHMARK_PATTERN_EVERY_OTHER_PAGE,
+    UVM_TEST_BENCHMARK_PATTERN_COUNT
+} UVM_TEST_BENCHMARK_PATTERN;
+
+// Run one of the benchmarks in UVM_TEST_BENCHMARK_TYPE for the given number of
+// iterations, and report statistics of the time taken by each sample. Each
+// benchmark only uses the inputs it documents.
+#define UVM_TEST_BENCHMARK                               UVM_TEST_IOCTL_BASE(106)
+typedef struct
+{
+    NvU32                           type;                                               // In
+    NvBool                          cold;                                               // In
+
+    // Number of samples. Must not exceed UVM_TEST_BENCHMARK_MAX_ITERATIONS.
+    NvU32                           iterations;                                         // In
+
+    // Not used by UVM_TEST_BENCHMARK_FAULT_SORT and
+    // UVM_TEST_BENCHMARK_PAGE_MASK_OPS
+    NvProcessorUuid                 gpu_uuid;                                           // In
+
+    // UVM_TEST_BENCHMARK_PMM_ALLOC_FREE
+    NvU64                           chunk_size NV_ALIGN_BYTES(8);                       // In
+
+    // UVM_TEST_BENCHMARK_PAGE_TREE_GET_PUT
+    NvU64                           page_size NV_ALIGN_BYTES(8);                        // In
+
+    // UVM_TEST_BENCHMARK_MAKE_RESIDENT. The GPU must have a GPU VA space.
+    NvU64                           va NV_ALIGN_BYTES(8);                               // In
+
+    // UVM_TEST_BENCHMARK_MAKE_RESIDENT and UVM_TEST_BENCHMARK_PAGE_MASK_OPS
+    NvU32                           pattern;                                            // In
+
+    // UVM_TEST_BENCHMARK_FAULT_SORT. Must not exceed
+    // UVM_TEST_FAULT_SORT_PERF_MAX_FAULTS.
+    NvU32                           num_faults;                                         // In
+
+    // Sample statistics, in nanoseconds
+    NvU64                           min_ns NV_ALIGN_BYTES(8);                           // Out
+    NvU64                           median_ns NV_ALIGN_BYTES(8);                        // Out
+    NvU64                           p99_ns NV_ALIGN_BYTES(8);                           // Out
+    NvU64                           max_ns NV_ALIGN_BYTES(8);                           // Out
+
+    NV_STATUS                       rmStatus;                                           // Out
+} UVM_TEST_BENCHMARK_PARAMS;
+
+#define UVM_TEST_BENCHMARK_MAX_ITERATIONS                (64 * 1024)
+#define UVM_TEST_BENCHMARK_PAGE_MASK_OPS_PER_SAMPLE      1024
+
+// Replay a trace of faulted pages within a single VA block through the prefetch
+// heuristic and report how many pages it migrates. No GPU is used, so the
+// results only depend on the trace and on the prefetch module parameters in
+// effect, which makes runs with different parameters comparable.
+//
+// The block starts at a VA block aligned address with no resident pages, has no
+// preferred location, does not thrash and migrates to a processor with 64K big
+// pages. The trace is serviced in batches of batch_size consecutive
+// entries. Like in fault servicing, faults on pages which are already resident
+// are dropped, and the faulted pages and the pages selected for prefetching
+// become resident once the batch is serviced.
+#define UVM_TEST_PREFETCH_REPLAY                         UVM_TEST_IOCTL_BASE(107)
+typedef struct
+{
+    // User pointer to an array of trace_length NvU32 page indices, each less
+    // than block_pages
+    NvU64                           trace NV_ALIGN_BYTES(8);                            // In
+    NvU32                           trace_length;                                       // In
+
+    // Number of pages in the block. Must be between 1 and the number of pages
+    // of a VA block.
+    NvU32                           block_pages;                                        // In
+
+    // Must not be 0
+    NvU32                           batch_size;                                         // In
+
+    // Number of faults on non-resident pages
+    NvU32                           serviced_faults;                                    // Out
+
+    // Number of batches with at least one serviced fault
+    NvU32                           serviced_batches;                                   // Out
+
+    // Number of pages made resident by prefetching
+    NvU32                           prefetched_pages;                                   // Out
+
+    NV_STATUS                       rmStatus;                                           // Out
+} UVM_TEST_PREFETCH_REPLAY_PARAMS;
+
 #ifdef __cplusplus
 }
 #endif
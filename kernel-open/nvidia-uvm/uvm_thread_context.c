@@ -26,6 +26,8 @@
 
 #include "uvm_linux.h"
 #include "uvm_common.h"
+#include "uvm_va_block.h"
+#include "uvm_va_space.h"
 
 // Thread local storage implementation.
 //
@@ -66,6 +68,14 @@ typedef struct  {
     atomic64_t task;
 
     uvm_thread_context_t *thread_context;
+
+    // Contexts preallocated for the thread context stored in this entry. See
+    // uvm_thread_context_block_context_get(). They are allocated on first use
+    // and freed back to their object caches when the thread context is
+    // removed, so idle entries don't hold on to them. Only accessed by the
+    // task owning the entry.
+    uvm_va_block_context_t *block_context;
+    uvm_service_block_context_t *service_context;
 } ____cacheline_aligned_in_smp uvm_thread_context_array_entry_t;
 
 // The thread's context information is stored in the array or the red-black
@@ -269,11 +279,26 @@ static uvm_thread_context_lock_t *thread_context_lock_of(uvm_thread_context_t *t
     return context_lock;
 }
 
+static void thread_context_array_entry_free_contexts(uvm_thread_context_array_entry_t *array_entry)
+{
+    if (array_entry->block_context) {
+        uvm_va_block_context_free(array_entry->block_context);
+        array_entry->block_context = NULL;
+    }
+
+    if (array_entry->service_context) {
+        uvm_service_block_context_free(array_entry->service_context);
+        array_entry->service_context = NULL;
+    }
+}
+
 static void thread_context_non_interrupt_init(uvm_thread_context_t *thread_context)
 {
     UVM_ASSERT(!in_interrupt());
 
     thread_context->array_index = UVM_THREAD_CONTEXT_ARRAY_SIZE;
+    thread_context->block_context_in_use = false;
+    thread_context->service_context_in_use = false;
 
     if (uvm_thread_context_wrapper_is_used()) {
         uvm_thread_context_wrapper_t *thread_context_wrapper;
@@ -296,6 +321,11 @@ static void thread_context_non_interrupt_deinit(uvm_thread_context_t *thread_con
 
     UVM_ASSERT(!in_interrupt());
 
+    // The preallocated contexts must not be used past the UVM entry point or
+    // by a different thread context.
+    UVM_ASSERT(!thread_context->block_context_in_use);
+    UVM_ASSERT(!thread_context->service_context_in_use);
+
     context_lock = thread_context_lock_of(thread_context);
     if (context_lock != NULL) {
         UVM_ASSERT(__uvm_check_all_unlocked(context_lock));
@@ -540,6 +570,8 @@ static void thread_context_non_interrupt_remove(uvm_thread_context_t *thread_con
         UVM_ASSERT(array_index < UVM_THREAD_CONTEXT_ARRAY_SIZE);
         UVM_ASSERT(atomic64_read(&array_entry->task) == (NvU64) thread_context->task);
 
+        thread_context_array_entry_free_contexts(array_entry);
+
         // Clear the task. The memory barrier prevents the write from being
         // moved before a previous (in program order) write to the entry's
         // thread_context field in thread_context_non_interrupt_add.
@@ -647,6 +679,113 @@ void uvm_thread_context_restore(uvm_thread_context_t *src)
     thread_context_non_interrupt_deinit(src);
 }
 
+// Return the array entry storing the current thread context, or NULL if there
+// is no thread context or it is stored in the tree.
+static uvm_thread_context_array_entry_t *thread_context_current_array_entry(uvm_thread_context_t **thread_context_out)
+{
+    uvm_thread_context_t *thread_context;
+    uvm_thread_context_table_entry_t *table_entry;
+
+    UVM_ASSERT(!in_interrupt());
+
+    thread_context = thread_context_current();
+    *thread_context_out = thread_context;
+    if (!thread_context || thread_context->array_index == UVM_THREAD_CONTEXT_ARRAY_SIZE)
+        return NULL;
+
+    table_entry = thread_context_non_interrupt_table_entry(NULL);
+    return table_entry->array + thread_context->array_index;
+}
+
+uvm_va_block_context_t *uvm_thread_context_block_context_get(struct mm_struct *mm)
+{
+    uvm_thread_context_t *thread_context;
+    uvm_thread_context_array_entry_t *array_entry = thread_context_current_array_entry(&thread_context);
+
+    if (!array_entry || thread_context->block_context_in_use)
+        return uvm_va_block_context_alloc(mm);
+
+    if (array_entry->block_context) {
+        uvm_va_block_context_init(array_entry->block_context, mm);
+    }
+    else {
+        array_entry->block_context = uvm_va_block_context_alloc(mm);
+        if (!array_entry->block_context)
+            return NULL;
+    }
+
+    thread_context->block_context_in_use = true;
+
+    return array_entry->block_context;
+}
+
+void uvm_thread_context_block_context_put(uvm_va_block_context_t *block_context)
+{
+    uvm_thread_context_t *thread_context;
+    uvm_thread_context_array_entry_t *array_entry = thread_context_current_array_entry(&thread_context);
+
+    if (array_entry && array_entry->block_context == block_context) {
+        UVM_ASSERT(thread_context->block_context_in_use);
+        thread_context->block_context_in_use = false;
+        return;
+    }
+
+    uvm_va_block_context_free(block_context);
+}
+
+uvm_service_block_context_t *uvm_thread_context_service_context_get(struct mm_struct *mm)
+{
+    uvm_thread_context_t *thread_context;
+    uvm_thread_context_array_entry_t *array_entry = thread_context_current_array_entry(&thread_context);
+
+    if (!array_entry || thread_context->service_context_in_use)
+        return uvm_service_block_context_alloc(mm);
+
+    if (array_entry->service_context) {
+        uvm_va_block_context_init(array_entry->service_context->block_context, mm);
+    }
+    else {
+        array_entry->service_context = uvm_service_block_context_alloc(mm);
+        if (!array_entry->service_context)
+            return NULL;
+    }
+
+    thread_context->service_context_in_use = true;
+
+    return array_entry->service_context;
+}
+
+void uvm_thread_context_service_context_put(uvm_service_block_context_t *service_context)
+{
+    uvm_thread_context_t *thread_context;
+    uvm_thread_context_array_entry_t *array_entry = thread_context_current_array_entry(&thread_context);
+
+    if (array_entry && array_entry->service_context == service_context) {
+        UVM_ASSERT(thread_context->service_context_in_use);
+        thread_context->service_context_in_use = false;
+        return;
+    }
+
+    uvm_service_block_context_free(service_context);
+}
+
+void uvm_thread_context_free_preallocated(void)
+{
+    size_t table_index;
+    size_t array_index;
+
+    if (!uvm_thread_context_global_initialized())
+        return;
+
+    for (table_index = 0; table_index < UVM_THREAD_CONTEXT_TABLE_SIZE; table_index++) {
+        uvm_thread_context_table_entry_t *table_entry = g_thread_context_table + table_index;
+
+        for (array_index = 0; array_index < UVM_THREAD_CONTEXT_ARRAY_SIZE; array_index++) {
+            thread_context_array_entry_free_contexts(table_entry->array + array_index);
+        }
+    }
+}
+
 uvm_thread_context_lock_t *uvm_thread_context_lock_get(void)
 {
     return thread_context_lock_of(uvm_thread_context());
@@ -79,6 +79,14 @@ struct uvm_thread_context_struct
     // Used to filter out invalidations we don't care about.
     unsigned long hmm_invalidate_seqnum;
 
+    // Set while the VA block context and the service context preallocated for
+    // this thread context are handed out. See
+    // uvm_thread_context_block_context_get().
+    //
+    // This field is ignored in interrupt paths
+    bool block_context_in_use;
+    bool service_context_in_use;
+
     // Pointer to enclosing node (if any) in red-black tree
     //
     // This field is ignored in interrupt paths
@@ -152,6 +160,37 @@ void uvm_thread_context_save(uvm_thread_context_t *dst);
 // thread context.
 void uvm_thread_context_restore(uvm_thread_context_t *src);
 
+// Get a VA block context for the current thread, reusing the one preallocated
+// for its thread context if possible. The thread contexts stored in the global
+// array each own a VA block context, allocated on first use and kept until the
+// thread context is removed, so paths that get one several times within the
+// same UVM entry point don't allocate one on every call. Once freed, the
+// context goes back to the per-CPU stash of its object cache.
+//
+// The preallocated context is handed out once at a time. Nested calls before
+// it is put back, calls from threads whose context is not in the array, and
+// calls without a thread context get a newly allocated VA block context
+// instead. The context is initialized with the given mm, see
+// uvm_va_block_context_init().
+//
+// Returns NULL if the allocation fails. Every context must be returned with
+// uvm_thread_context_block_context_put() before leaving the UVM entry point
+// it was obtained in.
+//
+// Do not invoke these functions in a interrupt path.
+uvm_va_block_context_t *uvm_thread_context_block_context_get(struct mm_struct *mm);
+void uvm_thread_context_block_context_put(uvm_va_block_context_t *block_context);
+
+// Same as uvm_thread_context_block_context_get() and
+// uvm_thread_context_block_context_put(), for service block contexts.
+uvm_service_block_context_t *uvm_thread_context_service_context_get(struct mm_struct *mm);
+void uvm_thread_context_service_context_put(uvm_service_block_context_t *service_context);
+
+// Free the contexts preallocated for the thread contexts still in the global
+// array. Called from the module exit path, before the caches they come from are
+// destroyed.
+void uvm_thread_context_free_preallocated(void);
+
 // Get the current thread lock context. Returns NULL if there is no thread lock
 // context (we are in release mode, or an internal allocation failed).
 uvm_thread_context_lock_t *uvm_thread_context_lock_get(void);
@@ -96,6 +96,8 @@ NV_STATUS uvm_test_thread_context_sanity(UVM_TEST_THREAD_CONTEXT_SANITY_PARAMS *
     NvU32 i;
     uvm_thread_context_t *thread_context, *nested_thread_context;
     uvm_thread_context_wrapper_t thread_context_wrapper_backup;
+    uvm_va_block_context_t *block_context, *nested_block_context;
+    bool same_block_context;
 
     if (params->iterations == 0)
         return NV_ERR_INVALID_ARGUMENT;
@@ -110,6 +112,23 @@ NV_STATUS uvm_test_thread_context_sanity(UVM_TEST_THREAD_CONTEXT_SANITY_PARAMS *
     nested_thread_context = inner_thread_context();
     TEST_CHECK_RET(nested_thread_context == thread_context);
 
+    // The VA block context preallocated for the thread context is handed out
+    // once at a time, so nested users get a different one.
+    block_context = uvm_thread_context_block_context_get(NULL);
+    if (!block_context)
+        return NV_ERR_NO_MEMORY;
+
+    nested_block_context = uvm_thread_context_block_context_get(NULL);
+    if (!nested_block_context) {
+        uvm_thread_context_block_context_put(block_context);
+        return NV_ERR_NO_MEMORY;
+    }
+
+    same_block_context = (nested_block_context == block_context);
+    uvm_thread_context_block_context_put(nested_block_context);
+    uvm_thread_context_block_context_put(block_context);
+    TEST_CHECK_RET(!same_block_context);
+
     uvm_thread_context_save(&thread_context_wrapper_backup.context);
 
     uvm_thread_context_remove(thread_context);
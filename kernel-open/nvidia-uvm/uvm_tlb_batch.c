@@ -86,7 +86,7 @@ static void tlb_batch_flush_invalidate_all(uvm_tlb_batch_t *batch, uvm_push_t *p
     gpu->parent->host_hal->tlb_invalidate_all(push, uvm_page_tree_pdb(tree)->addr, page_table_depth, batch->membar);
 }
 
-static bool tlb_batch_should_invalidate_all(uvm_tlb_batch_t *batch)
+static bool tlb_batch_should_invalidate_all(const uvm_tlb_batch_t *batch)
 {
     if (!batch->tree->gpu->parent->tlb_batch.va_invalidate_supported)
         return true;
@@ -119,6 +119,23 @@ void uvm_tlb_batch_invalidate(uvm_tlb_batch_t *batch, NvU64 start, NvU64 size, N
 
     batch->membar = uvm_membar_max(tlb_membar, batch->membar);
 
+    // Callers commonly queue up ranges in address order, for example one per
+    // serviced VA region. Extend the last range if the new one directly
+    // follows it so that contiguous invalidates don't use up the entries and
+    // fall back to invalidate all.
+    if (batch->count > 0 && !tlb_batch_should_invalidate_all(batch)) {
+        uvm_tlb_batch_range_t *last_entry = &batch->ranges[batch->count - 1];
+
+        if (last_entry->page_sizes == page_sizes && last_entry->start + last_entry->size == start) {
+            last_entry->size += size;
+
+            if (!batch->tree->gpu->parent->tlb_batch.va_range_invalidate_supported)
+                batch->total_pages += uvm_div_pow2_64(size, smallest_page_size(page_sizes));
+
+            return;
+        }
+    }
+
     ++batch->count;
 
     if (batch->tree->gpu->parent->tlb_batch.va_range_invalidate_supported)
@@ -136,3 +153,29 @@ void uvm_tlb_batch_invalidate(uvm_tlb_batch_t *batch, NvU64 start, NvU64 size, N
     new_entry->size = size;
     new_entry->page_sizes = page_sizes;
 }
+
+void uvm_tlb_batch_merge(uvm_tlb_batch_t *batch, const uvm_tlb_batch_t *other, uvm_membar_t tlb_membar)
+{
+    NvU32 i;
+
+    UVM_ASSERT(batch->tree == other->tree);
+
+    if (other->count == 0)
+        return;
+
+    batch->membar = uvm_membar_max(tlb_membar, uvm_membar_max(other->membar, batch->membar));
+
+    // If the other batch already gave up on tracking the ranges, the merged
+    // batch has to invalidate all as well.
+    if (tlb_batch_should_invalidate_all(other)) {
+        batch->count = UVM_TLB_BATCH_MAX_ENTRIES + 1;
+        batch->biggest_page_size = max(batch->biggest_page_size, other->biggest_page_size);
+        return;
+    }
+
+    for (i = 0; i < other->count; ++i) {
+        const uvm_tlb_batch_range_t *entry = &other->ranges[i];
+
+        uvm_tlb_batch_invalidate(batch, entry->start, entry->size, entry->page_sizes, UVM_MEMBAR_NONE);
+    }
+}
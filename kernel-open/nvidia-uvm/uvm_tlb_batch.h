@@ -94,6 +94,16 @@ void uvm_tlb_batch_invalidate(uvm_tlb_batch_t *batch, NvU64 start, NvU64 size, N
 // batch.
 void uvm_tlb_batch_end(uvm_tlb_batch_t *batch, uvm_push_t *push, uvm_membar_t tlb_membar);
 
+// Queue up all the invalidates of the other batch into batch, instead of
+// pushing them. Both batches have to be for the same page tree. This allows
+// callers to accumulate the invalidates of several independent operations,
+// for example across VA blocks, and push them once with uvm_tlb_batch_end.
+//
+// If the other batch already fell back to invalidating all, so does batch.
+//
+// The tlb_membar argument has the same behavior as in uvm_tlb_batch_end.
+void uvm_tlb_batch_merge(uvm_tlb_batch_t *batch, const uvm_tlb_batch_t *other, uvm_membar_t tlb_membar);
+
 // Helper for invalidating a single range immediately.
 //
 // Internally begins and ends a TLB batch.
@@ -43,6 +43,17 @@
 // over and over again in an attempt to overflow the refcount.
 #define MAX_PAGE_COUNT (1 << 20)
 
+// Only record 1 in uvm_tools_fault_event_sample_period CPU and GPU fault events
+// per VA space, so that fault tracing can be left enabled with low overhead.
+// Fault counters are not affected. 0 is treated as 1, which records every
+// fault event.
+static unsigned uvm_tools_fault_event_sample_period = 1;
+module_param(uvm_tools_fault_event_sample_period, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_tools_fault_event_sample_period,
+                 "Record one in this many fault events in tools event queues");
+
+static unsigned g_uvm_tools_fault_event_sample_period;
+
 typedef struct
 {
     NvU32 get_ahead;
@@ -323,6 +334,25 @@ fail:
     return status;
 }
 
+static void tools_update_enabled_events(uvm_va_space_t *va_space)
+{
+    NvU32 i;
+
+    uvm_assert_rwsem_locked_write(&va_space->tools.lock);
+
+    BUILD_BUG_ON(UvmEventNumTypesAll > sizeof(va_space->tools.enabled_events_v1) * 8);
+
+    va_space->tools.enabled_events_v1 = 0;
+    va_space->tools.enabled_events_v2 = 0;
+
+    for (i = 0; i < UvmEventNumTypesAll; i++) {
+        if (!list_empty(va_space->tools.queues_v1 + i))
+            va_space->tools.enabled_events_v1 |= 1ULL << i;
+        if (!list_empty(va_space->tools.queues_v2 + i))
+            va_space->tools.enabled_events_v2 |= 1ULL << i;
+    }
+}
+
 static void insert_event_tracker(uvm_va_space_t *va_space,
                                  struct list_head *node,
                                  NvU32 list_count,
@@ -346,6 +376,8 @@ static void insert_event_tracker(uvm_va_space_t *va_space,
 
     *subscribed_mask |= list_mask;
     *inserted_lists = insertable_lists;
+
+    tools_update_enabled_events(va_space);
 }
 
 static void remove_event_tracker(uvm_va_space_t *va_space,
@@ -369,6 +401,8 @@ static void remove_event_tracker(uvm_va_space_t *va_space,
     }
 
     *subscribed_mask &= ~list_mask;
+
+    tools_update_enabled_events(va_space);
 }
 
 static bool queue_needs_wakeup(uvm_tools_queue_t *queue, uvm_tools_queue_snapshot_t *sn)
@@ -595,9 +629,9 @@ static bool tools_is_event_enabled_version(uvm_va_space_t *va_space,
     UVM_ASSERT(event < UvmEventNumTypesAll);
 
     if (version == UvmToolsEventQueueVersion_V1)
-        return !list_empty(va_space->tools.queues_v1 + event);
+        return !!(va_space->tools.enabled_events_v1 & (1ULL << event));
     else
-        return !list_empty(va_space->tools.queues_v2 + event);
+        return !!(va_space->tools.enabled_events_v2 & (1ULL << event));
 }
 
 static bool tools_is_event_enabled(uvm_va_space_t *va_space, UvmEventType event)
@@ -606,8 +640,21 @@ static bool tools_is_event_enabled(uvm_va_space_t *va_space, UvmEventType event)
 
     UVM_ASSERT(event < UvmEventNumTypesAll);
 
-    return !list_empty(va_space->tools.queues_v1 + event) ||
-           !list_empty(va_space->tools.queues_v2 + event);
+    return !!((va_space->tools.enabled_events_v1 | va_space->tools.enabled_events_v2) & (1ULL << event));
+}
+
+// Return whether the current fault event should be recorded in the event
+// queues. This is only used for CPU and GPU fault events.
+static bool tools_fault_event_is_sampled(uvm_va_space_t *va_space)
+{
+    NvU64 num_fault_events;
+
+    if (g_uvm_tools_fault_event_sample_period <= 1)
+        return true;
+
+    num_fault_events = atomic64_inc_return(&va_space->tools.num_fault_events);
+
+    return do_div(num_fault_events, g_uvm_tools_fault_event_sample_period) == 0;
 }
 
 static bool tools_is_event_enabled_in_any_va_space(UvmEventType event)
@@ -867,7 +914,9 @@ static void uvm_tools_record_fault(uvm_perf_event_t event_id, uvm_perf_event_dat
     UVM_ASSERT(tools_is_fault_callback_needed(va_space));
 
     if (UVM_ID_IS_CPU(event_data->fault.proc_id)) {
-        if (tools_is_event_enabled_version(va_space, UvmEventTypeCpuFault, UvmToolsEventQueueVersion_V1)) {
+        bool sampled = tools_is_event_enabled(va_space, UvmEventTypeCpuFault) && tools_fault_event_is_sampled(va_space);
+
+        if (sampled && tools_is_event_enabled_version(va_space, UvmEventTypeCpuFault, UvmToolsEventQueueVersion_V1)) {
             UvmEventEntry_V1 entry;
             memset(&entry, 0, sizeof(entry));
 
@@ -875,7 +924,7 @@ static void uvm_tools_record_fault(uvm_perf_event_t event_id, uvm_perf_event_dat
 
             uvm_tools_record_event_v1(va_space, &entry);
         }
-        if (tools_is_event_enabled_version(va_space, UvmEventTypeCpuFault, UvmToolsEventQueueVersion_V2)) {
+        if (sampled && tools_is_event_enabled_version(va_space, UvmEventTypeCpuFault, UvmToolsEventQueueVersion_V2)) {
             UvmEventEntry_V2 entry;
             memset(&entry, 0, sizeof(entry));
 
@@ -905,7 +954,7 @@ static void uvm_tools_record_fault(uvm_perf_event_t event_id, uvm_perf_event_dat
         uvm_gpu_t *gpu = uvm_va_space_get_gpu(va_space, event_data->fault.proc_id);
         UVM_ASSERT(gpu);
 
-        if (tools_is_event_enabled(va_space, UvmEventTypeGpuFault)) {
+        if (tools_is_event_enabled(va_space, UvmEventTypeGpuFault) && tools_fault_event_is_sampled(va_space)) {
             NvU64 timestamp = NV_GETTIME();
             uvm_fault_buffer_entry_t *fault_entry = event_data->fault.gpu.buffer_entry;
             uvm_fault_buffer_entry_t *fault_instance;
@@ -1735,7 +1784,10 @@ void uvm_tools_record_gpu_fatal_fault(uvm_gpu_id_t gpu_id,
 void uvm_tools_record_thrashing(uvm_va_space_t *va_space,
                                 NvU64 address,
                                 size_t region_size,
-                                const uvm_processor_mask_t *processors)
+                                const uvm_processor_mask_t *processors,
+                                NvU32 num_throttles,
+                                NvU32 num_pins_local,
+                                NvU32 num_pins_remote)
 {
     UVM_ASSERT(address);
     UVM_ASSERT(PAGE_ALIGNED(address));
@@ -1776,6 +1828,10 @@ void uvm_tools_record_thrashing(uvm_va_space_t *va_space,
         info->size      = region_size;
         info->timeStamp = NV_GETTIME();
 
+        info->numThrottles  = min(num_throttles, (NvU32)NV_U16_MAX);
+        info->numPinsLocal  = min(num_pins_local, (NvU32)NV_U16_MAX);
+        info->numPinsRemote = min(num_pins_remote, (NvU32)NV_U16_MAX);
+
         BUILD_BUG_ON(UVM_MAX_PROCESSORS < UVM_ID_MAX_PROCESSORS);
         bitmap_copy((long unsigned *)&info->processors, processors->bitmap, UVM_ID_MAX_PROCESSORS);
 
@@ -2736,6 +2792,23 @@ NV_STATUS uvm_api_tools_flush_events(UVM_TOOLS_FLUSH_EVENTS_PARAMS *params, stru
     return NV_OK;
 }
 
+NV_STATUS uvm_api_tools_get_fault_latency_histogram(UVM_TOOLS_GET_FAULT_LATENCY_HISTOGRAM_PARAMS *params,
+                                                    struct file *filp)
+{
+    uvm_gpu_t *gpu;
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+
+    gpu = uvm_va_space_retain_gpu_by_uuid(va_space, &params->gpuUuid);
+    if (!gpu)
+        return NV_ERR_INVALID_DEVICE;
+
+    uvm_parent_gpu_fault_latency_histogram(gpu->parent, params->histogram);
+
+    uvm_gpu_release(gpu);
+
+    return NV_OK;
+}
+
 NV_STATUS uvm_test_tools_flush_replay_events(UVM_TEST_TOOLS_FLUSH_REPLAY_EVENTS_PARAMS *params, struct file *filp)
 {
     NV_STATUS status = NV_OK;
@@ -2794,6 +2867,8 @@ int uvm_tools_init(dev_t uvm_base_dev)
 
     uvm_init_rwsem(&g_tools_va_space_list_lock, UVM_LOCK_ORDER_TOOLS_VA_SPACE_LIST);
 
+    g_uvm_tools_fault_event_sample_period = max(uvm_tools_fault_event_sample_period, 1u);
+
     g_tools_event_tracker_cache = NV_KMEM_CACHE_CREATE("uvm_tools_event_tracker_t",
                                                         uvm_tools_event_tracker_t);
     if (!g_tools_event_tracker_cache)
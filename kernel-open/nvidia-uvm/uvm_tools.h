@@ -39,6 +39,8 @@ NV_STATUS uvm_api_tools_read_process_memory(UVM_TOOLS_READ_PROCESS_MEMORY_PARAMS
 NV_STATUS uvm_api_tools_write_process_memory(UVM_TOOLS_WRITE_PROCESS_MEMORY_PARAMS *params, struct file *filp);
 NV_STATUS uvm_api_tools_get_processor_uuid_table(UVM_TOOLS_GET_PROCESSOR_UUID_TABLE_PARAMS *params, struct file *filp);
 NV_STATUS uvm_api_tools_flush_events(UVM_TOOLS_FLUSH_EVENTS_PARAMS *params, struct file *filp);
+NV_STATUS uvm_api_tools_get_fault_latency_histogram(UVM_TOOLS_GET_FAULT_LATENCY_HISTOGRAM_PARAMS *params,
+                                                    struct file *filp);
 
 static UvmEventFatalReason uvm_tools_status_to_fatal_fault_reason(NV_STATUS status)
 {
@@ -68,10 +70,15 @@ void uvm_tools_record_gpu_fatal_fault(uvm_gpu_id_t gpu_id,
                                       const uvm_fault_buffer_entry_t *fault_entry,
                                       UvmEventFatalReason reason);
 
+// num_throttles, num_pins_local and num_pins_remote are the thrashing
+// mitigation decision counts reported in UvmEventThrashingDetectedInfo_V2.
 void uvm_tools_record_thrashing(uvm_va_space_t *va_space,
                                 NvU64 address,
                                 size_t region_size,
-                                const uvm_processor_mask_t *processors);
+                                const uvm_processor_mask_t *processors,
+                                NvU32 num_throttles,
+                                NvU32 num_pins_local,
+                                NvU32 num_pins_remote);
 
 void uvm_tools_record_throttling_start(uvm_va_space_t *va_space, NvU64 address, uvm_processor_id_t processor);
 
@@ -102,9 +102,11 @@ NV_STATUS uvm_tracker_overwrite(uvm_tracker_t *dst, uvm_tracker_t *src)
 NV_STATUS uvm_tracker_reserve(uvm_tracker_t *tracker, NvU32 min_free_entries)
 {
     if (tracker->size + min_free_entries > tracker->max_size) {
-        // Special case the first resize to jump from 1 all the way to 8.
-        // This is based on a guess that if a tracker needs more than 1
-        // entry it likely needs much more.
+        // Special case the first resize to jump from the static storage all
+        // the way to at least 8. This is based on a guess that if a tracker
+        // needs more than the static entries it likely needs much more.
+        // The new size is always larger than the static storage, which is
+        // what tracker_is_using_static_entries() relies on.
         // TODO: Bug 1764961: Verify that guess.
         NvU32 new_max_size = max((NvU32)8, (NvU32)roundup_pow_of_two(tracker->size + min_free_entries));
         uvm_tracker_entry_t *new_entries;
@@ -175,9 +177,11 @@ void uvm_tracker_overwrite_with_push(uvm_tracker_t *tracker, uvm_push_t *push)
     uvm_tracker_overwrite_with_entry(tracker, &entry);
 }
 
-static NV_STATUS reserve_for_entries_from_tracker(uvm_tracker_t *dst, uvm_tracker_t *src)
+// Count the entries of src for channels that are not yet tracked by dst, i.e.
+// the number of new entries adding src to dst would require.
+static NvU32 count_new_entries_from_tracker(uvm_tracker_t *dst, uvm_tracker_t *src)
 {
-    NvU32 needed_free_entries = 0;
+    NvU32 new_entries = 0;
     uvm_tracker_entry_t *src_entry, *dst_entry;
 
     for_each_tracker_entry(src_entry, src) {
@@ -189,10 +193,15 @@ static NV_STATUS reserve_for_entries_from_tracker(uvm_tracker_t *dst, uvm_tracke
             }
         }
         if (!found)
-            needed_free_entries++;
+            new_entries++;
     }
 
-    return uvm_tracker_reserve(dst, needed_free_entries);
+    return new_entries;
+}
+
+static NV_STATUS reserve_for_entries_from_tracker(uvm_tracker_t *dst, uvm_tracker_t *src)
+{
+    return uvm_tracker_reserve(dst, count_new_entries_from_tracker(dst, src));
 }
 
 NV_STATUS uvm_tracker_add_tracker(uvm_tracker_t *dst, uvm_tracker_t *src)
@@ -211,15 +220,24 @@ NV_STATUS uvm_tracker_add_tracker(uvm_tracker_t *dst, uvm_tracker_t *src)
     if (uvm_tracker_is_empty(src))
         return NV_OK;
 
-    status = uvm_tracker_reserve(dst, src->size);
-    if (status == NV_ERR_NO_MEMORY) {
+    // Entries for channels already tracked by dst are merged in place, so only
+    // reserve space for the remaining ones. If that still doesn't fit, compact
+    // dst by dropping its completed entries before growing it. Long-lived
+    // trackers, like the VA block ones, accumulate an entry for every channel
+    // they ever saw and without compaction they would keep growing even
+    // though most of their entries are long completed.
+    if (dst->size + count_new_entries_from_tracker(dst, src) > dst->max_size) {
         uvm_tracker_remove_completed(dst);
-        uvm_tracker_remove_completed(src);
+
         status = reserve_for_entries_from_tracker(dst, src);
-    }
+        if (status == NV_ERR_NO_MEMORY) {
+            uvm_tracker_remove_completed(src);
+            status = reserve_for_entries_from_tracker(dst, src);
+        }
 
-    if (status != NV_OK)
-        return status;
+        if (status != NV_OK)
+            return status;
+    }
 
     for_each_tracker_entry(src_entry, src) {
         status = uvm_tracker_add_entry(dst, src_entry);
@@ -298,12 +316,17 @@ static void uvm_tracker_print_pending_pushes(uvm_tracker_t *tracker)
         uvm_tracker_entry_print_pending_pushes(entry);
 }
 
-static NV_STATUS wait_for_entry_with_spin(uvm_tracker_entry_t *tracker_entry, uvm_spin_loop_t *spin)
+static NV_STATUS wait_for_entry_with_waiter(uvm_tracker_entry_t *tracker_entry, uvm_channel_waiter_t *waiter)
 {
     NV_STATUS status = NV_OK;
 
+    // The push may have its GPPUT update deferred, in which case the GPU
+    // won't ever see it unless it's submitted first.
+    if (tracker_entry->channel)
+        uvm_channel_flush_deferred_gpu_put(tracker_entry->channel);
+
     while (!uvm_tracker_is_entry_completed(tracker_entry) && status == NV_OK) {
-        if (UVM_SPIN_LOOP(spin) == NV_ERR_TIMEOUT_RETRY)
+        if (uvm_channel_waiter_wait(waiter, tracker_entry->channel) == NV_ERR_TIMEOUT_RETRY)
             uvm_tracker_entry_print_pending_pushes(tracker_entry);
 
         status = uvm_channel_check_errors(tracker_entry->channel);
@@ -322,19 +345,26 @@ static NV_STATUS wait_for_entry_with_spin(uvm_tracker_entry_t *tracker_entry, uv
 
 NV_STATUS uvm_tracker_wait_for_entry(uvm_tracker_entry_t *tracker_entry)
 {
-    uvm_spin_loop_t spin;
-    uvm_spin_loop_init(&spin);
-    return wait_for_entry_with_spin(tracker_entry, &spin);
+    uvm_channel_waiter_t waiter;
+    uvm_channel_waiter_init(&waiter);
+    return wait_for_entry_with_waiter(tracker_entry, &waiter);
 }
 
 NV_STATUS uvm_tracker_wait(uvm_tracker_t *tracker)
 {
     NV_STATUS status = NV_OK;
-    uvm_spin_loop_t spin;
+    uvm_tracker_entry_t *entry;
+    uvm_channel_waiter_t waiter;
+
+    // See wait_for_entry_with_waiter()
+    for_each_tracker_entry(entry, tracker)
+        uvm_channel_flush_deferred_gpu_put(entry->channel);
 
-    uvm_spin_loop_init(&spin);
+    uvm_channel_waiter_init(&waiter);
     while (!uvm_tracker_is_completed(tracker) && status == NV_OK) {
-        if (UVM_SPIN_LOOP(&spin) == NV_ERR_TIMEOUT_RETRY)
+        // uvm_tracker_is_completed() removes the completed entries, so the
+        // first entry is still pending.
+        if (uvm_channel_waiter_wait(&waiter, uvm_tracker_get_entries(tracker)[0].channel) == NV_ERR_TIMEOUT_RETRY)
             uvm_tracker_print_pending_pushes(tracker);
 
         status = uvm_tracker_check_errors(tracker);
@@ -360,15 +390,15 @@ NV_STATUS uvm_tracker_wait_for_other_gpus(uvm_tracker_t *tracker, uvm_gpu_t *gpu
 {
     NV_STATUS status = NV_OK;
     uvm_tracker_entry_t *entry;
-    uvm_spin_loop_t spin;
+    uvm_channel_waiter_t waiter;
 
-    uvm_spin_loop_init(&spin);
+    uvm_channel_waiter_init(&waiter);
 
     for_each_tracker_entry(entry, tracker) {
         if (uvm_tracker_entry_gpu(entry) == gpu)
             continue;
 
-        status = wait_for_entry_with_spin(entry, &spin);
+        status = wait_for_entry_with_waiter(entry, &waiter);
         if (status != NV_OK)
             break;
     }
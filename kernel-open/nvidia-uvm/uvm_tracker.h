@@ -41,15 +41,24 @@ typedef struct
     NvU64 value;
 } uvm_tracker_entry_t;
 
+// Number of entries that fit in a tracker's static storage. A single entry is
+// likely the most common use-case, but builds that regularly track work on
+// several channels at once (e.g. multi-GPU copies) can raise this to keep
+// trackers from ever needing a dynamic allocation, at the cost of a larger
+// uvm_tracker_t.
+#ifndef UVM_TRACKER_STATIC_ENTRIES
+#define UVM_TRACKER_STATIC_ENTRIES 1
+#endif
+
 typedef struct
 {
     union
     {
-        // The default static storage can fit a single entry as that's likely
-        // the most common use-case. If the tracker ever needs more space, a
-        // dynamic allocation will be made as part of adding an entry and
-        // dynamic_entries below will be used.
-        uvm_tracker_entry_t static_entries[1];
+        // The default static storage can fit UVM_TRACKER_STATIC_ENTRIES
+        // entries. If the tracker ever needs more space, a dynamic allocation
+        // will be made as part of adding an entry and dynamic_entries below
+        // will be used.
+        uvm_tracker_entry_t static_entries[UVM_TRACKER_STATIC_ENTRIES];
 
         // Pointer to the array with dynamically allocated entries
         uvm_tracker_entry_t *dynamic_entries;
@@ -1032,8 +1032,15 @@ typedef struct
     // or malign-double will have no effect on the field offsets
     //
     NvU8 padding8bits;
-    NvU16 padding16bits;
-    NvU32 padding32bits;
+    //
+    // Number of thrashing mitigation decisions taken on the VA block that
+    // contains the memory region since its thrashing tracking state was
+    // created. The counts saturate at NV_U16_MAX.
+    //
+    NvU16 numThrottles;     // processors throttled
+    NvU16 numPinsLocal;     // pages pinned on the faulting processor
+    NvU16 numPinsRemote;    // pages pinned elsewhere and mapped remotely by
+                            // the faulting processor
     NvU64 address;          // virtual address of the memory region that is
                             // thrashing
     NvU64 size;             // size of the memory region that is thrashing
@@ -1497,6 +1504,25 @@ typedef struct UvmEventControlData_tag {
 // TODO: Bug 4465348: remove this after replacing old references.
 typedef UvmToolsEventControlData UvmToolsEventControlData_V1;
 
+//------------------------------------------------------------------------------
+// Replayable fault servicing latency histograms
+//
+// Each fault batch serviced by a GPU records the time spent in each of the
+// servicing phases below. Bucket i of a histogram counts the batches whose
+// phase took [2^i, 2^(i+1)) nanoseconds, except for bucket 0, which also counts
+// 0ns, and the last bucket, which also counts all longer latencies.
+//------------------------------------------------------------------------------
+typedef enum
+{
+    UvmFaultLatencyPhaseFetch      = 0,
+    UvmFaultLatencyPhasePreprocess = 1,
+    UvmFaultLatencyPhaseService    = 2,
+    UvmFaultLatencyPhaseReplay     = 3,
+    UvmFaultLatencyPhaseCount      = 4,
+} UvmFaultLatencyPhase;
+
+#define UVM_FAULT_LATENCY_HISTOGRAM_BUCKETS 32
+
 //------------------------------------------------------------------------------
 // UVM Tools forward types (handles) definitions
 //------------------------------------------------------------------------------
@@ -37,6 +37,7 @@
 #include "uvm_hal.h"
 #include "uvm_perf_thrashing.h"
 #include "uvm_perf_prefetch.h"
+#include "uvm_perf_read_mostly.h"
 #include "uvm_mem.h"
 #include "uvm_gpu_access_counters.h"
 #include "uvm_va_space_mm.h"
@@ -55,7 +56,7 @@ static NvU64 uvm_perf_authorized_cpu_fault_tracking_window_ns = 300000;
 static struct kmem_cache *g_uvm_va_block_cache __read_mostly;
 static struct kmem_cache *g_uvm_va_block_gpu_state_cache __read_mostly;
 static struct kmem_cache *g_uvm_page_mask_cache __read_mostly;
-static struct kmem_cache *g_uvm_va_block_context_cache __read_mostly;
+static uvm_object_cache_t *g_uvm_va_block_context_cache __read_mostly;
 static struct kmem_cache *g_uvm_va_block_cpu_node_state_cache __read_mostly;
 
 static int uvm_fault_force_sysmem __read_mostly = 0;
@@ -69,6 +70,25 @@ static int uvm_block_cpu_to_cpu_copy_with_ce __read_mostly = 0;
 module_param(uvm_block_cpu_to_cpu_copy_with_ce, int, S_IRUGO | S_IWUSR);
 MODULE_PARM_DESC(uvm_block_cpu_to_cpu_copy_with_ce, "Use GPU CEs for CPU-to-CPU migrations.");
 
+// When enabled, physical CPU chunks are DMA mapped on a GPU the first time the
+// GPU accesses them, i.e. when copying to or from them or mapping them on the
+// GPU, instead of on all the GPUs with state in the block as soon as they are
+// populated. See block_cpu_chunk_is_lazily_mapped().
+static int uvm_cpu_chunk_lazy_dma_map __read_mostly = 0;
+module_param(uvm_cpu_chunk_lazy_dma_map, int, S_IRUGO);
+MODULE_PARM_DESC(uvm_cpu_chunk_lazy_dma_map,
+                 "DMA map CPU chunks on each GPU on first access from the GPU rather than on population.");
+
+// GPU destination copies that have to be staged through CPU pages are done in
+// pieces of this size. The copy of each piece from the CPU to the destination
+// GPU only waits for the copies to the CPU of that piece and the ones before
+// it, so it can overlap with the staging of the next piece. 0 stages the whole
+// copy before copying any of it to the destination.
+static unsigned uvm_perf_staged_copy_chunk_kb __read_mostly = 512;
+module_param(uvm_perf_staged_copy_chunk_kb, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_perf_staged_copy_chunk_kb,
+                 "Size in KB of the pieces in which GPU copies staged through CPU memory are pipelined.");
+
 // Caching is always disabled for mappings to remote memory. The following two
 // module parameters can be used to force caching for GPU peer/sysmem mappings.
 //
@@ -86,7 +106,52 @@ MODULE_PARM_DESC(uvm_exp_gpu_cache_sysmem,
                  "Force caching for mappings to system memory. "
                  "This is an experimental parameter that may cause correctness issues if used.");
 
+// Keep per VA block activity counters of each processor, see
+// uvm_va_block_stats_t. Their cost is a few increments under the block lock on
+// each migration and fault.
+static unsigned uvm_perf_va_range_stats __read_mostly = 1;
+module_param(uvm_perf_va_range_stats, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_perf_va_range_stats,
+                 "Track per VA range migration, fault and thrashing statistics, reported in the va_spaces "
+                 "procfs directory.");
+
+// When enabled, killing the blocks of a managed VA range on munmap only tears
+// down their mappings and page tables, which is all that is needed for their VA
+// to be reused. Freeing their GPU chunks, the DMA mappings of their CPU chunks
+// and the CPU chunks themselves is left to a background reaper. See
+// uvm_va_block_kill_deferred().
+static unsigned uvm_va_block_deferred_destroy __read_mostly = 1;
+module_param(uvm_va_block_deferred_destroy, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_va_block_deferred_destroy,
+                 "Free the memory of the VA blocks of unmapped managed allocations in the background.");
+
+// CPU faults on managed memory also map the pages around the faulting one
+// that are only resident on the CPU but not mapped by it, within an aligned
+// window of this many pages. This saves a fault per page when the CPU walks
+// memory that was already migrated back, for example after eviction. 0 or 1
+// only map the faulting page.
+static unsigned uvm_perf_cpu_fault_around_pages __read_mostly = 16;
+module_param(uvm_perf_cpu_fault_around_pages, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_perf_cpu_fault_around_pages,
+                 "Number of pages around a CPU fault that are mapped if they are already resident on the CPU.");
+
+static struct
+{
+    // Protects list
+    uvm_spinlock_t lock;
+
+    // Blocks killed with uvm_va_block_kill_deferred() whose memory hasn't been
+    // freed yet. Each of them holds a reference on the block.
+    struct list_head list;
+
+    nv_kthread_q_t q;
+
+    // Queue item processing the list
+    nv_kthread_q_item_t q_item;
+} g_uvm_va_block_reaper;
+
 static void block_add_eviction_mappings_entry(void *args);
+static void block_reaper_process_entry(void *args);
 
 uvm_va_space_t *uvm_va_block_get_va_space_maybe_dead(uvm_va_block_t *va_block)
 {
@@ -889,6 +954,53 @@ static block_phys_page_t block_phys_page(uvm_processor_id_t processor, int nid,
     return (block_phys_page_t){ processor, page_index, nid };
 }
 
+static void block_context_free_tracking(uvm_make_resident_page_tracking_t *tracking)
+{
+    size_t index;
+
+    for (index = 0; index < num_possible_nodes(); index++) {
+        if (tracking->node_masks[index])
+            kmem_cache_free(g_uvm_page_mask_cache, tracking->node_masks[index]);
+    }
+
+    uvm_kvfree(tracking->node_masks);
+}
+
+static NV_STATUS block_context_alloc_tracking(uvm_make_resident_page_tracking_t *tracking)
+{
+    size_t index;
+
+    tracking->node_masks = uvm_kvmalloc_zero(num_possible_nodes() * sizeof(*tracking->node_masks));
+    if (!tracking->node_masks)
+        return NV_ERR_NO_MEMORY;
+
+    for (index = 0; index < num_possible_nodes(); index++) {
+        tracking->node_masks[index] = kmem_cache_alloc(g_uvm_page_mask_cache, NV_UVM_GFP_FLAGS);
+        if (!tracking->node_masks[index])
+            goto error;
+    }
+
+    return NV_OK;
+
+error:
+    block_context_free_tracking(tracking);
+    return NV_ERR_NO_MEMORY;
+}
+
+static NV_STATUS block_context_ctor(void *object)
+{
+    uvm_va_block_context_t *block_context = object;
+
+    return block_context_alloc_tracking(&block_context->make_resident.cpu_pages_used);
+}
+
+static void block_context_dtor(void *object)
+{
+    uvm_va_block_context_t *block_context = object;
+
+    block_context_free_tracking(&block_context->make_resident.cpu_pages_used);
+}
+
 NV_STATUS uvm_va_block_init(void)
 {
     if (uvm_enable_builtin_tests)
@@ -907,7 +1019,13 @@ NV_STATUS uvm_va_block_init(void)
     if (!g_uvm_page_mask_cache)
         return NV_ERR_NO_MEMORY;
 
-    g_uvm_va_block_context_cache = NV_KMEM_CACHE_CREATE("uvm_va_block_context_t", uvm_va_block_context_t);
+    // Block contexts are allocated and freed in most operations, so keep a
+    // few of them per CPU with the page tracking already allocated.
+    g_uvm_va_block_context_cache = UVM_OBJECT_CACHE_CREATE("uvm_va_block_context_t",
+                                                           uvm_va_block_context_t,
+                                                           4,
+                                                           block_context_ctor,
+                                                           block_context_dtor);
     if (!g_uvm_va_block_context_cache)
         return NV_ERR_NO_MEMORY;
 
@@ -916,65 +1034,33 @@ NV_STATUS uvm_va_block_init(void)
     if (!g_uvm_va_block_cpu_node_state_cache)
         return NV_ERR_NO_MEMORY;
 
-    return NV_OK;
+    uvm_spin_lock_init(&g_uvm_va_block_reaper.lock, UVM_LOCK_ORDER_LEAF);
+    INIT_LIST_HEAD(&g_uvm_va_block_reaper.list);
+    nv_kthread_q_item_init(&g_uvm_va_block_reaper.q_item, block_reaper_process_entry, NULL);
+
+    return errno_to_nv_status(nv_kthread_q_init(&g_uvm_va_block_reaper.q, "UVM VA block reaper"));
 }
 
 void uvm_va_block_exit(void)
 {
+    // All VA spaces are gone, and each of them reaps its blocks on destroy
+    UVM_ASSERT(list_empty(&g_uvm_va_block_reaper.list));
+    nv_kthread_q_stop(&g_uvm_va_block_reaper.q);
+
     kmem_cache_destroy_safe(&g_uvm_va_block_cpu_node_state_cache);
-    kmem_cache_destroy_safe(&g_uvm_va_block_context_cache);
+    uvm_object_cache_destroy_safe(&g_uvm_va_block_context_cache);
     kmem_cache_destroy_safe(&g_uvm_page_mask_cache);
     kmem_cache_destroy_safe(&g_uvm_va_block_gpu_state_cache);
     kmem_cache_destroy_safe(&g_uvm_va_block_cache);
 }
 
-static void block_context_free_tracking(uvm_make_resident_page_tracking_t *tracking)
-{
-    size_t index;
-
-    for (index = 0; index < num_possible_nodes(); index++) {
-        if (tracking->node_masks[index])
-            kmem_cache_free(g_uvm_page_mask_cache, tracking->node_masks[index]);
-    }
-
-    uvm_kvfree(tracking->node_masks);
-}
-
-static NV_STATUS block_context_alloc_tracking(uvm_make_resident_page_tracking_t *tracking)
-{
-    size_t index;
-
-    tracking->node_masks = uvm_kvmalloc_zero(num_possible_nodes() * sizeof(*tracking->node_masks));
-    if (!tracking->node_masks)
-        return NV_ERR_NO_MEMORY;
-
-    for (index = 0; index < num_possible_nodes(); index++) {
-        tracking->node_masks[index] = kmem_cache_alloc(g_uvm_page_mask_cache, NV_UVM_GFP_FLAGS);
-        if (!tracking->node_masks[index])
-            goto error;
-    }
-
-    return NV_OK;
-
-error:
-    block_context_free_tracking(tracking);
-    return NV_ERR_NO_MEMORY;
-}
-
 uvm_va_block_context_t *uvm_va_block_context_alloc(struct mm_struct *mm)
 {
-    uvm_va_block_context_t *block_context = kmem_cache_alloc(g_uvm_va_block_context_cache, NV_UVM_GFP_FLAGS);
-    NV_STATUS status;
+    uvm_va_block_context_t *block_context = uvm_object_cache_alloc(g_uvm_va_block_context_cache);
 
     if (!block_context)
         return NULL;
 
-    status = block_context_alloc_tracking(&block_context->make_resident.cpu_pages_used);
-    if (status != NV_OK) {
-        kmem_cache_free(g_uvm_va_block_context_cache, block_context);
-        return NULL;
-    }
-
     uvm_va_block_context_init(block_context, mm);
     return block_context;
 }
@@ -998,16 +1084,15 @@ void uvm_va_block_context_init(uvm_va_block_context_t *va_block_context, struct
     }
 
     va_block_context->mm = mm;
+    va_block_context->mapping.deferred_tlb_batches = NULL;
     va_block_context->make_resident.dest_nid = NUMA_NO_NODE;
+    va_block_context->make_resident.ce_stripe = 0;
     nodes_clear(va_block_context->make_resident.cpu_pages_used.nodes);
 }
 
 void uvm_va_block_context_free(uvm_va_block_context_t *va_block_context)
 {
-    if (va_block_context) {
-        block_context_free_tracking(&va_block_context->make_resident.cpu_pages_used);
-        kmem_cache_free(g_uvm_va_block_context_cache, va_block_context);
-    }
+    uvm_object_cache_free(g_uvm_va_block_context_cache, va_block_context);
 }
 
 // Convert from page_index to chunk_index. The goal is for each system page in
@@ -1234,6 +1319,8 @@ uvm_gpu_chunk_t *uvm_va_block_lookup_gpu_chunk(uvm_va_block_t *va_block, uvm_gpu
 
 static void uvm_va_block_free(uvm_va_block_t *block)
 {
+    uvm_kvfree(block->num_faults);
+
     if (uvm_enable_builtin_tests) {
         uvm_va_block_wrapper_t *block_wrapper = container_of(block, uvm_va_block_wrapper_t, block);
 
@@ -1369,6 +1456,54 @@ static NV_STATUS cpu_chunk_add_sysmem_gpu_mapping(uvm_cpu_chunk_t *chunk,
     return status;
 }
 
+// Whether the DMA mappings of the chunk are created on first access from each
+// GPU rather than on all the GPUs when the chunk is populated.
+//
+// Logical chunks are always mapped eagerly since uvm_cpu_chunk_merge()
+// requires all the chunks being merged to be mapped on the same set of GPUs.
+// To preserve that, lazily mapped chunks are mapped on all the GPUs before
+// being split, see block_split_cpu_chunk_one().
+static bool block_cpu_chunk_is_lazily_mapped(uvm_va_block_t *block, uvm_cpu_chunk_t *chunk)
+{
+    return uvm_cpu_chunk_lazy_dma_map && !uvm_va_block_is_hmm(block) && uvm_cpu_chunk_is_physical(chunk);
+}
+
+// Create the missing DMA mappings on the GPU of the lazily mapped CPU chunks
+// backing the region on the given NUMA node, or all nodes if nid is
+// NUMA_NO_NODE. This has to be called before the GPU accesses the pages.
+static NV_STATUS block_map_lazy_cpu_chunks_on_gpu(uvm_va_block_t *block,
+                                                  int nid,
+                                                  uvm_va_block_region_t region,
+                                                  uvm_gpu_t *gpu)
+{
+    uvm_cpu_chunk_t *chunk;
+    uvm_page_index_t page_index;
+    NV_STATUS status;
+    int chunk_nid;
+
+    uvm_assert_mutex_locked(&block->lock);
+    UVM_ASSERT(uvm_va_block_gpu_state_get(block, gpu->id));
+
+    if (!uvm_cpu_chunk_lazy_dma_map || g_uvm_global.conf_computing_enabled)
+        return NV_OK;
+
+    for_each_possible_uvm_node(chunk_nid) {
+        if (nid != NUMA_NO_NODE && chunk_nid != nid)
+            continue;
+
+        for_each_cpu_chunk_in_block_region(chunk, page_index, block, chunk_nid, region) {
+            if (!block_cpu_chunk_is_lazily_mapped(block, chunk) || uvm_cpu_chunk_get_gpu_phys_addr(chunk, gpu) != 0)
+                continue;
+
+            status = cpu_chunk_add_sysmem_gpu_mapping(chunk, block, page_index, gpu);
+            if (status != NV_OK)
+                return status;
+        }
+    }
+
+    return NV_OK;
+}
+
 static void block_gpu_unmap_phys_all_cpu_pages(uvm_va_block_t *block, uvm_gpu_t *gpu)
 {
     uvm_cpu_chunk_t *chunk;
@@ -1398,6 +1533,9 @@ static NV_STATUS block_gpu_map_phys_all_cpu_pages(uvm_va_block_t *block, uvm_gpu
                            uvm_id_value(gpu->id),
                            uvm_cpu_chunk_get_gpu_phys_addr(chunk, gpu));
 
+            if (block_cpu_chunk_is_lazily_mapped(block, chunk))
+                continue;
+
             status = cpu_chunk_add_sysmem_gpu_mapping(chunk, block, page_index, gpu);
             if (status != NV_OK)
                 goto error;
@@ -1411,6 +1549,16 @@ error:
     return status;
 }
 
+// Whether the policy of the block requests its memory on the GPU to be
+// protected from eviction. HMM VA blocks don't support reservations.
+static bool block_gpu_is_resident_reserved(uvm_va_block_t *block, uvm_gpu_t *gpu)
+{
+    if (uvm_va_block_is_hmm(block) || !block->va_range)
+        return false;
+
+    return uvm_id_equal(uvm_va_range_get_policy(block->va_range)->gpu_resident_reservation, gpu->id);
+}
+
 // Retrieves the gpu_state for the given GPU. The returned pointer is
 // internally managed and will be allocated (and freed) automatically,
 // rather than by the caller.
@@ -1418,18 +1566,27 @@ static uvm_va_block_gpu_state_t *block_gpu_state_get_alloc(uvm_va_block_t *block
 {
     NV_STATUS status;
     uvm_va_block_gpu_state_t *gpu_state = uvm_va_block_gpu_state_get(block, gpu->id);
+    int node = gpu->parent->closest_cpu_numa_node;
 
     if (gpu_state)
         return gpu_state;
 
-    gpu_state = nv_kmem_cache_zalloc(g_uvm_va_block_gpu_state_cache, NV_UVM_GFP_FLAGS);
+    // The GPU state is mostly accessed while servicing faults and access
+    // counter notifications from this GPU, so place it on the NUMA node
+    // closest to the GPU, where the bottom halves also run.
+    gpu_state = nv_kmem_cache_zalloc_node(g_uvm_va_block_gpu_state_cache, NV_UVM_GFP_FLAGS, node);
     if (!gpu_state)
         return NULL;
 
-    gpu_state->chunks = uvm_kvmalloc_zero(block_num_gpu_chunks(block, gpu) * sizeof(gpu_state->chunks[0]));
+    if (node != NUMA_NO_NODE && page_to_nid(virt_to_page(gpu_state)) != node)
+        atomic64_inc(&gpu->parent->stats.num_remote_node_va_block_states);
+
+    gpu_state->chunks = uvm_kvmalloc_zero_node(block_num_gpu_chunks(block, gpu) * sizeof(gpu_state->chunks[0]), node);
     if (!gpu_state->chunks)
         goto error;
 
+    gpu_state->resident_reserved = block_gpu_is_resident_reserved(block, gpu);
+
     block->gpus[uvm_id_gpu_index(gpu->id)] = gpu_state;
 
     status = block_gpu_map_phys_all_cpu_pages(block, gpu);
@@ -1481,12 +1638,30 @@ NV_STATUS uvm_va_block_map_cpu_chunk_on_gpus(uvm_va_block_t *block,
     uvm_gpu_id_t id;
     uvm_chunk_size_t chunk_size = uvm_cpu_chunk_get_size(chunk);
     uvm_va_block_region_t chunk_region = uvm_va_block_chunk_region(block, chunk_size, page_index);
+    NvU32 num_gpus = 0;
 
     // We can't iterate over va_space->registered_gpus because we might be
     // on the eviction path, which does not have the VA space lock held. We have
     // the VA block lock held however, so the gpu_states can't change.
     uvm_assert_mutex_locked(&block->lock);
 
+    if (g_uvm_global.conf_computing_enabled)
+        return NV_OK;
+
+    if (block_cpu_chunk_is_lazily_mapped(block, chunk))
+        return NV_OK;
+
+    // Size the chunk's DMA address array for all the GPUs at once instead of
+    // growing it as each GPU gets mapped.
+    for_each_gpu_id(id) {
+        if (uvm_va_block_gpu_state_get(block, id))
+            num_gpus++;
+    }
+
+    status = uvm_cpu_chunk_reserve_gpu_mappings(chunk, num_gpus);
+    if (status != NV_OK)
+        return status;
+
     for_each_gpu_id(id) {
         uvm_gpu_t *gpu;
 
@@ -3281,6 +3456,10 @@ typedef struct
     // Starting address of the physically-contiguous allocation, from the view
     // of the copying GPU. Valid only if is_block_contig.
     uvm_gpu_address_t gpu_address;
+
+    // Region of the physically-contiguous storage containing the last page of
+    // the current copy run. Valid only if the run is not empty.
+    uvm_va_block_region_t run_contig_region;
 } block_copy_addr_t;
 
 typedef struct
@@ -3291,6 +3470,13 @@ typedef struct
     // True if at least one CE transfer (such as a memcopy) has already been
     // pushed to the GPU during the VA block copy thus far.
     bool copy_pushed;
+
+    // CE stripe to push the copy in, see uvm_channel_reserve_ce_stripe()
+    NvU32 ce_stripe;
+
+    // Pages accumulated to be copied at once when the storage is not
+    // physically contiguous on both processors. See block_copy_run_add_page().
+    uvm_va_block_region_t run;
 } block_copy_state_t;
 
 // Begin a push appropriate for copying data from src_id processor to dst_id processor.
@@ -3355,15 +3541,17 @@ static NV_STATUS block_copy_begin_push(uvm_va_block_t *va_block,
 
     if (channel_type == UVM_CHANNEL_TYPE_GPU_TO_GPU) {
         uvm_gpu_t *dst_gpu = block_get_gpu(va_block, dst_id);
-        return uvm_push_begin_acquire_gpu_to_gpu(gpu->channel_manager,
-                                                 dst_gpu,
-                                                 tracker,
-                                                 push,
-                                                 "Copy from %s to %s for block [0x%llx, 0x%llx]",
-                                                 block_processor_name(va_block, src_id),
-                                                 block_processor_name(va_block, dst_id),
-                                                 va_block->start,
-                                                 va_block->end);
+        return uvm_push_begin_acquire_ce_stripe(gpu->channel_manager,
+                                                channel_type,
+                                                dst_gpu,
+                                                copy_state->ce_stripe,
+                                                tracker,
+                                                push,
+                                                "Copy from %s to %s for block [0x%llx, 0x%llx]",
+                                                block_processor_name(va_block, src_id),
+                                                block_processor_name(va_block, dst_id),
+                                                va_block->start,
+                                                va_block->end);
     }
 
     if (g_uvm_global.conf_computing_enabled) {
@@ -3396,15 +3584,17 @@ static NV_STATUS block_copy_begin_push(uvm_va_block_t *va_block,
         tracker_ptr = &local_tracker;
     }
 
-    status = uvm_push_begin_acquire(gpu->channel_manager,
-                                    channel_type,
-                                    tracker_ptr,
-                                    push,
-                                    "Copy from %s to %s for block [0x%llx, 0x%llx]",
-                                    block_processor_name(va_block, src_id),
-                                    block_processor_name(va_block, dst_id),
-                                    va_block->start,
-                                    va_block->end);
+    status = uvm_push_begin_acquire_ce_stripe(gpu->channel_manager,
+                                              channel_type,
+                                              NULL,
+                                              copy_state->ce_stripe,
+                                              tracker_ptr,
+                                              push,
+                                              "Copy from %s to %s for block [0x%llx, 0x%llx]",
+                                              block_processor_name(va_block, src_id),
+                                              block_processor_name(va_block, dst_id),
+                                              va_block->start,
+                                              va_block->end);
 
 error:
     // Caller is responsible for freeing the DMA buffer on error
@@ -3476,6 +3666,47 @@ static void block_mark_memory_used(uvm_va_block_t *block, uvm_processor_id_t id)
     }
 }
 
+// Mark the root chunks backing the pages in page_mask that are resident on the
+// given GPU as accessed, for use by the PMM eviction policy.
+static void block_mark_gpu_chunks_accessed(uvm_va_block_t *block, uvm_gpu_t *gpu, const uvm_page_mask_t *page_mask)
+{
+    uvm_va_block_gpu_state_t *gpu_state = uvm_va_block_gpu_state_get(block, gpu->id);
+    const uvm_page_mask_t *resident_mask;
+    uvm_page_index_t page_index;
+
+    if (!gpu_state || !uvm_parent_gpu_supports_eviction(gpu->parent))
+        return;
+
+    resident_mask = uvm_va_block_resident_mask_get(block, gpu->id, NUMA_NO_NODE);
+
+    for_each_va_block_page_in_mask(page_index, page_mask, block) {
+        uvm_chunk_size_t chunk_size;
+        uvm_gpu_chunk_t *chunk;
+
+        if (!uvm_page_mask_test(resident_mask, page_index))
+            continue;
+
+        chunk = gpu_state->chunks[block_gpu_chunk_index(block, gpu, page_index, &chunk_size)];
+        if (!chunk)
+            continue;
+
+        uvm_pmm_gpu_mark_root_chunk_accessed(&gpu->pmm, chunk);
+
+        // Skip the remaining pages backed by the same chunk
+        page_index = uvm_va_block_chunk_region(block, chunk_size, page_index).outer - 1;
+    }
+}
+
+void uvm_va_block_mark_gpu_chunks_accessed(uvm_va_block_t *va_block, const uvm_page_mask_t *page_mask)
+{
+    uvm_gpu_id_t gpu_id;
+
+    uvm_assert_mutex_locked(&va_block->lock);
+
+    for_each_gpu_id_in_mask(gpu_id, &va_block->resident)
+        block_mark_gpu_chunks_accessed(va_block, block_get_gpu(va_block, gpu_id), page_mask);
+}
+
 static void block_set_resident_processor(uvm_va_block_t *block, uvm_processor_id_t id)
 {
     UVM_ASSERT(!uvm_page_mask_empty(uvm_va_block_resident_mask_get(block, id, NUMA_NO_NODE)));
@@ -3577,6 +3808,22 @@ static uvm_gpu_address_t block_copy_get_address(uvm_va_block_t *block,
     return block_phys_page_copy_address(block, block_phys_page(bca->id, bca->nid, page_index), copying_gpu);
 }
 
+// Size of each encryption and decryption done for a copy of the given region
+// of a CPU chunk starting at page. kmap() only guarantees PAGE_SIZE contiguity,
+// so highmem pages are encrypted and decrypted one page at a time. Otherwise
+// the pages of the chunk are contiguous in the kernel linear mapping and the
+// whole region, which the callers guarantee is within one chunk, is done at
+// once. Besides saving a CSL call and a CE operation per page, this consumes
+// a single IV per region rather than one per page, which makes IV rotation of
+// the channel proportionally rarer during large migrations.
+static NvU32 conf_computing_copy_size(struct page *page, uvm_va_block_region_t region)
+{
+    if (PageHighMem(page))
+        return PAGE_SIZE;
+
+    return uvm_va_block_region_size(region);
+}
+
 // When the Confidential Computing feature is enabled, the function performs
 // CPU side page encryption and GPU side decryption to the CPR.
 // GPU operations respect the caller's membar previously set in the push.
@@ -3598,6 +3845,7 @@ static void conf_computing_block_copy_push_cpu_to_gpu(uvm_va_block_t *block,
     char *cpu_va_staging_buffer = (char *)uvm_mem_get_cpu_addr_kernel(dma_buffer->alloc) + (page_index * PAGE_SIZE);
     uvm_cpu_chunk_t *chunk;
     uvm_va_block_region_t chunk_region;
+    NvU32 copy_size;
 
     UVM_ASSERT(UVM_ID_IS_CPU(copy_state->src.id));
     UVM_ASSERT(UVM_ID_IS_GPU(copy_state->dst.id));
@@ -3617,15 +3865,14 @@ static void conf_computing_block_copy_push_cpu_to_gpu(uvm_va_block_t *block,
     src_page = uvm_cpu_chunk_get_cpu_page(block, chunk, page_index);
     staging_buffer.address += page_index * PAGE_SIZE;
     auth_tag_buffer.address += page_index * UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
+    copy_size = conf_computing_copy_size(src_page, region);
 
     if (uvm_push_get_and_reset_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE))
         push_membar_flag = UVM_PUSH_FLAG_NEXT_MEMBAR_NONE;
     else if (uvm_push_get_and_reset_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_GPU))
         push_membar_flag = UVM_PUSH_FLAG_NEXT_MEMBAR_GPU;
 
-    // kmap() only guarantees PAGE_SIZE contiguity, all encryption and
-    // decryption must happen on a PAGE_SIZE basis.
-    for_each_va_block_page_in_region(page_index, region) {
+    for (; page_index < region.outer; page_index += copy_size / PAGE_SIZE) {
         void *src_cpu_virt_addr;
 
         src_cpu_virt_addr = kmap(src_page);
@@ -3633,7 +3880,7 @@ static void conf_computing_block_copy_push_cpu_to_gpu(uvm_va_block_t *block,
                                        cpu_va_staging_buffer,
                                        src_cpu_virt_addr,
                                        NULL,
-                                       PAGE_SIZE,
+                                       copy_size,
                                        cpu_auth_tag_buffer);
         kunmap(src_page);
 
@@ -3642,19 +3889,19 @@ static void conf_computing_block_copy_push_cpu_to_gpu(uvm_va_block_t *block,
         if (page_index > region.first)
             uvm_push_set_flag(push, UVM_PUSH_FLAG_CE_NEXT_PIPELINED);
 
-        if (page_index < (region.outer - 1))
+        if (page_index + copy_size / PAGE_SIZE < region.outer)
             uvm_push_set_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE);
         else if (push_membar_flag != UVM_PUSH_FLAG_COUNT)
             uvm_push_set_flag(push, push_membar_flag);
 
-        gpu->parent->ce_hal->decrypt(push, dst_address, staging_buffer, PAGE_SIZE, auth_tag_buffer);
+        gpu->parent->ce_hal->decrypt(push, dst_address, staging_buffer, copy_size, auth_tag_buffer);
 
-        src_page++;
-        dst_address.address += PAGE_SIZE;
-        cpu_va_staging_buffer += PAGE_SIZE;
-        staging_buffer.address += PAGE_SIZE;
-        cpu_auth_tag_buffer += UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
-        auth_tag_buffer.address += UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
+        src_page += copy_size / PAGE_SIZE;
+        dst_address.address += copy_size;
+        cpu_va_staging_buffer += copy_size;
+        staging_buffer.address += copy_size;
+        cpu_auth_tag_buffer += (copy_size / PAGE_SIZE) * UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
+        auth_tag_buffer.address += (copy_size / PAGE_SIZE) * UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
     }
 }
 
@@ -3673,11 +3920,23 @@ static void conf_computing_block_copy_push_gpu_to_cpu(uvm_va_block_t *block,
     uvm_gpu_address_t staging_buffer = uvm_mem_gpu_address_virtual_kernel(dma_buffer->alloc, gpu);
     uvm_gpu_address_t auth_tag_buffer = uvm_mem_gpu_address_virtual_kernel(dma_buffer->auth_tag, gpu);
     uvm_gpu_address_t src_address = block_copy_get_address(block, &copy_state->src, page_index, gpu);
+    uvm_cpu_chunk_t *dst_chunk;
+    NvU32 copy_size;
 
     UVM_ASSERT(UVM_ID_IS_GPU(copy_state->src.id));
     UVM_ASSERT(UVM_ID_IS_CPU(copy_state->dst.id));
     UVM_ASSERT(g_uvm_global.conf_computing_enabled);
 
+    // The CPU decryption in conf_computing_copy_pages_finish() decides
+    // the size of each encryption done here.
+    dst_chunk = uvm_cpu_chunk_get_chunk_for_page(block, copy_state->dst.nid, page_index);
+    UVM_ASSERT(dst_chunk);
+    UVM_ASSERT(uvm_va_block_region_contains_region(uvm_va_block_chunk_region(block,
+                                                                             uvm_cpu_chunk_get_size(dst_chunk),
+                                                                             page_index),
+                                                   region));
+    copy_size = conf_computing_copy_size(uvm_cpu_chunk_get_cpu_page(block, dst_chunk, page_index), region);
+
     staging_buffer.address += page_index * PAGE_SIZE;
     auth_tag_buffer.address += page_index * UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
 
@@ -3686,27 +3945,25 @@ static void conf_computing_block_copy_push_gpu_to_cpu(uvm_va_block_t *block,
     else if (uvm_push_get_and_reset_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_GPU))
         push_membar_flag = UVM_PUSH_FLAG_NEXT_MEMBAR_GPU;
 
-    // Because we use kmap() for mapping pages for CPU side
-    // crypto-operations and it only guarantees PAGE_SIZE contiguity, all
-    // encryptions and decryptions must happen on a PAGE_SIZE basis.
-    for_each_va_block_page_in_region(page_index, region) {
+    for (; page_index < region.outer; page_index += copy_size / PAGE_SIZE) {
         uvm_conf_computing_log_gpu_encryption(push->channel, &dma_buffer->decrypt_iv[page_index]);
+        uvm_page_mask_set(&dma_buffer->encryption_start_page_mask, page_index);
 
         // All but the first encryption can be pipelined. The first encryption
         // uses the caller's pipelining settings.
         if (page_index > region.first)
             uvm_push_set_flag(push, UVM_PUSH_FLAG_CE_NEXT_PIPELINED);
 
-        if (page_index < (region.outer - 1))
+        if (page_index + copy_size / PAGE_SIZE < region.outer)
             uvm_push_set_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE);
         else if (push_membar_flag != UVM_PUSH_FLAG_COUNT)
             uvm_push_set_flag(push, push_membar_flag);
 
-        gpu->parent->ce_hal->encrypt(push, staging_buffer, src_address, PAGE_SIZE, auth_tag_buffer);
+        gpu->parent->ce_hal->encrypt(push, staging_buffer, src_address, copy_size, auth_tag_buffer);
 
-        src_address.address += PAGE_SIZE;
-        staging_buffer.address += PAGE_SIZE;
-        auth_tag_buffer.address += UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
+        src_address.address += copy_size;
+        staging_buffer.address += copy_size;
+        auth_tag_buffer.address += (copy_size / PAGE_SIZE) * UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
     }
 
     uvm_page_mask_region_fill(&dma_buffer->encrypted_page_mask, region);
@@ -3720,6 +3977,8 @@ static NV_STATUS conf_computing_copy_pages_finish(uvm_va_block_t *block,
     uvm_page_index_t page_index;
     uvm_conf_computing_dma_buffer_t *dma_buffer = copy_state->dma_buffer;
     uvm_page_mask_t *encrypted_page_mask = &dma_buffer->encrypted_page_mask;
+    uvm_page_mask_t *encryption_start_page_mask = &dma_buffer->encryption_start_page_mask;
+    uvm_va_block_region_t block_region = uvm_va_block_region_from_block(block);
     void *auth_tag_buffer_base = uvm_mem_get_cpu_addr_kernel(dma_buffer->auth_tag);
     void *staging_buffer_base = uvm_mem_get_cpu_addr_kernel(dma_buffer->alloc);
 
@@ -3734,9 +3993,8 @@ static NV_STATUS conf_computing_copy_pages_finish(uvm_va_block_t *block,
     if (status != NV_OK)
         return status;
 
-    // kmap() only guarantees PAGE_SIZE contiguity, all encryption and
-    // decryption must happen on a PAGE_SIZE basis.
-    for_each_va_block_page_in_mask(page_index, encrypted_page_mask, block) {
+    // Each encryption is decrypted at once, see conf_computing_copy_size().
+    for_each_va_block_page_in_mask(page_index, encryption_start_page_mask, block) {
         // All CPU chunks for the copy have already been allocated in
         // block_populate_pages() and copy_state has been filled in based on
         // those allocations.
@@ -3744,13 +4002,22 @@ static NV_STATUS conf_computing_copy_pages_finish(uvm_va_block_t *block,
         struct page *dst_page = uvm_cpu_chunk_get_cpu_page(block, cpu_chunk, page_index);
         void *staging_buffer = (char *)staging_buffer_base + (page_index * PAGE_SIZE);
         void *auth_tag_buffer = (char *)auth_tag_buffer_base + (page_index * UVM_CONF_COMPUTING_AUTH_TAG_SIZE);
-        void *cpu_page_address = kmap(dst_page);
+        uvm_page_index_t outer = min(uvm_va_block_next_page_in_mask(block_region,
+                                                                    encryption_start_page_mask,
+                                                                    page_index),
+                                     uvm_va_block_next_unset_page_in_mask(block_region,
+                                                                          encrypted_page_mask,
+                                                                          page_index));
+        void *cpu_page_address;
+
+        UVM_ASSERT(uvm_page_mask_test(encrypted_page_mask, page_index));
 
+        cpu_page_address = kmap(dst_page);
         status = uvm_conf_computing_cpu_decrypt(push->channel,
                                                 cpu_page_address,
                                                 staging_buffer,
                                                 &dma_buffer->decrypt_iv[page_index],
-                                                PAGE_SIZE,
+                                                (outer - page_index) * PAGE_SIZE,
                                                 auth_tag_buffer);
         kunmap(dst_page);
         if (status != NV_OK) {
@@ -3897,6 +4164,97 @@ static NV_STATUS block_copy_pages(uvm_va_block_t *va_block,
     return NV_OK;
 }
 
+// Check whether page_index, which directly follows the current copy run, can be
+// added to the run on the given side of the copy, that is whether its copy
+// address follows the one of the last page of the run.
+//
+// Copies done with memcpy() and the CPU side of Confidential Computing copies
+// require the whole region to be within a single CPU chunk, so runs can only
+// cross the chunks of GPUs, or CPU chunks mapped contiguously for the copying
+// GPU when the copy is a plain CE memcopy.
+static bool block_copy_run_extend_side(uvm_va_block_t *block,
+                                       block_copy_addr_t *bca,
+                                       uvm_page_index_t page_index,
+                                       uvm_gpu_t *copying_gpu)
+{
+    uvm_gpu_address_t next_address;
+    uvm_gpu_address_t page_address;
+
+    if (page_index < bca->run_contig_region.outer)
+        return true;
+
+    if (!copying_gpu || (UVM_ID_IS_CPU(bca->id) && g_uvm_global.conf_computing_enabled))
+        return false;
+
+    next_address = block_copy_get_address(block, bca, page_index - 1, copying_gpu);
+    next_address.address += PAGE_SIZE;
+    page_address = block_copy_get_address(block, bca, page_index, copying_gpu);
+    if (uvm_gpu_addr_cmp(page_address, next_address) != 0)
+        return false;
+
+    bca->run_contig_region = block_phys_contig_region(block, page_index, bca->id, bca->nid);
+
+    return true;
+}
+
+// Copy the pages of the current copy run, if any. The run is left untouched on
+// error so the caller can tell which pages were not copied.
+static NV_STATUS block_copy_run_flush(uvm_va_block_t *block, block_copy_state_t *copy_state, uvm_push_t *push)
+{
+    NV_STATUS status;
+
+    if (uvm_va_block_region_size(copy_state->run) == 0)
+        return NV_OK;
+
+    status = block_copy_pages(block, copy_state, copy_state->run, push);
+    if (status == NV_OK)
+        copy_state->run = uvm_va_block_region(0, 0);
+
+    return status;
+}
+
+// Add the given page to the pages to be copied when the storage is not
+// physically contiguous on both processors. Consecutive pages are accumulated
+// into a run as long as their copy addresses are contiguous on both sides, even
+// across chunks, and the run is then copied with a single block_copy_pages()
+// call instead of one per page. The pending run is copied first if the page
+// can't be added to it.
+//
+// copying_gpu is NULL if the copy doesn't use a push. The caller must call
+// block_copy_run_flush() after the last page.
+static NV_STATUS block_copy_run_add_page(uvm_va_block_t *block,
+                                         block_copy_state_t *copy_state,
+                                         uvm_page_index_t page_index,
+                                         uvm_gpu_t *copying_gpu,
+                                         uvm_push_t *push)
+{
+    NV_STATUS status;
+
+    if (uvm_va_block_region_size(copy_state->run) != 0 &&
+        page_index == copy_state->run.outer &&
+        block_copy_run_extend_side(block, &copy_state->src, page_index, copying_gpu) &&
+        block_copy_run_extend_side(block, &copy_state->dst, page_index, copying_gpu)) {
+        ++copy_state->run.outer;
+        return NV_OK;
+    }
+
+    status = block_copy_run_flush(block, copy_state, push);
+    if (status != NV_OK)
+        return status;
+
+    copy_state->run = uvm_va_block_region_for_page(page_index);
+    copy_state->src.run_contig_region = block_phys_contig_region(block,
+                                                                 page_index,
+                                                                 copy_state->src.id,
+                                                                 copy_state->src.nid);
+    copy_state->dst.run_contig_region = block_phys_contig_region(block,
+                                                                 page_index,
+                                                                 copy_state->dst.id,
+                                                                 copy_state->dst.nid);
+
+    return NV_OK;
+}
+
 // Copies pages resident on the src_id processor to the dst_id processor
 //
 // The function adds the pages that were successfully copied to the output
@@ -3947,10 +4305,7 @@ static NV_STATUS block_copy_resident_pages_between(uvm_va_block_t *block,
         UVM_ASSERT(dst_nid != NUMA_NO_NODE);
 
     // If there are no pages to be copied, exit early
-    if (!uvm_page_mask_andnot(copy_mask, copy_mask, dst_resident_mask))
-        return NV_OK;
-
-    if (migrated_pages && !uvm_page_mask_andnot(copy_mask, copy_mask, migrated_pages))
+    if (!uvm_page_mask_andnot_or(copy_mask, copy_mask, dst_resident_mask, migrated_pages))
         return NV_OK;
 
     copy_state.src.id = src_id;
@@ -3958,6 +4313,7 @@ static NV_STATUS block_copy_resident_pages_between(uvm_va_block_t *block,
     copy_state.src.nid = src_nid;
     copy_state.dst.nid = dst_nid;
 
+    copy_state.ce_stripe = block_context->make_resident.ce_stripe;
     copy_state.src.is_block_contig = is_block_phys_contig(block, src_id, copy_state.src.nid);
     copy_state.dst.is_block_contig = is_block_phys_contig(block, dst_id, copy_state.dst.nid);
 
@@ -4045,6 +4401,15 @@ static NV_STATUS block_copy_resident_pages_between(uvm_va_block_t *block,
                     }
                 }
 
+                if (UVM_ID_IS_CPU(src_id))
+                    status = block_map_lazy_cpu_chunks_on_gpu(block, src_nid, region, copying_gpu);
+
+                if (status == NV_OK && UVM_ID_IS_CPU(dst_id))
+                    status = block_map_lazy_cpu_chunks_on_gpu(block, dst_nid, region, copying_gpu);
+
+                if (status != NV_OK)
+                    break;
+
                 // Record the GPU involved in the copy
                 uvm_processor_mask_set(&block_context->make_resident.all_involved_processors, copying_gpu->id);
 
@@ -4141,14 +4506,22 @@ static NV_STATUS block_copy_resident_pages_between(uvm_va_block_t *block,
         }
 
         if (!copy_state.src.is_block_contig || !copy_state.dst.is_block_contig) {
-            status = block_copy_pages(block, &copy_state, uvm_va_block_region_for_page(page_index), &push);
+            status = block_copy_run_add_page(block, &copy_state, page_index, copying_gpu, &push);
             if (status != NV_OK)
-                return status;
+                break;
         }
 
         last_index = page_index;
     }
 
+    // Copy the last run of pages. The pages of a run which could not be copied
+    // failed as well.
+    if (status == NV_OK)
+        status = block_copy_run_flush(block, &copy_state, &push);
+
+    if (status != NV_OK && uvm_va_block_region_size(copy_state.run) != 0)
+        page_index = min(page_index, copy_state.run.first);
+
     // Copy the remaining pages
     contig_region = uvm_va_block_region(contig_start_index, last_index + 1);
     if (uvm_va_block_region_size(contig_region) && uvm_va_block_region_contains_region(region, contig_region)) {
@@ -4414,12 +4787,7 @@ static void block_copy_set_first_touch_residency(uvm_va_block_t *block,
     uvm_page_mask_t *resident_mask = uvm_va_block_resident_mask_get(block, dst_id, NUMA_NO_NODE);
     uvm_page_mask_t *first_touch_mask = &block_context->make_resident.page_mask;
 
-    if (page_mask)
-        uvm_page_mask_andnot(first_touch_mask, page_mask, resident_mask);
-    else
-        uvm_page_mask_complement(first_touch_mask, resident_mask);
-
-    uvm_page_mask_region_clear_outside(first_touch_mask, region);
+    uvm_page_mask_region_andnot_weight(first_touch_mask, region, page_mask, resident_mask);
 
     for_each_va_block_page_in_mask(page_index, first_touch_mask, block) {
         UVM_ASSERT(!block_is_page_resident_anywhere(block, page_index));
@@ -4476,6 +4844,120 @@ static void block_select_cpu_node_pages(uvm_va_block_t *block,
     }
 }
 
+// Copy the pages in block_context->make_resident.pages_staged from the
+// processors in src_processor_mask to the GPU dst_id, staging them through the
+// CPU pages selected by block_select_cpu_node_pages().
+//
+// The copy is done in pieces of uvm_perf_staged_copy_chunk_kb. The copies to
+// the CPU are added to the block's tracker, which is acquired by the copies
+// from the CPU to the destination, while the copies to the destination are only
+// added to copy_tracker. That way the staging of a piece doesn't wait for the
+// copy to the destination of the previous one, and the source and destination
+// GPUs work on consecutive pieces at the same time.
+static NV_STATUS block_copy_staged_pages(uvm_va_block_t *block,
+                                         uvm_va_block_context_t *block_context,
+                                         uvm_processor_id_t dst_id,
+                                         const uvm_processor_mask_t *src_processor_mask,
+                                         uvm_va_block_region_t region,
+                                         const uvm_page_mask_t *prefetch_page_mask,
+                                         uvm_va_block_transfer_mode_t transfer_mode,
+                                         NvU32 *missing_pages_count,
+                                         uvm_page_mask_t *migrated_pages,
+                                         uvm_tracker_t *copy_tracker)
+{
+    NV_STATUS status = NV_OK;
+    NV_STATUS tracker_status;
+    uvm_tracker_t staging_tracker = UVM_TRACKER_INIT();
+    uvm_page_mask_t *pages_staged = &block_context->make_resident.pages_staged;
+    uvm_page_mask_t *node_pages_mask = &block_context->make_resident.node_pages_mask;
+    size_t chunk_pages = ((size_t)uvm_perf_staged_copy_chunk_kb * 1024) / PAGE_SIZE;
+    uvm_va_block_region_t chunk_region;
+    uvm_page_index_t chunk_first;
+
+    UVM_ASSERT(UVM_ID_IS_GPU(dst_id));
+
+    if (chunk_pages == 0)
+        chunk_pages = uvm_va_block_region_num_pages(region);
+
+    for (chunk_first = region.first; chunk_first < region.outer; chunk_first = chunk_region.outer) {
+        NvU32 pages_copied_to_cpu = 0;
+        NvU32 pages_copied_from_cpu = 0;
+        int nid;
+
+        chunk_region = uvm_va_block_region(chunk_first,
+                                           min(region.outer, (uvm_page_index_t)(chunk_first + chunk_pages)));
+
+        if (uvm_page_mask_region_empty(pages_staged, chunk_region))
+            continue;
+
+        status = block_copy_resident_pages_mask(block,
+                                                block_context,
+                                                UVM_ID_CPU,
+                                                src_processor_mask,
+                                                chunk_region,
+                                                pages_staged,
+                                                prefetch_page_mask,
+                                                transfer_mode,
+                                                *missing_pages_count,
+                                                NULL,
+                                                &pages_copied_to_cpu,
+                                                &staging_tracker);
+        if (status != NV_OK)
+            break;
+
+        // Add the staging copies to the block's tracker so that the
+        // block_copy_resident_pages_between() calls below will acquire them.
+        status = uvm_tracker_add_tracker_safe(&block->tracker, &staging_tracker);
+        if (status != NV_OK)
+            break;
+        uvm_tracker_clear(&staging_tracker);
+
+        // Now copy staged pages from the CPU to the destination.
+        // The staging copy above could have allocated pages on any NUMA node.
+        // Loop over all nodes where pages were allocated and copy from those
+        // nodes.
+        for_each_node_mask(nid, block_context->make_resident.cpu_pages_used.nodes) {
+            NvU32 pages_copied_from_node;
+            uvm_page_mask_t *node_alloc_mask = block_tracking_node_mask_get(block_context, nid);
+
+            if (!uvm_page_mask_and(node_pages_mask, pages_staged, node_alloc_mask))
+                continue;
+
+            status = block_copy_resident_pages_between(block,
+                                                       block_context,
+                                                       dst_id,
+                                                       NUMA_NO_NODE,
+                                                       UVM_ID_CPU,
+                                                       nid,
+                                                       chunk_region,
+                                                       node_pages_mask,
+                                                       prefetch_page_mask,
+                                                       transfer_mode,
+                                                       migrated_pages,
+                                                       &pages_copied_from_node,
+                                                       copy_tracker);
+            UVM_ASSERT(*missing_pages_count >= pages_copied_from_node);
+            *missing_pages_count -= pages_copied_from_node;
+            pages_copied_from_cpu += pages_copied_from_node;
+
+            if (status != NV_OK)
+                break;
+        }
+
+        if (status != NV_OK)
+            break;
+
+        // We should copy as many pages from the CPU as we copied to the CPU.
+        UVM_ASSERT(pages_copied_from_cpu == pages_copied_to_cpu);
+    }
+
+    // On errors, the staging copies still need to be tracked by the block.
+    tracker_status = uvm_tracker_add_tracker_safe(&block->tracker, &staging_tracker);
+    uvm_tracker_deinit(&staging_tracker);
+
+    return status == NV_OK ? tracker_status : status;
+}
+
 // Copy resident pages from other processors to the destination.
 // All the pages on the destination need to be populated by the caller first.
 // Pages not resident anywhere else need to be zeroed out as well.
@@ -4504,7 +4986,6 @@ static NV_STATUS block_copy_resident_pages(uvm_va_block_t *block,
     uvm_page_mask_t *pages_staged = &block_context->make_resident.pages_staged;
     uvm_page_mask_t *cpu_page_mask;
     uvm_page_mask_t *numa_resident_pages;
-    int nid;
 
     uvm_page_mask_zero(migrated_pages);
 
@@ -4590,6 +5071,21 @@ static NV_STATUS block_copy_resident_pages(uvm_va_block_t *block,
     }
 
 
+    // For a GPU destination, the remaining pages are staged through the CPU.
+    if (UVM_ID_IS_GPU(dst_id)) {
+        status = block_copy_staged_pages(block,
+                                         block_context,
+                                         dst_id,
+                                         src_processor_mask,
+                                         region,
+                                         prefetch_page_mask,
+                                         transfer_mode,
+                                         &missing_pages_count,
+                                         migrated_pages,
+                                         &local_tracker);
+        goto out;
+    }
+
     if (!uvm_page_mask_empty(cpu_page_mask)) {
         status = block_copy_resident_pages_mask(block,
                                                 block_context,
@@ -4600,65 +5096,11 @@ static NV_STATUS block_copy_resident_pages(uvm_va_block_t *block,
                                                 prefetch_page_mask,
                                                 transfer_mode,
                                                 missing_pages_count,
-                                                UVM_ID_IS_CPU(dst_id) ? migrated_pages : NULL,
+                                                migrated_pages,
                                                 &pages_copied_to_cpu,
                                                 &local_tracker);
-
-        if (status != NV_OK)
-            goto out;
     }
 
-    // If destination is the CPU then we copied everything there above
-    if (!UVM_ID_IS_GPU(dst_id))
-        goto out;
-
-    // Add everything to the block's tracker so that the
-    // block_copy_resident_pages_between() call below will acquire it.
-    status = uvm_tracker_add_tracker_safe(&block->tracker, &local_tracker);
-    if (status != NV_OK)
-        goto out;
-    uvm_tracker_clear(&local_tracker);
-
-    // Now copy staged pages from the CPU to the destination.
-    // The staging copy above could have allocated pages on any NUMA node.
-    // Loop over all nodes where pages were allocated and copy from those
-    // nodes.
-    pages_copied = 0;
-    for_each_node_mask(nid, block_context->make_resident.cpu_pages_used.nodes) {
-        NvU32 pages_copied_from_node;
-        uvm_page_mask_t *node_pages_mask = &block_context->make_resident.node_pages_mask;
-        uvm_page_mask_t *node_alloc_mask = block_tracking_node_mask_get(block_context, nid);
-
-        if (uvm_page_mask_and(node_pages_mask, pages_staged, node_alloc_mask)) {
-            status = block_copy_resident_pages_between(block,
-                                                       block_context,
-                                                       dst_id,
-                                                       NUMA_NO_NODE,
-                                                       UVM_ID_CPU,
-                                                       nid,
-                                                       region,
-                                                       node_pages_mask,
-                                                       prefetch_page_mask,
-                                                       transfer_mode,
-                                                       migrated_pages,
-                                                       &pages_copied_from_node,
-                                                       &local_tracker);
-            UVM_ASSERT(missing_pages_count >= pages_copied_from_node);
-            missing_pages_count -= pages_copied_from_node;
-            pages_copied += pages_copied_from_node;
-        }
-
-        if (status != NV_OK)
-            break;
-    }
-
-    if (status != NV_OK)
-        goto out;
-
-    // If we get here, that means we were staging the copy through the CPU and
-    // we should copy as many pages from the CPU as we copied to the CPU.
-    UVM_ASSERT(pages_copied == pages_copied_to_cpu);
-
 out:
     // Add everything from the local tracker to the block's tracker.
     // Notably this is also needed for handling
@@ -4713,11 +5155,7 @@ NV_STATUS uvm_va_block_make_resident_copy(uvm_va_block_t *va_block,
     // are largely persistent.
     uvm_processor_mask_andnot(unmap_processor_mask, &va_block->mapped, block_get_uvm_lite_gpus(va_block));
 
-    if (page_mask)
-        uvm_page_mask_andnot(unmap_page_mask, page_mask, resident_mask);
-    else
-        uvm_page_mask_complement(unmap_page_mask, resident_mask);
-    uvm_page_mask_region_clear_outside(unmap_page_mask, region);
+    uvm_page_mask_region_andnot_weight(unmap_page_mask, region, page_mask, resident_mask);
 
     // Unmap all pages not resident on the destination
     status = uvm_va_block_unmap_mask(va_block, va_block_context, unmap_processor_mask, region, unmap_page_mask);
@@ -4767,9 +5205,19 @@ static void block_make_resident_clear_evicted(uvm_va_block_t *va_block,
                                               uvm_page_mask_t *page_mask)
 {
     uvm_va_block_gpu_state_t *dst_gpu_state = uvm_va_block_gpu_state_get(va_block, dst_id);
+    uvm_page_index_t page_index;
+    NvU64 num_refaulted_pages = 0;
 
     UVM_ASSERT(dst_gpu_state);
 
+    for_each_va_block_page_in_mask(page_index, page_mask, va_block) {
+        if (uvm_page_mask_test(&dst_gpu_state->evicted, page_index))
+            ++num_refaulted_pages;
+    }
+
+    if (num_refaulted_pages)
+        atomic64_add(num_refaulted_pages, &block_get_gpu(va_block, dst_id)->pmm.eviction_stats.num_refaulted_pages);
+
     if (!uvm_page_mask_andnot(&dst_gpu_state->evicted, &dst_gpu_state->evicted, page_mask))
         uvm_processor_mask_clear(&va_block->evicted_gpus, dst_id);
 }
@@ -4820,6 +5268,9 @@ static void block_make_resident_update_state(uvm_va_block_t *va_block,
 
             uvm_page_mask_or(&src_gpu_state->evicted, &src_gpu_state->evicted, copy_mask);
             uvm_processor_mask_set(&va_block->evicted_gpus, src_id);
+
+            atomic64_add(uvm_page_mask_weight(copy_mask),
+                         &block_get_gpu(va_block, src_id)->pmm.eviction_stats.num_evicted_pages);
         }
     }
     else if (UVM_ID_IS_GPU(dst_id) && uvm_processor_mask_test(&va_block->evicted_gpus, dst_id))
@@ -6991,6 +7442,23 @@ static void block_gpu_map_big_and_4k(uvm_va_block_t *block,
     bitmap_copy(gpu_state->big_ptes, new_pte_state->big_ptes, MAX_BIG_PAGES_PER_UVM_VA_BLOCK);
 }
 
+// Ends the TLB batch of an unmap which has no further PTE or PDE changes to
+// make, either by pushing the invalidates or by merging them into the
+// caller-provided deferred batch of the GPU.
+static void block_gpu_unmap_tlb_batch_end(uvm_va_block_context_t *block_context,
+                                          uvm_gpu_t *gpu,
+                                          uvm_push_t *push,
+                                          uvm_tlb_batch_t *tlb_batch,
+                                          uvm_membar_t tlb_membar)
+{
+    uvm_tlb_batch_t *deferred_tlb_batches = block_context->mapping.deferred_tlb_batches;
+
+    if (deferred_tlb_batches)
+        uvm_tlb_batch_merge(&deferred_tlb_batches[uvm_id_gpu_index(gpu->id)], tlb_batch, tlb_membar);
+    else
+        uvm_tlb_batch_end(tlb_batch, push, tlb_membar);
+}
+
 // Unmap all PTEs for {block, gpu}. If the 2M entry is currently a PDE, it is
 // merged into a PTE.
 static void block_gpu_unmap_to_2m(uvm_va_block_t *block,
@@ -7012,7 +7480,7 @@ static void block_gpu_unmap_to_2m(uvm_va_block_t *block,
         block_gpu_pte_clear_2m(block, gpu, pte_batch, tlb_batch);
 
         uvm_pte_batch_end(pte_batch);
-        uvm_tlb_batch_end(tlb_batch, push, tlb_membar);
+        block_gpu_unmap_tlb_batch_end(block_context, gpu, push, tlb_batch, tlb_membar);
     }
     else {
         // Otherwise we have a mix of big and 4K PTEs which need to be merged
@@ -7235,12 +7703,19 @@ static void block_gpu_unmap_big_and_4k(uvm_va_block_t *block,
                                         tlb_batch,
                                         tlb_membar);
     }
-    else {
+    else if (!bitmap_empty(big_ptes_split, MAX_BIG_PAGES_PER_UVM_VA_BLOCK) ||
+             block_gpu_needs_to_activate_table(block, gpu)) {
         // End the batches. We have to commit the membars and TLB invalidates
         // before we finish splitting formerly-big PTEs.
         uvm_pte_batch_end(pte_batch);
         uvm_tlb_batch_end(tlb_batch, push, tlb_membar);
     }
+    else {
+        // Nothing else to do after these PTE writes, so the invalidates can be
+        // deferred if the caller asked for it.
+        uvm_pte_batch_end(pte_batch);
+        block_gpu_unmap_tlb_batch_end(block_context, gpu, push, tlb_batch, tlb_membar);
+    }
 
     if (!bitmap_empty(big_ptes_split, MAX_BIG_PAGES_PER_UVM_VA_BLOCK) ||
         block_gpu_needs_to_activate_table(block, gpu)) {
@@ -8203,6 +8678,18 @@ static NV_STATUS block_map_gpu_to(uvm_va_block_t *va_block,
 
     UVM_ASSERT(block_check_mapping_residency(va_block, block_context, gpu, resident_id, pages_to_map));
 
+    if (UVM_ID_IS_GPU(resident_id)) {
+        block_mark_gpu_chunks_accessed(va_block, block_get_gpu(va_block, resident_id), pages_to_map);
+    }
+    else {
+        status = block_map_lazy_cpu_chunks_on_gpu(va_block,
+                                                  resident_nid,
+                                                  uvm_va_block_region_from_mask(va_block, pages_to_map),
+                                                  gpu);
+        if (status != NV_OK)
+            return status;
+    }
+
     // For PTE merge/split computation, compute all resident pages which will
     // have exactly new_prot after performing the mapping.
     uvm_page_mask_or(&block_context->scratch_page_mask, &gpu_state->pte_bits[prot_pte_bit], pages_to_map);
@@ -8876,7 +9363,11 @@ static void update_read_duplicated_pages_mask(uvm_va_block_t *block,
 // must take care of copying the data elsewhere if it needs to remain intact.
 //
 // This serializes on the block tracker since it must unmap page tables.
-static void block_destroy_gpu_state(uvm_va_block_t *block, uvm_va_block_context_t *block_context, uvm_gpu_id_t id)
+// Unmaps the PTEs and frees the page tables of the block on the given GPU. The
+// block must not be dead.
+static void block_destroy_gpu_page_tables(uvm_va_block_t *block,
+                                          uvm_va_block_context_t *block_context,
+                                          uvm_gpu_id_t id)
 {
     uvm_va_block_gpu_state_t *gpu_state = uvm_va_block_gpu_state_get(block, id);
     uvm_va_space_t *va_space = uvm_va_block_get_va_space(block);
@@ -8888,7 +9379,6 @@ static void block_destroy_gpu_state(uvm_va_block_t *block, uvm_va_block_context_
 
     uvm_assert_mutex_locked(&block->lock);
 
-    // Unmap PTEs and free page tables
     gpu = uvm_va_space_get_gpu(va_space, id);
     gpu_va_space = uvm_gpu_va_space_get(va_space, gpu);
     if (gpu_va_space)
@@ -8898,6 +9388,25 @@ static void block_destroy_gpu_state(uvm_va_block_t *block, uvm_va_block_context_
 
     // No processor should have this GPU mapped at this point
     UVM_ASSERT(block_check_processor_not_mapped(block, block_context, id));
+}
+
+// Frees the chunks and the state of the block on the given GPU, whose page
+// tables must already be gone. This doesn't need the VA space, so it can be
+// called on dead blocks. The GPU can't be unregistered while it has state in a
+// dead block, see uvm_va_block_reap_deferred().
+static void block_free_gpu_state(uvm_va_block_t *block, uvm_gpu_id_t id)
+{
+    uvm_va_block_gpu_state_t *gpu_state = uvm_va_block_gpu_state_get(block, id);
+    uvm_gpu_t *gpu;
+
+    if (!gpu_state)
+        return;
+
+    uvm_assert_mutex_locked(&block->lock);
+    UVM_ASSERT(!uvm_processor_mask_test(&block->mapped, id));
+
+    gpu = uvm_gpu_get(id);
+    UVM_ASSERT(gpu);
 
     if (gpu_state->chunks) {
         size_t i, num_chunks;
@@ -8933,6 +9442,12 @@ static void block_destroy_gpu_state(uvm_va_block_t *block, uvm_va_block_context_
     block->gpus[uvm_id_gpu_index(id)] = NULL;
 }
 
+static void block_destroy_gpu_state(uvm_va_block_t *block, uvm_va_block_context_t *block_context, uvm_gpu_id_t id)
+{
+    block_destroy_gpu_page_tables(block, block_context, id);
+    block_free_gpu_state(block, id);
+}
+
 static void block_put_ptes_safe(uvm_page_tree_t *tree, uvm_page_table_range_t *range)
 {
     if (range->table) {
@@ -9144,7 +9659,7 @@ static NV_STATUS block_evict_pages_from_gpu(uvm_va_block_t *va_block, uvm_gpu_t
     uvm_va_block_region_t subregion;
     uvm_service_block_context_t *service_context;
 
-    service_context = uvm_service_block_context_alloc(mm);
+    service_context = uvm_thread_context_service_context_get(mm);
     if (!service_context)
         return NV_ERR_NO_MEMORY;
 
@@ -9170,7 +9685,7 @@ static NV_STATUS block_evict_pages_from_gpu(uvm_va_block_t *va_block, uvm_gpu_t
     if (status == NV_OK)
         UVM_ASSERT(!uvm_processor_mask_test(&va_block->resident, gpu->id));
 
-    uvm_service_block_context_free(service_context);
+    uvm_thread_context_service_context_put(service_context);
 
     return status;
 }
@@ -9210,6 +9725,10 @@ void uvm_va_block_unregister_gpu_locked(uvm_va_block_t *va_block, uvm_gpu_t *gpu
     // better testing coverage of chunk synchronization on GPU unregister.
     block_destroy_gpu_state(va_block, va_block_context, gpu->id);
 
+    // The rest of the counters of the GPU were dropped with its state
+    if (va_block->num_faults)
+        va_block->num_faults[uvm_id_value(gpu->id)] = 0;
+
     // Any time a GPU is unregistered we need to make sure that there are no
     // pending (direct or indirect) tracker entries for that GPU left in the
     // block's tracker. The only way to ensure that is to wait for the whole
@@ -9219,6 +9738,108 @@ void uvm_va_block_unregister_gpu_locked(uvm_va_block_t *va_block, uvm_gpu_t *gpu
         UVM_ASSERT(status == uvm_global_get_status());
 }
 
+uvm_va_block_stats_t *uvm_va_block_stats_get(uvm_va_block_t *va_block, uvm_processor_id_t id)
+{
+    uvm_va_block_gpu_state_t *gpu_state;
+
+    uvm_assert_mutex_locked(&va_block->lock);
+
+    if (!uvm_perf_va_range_stats || uvm_va_block_is_hmm(va_block))
+        return NULL;
+
+    if (UVM_ID_IS_CPU(id))
+        return &va_block->cpu.stats;
+
+    gpu_state = uvm_va_block_gpu_state_get(va_block, id);
+
+    return gpu_state ? &gpu_state->stats : NULL;
+}
+
+static void stats_migration_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data)
+{
+    uvm_va_block_t *va_block = event_data->migration.block;
+    NvU64 bytes = event_data->migration.bytes;
+    uvm_va_block_stats_t *stats;
+
+    UVM_ASSERT(event_id == UVM_PERF_EVENT_MIGRATION);
+    uvm_assert_mutex_locked(&va_block->lock);
+
+    stats = uvm_va_block_stats_get(va_block, event_data->migration.dst);
+    if (stats)
+        stats->bytes_migrated_in += bytes;
+
+    stats = uvm_va_block_stats_get(va_block, event_data->migration.src);
+    if (stats) {
+        stats->bytes_migrated_out += bytes;
+        if (event_data->migration.cause == UVM_MAKE_RESIDENT_CAUSE_EVICTION)
+            stats->bytes_evicted += bytes;
+    }
+}
+
+static void stats_fault_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data)
+{
+    uvm_va_block_t *va_block = event_data->fault.block;
+    uvm_processor_id_t proc_id = event_data->fault.proc_id;
+
+    UVM_ASSERT(event_id == UVM_PERF_EVENT_FAULT);
+
+    // Faults outside of any block, for example fatal ones, are not reported
+    // per VA range
+    if (!va_block || uvm_va_block_is_hmm(va_block))
+        return;
+
+    uvm_assert_mutex_locked(&va_block->lock);
+
+    if (UVM_ID_IS_GPU(proc_id) && event_data->fault.gpu.is_duplicate)
+        return;
+
+    // The fault is not counted if the allocation fails
+    if (!va_block->num_faults) {
+        va_block->num_faults = uvm_kvmalloc_zero(UVM_ID_MAX_PROCESSORS * sizeof(*va_block->num_faults));
+        if (!va_block->num_faults)
+            return;
+    }
+
+    ++va_block->num_faults[uvm_id_value(proc_id)];
+}
+
+NV_STATUS uvm_va_block_stats_init_va_space(uvm_va_space_t *va_space)
+{
+    NV_STATUS status;
+
+    if (!uvm_perf_va_range_stats)
+        return NV_OK;
+
+    status = uvm_perf_register_event_callback(&va_space->perf_events, UVM_PERF_EVENT_FAULT, stats_fault_cb);
+    if (status != NV_OK)
+        return status;
+
+    return uvm_perf_register_event_callback(&va_space->perf_events, UVM_PERF_EVENT_MIGRATION, stats_migration_cb);
+}
+
+void uvm_va_block_update_gpu_resident_reservation(uvm_va_block_t *va_block, uvm_gpu_t *gpu)
+{
+    uvm_va_block_gpu_state_t *gpu_state;
+    bool reserved;
+    size_t i;
+
+    uvm_mutex_lock(&va_block->lock);
+
+    gpu_state = uvm_va_block_gpu_state_get(va_block, gpu->id);
+    reserved = block_gpu_is_resident_reserved(va_block, gpu);
+
+    if (gpu_state && gpu_state->resident_reserved != reserved) {
+        gpu_state->resident_reserved = reserved;
+
+        for (i = 0; i < block_num_gpu_chunks(va_block, gpu); i++) {
+            if (gpu_state->chunks[i])
+                uvm_pmm_gpu_update_root_chunk_reservation(&gpu->pmm, gpu_state->chunks[i]);
+        }
+    }
+
+    uvm_mutex_unlock(&va_block->lock);
+}
+
 void uvm_va_block_unregister_gpu(uvm_va_block_t *va_block, uvm_gpu_t *gpu, struct mm_struct *mm)
 {
     // Take the lock internally to not expose the caller to allocation-retry.
@@ -9243,26 +9864,19 @@ static void block_mark_region_cpu_dirty(uvm_va_block_t *va_block, uvm_va_block_r
     }
 }
 
-// Tears down everything within the block, but doesn't free the block itself.
-// Note that when uvm_va_block_kill is called, this is called twice: once for
-// the initial kill itself, then again when the block's ref count is eventually
-// destroyed. block->va_range is used to track whether the block has already
-// been killed.
-static void block_kill(uvm_va_block_t *block)
+// Tears down the mappings and page tables of a block that is being killed.
+// This is all that's needed for the VA covered by the block to be reused, the
+// memory of the block is freed separately by block_free_memory().
+static void block_kill_unmap(uvm_va_block_t *block)
 {
     uvm_va_space_t *va_space;
     uvm_perf_event_data_t event_data;
-    uvm_cpu_chunk_t *chunk;
     uvm_gpu_id_t id;
     NV_STATUS status;
     uvm_va_block_region_t region = uvm_va_block_region_from_block(block);
-    uvm_page_index_t page_index;
-    uvm_page_index_t next_page_index;
-    int nid;
     uvm_va_block_context_t *block_context;
 
-    if (uvm_va_block_is_dead(block))
-        return;
+    uvm_assert_mutex_locked(&block->lock);
 
     va_space = uvm_va_block_get_va_space(block);
     event_data.block_destroy.block = block;
@@ -9291,15 +9905,49 @@ static void block_kill(uvm_va_block_t *block)
 
     UVM_ASSERT(uvm_processor_mask_empty(&block->mapped));
 
-    // Free the GPU page tables and chunks
+    // Free the GPU page tables. The page tree code waits for the pending PTE
+    // writes before releasing them, so they can be reused for new mappings of
+    // this VA as soon as this returns.
+    for_each_gpu_id(id)
+        block_destroy_gpu_page_tables(block, block_context, id);
+
+    // No processor should have the CPU mapped at this point
+    UVM_ASSERT(block_check_processor_not_mapped(block, block_context, UVM_ID_CPU));
+}
+
+static void block_mark_dead(uvm_va_block_t *block)
+{
+    if (uvm_va_block_is_hmm(block))
+        uvm_va_policy_clear(block, block->start, block->end);
+
+    block->va_range = NULL;
+#if UVM_IS_CONFIG_HMM()
+    block->hmm.va_space = NULL;
+#endif
+}
+
+// Frees the GPU chunks, the CPU chunks and their DMA mappings, and the per
+// processor state of a block unmapped by block_kill_unmap(). This is a no-op if
+// the memory has already been freed.
+static void block_free_memory(uvm_va_block_t *block)
+{
+    uvm_cpu_chunk_t *chunk;
+    uvm_gpu_id_t id;
+    uvm_page_index_t page_index;
+    uvm_page_index_t next_page_index;
+    int nid;
+
+    uvm_assert_mutex_locked(&block->lock);
+
+    // Free the GPU chunks
     for_each_gpu_id(id)
-        block_destroy_gpu_state(block, block_context, id);
+        block_free_gpu_state(block, id);
 
     // Wait for the GPU PTE unmaps before freeing CPU memory
     uvm_tracker_wait_deinit(&block->tracker);
 
-    // No processor should have the CPU mapped at this point
-    UVM_ASSERT(block_check_processor_not_mapped(block, block_context, UVM_ID_CPU));
+    if (!block->cpu.node_state)
+        return;
 
     // Free CPU pages
     for_each_possible_uvm_node(nid) {
@@ -9339,14 +9987,24 @@ static void block_kill(uvm_va_block_t *block)
     // is getting destroyed, but it keeps state consistent for assertions.
     uvm_page_mask_zero(&block->cpu.resident);
     block_clear_resident_processor(block, UVM_ID_CPU);
+}
 
-    if (uvm_va_block_is_hmm(block))
-        uvm_va_policy_clear(block, block->start, block->end);
+// Tears down everything within the block, but doesn't free the block itself.
+// Note that when uvm_va_block_kill is called, this is called twice: once for
+// the initial kill itself, then again when the block's ref count is eventually
+// destroyed. block->va_range is used to track whether the block has already
+// been killed. Blocks killed by uvm_va_block_kill_deferred() are dead but may
+// still have their memory, which is then freed here.
+static void block_kill(uvm_va_block_t *block)
+{
+    if (uvm_va_block_is_dead(block)) {
+        block_free_memory(block);
+        return;
+    }
 
-    block->va_range = NULL;
-#if UVM_IS_CONFIG_HMM()
-    block->hmm.va_space = NULL;
-#endif
+    block_kill_unmap(block);
+    block_free_memory(block);
+    block_mark_dead(block);
 }
 
 // Called when the block's ref count drops to 0
@@ -9373,6 +10031,68 @@ void uvm_va_block_kill(uvm_va_block_t *va_block)
     uvm_va_block_release(va_block);
 }
 
+static void block_reaper_process(void *args)
+{
+    while (1) {
+        uvm_va_block_t *block;
+
+        uvm_spin_lock(&g_uvm_va_block_reaper.lock);
+        block = list_first_entry_or_null(&g_uvm_va_block_reaper.list, uvm_va_block_t, reaper_list_node);
+        if (block)
+            list_del(&block->reaper_list_node);
+        uvm_spin_unlock(&g_uvm_va_block_reaper.lock);
+
+        if (!block)
+            break;
+
+        uvm_mutex_lock(&block->lock);
+        block_free_memory(block);
+        uvm_mutex_unlock(&block->lock);
+
+        uvm_va_block_release(block);
+    }
+}
+
+static void block_reaper_process_entry(void *args)
+{
+    UVM_ENTRY_VOID(block_reaper_process(args));
+}
+
+void uvm_va_block_kill_deferred(uvm_va_block_t *va_block)
+{
+    UVM_ASSERT(!uvm_va_block_is_hmm(va_block));
+
+    if (!uvm_va_block_deferred_destroy) {
+        uvm_va_block_kill(va_block);
+        return;
+    }
+
+    uvm_mutex_lock(&va_block->lock);
+    if (!uvm_va_block_is_dead(va_block)) {
+        block_kill_unmap(va_block);
+        block_mark_dead(va_block);
+    }
+    uvm_mutex_unlock(&va_block->lock);
+
+    // The reaper takes over the reference the caller is dropping
+    uvm_spin_lock(&g_uvm_va_block_reaper.lock);
+    list_add_tail(&va_block->reaper_list_node, &g_uvm_va_block_reaper.list);
+    uvm_spin_unlock(&g_uvm_va_block_reaper.lock);
+
+    // The queue item may already be pending, in which case it picks up this
+    // block too.
+    nv_kthread_q_schedule_q_item(&g_uvm_va_block_reaper.q, &g_uvm_va_block_reaper.q_item);
+}
+
+void uvm_va_block_reap_deferred(void)
+{
+    // Free the pending blocks from this thread rather than waiting for the
+    // reaper to get to them, then wait for the one the reaper may be in the
+    // middle of freeing.
+    block_reaper_process(NULL);
+    nv_kthread_q_flush(&g_uvm_va_block_reaper.q);
+}
+
 static void block_gpu_release_region(uvm_va_block_t *va_block,
                                      uvm_gpu_id_t gpu_id,
                                      uvm_va_block_gpu_state_t *gpu_state,
@@ -9741,6 +10461,21 @@ static NV_STATUS block_split_cpu_chunk_one(uvm_va_block_t *block, uvm_page_index
     uvm_gpu_id_t id;
     NV_STATUS status;
 
+    // The chunks resulting from the split are always mapped eagerly, so map
+    // the chunk on all the GPUs first.
+    if (block_cpu_chunk_is_lazily_mapped(block, chunk)) {
+        uvm_va_block_region_t chunk_region = uvm_va_block_chunk_region(block, chunk_size, page_index);
+
+        for_each_gpu_id(id) {
+            if (!uvm_va_block_gpu_state_get(block, id))
+                continue;
+
+            status = block_map_lazy_cpu_chunks_on_gpu(block, nid, chunk_region, block_get_gpu(block, id));
+            if (status != NV_OK)
+                return status;
+        }
+    }
+
     gpu_split_mask = uvm_processor_mask_cache_alloc();
     if (!gpu_split_mask)
         return NV_ERR_NO_MEMORY;
@@ -10417,9 +11152,13 @@ static void block_split_gpu(uvm_va_block_t *existing, uvm_va_block_t *new, uvm_g
 
     for_each_possible_uvm_node(nid) {
         for_each_cpu_chunk_in_block(cpu_chunk, page_index, new, nid) {
-            uvm_pmm_sysmem_mappings_reparent_gpu_mapping(&gpu->pmm_reverse_sysmem_mappings,
-                                                         uvm_cpu_chunk_get_gpu_phys_addr(cpu_chunk, gpu),
-                                                         new);
+            NvU64 gpu_mapping_addr = uvm_cpu_chunk_get_gpu_phys_addr(cpu_chunk, gpu);
+
+            // Lazily mapped chunks may not be mapped on the GPU yet
+            if (gpu_mapping_addr == 0)
+                continue;
+
+            uvm_pmm_sysmem_mappings_reparent_gpu_mapping(&gpu->pmm_reverse_sysmem_mappings, gpu_mapping_addr, new);
         }
     }
 
@@ -11094,6 +11833,80 @@ uvm_prot_t uvm_va_block_page_compute_highest_permission(uvm_va_block_t *va_block
     }
 }
 
+NV_STATUS uvm_va_block_gpu_promote_2m(uvm_va_block_t *va_block,
+                                      uvm_va_block_context_t *va_block_context,
+                                      uvm_gpu_t *gpu,
+                                      bool *promoted)
+{
+    uvm_va_block_gpu_state_t *gpu_state = uvm_va_block_gpu_state_get(va_block, gpu->id);
+    uvm_page_mask_t *map_page_mask = &va_block_context->promote_2m.map_page_mask;
+    uvm_va_block_region_t region = uvm_va_block_region_from_block(va_block);
+    const uvm_page_mask_t *resident_mask;
+    uvm_page_index_t page_index;
+    uvm_pte_bits_gpu_t pte_bit;
+    uvm_prot_t new_prot;
+    NV_STATUS status;
+
+    uvm_assert_mutex_locked(&va_block->lock);
+
+    *promoted = false;
+
+    if (uvm_va_block_is_dead(va_block) || !gpu_state || gpu_state->pte_is_2m || gpu_state->force_4k_ptes)
+        return NV_OK;
+
+    if (!uvm_gpu_va_space_get(uvm_va_block_get_va_space(va_block), gpu) || !block_gpu_supports_2m(va_block, gpu))
+        return NV_OK;
+
+    // A single 2M PTE can only be used if the whole block is backed by one
+    // physically-contiguous chunk in the GPU's memory
+    resident_mask = uvm_va_block_resident_mask_get(va_block, gpu->id, NUMA_NO_NODE);
+    if (!resident_mask || !uvm_page_mask_full(resident_mask) || !is_block_phys_contig(va_block, gpu->id, NUMA_NO_NODE))
+        return NV_OK;
+
+    // Use the highest protection currently mapped in the block. Blocks that
+    // are not mapped at all are left alone.
+    for (pte_bit = UVM_PTE_BITS_GPU_ATOMIC; ; --pte_bit) {
+        if (!uvm_page_mask_empty(&gpu_state->pte_bits[pte_bit]))
+            break;
+
+        if (pte_bit == UVM_PTE_BITS_GPU_READ)
+            return NV_OK;
+    }
+
+    if (pte_bit == UVM_PTE_BITS_GPU_ATOMIC)
+        new_prot = UVM_PROT_READ_WRITE_ATOMIC;
+    else if (pte_bit == UVM_PTE_BITS_GPU_WRITE)
+        new_prot = UVM_PROT_READ_WRITE;
+    else
+        new_prot = UVM_PROT_READ_ONLY;
+
+    // Map or upgrade the rest of the pages, as long as that doesn't require
+    // revoking permissions on other processors
+    uvm_page_mask_complement(map_page_mask, &gpu_state->pte_bits[pte_bit]);
+    if (uvm_page_mask_empty(map_page_mask))
+        return NV_OK;
+
+    for_each_va_block_page_in_mask(page_index, map_page_mask, va_block) {
+        if (uvm_va_block_page_compute_highest_permission(va_block, va_block_context, gpu->id, page_index) < new_prot)
+            return NV_OK;
+    }
+
+    status = uvm_va_block_map(va_block,
+                              va_block_context,
+                              gpu->id,
+                              region,
+                              map_page_mask,
+                              new_prot,
+                              UvmEventMapRemoteCauseInvalid,
+                              &va_block->tracker);
+    if (status != NV_OK)
+        return status;
+
+    *promoted = gpu_state->pte_is_2m;
+
+    return NV_OK;
+}
+
 NV_STATUS uvm_va_block_add_mappings(uvm_va_block_t *va_block,
                                     uvm_va_block_context_t *va_block_context,
                                     uvm_processor_id_t processor_id,
@@ -11183,6 +11996,14 @@ static bool can_read_duplicate(uvm_va_block_t *va_block,
         thrashing_hint->type != UVM_PERF_THRASHING_HINT_TYPE_PIN)
         return true;
 
+    // Blocks detected as read-mostly are read-duplicated as if the policy was
+    // enabled, unless the user explicitly set it.
+    if (policy->read_duplication == UVM_READ_DUPLICATION_UNSET &&
+        thrashing_hint->type != UVM_PERF_THRASHING_HINT_TYPE_PIN &&
+        uvm_perf_read_mostly_block_is_read_mostly(va_block) &&
+        uvm_va_space_can_read_duplicate(uvm_va_block_get_va_space(va_block), NULL))
+        return true;
+
     return false;
 }
 
@@ -11520,6 +12341,24 @@ static void uvm_va_block_get_prefetch_hint(uvm_va_block_t *va_block,
                                             &service_context->prefetch_bitmap_tree,
                                             &service_context->prefetch_hint);
 
+        // Speculative migrations to the faulting GPU can be deferred to its
+        // prefetch queue so that they don't delay the replay of the batch.
+        // The deferred pages are not mapped until they are accessed.
+        if (UVM_ID_IS_VALID(service_context->prefetch_hint.residency) &&
+            service_context->operation == UVM_SERVICE_OPERATION_REPLAYABLE_FAULTS &&
+            UVM_ID_IS_GPU(service_context->prefetch_hint.residency) &&
+            policy->read_duplication == UVM_READ_DUPLICATION_DISABLED) {
+            uvm_gpu_t *gpu = uvm_va_space_get_gpu(va_space, service_context->prefetch_hint.residency);
+
+            if (uvm_perf_prefetch_queue_post(&gpu->parent->fault_buffer_info.replayable.prefetch_queue,
+                                             va_block,
+                                             service_context->prefetch_hint.residency,
+                                             &service_context->prefetch_hint.prefetch_pages_mask)) {
+                uvm_page_mask_zero(&service_context->prefetch_hint.prefetch_pages_mask);
+                service_context->prefetch_hint.residency = UVM_ID_INVALID;
+            }
+        }
+
         // Obtain the prefetch hint and give a fake fault access type to the
         // prefetched pages
         if (UVM_ID_IS_VALID(service_context->prefetch_hint.residency)) {
@@ -12055,6 +12894,60 @@ NV_STATUS uvm_va_block_check_logical_permissions(uvm_va_block_t *va_block,
     return NV_OK;
 }
 
+// Add the pages in the fault-around window of page_index that are only
+// resident on the CPU and not mapped by it to the CPU fault being serviced,
+// as read accesses. They don't need to migrate, so this only adds CPU
+// mappings. The service region is grown to cover them.
+static void block_cpu_fault_around(uvm_va_block_t *va_block,
+                                   uvm_page_index_t page_index,
+                                   uvm_service_block_context_t *service_context)
+{
+    uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
+    uvm_va_block_context_t *block_context = service_context->block_context;
+    uvm_page_mask_t *new_residency_mask = &service_context->per_processor_masks[uvm_id_value(UVM_ID_CPU)].new_residency;
+    const uvm_page_mask_t *cpu_resident_mask = uvm_va_block_resident_mask_get(va_block, UVM_ID_CPU, NUMA_NO_NODE);
+    uvm_va_block_region_t window;
+    uvm_page_index_t i;
+
+    if (uvm_perf_cpu_fault_around_pages <= 1)
+        return;
+
+    window.first = page_index - (page_index % uvm_perf_cpu_fault_around_pages);
+    window.outer = min_t(size_t,
+                         (size_t)window.first + uvm_perf_cpu_fault_around_pages,
+                         uvm_va_block_num_cpu_pages(va_block));
+
+    for_each_va_block_page_in_region(i, window) {
+        NvU64 address;
+
+        if (i == page_index || !uvm_page_mask_test(cpu_resident_mask, i))
+            continue;
+
+        if (uvm_va_block_page_resident_processors_count(va_block, block_context, i) != 1)
+            continue;
+
+        if (block_page_is_processor_authorized(va_block, i, UVM_ID_CPU, UVM_PROT_READ_ONLY))
+            continue;
+
+        if (compute_logical_prot(va_block, block_context->hmm.vma, i) < UVM_PROT_READ_ONLY)
+            continue;
+
+        address = uvm_va_block_cpu_page_address(va_block, i);
+        if (uvm_va_block_check_logical_permissions(va_block,
+                                                   block_context,
+                                                   UVM_ID_CPU,
+                                                   i,
+                                                   UVM_FAULT_ACCESS_TYPE_READ,
+                                                   uvm_range_group_address_migratable(va_space, address)) != NV_OK)
+            continue;
+
+        uvm_page_mask_set(new_residency_mask, i);
+        service_context->access_type[i] = UVM_FAULT_ACCESS_TYPE_READ;
+        service_context->region.first = min_t(uvm_page_index_t, service_context->region.first, i);
+        service_context->region.outer = max_t(uvm_page_index_t, service_context->region.outer, i + 1);
+    }
+}
+
 // Check if we are faulting on a page with valid permissions to check if we can
 // skip fault handling. See uvm_va_block_t::cpu::fault_authorized for more
 // details
@@ -12202,6 +13095,12 @@ static NV_STATUS block_cpu_fault_locked(uvm_va_block_t *va_block,
 
     service_context->region = uvm_va_block_region_for_page(page_index);
 
+    if (UVM_ID_IS_CPU(new_residency) &&
+        !read_duplicate &&
+        thrashing_hint.type == UVM_PERF_THRASHING_HINT_TYPE_NONE &&
+        !uvm_va_block_is_hmm(va_block))
+        block_cpu_fault_around(va_block, page_index, service_context);
+
     status = uvm_va_block_service_locked(UVM_ID_CPU, va_block, va_block_retry, service_context);
     UVM_ASSERT(status != NV_WARN_MISMATCHED_TARGET);
 
@@ -12656,7 +13555,7 @@ static void block_add_eviction_mappings(void *args)
 
     mm = uvm_va_space_mm_retain_lock(va_space);
 
-    block_context = uvm_va_block_context_alloc(mm);
+    block_context = uvm_thread_context_block_context_get(mm);
     if (!block_context)
         goto done;
 
@@ -12729,7 +13628,7 @@ static void block_add_eviction_mappings(void *args)
 
 unlock:
     uvm_va_space_up_read(va_space);
-    uvm_va_block_context_free(block_context);
+    uvm_thread_context_block_context_put(block_context);
 
 done:
     uvm_va_space_mm_release_unlock(va_space, mm);
@@ -12762,9 +13661,13 @@ NV_STATUS uvm_va_block_evict_chunks(uvm_va_block_t *va_block,
 
     uvm_assert_mutex_locked(&va_block->lock);
 
-    // The block might have been killed in the meantime
-    if (!va_space)
+    // The block might have been killed in the meantime. If its memory was left
+    // to the reaper, free it now so the chunks are released to the eviction
+    // in progress.
+    if (!va_space) {
+        block_free_memory(va_block);
         return NV_OK;
+    }
 
     gpu_state = uvm_va_block_gpu_state_get(va_block, gpu->id);
     if (!gpu_state)
@@ -12781,7 +13684,7 @@ NV_STATUS uvm_va_block_evict_chunks(uvm_va_block_t *va_block,
     // block_add_eviction_mappings() will be scheduled below.
     mm = uvm_va_space_mm_retain(va_space);
 
-    service_context = uvm_service_block_context_alloc(mm);
+    service_context = uvm_thread_context_service_context_get(mm);
     if (!service_context) {
         if (mm)
             uvm_va_space_mm_release(va_space);
@@ -12904,7 +13807,7 @@ NV_STATUS uvm_va_block_evict_chunks(uvm_va_block_t *va_block,
     }
 
 out:
-    uvm_service_block_context_free(service_context);
+    uvm_thread_context_service_context_put(service_context);
 
     if (mm)
         uvm_va_space_mm_release(va_space);
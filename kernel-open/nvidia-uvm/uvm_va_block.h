@@ -98,6 +98,24 @@ typedef enum
     UVM_PTE_BITS_GPU_MAX
 } uvm_pte_bits_gpu_t;
 
+// Cumulative counters of the activity of a processor on a VA block, reported
+// per VA range by uvm_va_range_get_stats(). They are protected by the block
+// lock, which is already held by the code paths updating them, so they need no
+// atomics nor per-CPU copies.
+typedef struct
+{
+    // Bytes copied or moved to and from the processor
+    NvU64 bytes_migrated_in;
+    NvU64 bytes_migrated_out;
+
+    // Subset of bytes_migrated_out due to eviction of the processor's memory
+    NvU64 bytes_evicted;
+
+    // Thrashing events detected on pages of the block accessed by the
+    // processor
+    NvU64 thrashing_events;
+} uvm_va_block_stats_t;
+
 typedef struct
 {
     // Per-page residency bit vector, used for fast traversal
@@ -163,6 +181,19 @@ typedef struct
     // could lead to wrong fault attribution.
     bool force_4k_ptes;
 
+    // Whether the memory of the block on this GPU is protected from eviction by
+    // a GPU resident reservation of the VA range, see
+    // UVM_SET_GPU_RESIDENT_RESERVATION. PMM never evicts the root chunks
+    // holding any chunk of such a block.
+    //
+    // Protected by the block lock. PMM reads it with its list lock held while
+    // the block owns an allocated chunk.
+    bool resident_reserved;
+
+    // Activity counters of this GPU on the block. They are dropped along with
+    // the rest of the state when the GPU is unregistered.
+    uvm_va_block_stats_t stats;
+
     // This table shows the HW PTE states given all permutations of pte_is_2m,
     // big_ptes, and pte_bits. Note that the first row assumes that the 4k page
     // tables have been allocated (if not, then no PDEs are allocated either).
@@ -428,8 +459,19 @@ struct uvm_va_block_struct
             // Index of the page whose faults are being tracked
             uvm_page_index_t  page_index;
         } fault_authorized;
+
+        // Activity counters of the CPU on the block, for all NUMA nodes
+        uvm_va_block_stats_t stats;
     } cpu;
 
+    // Number of faults reported by each processor on the block, duplicates
+    // excluded, indexed by uvm_id_value(). They are kept out of the per-GPU
+    // state because the first faults of a GPU on the block are reported
+    // before that state is allocated. The array is allocated on the first
+    // fault on the block, so blocks that never fault, or all blocks when the
+    // counters are disabled, don't pay for it. Protected by the block lock.
+    NvU32 *num_faults;
+
     // Per-GPU residency and mapping state
     //
     // TODO: Bug 1766180: Even though these are pointers, making this a static
@@ -469,6 +511,10 @@ struct uvm_va_block_struct
     // A queue item for establishing eviction mappings in a deferred way
     nv_kthread_q_item_t eviction_mappings_q_item;
 
+    // Node in the list of dead blocks waiting for their memory to be freed. See
+    // uvm_va_block_kill_deferred(). Protected by the reaper lock.
+    struct list_head reaper_list_node;
+
     uvm_perf_module_data_desc_t perf_modules_data[UVM_PERF_MODULE_TYPE_COUNT];
 
     // Prefetch infomation that is updated while holding the va_block lock but
@@ -1170,6 +1216,27 @@ void uvm_va_block_disable_peer(uvm_va_block_t *va_block, uvm_gpu_t *gpu0, uvm_gp
 // LOCKING: The caller must hold the va_block lock
 void uvm_va_block_unmap_preferred_location_uvm_lite(uvm_va_block_t *va_block, uvm_gpu_t *gpu);
 
+// Update the GPU resident reservation of the block on the given GPU from the
+// policy of its VA range, and whether the root chunks holding its memory on
+// that GPU can be evicted.
+//
+// LOCKING: This takes and releases the VA block lock.
+void uvm_va_block_update_gpu_resident_reservation(uvm_va_block_t *va_block, uvm_gpu_t *gpu);
+
+// Register the callbacks which update the activity counters of the VA blocks
+// of the VA space, unless disabled with the uvm_perf_va_range_stats module
+// parameter.
+//
+// LOCKING: The VA space lock must be held in write mode.
+NV_STATUS uvm_va_block_stats_init_va_space(uvm_va_space_t *va_space);
+
+// Activity counters of the given processor on the block, or NULL if the block
+// was never accessed by that processor, if it is an HMM block, for which there
+// is no VA range to report them against, or if the counters are disabled.
+//
+// LOCKING: The caller must hold the VA block lock.
+uvm_va_block_stats_t *uvm_va_block_stats_get(uvm_va_block_t *va_block, uvm_processor_id_t id);
+
 // Frees all memory under this block associated with this GPU. Any portion of
 // the block which is resident on the GPU is evicted to sysmem before being
 // freed.
@@ -1206,6 +1273,23 @@ void uvm_va_block_unregister_gpu_locked(uvm_va_block_t *va_block, uvm_gpu_t *gpu
 // This performs a uvm_va_block_release.
 void uvm_va_block_kill(uvm_va_block_t *va_block);
 
+// Same as uvm_va_block_kill(), except that only the mappings and page tables of
+// the block are torn down before returning, which is enough for its VA to be
+// reused. Its GPU and CPU memory is freed later by a background reaper, unless
+// the uvm_va_block_deferred_destroy module parameter is 0. The eviction path
+// frees it right away if it runs into the block in the meantime.
+//
+// The block must be a managed block. Locking is the same as for
+// uvm_va_block_kill().
+void uvm_va_block_kill_deferred(uvm_va_block_t *va_block);
+
+// Frees the memory of all the blocks killed by uvm_va_block_kill_deferred() so
+// far. This must be called before a GPU is unregistered from a VA space, so
+// that no dead block still has state on it, and when a VA space is destroyed.
+//
+// LOCKING: No VA block lock may be held.
+void uvm_va_block_reap_deferred(void);
+
 // Exactly the same split semantics as uvm_va_range_split, including error
 // handling. See that function's comments for details.
 //
@@ -1425,6 +1509,13 @@ void uvm_va_block_unmapped_pages_get(uvm_va_block_t *va_block,
                                      uvm_va_block_region_t region,
                                      uvm_page_mask_t *out_mask);
 
+// Mark the GPU memory chunks backing the pages in page_mask as accessed, for
+// use by the PMM eviction policy. Only chunks of GPUs the pages are resident on
+// are marked.
+//
+// LOCKING: The caller must hold the va_block lock.
+void uvm_va_block_mark_gpu_chunks_accessed(uvm_va_block_t *va_block, const uvm_page_mask_t *page_mask);
+
 // VA block lookup functions. There are a number of permutations which might be
 // useful, such as looking up the block from {va_space, va_range} x {addr,
 // block index}. The ones implemented here and in uvm_va_range.h support the
@@ -1748,14 +1839,66 @@ static bool uvm_page_mask_region_test(const uvm_page_mask_t *mask,
     return !mask || uvm_page_mask_test(mask, page_index);
 }
 
+// The region helpers below work directly on the words of the mask covered by
+// the region, masking the partial words at both ends, so that a single pass is
+// made over the mask regardless of the number of operands.
+static unsigned long uvm_page_mask_region_word_mask(uvm_va_block_region_t region, size_t word_index)
+{
+    unsigned long word_mask = ~0UL;
+
+    if (word_index == BIT_WORD(region.first))
+        word_mask &= BITMAP_FIRST_WORD_MASK(region.first);
+
+    if (word_index == BIT_WORD(region.outer - 1))
+        word_mask &= BITMAP_LAST_WORD_MASK(region.outer);
+
+    return word_mask;
+}
+
 static NvU32 uvm_page_mask_region_weight(const uvm_page_mask_t *mask, uvm_va_block_region_t region)
 {
-    NvU32 weight_before = 0;
+    NvU32 weight = 0;
+    size_t i;
 
-    if (region.first > 0)
-        weight_before = bitmap_weight(mask->bitmap, region.first);
+    if (region.first >= region.outer)
+        return 0;
+
+    for (i = BIT_WORD(region.first); i <= BIT_WORD(region.outer - 1); i++)
+        weight += hweight_long(mask->bitmap[i] & uvm_page_mask_region_word_mask(region, i));
 
-    return bitmap_weight(mask->bitmap, region.outer) - weight_before;
+    return weight;
+}
+
+// mask_out = mask_in & ~mask_not, restricted to the pages in region. All pages
+// outside region are cleared in mask_out. If mask_in is NULL, all the pages in
+// the region are considered set. mask_out can alias any of the inputs.
+//
+// This is equivalent to uvm_page_mask_andnot() or uvm_page_mask_complement(),
+// followed by uvm_page_mask_region_clear_outside() and
+// uvm_page_mask_region_weight(), but it is computed in a single pass.
+//
+// Returns the number of pages set in mask_out.
+static NvU32 uvm_page_mask_region_andnot_weight(uvm_page_mask_t *mask_out,
+                                                uvm_va_block_region_t region,
+                                                const uvm_page_mask_t *mask_in,
+                                                const uvm_page_mask_t *mask_not)
+{
+    NvU32 weight = 0;
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(mask_out->bitmap); i++) {
+        unsigned long word = 0;
+
+        if (region.first < region.outer && i >= BIT_WORD(region.first) && i <= BIT_WORD(region.outer - 1)) {
+            word = mask_in ? mask_in->bitmap[i] : ~0UL;
+            word &= ~mask_not->bitmap[i] & uvm_page_mask_region_word_mask(region, i);
+            weight += hweight_long(word);
+        }
+
+        mask_out->bitmap[i] = word;
+    }
+
+    return weight;
 }
 
 static bool uvm_page_mask_region_empty(const uvm_page_mask_t *mask, uvm_va_block_region_t region)
@@ -1820,6 +1963,37 @@ static bool uvm_page_mask_andnot(uvm_page_mask_t *mask_out,
     return bitmap_andnot(mask_out->bitmap, mask_in1->bitmap, mask_in2->bitmap, PAGES_PER_UVM_VA_BLOCK);
 }
 
+// mask_out = mask_in & ~(mask_not1 | mask_not2), computed in a single pass.
+// mask_not2 can be NULL, in which case this is equivalent to
+// uvm_page_mask_andnot(). mask_out can alias any of the inputs.
+//
+// Returns whether mask_out has any page set.
+static bool uvm_page_mask_andnot_or(uvm_page_mask_t *mask_out,
+                                    const uvm_page_mask_t *mask_in,
+                                    const uvm_page_mask_t *mask_not1,
+                                    const uvm_page_mask_t *mask_not2)
+{
+    unsigned long result = 0;
+    size_t i;
+
+    if (!mask_not2)
+        return uvm_page_mask_andnot(mask_out, mask_in, mask_not1);
+
+    for (i = 0; i < ARRAY_SIZE(mask_out->bitmap); i++) {
+        unsigned long word = mask_in->bitmap[i] & ~(mask_not1->bitmap[i] | mask_not2->bitmap[i]);
+
+        // Bits past the end of the mask in the last word are not guaranteed to
+        // be clear, see bitmap_complement().
+        if (i == ARRAY_SIZE(mask_out->bitmap) - 1)
+            word &= BITMAP_LAST_WORD_MASK(PAGES_PER_UVM_VA_BLOCK);
+
+        mask_out->bitmap[i] = word;
+        result |= word;
+    }
+
+    return result != 0;
+}
+
 static void uvm_page_mask_or(uvm_page_mask_t *mask_out,
                              const uvm_page_mask_t *mask_in1,
                              const uvm_page_mask_t *mask_in2)
@@ -2246,6 +2420,22 @@ uvm_prot_t uvm_va_block_page_compute_highest_permission(uvm_va_block_t *va_block
                                                         uvm_processor_id_t processor_id,
                                                         uvm_page_index_t page_index);
 
+// Try to map the whole block on the given GPU with a single 2M PTE. This is
+// only possible if the block is fully resident on the GPU in a single
+// physically-contiguous chunk. Unmapped pages and pages mapped with a lower
+// protection are mapped with the highest protection already present in the
+// block, unless doing so would require revoking permissions on other
+// processors, in which case the block is left unchanged. promoted is set to
+// true if the block ends up mapped with a 2M PTE.
+//
+// The work is tracked in the block's tracker.
+//
+// LOCKING: The caller must hold the va_space lock and the va_block lock.
+NV_STATUS uvm_va_block_gpu_promote_2m(uvm_va_block_t *va_block,
+                                      uvm_va_block_context_t *va_block_context,
+                                      uvm_gpu_t *gpu,
+                                      bool *promoted);
+
 // Allocates a page for the given page_index in the va_block and maps
 // it to the GPU.
 // Locking: the va_block lock must be held.
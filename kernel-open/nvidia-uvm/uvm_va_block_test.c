@@ -28,6 +28,10 @@
 #include "uvm_va_block.h"
 #include "uvm_va_space.h"
 #include "uvm_mmu.h"
+#include "uvm_kvmalloc.h"
+#include "uvm_test_rng.h"
+
+#define TEST_PAGE_MASK_OPS_ITERATIONS 10000
 
 static NV_STATUS test_chunk_index_range(NvU64 start, NvU64 size, uvm_gpu_t *gpu)
 {
@@ -95,12 +99,117 @@ static NV_STATUS test_chunk_index(uvm_gpu_t *gpu)
     return NV_OK;
 }
 
+typedef struct
+{
+    uvm_page_mask_t in;
+    uvm_page_mask_t not1;
+    uvm_page_mask_t not2;
+    uvm_page_mask_t expected;
+    uvm_page_mask_t result;
+} test_page_mask_ops_t;
+
+// Fill the mask with random bits, and then set or clear a random region, so
+// that both sparse masks and masks with long runs of pages are covered.
+static void test_page_mask_fill_random(uvm_test_rng_t *rng, uvm_page_mask_t *mask)
+{
+    uvm_va_block_region_t region;
+
+    uvm_test_rng_memset(rng, mask->bitmap, sizeof(mask->bitmap));
+
+    region.first = uvm_test_rng_range_32(rng, 0, PAGES_PER_UVM_VA_BLOCK - 1);
+    region.outer = uvm_test_rng_range_32(rng, region.first, PAGES_PER_UVM_VA_BLOCK);
+
+    if (uvm_test_rng_32(rng) & 1)
+        uvm_page_mask_region_fill(mask, region);
+    else
+        uvm_page_mask_region_clear(mask, region);
+}
+
+// Check the fused page mask helpers against the equivalent sequence of simple
+// helpers.
+static NV_STATUS test_page_mask_ops(void)
+{
+    NV_STATUS status = NV_OK;
+    test_page_mask_ops_t *masks;
+    uvm_test_rng_t rng;
+    NvU32 i;
+
+    masks = uvm_kvmalloc_zero(sizeof(*masks));
+    if (!masks)
+        return NV_ERR_NO_MEMORY;
+
+    uvm_test_rng_init(&rng, 0);
+
+    for (i = 0; i < TEST_PAGE_MASK_OPS_ITERATIONS; i++) {
+        uvm_va_block_region_t region;
+        uvm_page_index_t page_index;
+        const uvm_page_mask_t *mask_in;
+        NvU32 expected_weight = 0;
+        bool expected_nonempty;
+
+        test_page_mask_fill_random(&rng, &masks->in);
+        test_page_mask_fill_random(&rng, &masks->not1);
+        test_page_mask_fill_random(&rng, &masks->not2);
+
+        region.first = uvm_test_rng_range_32(&rng, 0, PAGES_PER_UVM_VA_BLOCK - 1);
+        region.outer = uvm_test_rng_range_32(&rng, region.first, PAGES_PER_UVM_VA_BLOCK);
+
+        for_each_va_block_page_in_region(page_index, region)
+            expected_weight += uvm_page_mask_test(&masks->in, page_index);
+        TEST_CHECK_GOTO(uvm_page_mask_region_weight(&masks->in, region) == expected_weight, done);
+
+        // Exercise the NULL mask_in case in some of the iterations
+        mask_in = (i % 4 == 0)? NULL : &masks->in;
+
+        if (mask_in)
+            uvm_page_mask_andnot(&masks->expected, mask_in, &masks->not1);
+        else
+            uvm_page_mask_complement(&masks->expected, &masks->not1);
+        uvm_page_mask_region_clear_outside(&masks->expected, region);
+        expected_weight = uvm_page_mask_weight(&masks->expected);
+
+        TEST_CHECK_GOTO(uvm_page_mask_region_andnot_weight(&masks->result, region, mask_in, &masks->not1) ==
+                        expected_weight,
+                        done);
+        TEST_CHECK_GOTO(uvm_page_mask_equal(&masks->result, &masks->expected), done);
+
+        // Aliased output
+        if (mask_in) {
+            uvm_page_mask_copy(&masks->result, mask_in);
+            TEST_CHECK_GOTO(uvm_page_mask_region_andnot_weight(&masks->result,
+                                                               region,
+                                                               &masks->result,
+                                                               &masks->not1) == expected_weight,
+                            done);
+            TEST_CHECK_GOTO(uvm_page_mask_equal(&masks->result, &masks->expected), done);
+        }
+
+        uvm_page_mask_andnot(&masks->expected, &masks->in, &masks->not1);
+        expected_nonempty = uvm_page_mask_andnot(&masks->expected, &masks->expected, &masks->not2);
+
+        uvm_page_mask_copy(&masks->result, &masks->in);
+        TEST_CHECK_GOTO(uvm_page_mask_andnot_or(&masks->result, &masks->result, &masks->not1, &masks->not2) ==
+                        expected_nonempty,
+                        done);
+        TEST_CHECK_GOTO(uvm_page_mask_equal(&masks->result, &masks->expected), done);
+    }
+
+done:
+    uvm_kvfree(masks);
+
+    return status;
+}
+
 NV_STATUS uvm_test_va_block(UVM_TEST_VA_BLOCK_PARAMS *params, struct file *filp)
 {
     uvm_va_space_t *va_space = uvm_va_space_get(filp);
     uvm_gpu_t *gpu;
     NV_STATUS status = NV_OK;
 
+    status = test_page_mask_ops();
+    if (status != NV_OK)
+        return status;
+
     uvm_va_space_down_read(va_space);
 
     for_each_va_space_gpu(gpu, va_space)
@@ -161,7 +161,7 @@ typedef struct
 // In the worst case some VA block operations require more state than we should
 // reasonably store on the stack. Instead, we dynamically allocate VA block
 // contexts. These are used for almost all operations on VA blocks.
-typedef struct
+struct uvm_va_block_context_struct
 {
     // Available as scratch space for the caller. Not used by any of the VA
     // block APIs.
@@ -235,6 +235,11 @@ typedef struct
 
         // Event that triggered the call
         uvm_make_resident_cause_t cause;
+
+        // CE stripe to do the copies in, see uvm_channel_reserve_ce_stripe().
+        // Zero selects the default channels of the copy type. Callers setting
+        // a different stripe are responsible for resetting it to zero.
+        NvU32 ce_stripe;
     } make_resident;
 
     // State used by the mapping APIs (unmap, map, revoke). This could be used
@@ -270,6 +275,15 @@ typedef struct
         uvm_pte_batch_t pte_batch;
         uvm_tlb_batch_t tlb_batch;
 
+        // Optional array of TLB batches indexed by uvm_id_gpu_index(). When
+        // set, the final TLB invalidate of an unmap which isn't followed by
+        // any other PTE or PDE change is merged into the batch of the
+        // corresponding GPU instead of being pushed. The caller is responsible
+        // for pushing the accumulated invalidates once it's done with all the
+        // blocks, and before the unmapped memory can be reused. See
+        // uvm_va_range_destroy_managed().
+        uvm_tlb_batch_t *deferred_tlb_batches;
+
         // Event that triggered the call to the mapping function
         UvmEventMapRemoteCause cause;
     } mapping;
@@ -282,6 +296,11 @@ typedef struct
         uvm_page_mask_t running_page_mask;
     } update_read_duplicated_pages;
 
+    struct
+    {
+        uvm_page_mask_t map_page_mask;
+    } promote_2m;
+
     // mm to use for the operation. If this is non-NULL, the caller guarantees
     // that the mm will be valid (reference held) for the duration of the
     // block operation.
@@ -315,7 +334,7 @@ typedef struct
 
     // Convenience buffer for page mask prints
     char page_mask_string_buffer[UVM_PAGE_MASK_PRINT_MIN_BUFFER_SIZE];
-} uvm_va_block_context_t;
+};
 
 typedef enum
 {
@@ -33,6 +33,7 @@ const uvm_va_policy_t uvm_va_policy_default = {
     .preferred_location = UVM_ID_INVALID,
     .preferred_nid = NUMA_NO_NODE,
     .read_duplication = UVM_READ_DUPLICATION_UNSET,
+    .gpu_resident_reservation = UVM_ID_INVALID,
 };
 
 bool uvm_va_policy_is_read_duplicate(const uvm_va_policy_t *policy, uvm_va_space_t *va_space)
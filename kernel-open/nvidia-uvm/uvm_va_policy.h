@@ -41,6 +41,29 @@ typedef enum
     UVM_READ_DUPLICATION_MAX
 } uvm_read_duplication_policy_t;
 
+// Per-range overrides of the VA space thrashing mitigation parameters, set
+// with UVM_SET_THRASHING_POLICY. Zero values mean that the corresponding VA
+// space parameter is used.
+typedef struct
+{
+    // Disable thrashing mitigation on the range
+    bool disable;
+
+    // Use the link cost model to decide whether pinning the page and mapping
+    // it remotely is cheaper than migrating it back and forth
+    bool cost_model;
+
+    unsigned threshold;
+
+    unsigned pin_threshold;
+
+    NvU64 lapse_ns;
+
+    NvU64 nap_ns;
+
+    NvU64 pin_ns;
+} uvm_va_policy_thrashing_t;
+
 typedef enum
 {
     UVM_VA_POLICY_PREFERRED_LOCATION = 0,
@@ -79,6 +102,14 @@ struct uvm_va_policy_struct
     // their page tables updated to access the (possibly remote) pages.
     uvm_processor_mask_t accessed_by;
 
+    // Thrashing mitigation overrides for this VA range. Only managed VA ranges
+    // support overrides, HMM policies always use the VA space parameters.
+    uvm_va_policy_thrashing_t thrashing;
+
+    // GPU on which the memory of this VA range is protected from eviction, set
+    // with UVM_SET_GPU_RESIDENT_RESERVATION. This is set to UVM_ID_INVALID if
+    // there is no reservation. Only managed VA ranges support reservations.
+    uvm_processor_id_t gpu_resident_reservation;
 };
 
 // Policy nodes are used for storing policies in HMM va_blocks.
@@ -37,6 +37,18 @@
 static struct kmem_cache *g_uvm_va_range_cache __read_mostly;
 static struct kmem_cache *g_uvm_vma_wrapper_cache __read_mostly;
 
+static unsigned uvm_page_table_prebuild = 0;
+module_param(uvm_page_table_prebuild, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_page_table_prebuild,
+                 "Pre-build GPU page directories down to the 2M level for whole managed VA ranges when they are "
+                 "created or when a GPU VA space is registered, instead of allocating them on first touch.");
+
+static unsigned uvm_gpu_resident_reservation_percent = 25;
+module_param(uvm_gpu_resident_reservation_percent, uint, S_IRUGO);
+MODULE_PARM_DESC(uvm_gpu_resident_reservation_percent,
+                 "Percentage of the memory of a GPU that each VA space can protect from eviction with GPU resident "
+                 "reservations. 0 disables reservations.");
+
 NV_STATUS uvm_va_range_init(void)
 {
     g_uvm_va_range_cache = NV_KMEM_CACHE_CREATE("uvm_va_range_t", uvm_va_range_t);
@@ -177,6 +189,52 @@ error:
     return NULL;
 }
 
+// Best-effort allocation of the page directories covering the 2M-aligned
+// portion of the managed VA range on the given GPU VA space. All the
+// directories are allocated in a single batch and only waited on once.
+static void va_range_prebuild_ptes(uvm_va_range_t *va_range, uvm_gpu_va_space_t *gpu_va_space)
+{
+    uvm_page_table_range_vec_t **range_vec;
+    NvU64 start = UVM_ALIGN_UP(va_range->node.start, UVM_PAGE_SIZE_2M);
+    NvU64 end = UVM_ALIGN_DOWN(va_range->node.end + 1, UVM_PAGE_SIZE_2M);
+    NV_STATUS status;
+
+    UVM_ASSERT(va_range->type == UVM_VA_RANGE_TYPE_MANAGED);
+    uvm_assert_rwsem_locked_write(&va_range->va_space->lock);
+
+    range_vec = &va_range->managed.prebuilt_ptes[uvm_id_gpu_index(gpu_va_space->gpu->id)];
+    UVM_ASSERT(!*range_vec);
+
+    if (!uvm_page_table_prebuild || start >= end)
+        return;
+
+    // On ATS systems PDEs are pre-populated down to PDE1 only for VA blocks
+    // that have been mapped on the CPU. See block_pre_populate_pde1_gpu.
+    if (gpu_va_space->ats.enabled || !uvm_mmu_page_size_supported(&gpu_va_space->page_tables, UVM_PAGE_SIZE_2M))
+        return;
+
+    status = uvm_page_table_range_vec_create(&gpu_va_space->page_tables,
+                                             start,
+                                             end - start,
+                                             UVM_PAGE_SIZE_2M,
+                                             UVM_PMM_ALLOC_FLAGS_NONE,
+                                             range_vec);
+    if (status != NV_OK)
+        *range_vec = NULL;
+}
+
+static void va_range_release_prebuilt_ptes(uvm_va_range_t *va_range, uvm_gpu_t *gpu)
+{
+    uvm_page_table_range_vec_t **range_vec = &va_range->managed.prebuilt_ptes[uvm_id_gpu_index(gpu->id)];
+
+    UVM_ASSERT(va_range->type == UVM_VA_RANGE_TYPE_MANAGED);
+
+    if (*range_vec) {
+        uvm_page_table_range_vec_destroy(*range_vec);
+        *range_vec = NULL;
+    }
+}
+
 NV_STATUS uvm_va_range_create_mmap(uvm_va_space_t *va_space,
                                    struct mm_struct *mm,
                                    uvm_vma_wrapper_t *vma_wrapper,
@@ -204,6 +262,13 @@ NV_STATUS uvm_va_range_create_mmap(uvm_va_space_t *va_space,
     if (status != NV_OK)
         goto error;
 
+    if (uvm_page_table_prebuild) {
+        uvm_gpu_va_space_t *gpu_va_space;
+
+        for_each_gpu_va_space(gpu_va_space, va_space)
+            va_range_prebuild_ptes(va_range, gpu_va_space);
+    }
+
     if (out_va_range)
         *out_va_range = va_range;
 
@@ -422,19 +487,154 @@ error:
     return status;
 }
 
+// Unmap the GPUs from all the blocks of the range which aren't resident on
+// any GPU, accumulating the TLB invalidates of all the blocks and pushing them
+// once per GPU at the end. Without this, each block pushes its own
+// invalidates when it's killed, which for large ranges can end up being
+// thousands of TLB invalidates, most of them falling back to invalidate all.
+//
+// Blocks with GPU-resident pages are left for uvm_va_block_kill() so that
+// their GPU chunks are never freed while stale translations to them might be
+// cached. Sysmem pages of the other blocks are only freed by
+// uvm_va_block_kill(), after all the invalidates have completed.
+//
+// This is an optimization only: on any failure the remaining mappings are
+// torn down by uvm_va_block_kill() as usual.
+static void va_range_unmap_gpus_batched(uvm_va_range_t *va_range)
+{
+    uvm_va_space_t *va_space = va_range->va_space;
+    uvm_va_block_context_t *block_context;
+    uvm_tlb_batch_t *tlb_batches;
+    uvm_tracker_t local_tracker = UVM_TRACKER_INIT();
+    uvm_gpu_va_space_t *gpu_va_space;
+    uvm_va_block_t *block;
+    NV_STATUS status = NV_OK;
+
+    uvm_assert_rwsem_locked_write(&va_space->lock);
+
+    if (!va_range->blocks || uvm_va_range_num_blocks(va_range) < 2)
+        return;
+
+    tlb_batches = uvm_kvmalloc(sizeof(*tlb_batches) * UVM_ID_MAX_GPUS);
+    if (!tlb_batches)
+        return;
+
+    for_each_gpu_va_space(gpu_va_space, va_space)
+        uvm_tlb_batch_begin(&gpu_va_space->page_tables, &tlb_batches[uvm_id_gpu_index(gpu_va_space->gpu->id)]);
+
+    // The VA space lock is held in write mode so it's safe to use the VA
+    // space's block context, like uvm_va_block_kill() does.
+    block_context = uvm_va_space_block_context(va_space, NULL);
+
+    for_each_va_block_in_va_range(va_range, block) {
+        uvm_processor_mask_t *gpus_mask = &block_context->caller_processor_mask;
+        uvm_va_block_region_t region = uvm_va_block_region_from_block(block);
+
+        uvm_mutex_lock(&block->lock);
+
+        uvm_processor_mask_copy(gpus_mask, &block->mapped);
+        uvm_processor_mask_clear(gpus_mask, UVM_ID_CPU);
+
+        if (!uvm_processor_mask_empty(gpus_mask) && uvm_processor_mask_get_gpu_count(&block->resident) == 0) {
+            block_context->mapping.deferred_tlb_batches = tlb_batches;
+            status = uvm_va_block_unmap_mask(block, block_context, gpus_mask, region, NULL);
+            block_context->mapping.deferred_tlb_batches = NULL;
+
+            if (status == NV_OK)
+                status = uvm_tracker_add_tracker_safe(&local_tracker, &block->tracker);
+        }
+
+        uvm_mutex_unlock(&block->lock);
+
+        // Stop on errors, but the invalidates accumulated so far still have to
+        // be pushed.
+        if (status != NV_OK)
+            break;
+    }
+
+    for_each_gpu_va_space(gpu_va_space, va_space) {
+        uvm_gpu_t *gpu = gpu_va_space->gpu;
+        uvm_tlb_batch_t *tlb_batch = &tlb_batches[uvm_id_gpu_index(gpu->id)];
+        uvm_push_t push;
+
+        if (tlb_batch->count == 0)
+            continue;
+
+        status = uvm_push_begin_acquire(gpu->channel_manager,
+                                        UVM_CHANNEL_TYPE_MEMOPS,
+                                        &local_tracker,
+                                        &push,
+                                        "Invalidating TLBs for range [0x%llx, 0x%llx]",
+                                        va_range->node.start,
+                                        va_range->node.end);
+        if (status != NV_OK) {
+            UVM_ASSERT(status == uvm_global_get_status());
+            break;
+        }
+
+        uvm_tlb_batch_end(tlb_batch, &push, UVM_MEMBAR_NONE);
+        uvm_push_end(&push);
+
+        status = uvm_tracker_add_push_safe(&local_tracker, &push);
+        if (status != NV_OK)
+            break;
+    }
+
+    // The invalidates must complete before uvm_va_block_kill() can free the
+    // pages which were unmapped.
+    status = uvm_tracker_wait_deinit(&local_tracker);
+    UVM_ASSERT(status == NV_OK || status == uvm_global_get_status());
+
+    uvm_kvfree(tlb_batches);
+}
+
+static void va_range_account_gpu_resident_reservation(uvm_va_range_t *va_range,
+                                                      uvm_processor_id_t gpu_id,
+                                                      bool reserve)
+{
+    uvm_va_space_t *va_space = va_range->va_space;
+    uvm_gpu_t *gpu = uvm_va_space_get_gpu(va_space, gpu_id);
+    NvU64 *reserved_size = &va_space->gpu_resident_reservation_size[uvm_id_gpu_index(gpu_id)];
+    NvU64 size = uvm_va_range_size(va_range);
+
+    if (reserve) {
+        *reserved_size += size;
+        atomic64_add(size, &gpu->pmm.root_chunks.reservation_size);
+    }
+    else {
+        UVM_ASSERT(*reserved_size >= size);
+        *reserved_size -= size;
+        atomic64_sub(size, &gpu->pmm.root_chunks.reservation_size);
+    }
+}
+
 static void uvm_va_range_destroy_managed(uvm_va_range_t *va_range)
 {
     uvm_va_block_t *block;
     uvm_va_block_t *block_tmp;
     uvm_perf_event_data_t event_data;
+    uvm_gpu_va_space_t *gpu_va_space;
+    uvm_processor_id_t reservation_gpu_id = uvm_va_range_get_policy(va_range)->gpu_resident_reservation;
     NV_STATUS status;
 
     UVM_ASSERT(va_range->type == UVM_VA_RANGE_TYPE_MANAGED);
 
+    // The blocks are about to be killed, which frees their memory and updates
+    // the root chunks, so only the accounting needs to be dropped.
+    if (UVM_ID_IS_VALID(reservation_gpu_id))
+        va_range_account_gpu_resident_reservation(va_range, reservation_gpu_id, false);
+
+    for_each_gpu_va_space(gpu_va_space, va_range->va_space)
+        va_range_release_prebuilt_ptes(va_range, gpu_va_space->gpu);
+
+    va_range_unmap_gpus_batched(va_range);
+
     if (va_range->blocks) {
-        // Unmap and drop our ref count on each block
+        // Unmap and drop our ref count on each block. The blocks' GPU TLBs
+        // were already invalidated above in one go, and freeing their memory
+        // is left to the block reaper.
         for_each_va_block_in_va_range_safe(va_range, block, block_tmp)
-            uvm_va_block_kill(block);
+            uvm_va_block_kill_deferred(block);
 
         uvm_kvfree(va_range->blocks);
     }
@@ -615,6 +815,8 @@ static NV_STATUS va_range_add_gpu_va_space_managed(uvm_va_range_t *va_range,
         uvm_va_range_get_policy(va_range)->read_duplication == UVM_READ_DUPLICATION_ENABLED &&
         (uvm_va_space_can_read_duplicate(va_space, NULL) != uvm_va_space_can_read_duplicate(va_space, gpu));
 
+    va_range_prebuild_ptes(va_range, gpu_va_space);
+
     // Combine conditions to perform a single VA block traversal
     if (gpu_va_space->ats.enabled || should_add_remote_mappings || should_disable_read_duplication) {
         uvm_va_block_t *va_block;
@@ -702,6 +904,8 @@ static void va_range_remove_gpu_va_space_managed(uvm_va_range_t *va_range,
         uvm_va_range_get_policy(va_range)->read_duplication == UVM_READ_DUPLICATION_ENABLED &&
         uvm_va_space_can_read_duplicate(va_space, NULL) != uvm_va_space_can_read_duplicate(va_space, gpu_va_space->gpu);
 
+    va_range_release_prebuilt_ptes(va_range, gpu_va_space->gpu);
+
     for_each_va_block_in_va_range(va_range, va_block) {
         uvm_mutex_lock(&va_block->lock);
         uvm_va_block_remove_gpu_va_space(va_block, gpu_va_space, va_block_context);
@@ -777,8 +981,14 @@ static NV_STATUS uvm_va_range_enable_peer_managed(uvm_va_range_t *va_range, uvm_
     bool gpu0_accessed_by = uvm_processor_mask_test(&uvm_va_range_get_policy(va_range)->accessed_by, gpu0->id);
     bool gpu1_accessed_by = uvm_processor_mask_test(&uvm_va_range_get_policy(va_range)->accessed_by, gpu1->id);
     uvm_va_space_t *va_space = va_range->va_space;
-    uvm_va_block_context_t *va_block_context = uvm_va_space_block_context(va_space, NULL);
+    uvm_va_block_context_t *va_block_context;
 
+    // Enabling peer access only adds the accessed-by mappings, so there's no
+    // need to walk the blocks if neither GPU is in the accessed-by mask.
+    if (!gpu0_accessed_by && !gpu1_accessed_by)
+        return NV_OK;
+
+    va_block_context = uvm_va_space_block_context(va_space, NULL);
 
     for_each_va_block_in_va_range(va_range, va_block) {
         // For UVM-Lite at most one GPU needs to map the peer GPU if it's the
@@ -947,6 +1157,9 @@ static void va_range_unregister_gpu_managed(uvm_va_range_t *va_range, uvm_gpu_t
 
     uvm_va_range_unset_accessed_by(va_range, gpu->id, NULL);
 
+    if (uvm_id_equal(uvm_va_range_get_policy(va_range)->gpu_resident_reservation, gpu->id))
+        uvm_va_range_set_gpu_resident_reservation(va_range, UVM_ID_INVALID);
+
     // Migrate and free any remaining resident allocations on this GPU
     for_each_va_block_in_va_range(va_range, va_block)
         uvm_va_block_unregister_gpu(va_block, gpu, mm);
@@ -1141,6 +1354,30 @@ static NV_STATUS uvm_va_range_split_blocks(uvm_va_range_t *existing, uvm_va_rang
     return NV_OK;
 }
 
+// Rebuild the pre-built page directories of both halves of a split VA range.
+// The split point is not necessarily 2M-aligned, so the old range vector can't
+// just be split. It is only released after the new ones have been created so
+// that the directories shared by both halves are not freed in between.
+static void va_range_split_prebuilt_ptes(uvm_va_range_t *existing, uvm_va_range_t *new)
+{
+    uvm_gpu_va_space_t *gpu_va_space;
+
+    for_each_gpu_va_space(gpu_va_space, existing->va_space) {
+        size_t gpu_index = uvm_id_gpu_index(gpu_va_space->gpu->id);
+        uvm_page_table_range_vec_t *old_range_vec = existing->managed.prebuilt_ptes[gpu_index];
+
+        if (!old_range_vec)
+            continue;
+
+        existing->managed.prebuilt_ptes[gpu_index] = NULL;
+
+        va_range_prebuild_ptes(existing, gpu_va_space);
+        va_range_prebuild_ptes(new, gpu_va_space);
+
+        uvm_page_table_range_vec_destroy(old_range_vec);
+    }
+}
+
 NV_STATUS uvm_va_range_split(uvm_va_range_t *existing_va_range,
                              NvU64 new_end,
                              uvm_va_range_t **new_va_range)
@@ -1173,6 +1410,12 @@ NV_STATUS uvm_va_range_split(uvm_va_range_t *existing_va_range,
     uvm_va_range_get_policy(new)->preferred_nid = uvm_va_range_get_policy(existing_va_range)->preferred_nid;
     uvm_processor_mask_copy(&uvm_va_range_get_policy(new)->accessed_by,
                             &uvm_va_range_get_policy(existing_va_range)->accessed_by);
+    uvm_va_range_get_policy(new)->thrashing = uvm_va_range_get_policy(existing_va_range)->thrashing;
+
+    // The size accounted for the reservation doesn't change as it moves from
+    // the existing range to the new one.
+    uvm_va_range_get_policy(new)->gpu_resident_reservation =
+        uvm_va_range_get_policy(existing_va_range)->gpu_resident_reservation;
     uvm_processor_mask_copy(&new->uvm_lite_gpus, &existing_va_range->uvm_lite_gpus);
 
     status = uvm_va_range_split_blocks(existing_va_range, new);
@@ -1182,6 +1425,8 @@ NV_STATUS uvm_va_range_split(uvm_va_range_t *existing_va_range,
     // Finally, update the VA range tree
     uvm_range_tree_split(&va_space->va_range_tree, &existing_va_range->node, &new->node);
 
+    va_range_split_prebuilt_ptes(existing_va_range, new);
+
     if (new->type == UVM_VA_RANGE_TYPE_MANAGED) {
         event_data.range_shrink.range = new;
         uvm_perf_event_notify(&va_space->perf_events, UVM_PERF_EVENT_RANGE_SHRINK, &event_data);
@@ -1192,6 +1437,8 @@ NV_STATUS uvm_va_range_split(uvm_va_range_t *existing_va_range,
     return NV_OK;
 
 error:
+    // The reservation of the new range was never accounted
+    uvm_va_range_get_policy(new)->gpu_resident_reservation = UVM_ID_INVALID;
     uvm_va_range_destroy(new, NULL);
     return status;
 
@@ -1681,6 +1928,78 @@ void uvm_va_range_unset_accessed_by(uvm_va_range_t *va_range,
     range_update_uvm_lite_gpus_mask(va_range);
 }
 
+void uvm_va_range_set_gpu_resident_reservation(uvm_va_range_t *va_range, uvm_processor_id_t gpu_id)
+{
+    uvm_va_space_t *va_space = va_range->va_space;
+    uvm_va_policy_t *policy = uvm_va_range_get_policy(va_range);
+    uvm_processor_id_t old_gpu_id = policy->gpu_resident_reservation;
+    uvm_va_block_t *va_block;
+
+    UVM_ASSERT(va_range->type == UVM_VA_RANGE_TYPE_MANAGED);
+    UVM_ASSERT(UVM_ID_IS_INVALID(gpu_id) || UVM_ID_IS_GPU(gpu_id));
+    uvm_assert_rwsem_locked_write(&va_space->lock);
+
+    if (uvm_id_equal(old_gpu_id, gpu_id))
+        return;
+
+    policy->gpu_resident_reservation = gpu_id;
+
+    if (UVM_ID_IS_VALID(old_gpu_id)) {
+        uvm_gpu_t *old_gpu = uvm_va_space_get_gpu(va_space, old_gpu_id);
+
+        va_range_account_gpu_resident_reservation(va_range, old_gpu_id, false);
+
+        for_each_va_block_in_va_range(va_range, va_block)
+            uvm_va_block_update_gpu_resident_reservation(va_block, old_gpu);
+    }
+
+    if (UVM_ID_IS_VALID(gpu_id)) {
+        uvm_gpu_t *gpu = uvm_va_space_get_gpu(va_space, gpu_id);
+
+        va_range_account_gpu_resident_reservation(va_range, gpu_id, true);
+
+        for_each_va_block_in_va_range(va_range, va_block)
+            uvm_va_block_update_gpu_resident_reservation(va_block, gpu);
+    }
+}
+
+NvU64 uvm_va_range_gpu_resident_reservation_quota(uvm_gpu_t *gpu)
+{
+    return div_u64(gpu->mem_info.size * min(uvm_gpu_resident_reservation_percent, 100u), 100);
+}
+
+void uvm_va_range_get_stats(uvm_va_range_t *va_range, uvm_va_range_stats_t *stats)
+{
+    uvm_va_block_t *va_block;
+
+    UVM_ASSERT(va_range->type == UVM_VA_RANGE_TYPE_MANAGED);
+    uvm_assert_rwsem_locked(&va_range->va_space->lock);
+
+    for_each_va_block_in_va_range(va_range, va_block) {
+        uvm_processor_id_t id;
+
+        uvm_mutex_lock(&va_block->lock);
+
+        for_each_id(id) {
+            uvm_va_range_stats_t *range_stats = &stats[uvm_id_value(id)];
+            uvm_va_block_stats_t *block_stats = uvm_va_block_stats_get(va_block, id);
+
+            if (va_block->num_faults)
+                range_stats->faults += va_block->num_faults[uvm_id_value(id)];
+
+            if (!block_stats)
+                continue;
+
+            range_stats->bytes_migrated_in += block_stats->bytes_migrated_in;
+            range_stats->bytes_migrated_out += block_stats->bytes_migrated_out;
+            range_stats->bytes_evicted += block_stats->bytes_evicted;
+            range_stats->thrashing_events += block_stats->thrashing_events;
+        }
+
+        uvm_mutex_unlock(&va_block->lock);
+    }
+}
+
 NV_STATUS uvm_va_range_set_read_duplication(uvm_va_range_t *va_range, struct mm_struct *mm)
 {
     uvm_va_block_t *va_block;
@@ -146,6 +146,13 @@ typedef struct
     uvm_va_policy_t policy;
 
     uvm_perf_module_data_desc_t perf_modules_data[UVM_PERF_MODULE_TYPE_COUNT];
+
+    // Page directories pre-built down to the 2M level for each GPU when the
+    // uvm_page_table_prebuild module parameter is set. These hold a reference
+    // on the directories covering the 2M-aligned portion of the range so that
+    // first-touch mappings don't need to allocate them. They don't map
+    // anything by themselves. Protected by the VA space lock in write mode.
+    uvm_page_table_range_vec_t *prebuilt_ptes[UVM_ID_MAX_GPUS];
 } uvm_va_range_managed_t;
 
 typedef struct
@@ -163,6 +170,11 @@ typedef struct
     // Refcount for this handle/allocation. The refcount is used when external
     // ranges are split, resulting in two ranges using the same physical allocation.
     nv_kref_t ref_count;
+
+    // Entry of the GPU's external PTE cache holding the PTEs this allocation
+    // was mapped with, if any. The reference on the entry is dropped before
+    // rm_handle is freed.
+    uvm_ext_pte_cache_entry_t *pte_cache_entry;
 } uvm_ext_gpu_mem_handle;
 
 typedef struct
@@ -845,6 +857,43 @@ void uvm_va_range_unset_accessed_by(uvm_va_range_t *va_range,
                                     uvm_processor_id_t processor_id,
                                     uvm_tracker_t *out_tracker);
 
+// Set the GPU on which the memory of the VA range is protected from eviction,
+// or clear the reservation if gpu_id is UVM_ID_INVALID, and update the VA
+// blocks of the range. The size of the range is accounted to the GPU in
+// uvm_va_space_t::gpu_resident_reservation_size. The caller is responsible for
+// checking the quota, see uvm_va_range_gpu_resident_reservation_quota().
+//
+// The va_range must have type UVM_VA_RANGE_TYPE_MANAGED.
+//
+// LOCKING: The VA space lock must be held in write mode.
+void uvm_va_range_set_gpu_resident_reservation(uvm_va_range_t *va_range, uvm_processor_id_t gpu_id);
+
+// Maximum total size of the VA ranges of a VA space with a GPU resident
+// reservation on the given GPU, see uvm_gpu_resident_reservation_percent.
+NvU64 uvm_va_range_gpu_resident_reservation_quota(uvm_gpu_t *gpu);
+
+// Activity counters of a processor on a VA range: the sum of the counters of
+// its VA blocks, see uvm_va_block_stats_t.
+typedef struct
+{
+    NvU64 bytes_migrated_in;
+    NvU64 bytes_migrated_out;
+    NvU64 bytes_evicted;
+    NvU64 faults;
+    NvU64 thrashing_events;
+} uvm_va_range_stats_t;
+
+// Add the activity counters of all the VA blocks of the range to stats, which
+// is indexed by uvm_id_value() and must have UVM_ID_MAX_PROCESSORS entries. The
+// counters of blocks that have been destroyed, for example by a partial
+// munmap, are lost.
+//
+// The va_range must have type UVM_VA_RANGE_TYPE_MANAGED.
+//
+// LOCKING: The VA space lock must be held. This takes and releases the lock
+//          of each VA block.
+void uvm_va_range_get_stats(uvm_va_range_t *va_range, uvm_va_range_stats_t *stats);
+
 // Set read-duplication and remove any existing accessed_by and remote mappings
 //
 // If mm != NULL, that mm is used for any CPU mappings which may be created as
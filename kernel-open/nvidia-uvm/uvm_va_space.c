@@ -28,6 +28,7 @@
 #include "uvm_global.h"
 #include "uvm_kvmalloc.h"
 #include "uvm_perf_heuristics.h"
+#include "uvm_procfs.h"
 #include "uvm_user_channel.h"
 #include "uvm_tools.h"
 #include "uvm_thread_context.h"
@@ -37,6 +38,7 @@
 #include "uvm_gpu_access_counters.h"
 #include "uvm_hmm.h"
 #include "uvm_va_space_mm.h"
+#include "uvm_migrate.h"
 #include "uvm_test.h"
 #include "uvm_common.h"
 #include "nv_uvm_interface.h"
@@ -176,6 +178,106 @@ static bool va_space_check_processors_masks(uvm_va_space_t *va_space)
     return true;
 }
 
+static void va_space_range_stats_print(uvm_va_space_t *va_space, struct seq_file *s, uvm_va_range_stats_t *stats)
+{
+    uvm_va_range_t *va_range;
+
+    uvm_for_each_va_range(va_range, va_space) {
+        uvm_processor_id_t id;
+
+        if (va_range->type != UVM_VA_RANGE_TYPE_MANAGED)
+            continue;
+
+        memset(stats, 0, UVM_ID_MAX_PROCESSORS * sizeof(*stats));
+        uvm_va_range_get_stats(va_range, stats);
+
+        UVM_SEQ_OR_DBG_PRINT(s, "0x%llx-0x%llx\n", va_range->node.start, va_range->node.end + 1);
+
+        for_each_id(id) {
+            uvm_va_range_stats_t *processor_stats = &stats[uvm_id_value(id)];
+
+            if (!memchr_inv(processor_stats, 0, sizeof(*processor_stats)))
+                continue;
+
+            // Blocks keep the fault counts of GPUs until they are unregistered
+            // from the VA space
+            if (UVM_ID_IS_GPU(id) && !uvm_processor_mask_test(&va_space->registered_gpus, id))
+                continue;
+
+            UVM_SEQ_OR_DBG_PRINT(s,
+                                 "    %s: migrated_in %llu migrated_out %llu evicted %llu faults %llu thrashing %llu\n",
+                                 uvm_va_space_processor_name(va_space, id),
+                                 processor_stats->bytes_migrated_in,
+                                 processor_stats->bytes_migrated_out,
+                                 processor_stats->bytes_evicted,
+                                 processor_stats->faults,
+                                 processor_stats->thrashing_events);
+        }
+    }
+}
+
+static int nv_procfs_read_va_space_range_stats(struct seq_file *s, void *v)
+{
+    uvm_va_space_t *va_space = (uvm_va_space_t *)s->private;
+    uvm_va_range_stats_t *stats;
+
+    if (!uvm_down_read_trylock(&g_uvm_global.pm.lock))
+        return -EAGAIN;
+
+    stats = uvm_kvmalloc(UVM_ID_MAX_PROCESSORS * sizeof(*stats));
+    if (!stats) {
+        uvm_up_read(&g_uvm_global.pm.lock);
+        return -ENOMEM;
+    }
+
+    uvm_va_space_down_read(va_space);
+    va_space_range_stats_print(va_space, s, stats);
+    uvm_va_space_up_read(va_space);
+
+    uvm_kvfree(stats);
+
+    uvm_up_read(&g_uvm_global.pm.lock);
+
+    return 0;
+}
+
+static int nv_procfs_read_va_space_range_stats_entry(struct seq_file *s, void *v)
+{
+    UVM_ENTRY_RET(nv_procfs_read_va_space_range_stats(s, v));
+}
+
+UVM_DEFINE_SINGLE_PROCFS_FILE(va_space_range_stats_entry);
+
+// The file is only a reporting aid, so failing to create it doesn't fail the
+// creation of the VA space.
+static void va_space_create_procfs_files(uvm_va_space_t *va_space)
+{
+    static atomic64_t next_id = ATOMIC64_INIT(0);
+    char name[32];
+
+    if (!uvm_procfs_is_enabled())
+        return;
+
+    snprintf(name,
+             sizeof(name),
+             "%d_%llu",
+             task_tgid_nr(current),
+             (NvU64)atomic64_inc_return(&next_id));
+
+    va_space->procfs.range_stats_file = NV_CREATE_PROC_FILE(name,
+                                                            uvm_procfs_get_va_space_base_dir(),
+                                                            va_space_range_stats_entry,
+                                                            va_space);
+    if (!va_space->procfs.range_stats_file)
+        UVM_DBG_PRINT("Failed to create the procfs file %s\n", name);
+}
+
+// The kernel waits on readers to finish before returning from proc_remove
+static void va_space_destroy_procfs_files(uvm_va_space_t *va_space)
+{
+    proc_remove(va_space->procfs.range_stats_file);
+}
+
 NV_STATUS uvm_va_space_create(struct address_space *mapping, uvm_va_space_t **va_space_ptr, NvU64 flags)
 {
     NV_STATUS status;
@@ -231,6 +333,8 @@ NV_STATUS uvm_va_space_create(struct address_space *mapping, uvm_va_space_t **va
     init_waitqueue_head(&va_space->va_space_mm.last_retainer_wait_queue);
     init_waitqueue_head(&va_space->gpu_va_space_deferred_free.wait_queue);
 
+    uvm_migrate_va_space_init(va_space);
+
     va_space->mapping = mapping;
     va_space->test.page_prefetch_enabled = true;
 
@@ -257,6 +361,10 @@ NV_STATUS uvm_va_space_create(struct address_space *mapping, uvm_va_space_t **va
     if (status != NV_OK)
         goto fail;
 
+    status = uvm_va_block_stats_init_va_space(va_space);
+    if (status != NV_OK)
+        goto fail;
+
     UVM_ASSERT(va_space_check_processors_masks(va_space));
 
     va_space->initialization_flags = flags;
@@ -267,6 +375,9 @@ NV_STATUS uvm_va_space_create(struct address_space *mapping, uvm_va_space_t **va
 
     uvm_hmm_va_space_initialize(va_space);
 
+    // From now on, events can be notified
+    uvm_perf_seal_va_space_events(&va_space->perf_events);
+
     uvm_va_space_up_write(va_space);
     uvm_up_write_mmap_lock(current->mm);
 
@@ -274,6 +385,8 @@ NV_STATUS uvm_va_space_create(struct address_space *mapping, uvm_va_space_t **va
     list_add_tail(&va_space->list_node, &g_uvm_global.va_spaces.list);
     uvm_mutex_unlock(&g_uvm_global.va_spaces.lock);
 
+    va_space_create_procfs_files(va_space);
+
     *va_space_ptr = va_space;
 
     return NV_OK;
@@ -442,6 +555,8 @@ void uvm_va_space_destroy(uvm_va_space_t *va_space)
     uvm_processor_mask_t *retained_gpus = &va_space->registered_gpus_teardown;
     LIST_HEAD(deferred_free_list);
 
+    va_space_destroy_procfs_files(va_space);
+
     // Remove the VA space from the global list before we start tearing things
     // down so other threads can't see the VA space in a partially-valid state.
     uvm_mutex_lock(&g_uvm_global.va_spaces.lock);
@@ -450,6 +565,10 @@ void uvm_va_space_destroy(uvm_va_space_t *va_space)
 
     uvm_perf_heuristics_stop(va_space);
 
+    // Deferred migrations take the VA space lock on their own, so they need to
+    // be stopped before the teardown.
+    uvm_migrate_va_space_destroy(va_space);
+
     // Stop all channels before unmapping anything. This kills the channels and
     // prevents spurious MMU faults from being generated (bug 1722021), but
     // doesn't prevent the bottom half from servicing old faults for those
@@ -483,6 +602,10 @@ void uvm_va_space_destroy(uvm_va_space_t *va_space)
         uvm_va_range_destroy(va_range, &deferred_free_list);
     }
 
+    // Free the memory of the blocks killed above, or by earlier munmaps, while
+    // their GPUs are still registered.
+    uvm_va_block_reap_deferred();
+
     uvm_range_group_radix_tree_destroy(va_space);
 
     // Unregister all GPUs in the VA space. Note that this does not release the
@@ -492,6 +615,9 @@ void uvm_va_space_destroy(uvm_va_space_t *va_space)
 
     uvm_hmm_va_space_destroy(va_space);
 
+    // All the VA ranges and GPUs are gone, so no more events can be notified
+    // other than the ones generated by the perf modules when unloading.
+    uvm_perf_unseal_va_space_events(&va_space->perf_events);
     uvm_perf_heuristics_unload(va_space);
     uvm_perf_destroy_va_space_events(&va_space->perf_events);
 
@@ -536,14 +662,21 @@ void uvm_va_space_destroy(uvm_va_space_t *va_space)
 
         nv_kthread_q_flush(&gpu->parent->isr.bottom_half_q);
 
+        // The bottom half may have posted deferred prefetches on this VA space
+        uvm_perf_prefetch_queue_flush(&gpu->parent->fault_buffer_info.replayable.prefetch_queue);
+
         // The same applies to the kill channel kthreads. However, they need to
         // be flushed after their bottom-half counterparts since the latter may
         // schedule a channel kill.
         if (gpu->parent->isr.non_replayable_faults.handling)
             nv_kthread_q_flush(&gpu->parent->isr.kill_channel_q);
 
-        if (gpu->parent->access_counters_supported)
+        if (gpu->parent->access_counters_supported) {
+            // The bottom half may have gathered promotion regions on this VA
+            // space
+            uvm_parent_gpu_access_counters_promotion_flush(gpu->parent, va_space);
             uvm_parent_gpu_access_counters_disable(gpu->parent, va_space);
+        }
 
     }
 
@@ -958,6 +1091,10 @@ NV_STATUS uvm_va_space_unregister_gpu(uvm_va_space_t *va_space, const NvProcesso
 
     va_space->peers_to_release[uvm_id_value(gpu->id)] = NULL;
 
+    // Dead blocks of this VA space may still have memory on the GPU. No new
+    // ones can be killed while the VA space lock is held in write mode.
+    uvm_va_block_reap_deferred();
+
     // This will call disable_peers for all GPU's peers, including NVLink
     unregister_gpu(va_space, gpu, mm, &deferred_free_list, peers_to_release);
 
@@ -2175,29 +2312,43 @@ static LIST_HEAD(g_cpu_service_block_context_list);
 
 static uvm_spinlock_t g_cpu_service_block_context_list_lock;
 
+static uvm_object_cache_t *g_uvm_service_block_context_cache __read_mostly;
+
+static NV_STATUS service_block_context_ctor(void *object)
+{
+    uvm_service_block_context_t *service_context = object;
+
+    service_context->block_context = uvm_va_block_context_alloc(NULL);
+    if (!service_context->block_context)
+        return NV_ERR_NO_MEMORY;
+
+    return NV_OK;
+}
+
+static void service_block_context_dtor(void *object)
+{
+    uvm_service_block_context_t *service_context = object;
+
+    uvm_va_block_context_free(service_context->block_context);
+}
+
 uvm_service_block_context_t *uvm_service_block_context_alloc(struct mm_struct *mm)
 {
-    uvm_service_block_context_t *service_context = uvm_kvmalloc(sizeof(*service_context));
+    uvm_service_block_context_t *service_context = uvm_object_cache_alloc(g_uvm_service_block_context_cache);
 
     if (!service_context)
         return NULL;
 
-    service_context->block_context = uvm_va_block_context_alloc(mm);
-    if (!service_context->block_context) {
-        uvm_kvfree(service_context);
-        service_context = NULL;
-    }
+    // The block context is kept around with the service context by the
+    // cache, but it has to be initialized for the new user.
+    uvm_va_block_context_init(service_context->block_context, mm);
 
     return service_context;
 }
 
 void uvm_service_block_context_free(uvm_service_block_context_t *service_context)
 {
-    if (!service_context)
-        return;
-
-    uvm_va_block_context_free(service_context->block_context);
-    uvm_kvfree(service_context);
+    uvm_object_cache_free(g_uvm_service_block_context_cache, service_context);
 }
 
 NV_STATUS uvm_service_block_context_init(void)
@@ -2206,6 +2357,15 @@ NV_STATUS uvm_service_block_context_init(void)
 
     uvm_spin_lock_init(&g_cpu_service_block_context_list_lock, UVM_LOCK_ORDER_LEAF);
 
+    // Service contexts are fairly big, so only keep a couple of them per CPU
+    g_uvm_service_block_context_cache = UVM_OBJECT_CACHE_CREATE("uvm_service_block_context_t",
+                                                                uvm_service_block_context_t,
+                                                                2,
+                                                                service_block_context_ctor,
+                                                                service_block_context_dtor);
+    if (!g_uvm_service_block_context_cache)
+        return NV_ERR_NO_MEMORY;
+
     // Pre-allocate some fault service contexts for the CPU and add them to the global list
     while (num_preallocated_contexts-- > 0) {
         uvm_service_block_context_t *service_context = uvm_service_block_context_alloc(NULL);
@@ -2232,6 +2392,8 @@ void uvm_service_block_context_exit(void)
     }
 
     INIT_LIST_HEAD(&g_cpu_service_block_context_list);
+
+    uvm_object_cache_destroy_safe(&g_uvm_service_block_context_cache);
 }
 
 // Get a fault service context from the global list or allocate a new one if
@@ -294,6 +294,11 @@ struct uvm_va_space_struct
     // at GPU register and freed at GPU unregister.
     uvm_conf_computing_dma_buffer_t *gpu_unregister_dma_buffer[UVM_ID_MAX_GPUS];
 
+    // Total length of the VA ranges with a GPU resident reservation on each
+    // GPU, which is checked against uvm_va_range_gpu_resident_reservation_quota
+    // when new reservations are set. Protected by the VA space lock.
+    NvU64 gpu_resident_reservation_size[UVM_ID_MAX_GPUS];
+
     // Array of GPU VA spaces
     uvm_gpu_va_space_t *gpu_va_spaces[UVM_ID_MAX_GPUS];
 
@@ -327,6 +332,17 @@ struct uvm_va_space_struct
         struct list_head queues_v1[UvmEventNumTypesAll];
         struct list_head queues_v2[UvmEventNumTypesAll];
 
+        // Bitmaps of the event types with at least one subscribed queue of
+        // each version, indexed by UvmEventType. They are recomputed whenever
+        // the queue lists change so that event recording doesn't need to
+        // inspect the lists.
+        NvU64 enabled_events_v1;
+        NvU64 enabled_events_v2;
+
+        // Number of fault events seen, used to sample fault events when
+        // uvm_tools_fault_event_sample_period is greater than 1
+        atomic64_t num_fault_events;
+
         // Node for this va_space in global subscribers list
         struct list_head node;
     } tools;
@@ -394,6 +410,31 @@ struct uvm_va_space_struct
 
     // Queue item for deferred f_ops->release() handling
     nv_kthread_q_item_t deferred_release_q_item;
+
+    // Migrations queued with UVM_MIGRATE_FLAG_DEFERRED. See uvm_migrate.c.
+    struct
+    {
+        // Protects list and stopped
+        uvm_spinlock_t lock;
+
+        // Queued migrations, in submission order
+        struct list_head list;
+
+        // Set when the VA space starts being destroyed. No new migrations are
+        // accepted after that.
+        bool stopped;
+
+        // Queue item processing the list
+        nv_kthread_q_item_t q_item;
+    } deferred_migrations;
+
+    struct
+    {
+        // /proc/driver/nvidia-uvm/va_spaces/${tgid}_${id}, reporting the
+        // activity counters of each managed VA range. See
+        // uvm_va_range_get_stats().
+        struct proc_dir_entry *range_stats_file;
+    } procfs;
 };
 
 static uvm_gpu_t *uvm_va_space_get_gpu(uvm_va_space_t *va_space, uvm_gpu_id_t gpu_id)
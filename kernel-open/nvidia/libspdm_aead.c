@@ -27,15 +27,74 @@
 #ifdef USE_LKCA
 #define BUFFER_SIZE (2 * 1024 * 1024)
 #define AUTH_TAG_SIZE 16
-struct lkca_aead_ctx
+#define MAX_KEY_SIZE 32
+
+// Cipher state for one direction of a preallocated context
+struct lkca_aead_dir
 {
     struct crypto_aead *aead;
     struct aead_request *req;
+    // Key last set on aead, so that setkey (key expansion and GHASH key
+    // derivation) is only redone when the caller switches keys.
+    uint8_t key[MAX_KEY_SIZE];
+    size_t key_size;
+};
+
+struct lkca_aead_ctx
+{
+    // Encryption and decryption use different keys, so each direction gets
+    // its own aead to keep its key set across calls. Indexed by enc.
+    struct lkca_aead_dir dir[2];
     char *a_data_buffer;
     char *in_buffer;
     char *out_buffer;
     char tag[AUTH_TAG_SIZE];
 };
+
+static void lkca_aead_dir_free(struct lkca_aead_dir *dir)
+{
+    memzero_explicit(dir->key, sizeof(dir->key));
+    dir->key_size = 0;
+
+    if (dir->req != NULL) {
+        aead_request_free(dir->req);
+        dir->req = NULL;
+    }
+
+    if (dir->aead != NULL) {
+        crypto_free_aead(dir->aead);
+        dir->aead = NULL;
+    }
+}
+
+static int lkca_aead_dir_alloc(struct lkca_aead_dir *dir, char const *alg)
+{
+    dir->aead = crypto_alloc_aead(alg, CRYPTO_ALG_TYPE_AEAD, 0);
+    if (IS_ERR(dir->aead)) {
+        pr_notice("could not allocate AEAD algorithm\n");
+        dir->aead = NULL;
+        return -ENODEV;
+    }
+
+    dir->req = aead_request_alloc(dir->aead, GFP_KERNEL);
+    if (dir->req == NULL) {
+        pr_info("could not allocate skcipher request\n");
+        lkca_aead_dir_free(dir);
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+static void lkca_aead_ctx_free(struct lkca_aead_ctx *ctx)
+{
+    lkca_aead_dir_free(&ctx->dir[0]);
+    lkca_aead_dir_free(&ctx->dir[1]);
+    kfree(ctx->a_data_buffer);
+    kfree(ctx->in_buffer);
+    kfree(ctx->out_buffer);
+    kfree(ctx);
+}
 #endif
 
 int libspdm_aead_prealloc(void **context, char const *alg)
@@ -44,6 +103,7 @@ int libspdm_aead_prealloc(void **context, char const *alg)
     return -ENODEV;
 #else
     struct lkca_aead_ctx *ctx;
+    int rc;
 
     ctx = kmalloc(sizeof(*ctx), GFP_KERNEL);
     if (ctx == NULL) {
@@ -52,45 +112,22 @@ int libspdm_aead_prealloc(void **context, char const *alg)
 
     memset(ctx, 0, sizeof(*ctx));
 
-    ctx->aead = crypto_alloc_aead(alg, CRYPTO_ALG_TYPE_AEAD, 0);
-    if (IS_ERR(ctx->aead)) {
-        pr_notice("could not allocate AEAD algorithm\n");
-        kfree(ctx);
-        return -ENODEV;
+    rc = lkca_aead_dir_alloc(&ctx->dir[0], alg);
+    if (rc == 0) {
+        rc = lkca_aead_dir_alloc(&ctx->dir[1], alg);
     }
-
-    ctx->req = aead_request_alloc(ctx->aead, GFP_KERNEL);
-    if (ctx->req == NULL) {
-        pr_info("could not allocate skcipher request\n");
-        crypto_free_aead(ctx->aead);
-        kfree(ctx);
-        return -ENOMEM;
+    if (rc != 0) {
+        lkca_aead_ctx_free(ctx);
+        return rc;
     }
 
     ctx->a_data_buffer = kmalloc(BUFFER_SIZE, GFP_KERNEL);
-    if (ctx->a_data_buffer == NULL) {
-        aead_request_free(ctx->req);
-        crypto_free_aead(ctx->aead);
-        kfree(ctx);
-        return -ENOMEM;
-    }
-
     ctx->in_buffer = kmalloc(BUFFER_SIZE, GFP_KERNEL);
-    if (ctx->in_buffer == NULL) {
-        kfree(ctx->a_data_buffer);
-        aead_request_free(ctx->req);
-        crypto_free_aead(ctx->aead);
-        kfree(ctx);
-        return -ENOMEM;
-    }
-
     ctx->out_buffer = kmalloc(BUFFER_SIZE, GFP_KERNEL);
-    if (ctx->out_buffer == NULL) {
-        kfree(ctx->a_data_buffer);
-        kfree(ctx->in_buffer);
-        aead_request_free(ctx->req);
-        crypto_free_aead(ctx->aead);
-        kfree(ctx);
+    if ((ctx->a_data_buffer == NULL) ||
+        (ctx->in_buffer == NULL) ||
+        (ctx->out_buffer == NULL)) {
+        lkca_aead_ctx_free(ctx);
         return -ENOMEM;
     }
 
@@ -102,13 +139,7 @@ int libspdm_aead_prealloc(void **context, char const *alg)
 void libspdm_aead_free(void *context)
 {
 #ifdef USE_LKCA
-    struct lkca_aead_ctx *ctx = context;
-    crypto_free_aead(ctx->aead);
-    aead_request_free(ctx->req);
-    kfree(ctx->a_data_buffer);
-    kfree(ctx->in_buffer);
-    kfree(ctx->out_buffer);
-    kfree(ctx);
+    lkca_aead_ctx_free(context);
 #endif
 }
 
@@ -119,7 +150,29 @@ void libspdm_aead_free(void *context)
 #define SG_AEAD_LEN 3
 
 #ifdef USE_LKCA
-// This function doesn't do any allocs, it uses temp buffers instead
+// Sets the key on a preallocated direction, unless it is already the one set
+static int lkca_aead_dir_setkey(struct lkca_aead_dir *dir,
+                                const uint8_t *key, size_t key_size)
+{
+    if ((key_size == dir->key_size) && (memcmp(dir->key, key, key_size) == 0)) {
+        return 0;
+    }
+
+    dir->key_size = 0;
+
+    if ((key_size > MAX_KEY_SIZE) || crypto_aead_setkey(dir->aead, key, key_size)) {
+        pr_info("key could not be set\n");
+        return -EINVAL;
+    }
+
+    memcpy(dir->key, key, key_size);
+    dir->key_size = key_size;
+
+    return 0;
+}
+
+// This function doesn't do any allocs, it uses temp buffers instead.
+// A NULL key means the key is already set on aead.
 static int lkca_aead_internal(struct crypto_aead *aead,
                               struct aead_request *req,
                               const uint8_t *key, size_t key_size,
@@ -135,7 +188,7 @@ static int lkca_aead_internal(struct crypto_aead *aead,
     DECLARE_CRYPTO_WAIT(wait);
     int rc = 0;
 
-    if (crypto_aead_setkey(aead, key, key_size)) {
+    if ((key != NULL) && crypto_aead_setkey(aead, key, key_size)) {
         pr_info("key could not be set\n");
         return -EINVAL;
     }
@@ -191,7 +244,7 @@ int libspdm_aead_prealloced(void *context,
     struct scatterlist sg_in[SG_AEAD_LEN];
     struct scatterlist sg_out[SG_AEAD_LEN];
     struct lkca_aead_ctx *ctx = context;
-
+    struct lkca_aead_dir *dir = &ctx->dir[enc ? 1 : 0];
 
     sg_init_table(sg_in, SG_AEAD_LEN);
     sg_init_table(sg_out, SG_AEAD_LEN);
@@ -238,7 +291,12 @@ int libspdm_aead_prealloced(void *context,
     if(!enc)
         memcpy(ctx->tag, tag, tag_size);
 
-    rc = lkca_aead_internal(ctx->aead, ctx->req, key, key_size, iv, iv_size,
+    rc = lkca_aead_dir_setkey(dir, key, key_size);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = lkca_aead_internal(dir->aead, dir->req, NULL, key_size, iv, iv_size,
                             sg_in, sg_out, a_data_size, data_in_size,
                             data_out_size, tag_size, enc);
 
@@ -95,6 +95,16 @@ typedef struct nv_dma_buf_file_private
     NvBool                   static_phys_addrs;
 } nv_dma_buf_file_private_t;
 
+//
+// Mapping of an attachment cached by its first map, see nv_dma_buf_map().
+// Stored in attachment->priv, and protected by the lock of the dma-buf.
+//
+typedef struct nv_dma_buf_attachment_private
+{
+    struct sg_table         *sgt;
+    enum dma_data_direction  direction;
+} nv_dma_buf_attachment_private_t;
+
 static void
 nv_dma_buf_free_file_private(
     nv_dma_buf_file_private_t *priv
@@ -587,6 +597,167 @@ nv_dma_buf_unmap_pfns(
     }
 }
 
+//
+// Iterator over the phys ranges of all the handles of a dma-buf, which merges
+// physically contiguous ranges, including across handles, and splits the
+// merged runs into segments of at most max_seg_size bytes. Runs longer than
+// that are split at 512MB, or else 2MB, aligned addresses when possible, so
+// importers that map the segments with large pages can use them.
+//
+typedef struct nv_dma_buf_seg_iter
+{
+    nv_dma_buf_file_private_t *priv;
+    NvU64                      max_seg_size;
+
+    // Next phys range to merge into a run
+    NvU32                      handle_index;
+    NvU32                      range_index;
+
+    // Remainder of the current run
+    NvU64                      run_addr;
+    NvU64                      run_len;
+} nv_dma_buf_seg_iter_t;
+
+static void
+nv_dma_buf_seg_iter_init(
+    nv_dma_buf_seg_iter_t *iter,
+    nv_dma_buf_file_private_t *priv,
+    NvU64 max_seg_size
+)
+{
+    os_mem_set(iter, 0, sizeof(*iter));
+    iter->priv = priv;
+    iter->max_seg_size = max_seg_size;
+}
+
+static nv_phys_addr_range_t*
+nv_dma_buf_seg_iter_next_range(
+    nv_dma_buf_seg_iter_t *iter
+)
+{
+    nv_dma_buf_file_private_t *priv = iter->priv;
+
+    while (iter->handle_index < priv->num_objects)
+    {
+        nv_dma_buf_mem_handle_t *handle = &priv->handles[iter->handle_index];
+
+        if (iter->range_index < handle->phys_range_count)
+        {
+            return &handle->phys_range[iter->range_index];
+        }
+
+        iter->handle_index++;
+        iter->range_index = 0;
+    }
+
+    return NULL;
+}
+
+static NvBool
+nv_dma_buf_seg_iter_next(
+    nv_dma_buf_seg_iter_t *iter,
+    NvU64 *addr,
+    NvU64 *len
+)
+{
+    static const NvU64 seg_aligns[] = { 512ULL << 20, 2ULL << 20, PAGE_SIZE };
+    NvU64 seg_len = 0;
+    NvU32 i;
+
+    if (iter->run_len == 0)
+    {
+        nv_phys_addr_range_t *range;
+
+        while ((range = nv_dma_buf_seg_iter_next_range(iter)) != NULL)
+        {
+            if ((iter->run_len != 0) &&
+                (range->addr != (iter->run_addr + iter->run_len)))
+            {
+                break;
+            }
+
+            if (iter->run_len == 0)
+            {
+                iter->run_addr = range->addr;
+            }
+
+            iter->run_len += range->len;
+            iter->range_index++;
+        }
+
+        if (iter->run_len == 0)
+        {
+            return NV_FALSE;
+        }
+    }
+
+    if (iter->run_len <= iter->max_seg_size)
+    {
+        seg_len = iter->run_len;
+    }
+    else
+    {
+        for (i = 0; i < ARRAY_SIZE(seg_aligns); i++)
+        {
+            NvU64 seg_end = NV_ALIGN_DOWN(iter->run_addr + iter->max_seg_size,
+                                          seg_aligns[i]);
+
+            if (seg_end > iter->run_addr)
+            {
+                seg_len = seg_end - iter->run_addr;
+                break;
+            }
+        }
+    }
+
+    *addr = iter->run_addr;
+    *len = seg_len;
+
+    iter->run_addr += seg_len;
+    iter->run_len -= seg_len;
+
+    return NV_TRUE;
+}
+
+static NvU32
+nv_dma_buf_count_segs(
+    nv_dma_buf_file_private_t *priv,
+    NvU64 max_seg_size
+)
+{
+    nv_dma_buf_seg_iter_t iter;
+    NvU64 addr, len;
+    NvU32 nents = 0;
+
+    nv_dma_buf_seg_iter_init(&iter, priv, max_seg_size);
+
+    while (nv_dma_buf_seg_iter_next(&iter, &addr, &len))
+    {
+        nents++;
+    }
+
+    return nents;
+}
+
+static void
+nv_dma_buf_print_segs(
+    nv_dma_buf_file_private_t *priv,
+    struct sg_table *sgt
+)
+{
+    NvU32 range_count = 0;
+    NvU32 i;
+
+    for (i = 0; i < priv->num_objects; i++)
+    {
+        range_count += priv->handles[i].phys_range_count;
+    }
+
+    nv_printf(NV_DBG_INFO,
+              "NVRM: dma-buf of 0x%llx bytes mapped with %u sg segments "
+              "(%u phys ranges)\n", priv->total_size, sgt->nents, range_count);
+}
+
 static struct sg_table*
 nv_dma_buf_map_pages (
     struct device *dev,
@@ -595,15 +766,17 @@ nv_dma_buf_map_pages (
 {
     struct sg_table *sgt = NULL;
     struct scatterlist *sg;
+    nv_dma_buf_seg_iter_t iter;
+    NvU64 max_seg_size;
+    NvU64 addr, len;
     NvU32 nents = 0;
-    NvU32 i;
     int rc;
 
+    // sg entries are limited to 4GB. dma_map_sg() further splits them as needed.
+    max_seg_size = NV_ALIGN_DOWN((NvU64)UINT_MAX, PAGE_SIZE);
+
     // Calculate nents needed to allocate sg_table
-    for (i = 0; i < priv->num_objects; i++)
-    {
-        nents += priv->handles[i].phys_range_count;
-    }
+    nents = nv_dma_buf_count_segs(priv, max_seg_size);
 
     NV_KZALLOC(sgt, sizeof(struct sg_table));
     if (sgt == NULL)
@@ -619,24 +792,19 @@ nv_dma_buf_map_pages (
 
     sg = sgt->sgl;
 
-    for (i = 0; i < priv->num_objects; i++)
-    {
-        NvU32 range_count = priv->handles[i].phys_range_count;
-        NvU32 index = 0;
-        for (index = 0; index < range_count; index++)
-        {
-            NvU64 addr = priv->handles[i].phys_range[index].addr;
-            NvU64 len  = priv->handles[i].phys_range[index].len;
-            struct page *page = NV_GET_PAGE_STRUCT(addr);
+    nv_dma_buf_seg_iter_init(&iter, priv, max_seg_size);
 
-            if ((page == NULL) || (sg == NULL))
-            {
-                goto free_table;
-            }
+    while (nv_dma_buf_seg_iter_next(&iter, &addr, &len))
+    {
+        struct page *page = NV_GET_PAGE_STRUCT(addr);
 
-            sg_set_page(sg, page, len, 0);
-            sg = sg_next(sg);
+        if ((page == NULL) || (sg == NULL))
+        {
+            goto free_table;
         }
+
+        sg_set_page(sg, page, len, 0);
+        sg = sg_next(sg);
     }
 
     // DMA map the sg_table
@@ -647,6 +815,8 @@ nv_dma_buf_map_pages (
     }
     sgt->nents = rc;
 
+    nv_dma_buf_print_segs(priv, sgt);
+
     return sgt;
 
 free_table:
@@ -668,10 +838,11 @@ nv_dma_buf_map_pfns (
     struct sg_table *sgt = NULL;
     struct scatterlist *sg;
     nv_dma_device_t peer_dma_dev = {{ 0 }};
+    nv_dma_buf_seg_iter_t iter;
     NvU32 dma_max_seg_size;
+    NvU64 dma_addr, dma_len;
     NvU32 nents = 0;
     NvU32 mapped_nents = 0;
-    NvU32 i = 0;
     int rc = 0;
 
     peer_dma_dev.dev = dev;
@@ -685,19 +856,7 @@ nv_dma_buf_map_pfns (
     }
 
     // Calculate nents needed to allocate sg_table
-    for (i = 0; i < priv->num_objects; i++)
-    {
-        NvU32 range_count = priv->handles[i].phys_range_count;
-        NvU32 index;
-
-        for (index = 0; index < range_count; index++)
-        {
-            NvU64 length = priv->handles[i].phys_range[index].len;
-            NvU64 count = length + dma_max_seg_size - 1;
-            do_div(count, dma_max_seg_size);
-            nents += count;
-        }
-    }
+    nents = nv_dma_buf_count_segs(priv, dma_max_seg_size);
 
     NV_KZALLOC(sgt, sizeof(struct sg_table));
     if (sgt == NULL)
@@ -712,47 +871,36 @@ nv_dma_buf_map_pfns (
     }
 
     sg = sgt->sgl;
-    for (i = 0; i < priv->num_objects; i++)
-    {
-        NvU32 range_count = priv->handles[i].phys_range_count;
-        NvU32 index = 0;
 
-        for (index = 0; index < range_count; index++)
+    // Break the scatterlist into dma_max_seg_size chunks
+    nv_dma_buf_seg_iter_init(&iter, priv, dma_max_seg_size);
+
+    while (nv_dma_buf_seg_iter_next(&iter, &dma_addr, &dma_len))
+    {
+        if (sg == NULL)
         {
-            NvU64 dma_addr = priv->handles[i].phys_range[index].addr;
-            NvU64 dma_len  = priv->handles[i].phys_range[index].len;
+            goto unmap_pfns;
+        }
 
-            // Break the scatterlist into dma_max_seg_size chunks
-            while(dma_len != 0)
-            {
-                NvU32 sg_len = NV_MIN(dma_len, dma_max_seg_size);
-
-                if (sg == NULL)
-                {
-                    goto unmap_pfns;
-                }
-
-                status = nv_dma_map_peer(&peer_dma_dev, priv->nv->dma_dev, 0x1,
-                                         (sg_len >> PAGE_SHIFT), &dma_addr);
-                if (status != NV_OK)
-                {
-                    goto unmap_pfns;
-                }
-
-                sg_set_page(sg, NULL, sg_len, 0);
-                sg_dma_address(sg) = (dma_addr_t) dma_addr;
-                sg_dma_len(sg) = sg_len;
-                dma_addr += sg_len;
-                dma_len -= sg_len;
-                mapped_nents++;
-                sg = sg_next(sg);
-            }
+        status = nv_dma_map_peer(&peer_dma_dev, priv->nv->dma_dev, 0x1,
+                                 (dma_len >> PAGE_SHIFT), &dma_addr);
+        if (status != NV_OK)
+        {
+            goto unmap_pfns;
         }
+
+        sg_set_page(sg, NULL, dma_len, 0);
+        sg_dma_address(sg) = (dma_addr_t) dma_addr;
+        sg_dma_len(sg) = dma_len;
+        mapped_nents++;
+        sg = sg_next(sg);
     }
     sgt->nents = mapped_nents;
 
     WARN_ON(sgt->nents != sgt->orig_nents);
 
+    nv_dma_buf_print_segs(priv, sgt);
+
     return sgt;
 
 unmap_pfns:
@@ -768,6 +916,36 @@ free_sgt:
     return NULL;
 }
 
+static void
+nv_dma_buf_unmap_sgt_locked(
+    struct dma_buf_attachment *attachment,
+    nv_dma_buf_file_private_t *priv,
+    struct sg_table *sgt
+)
+{
+    if (priv->nv->coherent)
+    {
+        nv_dma_buf_unmap_pages(attachment->dev, sgt);
+    }
+    else
+    {
+        nv_dma_buf_unmap_pfns(attachment->dev, sgt);
+    }
+
+    //
+    // For static_phys_addrs platforms, this operation is done in release
+    // since getting the phys_addrs was done in create/reuse.
+    //
+    if (!priv->static_phys_addrs)
+    {
+        nv_dma_buf_put_phys_addresses(priv, 0, priv->num_objects);
+    }
+
+    sg_free_table(sgt);
+
+    NV_KFREE(sgt, sizeof(struct sg_table));
+}
+
 static struct sg_table*
 nv_dma_buf_map(
     struct dma_buf_attachment *attachment,
@@ -778,6 +956,7 @@ nv_dma_buf_map(
     struct sg_table *sgt = NULL;
     struct dma_buf *buf = attachment->dmabuf;
     nv_dma_buf_file_private_t *priv = buf->priv;
+    nv_dma_buf_attachment_private_t *attach_priv;
 
     //
     // On non-coherent platforms, importers must be able to handle peer
@@ -797,6 +976,22 @@ nv_dma_buf_map(
 
     mutex_lock(&priv->lock);
 
+    //
+    // The sg table built and DMA mapped by the first map of an attachment is
+    // reused by the following maps in the same direction, until the
+    // attachment is detached. Importers that map and unmap around each
+    // transfer would otherwise pay for the phys address lookup and the DMA
+    // mapping every time. The exported memory never moves, so the cached
+    // mapping never needs to be invalidated before detach. Maps in another
+    // direction get a mapping of their own, torn down by their unmap.
+    //
+    attach_priv = attachment->priv;
+    if ((attach_priv != NULL) && (attach_priv->direction == direction))
+    {
+        sgt = attach_priv->sgt;
+        goto unlock_priv;
+    }
+
     if (priv->num_objects != priv->total_objects)
     {
         goto unlock_priv;
@@ -824,6 +1019,21 @@ nv_dma_buf_map(
         goto unmap_handles;
     }
 
+    //
+    // Failing to allocate the cache entry is not fatal: the mapping is then
+    // torn down by its unmap, as maps in other directions are.
+    //
+    if (attach_priv == NULL)
+    {
+        NV_KZALLOC(attach_priv, sizeof(nv_dma_buf_attachment_private_t));
+        if (attach_priv != NULL)
+        {
+            attach_priv->sgt = sgt;
+            attach_priv->direction = direction;
+            attachment->priv = attach_priv;
+        }
+    }
+
     mutex_unlock(&priv->lock);
 
     return sgt;
@@ -837,7 +1047,7 @@ unmap_handles:
 unlock_priv:
     mutex_unlock(&priv->lock);
 
-    return NULL;
+    return sgt;
 }
 
 static void
@@ -849,34 +1059,72 @@ nv_dma_buf_unmap(
 {
     struct dma_buf *buf = attachment->dmabuf;
     nv_dma_buf_file_private_t *priv = buf->priv;
+    nv_dma_buf_attachment_private_t *attach_priv;
 
     mutex_lock(&priv->lock);
 
-    if (priv->nv->coherent)
-    {
-        nv_dma_buf_unmap_pages(attachment->dev, sgt);
-    }
-    else
-    {
-        nv_dma_buf_unmap_pfns(attachment->dev, sgt);
-    }
-
     //
-    // For static_phys_addrs platforms, this operation is done in release
-    // since getting the phys_addrs was done in create/reuse.
+    // The cached sg table stays mapped in the attachment, see
+    // nv_dma_buf_map(). It is unmapped by nv_dma_buf_detach().
     //
-    if (!priv->static_phys_addrs)
+    attach_priv = attachment->priv;
+    if ((attach_priv == NULL) || (attach_priv->sgt != sgt))
     {
-        nv_dma_buf_put_phys_addresses(priv, 0, priv->num_objects);
+        nv_dma_buf_unmap_sgt_locked(attachment, priv, sgt);
     }
 
-    sg_free_table(sgt);
+    mutex_unlock(&priv->lock);
+}
 
-    NV_KFREE(sgt, sizeof(struct sg_table));
+static void
+nv_dma_buf_detach(
+    struct dma_buf *buf,
+    struct dma_buf_attachment *attachment
+)
+{
+    nv_dma_buf_file_private_t *priv = buf->priv;
+    nv_dma_buf_attachment_private_t *attach_priv;
+
+    mutex_lock(&priv->lock);
+
+    attach_priv = attachment->priv;
+    if (attach_priv != NULL)
+    {
+        nv_dma_buf_unmap_sgt_locked(attachment, priv, attach_priv->sgt);
+
+        NV_KFREE(attach_priv, sizeof(nv_dma_buf_attachment_private_t));
+
+        attachment->priv = NULL;
+    }
 
     mutex_unlock(&priv->lock);
 }
 
+#if defined(NV_DMA_BUF_OPS_HAS_PIN)
+//
+// Providing pin/unpin makes this a dynamic exporter, so dynamic importers
+// (attached with dma_buf_attach_ops) can keep their mappings without pinning
+// the dma-buf. The exported memory is resident and never moves for the
+// lifetime of the dma-buf, so there is nothing to do to pin it, and
+// dma_buf_move_notify() never needs to be called.
+//
+static int
+nv_dma_buf_pin(
+    struct dma_buf_attachment *attachment
+)
+{
+    return 0;
+}
+
+static void
+nv_dma_buf_unpin(
+    struct dma_buf_attachment *attachment
+)
+{
+    return;
+}
+#endif
+
 static void
 nv_dma_buf_release(
     struct dma_buf *buf
@@ -995,10 +1243,15 @@ nv_dma_buf_kunmap_atomic_stub(
 // f9b67f0014cb: dma-buf: Rename dma-ops to prevent conflict with kunmap_atomic
 //
 static const struct dma_buf_ops nv_dma_buf_ops = {
+    .detach        = nv_dma_buf_detach,
     .map_dma_buf   = nv_dma_buf_map,
     .unmap_dma_buf = nv_dma_buf_unmap,
     .release       = nv_dma_buf_release,
     .mmap          = nv_dma_buf_mmap,
+#if defined(NV_DMA_BUF_OPS_HAS_PIN)
+    .pin           = nv_dma_buf_pin,
+    .unpin         = nv_dma_buf_unpin,
+#endif
 #if defined(NV_DMA_BUF_OPS_HAS_KMAP)
     .kmap          = nv_dma_buf_kmap_stub,
     .kunmap        = nv_dma_buf_kunmap_stub,
@@ -27,6 +27,28 @@
 #include "nv-linux.h"
 #include "nv_speculation_barrier.h"
 
+/*
+ * Framebuffer mappings of the GPU device nodes are mapped with PMD and PUD
+ * sized PFN entries when the kernel supports special huge PFN mappings,
+ * added in Linux 6.12 (CONFIG_ARCH_SUPPORTS_PMD_PFNMAP and
+ * CONFIG_ARCH_SUPPORTS_PUD_PFNMAP). Older kernels do not mark huge PFN
+ * mappings special, and could treat the BAR as struct page backed memory.
+ */
+#if defined(NV_VM_OPS_HUGE_FAULT_HAS_ORDER_ARG) && \
+    defined(NV_VMF_INSERT_PFN_PMD_PRESENT) && \
+    defined(CONFIG_ARCH_SUPPORTS_PMD_PFNMAP) && \
+    !defined(NV_XEN_SUPPORT_FULLY_VIRTUALIZED_KERNEL)
+#define NV_HUGE_PFNMAP_SUPPORTED 1
+#include <linux/huge_mm.h>
+#if defined(NV_VMF_INSERT_PFN_PMD_HAS_PFN_T_ARG)
+#include <linux/pfn_t.h>
+#endif
+#if defined(NV_VMF_INSERT_PFN_PUD_PRESENT) && \
+    defined(CONFIG_ARCH_SUPPORTS_PUD_PFNMAP)
+#define NV_HUGE_PFNMAP_PUD_SUPPORTED 1
+#endif
+#endif
+
 /*
  * The 'struct vm_operations' open() callback is called by the Linux
  * kernel when the parent VMA is split or copied, close() when the
@@ -198,40 +220,98 @@ nvidia_vma_access(
     return length;
 }
 
-static vm_fault_t nvidia_fault(
-#if !defined(NV_VM_OPS_FAULT_REMOVED_VMA_ARG)
-    struct vm_area_struct *vma,
-#endif
-    struct vm_fault *vmf
+/*
+ * Returns whether the VMA of a GPU device node may be mapped with huge PFN
+ * entries: only framebuffer mappings qualify, since register mappings are
+ * small and uncached, and the PPC64LE page isolation workaround needs 4K
+ * entries. With the GPU memory onlined as NUMA memory, the mapping is
+ * populated through vm_insert_page() instead.
+ *
+ * Skipping nv_io_remap_page_range() at mmap() time also skips its PAT memory
+ * type reservation, and the PFNs inserted at fault time then take the memory
+ * type tracked for the BAR, UC-. Write-combined and cached mappings therefore
+ * keep being remapped up front with 4K entries.
+ */
+static NvBool nv_vma_huge_pfnmap_allowed(
+    nv_linux_state_t *nvl,
+    const nv_alloc_mapping_context_t *mmap_context,
+    struct vm_area_struct *vma
 )
 {
-#if defined(NV_VM_OPS_FAULT_REMOVED_VMA_ARG)
-    struct vm_area_struct *vma = vmf->vma;
-#endif
-    nv_linux_file_private_t *nvlfp = NV_GET_LINUX_FILE_PRIVATE(NV_VMA_FILE(vma));
-    nv_linux_state_t *nvl = nvlfp->nvptr;
+#if defined(NV_HUGE_PFNMAP_SUPPORTED)
     nv_state_t *nv = NV_STATE_PTR(nvl);
-    vm_fault_t ret = VM_FAULT_NOPAGE;
 
-    NvU64 page;
-    NvU64 num_pages = NV_VMA_SIZE(vma) >> PAGE_SHIFT;
-    NvU64 pfn_start = (nvlfp->mmap_context.mmap_start >> PAGE_SHIFT);
+    if (NV_IS_CTL_DEVICE(nv) ||
+        (mmap_context->remap_prot_extra != 0) ||
+        ((vma->vm_flags & VM_SHARED) == 0) ||
+        (nv_get_numa_status(nvl) == NV_NUMA_STATUS_ONLINE))
+    {
+        return NV_FALSE;
+    }
 
-    if (vma->vm_pgoff != 0)
+    if ((mmap_context->caching != NV_MEMORY_UNCACHED) &&
+        !IS_UD_OFFSET(nv, mmap_context->access_start,
+                      mmap_context->access_size) &&
+        !rm_disable_iomap_wc())
     {
-        return VM_FAULT_SIGBUS;
+        return NV_FALSE;
     }
 
-    // Mapping revocation is only supported for GPU mappings.
-    if (NV_IS_CTL_DEVICE(nv))
+    return IS_FB_OFFSET(nv, mmap_context->access_start,
+                        mmap_context->access_size);
+#else
+    return NV_FALSE;
+#endif
+}
+
+#if defined(NV_HUGE_PFNMAP_SUPPORTED)
+/*
+ * Returns whether the naturally aligned 2^shift byte region containing
+ * virt_addr lies within the VMA and is backed by a 2^shift aligned physical
+ * range, in which case *pfn is set to the first PFN of the region.
+ */
+static NvBool nv_vma_huge_pfn_range(
+    struct vm_area_struct *vma,
+    NvU64 pfn_start,
+    NvU64 virt_addr,
+    unsigned int shift,
+    NvU64 *pfn
+)
+{
+    NvU64 size = 1ULL << shift;
+    NvU64 start = virt_addr & ~(size - 1);
+
+    if ((start < vma->vm_start) || ((start + size) > vma->vm_end))
     {
-        return VM_FAULT_SIGBUS;
+        return NV_FALSE;
     }
 
+    *pfn = pfn_start + ((start - vma->vm_start) >> PAGE_SHIFT);
+
+    return ((*pfn & ((size >> PAGE_SHIFT) - 1)) == 0);
+}
+#endif
+
+/*
+ * Takes nv_system_pm_lock and nvl->mmap_lock before mappings are reinstated
+ * by a fault, and wakes up the GPU if it is not currently safe to mmap.
+ * Returns NV_TRUE with both locks held if the fault may map the VMA, or
+ * NV_FALSE with no locks held and *ret set to the value to return from the
+ * fault handler.
+ */
+static NvBool nv_fault_begin(
+    nv_linux_state_t *nvl,
+    vm_fault_t *ret
+)
+{
+    nv_state_t *nv = NV_STATE_PTR(nvl);
+
+    *ret = VM_FAULT_NOPAGE;
+
     // Wake up GPU and reinstate mappings only if we are not in S3/S4 entry
     if (!down_read_trylock(&nv_system_pm_lock))
     {
-        return VM_FAULT_NOPAGE;
+        return NV_FALSE;
     }
 
     down(&nvl->mmap_lock);
@@ -246,7 +326,7 @@ static vm_fault_t nvidia_fault(
             // GPU wakeup callback already scheduled.
             up(&nvl->mmap_lock);
             up_read(&nv_system_pm_lock);
-            return VM_FAULT_NOPAGE;
+            return NV_FALSE;
         }
 
         /*
@@ -260,22 +340,123 @@ static vm_fault_t nvidia_fault(
                       "NVRM: VM: rm_schedule_gpu_wakeup failed: %x\n", status);
             up(&nvl->mmap_lock);
             up_read(&nv_system_pm_lock);
-            return VM_FAULT_SIGBUS;
+            *ret = VM_FAULT_SIGBUS;
+            return NV_FALSE;
         }
         // Ensure that we do not schedule duplicate GPU wakeup callbacks.
         nvl->gpu_wakeup_callback_needed = NV_FALSE;
 
         up(&nvl->mmap_lock);
         up_read(&nv_system_pm_lock);
-        return VM_FAULT_NOPAGE;
+        return NV_FALSE;
     }
 
-    // Safe to mmap, map all pages in this VMA.
-    for (page = 0; page < num_pages; page++)
+    return NV_TRUE;
+}
+
+static void nv_fault_end(
+    nv_linux_state_t *nvl
+)
+{
+    up(&nvl->mmap_lock);
+    up_read(&nv_system_pm_lock);
+}
+
+static vm_fault_t nvidia_fault(
+#if !defined(NV_VM_OPS_FAULT_REMOVED_VMA_ARG)
+    struct vm_area_struct *vma,
+#endif
+    struct vm_fault *vmf
+)
+{
+#if defined(NV_VM_OPS_FAULT_REMOVED_VMA_ARG)
+    struct vm_area_struct *vma = vmf->vma;
+#endif
+    nv_linux_file_private_t *nvlfp = NV_GET_LINUX_FILE_PRIVATE(NV_VMA_FILE(vma));
+    nv_linux_state_t *nvl = nvlfp->nvptr;
+    nv_state_t *nv = NV_STATE_PTR(nvl);
+    vm_fault_t ret = VM_FAULT_NOPAGE;
+
+    NvU64 page;
+    NvU64 num_pages = NV_VMA_SIZE(vma) >> PAGE_SHIFT;
+    NvU64 pfn_start = (nvlfp->mmap_context.mmap_start >> PAGE_SHIFT);
+    NvU64 fault_addr = nv_page_fault_va(vmf);
+    NvU64 first_page = 0;
+    NvU64 end_page = num_pages;
+    NvU64 mapped_pages = 0;
+#if defined(NV_HUGE_PFNMAP_SUPPORTED)
+    NvBool huge_pfnmap;
+#endif
+
+    if (vma->vm_pgoff != 0)
+    {
+        return VM_FAULT_SIGBUS;
+    }
+
+    /*
+     * With a fault window configured, only the naturally aligned window of
+     * the virtual address space containing the faulting address is mapped,
+     * clipped to the VMA, and the rest of the VMA is mapped by later faults,
+     * as it is touched. Otherwise the whole VMA is mapped. Aligning on the
+     * virtual address keeps the window boundaries on PMD boundaries for
+     * windows that are a multiple of the PMD size.
+     */
+    if (NVreg_MmapFaultWindowSize != 0)
+    {
+        NvU64 window_size = (NvU64)NVreg_MmapFaultWindowSize << 20;
+        NvU64 window_start = fault_addr - (fault_addr % window_size);
+        NvU64 window_end = window_start + window_size;
+
+        if (window_start > vma->vm_start)
+        {
+            first_page = (window_start - vma->vm_start) >> PAGE_SHIFT;
+        }
+
+        end_page = min(num_pages, (window_end - vma->vm_start) >> PAGE_SHIFT);
+    }
+
+    // Mapping revocation is only supported for GPU mappings.
+    if (NV_IS_CTL_DEVICE(nv))
+    {
+        return VM_FAULT_SIGBUS;
+    }
+
+    if (!nv_fault_begin(nvl, &ret))
+    {
+        return ret;
+    }
+
+#if defined(NV_HUGE_PFNMAP_SUPPORTED)
+    huge_pfnmap = nv_vma_huge_pfnmap_allowed(nvl, &nvlfp->mmap_context, vma);
+#endif
+
+    // Safe to mmap, map all pages in this VMA or fault window.
+    for (page = first_page; page < end_page; page++)
     {
         NvU64 virt_addr = vma->vm_start + (page << PAGE_SHIFT);
         NvU64 pfn = pfn_start + page;
 
+#if defined(NV_HUGE_PFNMAP_SUPPORTED)
+        /*
+         * Leave the regions that can be mapped with a PMD entry to
+         * nvidia_huge_fault(), since populating a page table for them here
+         * would prevent their huge mapping. The faulting region is mapped
+         * regardless: the kernel already chose not to map it huge.
+         */
+        if (huge_pfnmap &&
+            ((virt_addr & PMD_MASK) != (fault_addr & PMD_MASK)))
+        {
+            NvU64 huge_pfn;
+
+            if (nv_vma_huge_pfn_range(vma, pfn_start, virt_addr, PMD_SHIFT,
+                                      &huge_pfn))
+            {
+                page += (PMD_SIZE >> PAGE_SHIFT) - 1;
+                continue;
+            }
+        }
+#endif
+
         ret = nv_insert_pfn(vma, virt_addr, pfn,
                             nvlfp->mmap_context.remap_prot_extra);
         if (ret != VM_FAULT_NOPAGE)
@@ -286,17 +467,97 @@ static vm_fault_t nvidia_fault(
         }
 
         nvl->all_mappings_revoked = NV_FALSE;
+        mapped_pages++;
     }
-    up(&nvl->mmap_lock);
-    up_read(&nv_system_pm_lock);
+
+    nvl->mmap_fault_stats.faults++;
+    nvl->mmap_fault_stats.mapped_pages += mapped_pages;
+
+    nv_fault_end(nvl);
 
     return ret;
 }
 
+#if defined(NV_HUGE_PFNMAP_SUPPORTED)
+static vm_fault_t nvidia_huge_fault(
+    struct vm_fault *vmf,
+    unsigned int order
+)
+{
+    struct vm_area_struct *vma = vmf->vma;
+    nv_linux_file_private_t *nvlfp = NV_GET_LINUX_FILE_PRIVATE(NV_VMA_FILE(vma));
+    nv_linux_state_t *nvl = nvlfp->nvptr;
+    NvU64 pfn_start = (nvlfp->mmap_context.mmap_start >> PAGE_SHIFT);
+    NvBool write = !!(vmf->flags & FAULT_FLAG_WRITE);
+    unsigned int shift = order + PAGE_SHIFT;
+    vm_fault_t ret = VM_FAULT_FALLBACK;
+    NvU64 pfn;
+
+    if ((vma->vm_pgoff != 0) ||
+        !nv_vma_huge_pfnmap_allowed(nvl, &nvlfp->mmap_context, vma))
+    {
+        return VM_FAULT_FALLBACK;
+    }
+
+    if ((shift != PMD_SHIFT)
+#if defined(NV_HUGE_PFNMAP_PUD_SUPPORTED)
+        && (shift != PUD_SHIFT)
+#endif
+       )
+    {
+        return VM_FAULT_FALLBACK;
+    }
+
+    if (!nv_vma_huge_pfn_range(vma, pfn_start, vmf->address, shift, &pfn))
+    {
+        return VM_FAULT_FALLBACK;
+    }
+
+    if (!nv_fault_begin(nvl, &ret))
+    {
+        return ret;
+    }
+
+#if defined(NV_HUGE_PFNMAP_PUD_SUPPORTED)
+    if (shift == PUD_SHIFT)
+    {
+#if defined(NV_VMF_INSERT_PFN_PMD_HAS_PFN_T_ARG)
+        ret = vmf_insert_pfn_pud(vmf, __pfn_to_pfn_t(pfn, PFN_DEV), write);
+#else
+        ret = vmf_insert_pfn_pud(vmf, pfn, write);
+#endif
+    }
+    else
+#endif
+    {
+#if defined(NV_VMF_INSERT_PFN_PMD_HAS_PFN_T_ARG)
+        ret = vmf_insert_pfn_pmd(vmf, __pfn_to_pfn_t(pfn, PFN_DEV), write);
+#else
+        ret = vmf_insert_pfn_pmd(vmf, pfn, write);
+#endif
+    }
+
+    if (ret == VM_FAULT_NOPAGE)
+    {
+        nvl->all_mappings_revoked = NV_FALSE;
+        nvl->mmap_fault_stats.mapped_pages += 1ULL << order;
+    }
+
+    nvl->mmap_fault_stats.faults++;
+
+    nv_fault_end(nvl);
+
+    return ret;
+}
+#endif
+
 static struct vm_operations_struct nv_vm_ops = {
     .open   = nvidia_vma_open,
     .close  = nvidia_vma_release,
     .fault  = nvidia_fault,
+#if defined(NV_HUGE_PFNMAP_SUPPORTED)
+    .huge_fault = nvidia_huge_fault,
+#endif
     .access = nvidia_vma_access,
 };
 
@@ -570,6 +831,7 @@ int nvidia_mmap_helper(
         }
 
         down(&nvl->mmap_lock);
+        nvl->mmap_fault_stats.mmapped_pages += mmap_length >> PAGE_SHIFT;
         if (nvl->safe_to_mmap)
         {
             nvl->all_mappings_revoked = NV_FALSE;
@@ -590,8 +852,14 @@ int nvidia_mmap_helper(
             }
             else
             {
-                if (nv_io_remap_page_range(vma, mmap_start, mmap_length,
-                        remap_prot_extra) != 0)
+                //
+                // Mappings that can use huge PFN entries are left unpopulated,
+                // and mapped on first access by nvidia_huge_fault() and
+                // nvidia_fault(), as revoked mappings are.
+                //
+                if (!nv_vma_huge_pfnmap_allowed(nvl, mmap_context, vma) &&
+                    (nv_io_remap_page_range(vma, mmap_start, mmap_length,
+                        remap_prot_extra) != 0))
                 {
                     up(&nvl->mmap_lock);
                     return -EAGAIN;
@@ -758,6 +1026,11 @@ nv_revoke_gpu_mappings_locked(
         unmap_mapping_range(&nvlfp->mapping, 0, ~0, 1);
     }
 
+    if (!nvl->all_mappings_revoked)
+    {
+        nvl->mmap_fault_stats.revocations++;
+    }
+
     nvl->all_mappings_revoked = NV_TRUE;
 }
 
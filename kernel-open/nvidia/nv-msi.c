@@ -145,6 +145,7 @@ NvS32 NV_API_CALL nv_request_msix_irq(nv_linux_state_t *nvl)
     struct msix_entry *msix_entries;
     int rc = NV_ERR_INVALID_ARGUMENT;
     nv_state_t *nv = NV_STATE_PTR(nvl);
+    int node = dev_to_node(nvl->dev);
 
     for (i = 0, msix_entries = nvl->msix_entries; i < nvl->num_intr;
          i++, msix_entries++)
@@ -156,10 +157,18 @@ NvS32 NV_API_CALL nv_request_msix_irq(nv_linux_state_t *nvl)
         {
             for( j = 0; j < i; j++)
             {
+                irq_set_affinity_hint(nvl->msix_entries[j].vector, NULL);
                 free_irq(nvl->msix_entries[j].vector, (void *)nvl);
             }
             break;
         }
+
+        /*
+         * Spread the vectors over the CPUs closest to the GPU, so that
+         * interrupt load from different engines doesn't all land on one CPU.
+         */
+        irq_set_affinity_hint(msix_entries->vector,
+                              cpumask_of(cpumask_local_spread(i, node)));
     }
 
     return rc;
@@ -36,6 +36,15 @@
 #define NV_NANO_TIMER_USE_HRTIMER 0
 #endif  // !defined(NVCPU_PPC64LE)
 
+//
+// RM's timer callbacks tolerate firing a little late, so give the kernel a
+// slack window of 1/8th of the timeout (the same granularity as the jiffy
+// timer wheel), capped at 1ms. This lets it coalesce our wakeups with other
+// timers on the CPU instead of waking up for each one separately.
+//
+#define NV_NANO_TIMER_SLACK_SHIFT  3
+#define NV_NANO_TIMER_MAX_SLACK_NS NSEC_PER_MSEC
+
 struct nv_nano_timer
 {
 #if NV_NANO_TIMER_USE_HRTIMER
@@ -183,7 +192,11 @@ void NV_API_CALL nv_start_nano_timer(
 {
 #if NV_NANO_TIMER_USE_HRTIMER
     ktime_t ktime = ktime_set(0, time_ns);
-    hrtimer_start(&nv_nstimer->hr_timer, ktime, HRTIMER_MODE_REL);
+    u64 slack_ns = min_t(u64, time_ns >> NV_NANO_TIMER_SLACK_SHIFT,
+                         NV_NANO_TIMER_MAX_SLACK_NS);
+
+    hrtimer_start_range_ns(&nv_nstimer->hr_timer, ktime, slack_ns,
+                           HRTIMER_MODE_REL);
 #else
     unsigned long time_jiffies;
     NvU32 time_us;
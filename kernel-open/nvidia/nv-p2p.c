@@ -33,6 +33,8 @@
 
 #include "nvmisc.h"
 
+#include <linux/hashtable.h>
+
 typedef enum nv_p2p_page_table_type {
     NV_P2P_PAGE_TABLE_TYPE_NON_PERSISTENT = 0,
     NV_P2P_PAGE_TABLE_TYPE_PERSISTENT,
@@ -41,11 +43,13 @@ typedef enum nv_p2p_page_table_type {
 typedef struct nv_p2p_dma_mapping {
     struct list_head list_node;
     struct nvidia_p2p_dma_mapping *dma_mapping;
+
+    // Number of nvidia_p2p_dma_map_pages() calls sharing dma_mapping
+    NvU32 refcount;
 } nv_p2p_dma_mapping_t;
 
 typedef struct nv_p2p_mem_info {
-    void (*free_callback)(void *data);
-    void *data;
+    // Page table known to RM. Callers get the copies in their refs.
     struct nvidia_p2p_page_table page_table;
     struct {
         struct list_head list_head;
@@ -53,8 +57,52 @@ typedef struct nv_p2p_mem_info {
     } dma_mapping_list;
     void *private;
     void *mig_info;
+
+    //
+    // The following fields are protected by nv_p2p_cache_lock.
+    //
+    // List of nv_p2p_page_table_ref_t handed out for this page table.
+    //
+    struct list_head refs;
+
+    //
+    // Non-persistent page tables are added to nv_p2p_page_table_cache and
+    // shared by the nvidia_p2p_get_pages() calls of the same process with the
+    // same arguments, until they are put or freed by RM.
+    //
+    struct hlist_node cache_node;
+    NvBool cached;
+    struct mm_struct *mm;
+    uint64_t p2p_token;
+    uint32_t va_space;
+    uint64_t virtual_address;
+    uint64_t length;
 } nv_p2p_mem_info_t;
 
+//
+// Reference to a shared nv_p2p_mem_info_t, one per nvidia_p2p_get_pages*()
+// call. The page table returned to the caller is the copy embedded here, so
+// that nvidia_p2p_put_pages() and the free callback are tracked per caller.
+//
+typedef struct nv_p2p_page_table_ref {
+    struct hlist_node hash_node;
+    struct list_head list_node;
+    nv_p2p_mem_info_t *mem_info;
+    void (*free_callback)(void *data);
+    void *data;
+    struct nvidia_p2p_page_table page_table;
+} nv_p2p_page_table_ref_t;
+
+#define NV_P2P_CACHE_HASH_BITS 8
+
+// Cached page tables, hashed by virtual address
+static DEFINE_HASHTABLE(nv_p2p_page_table_cache, NV_P2P_CACHE_HASH_BITS);
+
+// Live page table refs, hashed by the address of their page table
+static DEFINE_HASHTABLE(nv_p2p_page_table_refs, NV_P2P_CACHE_HASH_BITS);
+
+static NV_DEFINE_SPINLOCK(nv_p2p_cache_lock);
+
 // declared and created in nv.c
 extern void *nvidia_p2p_page_t_cache;
 
@@ -117,6 +165,147 @@ static NV_STATUS nvidia_p2p_map_page_size(NvU32 page_size, NvU32 *page_size_inde
     return NV_OK;
 }
 
+static nv_p2p_page_table_ref_t* nv_p2p_alloc_page_table_ref(
+    void (*free_callback)(void *data),
+    void *data
+)
+{
+    nv_p2p_page_table_ref_t *ref;
+
+    if (os_alloc_mem((void **)&ref, sizeof(*ref)) != NV_OK)
+    {
+        return NULL;
+    }
+
+    memset(ref, 0, sizeof(*ref));
+    ref->free_callback = free_callback;
+    ref->data = data;
+
+    return ref;
+}
+
+// Must be called with nv_p2p_cache_lock held
+static void nv_p2p_add_page_table_ref_locked(
+    nv_p2p_mem_info_t *mem_info,
+    nv_p2p_page_table_ref_t *ref
+)
+{
+    ref->mem_info = mem_info;
+    ref->page_table = mem_info->page_table;
+
+    list_add_tail(&ref->list_node, &mem_info->refs);
+    hash_add(nv_p2p_page_table_refs, &ref->hash_node,
+             (unsigned long)&ref->page_table);
+}
+
+// Must be called with nv_p2p_cache_lock held
+static void nv_p2p_remove_page_table_ref_locked(
+    nv_p2p_page_table_ref_t *ref
+)
+{
+    hash_del(&ref->hash_node);
+    list_del(&ref->list_node);
+}
+
+//
+// Looks up the ref of a page table returned by nvidia_p2p_get_pages*(),
+// without dereferencing it, since it is freed once RM frees the pages.
+//
+// Must be called with nv_p2p_cache_lock held
+//
+static nv_p2p_page_table_ref_t* nv_p2p_find_page_table_ref_locked(
+    struct nvidia_p2p_page_table *page_table
+)
+{
+    nv_p2p_page_table_ref_t *ref;
+
+    hash_for_each_possible(nv_p2p_page_table_refs, ref, hash_node,
+                           (unsigned long)page_table)
+    {
+        if (&ref->page_table == page_table)
+        {
+            return ref;
+        }
+    }
+
+    return NULL;
+}
+
+static nv_p2p_mem_info_t* nv_p2p_page_table_mem_info(
+    struct nvidia_p2p_page_table *page_table
+)
+{
+    return container_of(page_table, nv_p2p_page_table_ref_t, page_table)->mem_info;
+}
+
+// Must be called with nv_p2p_cache_lock held
+static void nv_p2p_uncache_mem_info_locked(
+    nv_p2p_mem_info_t *mem_info
+)
+{
+    if (mem_info->cached)
+    {
+        hash_del(&mem_info->cache_node);
+        mem_info->cached = NV_FALSE;
+    }
+}
+
+//
+// Returns a new ref to the cached page table of the current process matching
+// the arguments of nvidia_p2p_get_pages(), if any.
+//
+static NvBool nv_p2p_get_cached_pages(
+    uint64_t p2p_token,
+    uint32_t va_space,
+    uint64_t virtual_address,
+    uint64_t length,
+    struct nvidia_p2p_page_table **page_table,
+    void (*free_callback)(void *data),
+    void *data
+)
+{
+    nv_p2p_page_table_ref_t *ref;
+    nv_p2p_mem_info_t *mem_info;
+    unsigned long flags;
+
+    if (!NVreg_P2pPageTableCache)
+    {
+        return NV_FALSE;
+    }
+
+    ref = nv_p2p_alloc_page_table_ref(free_callback, data);
+    if (ref == NULL)
+    {
+        return NV_FALSE;
+    }
+
+    NV_SPIN_LOCK_IRQSAVE(&nv_p2p_cache_lock, flags);
+
+    hash_for_each_possible(nv_p2p_page_table_cache, mem_info, cache_node,
+                           virtual_address)
+    {
+        if ((mem_info->mm == current->mm) &&
+            (mem_info->p2p_token == p2p_token) &&
+            (mem_info->va_space == va_space) &&
+            (mem_info->virtual_address == virtual_address) &&
+            (mem_info->length == length))
+        {
+            nv_p2p_add_page_table_ref_locked(mem_info, ref);
+            *page_table = &ref->page_table;
+
+            NV_SPIN_UNLOCK_IRQRESTORE(&nv_p2p_cache_lock, flags);
+
+            return NV_TRUE;
+        }
+    }
+
+    NV_SPIN_UNLOCK_IRQRESTORE(&nv_p2p_cache_lock, flags);
+
+    os_free_mem(ref);
+
+    return NV_FALSE;
+}
+
 static NV_STATUS nv_p2p_insert_dma_mapping(
     struct nv_p2p_mem_info *mem_info,
     struct nvidia_p2p_dma_mapping *dma_mapping
@@ -134,6 +323,7 @@ static NV_STATUS nv_p2p_insert_dma_mapping(
     down(&mem_info->dma_mapping_list.lock);
 
     node->dma_mapping = dma_mapping;
+    node->refcount = 1;
     list_add_tail(&node->list_node, &mem_info->dma_mapping_list.list_head);
 
     up(&mem_info->dma_mapping_list.lock);
@@ -167,6 +357,69 @@ static struct nvidia_p2p_dma_mapping* nv_p2p_remove_dma_mapping(
     return ret_dma_mapping;
 }
 
+//
+// Returns an existing DMA mapping of the page table for the given peer, with
+// its refcount incremented, or NULL.
+//
+static struct nvidia_p2p_dma_mapping* nv_p2p_get_dma_mapping(
+    struct nv_p2p_mem_info *mem_info,
+    struct pci_dev *peer
+)
+{
+    struct nv_p2p_dma_mapping *cur;
+    struct nvidia_p2p_dma_mapping *ret_dma_mapping = NULL;
+
+    down(&mem_info->dma_mapping_list.lock);
+
+    list_for_each_entry(cur, &mem_info->dma_mapping_list.list_head, list_node)
+    {
+        if (cur->dma_mapping->pci_dev == peer)
+        {
+            cur->refcount++;
+            ret_dma_mapping = cur->dma_mapping;
+            break;
+        }
+    }
+
+    up(&mem_info->dma_mapping_list.lock);
+
+    return ret_dma_mapping;
+}
+
+//
+// Drops a reference on the DMA mapping. Returns dma_mapping if this was the
+// last reference and it got unlinked from mem_info->dma_mapping_list, or NULL
+// if it is still in use or was already unlinked.
+//
+static struct nvidia_p2p_dma_mapping* nv_p2p_put_dma_mapping(
+    struct nv_p2p_mem_info *mem_info,
+    struct nvidia_p2p_dma_mapping *dma_mapping
+)
+{
+    struct nv_p2p_dma_mapping *cur;
+    struct nvidia_p2p_dma_mapping *ret_dma_mapping = NULL;
+
+    down(&mem_info->dma_mapping_list.lock);
+
+    list_for_each_entry(cur, &mem_info->dma_mapping_list.list_head, list_node)
+    {
+        if (dma_mapping == cur->dma_mapping)
+        {
+            if (--cur->refcount == 0)
+            {
+                ret_dma_mapping = cur->dma_mapping;
+                list_del(&cur->list_node);
+                os_free_mem(cur);
+            }
+            break;
+        }
+    }
+
+    up(&mem_info->dma_mapping_list.lock);
+
+    return ret_dma_mapping;
+}
+
 static void nv_p2p_free_dma_mapping(
     struct nvidia_p2p_dma_mapping *dma_mapping
 )
@@ -260,9 +513,29 @@ static void nv_p2p_free_page_table(
     NvU32 i;
     struct nvidia_p2p_dma_mapping *dma_mapping;
     struct nv_p2p_mem_info *mem_info = NULL;
+    nv_p2p_page_table_ref_t *ref, *next;
+    unsigned long flags;
+    LIST_HEAD(refs);
 
     mem_info = container_of(page_table, nv_p2p_mem_info_t, page_table);
 
+    NV_SPIN_LOCK_IRQSAVE(&nv_p2p_cache_lock, flags);
+
+    nv_p2p_uncache_mem_info_locked(mem_info);
+
+    list_for_each_entry_safe(ref, next, &mem_info->refs, list_node)
+    {
+        nv_p2p_remove_page_table_ref_locked(ref);
+        list_add_tail(&ref->list_node, &refs);
+    }
+
+    NV_SPIN_UNLOCK_IRQRESTORE(&nv_p2p_cache_lock, flags);
+
+    list_for_each_entry_safe(ref, next, &refs, list_node)
+    {
+        os_free_mem(ref);
+    }
+
     dma_mapping = nv_p2p_remove_dma_mapping(mem_info, NULL);
     while (dma_mapping != NULL)
     {
@@ -289,6 +562,47 @@ static void nv_p2p_free_page_table(
     os_free_mem(mem_info);
 }
 
+//
+// Drops the ref of a caller on a page table returned by
+// nvidia_p2p_get_pages*(). Returns the page table known to RM if this was the
+// last ref, in which case the pages must be put, or NULL if other callers
+// still share it or if RM already freed it.
+//
+static struct nvidia_p2p_page_table* nv_p2p_put_page_table_ref(
+    struct nvidia_p2p_page_table *page_table
+)
+{
+    struct nvidia_p2p_page_table *rm_page_table = NULL;
+    nv_p2p_page_table_ref_t *ref;
+    nv_p2p_mem_info_t *mem_info;
+    unsigned long flags;
+
+    NV_SPIN_LOCK_IRQSAVE(&nv_p2p_cache_lock, flags);
+
+    ref = nv_p2p_find_page_table_ref_locked(page_table);
+    if (ref == NULL)
+    {
+        NV_SPIN_UNLOCK_IRQRESTORE(&nv_p2p_cache_lock, flags);
+        return NULL;
+    }
+
+    mem_info = ref->mem_info;
+
+    nv_p2p_remove_page_table_ref_locked(ref);
+
+    if (list_empty(&mem_info->refs))
+    {
+        nv_p2p_uncache_mem_info_locked(mem_info);
+        rm_page_table = &mem_info->page_table;
+    }
+
+    NV_SPIN_UNLOCK_IRQRESTORE(&nv_p2p_cache_lock, flags);
+
+    os_free_mem(ref);
+
+    return rm_page_table;
+}
+
 static NV_STATUS nv_p2p_put_pages(
     nv_p2p_page_table_type_t pt_type,
     nvidia_stack_t * sp,
@@ -379,8 +693,36 @@ NV_EXPORT_SYMBOL(nvidia_p2p_destroy_mapping);
 static void nv_p2p_mem_info_free_callback(void *data)
 {
     nv_p2p_mem_info_t *mem_info = (nv_p2p_mem_info_t*) data;
+    nv_p2p_page_table_ref_t *ref, *next;
+    unsigned long flags;
+    LIST_HEAD(refs);
+
+    //
+    // Unlink the refs first, so that concurrent nvidia_p2p_put_pages() calls
+    // no longer find them, and no new caller can share the page table.
+    //
+    NV_SPIN_LOCK_IRQSAVE(&nv_p2p_cache_lock, flags);
 
-    mem_info->free_callback(mem_info->data);
+    nv_p2p_uncache_mem_info_locked(mem_info);
+
+    list_for_each_entry_safe(ref, next, &mem_info->refs, list_node)
+    {
+        nv_p2p_remove_page_table_ref_locked(ref);
+        list_add_tail(&ref->list_node, &refs);
+    }
+
+    NV_SPIN_UNLOCK_IRQRESTORE(&nv_p2p_cache_lock, flags);
+
+    list_for_each_entry_safe(ref, next, &refs, list_node)
+    {
+        if (ref->free_callback != NULL)
+        {
+            ref->free_callback(ref->data);
+        }
+
+        list_del(&ref->list_node);
+        os_free_mem(ref);
+    }
 
     nv_p2p_free_platform_data(&mem_info->page_table);
 }
@@ -413,6 +755,9 @@ static int nv_p2p_get_pages(
     NvU64 temp_length;
     NvU8 *gpu_uuid = NULL;
     NvU8 uuid[NVIDIA_P2P_GPU_UUID_LEN] = {0};
+    nv_p2p_page_table_ref_t *ref = NULL;
+    NvBool bRefAdded = NV_FALSE;
+    unsigned long flags;
     int rc;
 
     if (!NV_IS_ALIGNED64(virtual_address, NVRM_P2P_PAGESIZE_BIG_64K) ||
@@ -443,9 +788,17 @@ static int nv_p2p_get_pages(
 
     INIT_LIST_HEAD(&mem_info->dma_mapping_list.list_head);
     NV_INIT_MUTEX(&mem_info->dma_mapping_list.lock);
+    INIT_LIST_HEAD(&mem_info->refs);
 
     *page_table = &(mem_info->page_table);
 
+    ref = nv_p2p_alloc_page_table_ref(free_callback, data);
+    if (ref == NULL)
+    {
+        status = NV_ERR_NO_MEMORY;
+        goto failed;
+    }
+
     /*
      * assign length to temporary variable since do_div macro does in-place
      * division
@@ -576,11 +929,19 @@ static int nv_p2p_get_pages(
     os_free_mem(rreqmb_h);
     rreqmb_h = NULL;
 
+    //
+    // The ref must be visible to nv_p2p_mem_info_free_callback() before the
+    // callback is registered, as RM may call it right away.
+    //
+    NV_SPIN_LOCK_IRQSAVE(&nv_p2p_cache_lock, flags);
+
+    nv_p2p_add_page_table_ref_locked(mem_info, ref);
+    bRefAdded = NV_TRUE;
+
+    NV_SPIN_UNLOCK_IRQRESTORE(&nv_p2p_cache_lock, flags);
+
     if (free_callback != NULL)
     {
-        mem_info->free_callback = free_callback;
-        mem_info->data          = data;
-
         status = rm_p2p_register_callback(sp, p2p_token, virtual_address, length,
                                           *page_table, nv_p2p_mem_info_free_callback, mem_info);
         if (status != NV_OK)
@@ -589,6 +950,33 @@ static int nv_p2p_get_pages(
         }
     }
 
+    //
+    // Share the page table with later identical requests once it can no
+    // longer fail. If RM already freed it, its ref is gone and it must not
+    // be cached.
+    //
+    if ((pt_type == NV_P2P_PAGE_TABLE_TYPE_NON_PERSISTENT) &&
+        NVreg_P2pPageTableCache)
+    {
+        NV_SPIN_LOCK_IRQSAVE(&nv_p2p_cache_lock, flags);
+
+        if (nv_p2p_find_page_table_ref_locked(&ref->page_table) == ref)
+        {
+            mem_info->mm = current->mm;
+            mem_info->p2p_token = p2p_token;
+            mem_info->va_space = va_space;
+            mem_info->virtual_address = virtual_address;
+            mem_info->length = length;
+            mem_info->cached = NV_TRUE;
+            hash_add(nv_p2p_page_table_cache, &mem_info->cache_node,
+                     virtual_address);
+        }
+
+        NV_SPIN_UNLOCK_IRQRESTORE(&nv_p2p_cache_lock, flags);
+    }
+
+    *page_table = &ref->page_table;
+
     nv_kmem_cache_free_stack(sp);
 
     return nvidia_p2p_map_status(status);
@@ -623,6 +1011,13 @@ failed:
     if (*page_table != NULL)
     {
         nv_p2p_free_page_table(*page_table);
+        *page_table = NULL;
+    }
+
+    // Refs added to mem_info are freed along with it
+    if ((ref != NULL) && !bRefAdded)
+    {
+        os_free_mem(ref);
     }
 
     nv_kmem_cache_free_stack(sp);
@@ -645,6 +1040,12 @@ int nvidia_p2p_get_pages(
         return -EINVAL;
     }
 
+    if (nv_p2p_get_cached_pages(p2p_token, va_space, virtual_address, length,
+                                page_table, free_callback, data))
+    {
+        return 0;
+    }
+
     return nv_p2p_get_pages(NV_P2P_PAGE_TABLE_TYPE_NON_PERSISTENT,
                             p2p_token, va_space, virtual_address,
                             length, page_table, free_callback, data);
@@ -698,6 +1099,17 @@ int nvidia_p2p_put_pages(
         return 0;
     }
 
+    //
+    // Only the last of the callers sharing the page table puts the pages. A
+    // page table that is not found was already freed by RM, which may race
+    // with this call.
+    //
+    page_table = nv_p2p_put_page_table_ref(page_table);
+    if (page_table == NULL)
+    {
+        return 0;
+    }
+
     rc = nv_kmem_cache_alloc_stack(&sp);
     if (rc != 0)
     {
@@ -742,6 +1154,14 @@ int nvidia_p2p_put_pages_persistent(
 
     os_mem_copy(uuid, page_table->gpu_uuid, NVIDIA_P2P_GPU_UUID_LEN);
 
+    // Persistent page tables are never shared, this is always the last ref.
+    page_table = nv_p2p_put_page_table_ref(page_table);
+    if (WARN_ON(page_table == NULL))
+    {
+        nv_kmem_cache_free_stack(sp);
+        return -EINVAL;
+    }
+
     status = nv_p2p_put_pages(NV_P2P_PAGE_TABLE_TYPE_PERSISTENT,
                               sp, 0, 0, virtual_address, &page_table);
 
@@ -777,7 +1197,17 @@ int nvidia_p2p_dma_map_pages(
         return -EINVAL;
     }
 
-    mem_info = container_of(page_table, nv_p2p_mem_info_t, page_table);
+    mem_info = nv_p2p_page_table_mem_info(page_table);
+
+    //
+    // Page tables shared by several callers are typically DMA mapped for the
+    // same peer by each of them, reuse the existing mapping in that case.
+    //
+    *dma_mapping = nv_p2p_get_dma_mapping(mem_info, peer);
+    if (*dma_mapping != NULL)
+    {
+        return 0;
+    }
 
     rc = nv_kmem_cache_alloc_stack(&sp);
     if (rc != 0)
@@ -881,17 +1311,18 @@ int nvidia_p2p_dma_unmap_pages(
         return -EINVAL;
     }
 
-    mem_info = container_of(page_table, nv_p2p_mem_info_t, page_table);
+    mem_info = nv_p2p_page_table_mem_info(page_table);
 
     /*
-     * nv_p2p_remove_dma_mapping returns dma_mapping if the dma_mapping was
-     * found and got unlinked from the mem_info->dma_mapping_list (atomically).
-     * This ensures that the RM's tear-down path does not race with this path.
+     * nv_p2p_put_dma_mapping returns dma_mapping if this was its last
+     * reference and it got unlinked from the mem_info->dma_mapping_list
+     * (atomically). This ensures that the RM's tear-down path does not race
+     * with this path.
      *
-     * nv_p2p_remove_dma_mappings returns NULL if the dma_mapping was already
-     * unlinked.
+     * nv_p2p_put_dma_mapping returns NULL if the dma_mapping is still in use
+     * by other callers or was already unlinked.
      */
-    if (nv_p2p_remove_dma_mapping(mem_info, dma_mapping) == NULL)
+    if (nv_p2p_put_dma_mapping(mem_info, dma_mapping) == NULL)
     {
         return 0;
     }
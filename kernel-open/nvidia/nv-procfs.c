@@ -223,6 +223,32 @@ nv_procfs_read_power(
 
 NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(power);
 
+static int
+nv_procfs_read_mmap_faults(
+    struct seq_file *s,
+    void *v
+)
+{
+    nv_state_t *nv = s->private;
+    nv_linux_state_t *nvl = NV_GET_NVL_FROM_NV_STATE(nv);
+
+    down(&nvl->mmap_lock);
+
+    seq_printf(s, "Fault window:    %u MB\n", NVreg_MmapFaultWindowSize);
+    seq_printf(s, "Revocations:     %llu\n", nvl->mmap_fault_stats.revocations);
+    seq_printf(s, "Faults:          %llu\n", nvl->mmap_fault_stats.faults);
+    seq_printf(s, "Reinstated:      %llu KB\n",
+               (nvl->mmap_fault_stats.mapped_pages << PAGE_SHIFT) >> 10);
+    seq_printf(s, "Mapped:          %llu KB\n",
+               (nvl->mmap_fault_stats.mmapped_pages << PAGE_SHIFT) >> 10);
+
+    up(&nvl->mmap_lock);
+
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(mmap_faults);
+
 static int
 nv_procfs_read_version(
     struct seq_file *s,
@@ -237,6 +263,109 @@ nv_procfs_read_version(
 
 NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(version);
 
+static int
+nv_procfs_read_uncached_page_pool(
+    struct seq_file *s,
+    void *v
+)
+{
+    nv_uc_page_pool_print(s);
+
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(uncached_page_pool);
+
+static int
+nv_procfs_read_control_cache(
+    struct seq_file *s,
+    void *v
+)
+{
+    nvidia_stack_t *sp = NULL;
+    char *buffer;
+
+    if (nv_kmem_cache_alloc_stack(&sp) != 0)
+    {
+        return 0;
+    }
+
+    NV_KMALLOC(buffer, PAGE_SIZE);
+    if (buffer != NULL)
+    {
+        rm_get_control_cache_stats(sp, buffer, PAGE_SIZE);
+        seq_puts(s, buffer);
+        NV_KFREE(buffer, PAGE_SIZE);
+    }
+
+    nv_kmem_cache_free_stack(sp);
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(control_cache);
+
+//
+// One line per RM control command, or a few lines per lock contention site,
+// which does not fit in a page once a few dozen of them have been seen.
+//
+#define NV_PROCFS_GPU_LOCK_TIMES_SIZE (4 * PAGE_SIZE)
+
+static int
+nv_procfs_read_gpu_lock_times(
+    struct seq_file *s,
+    void *v
+)
+{
+    nvidia_stack_t *sp = NULL;
+    char *buffer;
+
+    if (nv_kmem_cache_alloc_stack(&sp) != 0)
+    {
+        return 0;
+    }
+
+    NV_KMALLOC(buffer, NV_PROCFS_GPU_LOCK_TIMES_SIZE);
+    if (buffer != NULL)
+    {
+        rm_get_gpu_lock_times(sp, buffer, NV_PROCFS_GPU_LOCK_TIMES_SIZE);
+        seq_puts(s, buffer);
+        NV_KFREE(buffer, NV_PROCFS_GPU_LOCK_TIMES_SIZE);
+    }
+
+    nv_kmem_cache_free_stack(sp);
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(gpu_lock_times);
+
+static int
+nv_procfs_read_lock_contention(
+    struct seq_file *s,
+    void *v
+)
+{
+    nvidia_stack_t *sp = NULL;
+    char *buffer;
+
+    if (nv_kmem_cache_alloc_stack(&sp) != 0)
+    {
+        return 0;
+    }
+
+    NV_KMALLOC(buffer, NV_PROCFS_GPU_LOCK_TIMES_SIZE);
+    if (buffer != NULL)
+    {
+        rm_get_lock_contention(sp, buffer, NV_PROCFS_GPU_LOCK_TIMES_SIZE);
+        seq_puts(s, buffer);
+        NV_KFREE(buffer, NV_PROCFS_GPU_LOCK_TIMES_SIZE);
+    }
+
+    nv_kmem_cache_free_stack(sp);
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(lock_contention);
+
 static void
 nv_procfs_close_file(
     nv_procfs_private_t *nvpp
@@ -1360,6 +1489,26 @@ int nv_procfs_init(void)
     if (!entry)
         goto failed;
 
+    entry = NV_CREATE_PROC_FILE("uncached_page_pool", proc_nvidia,
+                                uncached_page_pool, NULL);
+    if (!entry)
+        goto failed;
+
+    entry = NV_CREATE_PROC_FILE("control_cache", proc_nvidia,
+                                control_cache, NULL);
+    if (!entry)
+        goto failed;
+
+    entry = NV_CREATE_PROC_FILE("gpu_lock_times", proc_nvidia,
+                                gpu_lock_times, NULL);
+    if (!entry)
+        goto failed;
+
+    entry = NV_CREATE_PROC_FILE("lock_contention", proc_nvidia,
+                                lock_contention, NULL);
+    if (!entry)
+        goto failed;
+
     proc_nvidia_gpus = NV_CREATE_PROC_DIR("gpus", proc_nvidia);
     if (!proc_nvidia_gpus)
         goto failed;
@@ -1411,6 +1560,11 @@ int nv_procfs_add_gpu(nv_linux_state_t *nvl)
     if (!entry)
         goto failed;
 
+    entry = NV_CREATE_PROC_FILE("mmap_faults", proc_nvidia_gpu, mmap_faults,
+                                nv);
+    if (!entry)
+        goto failed;
+
     if (IS_EXERCISE_ERROR_FORWARDING_ENABLED())
     {
         entry = NV_CREATE_PROC_FILE("exercise_error_forwarding", proc_nvidia_gpu,
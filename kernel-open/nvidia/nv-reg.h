@@ -903,6 +903,70 @@
 #define __NV_CREATE_IMEX_CHANNEL_0 CreateImexChannel0
 #define NV_CREATE_IMEX_CHANNEL_0 NV_REG_STRING(__CREATE_IMEX_CHANNEL_0)
 
+/*
+ * Option: UncachedPagePoolSize
+ *
+ * Description:
+ *
+ * This option specifies the size, in MB per NUMA node, of the pool of system
+ * memory pages kept with an uncached kernel mapping when uncached and
+ * write-combined allocations are freed. New allocations of these types take
+ * their pages from the pool first, which avoids changing the caching
+ * attributes of the pages, and the CPU TLB and cache flushes that come with
+ * it. The pool is shrunk under memory pressure.
+ *
+ * Possible Values:
+ *
+ *  0: disable the pool
+ *  N: keep up to N MB of pages per NUMA node (default 64)
+ */
+#define __NV_UNCACHED_PAGE_POOL_SIZE UncachedPagePoolSize
+#define NV_REG_UNCACHED_PAGE_POOL_SIZE NV_REG_STRING(__NV_UNCACHED_PAGE_POOL_SIZE)
+
+/*
+ * Option: MmapFaultWindowSize
+ *
+ * Description:
+ *
+ * GPU memory mappings are revoked when the GPU is suspended or powered down,
+ * and reinstated by the first CPU access that faults on them. By default, the
+ * fault reinstates the whole mapping, which can stall the faulting thread for
+ * a long time on very large mappings. This option specifies the size, in MB,
+ * of the window of the mapping that is reinstated around the faulting address
+ * instead; the rest of the mapping is reinstated on demand, as it is accessed.
+ * Windows are naturally aligned in the virtual address space of the process,
+ * and clipped to the mapping. Per-GPU statistics of the reinstated mappings
+ * are reported in /proc/driver/nvidia/gpus/<gpu>/mmap_faults.
+ *
+ * Possible Values:
+ *
+ *  0: reinstate the whole mapping on the first fault (default)
+ *  N: reinstate N MB of the mapping around each faulting address
+ */
+#define __NV_MMAP_FAULT_WINDOW_SIZE MmapFaultWindowSize
+#define NV_REG_MMAP_FAULT_WINDOW_SIZE NV_REG_STRING(__NV_MMAP_FAULT_WINDOW_SIZE)
+
+/*
+ * Option: P2pPageTableCache
+ *
+ * Description:
+ *
+ * When this option is enabled, the page tables returned by
+ * nvidia_p2p_get_pages() are shared by the later calls made by the same
+ * process with the same arguments, instead of looking up and pinning the
+ * pages in RM again. A shared page table is released when all of its callers
+ * have put it, or when the memory is freed, in which case the free callback
+ * of each caller is invoked. DMA mappings of a page table for the same peer
+ * device are shared as well.
+ *
+ * Possible Values:
+ *
+ *  0: disable the cache
+ *  1: enable the cache (default)
+ */
+#define __NV_P2P_PAGE_TABLE_CACHE P2pPageTableCache
+#define NV_REG_P2P_PAGE_TABLE_CACHE NV_REG_STRING(__NV_P2P_PAGE_TABLE_CACHE)
+
 #if defined(NV_DEFINE_REGISTRY_KEY_TABLE)
 
 /*
@@ -953,6 +1017,9 @@ NV_DEFINE_REG_ENTRY(__NV_DMA_REMAP_PEER_MMIO, NV_DMA_REMAP_PEER_MMIO_ENABLE);
 NV_DEFINE_REG_STRING_ENTRY(__NV_RM_NVLINK_BW, NULL);
 NV_DEFINE_REG_ENTRY_GLOBAL(__NV_IMEX_CHANNEL_COUNT, 2048);
 NV_DEFINE_REG_ENTRY_GLOBAL(__NV_CREATE_IMEX_CHANNEL_0, 0);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_UNCACHED_PAGE_POOL_SIZE, 64);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_MMAP_FAULT_WINDOW_SIZE, 0);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_P2P_PAGE_TABLE_CACHE, 1);
 
 /*
  *----------------registry database definition----------------------
@@ -1001,6 +1068,9 @@ nv_parm_t nv_parms[] = {
     NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_DMA_REMAP_PEER_MMIO),
     NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_IMEX_CHANNEL_COUNT),
     NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_CREATE_IMEX_CHANNEL_0),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_UNCACHED_PAGE_POOL_SIZE),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_MMAP_FAULT_WINDOW_SIZE),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_P2P_PAGE_TABLE_CACHE),
     {NULL, NULL}
 };
 
@@ -25,6 +25,8 @@
 #include "nv.h"
 #include "nv-linux.h"
 
+#include <linux/seq_file.h>
+
 static inline void nv_set_contig_memory_uc(nvidia_pte_t *page_ptr, NvU32 num_pages)
 {
 #if defined(NV_SET_MEMORY_UC_PRESENT)
@@ -148,7 +150,16 @@ static inline void nv_set_contig_memory_type(
     }
 }
 
-static inline void nv_set_memory_type(nv_alloc_t *at, NvU32 type)
+/*
+ * Change the caching attributes of the kernel mapping of num_pages pages of the
+ * allocation, starting at page first_page.
+ */
+static inline void nv_set_memory_type(
+    nv_alloc_t *at,
+    NvU32 first_page,
+    NvU32 num_pages,
+    NvU32 type
+)
 {
     NvU32 i;
     NV_STATUS status = NV_OK;
@@ -163,16 +174,19 @@ static inline void nv_set_memory_type(nv_alloc_t *at, NvU32 type)
     nvidia_pte_t *page_ptr;
     struct page *page;
 
+    if (num_pages == 0)
+        return;
+
     if (nv_set_memory_array_type_present(type))
     {
         status = os_alloc_mem((void **)&pages,
-                at->num_pages * sizeof(unsigned long));
+                num_pages * sizeof(unsigned long));
 
     }
     else if (nv_set_pages_array_type_present(type))
     {
         status = os_alloc_mem((void **)&pages,
-                at->num_pages * sizeof(struct page*));
+                num_pages * sizeof(struct page*));
     }
 
     if (status != NV_OK)
@@ -185,9 +199,9 @@ static inline void nv_set_memory_type(nv_alloc_t *at, NvU32 type)
     //
     if (pages)
     {
-        for (i = 0; i < at->num_pages; i++)
+        for (i = 0; i < num_pages; i++)
         {
-            page_ptr = at->page_table[i];
+            page_ptr = at->page_table[first_page + i];
             page = NV_GET_PAGE_STRUCT(page_ptr->phys_addr);
 #if defined(NV_SET_MEMORY_ARRAY_UC_PRESENT)
             pages[i] = (unsigned long)page_address(page);
@@ -196,25 +210,63 @@ static inline void nv_set_memory_type(nv_alloc_t *at, NvU32 type)
 #endif
         }
 #if defined(NV_SET_MEMORY_ARRAY_UC_PRESENT)
-        nv_set_memory_array_type(pages, at->num_pages, type);
+        nv_set_memory_array_type(pages, num_pages, type);
 #elif defined(NV_SET_PAGES_ARRAY_UC_PRESENT)
-        nv_set_pages_array_type(pages, at->num_pages, type);
+        nv_set_pages_array_type(pages, num_pages, type);
 #endif
         os_free_mem(pages);
     }
 
     //
     // If the set_{memory,page}_array_* functions aren't present in the kernel
-    // interface, each page has to be set individually, which has been measured
-    // to be ~10x slower than using the set_{memory,page}_array_* functions.
+    // interface, each physically contiguous run of pages has to be set
+    // individually, which has been measured to be ~10x slower than using the
+    // set_{memory,page}_array_* functions when the runs are single pages.
     //
     else
     {
-        for (i = 0; i < at->num_pages; i++)
-            nv_set_contig_memory_type(at->page_table[i], 1, type);
+        NvU32 run_start = first_page;
+        NvU32 end_page = first_page + num_pages;
+
+        for (i = first_page + 1; i <= end_page; i++)
+        {
+            if ((i < end_page) &&
+                (at->page_table[i]->phys_addr ==
+                 at->page_table[i - 1]->phys_addr + PAGE_SIZE))
+            {
+                continue;
+            }
+
+            nv_set_contig_memory_type(at->page_table[run_start],
+                                      i - run_start,
+                                      type);
+            run_start = i;
+        }
     }
 }
 
+#if defined(NV_ALLOC_PAGES_BULK_NODE_PRESENT) || \
+    defined(NV_ALLOC_PAGES_BULK_ARRAY_NODE_PRESENT)
+#define NV_ALLOC_PAGES_BULK_PRESENT
+
+// Number of pages requested from the kernel per bulk allocation call
+#define NV_ALLOC_PAGES_BULK_BATCH 64
+
+static inline unsigned long nv_alloc_pages_bulk_node(
+    unsigned int gfp_mask,
+    int node_id,
+    unsigned long num_pages,
+    struct page **pages
+)
+{
+#if defined(NV_ALLOC_PAGES_BULK_NODE_PRESENT)
+    return alloc_pages_bulk_node(gfp_mask, node_id, num_pages, pages);
+#else
+    return alloc_pages_bulk_array_node(gfp_mask, node_id, num_pages, pages);
+#endif
+}
+#endif
+
 static NvU64 nv_get_max_sysmem_address(void)
 {
     NvU64 global_max_pfn = 0ULL;
@@ -276,6 +328,427 @@ static unsigned int nv_compute_gfp_mask(
     return gfp_mask;
 }
 
+#if defined(NV_SET_MEMORY_UC_PRESENT) || defined(NV_SET_PAGES_UC_PRESENT)
+#define NV_UC_PAGE_POOL_SUPPORTED
+#endif
+
+/*
+ * Pool of order 0 pages whose kernel mapping is already uncached.
+ *
+ * Changing the caching attributes of pages flushes the TLBs and caches of all
+ * CPUs, and non-cached allocations pay for it once when allocated and once when
+ * freed. Instead, nv_free_system_pages() returns their pages to this pool as
+ * they are, up to NVreg_UncachedPagePoolSize MB per NUMA node, and
+ * nv_alloc_system_pages() takes pages from it before allocating new ones. Pages
+ * below 4GB are kept apart so that they can serve DMA32 allocations. A shrinker
+ * gives the pages back to the kernel under memory pressure.
+ */
+#define NV_UC_PAGE_POOL_ZONE_DEFAULT 0
+#define NV_UC_PAGE_POOL_ZONE_DMA32   1
+#define NV_UC_PAGE_POOL_ZONE_COUNT   2
+
+// Number of pages released to the kernel at once by the shrinker
+#define NV_UC_PAGE_POOL_RELEASE_BATCH 64
+
+typedef struct nv_uc_page_pool_s
+{
+    // Protects the lists and counts
+    spinlock_t lock;
+
+    // Pages linked through their lru field
+    struct list_head pages[NV_UC_PAGE_POOL_ZONE_COUNT];
+
+    unsigned long num_pages[NV_UC_PAGE_POOL_ZONE_COUNT];
+} nv_uc_page_pool_t;
+
+// One pool per possible NUMA node, or NULL when the pool is disabled
+static nv_uc_page_pool_t *nv_uc_page_pools;
+static unsigned long nv_uc_page_pool_max_pages;
+
+static struct
+{
+    // Pages handed out from the pool
+    atomic64_t hits;
+
+    // Pages of eligible allocations that had to be allocated and converted
+    atomic64_t misses;
+
+    // Pages returned to the pool on free
+    atomic64_t recycled;
+
+    // Pages released to the kernel by the shrinker
+    atomic64_t reclaimed;
+
+    // Pages currently in all the pools
+    atomic_long_t total;
+} nv_uc_page_pool_stats;
+
+static struct shrinker *nv_uc_page_pool_shrinker;
+#if !defined(NV_SHRINKER_ALLOC_PRESENT)
+static struct shrinker nv_uc_page_pool_shrinker_storage;
+#endif
+
+static inline NvBool nv_uc_page_pool_usable(nv_alloc_t *at)
+{
+    return (nv_uc_page_pools != NULL) &&
+           (at->order == 0) &&
+           (at->cache_type != NV_MEMORY_CACHED) &&
+           !at->flags.unencrypted;
+}
+
+static inline unsigned int nv_uc_page_pool_zone(struct page *page)
+{
+    if (page_to_phys(page) < (1ULL << 32))
+        return NV_UC_PAGE_POOL_ZONE_DMA32;
+
+    return NV_UC_PAGE_POOL_ZONE_DEFAULT;
+}
+
+/*
+ * Restore the caching attributes of pages taken out of the pool and give them
+ * back to the kernel.
+ */
+static void nv_uc_page_pool_release_pages(
+    struct page **pages,
+    NvU32 num_pages
+)
+{
+    NvU32 i;
+
+#if defined(NV_SET_MEMORY_ARRAY_UC_PRESENT)
+    unsigned long addrs[NV_UC_PAGE_POOL_RELEASE_BATCH];
+
+    for (i = 0; i < num_pages; i++)
+        addrs[i] = (unsigned long)page_address(pages[i]);
+
+    nv_set_memory_array_type(addrs, num_pages, NV_MEMORY_WRITEBACK);
+#elif defined(NV_SET_PAGES_ARRAY_UC_PRESENT)
+    nv_set_pages_array_type(pages, num_pages, NV_MEMORY_WRITEBACK);
+#else
+    for (i = 0; i < num_pages; i++)
+    {
+#if defined(NV_SET_MEMORY_UC_PRESENT)
+        set_memory_wb((unsigned long)page_address(pages[i]), 1);
+#elif defined(NV_SET_PAGES_UC_PRESENT)
+        set_pages_wb(pages[i], 1);
+#endif
+    }
+#endif
+
+    for (i = 0; i < num_pages; i++)
+        __free_page(pages[i]);
+}
+
+/*
+ * Release up to max_pages pages of the given node's pool to the kernel.
+ * Returns the number of pages released.
+ */
+static unsigned long nv_uc_page_pool_drain_node(
+    int node_id,
+    unsigned long max_pages
+)
+{
+    nv_uc_page_pool_t *pool = &nv_uc_page_pools[node_id];
+    struct page *pages[NV_UC_PAGE_POOL_RELEASE_BATCH];
+    unsigned long released = 0;
+
+    while (released < max_pages)
+    {
+        unsigned int zone;
+        NvU32 count = 0;
+        NvU32 batch = min_t(unsigned long,
+                            max_pages - released,
+                            NV_UC_PAGE_POOL_RELEASE_BATCH);
+
+        spin_lock(&pool->lock);
+        for (zone = 0; zone < NV_UC_PAGE_POOL_ZONE_COUNT; zone++)
+        {
+            while ((count < batch) && !list_empty(&pool->pages[zone]))
+            {
+                struct page *page = list_first_entry(&pool->pages[zone], struct page, lru);
+
+                list_del(&page->lru);
+                pool->num_pages[zone]--;
+                pages[count++] = page;
+            }
+        }
+        spin_unlock(&pool->lock);
+
+        if (count == 0)
+            break;
+
+        atomic_long_sub(count, &nv_uc_page_pool_stats.total);
+        atomic64_add(count, &nv_uc_page_pool_stats.reclaimed);
+
+        nv_uc_page_pool_release_pages(pages, count);
+        released += count;
+    }
+
+    return released;
+}
+
+static unsigned long nv_uc_page_pool_shrink_count(
+    struct shrinker *shrinker,
+    struct shrink_control *sc
+)
+{
+    return atomic_long_read(&nv_uc_page_pool_stats.total);
+}
+
+static unsigned long nv_uc_page_pool_shrink_scan(
+    struct shrinker *shrinker,
+    struct shrink_control *sc
+)
+{
+    unsigned long released = 0;
+    int node_id;
+
+    for_each_node(node_id)
+    {
+        if (released >= sc->nr_to_scan)
+            break;
+
+        released += nv_uc_page_pool_drain_node(node_id, sc->nr_to_scan - released);
+    }
+
+    return (released == 0) ? SHRINK_STOP : released;
+}
+
+/*
+ * Fill at->page_table with pages from the pool, starting at index 0. Returns
+ * the number of pages taken.
+ */
+static NvU32 nv_uc_page_pool_get(
+    nv_alloc_t *at,
+    unsigned int gfp_mask
+)
+{
+    int node_id = at->flags.node ? at->node_id : numa_mem_id();
+    nv_uc_page_pool_t *pool;
+    struct device *dev = at->dev;
+    NvBool dma32 = (gfp_mask & __GFP_DMA32) != 0;
+    NvU32 count = 0;
+    NvU32 i;
+    unsigned int zone;
+
+    if ((node_id < 0) || (node_id >= nr_node_ids) || !node_possible(node_id))
+        return 0;
+
+    pool = &nv_uc_page_pools[node_id];
+
+    spin_lock(&pool->lock);
+    for (zone = dma32 ? NV_UC_PAGE_POOL_ZONE_DMA32 : NV_UC_PAGE_POOL_ZONE_DEFAULT;
+         zone < NV_UC_PAGE_POOL_ZONE_COUNT;
+         zone++)
+    {
+        while ((count < at->num_pages) && !list_empty(&pool->pages[zone]))
+        {
+            struct page *page = list_first_entry(&pool->pages[zone], struct page, lru);
+            nvidia_pte_t *page_ptr = at->page_table[count];
+
+            list_del(&page->lru);
+            pool->num_pages[zone]--;
+
+            page_ptr->virt_addr = (unsigned long)page_address(page);
+            page_ptr->phys_addr = page_to_phys(page);
+            count++;
+        }
+    }
+    spin_unlock(&pool->lock);
+
+    if (count == 0)
+        return 0;
+
+    atomic_long_sub(count, &nv_uc_page_pool_stats.total);
+    atomic64_add(count, &nv_uc_page_pool_stats.hits);
+
+    for (i = 0; i < count; i++)
+    {
+        nvidia_pte_t *page_ptr = at->page_table[i];
+
+        // The pages were last used by another allocation. This goes through
+        // the uncached mapping, but is still much cheaper than converting
+        // fresh pages.
+        if (at->flags.zeroed)
+            memset((void *)page_ptr->virt_addr, 0, PAGE_SIZE);
+
+        page_ptr->page_count = NV_GET_PAGE_COUNT(page_ptr);
+
+        if (dev != NULL)
+            page_ptr->dma_addr = nv_phys_to_dma(dev, page_ptr->phys_addr);
+        else
+            page_ptr->dma_addr = page_ptr->phys_addr;
+
+        NV_MAYBE_RESERVE_PAGE(page_ptr);
+    }
+
+    return count;
+}
+
+/*
+ * Return the first num_pages pages of at->page_table, which must be unreserved,
+ * to the pool. Returns the number of pages the pool took, always the first
+ * ones. The caller has to restore the caching attributes of the others and
+ * free them.
+ */
+static NvU32 nv_uc_page_pool_put(
+    nv_alloc_t *at,
+    NvU32 num_pages
+)
+{
+    nv_uc_page_pool_t *pool = NULL;
+    NvU32 count;
+
+    for (count = 0; count < num_pages; count++)
+    {
+        nvidia_pte_t *page_ptr = at->page_table[count];
+        struct page *page = NV_GET_PAGE_STRUCT(page_ptr->phys_addr);
+        nv_uc_page_pool_t *page_pool = &nv_uc_page_pools[page_to_nid(page)];
+        unsigned int zone = nv_uc_page_pool_zone(page);
+
+        // Pages still referenced elsewhere may only go back to the kernel
+        if (NV_GET_PAGE_COUNT(page_ptr) != page_ptr->page_count)
+            break;
+
+        if (page_pool != pool)
+        {
+            if (pool != NULL)
+                spin_unlock(&pool->lock);
+
+            pool = page_pool;
+            spin_lock(&pool->lock);
+        }
+
+        if (pool->num_pages[NV_UC_PAGE_POOL_ZONE_DEFAULT] +
+            pool->num_pages[NV_UC_PAGE_POOL_ZONE_DMA32] >= nv_uc_page_pool_max_pages)
+        {
+            break;
+        }
+
+        list_add(&page->lru, &pool->pages[zone]);
+        pool->num_pages[zone]++;
+    }
+
+    if (pool != NULL)
+        spin_unlock(&pool->lock);
+
+    atomic_long_add(count, &nv_uc_page_pool_stats.total);
+    atomic64_add(count, &nv_uc_page_pool_stats.recycled);
+
+    return count;
+}
+
+int nv_uc_page_pool_init(void)
+{
+    int node_id;
+    unsigned int zone;
+
+#if !defined(NV_UC_PAGE_POOL_SUPPORTED)
+    // The caching attributes of the kernel mapping are never changed
+    return 0;
+#endif
+
+    if (NVreg_UncachedPagePoolSize == 0)
+        return 0;
+
+    NV_KZALLOC(nv_uc_page_pools, nr_node_ids * sizeof(*nv_uc_page_pools));
+    if (nv_uc_page_pools == NULL)
+        return -ENOMEM;
+
+    for (node_id = 0; node_id < nr_node_ids; node_id++)
+    {
+        spin_lock_init(&nv_uc_page_pools[node_id].lock);
+        for (zone = 0; zone < NV_UC_PAGE_POOL_ZONE_COUNT; zone++)
+            INIT_LIST_HEAD(&nv_uc_page_pools[node_id].pages[zone]);
+    }
+
+    nv_uc_page_pool_max_pages = ((unsigned long)NVreg_UncachedPagePoolSize << 20) >> PAGE_SHIFT;
+
+#if defined(NV_SHRINKER_ALLOC_PRESENT)
+    nv_uc_page_pool_shrinker = shrinker_alloc(0, "nvidia-uc-page-pool");
+    if (nv_uc_page_pool_shrinker == NULL)
+        goto failed;
+
+    nv_uc_page_pool_shrinker->count_objects = nv_uc_page_pool_shrink_count;
+    nv_uc_page_pool_shrinker->scan_objects = nv_uc_page_pool_shrink_scan;
+    shrinker_register(nv_uc_page_pool_shrinker);
+#else
+    nv_uc_page_pool_shrinker_storage.count_objects = nv_uc_page_pool_shrink_count;
+    nv_uc_page_pool_shrinker_storage.scan_objects = nv_uc_page_pool_shrink_scan;
+    nv_uc_page_pool_shrinker_storage.seeks = DEFAULT_SEEKS;
+
+#if defined(NV_REGISTER_SHRINKER_HAS_FMT_ARG)
+    if (register_shrinker(&nv_uc_page_pool_shrinker_storage, "nvidia-uc-page-pool") != 0)
+        goto failed;
+#else
+    if (register_shrinker(&nv_uc_page_pool_shrinker_storage) != 0)
+        goto failed;
+#endif
+
+    nv_uc_page_pool_shrinker = &nv_uc_page_pool_shrinker_storage;
+#endif
+
+    return 0;
+
+failed:
+    NV_KFREE(nv_uc_page_pools, nr_node_ids * sizeof(*nv_uc_page_pools));
+    nv_uc_page_pools = NULL;
+    return -ENOMEM;
+}
+
+void nv_uc_page_pool_exit(void)
+{
+    int node_id;
+
+    if (nv_uc_page_pools == NULL)
+        return;
+
+#if defined(NV_SHRINKER_ALLOC_PRESENT)
+    shrinker_free(nv_uc_page_pool_shrinker);
+#else
+    unregister_shrinker(nv_uc_page_pool_shrinker);
+#endif
+    nv_uc_page_pool_shrinker = NULL;
+
+    for (node_id = 0; node_id < nr_node_ids; node_id++)
+        nv_uc_page_pool_drain_node(node_id, ULONG_MAX);
+
+    WARN_ON(atomic_long_read(&nv_uc_page_pool_stats.total) != 0);
+
+    NV_KFREE(nv_uc_page_pools, nr_node_ids * sizeof(*nv_uc_page_pools));
+    nv_uc_page_pools = NULL;
+}
+
+void nv_uc_page_pool_print(struct seq_file *s)
+{
+    int node_id;
+
+    seq_printf(s, "Enabled:     %s\n", (nv_uc_page_pools != NULL) ? "yes" : "no");
+    if (nv_uc_page_pools == NULL)
+        return;
+
+    seq_printf(s, "Max pages:   %lu per node\n", nv_uc_page_pool_max_pages);
+    seq_printf(s, "Pages:       %ld\n", atomic_long_read(&nv_uc_page_pool_stats.total));
+    seq_printf(s, "Hits:        %lld\n", (long long)atomic64_read(&nv_uc_page_pool_stats.hits));
+    seq_printf(s, "Misses:      %lld\n", (long long)atomic64_read(&nv_uc_page_pool_stats.misses));
+    seq_printf(s, "Recycled:    %lld\n", (long long)atomic64_read(&nv_uc_page_pool_stats.recycled));
+    seq_printf(s, "Reclaimed:   %lld\n", (long long)atomic64_read(&nv_uc_page_pool_stats.reclaimed));
+
+    for_each_node(node_id)
+    {
+        nv_uc_page_pool_t *pool = &nv_uc_page_pools[node_id];
+        unsigned long num_pages, num_dma32_pages;
+
+        spin_lock(&pool->lock);
+        num_pages = pool->num_pages[NV_UC_PAGE_POOL_ZONE_DEFAULT];
+        num_dma32_pages = pool->num_pages[NV_UC_PAGE_POOL_ZONE_DMA32];
+        spin_unlock(&pool->lock);
+
+        seq_printf(s, "Node %d:      %lu pages, %lu below 4GB\n",
+                   node_id, num_pages + num_dma32_pages, num_dma32_pages);
+    }
+}
+
 /*
  * This function is needed for allocating contiguous physical memory in xen
  * dom0. Because of the use of xen sw iotlb in xen dom0, memory allocated by
@@ -457,6 +930,87 @@ failed:
     return status;
 }
 
+#if defined(NV_ALLOC_PAGES_BULK_PRESENT)
+/*
+ * Allocate the order 0 pages of at->page_table starting at index first_page
+ * with the kernel's bulk page allocator, which takes the zone lock once per
+ * batch rather than once per page. Returns the index of the first page not
+ * allocated, which may be less than at->num_pages when the bulk allocator runs
+ * short, in which case the rest are allocated one at a time by the caller.
+ */
+static NvU32 nv_alloc_system_pages_bulk(
+    nv_alloc_t *at,
+    unsigned int gfp_mask,
+    NvU32 first_page
+)
+{
+    struct page *pages[NV_ALLOC_PAGES_BULK_BATCH];
+    int node_id = at->flags.node ? at->node_id : NUMA_NO_NODE;
+    struct device *dev = at->dev;
+    nvidia_pte_t *page_ptr;
+    NvU32 count = first_page;
+
+    while (count < at->num_pages)
+    {
+        unsigned long num_allocated;
+        unsigned long num_pages = min_t(unsigned long,
+                                        at->num_pages - count,
+                                        NV_ALLOC_PAGES_BULK_BATCH);
+        unsigned long k;
+
+        // The bulk allocator only fills the NULL entries of the array
+        memset(pages, 0, sizeof(pages));
+
+        num_allocated = nv_alloc_pages_bulk_node(gfp_mask, node_id, num_pages, pages);
+
+        for (k = 0; k < num_allocated; k++)
+        {
+            unsigned long virt_addr = (unsigned long)page_address(pages[k]);
+            NvU64 phys_addr = nv_get_kern_phys_address(virt_addr);
+
+            if (phys_addr == 0)
+            {
+                // Leave this page and the rest of the batch to the caller's
+                // per-page allocation, which reports the failure.
+                for (; k < num_allocated; k++)
+                    __free_page(pages[k]);
+                return count;
+            }
+
+#if defined(_PAGE_NX)
+            // Discard the page like nv_alloc_system_pages() does
+            if (((_PAGE_NX & pgprot_val(PAGE_KERNEL)) != 0) &&
+                    (phys_addr < 0x400000))
+            {
+                nv_printf(NV_DBG_SETUP,
+                    "NVRM: VM: %s: discarding page @ 0x%llx\n",
+                    __FUNCTION__, phys_addr);
+                continue;
+            }
+#endif
+
+            page_ptr = at->page_table[count];
+            page_ptr->phys_addr = phys_addr;
+            page_ptr->page_count = NV_GET_PAGE_COUNT(page_ptr);
+            page_ptr->virt_addr = virt_addr;
+
+            if (dev != NULL)
+                page_ptr->dma_addr = nv_phys_to_dma(dev, page_ptr->phys_addr);
+            else
+                page_ptr->dma_addr = page_ptr->phys_addr;
+
+            NV_MAYBE_RESERVE_PAGE(page_ptr);
+            count++;
+        }
+
+        if (num_allocated < num_pages)
+            break;
+    }
+
+    return count;
+}
+#endif
+
 void nv_free_contig_pages(
     nv_alloc_t *at
 )
@@ -520,13 +1074,33 @@ NV_STATUS nv_alloc_system_pages(
     unsigned int sub_page_idx;
     unsigned int sub_page_offset;
     unsigned int os_pages_in_page = alloc_page_size / PAGE_SIZE;
+    NvU32 num_pool_pages = 0;
 
     nv_printf(NV_DBG_MEMINFO,
             "NVRM: VM: %s: %u order0 pages, %u order\n", __FUNCTION__, at->num_pages, at->order);
 
     gfp_mask = nv_compute_gfp_mask(nv, at);
 
-    for (i = 0; i < alloc_num_pages; i++)
+    // Pages from the pool are already uncached, see nv_uc_page_pool_t
+    if (nv_uc_page_pool_usable(at))
+    {
+        num_pool_pages = nv_uc_page_pool_get(at, gfp_mask);
+        atomic64_add(at->num_pages - num_pool_pages, &nv_uc_page_pool_stats.misses);
+    }
+
+    i = num_pool_pages;
+
+#if defined(NV_ALLOC_PAGES_BULK_PRESENT)
+    //
+    // Large allocations of order 0 pages spend most of their time in the page
+    // allocator, so take them from it in batches. Unencrypted allocations come
+    // from dma_alloc_coherent() and can't use it.
+    //
+    if ((at->order == 0) && !(at->flags.unencrypted && (dev != NULL)))
+        i = nv_alloc_system_pages_bulk(at, gfp_mask, i);
+#endif
+
+    for (; i < alloc_num_pages; i++)
     {
         if (at->flags.unencrypted && (dev != NULL))
         {
@@ -606,14 +1180,40 @@ NV_STATUS nv_alloc_system_pages(
     }
 
     if (at->cache_type != NV_MEMORY_CACHED)
-        nv_set_memory_type(at, NV_MEMORY_UNCACHED);
+    {
+        nv_set_memory_type(at,
+                           num_pool_pages,
+                           at->num_pages - num_pool_pages,
+                           NV_MEMORY_UNCACHED);
+    }
 
     return NV_OK;
 
 failed:
-    if (i > 0)
+    //
+    // The pages taken from the pool are uncached, give them back. Any the pool
+    // doesn't take back are restored and freed with the others.
+    //
+    if (num_pool_pages > 0)
     {
-        for (j = 0; j < i; j++)
+        NvU32 num_returned;
+
+        for (j = 0; j < num_pool_pages; j++)
+            NV_MAYBE_UNRESERVE_PAGE(at->page_table[j]);
+
+        num_returned = nv_uc_page_pool_put(at, num_pool_pages);
+        nv_set_memory_type(at,
+                           num_returned,
+                           num_pool_pages - num_returned,
+                           NV_MEMORY_WRITEBACK);
+
+        for (j = num_returned; j < num_pool_pages; j++)
+            NV_FREE_PAGES(at->page_table[j]->virt_addr, 0);
+    }
+
+    if (i > num_pool_pages)
+    {
+        for (j = num_pool_pages; j < i; j++)
         {
             page_ptr = at->page_table[j * os_pages_in_page];
             NV_MAYBE_UNRESERVE_PAGE(page_ptr);
@@ -643,12 +1243,11 @@ void nv_free_system_pages(
     unsigned int alloc_page_size = PAGE_SIZE << at->order;
     unsigned int os_pages_in_page = alloc_page_size / PAGE_SIZE;
 
+    NvU32 num_pool_pages = 0;
+
     nv_printf(NV_DBG_MEMINFO,
             "NVRM: VM: %s: %u pages\n", __FUNCTION__, at->num_pages);
 
-    if (at->cache_type != NV_MEMORY_CACHED)
-        nv_set_memory_type(at, NV_MEMORY_WRITEBACK);
-
     for (i = 0; i < at->num_pages; i++)
     {
         page_ptr = at->page_table[i];
@@ -668,7 +1267,19 @@ void nv_free_system_pages(
         NV_MAYBE_UNRESERVE_PAGE(page_ptr);
     }
 
-    for (i = 0; i < at->num_pages; i += os_pages_in_page)
+    // Keep the uncached pages for the next allocations, see nv_uc_page_pool_t
+    if (nv_uc_page_pool_usable(at))
+        num_pool_pages = nv_uc_page_pool_put(at, at->num_pages);
+
+    if (at->cache_type != NV_MEMORY_CACHED)
+    {
+        nv_set_memory_type(at,
+                           num_pool_pages,
+                           at->num_pages - num_pool_pages,
+                           NV_MEMORY_WRITEBACK);
+    }
+
+    for (i = num_pool_pages; i < at->num_pages; i += os_pages_in_page)
     {
         page_ptr = at->page_table[i];
 
@@ -390,6 +390,8 @@ int nvos_free_alloc(
 static void
 nv_module_resources_exit(nv_stack_t *sp)
 {
+    nv_uc_page_pool_exit();
+
     nv_kmem_cache_free_stack(sp);
 
     NV_KMEM_CACHE_DESTROY(nvidia_p2p_page_t_cache);
@@ -435,6 +437,14 @@ nv_module_resources_init(nv_stack_t **sp)
         goto exit;
     }
 
+    rc = nv_uc_page_pool_init();
+    if (rc < 0)
+    {
+        nv_printf(NV_DBG_ERRORS,
+                  "NVRM: uncached page pool initialization failed.\n");
+        goto exit;
+    }
+
 exit:
     if (rc < 0)
     {
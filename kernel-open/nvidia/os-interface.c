@@ -72,7 +72,14 @@ void NV_API_CALL os_enable_console_access(void)
     console_unlock();
 }
 
-typedef struct semaphore os_mutex_t;
+//
+// RM mutexes are always released by the thread that acquired them, so back
+// them with a kernel mutex rather than a binary semaphore. This lets
+// contended acquires spin while the owner is running instead of sleeping
+// right away. They aren't validated by lockdep, since every RM mutex would
+// otherwise share the single lock class of os_alloc_mutex.
+//
+typedef struct mutex os_mutex_t;
 
 //
 // os_alloc_mutex - Allocate the RM mutex
@@ -94,7 +101,8 @@ NV_STATUS NV_API_CALL os_alloc_mutex
         return rmStatus;
     }
     os_mutex = (os_mutex_t *)*ppMutex;
-    NV_INIT_MUTEX(os_mutex);
+    mutex_init(os_mutex);
+    lockdep_set_novalidate_class(os_mutex);
 
     return NV_OK;
 }
@@ -114,6 +122,7 @@ void NV_API_CALL os_free_mutex
 
     if (os_mutex != NULL)
     {
+        mutex_destroy(os_mutex);
         os_free_mem(pMutex);
     }
 }
@@ -133,7 +142,7 @@ NV_STATUS NV_API_CALL os_acquire_mutex
     {
         return NV_ERR_INVALID_REQUEST;
     }
-    down(os_mutex);
+    mutex_lock(os_mutex);
 
     return NV_OK;
 }
@@ -149,7 +158,7 @@ NV_STATUS NV_API_CALL os_cond_acquire_mutex
         return NV_ERR_INVALID_REQUEST;
     }
 
-    if (down_trylock(os_mutex))
+    if (!mutex_trylock(os_mutex))
     {
         return NV_ERR_TIMEOUT_RETRY;
     }
@@ -164,7 +173,7 @@ void NV_API_CALL os_release_mutex
 )
 {
     os_mutex_t *os_mutex = (os_mutex_t *)pMutex;
-    up(os_mutex);
+    mutex_unlock(os_mutex);
 }
 
 typedef struct semaphore os_semaphore_t;
@@ -747,6 +756,19 @@ NV_STATUS NV_API_CALL os_delay_us(NvU32 MicroSeconds)
     return nv_sleep_us(MicroSeconds);
 }
 
+/*
+ * Unlike os_delay_us(), which busy-waits, yields the CPU for at least the
+ * given number of microseconds. Fails if the caller may not sleep.
+ */
+NV_STATUS NV_API_CALL os_sleep_us(NvU32 MicroSeconds)
+{
+    if (!NV_MAY_SLEEP())
+        return NV_ERR_ILLEGAL_ACTION;
+
+    usleep_range(MicroSeconds, 2 * (unsigned long)MicroSeconds);
+    return NV_OK;
+}
+
 NV_STATUS NV_API_CALL os_delay(NvU32 MilliSeconds)
 {
     return nv_sleep_ms(MilliSeconds);
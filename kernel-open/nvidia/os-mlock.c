@@ -32,6 +32,31 @@
 #define NV_NUM_PIN_PAGES_PER_ITERATION 0x80000
 #endif
 
+//
+// Faulting in and pinning hundreds of GBs from a single thread takes minutes,
+// so ranges of at least NV_PIN_PAGES_PARALLEL_MIN_PAGES pages are split into
+// chunks of NV_PIN_PAGES_PARALLEL_CHUNK_PAGES pages, which are pinned
+// concurrently by up to NV_PIN_PAGES_PARALLEL_MAX_WORKERS kthreads. This
+// requires pin_user_pages_remote(), since the kthreads pin pages of the mm of
+// the calling process.
+//
+#if defined(NV_PIN_USER_PAGES_REMOTE_PRESENT) && !defined(NV_BSD)
+#define NV_PIN_PAGES_PARALLEL_CHUNK_PAGES  0x10000
+#define NV_PIN_PAGES_PARALLEL_MIN_PAGES    (16 * NV_PIN_PAGES_PARALLEL_CHUNK_PAGES)
+#define NV_PIN_PAGES_PARALLEL_MAX_WORKERS  16
+
+typedef struct nv_pin_pages_chunk_s
+{
+    nv_kthread_q_item_t q_item;
+    struct mm_struct   *mm;
+    unsigned long       start;
+    NvU64               page_count;
+    NvU64               pinned;
+    unsigned int        gup_flags;
+    struct page       **user_pages;
+} nv_pin_pages_chunk_t;
+#endif
+
 static inline int nv_follow_pfn(struct vm_area_struct *vma,
                                 unsigned long address,
                                 unsigned long *pfn)
@@ -177,6 +202,128 @@ done:
     return rmStatus;
 }
 
+#if defined(NV_PIN_PAGES_PARALLEL_CHUNK_PAGES)
+static void nv_pin_pages_chunk(void *args)
+{
+    nv_pin_pages_chunk_t *chunk = args;
+    long ret;
+
+    nv_mmap_read_lock(chunk->mm);
+    while (chunk->pinned < chunk->page_count)
+    {
+        ret = NV_PIN_USER_PAGES_REMOTE(chunk->mm,
+                                       chunk->start + (chunk->pinned * PAGE_SIZE),
+                                       chunk->page_count - chunk->pinned,
+                                       chunk->gup_flags,
+                                       &chunk->user_pages[chunk->pinned],
+                                       NULL);
+        if (ret <= 0)
+        {
+            break;
+        }
+
+        chunk->pinned += ret;
+    }
+    nv_mmap_read_unlock(chunk->mm);
+}
+
+//
+// Pins the range with a pool of kthreads. Returns NV_TRUE if all pages were
+// pinned; otherwise nothing is left pinned, and the caller falls back to
+// pinning the range from the current thread, which also takes care of
+// reporting the failure.
+//
+static NvBool nv_lock_user_pages_parallel(
+    struct mm_struct *mm,
+    unsigned long     address,
+    NvU64             page_count,
+    unsigned int      gup_flags,
+    struct page     **user_pages
+)
+{
+    nv_kthread_pool_t pool;
+    nv_pin_pages_chunk_t *chunks;
+    NvU64 num_chunks = NV_CEIL(page_count, NV_PIN_PAGES_PARALLEL_CHUNK_PAGES);
+    int node = numa_node_id();
+    unsigned num_workers = min_t(unsigned, cpumask_weight(cpumask_of_node(node)),
+                                 NV_PIN_PAGES_PARALLEL_MAX_WORKERS);
+    NvBool success = NV_TRUE;
+    NvU64 i, j;
+
+    if (num_workers < 2)
+    {
+        return NV_FALSE;
+    }
+
+    //
+    // Pages that are not populated yet get faulted in by the kthreads, so
+    // the kthreads run on the node of the calling thread, where the pages
+    // would be allocated otherwise. The memory policy of the calling task
+    // would not be honored by the kthreads though, so leave that case to the
+    // caller.
+    //
+#if defined(CONFIG_NUMA)
+    if (current->mempolicy != NULL)
+    {
+        return NV_FALSE;
+    }
+#endif
+
+    if (os_alloc_mem((void **)&chunks, num_chunks * sizeof(*chunks)) != NV_OK)
+    {
+        return NV_FALSE;
+    }
+
+    if (nv_kthread_pool_init_on_node(&pool, "nv_pin_pages", num_workers, node) != 0)
+    {
+        os_free_mem(chunks);
+        return NV_FALSE;
+    }
+
+    for (i = 0; i < num_chunks; i++)
+    {
+        nv_pin_pages_chunk_t *chunk = &chunks[i];
+        NvU64 first_page = i * NV_PIN_PAGES_PARALLEL_CHUNK_PAGES;
+
+        chunk->mm = mm;
+        chunk->start = address + (first_page * PAGE_SIZE);
+        chunk->page_count = NV_MIN(page_count - first_page,
+                                   NV_PIN_PAGES_PARALLEL_CHUNK_PAGES);
+        chunk->pinned = 0;
+        chunk->gup_flags = gup_flags;
+        chunk->user_pages = &user_pages[first_page];
+
+        nv_kthread_q_item_init(&chunk->q_item, nv_pin_pages_chunk, chunk);
+        nv_kthread_pool_schedule_q_item(&pool, &chunk->q_item);
+    }
+
+    // Stopping the pool waits for all of the chunks to be pinned.
+    nv_kthread_pool_stop(&pool);
+
+    for (i = 0; i < num_chunks; i++)
+    {
+        if (chunks[i].pinned < chunks[i].page_count)
+        {
+            success = NV_FALSE;
+            break;
+        }
+    }
+
+    if (!success)
+    {
+        for (i = 0; i < num_chunks; i++)
+        {
+            for (j = 0; j < chunks[i].pinned; j++)
+                NV_UNPIN_USER_PAGE(chunks[i].user_pages[j]);
+        }
+    }
+
+    os_free_mem(chunks);
+
+    return success;
+}
+#endif
+
 NV_STATUS NV_API_CALL os_lock_user_pages(
     void   *address,
     NvU64   page_count,
@@ -213,6 +360,16 @@ NV_STATUS NV_API_CALL os_lock_user_pages(
         return rmStatus;
     }
 
+#if defined(NV_PIN_PAGES_PARALLEL_CHUNK_PAGES)
+    if ((page_count >= NV_PIN_PAGES_PARALLEL_MIN_PAGES) &&
+        nv_lock_user_pages_parallel(mm, (unsigned long)address, page_count,
+                                    gup_flags, user_pages))
+    {
+        *page_array = user_pages;
+        return NV_OK;
+    }
+#endif
+
     nv_mmap_read_lock(mm);
     ret = NV_PIN_USER_PAGES((unsigned long)address,
                             npages, gup_flags, user_pages);
@@ -279,7 +436,14 @@ NV_STATUS NV_API_CALL os_unlock_user_pages(
 {
     NvBool write = 1;
     struct page **user_pages = page_array;
-    NvU32 i;
+#if defined(NV_UNPIN_USER_PAGES_DIRTY_LOCK)
+    //
+    // This dirties and unpins the pages one folio at a time, instead of one
+    // page at a time.
+    //
+    NV_UNPIN_USER_PAGES_DIRTY_LOCK(user_pages, page_count, write);
+#else
+    NvU64 i;
 
     for (i = 0; i < page_count; i++)
     {
@@ -287,6 +451,7 @@ NV_STATUS NV_API_CALL os_unlock_user_pages(
             set_page_dirty_lock(user_pages[i]);
         NV_UNPIN_USER_PAGE(user_pages[i]);
     }
+#endif
 
     os_free_mem(user_pages);
 
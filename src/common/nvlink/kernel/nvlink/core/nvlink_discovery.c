@@ -208,6 +208,15 @@ _nvlink_core_discover_topology(void)
                     if (!end1->bRxDetected || end1->bTxCommonModeFail)
                         continue;
 
+                    //
+                    // A link that is already part of a connection can't be
+                    // the remote end of end0, so don't read its token
+                    //
+                    conn = NULL;
+                    nvlink_core_get_intranode_conn(end1, &conn);
+                    if (conn != NULL)
+                        continue;
+
                     token = 0;
 
                     if ((end0->version >= NVLINK_DEVICE_VERSION_30) &&
@@ -72,6 +72,51 @@ _nvswitch_dump_error_entry
     }
 }
 
+//
+// Return whether a newly recorded error should be dumped to the kernel log.
+// Only non-fatal errors reported by the hardware are rate-limited, fatal and
+// software errors are always dumped.
+//
+static NvBool
+_nvswitch_should_dump_error_entry
+(
+    nvswitch_device *device,
+    NVSWITCH_ERROR_LOG_TYPE *errors,
+    NVSWITCH_ERROR_TYPE *error_entry
+)
+{
+    if ((error_entry->severity != NVSWITCH_ERROR_SEVERITY_NONFATAL) ||
+        (error_entry->error_src != NVSWITCH_ERROR_SRC_HW))
+    {
+        return NV_TRUE;
+    }
+
+    if ((error_entry->time - errors->dump_window_start) >=
+        NVSWITCH_ERROR_DUMP_INTERVAL_NS)
+    {
+        if (errors->dump_suppressed != 0)
+        {
+            NVSWITCH_PRINT(device, ERROR,
+                "%s: %u non-fatal errors were recorded but not dumped\n",
+                __FUNCTION__, errors->dump_suppressed);
+        }
+
+        errors->dump_window_start = error_entry->time;
+        errors->dump_window_count = 0;
+        errors->dump_suppressed = 0;
+    }
+
+    if (errors->dump_window_count >= NVSWITCH_ERROR_DUMP_BURST)
+    {
+        errors->dump_suppressed++;
+        return NV_FALSE;
+    }
+
+    errors->dump_window_count++;
+
+    return NV_TRUE;
+}
+
 //
 // Construct an error log
 //
@@ -95,6 +140,9 @@ nvswitch_construct_error_log
     errors->error_log_size = 0;
     errors->error_log = NULL;
     errors->overwritable = overwritable;
+    errors->dump_window_start = 0;
+    errors->dump_window_count = 0;
+    errors->dump_suppressed = 0;
 
     if (error_log_size > 0)
     {
@@ -215,7 +263,10 @@ nvswitch_record_error
             nvswitch_os_memcpy(&errors->error_log[idx_error].data, data, data_size);
         }
 
-        _nvswitch_dump_error_entry(device, idx_error, &errors->error_log[idx_error]);
+        if (_nvswitch_should_dump_error_entry(device, errors, &errors->error_log[idx_error]))
+        {
+            _nvswitch_dump_error_entry(device, idx_error, &errors->error_log[idx_error]);
+        }
     }
     errors->error_total++;
     device->error_total++;
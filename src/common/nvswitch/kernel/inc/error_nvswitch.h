@@ -112,6 +112,14 @@ typedef struct
     } data;
 } NVSWITCH_ERROR_TYPE;
 
+//
+// At most NVSWITCH_ERROR_DUMP_BURST non-fatal errors are dumped to the kernel
+// log per NVSWITCH_ERROR_DUMP_INTERVAL_NS.  Errors past that are still
+// recorded in the error log, only their dump is skipped.
+//
+#define NVSWITCH_ERROR_DUMP_BURST           32
+#define NVSWITCH_ERROR_DUMP_INTERVAL_NS     1000000000LL
+
 typedef struct
 {
     NvU32               error_start;    // Start index within CB
@@ -121,6 +129,10 @@ typedef struct
     NVSWITCH_ERROR_TYPE *error_log;
     NvBool              overwritable;   // Old CB entries can be overwritten
 
+    NvU64               dump_window_start;  // Start of the dump window, in ns
+    NvU32               dump_window_count;  // Errors dumped in the window
+    NvU32               dump_suppressed;    // Errors not dumped in the window
+
 } NVSWITCH_ERROR_LOG_TYPE;
 
 //
@@ -684,8 +684,12 @@ void __nvPushMakeRoom(NvPushChannelPtr push_buffer, NvU32 count)
             // available.
             push_buffer->main.freeDwords = ((getOffset - putOffset) >> 2) - 1;
 
-            // TODO: If still not enough room, call DelayRegisterReadsCaller
-            // here.
+            // If there is still not enough room, the GPU has to consume more
+            // of the pushbuffer first.  Let other threads run rather than
+            // spinning on GET reads meanwhile.
+            if (count >= push_buffer->main.freeDwords) {
+                nvPushImportYield(push_buffer->pDevice);
+            }
         } else if(!fenceToEnd) {
             // GET wrapped, so we can write all the way to the end of the
             // pushbuffer.
@@ -32,6 +32,7 @@
 
 #include "nvidia-push-init.h"
 #include "nvidia-3d.h"
+#include "nvidia-headsurface-types.h"
 
 #include "nv_list.h"
 
@@ -177,6 +178,19 @@ typedef struct _NVHsChannelEvoRec {
         NvU32 handle;
         Nv3dChannelRec channel;
         Nv3dRenderTexInfo texInfo[NVKMS_HEADSURFACE_TEXINFO_NUM];
+
+        /*
+         * The program uniforms most recently loaded into the vertex and
+         * fragment program constant buffers.  In the steady state these don't
+         * change from one frame to the next, so nvHs3dRenderFrame() only
+         * reloads them when they differ.
+         */
+        struct {
+            NvBool vertexValid;
+            NvBool fragmentValid;
+            NvHsVertexUniforms vertex;
+            NvHsFragmentUniforms fragment;
+        } uniforms;
     } nv3d;
 
     struct {
@@ -862,6 +862,11 @@ void nvHs3dSetConfig(NVHsChannelEvoPtr pHsChannel)
     nvkms_memset(pHsChannel->nv3d.texInfo, 0,
                  sizeof(pHsChannel->nv3d.texInfo));
 
+    /* Reload the program uniforms with the next frame. */
+
+    pHsChannel->nv3d.uniforms.vertexValid = FALSE;
+    pHsChannel->nv3d.uniforms.fragmentValid = FALSE;
+
     /* Set up sampler from blend surface. */
 
     AssignRenderTexInfo(
@@ -1085,6 +1090,15 @@ static void LoadFragmentProgramUniforms(
         }
     }
 
+    if (pHsChannel->nv3d.uniforms.fragmentValid &&
+        nvkms_memcmp(&pHsChannel->nv3d.uniforms.fragment, &fragmentUniforms,
+                     sizeof(fragmentUniforms)) == 0) {
+        return;
+    }
+
+    pHsChannel->nv3d.uniforms.fragment = fragmentUniforms;
+    pHsChannel->nv3d.uniforms.fragmentValid = TRUE;
+
     nv3dSelectCb(&pHsChannel->nv3d.channel,
                  NVKMS_HEADSURFACE_CONSTANT_BUFFER_FRAGMENT_PROGRAM);
     nv3dBindCb(&pHsChannel->nv3d.channel, NV3D_HW_BIND_GROUP_FRAGMENT,
@@ -1121,6 +1135,15 @@ static void LoadVertexProgramUniforms(
     uniforms.cursorPosition.y = pChannelConfig->cursor.y +
                                 uniforms.primaryTextureBias.y;
 
+    if (pHsChannel->nv3d.uniforms.vertexValid &&
+        nvkms_memcmp(&pHsChannel->nv3d.uniforms.vertex, &uniforms,
+                     sizeof(uniforms)) == 0) {
+        return;
+    }
+
+    pHsChannel->nv3d.uniforms.vertex = uniforms;
+    pHsChannel->nv3d.uniforms.vertexValid = TRUE;
+
     /* Bind the constant buffer. */
     nv3dSelectCb(p3d, NVKMS_HEADSURFACE_CONSTANT_BUFFER_VERTEX_PROGRAM);
     nv3dBindCb(p3d, NV3D_HW_BIND_GROUP_VERTEX, NV3D_CB_SLOT_MISC1, TRUE);
@@ -1977,10 +2000,9 @@ NvBool nvHs3dRenderFrame(
     /*
      * Load vertex and fragment program uniforms.
      *
-     * XXX NVKMS HEADSURFACE TODO: the inputs that influence the program
-     * uniforms /could/ change from one frame to the next, but in the steady
-     * state they won't.  Should we add tracking to only reload the program
-     * uniforms when their inputs change?
+     * The inputs that influence the program uniforms /could/ change from one
+     * frame to the next, but in the steady state they won't: the uniforms are
+     * only reloaded when they differ from the ones last loaded.
      */
 
     LoadFragmentProgramUniforms(pHsChannel, pixelShift, useOverlay,
@@ -781,10 +781,14 @@ static void HsUpdateFlipQueueCurrent(
         NVHsLayerRequestedFlipState newCurrent = { };
 
         /*
-         * XXX NVKMS HEADSURFACE TODO: fast forward to the last ready flip queue
-         * entry.  Share code with similar functionality in
-         * nvHsPushFlipQueueEntry().
+         * Fast forward through the ready flip queue entries that don't need to
+         * be displayed for a frame, as nvHsPushFlipQueueEntry() does.  Entries
+         * may have become ready since they were pushed, and otherwise each of
+         * them would be displayed for a frame before the next one is popped.
          */
+        HsFastForwardFlipQueue(pHsChannel, layer,
+                               TRUE /* honorIsReadyCriteria */,
+                               TRUE /* honorMinPresentInterval */);
 
         if (!HsPopFlipQueueEntry(pHsChannel, layer, &newCurrent)) {
             continue;
@@ -715,6 +715,11 @@ NV_STATUS osSchedule(void)
     return os_schedule();
 }
 
+NV_STATUS osSleepUs(NvU32 microseconds)
+{
+    return os_sleep_us(microseconds);
+}
+
 NV_STATUS osQueueWorkItemWithFlags(
     OBJGPU *pGpu,
     OSWorkItemFunction pFunction,
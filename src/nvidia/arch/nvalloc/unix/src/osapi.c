@@ -54,6 +54,7 @@
 #include <mem_mgr/p2p.h>
 
 #include "rmapi/exports.h"
+#include "rmapi/rmapi.h"
 #include "rmapi/rmapi_utils.h"
 #include "rmapi/rs_utils.h"
 #include "rmapi/resource_fwd_decls.h"
@@ -2787,8 +2788,7 @@ static void _deferredClientListFreeCallback(void *unused)
     //
     // Possible return values:
     //   NV_WARN_MORE_PROCESSING_REQUIRED - Iteration limit reached, need to call again
-    //   NV_ERR_IN_USE - Already running on another thread, try again later
-    // In both cases, schedule a worker to clean up anything that remains
+    // Schedule a worker to clean up anything that remains
     //
     if (status != NV_OK)
     {
@@ -2801,6 +2801,42 @@ static void _deferredClientListFreeCallback(void *unused)
     }
 }
 
+//
+// Start freeing disabled clients on the calling thread, along with extra work
+// items when the clients can be torn down in parallel.
+//
+static void _deferredClientListFreeStart(void)
+{
+    OBJSYS *pSys = SYS_GET_INSTANCE();
+    NvU32 threadCount = pSys->clientListDeferredFreeThreads;
+    NvU32 gpuCount;
+    NvU32 gpuMask;
+    NvU32 i;
+
+    //
+    // A whole client free takes the API lock for writing unless read-only
+    // frees were enabled, in which case only the client lock and the locks
+    // of the GPUs whose resources are being freed are held.
+    //
+    if (!serverSupportsReadOnlyLock(&g_resServ, RS_LOCK_TOP, RS_API_FREE_RESOURCE))
+    {
+        threadCount = 1;
+    }
+    else if (threadCount == 0)
+    {
+        gpumgrGetGpuAttachInfo(&gpuCount, &gpuMask);
+        threadCount = NV_MAX(gpuCount, 1);
+    }
+
+    for (i = 1; i < threadCount; i++)
+    {
+        if (osQueueSystemWorkItem(_deferredClientListFreeCallback, NULL) != NV_OK)
+            break;
+    }
+
+    _deferredClientListFreeCallback(NULL);
+}
+
 void NV_API_CALL rm_cleanup_file_private(
     nvidia_stack_t     *sp,
     nv_state_t         *pNv,
@@ -2869,7 +2905,7 @@ void NV_API_CALL rm_cleanup_file_private(
 
     // Start the deferred free callback if necessary
     if (pSys->bUseDeferredClientListFree)
-        _deferredClientListFreeCallback(NULL);
+        _deferredClientListFreeStart();
 
     rmapiEpilogue(pRmApi, &rmApiContext);
     threadStateFree(&threadState, THREAD_STATE_FLAGS_NONE);
@@ -4898,6 +4934,281 @@ finish:
     NV_EXIT_RM_RUNTIME(sp,fp);
 }
 
+#define RM_CONTROL_CACHE_STATS_MAX 64
+
+//
+// Formats the hit/miss counters of the RM control cache, one cacheable
+// control command per line, into the given buffer.
+//
+void NV_API_CALL rm_get_control_cache_stats(
+    nvidia_stack_t *sp,
+    char *buffer,
+    NvLength size
+)
+{
+    RMAPI_CONTROL_CACHE_STATS *pStats;
+    NvU32  count;
+    NvU32  i;
+    NvS32  len;
+    NvU32  offset = 0;
+    void  *fp;
+
+    if (size == 0)
+        return;
+
+    buffer[0] = '\0';
+
+    NV_ENTER_RM_RUNTIME(sp,fp);
+
+    pStats = portMemAllocNonPaged(sizeof(*pStats) * RM_CONTROL_CACHE_STATS_MAX);
+    if (pStats == NULL)
+        goto done;
+
+    count = rmapiControlCacheGetStats(pStats, RM_CONTROL_CACHE_STATS_MAX);
+
+    len = os_snprintf(buffer, size, "Mode:     %u\n%-10s %20s %20s\n",
+                      rmapiControlCacheGetMode(), "Command", "Hits", "Misses");
+
+    for (i = 0; i < count; i++)
+    {
+        if ((len < 0) || ((offset + len) >= size))
+            break;
+
+        offset += len;
+        len = os_snprintf(buffer + offset, size - offset, "0x%08x %20llu %20llu\n",
+                          pStats[i].cmd, pStats[i].hits, pStats[i].misses);
+    }
+
+    portMemFree(pStats);
+
+done:
+    NV_EXIT_RM_RUNTIME(sp,fp);
+}
+
+#define RM_GPU_LOCK_CMD_TIMES_MAX 64
+
+//
+// Formats the GPU lock hold time histograms of the RM control commands, one
+// command per line, into the given buffer. The times are only collected when
+// the RmLockTimeCollect registry key is set.
+//
+void NV_API_CALL rm_get_gpu_lock_times(
+    nvidia_stack_t *sp,
+    char *buffer,
+    NvLength size
+)
+{
+    static const char *bucketNames[RM_GPU_LOCK_HOLD_HIST_BUCKETS] =
+    {
+        "<1us", "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"
+    };
+    OBJSYS *pSys = SYS_GET_INSTANCE();
+    RM_GPU_LOCK_CMD_TIMES *pTimes;
+    NvU32  count;
+    NvU32  i;
+    NvU32  bucket;
+    NvS32  len;
+    NvU32  offset = 0;
+    void  *fp;
+
+    ct_assert(RM_GPU_LOCK_HOLD_HIST_BUCKETS == 8);
+
+    if (size == 0)
+        return;
+
+    buffer[0] = '\0';
+
+    NV_ENTER_RM_RUNTIME(sp,fp);
+
+    if (!pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
+    {
+        os_snprintf(buffer, size, "Disabled, set %s to collect\n",
+                    NV_REG_STR_RM_LOCK_TIME_COLLECT);
+        goto done;
+    }
+
+    pTimes = portMemAllocNonPaged(sizeof(*pTimes) * RM_GPU_LOCK_CMD_TIMES_MAX);
+    if (pTimes == NULL)
+        goto done;
+
+    count = rmGpuLockGetCmdTimes(pTimes, RM_GPU_LOCK_CMD_TIMES_MAX);
+
+    len = os_snprintf(buffer, size, "%-10s %12s %16s %12s", "Command", "Count",
+                      "Total(ns)", "Max(ns)");
+
+    for (bucket = 0; bucket < RM_GPU_LOCK_HOLD_HIST_BUCKETS; bucket++)
+    {
+        if ((len < 0) || ((offset + len) >= size))
+            break;
+
+        offset += len;
+        len = os_snprintf(buffer + offset, size - offset, " %10s", bucketNames[bucket]);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if ((len < 0) || ((offset + len) >= size))
+            break;
+
+        offset += len;
+        len = os_snprintf(buffer + offset, size - offset, "\n0x%08x %12llu %16llu %12llu",
+                          pTimes[i].cmd, pTimes[i].count, pTimes[i].totalHoldTime,
+                          pTimes[i].maxHoldTime);
+
+        for (bucket = 0; bucket < RM_GPU_LOCK_HOLD_HIST_BUCKETS; bucket++)
+        {
+            if ((len < 0) || ((offset + len) >= size))
+                break;
+
+            offset += len;
+            len = os_snprintf(buffer + offset, size - offset, " %10llu",
+                              pTimes[i].holdTimeHist[bucket]);
+        }
+    }
+
+    if ((len >= 0) && ((offset + len) < size))
+    {
+        offset += len;
+        os_snprintf(buffer + offset, size - offset, "\n");
+    }
+
+    portMemFree(pTimes);
+
+done:
+    NV_EXIT_RM_RUNTIME(sp,fp);
+}
+
+#define RM_LOCK_PROF_TOP_SITES 16
+
+//
+// Formats the lock contention profiler sites that made other acquires wait the
+// longest into the given buffer, with their wait and hold time histograms.
+// Call sites are resolved to symbols by the kernel vsnprintf (%pS).
+//
+void NV_API_CALL rm_get_lock_contention(
+    nvidia_stack_t *sp,
+    char *buffer,
+    NvLength size
+)
+{
+    static const char *lockNames[RM_LOCK_PROF_LOCK_COUNT] = { "API", "GPU" };
+    OBJSYS *pSys = SYS_GET_INSTANCE();
+    RM_LOCK_PROF_SITE_INFO *pSites;
+    NvU32  count;
+    NvU32  i;
+    NvU32  bucket;
+    NvS32  len;
+    NvU32  offset = 0;
+    void  *fp;
+
+    if (size == 0)
+        return;
+
+    buffer[0] = '\0';
+
+    NV_ENTER_RM_RUNTIME(sp,fp);
+
+    if (!pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
+    {
+        os_snprintf(buffer, size, "Disabled, set %s to collect\n",
+                    NV_REG_STR_RM_LOCK_TIME_COLLECT);
+        goto done;
+    }
+
+    pSites = portMemAllocNonPaged(sizeof(*pSites) * RM_LOCK_PROF_TOP_SITES);
+    if (pSites == NULL)
+        goto done;
+
+    count = rmLockProfGetTopSites(pSites, RM_LOCK_PROF_TOP_SITES);
+
+    len = os_snprintf(buffer, size,
+                      "Histogram buckets: <1us <10us <100us <1ms <10ms <100ms <1s >=1s, times in ns\n");
+
+    for (i = 0; i < count; i++)
+    {
+        const RM_LOCK_PROF_SITE_INFO *pSite = &pSites[i];
+
+        if ((len < 0) || ((offset + len) >= size))
+            break;
+
+        offset += len;
+        if (pSite->traceOp == RS_LOCK_TRACE_CTRL)
+        {
+            len = os_snprintf(buffer + offset, size - offset, "\n%s lock, control 0x%08x\n",
+                              lockNames[pSite->lock], pSite->traceId);
+        }
+        else if (pSite->traceOp == RS_LOCK_TRACE_ALLOC)
+        {
+            len = os_snprintf(buffer + offset, size - offset, "\n%s lock, alloc class 0x%04x\n",
+                              lockNames[pSite->lock], pSite->traceId);
+        }
+        else if (pSite->traceOp == RS_LOCK_TRACE_FREE)
+        {
+            len = os_snprintf(buffer + offset, size - offset, "\n%s lock, free class 0x%04x\n",
+                              lockNames[pSite->lock], pSite->traceId);
+        }
+        else if (pSite->traceOp != 0)
+        {
+            len = os_snprintf(buffer + offset, size - offset, "\n%s lock, operation %u id 0x%08x\n",
+                              lockNames[pSite->lock], pSite->traceOp, pSite->traceId);
+        }
+        else
+        {
+            len = os_snprintf(buffer + offset, size - offset, "\n%s lock, %pS\n",
+                              lockNames[pSite->lock], (void *)(NvUPtr)pSite->callSite);
+        }
+
+        if ((len < 0) || ((offset + len) >= size))
+            break;
+
+        offset += len;
+        len = os_snprintf(buffer + offset, size - offset,
+                          "  blocked others: %llu times, %llu ns, last owner thread 0x%llx\n"
+                          "  acquires: %llu, wait %llu ns (max %llu), hold %llu ns (max %llu)\n"
+                          "  wait:",
+                          pSite->blockedCount, pSite->blockedTime, pSite->lastOwnerThreadId,
+                          pSite->acquireCount, pSite->totalWaitTime, pSite->maxWaitTime,
+                          pSite->totalHoldTime, pSite->maxHoldTime);
+
+        for (bucket = 0; bucket < RM_LOCK_PROF_HIST_BUCKETS; bucket++)
+        {
+            if ((len < 0) || ((offset + len) >= size))
+                break;
+
+            offset += len;
+            len = os_snprintf(buffer + offset, size - offset, " %llu",
+                              pSite->waitTimeHist[bucket]);
+        }
+
+        if ((len < 0) || ((offset + len) >= size))
+            break;
+
+        offset += len;
+        len = os_snprintf(buffer + offset, size - offset, "\n  hold:");
+
+        for (bucket = 0; bucket < RM_LOCK_PROF_HIST_BUCKETS; bucket++)
+        {
+            if ((len < 0) || ((offset + len) >= size))
+                break;
+
+            offset += len;
+            len = os_snprintf(buffer + offset, size - offset, " %llu",
+                              pSite->holdTimeHist[bucket]);
+        }
+
+        if ((len < 0) || ((offset + len) >= size))
+            break;
+
+        offset += len;
+        len = os_snprintf(buffer + offset, size - offset, "\n");
+    }
+
+    portMemFree(pSites);
+
+done:
+    NV_EXIT_RM_RUNTIME(sp,fp);
+}
+
 //
 // disable GPU SW state persistence
 //
@@ -700,12 +700,12 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_Device[]
 #endif
     },
     {               /*  [40] */
-#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x108u)
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x508u)
         /*pFunc=*/      (void (*)(void)) NULL,
 #else
         /*pFunc=*/      (void (*)(void)) deviceCtrlCmdFifoGetCapsV2_IMPL,
-#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x108u)
-        /*flags=*/      0x108u,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x508u)
+        /*flags=*/      0x508u,
         /*accessRight=*/0x0u,
         /*methodId=*/   0x801713u,
         /*paramSize=*/  sizeof(NV0080_CTRL_FIFO_GET_CAPS_V2_PARAMS),
@@ -1382,7 +1382,7 @@ static void __nvoc_init_funcTable_Device_1(Device *pThis, RmHalspecOwner *pRmhal
 #endif
 
     // deviceCtrlCmdFifoGetCapsV2 -- exported (id=0x801713)
-#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x108u)
+#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x508u)
     pThis->__deviceCtrlCmdFifoGetCapsV2__ = &deviceCtrlCmdFifoGetCapsV2_IMPL;
 #endif
 
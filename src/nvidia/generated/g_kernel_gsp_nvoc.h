@@ -456,6 +456,7 @@ struct KernelGsp {
     NvU64 logElfDataSize;
     PORT_MUTEX *pNvlogFlushMtx;
     NvBool bLibosLogsPollingEnabled;
+    NvBool bLogsDrainedSincePoll;
     NvU8 bootAttempts;
     NvBool bInInit;
     NvBool bInLockdown;
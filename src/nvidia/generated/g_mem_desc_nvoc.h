@@ -767,6 +767,12 @@ NV_STATUS memdescCreateSubMem(MEMORY_DESCRIPTOR **ppMemDescNew,
                               MEMORY_DESCRIPTOR *pMemDesc,
                               OBJGPU *pGpu, NvU64 Offset, NvU64 Size);
 
+// Same as memdescCreateSubMem, into a caller supplied MEMORY_DESCRIPTOR.
+// Only for physically contiguous memory without subdevice memdescs.
+NV_STATUS memdescCreateSubMemExisting(MEMORY_DESCRIPTOR *pMemDescNew,
+                                      MEMORY_DESCRIPTOR *pMemDesc,
+                                      OBJGPU *pGpu, NvU64 Offset, NvU64 Size);
+
 // Compute the physical address of a byte within a MEMORY_DESCRIPTOR
 RmPhysAddr memdescGetPhysAddr(MEMORY_DESCRIPTOR *pMemDesc, ADDRESS_TRANSLATION addressTranslation, NvU64 offset);
 
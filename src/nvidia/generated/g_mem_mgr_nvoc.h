@@ -579,6 +579,7 @@ struct MemoryManager {
     NvBool bBug1698088IncreaseRmReserveMemoryWar;
     NvBool bBug2301372IncreaseRmReserveMemoryWar;
     NvBool bEnableFbsrFileMode;
+    NvBool bRetainFbsrSysMem;
     NvBool bEnableDynamicPageOfflining;
     NvBool bVgpuPmaSupport;
     NvBool bScrubChannelSetupInProgress;
@@ -986,6 +986,8 @@ NV_STATUS osGetValidWindowHeadMask(OS_GPU_INFO *pArg1,
 
 NV_STATUS osSchedule(void);
 
+NV_STATUS osSleepUs(NvU32 microseconds);
+
 void osDmaSetAddressSize(OS_GPU_INFO *pArg1,
                          NvU32 bits);
 
@@ -733,12 +733,12 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_Subdevic
 #endif
     },
     {               /*  [41] */
-#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x48u)
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x448u)
         /*pFunc=*/      (void (*)(void)) NULL,
 #else
         /*pFunc=*/      (void (*)(void)) subdeviceCtrlCmdGpuGetVprCaps_IMPL,
-#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x48u)
-        /*flags=*/      0x48u,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x448u)
+        /*flags=*/      0x448u,
         /*accessRight=*/0x0u,
         /*methodId=*/   0x20800160u,
         /*paramSize=*/  sizeof(NV2080_CTRL_GPU_GET_VPR_CAPS_PARAMS),
@@ -1588,12 +1588,12 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_Subdevic
 #endif
     },
     {               /*  [98] */
-#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x118u)
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x400018u)
         /*pFunc=*/      (void (*)(void)) NULL,
 #else
         /*pFunc=*/      (void (*)(void)) subdeviceCtrlCmdTimerGetTime_IMPL,
-#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x118u)
-        /*flags=*/      0x118u,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x400018u)
+        /*flags=*/      0x400018u,
         /*accessRight=*/0x0u,
         /*methodId=*/   0x20800403u,
         /*paramSize=*/  sizeof(NV2080_CTRL_TIMER_GET_TIME_PARAMS),
@@ -5638,12 +5638,12 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_Subdevic
 #endif
     },
     {               /*  [368] */
-#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x518u)
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x400418u)
         /*pFunc=*/      (void (*)(void)) NULL,
 #else
         /*pFunc=*/      (void (*)(void)) subdeviceCtrlCmdBusGetPciInfo_IMPL,
-#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x518u)
-        /*flags=*/      0x518u,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x400418u)
+        /*flags=*/      0x400418u,
         /*accessRight=*/0x0u,
         /*methodId=*/   0x20801801u,
         /*paramSize=*/  sizeof(NV2080_CTRL_BUS_GET_PCI_INFO_PARAMS),
@@ -5653,12 +5653,12 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_Subdevic
 #endif
     },
     {               /*  [369] */
-#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x518u)
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x400418u)
         /*pFunc=*/      (void (*)(void)) NULL,
 #else
         /*pFunc=*/      (void (*)(void)) subdeviceCtrlCmdBusGetPciBarInfo_IMPL,
-#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x518u)
-        /*flags=*/      0x518u,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x400418u)
+        /*flags=*/      0x400418u,
         /*accessRight=*/0x0u,
         /*methodId=*/   0x20801803u,
         /*paramSize=*/  sizeof(NV2080_CTRL_BUS_GET_PCI_BAR_INFO_PARAMS),
@@ -6913,12 +6913,12 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_Subdevic
 #endif
     },
     {               /*  [453] */
-#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x118u)
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x800518u)
         /*pFunc=*/      (void (*)(void)) NULL,
 #else
         /*pFunc=*/      (void (*)(void)) subdeviceCtrlCmdBusGetNvlinkCaps_DISPATCH,
-#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x118u)
-        /*flags=*/      0x118u,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x800518u)
+        /*flags=*/      0x800518u,
         /*accessRight=*/0x0u,
         /*methodId=*/   0x20803001u,
         /*paramSize=*/  sizeof(NV2080_CTRL_CMD_NVLINK_GET_NVLINK_CAPS_PARAMS),
@@ -9327,7 +9327,7 @@ static void __nvoc_init_funcTable_Subdevice_1(Subdevice *pThis, RmHalspecOwner *
 #endif
 
     // subdeviceCtrlCmdBusGetPciInfo -- exported (id=0x20801801)
-#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x518u)
+#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x400418u)
     pThis->__subdeviceCtrlCmdBusGetPciInfo__ = &subdeviceCtrlCmdBusGetPciInfo_IMPL;
 #endif
 
@@ -9337,7 +9337,7 @@ static void __nvoc_init_funcTable_Subdevice_1(Subdevice *pThis, RmHalspecOwner *
 #endif
 
     // subdeviceCtrlCmdBusGetPciBarInfo -- exported (id=0x20801803)
-#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x518u)
+#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x400418u)
     pThis->__subdeviceCtrlCmdBusGetPciBarInfo__ = &subdeviceCtrlCmdBusGetPciBarInfo_IMPL;
 #endif
 
@@ -11114,7 +11114,7 @@ static void __nvoc_init_funcTable_Subdevice_2(Subdevice *pThis, RmHalspecOwner *
     }
 
     // subdeviceCtrlCmdGpuGetVprCaps -- exported (id=0x20800160)
-#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x48u)
+#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x448u)
     pThis->__subdeviceCtrlCmdGpuGetVprCaps__ = &subdeviceCtrlCmdGpuGetVprCaps_IMPL;
 #endif
 
@@ -11289,7 +11289,7 @@ static void __nvoc_init_funcTable_Subdevice_2(Subdevice *pThis, RmHalspecOwner *
 #endif
 
     // subdeviceCtrlCmdTimerGetTime -- exported (id=0x20800403)
-#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x118u)
+#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x400018u)
     pThis->__subdeviceCtrlCmdTimerGetTime__ = &subdeviceCtrlCmdTimerGetTime_IMPL;
 #endif
 
@@ -97,6 +97,8 @@ void __nvoc_init_dataField_OBJSYS(OBJSYS *pThis) {
     pThis->bUseDeferredClientListFree = ((NvBool)(0 != 0));
 
     pThis->clientListDeferredFreeLimit = 0;
+
+    pThis->clientListDeferredFreeThreads = 0;
 }
 
 NV_STATUS __nvoc_ctor_Object(Object* );
@@ -445,6 +445,7 @@ struct OBJSYS {
     NvU32 currentCid;
     NvBool bUseDeferredClientListFree;
     NvU32 clientListDeferredFreeLimit;
+    NvU32 clientListDeferredFreeThreads;
     OS_RM_CAPS *pOsRmCaps;
     SYS_MEM_EXPORT_CACHE sysMemExportCache;
     PORT_RWLOCK *pSysMemExportModuleLock;
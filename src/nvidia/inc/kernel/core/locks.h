@@ -144,6 +144,64 @@ void        threadPriorityRestore(void);
 
 NV_STATUS  rmGpuGroupLockGetMask(NvU32 gpuInst, GPU_LOCK_GRP_ID gpuGrpId, GPU_MASK* pGpuMask);
 
+//
+// GPU lock hold time histogram of an RM control command, see
+// rmGpuLockGetCmdTimes(). Times are in ns. Bucket 0 counts the hold times
+// below 1us, bucket i the ones in [10^(i-1), 10^i) us, and the last bucket
+// everything from 10^(RM_GPU_LOCK_HOLD_HIST_BUCKETS - 2) us up.
+//
+#define RM_GPU_LOCK_HOLD_HIST_BUCKETS                   8
+
+typedef struct
+{
+    NvU32  cmd;
+    NvU64  count;
+    NvU64  totalHoldTime;
+    NvU64  maxHoldTime;
+    NvU64  holdTimeHist[RM_GPU_LOCK_HOLD_HIST_BUCKETS];
+} RM_GPU_LOCK_CMD_TIMES;
+
+//
+// Lock contention profiler
+//
+// Wait and hold times of the API and GPU locks are accounted per site, along
+// with the time each site made other sites wait while it owned the lock. A
+// site is the resource server operation the lock is taken for (RS_LOCK_TRACE_*
+// and its class or control command) when it is known, and the return address
+// of the lock acquire otherwise. Like the lock times, this is only collected
+// when PDB_PROP_SYS_RM_LOCK_TIME_COLLECT is set.
+//
+#define RM_LOCK_PROF_LOCK_API                           0
+#define RM_LOCK_PROF_LOCK_GPU                           1
+#define RM_LOCK_PROF_LOCK_COUNT                         2
+
+#define RM_LOCK_PROF_HIST_BUCKETS                       RM_GPU_LOCK_HOLD_HIST_BUCKETS
+
+typedef struct RM_LOCK_PROF_SITE RM_LOCK_PROF_SITE;
+
+typedef struct
+{
+    NvU32  lock;                // RM_LOCK_PROF_LOCK_*
+    NvU32  traceOp;             // RS_LOCK_TRACE_*, 0 if the site is callSite
+    NvU32  traceId;             // class or control command of traceOp
+    NvU64  callSite;
+    NvU64  acquireCount;
+    NvU64  totalWaitTime;
+    NvU64  maxWaitTime;
+    NvU64  totalHoldTime;
+    NvU64  maxHoldTime;
+    NvU64  blockedCount;        // acquires that had to wait for this site
+    NvU64  blockedTime;         // time those acquires waited
+    NvU64  lastOwnerThreadId;
+    NvU64  waitTimeHist[RM_LOCK_PROF_HIST_BUCKETS];
+    NvU64  holdTimeHist[RM_LOCK_PROF_HIST_BUCKETS];
+} RM_LOCK_PROF_SITE_INFO;
+
+RM_LOCK_PROF_SITE *rmLockProfGetSite(NvU32 lock, void *ra, NvU32 traceOp, NvU32 traceId);
+void       rmLockProfRecordWait(RM_LOCK_PROF_SITE *pSite, RM_LOCK_PROF_SITE *pBlocker, NvU64 waitTime);
+void       rmLockProfRecordHold(RM_LOCK_PROF_SITE *pSite, NvU64 holdTime);
+NvU32      rmLockProfGetTopSites(RM_LOCK_PROF_SITE_INFO *pInfo, NvU32 maxCount);
+
 //
 // Defines for rmGpuLockSetOwner operation.
 //
@@ -164,6 +222,7 @@ NvU32      rmGpuLocksGetOwnedMask(void);
 NvBool     rmGpuLockIsHidden(OBJGPU *);
 NV_STATUS  rmGpuLockSetOwner(OS_THREAD_HANDLE);
 void       rmGpuLockGetTimes(NV0000_CTRL_SYSTEM_GET_LOCK_TIMES_PARAMS *);
+NvU32      rmGpuLockGetCmdTimes(RM_GPU_LOCK_CMD_TIMES *, NvU32);
 NV_STATUS  rmGpuGroupLockAcquire(NvU32, GPU_LOCK_GRP_ID, NvU32, NvU32, GPU_MASK *);
 NV_STATUS  rmGpuGroupLockRelease(GPU_MASK, NvU32);
 NvBool     rmGpuGroupLockIsOwner(NvU32, GPU_LOCK_GRP_ID, GPU_MASK*);
@@ -54,6 +54,19 @@ struct OBJCHANNEL;
 #define SIZE_OF_ONE_MEMSET_BLOCK                  0x60
 #define SCRUB_MAX_BYTES_PER_LINE                  0xffffffffULL
 #define MAX_SCRUB_ITEMS                           4096 // 4K scrub items
+#define SCRUBBER_MAX_CHANNELS                     4
+#define SCRUBBER_STRIPE_SIZE                      0x4000000ULL   //64MB
+
+//
+// Flags for scrubSubmitPages()
+//
+// SCRUB_SUBMIT_FLAGS_PRIORITY: the pages are scrubbed on behalf of an
+// allocation waiting for them, e.g. after an eviction. When the scrubber has
+// more than one channel, such work goes to a channel that background scrubbing
+// of freed pages doesn't use.
+//
+#define SCRUB_SUBMIT_FLAGS_NONE                   0x0
+#define SCRUB_SUBMIT_FLAGS_PRIORITY               NVBIT(0)
 
 // structure to store the details of a scrubbing work
 typedef struct SCRUB_NODE {
@@ -63,6 +76,10 @@ typedef struct SCRUB_NODE {
     NvU64      base;
     // The size of a scrub work
     NvU64      size;
+    // The scrubber channel the work was submitted to
+    NvU32      channel;
+    // The ID of the work in the sequence of its channel
+    NvU64      channelWorkId;
 } SCRUB_NODE, *PSCRUB_NODE;
 
 //
@@ -72,6 +89,11 @@ typedef struct SCRUB_NODE {
 // the scrub work list. The scrubber data structures are
 // synchronized using the mutex pScrubberMutex.
 //
+// Work is striped across up to SCRUBBER_MAX_CHANNELS CE channels, each on its
+// own CE. Work IDs are still assigned in submission order, and an ID only
+// completes once all the work submitted before it has, whatever channel it
+// went to, so that completed work can be handed back to PMA in order.
+//
 
 typedef struct OBJMEMSCRUB {
     // Mutex for Scrubber Object
@@ -87,14 +109,20 @@ typedef struct OBJMEMSCRUB {
     // Pre-allocated Free Scrub List
     PSCRUB_NODE                        pScrubList;
 #if !defined(SRT_BUILD)
-    // Scrubber uses ceUtils to manage CE channel
-    CeUtils                           *pCeUtils;
+    // Scrubber uses ceUtils to manage CE channels
+    CeUtils                           *pCeUtils[SCRUBBER_MAX_CHANNELS];
 
     // Scrubber uses sec2Utils to manage SEC2 channel
     Sec2Utils                         *pSec2Utils;
 #endif //  !defined(SRT_BUILD)
     // Engine used for scrubbing 
     NvU32                              engineType;
+    // Number of channels work is submitted to
+    NvU32                              numChannels;
+    // Next channel to submit background work to
+    NvU32                              nextChannel;
+    // PMA statistics updated with the scrub backlog
+    struct _PMA_STATS                 *pPmaStats;
 
     struct OBJGPU                     *pGpu;
     VGPU_GUEST_PMA_SCRUB_BUFFER_RING   vgpuScrubBuffRing;
@@ -154,6 +182,7 @@ NV_STATUS scrubCheck(OBJMEMSCRUB *pScrubber, PSCRUB_NODE *ppList, NvU64 *size);
  * @param[in] chunkSize   NvU64 size of each page
  * @param[in] pPages     NvU64 array of base address
  * @param[in] pageCount  NvU64 number of pages
+ * @param[in] flags      SCRUB_SUBMIT_FLAGS_*
  * @param[out] ppList     SCRUB_NODE double pointer to hand off the list
  * @param[out] pSize      NvU64 pointer to store the size
  *
@@ -161,7 +190,7 @@ NV_STATUS scrubCheck(OBJMEMSCRUB *pScrubber, PSCRUB_NODE *ppList, NvU64 *size);
  */
 
 NV_STATUS scrubSubmitPages(OBJMEMSCRUB *pScrubber, NvU64 chunkSize, NvU64* pages,
-                           NvU64 pageCount, PSCRUB_NODE *ppList, NvU64 *size);
+                           NvU64 pageCount, NvU32 flags, PSCRUB_NODE *ppList, NvU64 *size);
 
 /**
  *  This function waits for the memory scrubber to wait for the scrubbing of
@@ -106,6 +106,8 @@ typedef struct _PMA_STATS
     NvU64 num2mbPagesProtected;      // PMA-wide total number of 2MB pages in protected memory
     NvU64 numFreeFramesProtected;    // PMA-wide free 64KB frame count in protected memory
     NvU64 numFree2mbPagesProtected;  // PMA-wide free 2MB pages count in protected memory
+    NvU64 numScrubPendingFrames;     // PMA-wide 64KB frame count submitted to the scrubber and not scrubbed yet
+    NvU64 numScrubbedFrames;         // PMA-wide 64KB frame count scrubbed by the scrubber so far
 #endif // !defined(NVWATCH)
 } PMA_STATS;
 
@@ -51,6 +51,9 @@ typedef struct pma_regmap
     NvU64 frameEvictionsInProcess;    /* Count of frame evictions in-process */
     PMA_STATS *pPmaStats;             /* Point back to the public struct in PMA structure */
     NvBool bProtected;                /* The memory segment tracked by this regmap is protected (VPR/CPR) */
+    NvU64 numChunks;                  /* Number of 64MB chunks summarized below */
+    NvU32 *pChunkAllocFrames;         /* Per chunk count of allocated (pinned or unpinned) frames */
+    NvU32 *pChunkPinFrames;           /* Per chunk count of pinned frames */
 } PMA_REGMAP;
 
 void pmaRegmapPrint(PMA_REGMAP *pMap);
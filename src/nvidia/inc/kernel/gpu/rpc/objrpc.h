@@ -92,6 +92,10 @@ struct OBJRPC{
     NvU32 timeoutCount;
     NvBool bQuietPrints;
 
+    // Responses received by the GSP RPC poll loop while spinning / after sleeping
+    NvU64 pollSpinCount;
+    NvU64 pollSleepCount;
+
     OBJRPCSTRUCTURECOPY rpcStructureCopy;
 };
 
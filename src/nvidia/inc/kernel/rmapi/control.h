@@ -337,8 +337,22 @@ NV_STATUS embeddedParamCopyOut(RMAPI_PARAM_COPY  *pParamCopy, RmCtrlParams *pRmC
 // experts first and please consider other alternatives as much as possible
 // before resorting to using this flag!
 //
+// It must be combined with either NO_GPUS_LOCK or GPU_LOCK_DEVICE_ONLY. With
+// GPU_LOCK_DEVICE_ONLY, the control only serializes against other users of the
+// same device, so it is suited to read-only controls that are polled often and
+// only touch state owned by that device (the client lock still protects the
+// resource tree of the caller).
+//
 #define RMCTRL_FLAGS_NO_API_LOCK                              0x000400000
 
+//
+// This flag specifies that the output of a CACHEABLE control depends on the
+// GPU configuration (MIG mode and GPU instances, NVLink link state). The
+// cached value is dropped by rmapiControlCacheInvalidateGpuConfig() when that
+// configuration changes, instead of being kept for the lifetime of the GPU.
+//
+#define RMCTRL_FLAGS_CACHE_INVALIDATE_ON_GPU_CONFIG           0x000800000
+
 //
 //  'ACCESS_RIGHTS' Attribute
 //  ------------------------
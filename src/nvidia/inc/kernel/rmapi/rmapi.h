@@ -82,6 +82,19 @@ void rmapiShutdown(void);
  */
 NV_STATUS rmapiLockAcquire(NvU32 flags, NvU32 module);
 
+/**
+ * Acquire the RM API Lock for a resource server operation
+ *
+ * Same as rmapiLockAcquire, except that the lock contention profiler accounts
+ * the wait and hold times to the operation rather than to the caller.
+ *
+ * @param[in] flags   RM_LOCK_FLAGS_*
+ * @param[in] module  RM_LOCK_MODULES_*
+ * @param[in] traceOp RS_LOCK_TRACE_* operation, 0 if unknown
+ * @param[in] traceId Class or control command of the operation
+ */
+NV_STATUS rmapiLockAcquireForOp(NvU32 flags, NvU32 module, NvU32 traceOp, NvU32 traceId);
+
 /**
  * Release RM API Lock
  */
@@ -306,14 +319,26 @@ NV_STATUS rmapiControlCacheGet(NvHandle hClient, NvHandle hObject, NvU32 cmd,
                                void* params, NvU32 paramsSize);
 NV_STATUS rmapiControlCacheSet(NvHandle hClient, NvHandle hObject, NvU32 cmd,
                                void* params, NvU32 paramsSize);
+NV_STATUS rmapiControlCacheGetInfoIndex(NvHandle hClient, NvHandle hObject, NvU32 cmd,
+                                        NvU32 index, NvU32 *pData);
 NV_STATUS rmapiControlCacheSetGpuAttrForObject(NvHandle hClient, NvHandle hObject, OBJGPU *pGpu);
 void rmapiControlCacheFreeAllCacheForGpu(NvU32 gpuInst);
+void rmapiControlCacheInvalidateGpuConfig(NvU32 gpuInst);
 void rmapiControlCacheSetMode(NvU32 mode);
 NvU32 rmapiControlCacheGetMode(void);
 void rmapiControlCacheFree(void);
 void rmapiControlCacheFreeClientEntry(NvHandle hClient);
 void rmapiControlCacheFreeObjectEntry(NvHandle hClient, NvHandle hObject);
 
+typedef struct
+{
+    NvU32 cmd;
+    NvU64 hits;
+    NvU64 misses;
+} RMAPI_CONTROL_CACHE_STATS;
+
+NvU32 rmapiControlCacheGetStats(RMAPI_CONTROL_CACHE_STATS *pStats, NvU32 maxCount);
+
 typedef struct _RM_API_CONTEXT {
     NvU32 gpuMask;
 } RM_API_CONTEXT;
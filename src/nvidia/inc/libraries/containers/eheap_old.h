@@ -47,6 +47,11 @@ struct EMEMBLOCK
     NODE       node;
     EMEMBLOCK *prevFree;
     EMEMBLOCK *nextFree;
+    // free block index (treap keyed by begin, see eheap_old.c)
+    EMEMBLOCK *freeLeft;
+    EMEMBLOCK *freeRight;
+    NvU64      freeMaxSize;
+    NvU32      freePriority;
     EMEMBLOCK *prev;
     EMEMBLOCK *next;
     void      *pData;
@@ -98,6 +103,8 @@ struct OBJEHEAP
     NvU32      ownerGranularity;
     EMEMBLOCK *pBlockList;
     EMEMBLOCK *pFreeBlockList;
+    EMEMBLOCK *pFreeBlockTree;
+    NvU32      freeTreeSeed;
     NvU32      memHandle;
     NvU32      numBlocks;
     NvU32      sizeofMemBlock;
@@ -59,6 +59,24 @@ typedef struct AccessBackRef
 
 MAKE_LIST(AccessBackRefList, AccessBackRef);
 
+/**
+ * Open-addressing index of a client's resource references by handle
+ *
+ * The references are owned by the client's resourceMap; this only speeds up
+ * handle lookups on the control and alloc paths. Slots are linear probed and
+ * are NULL when empty. If the index cannot be grown it is disabled and lookups
+ * fall back to the resourceMap.
+ */
+typedef struct RsRefIndex
+{
+    PORT_MEM_ALLOCATOR *pAllocator;
+    RsResourceRef     **ppSlots;
+    NvU32               slotCount; ///< Power of 2, 0 if nothing was inserted yet
+    NvU32               hashShift;
+    NvU32               refCount;
+    NvBool              bDisabled;
+} RsRefIndex;
+
 /**
  * Information about a client
  */
@@ -95,11 +113,22 @@ public:
      */
     NvBool bHighPriorityFreeDone;
 
+    /**
+     * True if a thread in serverFreeDisabledClients is freeing this client.
+     * Protected by the server's pDisabledClientListLock.
+     */
+    NvBool bFreeClaimed;
+
     /**
      * Maps resource handle -> RsResourceRef
      */
     RsRefMap resourceMap;
 
+    /**
+     * Hash index of resourceMap, used for lookups by handle
+     */
+    RsRefIndex resourceIndex;
+
     /**
      * Access right back reference list of <hClient, hResource> pairs
      *
@@ -149,6 +149,7 @@ struct RS_RES_FREE_PARAMS_INTERNAL
     RsResourceRef     *pResourceRef;    ///< [inout] Cached RsResourceRef
     NV_STATUS          status;          ///< [out] Status of free operation
     API_SECURITY_INFO *pSecInfo;        ///< [in] Security info
+    NvU32             *pResLockReleaseFlags; ///< [inout] If set, leave the resource lock held for the caller
 };
 
 struct NVOC_EXPORTED_METHOD_DEF;
@@ -317,6 +317,11 @@ NV_STATUS serverMarkClientListDisabled(RsServer *pServer, NvHandle *phClientList
  * any of the clients will be freed.
  * All priority resources will be freed first across all listed clients.
  *
+ * Several threads may call this at once; each client is freed by only one of
+ * them at a time, and the priority ordering then only holds across the
+ * clients freed by the same thread. A call returns once no disabled client is
+ * left that isn't being freed by another thread.
+ *
  * NOTE: may return NV_WARN_MORE_PROCESSING_REQUIRED if not all clients were freed
  *
  * @param[in]   pServer   This server instance
@@ -853,6 +853,15 @@
 // Encoding 0 (default) - Enable Fast Scrubber
 //          1           - Disable Fast Scrubber
 
+#define  NV_REG_STR_RM_SCRUBBER_CHANNELS              "RMScrubberChannels"
+// Type DWORD
+// Encoding Numeric Value
+// Maximum number of CE channels, each on a different CE, used by the PMA
+// scrubber. Values larger than 4 are capped to 4. Only one channel is used
+// with MIG or when scrubbing with SEC2.
+// 0 (default) - One channel per usable async CE
+// 1           - Single channel
+
 //
 // Type DWORD
 // Controls enable of PMA memory management instead of existing legacy
@@ -1186,6 +1195,17 @@
 // 0 - Disable (default)
 // 1 - Enable
 
+#define NV_REG_STR_RM_FBSR_RETAIN_SYSMEM                     "RmFbsrRetainSysMem"
+#define NV_REG_STR_RM_FBSR_RETAIN_SYSMEM_ENABLE              1
+#define NV_REG_STR_RM_FBSR_RETAIN_SYSMEM_DISABLE             0
+#define NV_REG_STR_RM_FBSR_RETAIN_SYSMEM_DEFAULT             NV_REG_STR_RM_FBSR_RETAIN_SYSMEM_DISABLE
+// Type Dword
+// Encoding Numeric Value
+// Keep the system memory used by DMA type FBSR allocated after resume, so
+// that following suspends reuse it instead of allocating it again.
+// 0 - Disable (default)
+// 1 - Enable
+
 #define NV_REG_STR_RM_FBSR_WDDM_MODE                         "RmFbsrWDDMMode"
 #define NV_REG_STR_RM_FBSR_WDDM_MODE_ENABLE                  1
 #define NV_REG_STR_RM_FBSR_WDDM_MODE_DISABLE                 0
@@ -1875,6 +1895,22 @@
 //
 #define NV_REG_STR_RM_CLIENT_LIST_DEFERRED_FREE_LIMIT      "RMClientListDeferredFreeLimit"
 
+//
+// Type: DWORD
+//
+// Number of work items freeing disabled clients in parallel. Each client is
+// still freed by a single work item, so this helps when a process exits with
+// several clients, e.g. one per GPU.
+//
+// Only valid if NV_REG_STR_RM_CLIENT_LIST_DEFERRED_FREE is set. Clients are
+// only torn down concurrently if NV_REG_STR_RM_READONLY_API_LOCK enables
+// _FREE_RESOURCE; otherwise they serialize on the API lock and a single work
+// item is used.
+//
+// Value of 0 (default) means one work item per attached GPU.
+//
+#define NV_REG_STR_RM_CLIENT_LIST_DEFERRED_FREE_THREADS    "RMClientListDeferredFreeThreads"
+
 //
 // TYPE Dword
 // Determines whether or not to emulate VF MMU TLB Invalidation register range
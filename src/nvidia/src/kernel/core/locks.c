@@ -81,8 +81,56 @@ typedef struct
     NvU16               priority;
     NvU16               priorityPrev;
     NvU64               timestamp;
+    RM_LOCK_PROF_SITE  *pProfSite;  // Lock contention profiler site of the owner
 } GPULOCK;
 
+//
+// GPU lock hold times of one RM control command. The slots are claimed with an
+// atomic compare and swap of cmd, 0 being a free slot, and are never released,
+// so they are updated and read without taking any lock.
+//
+typedef struct
+{
+    volatile NvU32      cmd;
+    volatile NvU64      count;
+    volatile NvU64      totalHoldTime;
+    volatile NvU64      maxHoldTime;
+    volatile NvU64      holdTimeHist[RM_GPU_LOCK_HOLD_HIST_BUCKETS];
+} GPULOCKCMDTIMES;
+
+#define GPU_LOCK_CMD_TIMES_MAX_CMDS                     64
+
+//
+// Lock contention profiler site, see locks.h. Sites live in a fixed open
+// addressing table per lock and are claimed with an atomic compare and swap of
+// key, 0 being a free slot. They are never released, so they are updated and
+// read without taking any lock, and key alone identifies the site: the
+// RS_LOCK_TRACE_* operation in bits 32..39 and its class or command in bits
+// 0..31 for operations, the return address of the acquire otherwise (kernel
+// addresses never fit in 40 bits).
+//
+struct RM_LOCK_PROF_SITE
+{
+    volatile NvU64      key;
+    volatile NvU64      acquireCount;
+    volatile NvU64      totalWaitTime;
+    volatile NvU64      maxWaitTime;
+    volatile NvU64      totalHoldTime;
+    volatile NvU64      maxHoldTime;
+    volatile NvU64      blockedCount;
+    volatile NvU64      blockedTime;
+    volatile NvU64      lastOwnerThreadId;
+    volatile NvU64      waitTimeHist[RM_LOCK_PROF_HIST_BUCKETS];
+    volatile NvU64      holdTimeHist[RM_LOCK_PROF_HIST_BUCKETS];
+};
+
+#define RM_LOCK_PROF_MAX_SITES                          128     // per lock, power of 2
+#define RM_LOCK_PROF_OP_KEY_LIMIT                       NVBIT64(40)
+
+ct_assert((RM_LOCK_PROF_MAX_SITES & (RM_LOCK_PROF_MAX_SITES - 1)) == 0);
+
+static RM_LOCK_PROF_SITE rmLockProfSites[RM_LOCK_PROF_LOCK_COUNT][RM_LOCK_PROF_MAX_SITES];
+
 //
 // GPU lock info
 //
@@ -168,6 +216,11 @@ typedef struct
     // Total time spent holding GPU locks.
     //
     volatile NvU64               totalHoldTime;
+
+    //
+    // GPU lock hold times of RM control commands, see _rmGpuLockCmdTimesUpdate.
+    //
+    GPULOCKCMDTIMES              cmdTimes[GPU_LOCK_CMD_TIMES_MAX_CMDS];
 } GPULOCKINFO;
 
 static GPULOCKINFO rmGpuLockInfo;
@@ -181,6 +234,9 @@ static NvU32     _rmGpuLocksRelease(NvU32, NvU32, OBJGPU *, void *);
 static NvBool    _rmGpuAllocLockIsOwner(void);
 static NvBool    _rmGpuLockIsOwner(NvU32);
 
+static void      _rmGpuLockCmdTimesUpdate(NvU64);
+static RM_LOCK_PROF_SITE *_rmGpuLockProfGetSite(void *);
+
 
 //
 // Determines the gpuInst value for the first iteration of a loop
@@ -725,10 +781,16 @@ _rmGpuLocksAcquire(NvU32 gpuMask, NvU32 flags, NvU32 module, void *ra, NvU32 *pG
     NvBool    bLockAll = NV_FALSE;
     NvBool    bAcquireAllocLock = NV_FALSE;
     NvU32     loopCount;
+    RM_LOCK_PROF_SITE *pProfSite = NULL;
+    RM_LOCK_PROF_SITE *pProfBlocker = NULL;
 
     bHighIrql = (portSyncExSafeToSleep() == NV_FALSE);
     bCondAcquireCheck = ((flags & GPU_LOCK_FLAGS_COND_ACQUIRE) != 0);
 
+    // Resolve the contention profiler site before taking the spinlock
+    if (pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
+        pProfSite = _rmGpuLockProfGetSite(ra);
+
     if (pGpuLockedMask)
         *pGpuLockedMask = 0;
 
@@ -936,6 +998,10 @@ _rmGpuLocksAcquire(NvU32 gpuMask, NvU32 flags, NvU32 module, void *ra, NvU32 *pG
         //
         if (!bCondAcquireCheck && (pGpuLock->count <= 0))
         {
+            // The owner of the first busy lock is the one we end up waiting for
+            if (pProfBlocker == NULL)
+                pProfBlocker = pGpuLock->pProfSite;
+
             //
             // Assert that this is not already the owner of the GpusLock
             // (the lock will cause a hang if acquired recursively)
@@ -1084,6 +1150,7 @@ per_gpu_lock_acquired:
         pGpuLock->priority = priority;
         pGpuLock->priorityPrev = priorityPrev;
         pGpuLock->timestamp = timestamp;
+        pGpuLock->pProfSite = pProfSite;
 
 next_gpu_instance:
         ;
@@ -1095,6 +1162,8 @@ next_gpu_instance:
         osGetCurrentTick(&timestamp);
 
         portAtomicExAddU64(&rmGpuLockInfo.totalWaitTime, timestamp - startWaitTime);
+
+        rmLockProfRecordWait(pProfSite, pProfBlocker, timestamp - startWaitTime);
     }
 
     // update gpusLockedMask
@@ -1570,6 +1639,7 @@ _rmGpuLocksRelease(NvU32 gpuMask, NvU32 flags, OBJGPU *pDpcGpu, void *ra)
     NvU64   priorityPrev = 0;
     NvU64   timestamp;
     NvU64   startHoldTime = 0;
+    RM_LOCK_PROF_SITE *pProfSite = NULL;
     NvBool  bReleaseAllocLock = NV_FALSE;
     NvBool  bAllocLockWakeup = NV_FALSE;
     NV_STATUS status;
@@ -1687,7 +1757,10 @@ _rmGpuLocksRelease(NvU32 gpuMask, NvU32 flags, OBJGPU *pDpcGpu, void *ra)
 
         // Start of GPU lock hold time is the first acquired GPU lock
         if (pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
+        {
             startHoldTime = pGpuLock->timestamp;
+            pProfSite = pGpuLock->pProfSite;
+        }
 
         if (pGpuLock->count < 0)
         {
@@ -1748,6 +1821,7 @@ _rmGpuLocksRelease(NvU32 gpuMask, NvU32 flags, OBJGPU *pDpcGpu, void *ra)
             NV_ASSERT(pGpuLock->threadId == threadId);
             pGpuLock->bRunning = NV_FALSE;
             pGpuLock->threadId = ~(NvU64)0;
+            pGpuLock->pProfSite = NULL;
 
             portAtomicIncrementS32(&pGpuLock->count);
             NV_ASSERT(pGpuLock->count <= 1);
@@ -1895,6 +1969,9 @@ done:
 
         portAtomicExAddU64(&rmGpuLockInfo.totalHoldTime,
             timestamp - startHoldTime);
+
+        _rmGpuLockCmdTimesUpdate(timestamp - startHoldTime);
+        rmLockProfRecordHold(pProfSite, timestamp - startHoldTime);
     }
 
     threadPriorityRestore();
@@ -2237,6 +2314,300 @@ rmGpuLockGetTimes(NV0000_CTRL_SYSTEM_GET_LOCK_TIMES_PARAMS *pParams)
     pParams->waitGpuLock = rmGpuLockInfo.totalWaitTime;
 }
 
+//
+// Histogram bucket of a lock wait or hold time in ns, see
+// RM_GPU_LOCK_HOLD_HIST_BUCKETS.
+//
+static NvU32
+_rmLockTimeHistBucket(NvU64 time)
+{
+    NvU64 bucketLimit = 1000; // 1us in ns
+    NvU32 bucket;
+
+    for (bucket = 0; bucket < RM_GPU_LOCK_HOLD_HIST_BUCKETS - 1; bucket++)
+    {
+        if (time < bucketLimit)
+            break;
+        bucketLimit *= 10;
+    }
+
+    return bucket;
+}
+
+static void
+_rmLockTimeUpdateMax(volatile NvU64 *pMax, NvU64 time)
+{
+    NvU64 max = *pMax;
+
+    while ((time > max) && !portAtomicExCompareAndSwapU64(pMax, time, max))
+        max = *pMax;
+}
+
+//
+// _rmGpuLockCmdTimesUpdate
+//
+// Account a GPU lock hold time to the RM control command being executed by
+// the current thread, if any. Locks taken outside of a control (allocations,
+// ISR/DPC, work items) only count towards totalHoldTime.
+//
+static void
+_rmGpuLockCmdTimesUpdate(NvU64 holdTime)
+{
+    CALL_CONTEXT *pCallContext = resservGetTlsCallContext();
+    GPULOCKCMDTIMES *pTimes;
+    NvU32 cmd;
+    NvU32 i;
+
+    if ((pCallContext == NULL) || (pCallContext->pControlParams == NULL))
+        return;
+
+    cmd = pCallContext->pControlParams->cmd;
+    if (cmd == 0)
+        return;
+
+    for (i = 0; i < GPU_LOCK_CMD_TIMES_MAX_CMDS; i++)
+    {
+        pTimes = &rmGpuLockInfo.cmdTimes[i];
+
+        if (pTimes->cmd == 0)
+            portAtomicCompareAndSwapU32(&pTimes->cmd, cmd, 0);
+
+        if (pTimes->cmd == cmd)
+            break;
+    }
+
+    // All slots taken by other commands
+    if (i == GPU_LOCK_CMD_TIMES_MAX_CMDS)
+        return;
+
+    portAtomicExIncrementU64(&pTimes->count);
+    portAtomicExAddU64(&pTimes->totalHoldTime, holdTime);
+    portAtomicExIncrementU64(&pTimes->holdTimeHist[_rmLockTimeHistBucket(holdTime)]);
+    _rmLockTimeUpdateMax(&pTimes->maxHoldTime, holdTime);
+}
+
+//
+// rmGpuLockGetCmdTimes
+//
+// Retrieve the GPU lock hold times of up to maxCount RM control commands,
+// in the order they were first seen. Returns the number of entries filled in.
+// Nothing is collected unless PDB_PROP_SYS_RM_LOCK_TIME_COLLECT is set.
+//
+NvU32
+rmGpuLockGetCmdTimes(RM_GPU_LOCK_CMD_TIMES *pTimes, NvU32 maxCount)
+{
+    NvU32 count = 0;
+    NvU32 i;
+    NvU32 bucket;
+
+    for (i = 0; (i < GPU_LOCK_CMD_TIMES_MAX_CMDS) && (count < maxCount); i++)
+    {
+        const GPULOCKCMDTIMES *pSlot = &rmGpuLockInfo.cmdTimes[i];
+
+        if (pSlot->cmd == 0)
+            break;
+
+        pTimes[count].cmd = pSlot->cmd;
+        pTimes[count].count = pSlot->count;
+        pTimes[count].totalHoldTime = pSlot->totalHoldTime;
+        pTimes[count].maxHoldTime = pSlot->maxHoldTime;
+        for (bucket = 0; bucket < RM_GPU_LOCK_HOLD_HIST_BUCKETS; bucket++)
+            pTimes[count].holdTimeHist[bucket] = pSlot->holdTimeHist[bucket];
+        count++;
+    }
+
+    return count;
+}
+
+//
+// rmLockProfGetSite
+//
+// Find or claim the contention profiler site of lock for the given operation,
+// or for the acquire return address ra if traceOp is 0. Returns NULL if the
+// table is full.
+//
+RM_LOCK_PROF_SITE *
+rmLockProfGetSite(NvU32 lock, void *ra, NvU32 traceOp, NvU32 traceId)
+{
+    NvU64 key;
+    NvU32 idx;
+    NvU32 i;
+
+    if (lock >= RM_LOCK_PROF_LOCK_COUNT)
+        return NULL;
+
+    if (traceOp != 0)
+        key = ((NvU64)(traceOp & 0xff) << 32) | traceId;
+    else
+        key = (NvU64)(NvUPtr)ra;
+
+    if ((key == 0) || ((traceOp == 0) && (key < RM_LOCK_PROF_OP_KEY_LIMIT)))
+        return NULL;
+
+    // Fibonacci hashing, which spreads nearby return addresses well
+    idx = (NvU32)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (RM_LOCK_PROF_MAX_SITES - 1);
+
+    for (i = 0; i < RM_LOCK_PROF_MAX_SITES; i++)
+    {
+        RM_LOCK_PROF_SITE *pSite = &rmLockProfSites[lock][idx];
+
+        if (pSite->key == 0)
+            portAtomicExCompareAndSwapU64(&pSite->key, key, 0);
+
+        if (pSite->key == key)
+            return pSite;
+
+        idx = (idx + 1) & (RM_LOCK_PROF_MAX_SITES - 1);
+    }
+
+    return NULL;
+}
+
+//
+// rmLockProfRecordWait
+//
+// Account a successful acquire at pSite that waited waitTime ns. pBlocker is
+// the site that owned the lock when the wait started, if known.
+//
+void
+rmLockProfRecordWait(RM_LOCK_PROF_SITE *pSite, RM_LOCK_PROF_SITE *pBlocker, NvU64 waitTime)
+{
+    if (pSite == NULL)
+        return;
+
+    portAtomicExIncrementU64(&pSite->acquireCount);
+    portAtomicExAddU64(&pSite->totalWaitTime, waitTime);
+    portAtomicExIncrementU64(&pSite->waitTimeHist[_rmLockTimeHistBucket(waitTime)]);
+    _rmLockTimeUpdateMax(&pSite->maxWaitTime, waitTime);
+
+    if (pBlocker != NULL)
+    {
+        portAtomicExIncrementU64(&pBlocker->blockedCount);
+        portAtomicExAddU64(&pBlocker->blockedTime, waitTime);
+    }
+}
+
+//
+// rmLockProfRecordHold
+//
+// Account a release of a lock acquired at pSite, held for holdTime ns, by the
+// current thread.
+//
+void
+rmLockProfRecordHold(RM_LOCK_PROF_SITE *pSite, NvU64 holdTime)
+{
+    if (pSite == NULL)
+        return;
+
+    portAtomicExAddU64(&pSite->totalHoldTime, holdTime);
+    portAtomicExIncrementU64(&pSite->holdTimeHist[_rmLockTimeHistBucket(holdTime)]);
+    _rmLockTimeUpdateMax(&pSite->maxHoldTime, holdTime);
+    pSite->lastOwnerThreadId = portThreadGetCurrentThreadId();
+}
+
+//
+// rmLockProfGetTopSites
+//
+// Retrieve up to maxCount profiler sites of all locks, the ones that made
+// others wait the longest first, then the ones that waited the longest.
+// Returns the number of entries filled in.
+//
+NvU32
+rmLockProfGetTopSites(RM_LOCK_PROF_SITE_INFO *pInfo, NvU32 maxCount)
+{
+    NvU32 count = 0;
+    NvU32 lock;
+    NvU32 i;
+    NvU32 bucket;
+
+    if (maxCount == 0)
+        return 0;
+
+    for (lock = 0; lock < RM_LOCK_PROF_LOCK_COUNT; lock++)
+    {
+        for (i = 0; i < RM_LOCK_PROF_MAX_SITES; i++)
+        {
+            const RM_LOCK_PROF_SITE *pSite = &rmLockProfSites[lock][i];
+            RM_LOCK_PROF_SITE_INFO info;
+            NvU32 pos;
+
+            if (pSite->key == 0)
+                continue;
+
+            portMemSet(&info, 0, sizeof(info));
+            info.lock = lock;
+            if (pSite->key < RM_LOCK_PROF_OP_KEY_LIMIT)
+            {
+                info.traceOp = (NvU32)(pSite->key >> 32);
+                info.traceId = NvU64_LO32(pSite->key);
+            }
+            else
+            {
+                info.callSite = pSite->key;
+            }
+            info.acquireCount = pSite->acquireCount;
+            info.totalWaitTime = pSite->totalWaitTime;
+            info.maxWaitTime = pSite->maxWaitTime;
+            info.totalHoldTime = pSite->totalHoldTime;
+            info.maxHoldTime = pSite->maxHoldTime;
+            info.blockedCount = pSite->blockedCount;
+            info.blockedTime = pSite->blockedTime;
+            info.lastOwnerThreadId = pSite->lastOwnerThreadId;
+            for (bucket = 0; bucket < RM_LOCK_PROF_HIST_BUCKETS; bucket++)
+            {
+                info.waitTimeHist[bucket] = pSite->waitTimeHist[bucket];
+                info.holdTimeHist[bucket] = pSite->holdTimeHist[bucket];
+            }
+
+            // Insertion into the sorted output, dropping the last if full
+            for (pos = count; pos > 0; pos--)
+            {
+                const RM_LOCK_PROF_SITE_INFO *pPrev = &pInfo[pos - 1];
+
+                if ((pPrev->blockedTime > info.blockedTime) ||
+                    ((pPrev->blockedTime == info.blockedTime) &&
+                     (pPrev->totalWaitTime >= info.totalWaitTime)))
+                {
+                    break;
+                }
+
+                if (pos < maxCount)
+                    pInfo[pos] = *pPrev;
+            }
+
+            if (pos < maxCount)
+            {
+                pInfo[pos] = info;
+                if (count < maxCount)
+                    count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+//
+// Contention profiler site of a GPU lock acquire by the current thread: the
+// operation of the resource server call in progress if there is one, else
+// the acquire return address.
+//
+static RM_LOCK_PROF_SITE *
+_rmGpuLockProfGetSite(void *ra)
+{
+    CALL_CONTEXT *pCallContext = resservGetTlsCallContext();
+
+    if ((pCallContext != NULL) && (pCallContext->pLockInfo != NULL) &&
+        (pCallContext->pLockInfo->traceOp != 0))
+    {
+        return rmLockProfGetSite(RM_LOCK_PROF_LOCK_GPU, ra,
+                                 pCallContext->pLockInfo->traceOp,
+                                 pCallContext->pLockInfo->traceClassId);
+    }
+
+    return rmLockProfGetSite(RM_LOCK_PROF_LOCK_GPU, ra, 0, 0);
+}
+
 //
 // rmDeviceGpuLockSetOwner
 //
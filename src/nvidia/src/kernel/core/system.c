@@ -432,6 +432,12 @@ _sysRegistryOverrideResourceServer
     {
         pSys->clientListDeferredFreeLimit = data32;
     }
+
+    if (osReadRegistryDword(pGpu, NV_REG_STR_RM_CLIENT_LIST_DEFERRED_FREE_THREADS,
+                            &data32) == NV_OK)
+    {
+        pSys->clientListDeferredFreeThreads = data32;
+    }
 }
 
 static void
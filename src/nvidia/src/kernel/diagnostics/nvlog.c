@@ -545,18 +545,36 @@ nvlogRingBufferPush
 {
     NvU32 writeSize;
     NvU32 oldPos;
+    NvU32 newPos;
+    NvU32 overflow;
     NvU32 lock = DRF_VAL(LOG, _BUFFER_FLAGS, _LOCKING, pBuffer->flags);
 
-    if (lock != NVLOG_BUFFER_FLAGS_LOCKING_NONE)
-        portSyncSpinlockAcquire(NvLogLogger.mainLock);
+    if (lock == NVLOG_BUFFER_FLAGS_LOCKING_STATE)
+    {
+        //
+        // State locking does portMemCopy unlocked, so only the position has
+        // to be claimed atomically. Do it without the main lock, which is
+        // shared by all buffers.
+        //
+        do
+        {
+            oldPos = pBuffer->pos;
+            newPos = (oldPos + dataSize) % pBuffer->size;
+        } while (!portAtomicCompareAndSwapU32((volatile NvU32 *)&pBuffer->pos, newPos, oldPos));
 
-    oldPos = pBuffer->pos;
-    pBuffer->extra.ring.overflow += (pBuffer->pos + dataSize) / pBuffer->size;
-    pBuffer->pos                  = (pBuffer->pos + dataSize) % pBuffer->size;
+        overflow = (oldPos + dataSize) / pBuffer->size;
+        if (overflow != 0)
+            portAtomicAddU32((volatile NvU32 *)&pBuffer->extra.ring.overflow, overflow);
+    }
+    else
+    {
+        if (lock == NVLOG_BUFFER_FLAGS_LOCKING_FULL)
+            portSyncSpinlockAcquire(NvLogLogger.mainLock);
 
-    // State locking does portMemCopy unlocked.
-    if (lock == NVLOG_BUFFER_FLAGS_LOCKING_STATE)
-        portSyncSpinlockRelease(NvLogLogger.mainLock);
+        oldPos = pBuffer->pos;
+        pBuffer->extra.ring.overflow += (pBuffer->pos + dataSize) / pBuffer->size;
+        pBuffer->pos                  = (pBuffer->pos + dataSize) % pBuffer->size;
+    }
 
     while (dataSize > 0)
     {
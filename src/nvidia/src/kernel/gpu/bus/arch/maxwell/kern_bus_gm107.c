@@ -2922,6 +2922,7 @@ _kbusMapAperture_GM107
     NV_STATUS           rmStatus = NV_ERR_GENERIC;
     VirtMemAllocator   *pDma;
     NvU32               flags = DRF_DEF(OS46, _FLAGS, _DMA_UNICAST_REUSE_ALLOC, _FALSE);
+    MEMORY_DESCRIPTOR   tempMemDesc;
     MEMORY_DESCRIPTOR  *pTempMemDesc;
     NvU32               swizzId = KMIGMGR_SWIZZID_INVALID;
     NvU32               gfid;
@@ -3012,7 +3013,21 @@ _kbusMapAperture_GM107
         flags = FLD_SET_DRF(OS46, _FLAGS, _ACCESS, _WRITE_ONLY, flags);
     }
 
-    rmStatus = memdescCreateSubMem(&pTempMemDesc, pMemDesc, pGpu, offset, *pLength);
+    //
+    // The sub-memdesc only lives for the duration of the mapping call, so
+    // build it on the stack when the parent allows it, to save a heap
+    // allocation on every BAR1 map.
+    //
+    rmStatus = memdescCreateSubMemExisting(&tempMemDesc, pMemDesc, pGpu, offset, *pLength);
+    if (rmStatus == NV_OK)
+    {
+        pTempMemDesc = &tempMemDesc;
+    }
+    else if (rmStatus == NV_ERR_NOT_SUPPORTED)
+    {
+        rmStatus = memdescCreateSubMem(&pTempMemDesc, pMemDesc, pGpu, offset, *pLength);
+    }
+
     if (NV_OK == rmStatus)
     {
         rmStatus = dmaAllocMapping_HAL(pGpu, pDma, pVAS, pTempMemDesc, pAperOffset, flags, NULL, swizzId);
@@ -1465,8 +1465,26 @@ kbusUpdateRusdStatistics_IMPL
         if (pVASHeap != NULL)
         {
             NvU64 freeSize = 0;
-
-            pVASHeap->eheapInfoForRange(pVASHeap, bar1VARange, NULL, NULL, NULL, &freeSize);
+            NvU64 heapBase = 0;
+            NvU64 heapSize = 0;
+
+            //
+            // This runs on every BAR1 map and unmap. When the range covers the
+            // whole heap, which is the usual case, use the heap's running free
+            // count rather than walking its free list.
+            //
+            pVASHeap->eheapGetBase(pVASHeap, &heapBase);
+            pVASHeap->eheapGetSize(pVASHeap, &heapSize);
+
+            if ((heapSize != 0) &&
+                rangeContains(bar1VARange, rangeMake(heapBase, heapBase + heapSize - 1)))
+            {
+                pVASHeap->eheapGetFree(pVASHeap, &freeSize);
+            }
+            else
+            {
+                pVASHeap->eheapInfoForRange(pVASHeap, bar1VARange, NULL, NULL, NULL, &freeSize);
+            }
             bar1AvailSize = (NvU32)(freeSize / 1024);
         }
     }
@@ -1201,6 +1201,41 @@ kchangrpapiCtrlCmdGpFifoSchedule_IMPL
     return status;
 }
 
+//
+// Kernel side of kchannelBindToRunlist, for channels whose bind was already
+// done on GSP as part of binding their TSG.
+//
+static NV_STATUS
+_kchangrpapiSetChannelRunlist
+(
+    OBJGPU        *pGpu,
+    KernelChannel *pKernelChannel,
+    ENGDESCRIPTOR  engineDesc
+)
+{
+    KernelFifo *pKernelFifo = GPU_GET_KERNEL_FIFO(pGpu);
+    NV_STATUS   status      = NV_OK;
+
+    NV_ASSERT_OR_RETURN(pKernelChannel != NULL, NV_ERR_INVALID_ARGUMENT);
+
+    SLI_LOOP_START(SLI_LOOP_FLAGS_BC_ONLY)
+
+    pKernelFifo = GPU_GET_KERNEL_FIFO(pGpu);
+    status = kfifoRunlistSetIdByEngine_HAL(pGpu, pKernelFifo, pKernelChannel, engineDesc);
+
+    if (status != NV_OK)
+    {
+        NV_PRINTF(LEVEL_ERROR,
+                  "Failed to set RunlistID 0x%08x for channel 0x%08x\n",
+                  engineDesc, kchannelGetDebugTag(pKernelChannel));
+        SLI_LOOP_BREAK;
+    }
+
+    SLI_LOOP_END;
+
+    return status;
+}
+
 NV_STATUS
 kchangrpapiCtrlCmdBind_IMPL
 (
@@ -1216,6 +1251,7 @@ kchangrpapiCtrlCmdBind_IMPL
     RM_ENGINE_TYPE globalEngineType;
     ENGDESCRIPTOR engineDesc;
     NvBool        bMIGInUse = IS_MIG_IN_USE(pGpu);
+    NvBool        bBindTsgOnGsp;
 
     NV_ASSERT_OR_RETURN(pParams != NULL, NV_ERR_INVALID_ARGUMENT);
 
@@ -1252,15 +1288,42 @@ kchangrpapiCtrlCmdBind_IMPL
             ENGINE_INFO_TYPE_RUNLIST,
             &pKernelChannelGroupApi->pKernelChannelGroup->runlistId));
 
+    //
+    // On GSP clients, binding each channel on its own costs one RPC per
+    // channel. Bind the whole TSG with a single RPC instead, GSP binds all of
+    // its channels, and only update the channels' runlist here.
+    //
+    bBindTsgOnGsp = IS_GSP_CLIENT(pGpu) && (rmStatus == NV_OK) &&
+                    (engineDesc != ENG_SW) && (engineDesc != ENG_BUS);
+    if (bBindTsgOnGsp)
+    {
+        NV_RM_RPC_CONTROL(pGpu,
+                          RES_GET_CLIENT_HANDLE(pKernelChannelGroupApi),
+                          RES_GET_HANDLE(pKernelChannelGroupApi),
+                          NVA06C_CTRL_CMD_BIND,
+                          pParams,
+                          sizeof(*pParams),
+                          rmStatus);
+        NV_ASSERT_OK_OR_RETURN(rmStatus);
+    }
+
     for (pChanNode =
              pKernelChannelGroupApi->pKernelChannelGroup->pChanList->pHead;
          pChanNode != NULL;
          pChanNode = pChanNode->pNext)
     {
-        NV_ASSERT_OK_OR_CAPTURE_FIRST_ERROR(rmStatus,
-            kchannelBindToRunlist(pChanNode->pKernelChannel,
-                                  localEngineType,
-                                  engineDesc));
+        if (bBindTsgOnGsp)
+        {
+            NV_ASSERT_OK_OR_CAPTURE_FIRST_ERROR(rmStatus,
+                _kchangrpapiSetChannelRunlist(pGpu, pChanNode->pKernelChannel, engineDesc));
+        }
+        else
+        {
+            NV_ASSERT_OK_OR_CAPTURE_FIRST_ERROR(rmStatus,
+                kchannelBindToRunlist(pChanNode->pKernelChannel,
+                                      localEngineType,
+                                      engineDesc));
+        }
         if (rmStatus != NV_OK)
         {
             break;
@@ -503,6 +503,8 @@ gpuFabricProbeReceiveKernelCallback
     nvlink_inband_gpu_probe_rsp_msg_t *pProbeRespMsg;
     GPU_FABRIC_PROBE_INFO_KERNEL *pGpuFabricProbeInfoKernel;
     NV_STATUS status;
+    NvBool bCliqueIdKnown;
+    NvU32 prevCliqueId;
 
     if ((pGpu = gpumgrGetGpu(gpuInstance)) == NULL)
     {
@@ -531,6 +533,9 @@ gpuFabricProbeReceiveKernelCallback
     pProbeRespMsg = \
         (nvlink_inband_gpu_probe_rsp_msg_t *)&pInbandRcvParams->data[0];
 
+    bCliqueIdKnown = gpuFabricProbeIsReceived(pGpuFabricProbeInfoKernel);
+    prevCliqueId = pGpuFabricProbeInfoKernel->probeResponseMsg.probeRsp.cliqueId;
+
     portMemCopy(&pGpuFabricProbeInfoKernel->probeResponseMsg,
                 sizeof(pGpuFabricProbeInfoKernel->probeResponseMsg),
                 pProbeRespMsg,
@@ -549,6 +554,19 @@ gpuFabricProbeReceiveKernelCallback
     _gpuFabricProbeSetupGpaRange(pGpu, pGpuFabricProbeInfoKernel);
     _gpuFabricProbeSetupFlaRange(pGpu, pGpuFabricProbeInfoKernel);
 
+    //
+    // The probe is asynchronous and nothing else waits for it, so let fabric
+    // event listeners know the GPU's clique ID is now valid instead of having
+    // them poll the probe state. A repeated response with the same clique ID
+    // is not a change.
+    //
+    if (!bCliqueIdKnown ||
+        (prevCliqueId != pGpuFabricProbeInfoKernel->probeResponseMsg.probeRsp.cliqueId))
+    {
+        _gpuFabricProbeSendCliqueIdChangeEvent(pGpu,
+            pGpuFabricProbeInfoKernel->probeResponseMsg.probeRsp.cliqueId);
+    }
+
     return NV_OK;
 }
 
@@ -49,6 +49,21 @@
 static NV_STATUS gpuPowerManagementEnter(OBJGPU *, NvU32 newLevel, NvU32 flags);
 static NV_STATUS gpuPowerManagementResume(OBJGPU *, NvU32 oldLevel, NvU32 flags);
 
+//
+// Returns the time elapsed since the given osGetTimestamp() value in
+// microseconds, to report how long each phase of a PM transition took.
+//
+static NvU64
+_gpuPowerManagementElapsedUs(NvU64 startTs)
+{
+    const NvU64 tsFreqUs = osGetTimestampFreq() / 1000000;
+
+    if (tsFreqUs == 0)
+        return 0;
+
+    return (osGetTimestamp() - startTs) / tsFreqUs;
+}
+
 // XXX Needs to be further cleaned up. No new code should be placed in this
 // routine. Please use the per-engine StateLoad() and StateUnload() routines
 // instead
@@ -57,6 +72,8 @@ gpuPowerManagementEnter(OBJGPU *pGpu, NvU32 newLevel, NvU32 flags)
 {
     NV_STATUS  status = NV_OK;
     MemoryManager *pMemoryManager = GPU_GET_MEMORY_MANAGER(pGpu);
+    NvU64 startTs = osGetTimestamp();
+    NvU64 unloadUs;
 
     // This is a no-op in CPU-RM
     NV_ASSERT_OK_OR_GOTO(status, gpuPowerManagementEnterPreUnloadPhysical(pGpu), done);
@@ -66,6 +83,9 @@ gpuPowerManagementEnter(OBJGPU *pGpu, NvU32 newLevel, NvU32 flags)
         GPU_STATE_FLAGS_PRESERVING | GPU_STATE_FLAGS_PM_TRANSITION | GPU_STATE_FLAGS_GC6_TRANSITION :
         GPU_STATE_FLAGS_PRESERVING | GPU_STATE_FLAGS_PM_TRANSITION), done);
 
+    unloadUs = _gpuPowerManagementElapsedUs(startTs);
+    startTs = osGetTimestamp();
+
     pGpu->setProperty(pGpu, PDB_PROP_GPU_VGA_ENABLED, NV_TRUE);
 
     // This is a no-op in CPU-RM
@@ -121,6 +141,9 @@ gpuPowerManagementEnter(OBJGPU *pGpu, NvU32 newLevel, NvU32 flags)
         }
     }
 
+    NV_PRINTF(LEVEL_NOTICE, "State unload took %llu us, GSP suspend took %llu us\n",
+              unloadUs, _gpuPowerManagementElapsedUs(startTs));
+
 done:
     if ((status != NV_OK) && !IS_GPU_GC6_STATE_ENTERING(pGpu))
     {
@@ -144,6 +167,8 @@ gpuPowerManagementResume(OBJGPU *pGpu, NvU32 oldLevel, NvU32 flags)
     OBJSYS         *pSys   = SYS_GET_INSTANCE();
     OBJCL          *pCl    = SYS_GET_CL(pSys);
     MemoryManager *pMemoryManager = GPU_GET_MEMORY_MANAGER(pGpu);
+    NvU64 startTs = osGetTimestamp();
+    NvU64 bootUs;
 
 #ifdef DEBUG
     //
@@ -237,6 +262,9 @@ gpuPowerManagementResume(OBJGPU *pGpu, NvU32 oldLevel, NvU32 flags)
 
     }
 
+    bootUs = _gpuPowerManagementElapsedUs(startTs);
+    startTs = osGetTimestamp();
+
     // This is a no-op in CPU-RM
     NV_ASSERT_OK_OR_GOTO(status, gpuPowerManagementResumePreLoadPhysical(pGpu, oldLevel, flags), done);
 
@@ -250,7 +278,8 @@ gpuPowerManagementResume(OBJGPU *pGpu, NvU32 oldLevel, NvU32 flags)
     // This is a no-op in CPU-RM
     NV_ASSERT_OK_OR_GOTO(status, gpuPowerManagementResumePostLoadPhysical(pGpu), done);
 
-    NV_PRINTF(LEVEL_NOTICE, "Adapter now in D0 state\n");
+    NV_PRINTF(LEVEL_NOTICE, "Adapter now in D0 state (boot took %llu us, state load took %llu us)\n",
+              bootUs, _gpuPowerManagementElapsedUs(startTs));
 
 done:
     if (!IS_GPU_GC6_STATE_EXITING(pGpu))
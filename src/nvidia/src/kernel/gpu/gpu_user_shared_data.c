@@ -274,11 +274,22 @@ _gpushareddataRequestDataPoll
     NvU64 polledDataUnion = 0U;
     RmClient **ppClient;
 
+    NvU64 removedDataMask = pData->polledDataMask & ~polledDataMask;
+
     if (polledDataMask == pData->polledDataMask)
         return NV_OK; // Nothing to do
 
     pData->polledDataMask = polledDataMask;
 
+    //
+    // If this object only requests data that is already being polled for
+    // some RUSD object on this GPU, the union can't change. Skip walking
+    // every client, which is the common case with several monitoring clients.
+    //
+    if ((removedDataMask == 0U) &&
+        ((polledDataMask & ~pGpu->userSharedData.lastPolledDataMask) == 0U))
+        return NV_OK;
+
     // Iterate over all clients to get all RUSD objects
     for (ppClient = serverutilGetFirstClientUnderLock();
          ppClient != NULL;
@@ -118,6 +118,14 @@ typedef struct
 //
 #define RPC_PARAMS(r, v) rpc_##r##v *rpc_params = &RPC_HDR->rpc_message_data->r##_v
 
+//
+// _kgspRpcRecvPoll() spins for GSP_RPC_POLL_SPIN_US waiting for a response,
+// which covers most RPCs, and then sleeps GSP_RPC_POLL_SLEEP_US between polls
+// when the caller may sleep, so that long RPCs do not hold a CPU.
+//
+#define GSP_RPC_POLL_SPIN_US    100
+#define GSP_RPC_POLL_SLEEP_US   20
+
 static NV_STATUS _kgspInitRpcInfrastructure(OBJGPU *, KernelGsp *);
 static void _kgspFreeRpcInfrastructure(OBJGPU *, KernelGsp *);
 
@@ -1702,6 +1710,9 @@ _kgspRpcDrainEvents
         kgspDumpGspLogs(pKernelGsp, NV_FALSE);
     }
 
+    // The logs are current, let the next poll skip its pass.
+    pKernelGsp->bLogsDrainedSincePoll = NV_TRUE;
+
     // If GSP-RM has died, the GPU will need to be reset
     if (!kgspHealthCheck_HAL(pGpu, pKernelGsp))
         return NV_ERR_RESET_REQUIRED;
@@ -1845,6 +1856,10 @@ kgspLogRpcDebugInfo
                       pMsgHdr->function, _getRpcName(pMsgHdr->function),
                       activeData[0], activeData[1]);
 
+    NV_ERROR_LOG_DATA(pGpu, errorNum,
+                      "GPU%d RPC responses: %llu while spinning, %llu after sleeping\n",
+                      gpuGetInstance(pGpu), pRpc->pollSpinCount, pRpc->pollSleepCount);
+
     NV_ERROR_LOG_DATA(pGpu, errorNum,
                       "GPU%d RPC history (CPU -> GSP):\n",
                       gpuGetInstance(pGpu));
@@ -1979,6 +1994,15 @@ _kgspRpcIncrementTimeoutCountAndRateLimitPrints
 
 /*!
  * GSP client RM RPC poll routine
+ *
+ * There is at most one RPC waiting for a response per GPU: the request and the
+ * response share the single message buffer of pRpc, GSP-RM services the
+ * command queue one RPC at a time and returns responses in order, and the
+ * response is matched by function only. The seqNum of the queue elements is a
+ * transport sequence number, also used as the AAD when Confidential Computing
+ * is enabled, and not an RPC tag GSP-RM echoes back. Keeping several RPCs in
+ * flight would therefore need per-RPC buffers and GSP-RM support for tagged
+ * responses, in addition to dropping the GPU lock while waiting.
  */
 static NV_STATUS
 _kgspRpcRecvPoll
@@ -1996,6 +2020,9 @@ _kgspRpcRecvPoll
     NvU32      timeoutFlags;
     NvBool     bSlowGspRpc = IS_EMULATION(pGpu) || IS_SIMULATION(pGpu);
     NvU32      gpuMaskUnused;
+    NvBool     bCanSleep = portSyncExSafeToSleep();
+    NvBool     bSlept = NV_FALSE;
+    NvU64      spinStartUs;
 
     KernelGspRpcEventHandlerContext rpcHandlerContext = KGSP_RPC_EVENT_HANDLER_CONTEXT_POLL;
     if (expectedFunc == NV_VGPU_MSG_EVENT_GSP_INIT_DONE)
@@ -2059,6 +2086,7 @@ _kgspRpcRecvPoll
         timeoutFlags |= GPU_TIMEOUT_FLAGS_BYPASS_JOURNAL_LOG;
 
     gpuSetTimeout(pGpu, timeoutUs, &timeout, timeoutFlags);
+    spinStartUs = osGetTimestamp();
 
     for (;;)
     {
@@ -2074,6 +2102,10 @@ _kgspRpcRecvPoll
             case NV_WARN_MORE_PROCESSING_REQUIRED:
                 // The synchronous RPC response we were waiting for is here
                 _kgspCompleteRpcHistoryEntry(pRpc->rpcHistory, pRpc->rpcHistoryCurrent);
+                if (bSlept)
+                    pRpc->pollSleepCount++;
+                else
+                    pRpc->pollSpinCount++;
                 rpcStatus = NV_OK;
                 goto done;
             case NV_OK:
@@ -2115,7 +2147,22 @@ _kgspRpcRecvPoll
             goto done;
         }
 
-        osSpinLoop();
+        //
+        // The GSP message queue interrupt is serviced by the bottom half under
+        // the GPU lock held here, so it cannot wake this thread: once the spin
+        // budget is spent, sleep for short intervals instead. Keep spinning
+        // when sleeping is not allowed, e.g. at raised IRQL.
+        //
+        if (bCanSleep &&
+            ((osGetTimestamp() - spinStartUs) >= GSP_RPC_POLL_SPIN_US) &&
+            (osSleepUs(GSP_RPC_POLL_SLEEP_US) == NV_OK))
+        {
+            bSlept = NV_TRUE;
+        }
+        else
+        {
+            osSpinLoop();
+        }
     }
 
     pRpc->timeoutCount = 0;
@@ -2224,6 +2271,9 @@ _kgspFreeRpcInfrastructure
 {
     if (pKernelGsp->pRpc != NULL)
     {
+        NV_PRINTF(LEVEL_INFO, "GSP RPC responses: %llu while spinning, %llu after sleeping\n",
+                  pKernelGsp->pRpc->pollSpinCount, pKernelGsp->pRpc->pollSleepCount);
+
         rpcDestroy(pGpu, pKernelGsp->pRpc);
         portMemFree(pKernelGsp->pRpc);
         pKernelGsp->pRpc = NULL;
@@ -4623,6 +4673,17 @@ _kgspLogPollingCallback
     // is not registered, there is no possibility of data race.
     //
     KernelGsp *pKernelGsp = GPU_GET_KERNEL_GSP(pGpu);
+
+    //
+    // GSP logs are dumped whenever RPC events are drained, so the poll only
+    // needs to catch logs written while no RPC traffic was going on.
+    //
+    if (pKernelGsp->bLogsDrainedSincePoll)
+    {
+        pKernelGsp->bLogsDrainedSincePoll = NV_FALSE;
+        return;
+    }
+
     kgspDumpGspLogsUnlocked(pKernelGsp, NV_FALSE);
 }
 
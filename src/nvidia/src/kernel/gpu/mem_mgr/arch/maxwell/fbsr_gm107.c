@@ -259,6 +259,9 @@ fbsrInit_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr)
 void
 fbsrDestroy_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr)
 {
+    // Free the system memory retained across suspends, if any
+    fbsrFreeReservedSysMemoryForPowerMgmt(pFbsr);
+
     if (pFbsr->type == FBSR_TYPE_CPU ||
         pFbsr->type == FBSR_TYPE_WDDM_SLOW_CPU_PAGED ||
         pFbsr->type == FBSR_TYPE_FILE)
@@ -327,8 +330,10 @@ fbsrBegin_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr, FBSR_OP_TYPE op)
                 {
                     //
                     // Validate if reserved system memory size is sufficient,
-                    // Otherwise generate the assert and free the
-                    // pre-allocated reserved system memory
+                    // Otherwise free the pre-allocated reserved system memory
+                    // and allocate memory of the needed size below. A buffer
+                    // retained from an earlier suspend becomes too small when
+                    // more vidmem is in use now.
                     //
                     if (pFbsr->pSysReservedMemDesc->Size >= pFbsr->length)
                     {
@@ -343,12 +348,12 @@ fbsrBegin_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr, FBSR_OP_TYPE op)
                         break;
                     }
 
-                    NV_ASSERT(pFbsr->pSysReservedMemDesc->Size >= pFbsr->length);
+                    NV_PRINTF(LEVEL_INFO,
+                              "reserved sysmem too small (0x%llx < 0x%llx), reallocating\n",
+                              pFbsr->pSysReservedMemDesc->Size, pFbsr->length);
                     memdescFree(pFbsr->pSysReservedMemDesc);
                     memdescDestroy(pFbsr->pSysReservedMemDesc);
                     pFbsr->pSysReservedMemDesc = NULL;
-                    status = NV_ERR_GENERIC;
-                    break;
                 }
 
                 if (pFbsr->length)
@@ -638,6 +643,23 @@ fbsrEnd_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr)
                     {
                         memdescUnlock(pFbsr->pSysMemDesc);
                     }
+
+                    //
+                    // Keep the memory of a successful restore as the reservation
+                    // for the next suspend, see fbsrReserveSysMemoryForPowerMgmt.
+                    //
+                    if ((pFbsr->type == FBSR_TYPE_DMA) &&
+                        (pFbsr->op == FBSR_OP_RESTORE) &&
+                        !pFbsr->bOperationFailed &&
+                        pMemoryManager->bRetainFbsrSysMem &&
+                        (pFbsr->pSysMemDesc != NULL) &&
+                        (pFbsr->pSysReservedMemDesc == NULL))
+                    {
+                        pFbsr->pSysReservedMemDesc = pFbsr->pSysMemDesc;
+                        pFbsr->pSysMemDesc = NULL;
+                        break;
+                    }
+
                     memdescFree(pFbsr->pSysMemDesc);
                     memdescDestroy(pFbsr->pSysMemDesc);
                     pFbsr->pSysMemDesc = NULL;
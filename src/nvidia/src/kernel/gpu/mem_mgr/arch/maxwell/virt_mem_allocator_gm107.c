@@ -1663,8 +1663,22 @@ _gmmuWalkCBMapNextEntries_RmAperture
     MEMORY_DESCRIPTOR   *pMemDesc       = (MEMORY_DESCRIPTOR*)pLevelMem;
     const MMU_FMT_LEVEL *pLevelFmt      = pTarget->pLevelFmt;
     TRANSFER_SURFACE     surf           = {0};
+    NvU32                transferFlags  = TRANSFER_FLAGS_SHADOW_ALLOC | TRANSFER_FLAGS_DEFER_FLUSH;
     NvU32                sizeOfEntries;
 
+    //
+    // All the entries of the batch are written, so the current ones only
+    // need to be read back when they are read-modify-written. This saves a
+    // copy per page table when mapping through CE.
+    //
+    // The flush is left to the caller, which issues a single one once the
+    // whole range is mapped rather than one per page table.
+    //
+    if (pIter->bReadPtes)
+    {
+        transferFlags |= TRANSFER_FLAGS_SHADOW_INIT_MEM;
+    }
+
     NV_PRINTF(LEVEL_INFO, "[GPU%u]: PA 0x%llX, Entries 0x%X-0x%X\n",
               pUserCtx->pGpu->gpuInstance,
               memdescGetPhysAddr(pMemDesc, AT_GPU, 0), entryIndexLo,
@@ -1676,16 +1690,13 @@ _gmmuWalkCBMapNextEntries_RmAperture
     sizeOfEntries = (entryIndexHi - entryIndexLo + 1 ) * pLevelFmt->entrySize;
 
     pIter->pMap = memmgrMemBeginTransfer(pMemoryManager, &surf, sizeOfEntries,
-                                         TRANSFER_FLAGS_SHADOW_ALLOC |
-                                         TRANSFER_FLAGS_SHADOW_INIT_MEM);
+                                         transferFlags);
     NV_ASSERT_OR_RETURN_VOID(NULL != pIter->pMap);
 
     _gmmuWalkCBMapNextEntries_Direct(pUserCtx, pTarget, pLevelMem,
                                      entryIndexLo, entryIndexHi, pProgress);
 
-    memmgrMemEndTransfer(pMemoryManager, &surf, sizeOfEntries,
-                         TRANSFER_FLAGS_SHADOW_ALLOC |
-                         TRANSFER_FLAGS_SHADOW_INIT_MEM);
+    memmgrMemEndTransfer(pMemoryManager, &surf, sizeOfEntries, transferFlags);
 }
 
 static NV_STATUS _dmaGetFabricAddress
@@ -2226,6 +2237,12 @@ done:
                                         BUS_FLUSH_SYSTEM_MEMORY);
         gvaspaceInvalidateTlb(pGVAS, pGpu, update_type);
     }
+    else if ((NULL == pTgtPteMem) && !bUnmap)
+    {
+        // The PTE writes left the flush to us, see _gmmuWalkCBMapNextEntries_RmAperture.
+        kbusFlush_HAL(pGpu, pKernelBus, BUS_FLUSH_VIDEO_MEMORY |
+                                        BUS_FLUSH_SYSTEM_MEMORY);
+    }
 
 #if NV_PRINTF_LEVEL_ENABLED(LEVEL_INFO)
     if (DBG_RMMSG_CHECK(LEVEL_INFO))
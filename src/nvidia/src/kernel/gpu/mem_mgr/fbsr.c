@@ -67,6 +67,15 @@ fbsrReserveSysMemoryForPowerMgmt_IMPL
     if (pFbsr->type != FBSR_TYPE_DMA)
         return NV_ERR_GENERIC;
 
+    // Reuse the memory retained from an earlier suspend if it is large enough
+    if (pFbsr->pSysReservedMemDesc != NULL)
+    {
+        if (pFbsr->pSysReservedMemDesc->Size >= Size)
+            return NV_OK;
+
+        fbsrFreeReservedSysMemoryForPowerMgmt(pFbsr);
+    }
+
     status = memdescCreate(&pFbsr->pSysReservedMemDesc, pGpu,
                            Size, 0, NV_FALSE,
                            ADDR_SYSMEM, NV_MEMORY_UNCACHED,
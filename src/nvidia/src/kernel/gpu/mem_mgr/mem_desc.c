@@ -73,6 +73,9 @@ typedef struct
     NvP64 pPriv;
 } FB_MAPPING_INFO;
 
+static NV_STATUS _memdescCreateSubMem(MEMORY_DESCRIPTOR **ppMemDescNew, MEMORY_DESCRIPTOR *pMemDesc,
+                                      OBJGPU *pGpu, NvU64 Offset, NvU64 Size, NvU64 Flags);
+
 //
 // Common address space lists
 //
@@ -2568,9 +2571,67 @@ memdescCreateSubMem
     NvU64 Offset,
     NvU64 Size
 )
+{
+    return _memdescCreateSubMem(ppMemDescNew, pMemDesc, pGpu, Offset, Size, MEMDESC_FLAGS_NONE);
+}
+
+/*!
+ *  @brief Initialize a caller supplied memory descriptor as a subset of a
+ *  physically contiguous pMemDesc.
+ *
+ *  Unlike memdescCreateSubMem this does not allocate the new memory
+ *  descriptor, which makes it suitable for short lived sub-allocations
+ *  described on the stack, e.g. per block of a transfer. A contiguous
+ *  sub-memory descriptor only ever needs the single embedded PTE.
+ *
+ *  memdescDestroy should still be called when done with it.
+ *
+ *  @param[out]  pMemDescNew    Caller supplied memory descriptor
+ *  @param[in]   pMemDesc       Original memory descriptor
+ *  @param[in]   pGpu           The GPU that this memory will be mapped to
+ *  @param[in]   Offset         Sub memory descriptor starts at pMemdesc+Offset
+ *  @param[in]   Size           For Size bytes
+ *
+ *  @returns NV_ERR_NOT_SUPPORTED, without touching pMemDescNew, if pMemDesc is
+ *           not physically contiguous or has subdevice memory descriptors.
+ *           memdescCreateSubMem must be used for those.
+ */
+NV_STATUS
+memdescCreateSubMemExisting
+(
+    MEMORY_DESCRIPTOR *pMemDescNew,
+    MEMORY_DESCRIPTOR *pMemDesc,
+    OBJGPU *pGpu,
+    NvU64 Offset,
+    NvU64 Size
+)
+{
+    NV_CHECK_OR_RETURN(LEVEL_SILENT,
+                       (pMemDesc->_flags & MEMDESC_FLAGS_PHYSICALLY_CONTIGUOUS) &&
+                       !memdescHasSubDeviceMemDescs(pMemDesc),
+                       NV_ERR_NOT_SUPPORTED);
+
+    return _memdescCreateSubMem(&pMemDescNew, pMemDesc, pGpu, Offset, Size, MEMDESC_FLAGS_PRE_ALLOCATED);
+}
+
+//
+// Common code of memdescCreateSubMem and memdescCreateSubMemExisting.
+// With MEMDESC_FLAGS_PRE_ALLOCATED in Flags, *ppMemDescNew is the caller
+// supplied memory descriptor to initialize.
+//
+static NV_STATUS
+_memdescCreateSubMem
+(
+    MEMORY_DESCRIPTOR **ppMemDescNew,
+    MEMORY_DESCRIPTOR *pMemDesc,
+    OBJGPU *pGpu,
+    NvU64 Offset,
+    NvU64 Size,
+    NvU64 Flags
+)
 {
     NV_STATUS status;
-    MEMORY_DESCRIPTOR *pMemDescNew;
+    MEMORY_DESCRIPTOR *pMemDescNew = (Flags & MEMDESC_FLAGS_PRE_ALLOCATED) ? *ppMemDescNew : NULL;
     NvU32 subDevInst;
     NvU64 tmpSize = Size;
     MEMORY_DESCRIPTOR *pLast;
@@ -2626,7 +2687,8 @@ memdescCreateSubMem
                            !!(pMemDesc->_flags & MEMDESC_FLAGS_PHYSICALLY_CONTIGUOUS),
                            pMemDesc->_addressSpace,
                            pMemDesc->_cpuCacheAttrib,
-                           ((pMemDesc->_flags & ~MEMDESC_FLAGS_PRE_ALLOCATED) | MEMDESC_FLAGS_SKIP_RESOURCE_COMPUTE));
+                           ((pMemDesc->_flags & ~MEMDESC_FLAGS_PRE_ALLOCATED) |
+                            MEMDESC_FLAGS_SKIP_RESOURCE_COMPUTE | Flags));
 
     if (status != NV_OK)
     {
@@ -2661,7 +2723,8 @@ memdescCreateSubMem
     pMemDescNew->gfid                = pMemDesc->gfid;
     pMemDescNew->bUsingSuballocator  = pMemDesc->bUsingSuballocator;
     pMemDescNew->_pParentDescriptor  = pMemDesc;
-    pMemDesc->childDescriptorCnt++;
+    if ((Flags & MEMDESC_FLAGS_PRE_ALLOCATED) == 0)
+        pMemDesc->childDescriptorCnt++;
     pMemDescNew->bRmExclusiveUse = pMemDesc->bRmExclusiveUse;
     pMemDescNew->numaNode        = pMemDesc->numaNode;
 
@@ -241,6 +241,11 @@ _memmgrInitRegistryOverrides(OBJGPU *pGpu, MemoryManager *pMemoryManager)
         }
     }
 
+    if (osReadRegistryDword(pGpu, NV_REG_STR_RM_FBSR_RETAIN_SYSMEM, &data32) == NV_OK)
+    {
+        pMemoryManager->bRetainFbsrSysMem = !!data32;
+    }
+
     //
     // Override PMA enable.  PDB_PROP_FB_PMA_ENABLED is reconciled with
     // PDB_PROP_FB_PLATFORM_PMA_SUPPORT to decide whether to enable PMA.
@@ -45,6 +45,7 @@
 #include "nvstatus.h"
 #include "rmapi/rs_utils.h"
 #include "core/locks.h"
+#include "nvrm_registry.h"
 
 #include "gpu/conf_compute/conf_compute.h"
 
@@ -66,18 +67,125 @@
 static NvU64  _scrubCheckProgress(OBJMEMSCRUB *pScrubber);
 static NvU64  _searchScrubList(OBJMEMSCRUB *pScrubber, RmPhysAddr base, NvU64 size);
 static void   _waitForPayload(OBJMEMSCRUB  *pScrubber, RmPhysAddr  base, RmPhysAddr end);
-static void   _scrubAddWorkToList(OBJMEMSCRUB  *pScrubber, RmPhysAddr  base, NvU64  size, NvU64  newId);
-static NvU32  _scrubMemory(OBJMEMSCRUB  *pScrubber, RmPhysAddr base, NvU64 size,
-                           NvU32 dstCpuCacheAttrib, NvU32 freeToken);
+static void   _scrubAddWorkToList(OBJMEMSCRUB  *pScrubber, RmPhysAddr  base, NvU64  size, NvU64  newId,
+                                  NvU32 channel, NvU64 channelWorkId);
+static NvU32  _scrubMemory(OBJMEMSCRUB  *pScrubber, NvU32 channel, RmPhysAddr base, NvU64 size,
+                           NvU32 dstCpuCacheAttrib, NvU64 *pChannelWorkId);
 static void   _scrubWaitAndSave(OBJMEMSCRUB *pScrubber, PSCRUB_NODE pList, NvLength  itemsToSave);
 static NvU64  _scrubGetFreeEntries(OBJMEMSCRUB *pScrubber);
 static NvU64  _scrubCheckAndSubmit(OBJMEMSCRUB *pScrubber, NvU64 pageCount, PSCRUB_NODE  pList,
-                                   PSCRUB_NODE pScrubListCopy, NvLength  pagesToScrubCheck);
+                                   PSCRUB_NODE pScrubListCopy, NvLength  pagesToScrubCheck, NvU32 flags);
 static void   _scrubCopyListItems(OBJMEMSCRUB *pScrubber, PSCRUB_NODE pList, NvLength itemsToSave);
 
 static NV_STATUS _scrubCheckLocked(OBJMEMSCRUB  *pScrubber, PSCRUB_NODE *ppList, NvU64 *pSize);
-static NV_STATUS _scrubCombinePages(NvU64 *pPages, NvU64 pageSize, NvU64 pageCount,
+static NV_STATUS _scrubCombinePages(NvU64 *pPages, NvU64 pageSize, NvU64 pageCount, NvU64 maxBytesPerLine,
                                     PSCRUB_NODE *ppScrubList, NvU64 *pSize);
+static NvU64  _scrubChannelProgress(OBJMEMSCRUB *pScrubber, NvU32 channel);
+static void   _scrubServiceInterrupts(OBJMEMSCRUB *pScrubber);
+
+/**
+ * Find the async CEs the scrubber can use, the same way CeUtils picks its CE
+ * when none is forced.
+ *
+ * @param[in]   pGpu      OBJGPU pointer
+ * @param[out]  pCeIds    Array to store the CE instance of each usable CE
+ * @param[in]   maxCes    Size of pCeIds
+ *
+ * @returns the number of CEs found
+ */
+static NvU32
+_scrubGetCes
+(
+    OBJGPU *pGpu,
+    NvU32  *pCeIds,
+    NvU32   maxCes
+)
+{
+    KernelBus *pKernelBus = GPU_GET_KERNEL_BUS(pGpu);
+    KernelCE  *pKCe       = NULL;
+    NvU32      numCes     = 0;
+
+    NV_CHECK_OR_RETURN(LEVEL_ERROR, gpuUpdateEngineTable(pGpu) == NV_OK, 0);
+
+    KCE_ITER_ALL_BEGIN(pGpu, pKCe, 0)
+        if ((numCes < maxCes) &&
+            kbusCheckEngine_HAL(pGpu, pKernelBus, ENG_CE(pKCe->publicID)) &&
+            !ceIsCeGrce(pGpu, RM_ENGINE_TYPE_COPY(pKCe->publicID)) &&
+            gpuCheckEngineTable(pGpu, RM_ENGINE_TYPE_COPY(pKCe->publicID)))
+        {
+            pCeIds[numCes++] = pKCe->publicID;
+        }
+    KCE_ITER_END
+
+    return numCes;
+}
+
+/**
+ * Create the CeUtils channels of the scrubber. Without MIG, one channel is
+ * created on each usable async CE, up to SCRUBBER_MAX_CHANNELS or the
+ * RMScrubberChannels registry override. A single channel on the CE picked by
+ * CeUtils is used otherwise, or if only one CE is usable.
+ */
+static NV_STATUS
+_scrubCreateCeChannels
+(
+    OBJGPU                       *pGpu,
+    Heap                         *pHeap,
+    OBJMEMSCRUB                  *pScrubber,
+    KERNEL_MIG_GPU_INSTANCE      *pKernelMIGGPUInstance,
+    NV0050_ALLOCATION_PARAMETERS *pCeUtilsAllocParams
+)
+{
+    NvU32     ceIds[SCRUBBER_MAX_CHANNELS];
+    NvU32     maxChannels = SCRUBBER_MAX_CHANNELS;
+    NvU32     numCes      = 0;
+    NvU32     data32;
+    NvU32     i;
+    NV_STATUS status      = NV_OK;
+
+    if ((osReadRegistryDword(pGpu, NV_REG_STR_RM_SCRUBBER_CHANNELS, &data32) == NV_OK) &&
+        (data32 != 0))
+    {
+        maxChannels = NV_MIN(data32, SCRUBBER_MAX_CHANNELS);
+    }
+
+    if (!IS_MIG_IN_USE(pGpu) && (maxChannels > 1))
+        numCes = _scrubGetCes(pGpu, ceIds, maxChannels);
+
+    if (numCes <= 1)
+    {
+        NV_ASSERT_OK_OR_RETURN(objCreate(&pScrubber->pCeUtils[0], pHeap, CeUtils, pGpu,
+                                         pKernelMIGGPUInstance, pCeUtilsAllocParams));
+        pScrubber->numChannels = 1;
+        return NV_OK;
+    }
+
+    pCeUtilsAllocParams->flags |= DRF_DEF(0050, _CEUTILS_FLAGS, _FORCE_CE_ID, _TRUE);
+
+    for (i = 0; i < numCes; i++)
+    {
+        pCeUtilsAllocParams->forceCeId = ceIds[i];
+
+        status = objCreate(&pScrubber->pCeUtils[i], pHeap, CeUtils, pGpu,
+                           pKernelMIGGPUInstance, pCeUtilsAllocParams);
+        if (status != NV_OK)
+        {
+            NV_PRINTF(LEVEL_WARNING,
+                      "Failed to create scrubber channel on CE%u: 0x%x, using %u channel(s)\n",
+                      ceIds[i], status, i);
+            break;
+        }
+    }
+
+    // Scrubbing works with any number of channels
+    NV_CHECK_OR_RETURN(LEVEL_ERROR, i > 0, status);
+
+    pScrubber->numChannels = i;
+
+    NV_PRINTF(LEVEL_INFO, "Scrubber using %u CE channels\n", pScrubber->numChannels);
+
+    return NV_OK;
+}
 
 /**
  * Constructs the memory scrubber object and signals
@@ -175,16 +283,36 @@ scrubberConstruct
         }
         else
         {
-            NV_ASSERT_OK_OR_GOTO(status, objCreate(&pScrubber->pCeUtils, pHeap, CeUtils, pGpu, pKernelMIGGPUInstance, &ceUtilsAllocParams),
-               destroyscrublist);
+            NV_ASSERT_OK_OR_GOTO(status,
+                _scrubCreateCeChannels(pGpu, pHeap, pScrubber, pKernelMIGGPUInstance, &ceUtilsAllocParams),
+               destroychannels);
 
             pScrubber->engineType = gpuGetFirstAsyncLce_HAL(pGpu);
         }
-        NV_ASSERT_OK_OR_GOTO(status, pmaRegMemScrub(pPma, pScrubber), destroyscrublist);
+        if (pScrubber->engineType == NV2080_ENGINE_TYPE_SEC2)
+            pScrubber->numChannels = 1;
+
+        pScrubber->pPmaStats = &pPma->pmaStats;
+
+        NV_ASSERT_OK_OR_GOTO(status, pmaRegMemScrub(pPma, pScrubber), destroychannels);
     }
 
     return status;
 
+destroychannels:
+    {
+        NvU32 i;
+
+        for (i = 0; i < SCRUBBER_MAX_CHANNELS; i++)
+        {
+            if (pScrubber->pCeUtils[i] != NULL)
+                objDelete(pScrubber->pCeUtils[i]);
+        }
+
+        if (pScrubber->pSec2Utils != NULL)
+            objDelete(pScrubber->pSec2Utils);
+    }
+
 destroyscrublist:
     portMemFree(pScrubber->pScrubList);
 
@@ -214,17 +342,7 @@ _isScrubWorkPending(
     }
     else
     {
-        NvU64 lastCompleted;
-        if (pScrubber->engineType ==  NV2080_ENGINE_TYPE_SEC2)
-        {
-            lastCompleted = sec2utilsUpdateProgress(pScrubber->pSec2Utils);
-        }
-        else
-        {
-            lastCompleted = ceutilsUpdateProgress(pScrubber->pCeUtils);
-        }
-
-        if (pScrubber->lastSubmittedWorkId != lastCompleted)
+        if (pScrubber->lastSubmittedWorkId != _scrubCheckProgress(pScrubber))
             workPending = NV_TRUE;
     }
     return workPending;
@@ -304,7 +422,10 @@ scrubberDestruct
         }
         else
         {
-            objDelete(pScrubber->pCeUtils);
+            NvU32 i;
+
+            for (i = 0; i < pScrubber->numChannels; i++)
+                objDelete(pScrubber->pCeUtils[i]);
         }
     }
 
@@ -390,6 +511,7 @@ scrubCheck
  * @param[in]  chunkSize   NvU64 size of each page
  * @param[in]  pPages     NvU64 array of base address
  * @param[in]  pageCount  NvU64 number of pages
+ * @param[in]  flags      SCRUB_SUBMIT_FLAGS_*
  * @param[out] ppList     SCRUB_NODE double pointer to hand off the list
  * @param[out] pSize      NvU64 pointer to store the size
  *
@@ -402,6 +524,7 @@ scrubSubmitPages
     NvU64        chunkSize,
     NvU64       *pPages,
     NvU64        pageCount,
+    NvU32        flags,
     PSCRUB_NODE *ppList,
     NvU64       *pSize
 )
@@ -416,6 +539,7 @@ scrubSubmitPages
     NvU64       freeEntriesInList = 0;
     NvU64       scrubCount        = 0;
     NvU64       numPagesToScrub   = 0;
+    NvU64       maxBytesPerLine   = SCRUB_MAX_BYTES_PER_LINE;
     NV_STATUS   status            = NV_OK;
 
     portSyncMutexAcquire(pScrubber->pScrubberMutex);
@@ -428,10 +552,15 @@ scrubSubmitPages
 
     freeEntriesInList = _scrubGetFreeEntries(pScrubber);
 
+    // Split large ranges so that they can be spread over all the channels
+    if (pScrubber->numChannels > 1)
+        maxBytesPerLine = NV_MAX(SCRUBBER_STRIPE_SIZE, chunkSize);
+
     NV_ASSERT_OK_OR_GOTO(status,
                          _scrubCombinePages(pPages,
                                             chunkSize,
                                             pageCount,
+                                            maxBytesPerLine,
                                             &pScrubList,
                                             &scrubListSize),
                          cleanup);
@@ -465,7 +594,7 @@ scrubSubmitPages
             numFinished = _scrubCheckAndSubmit(pScrubber, scrubCount,
                                                &pScrubList[totalSubmitted],
                                                &pScrubListCopy[curPagesSaved],
-                                               pagesToScrubCheck);
+                                               pagesToScrubCheck, flags);
 
             scrubListSize     -= numFinished;
             curPagesSaved     += pagesToScrubCheck;
@@ -479,7 +608,7 @@ scrubSubmitPages
     else
     {
         totalSubmitted = _scrubCheckAndSubmit(pScrubber, scrubListSize,
-                                              pScrubList, NULL, 0);
+                                              pScrubList, NULL, 0, flags);
         *ppList = NULL;
         *pSize  = 0;
     }
@@ -541,6 +670,7 @@ scrubWaitPages
     NV_ASSERT_OK_OR_RETURN(_scrubCombinePages(pPages,
                                               chunkSize,
                                               pageCount,
+                                              SCRUB_MAX_BYTES_PER_LINE,
                                               &pScrubList,
                                               &scrubListSize));
 
@@ -693,6 +823,7 @@ _scrubCopyListItems
  *  @param[in]  pList               pointer will store the return check array
  *  @param[in]  pScrubListCopy      List where pages are saved
  *  @param[in]  pagesToScrubCheck   How many pages will need to be saved
+ *  @param[in]  flags               SCRUB_SUBMIT_FLAGS_*
  *  @returns the number of work successfully submitted, else 0
  */
 static NvU64
@@ -702,11 +833,14 @@ _scrubCheckAndSubmit
     NvU64        pageCount,
     PSCRUB_NODE  pList,
     PSCRUB_NODE  pScrubListCopy,
-    NvLength     pagesToScrubCheck
+    NvLength     pagesToScrubCheck,
+    NvU32        flags
 )
 {
     NvU64     iter = 0;
     NvU64     newId;
+    NvU64     channelWorkId = 0;
+    NvU32     channel;
     NV_STATUS status;
 
     if (pScrubListCopy == NULL && pagesToScrubCheck != 0)
@@ -722,13 +856,28 @@ _scrubCheckAndSubmit
     {
         newId    = pScrubber->lastSubmittedWorkId + 1;
 
+        //
+        // With more than one channel, the first one is kept for priority work
+        // so that it doesn't queue up behind the scrubbing of freed memory,
+        // which is striped across the others.
+        //
+        if ((pScrubber->numChannels == 1) || (flags & SCRUB_SUBMIT_FLAGS_PRIORITY))
+        {
+            channel = 0;
+        }
+        else
+        {
+            channel = 1 + (pScrubber->nextChannel % (pScrubber->numChannels - 1));
+            pScrubber->nextChannel++;
+        }
+
         NV_PRINTF(LEVEL_INFO,
-                  "Submitting work, Id: %llx, base: %llx, size: %llx\n",
-                  newId, pList[iter].base, pList[iter].size);
+                  "Submitting work, Id: %llx, base: %llx, size: %llx, channel: %u\n",
+                  newId, pList[iter].base, pList[iter].size, channel);
 
         {
-            status =_scrubMemory(pScrubber, pList[iter].base, pList[iter].size, NV_MEMORY_DEFAULT,
-                                 (NvU32)newId);
+            status =_scrubMemory(pScrubber, channel, pList[iter].base, pList[iter].size, NV_MEMORY_DEFAULT,
+                                 &channelWorkId);
         }
 
         if(status != NV_OK)
@@ -736,7 +885,7 @@ _scrubCheckAndSubmit
             NV_PRINTF(LEVEL_ERROR, "Failing because the work didn't submit.\n");
             goto exit;
         }
-        _scrubAddWorkToList(pScrubber, pList[iter].base, pList[iter].size, newId);
+        _scrubAddWorkToList(pScrubber, pList[iter].base, pList[iter].size, newId, channel, channelWorkId);
         _scrubCheckProgress(pScrubber);
     }
 
@@ -824,12 +973,7 @@ _scrubWaitAndSave
 
     while (currentCompletedId < (pScrubber->lastSeenIdByClient + itemsToSave))
     {
-        {
-            if (pScrubber->engineType == NV2080_ENGINE_TYPE_SEC2)
-                sec2utilsServiceInterrupts(pScrubber->pSec2Utils);
-            else
-                ceutilsServiceInterrupts(pScrubber->pCeUtils);
-        }
+        _scrubServiceInterrupts(pScrubber);
         currentCompletedId = _scrubCheckProgress(pScrubber);
     }
 
@@ -850,6 +994,32 @@ _waitForPayload
 {
     NvU64     idToWait;
 
+    //
+    // Only wait for the work overlapping the range, on the channel it was
+    // submitted to, so that priority work doesn't wait for the background
+    // work submitted before it on other channels.
+    //
+    if (!pScrubber->bVgpuScrubberEnabled)
+    {
+        NvU64 id;
+
+        for (id = pScrubber->lastSeenIdByClient; id != pScrubber->lastSubmittedWorkId; id++)
+        {
+            PSCRUB_NODE pNode      = &pScrubber->pScrubList[id % MAX_SCRUB_ITEMS];
+            RmPhysAddr  blockStart = pNode->base;
+            RmPhysAddr  blockEnd   = pNode->base + pNode->size - 1;
+
+            if (blockStart > end || blockEnd < base)
+                continue;
+
+            while (_scrubChannelProgress(pScrubber, pNode->channel) < pNode->channelWorkId)
+            {
+                portUtilSpin();
+            }
+        }
+        return;
+    }
+
     //We need to look up in the range between [lastSeenIdByClient, lastSubmittedWorkId]
     idToWait = _searchScrubList(pScrubber, base, end);
 
@@ -874,7 +1044,9 @@ _scrubAddWorkToList
     OBJMEMSCRUB  *pScrubber,
     RmPhysAddr    base,
     NvU64         size,
-    NvU64         newId
+    NvU64         newId,
+    NvU32         channel,
+    NvU64         channelWorkId
 )
 {
     //since the Id works from [1,4k] range, the Idx in which it writes in 1 lesser
@@ -888,19 +1060,65 @@ _scrubAddWorkToList
     pScrubber->pScrubList[idx].base = base;
     pScrubber->pScrubList[idx].size = size;
     pScrubber->pScrubList[idx].id   = newId;
+    pScrubber->pScrubList[idx].channel       = channel;
+    pScrubber->pScrubList[idx].channelWorkId = channelWorkId;
 
     pScrubber->lastSubmittedWorkId = newId;
     pScrubber->scrubListSize++;
+
+    if (pScrubber->pPmaStats != NULL)
+        pScrubber->pPmaStats->numScrubPendingFrames += size >> PMA_PAGE_SHIFT;
     NV_ASSERT(_scrubGetFreeEntries(pScrubber) <= MAX_SCRUB_ITEMS);
 }
 
 
 
+/**
+ * helper function to return the last completed work ID of a channel, in the
+ * sequence of that channel
+ */
+static NvU64
+_scrubChannelProgress
+(
+    OBJMEMSCRUB *pScrubber,
+    NvU32        channel
+)
+{
+    if (pScrubber->engineType == NV2080_ENGINE_TYPE_SEC2)
+        return sec2utilsUpdateProgress(pScrubber->pSec2Utils);
+
+    return ceutilsUpdateProgress(pScrubber->pCeUtils[channel]);
+}
+
+/**
+ * helper function to service the interrupts of all the scrubber channels
+ */
+static void
+_scrubServiceInterrupts
+(
+    OBJMEMSCRUB *pScrubber
+)
+{
+    NvU32 i;
+
+    if (pScrubber->engineType == NV2080_ENGINE_TYPE_SEC2)
+    {
+        sec2utilsServiceInterrupts(pScrubber->pSec2Utils);
+        return;
+    }
+
+    for (i = 0; i < pScrubber->numChannels; i++)
+        ceutilsServiceInterrupts(pScrubber->pCeUtils[i]);
+}
+
 /**
  * Scrubber uses 64 bit index to track the work submitted. But HW supports
  * only 32 bit semaphore. The current completed Id is calculated here, based
  * on the lastSeenIdByClient and current HW semaphore value.
  *
+ * With several channels, the work completes out of order. The completed Id
+ * is the last one such that all the work up to it is complete.
+ *
  * @returns Current Completed 64 bit ID
  */
 static NvU64
@@ -911,6 +1129,7 @@ _scrubCheckProgress
 {
     NvU32 hwCurrentCompletedId;
     NvU64 lastSWSemaphoreDone;
+    NvU64 id;
 
     NV_ASSERT(pScrubber != NULL);
 
@@ -935,10 +1154,34 @@ _scrubCheckProgress
     }
     else
     {
-        if (pScrubber->engineType ==  NV2080_ENGINE_TYPE_SEC2)
-            lastSWSemaphoreDone = sec2utilsUpdateProgress(pScrubber->pSec2Utils);
-        else
-            lastSWSemaphoreDone = ceutilsUpdateProgress(pScrubber->pCeUtils);
+        NvU64 channelDone[SCRUBBER_MAX_CHANNELS];
+        NvU32 i;
+
+        for (i = 0; i < pScrubber->numChannels; i++)
+            channelDone[i] = _scrubChannelProgress(pScrubber, i);
+
+        // The work with ID (n + 1) is stored at index n
+        lastSWSemaphoreDone = pScrubber->lastSWSemaphoreDone;
+        while (lastSWSemaphoreDone != pScrubber->lastSubmittedWorkId)
+        {
+            PSCRUB_NODE pNode = &pScrubber->pScrubList[lastSWSemaphoreDone % MAX_SCRUB_ITEMS];
+
+            if (channelDone[pNode->channel] < pNode->channelWorkId)
+                break;
+
+            lastSWSemaphoreDone++;
+        }
+    }
+
+    if (pScrubber->pPmaStats != NULL)
+    {
+        for (id = pScrubber->lastSWSemaphoreDone; id < lastSWSemaphoreDone; id++)
+        {
+            NvU64 numFrames = pScrubber->pScrubList[id % MAX_SCRUB_ITEMS].size >> PMA_PAGE_SHIFT;
+
+            pScrubber->pPmaStats->numScrubPendingFrames -= numFrames;
+            pScrubber->pPmaStats->numScrubbedFrames     += numFrames;
+        }
     }
 
     pScrubber->lastSWSemaphoreDone = lastSWSemaphoreDone;
@@ -949,23 +1192,26 @@ _scrubCheckProgress
 
 /**  Single function to memset a surface mapped by GPU. This interface supports
      both sysmem and vidmem surface, since it uses CE to memset a surface.
-     The user is notified by releasing semaphore with value "payload"
+     The ID of the work in the sequence of the channel is returned in
+     pChannelWorkId.
   */
 static NV_STATUS
 _scrubMemory
 (
     OBJMEMSCRUB *pScrubber,
+    NvU32        channel,
     RmPhysAddr   base,
     NvU64        size,
     NvU32        dstCpuCacheAttrib,
-    NvU32        payload
+    NvU64       *pChannelWorkId
 )
 {
     NV_STATUS status = NV_OK;
-    MEMORY_DESCRIPTOR *pMemDesc = NULL;
-    NV_ASSERT_OK_OR_RETURN(memdescCreate(&pMemDesc, pScrubber->pGpu, size, 0, NV_TRUE,
-                                          ADDR_FBMEM, dstCpuCacheAttrib, MEMDESC_FLAGS_NONE));
+    MEMORY_DESCRIPTOR memDesc;
+    MEMORY_DESCRIPTOR *pMemDesc = &memDesc;
 
+    // The range is contiguous, describe it on the stack rather than allocating a memdesc per work item
+    memdescCreateExisting(pMemDesc, pScrubber->pGpu, size, ADDR_FBMEM, dstCpuCacheAttrib, MEMDESC_FLAGS_NONE);
     memdescDescribe(pMemDesc, ADDR_FBMEM, base, size);
 
     if (pScrubber->engineType ==  NV2080_ENGINE_TYPE_SEC2)
@@ -975,7 +1221,7 @@ _scrubMemory
         memsetParams.length = size;
 
         NV_ASSERT_OK_OR_GOTO(status, sec2utilsMemset(pScrubber->pSec2Utils, &memsetParams), cleanup);
-        pScrubber->lastSubmittedWorkId = memsetParams.submittedWorkId;
+        *pChannelWorkId = memsetParams.submittedWorkId;
     }
     else
     {
@@ -984,8 +1230,8 @@ _scrubMemory
         memsetParams.length = size;
         memsetParams.flags = NV0050_CTRL_MEMSET_FLAGS_ASYNC | NV0050_CTRL_MEMSET_FLAGS_PIPELINED;
 
-        NV_ASSERT_OK_OR_GOTO(status, ceutilsMemset(pScrubber->pCeUtils, &memsetParams), cleanup);
-        pScrubber->lastSubmittedWorkId = memsetParams.submittedWorkId;
+        NV_ASSERT_OK_OR_GOTO(status, ceutilsMemset(pScrubber->pCeUtils[channel], &memsetParams), cleanup);
+        *pChannelWorkId = memsetParams.submittedWorkId;
     }
 
 cleanup:
@@ -999,6 +1245,7 @@ _scrubCombinePages
     NvU64       *pPages,
     NvU64        pageSize,
     NvU64        pageCount,
+    NvU64        maxBytesPerLine,
     PSCRUB_NODE *ppScrubList,
     NvU64       *pSize
 )
@@ -1014,7 +1261,7 @@ _scrubCombinePages
 
     for (i = 0, j = 0; i < (pageCount - 1); i++)
     {
-        if ((((*ppScrubList)[j].size + pageSize) > SCRUB_MAX_BYTES_PER_LINE) ||
+        if ((((*ppScrubList)[j].size + pageSize) > maxBytesPerLine) ||
             ((pPages[i] + pageSize) != pPages[i+1]))
         {
             j++;
@@ -994,6 +994,33 @@ memmgrMemUtilsGetMemDescFromHandle_IMPL
     return pMemory->pMemDesc;
 }
 
+//
+// Describe one block of pMemDesc for a blocked transfer. When pMemDesc is
+// physically contiguous the sub-memdesc is built in the caller supplied
+// pStorage, so transfers don't allocate a memdesc per block.
+//
+static NV_STATUS
+_memmgrCreateBlockSubMem
+(
+    MEMORY_DESCRIPTOR  *pMemDesc,
+    OBJGPU             *pGpu,
+    NvU64               offset,
+    NvU64               size,
+    MEMORY_DESCRIPTOR  *pStorage,
+    MEMORY_DESCRIPTOR **ppSubMemDesc
+)
+{
+    NV_STATUS status = memdescCreateSubMemExisting(pStorage, pMemDesc, pGpu, offset, size);
+
+    if (status != NV_ERR_NOT_SUPPORTED)
+    {
+        *ppSubMemDesc = (status == NV_OK) ? pStorage : NULL;
+        return status;
+    }
+
+    return memdescCreateSubMem(ppSubMemDesc, pMemDesc, pGpu, offset, size);
+}
+
 /*!
  * @brief This function is used for write a value placed in a caller passed buffer
  *        to a given memory region while only mapping regions as large as the given
@@ -1022,6 +1049,7 @@ memmgrMemsetInBlocks_IMPL
     OBJGPU    *pGpu      = ENG_GET_GPU(pMemoryManager);
     NvU64      remaining = size;
     NvU64      offset    = 0;
+    MEMORY_DESCRIPTOR subMemDesc;
 
     if (blockSize == 0)
     {
@@ -1034,7 +1062,8 @@ memmgrMemsetInBlocks_IMPL
         NvU32              mapSize     = NV_MIN(blockSize, remaining);
         TRANSFER_SURFACE   surf = {0};
 
-        NV_CHECK_OK_OR_RETURN(LEVEL_SILENT, memdescCreateSubMem(&pSubMemDesc, pMemDesc, pGpu, offset + baseOffset, mapSize));
+        NV_CHECK_OK_OR_RETURN(LEVEL_SILENT,
+            _memmgrCreateBlockSubMem(pMemDesc, pGpu, offset + baseOffset, mapSize, &subMemDesc, &pSubMemDesc));
 
         surf.pMemDesc = pSubMemDesc;
         surf.offset = 0;
@@ -1149,6 +1178,7 @@ memmgrMemReadOrWriteInBlocks
     MEMORY_DESCRIPTOR *pMemDesc          = pSurf->pMemDesc;
     NvU64              offset            = 0;
     NV_STATUS          status            = NV_OK;
+    MEMORY_DESCRIPTOR  subMemDesc;
 
     while ((remainingSize > 0) && (status == NV_OK))
     {
@@ -1159,7 +1189,8 @@ memmgrMemReadOrWriteInBlocks
         if (bCreateSubMemDesc)
         {
             NV_ASSERT_OK_OR_RETURN(
-                memdescCreateSubMem(&pSubMemDesc, pMemDesc, pMemDesc->pGpu, offset + baseOffset, copySize));
+                _memmgrCreateBlockSubMem(pMemDesc, pMemDesc->pGpu, offset + baseOffset, copySize,
+                                         &subMemDesc, &pSubMemDesc));
             tmpSurf.pMemDesc = pSubMemDesc;
             tmpSurf.offset = 0;
         }
@@ -255,7 +255,7 @@ NV_STATUS _pmaNumaAllocateRange
             NvU64 count;
 
             if ((status = scrubSubmitPages(pPma->pScrubObj, (NvU32)actualSize, &gpaPhysAddr,
-                                           1, &pPmaScrubList, &count)) != NV_OK)
+                                           1, SCRUB_SUBMIT_FLAGS_PRIORITY, &pPmaScrubList, &count)) != NV_OK)
             {
                 status = NV_ERR_INSUFFICIENT_RESOURCES;
                 goto scrub_exit;
@@ -411,7 +411,7 @@ static NV_STATUS _pmaNumaAllocatePages
         NvU64 count;
 
         if ((status = scrubSubmitPages(pPma->pScrubObj, pageSize, pPages,
-                                       i, &pPmaScrubList, &count)) != NV_OK)
+                                       i, SCRUB_SUBMIT_FLAGS_PRIORITY, &pPmaScrubList, &count)) != NV_OK)
         {
             status = NV_ERR_INSUFFICIENT_RESOURCES;
             goto scrub_exit;
@@ -263,6 +263,8 @@ pmaInitialize(PMA *pPma, NvU32 initFlags)
     pPma->pmaStats.numFreeFramesProtected = 0;
     pPma->pmaStats.num2mbPagesProtected = 0;
     pPma->pmaStats.numFree2mbPagesProtected = 0;
+    pPma->pmaStats.numScrubPendingFrames = 0;
+    pPma->pmaStats.numScrubbedFrames = 0;
     pPma->regSize = 0;
     portAtomicSetSize(&pPma->initScrubbing, PMA_SCRUB_INITIALIZE);
 
@@ -591,6 +593,12 @@ pmaAllocatePages
     NvBool tryEvict = NV_TRUE;
     NvBool tryAlloc = NV_TRUE;
 
+    //
+    // Whether eviction was put off on the first attempt because enough freed
+    // memory was still being scrubbed.
+    //
+    NvBool bEvictAfterScrubWait = NV_FALSE;
+
     if (pPma == NULL || pPages == NULL || allocationCount == 0
         || (pageSize != _PMA_64KB && pageSize != _PMA_128KB && pageSize != _PMA_2MB && pageSize != _PMA_512MB)
         || allocationOptions == NULL)
@@ -771,6 +779,11 @@ pmaAllocatePages_retry:
         if (regionList[regionIdx] == -1)
         {
             status = NV_ERR_NO_MEMORY;
+
+            // Go wait for the scrubber, eviction is retried afterwards
+            if (bEvictAfterScrubWait)
+                break;
+
             goto normal_exit;
         }
         NV_ASSERT(regionList[regionIdx] < PMA_REGION_SIZE);
@@ -877,6 +890,19 @@ pmaAllocatePages_retry:
                 NV_ASSERT(numPagesAllocatedThisTime == 0);
             }
         }
+        else if (tryEvict && bScrubOnFree && tryAlloc &&
+                 (pPma->pmaStats.numScrubPendingFrames >= numPagesLeftToAllocate * framesPerPage))
+        {
+            //
+            // Memory freed earlier is still being scrubbed. Waiting for the
+            // scrubber is cheaper than evicting, which would also have to
+            // scrub the evicted memory. Wait for it first and only evict on
+            // the retry if that wasn't enough.
+            //
+            NV_PRINTF(LEVEL_INFO, "Status evictable, waiting for the scrubber before evicting\n");
+            bEvictAfterScrubWait = NV_TRUE;
+            status = NV_ERR_NO_MEMORY;
+        }
         else if (tryEvict)
         {
             NV_PRINTF(LEVEL_INFO, "Status evictable, region before eviction:\n");
@@ -1021,12 +1047,13 @@ pmaAllocatePages_retry:
         //
         // Set tryEvict to NV_FALSE because we know UVM already failed eviction and any
         // available memory that comes after we tried eviction will not be counted towards
-        // this allocation.
+        // this allocation. If eviction was put off to wait for the scrubber, it is still
+        // allowed.
         //
         if (tryAlloc)
         {
             tryAlloc = NV_FALSE;
-            tryEvict = NV_FALSE;
+            tryEvict = bEvictAfterScrubWait;
             NV_PRINTF(LEVEL_INFO, "Retrying after waiting for scrubber\n");
             goto pmaAllocatePages_retry;
         }
@@ -1391,7 +1418,7 @@ pmaFreePages
         PSCRUB_NODE pPmaScrubList = NULL;
         NvU64 count;
         if (scrubSubmitPages(pPma->pScrubObj, size, pPages, pageCount,
-                             &pPmaScrubList, &count) == NV_OK)
+                             SCRUB_SUBMIT_FLAGS_NONE, &pPmaScrubList, &count) == NV_OK)
         {
             if (count > 0)
             {
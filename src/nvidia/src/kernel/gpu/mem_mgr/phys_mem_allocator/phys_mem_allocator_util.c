@@ -62,7 +62,7 @@ NV_STATUS scrubCheck(OBJMEMSCRUB *pScrubber, PSCRUB_NODE *ppList, NvU64 *size)
 }
 
 NV_STATUS scrubSubmitPages(OBJMEMSCRUB *pScrubber, NvU64 chunkSize, NvU64* pages,
-                           NvU64 pageCount, PSCRUB_NODE *ppList, NvU64 *size)
+                           NvU64 pageCount, NvU32 flags, PSCRUB_NODE *ppList, NvU64 *size)
 {
     return NV_ERR_GENERIC;
 }
@@ -488,7 +488,7 @@ _pmaEvictContiguous
             NvU64 count;
 
             if ((status = scrubSubmitPages(pPma->pScrubObj, (NvU32)evictSize, &evictStart,
-                                           1, &pPmaScrubList, &count)) != NV_OK)
+                                           1, SCRUB_SUBMIT_FLAGS_PRIORITY, &pPmaScrubList, &count)) != NV_OK)
             {
                 status = NV_ERR_INSUFFICIENT_RESOURCES;
                 goto scrub_exit;
@@ -602,7 +602,8 @@ _pmaEvictPages
 
         // Don't need to mark ATTRIB_SCRUBBING to protect the pages because they are already pinned
         status = scrubSubmitPages(pPma->pScrubObj, pageSize, evictPages,
-                                  (NvU32)evictPageCount, &pPmaScrubList, &count);
+                                  (NvU32)evictPageCount, SCRUB_SUBMIT_FLAGS_PRIORITY,
+                                  &pPmaScrubList, &count);
         NV_ASSERT_OR_GOTO((status == NV_OK), scrub_exit);
 
         if (count > 0)
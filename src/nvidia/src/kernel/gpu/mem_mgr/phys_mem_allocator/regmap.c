@@ -45,6 +45,18 @@
 
 #define SETBITS(bits, mask, newVal) ((bits & (~mask)) | (mask & newVal))
 
+//
+// The allocation state is summarized per chunk of 64MB (1024 frames, 16 map
+// words) so that the scans can skip chunks that are completely allocated, and
+// large contiguous searches can skip candidates covering a chunk that isn't
+// completely free.
+//
+#define CHUNK_TO_U64_SHIFT          4
+#define CHUNK_FRAME_SHIFT           (CHUNK_TO_U64_SHIFT + FRAME_TO_U64_SHIFT)
+#define CHUNK_FRAME_SIZE            (1llu << CHUNK_FRAME_SHIFT)
+#define CHUNK_TO_U64_MASK           ((1llu << CHUNK_TO_U64_SHIFT) - 1llu)
+#define PAGE_CHUNKIDX(n)            ((n) >> CHUNK_FRAME_SHIFT)
+
 //////////////// DEBUG ///////////////
 
 void
@@ -158,6 +170,63 @@ _checkOne(NvU64 *bits, NvU64 start, NvU64 end)
     }
 }
 
+// Number of frames of the region in the given chunk; only the last one is partial.
+static NvU64
+_pmaRegmapChunkFrames(PMA_REGMAP *pRegmap, NvU64 chunkIdx)
+{
+    NvU64 chunkStart = chunkIdx << CHUNK_FRAME_SHIFT;
+
+    return NV_MIN(CHUNK_FRAME_SIZE, pRegmap->totalFrames - chunkStart);
+}
+
+//
+// Whether none of the frames of the chunk can be allocated: all of them are
+// pinned, or all of them are allocated when evictable frames don't qualify.
+//
+static NvBool
+_pmaRegmapChunkFull(PMA_REGMAP *pRegmap, NvU64 chunkIdx, NvBool bSearchEvictable)
+{
+    NvU32 count = bSearchEvictable ? pRegmap->pChunkPinFrames[chunkIdx] :
+                                     pRegmap->pChunkAllocFrames[chunkIdx];
+
+    return count == _pmaRegmapChunkFrames(pRegmap, chunkIdx);
+}
+
+//
+// Find the last chunk lying entirely within [frameBegin, frameEnd] with a frame
+// that can't be allocated. No run starting at or before its start can cover
+// the range then.
+//
+static NvBool
+_pmaRegmapFindLastUsedChunk
+(
+    PMA_REGMAP *pRegmap,
+    NvU64       frameBegin,
+    NvU64       frameEnd,
+    NvBool      bSearchEvictable,
+    NvU64      *pChunkIdx
+)
+{
+    NvU64 firstChunk = PAGE_CHUNKIDX(frameBegin + CHUNK_FRAME_SIZE - 1llu);
+    NvU64 chunkIdx = PAGE_CHUNKIDX(frameEnd + 1llu);
+
+    while (chunkIdx > firstChunk)
+    {
+        NvU32 count;
+
+        chunkIdx--;
+        count = bSearchEvictable ? pRegmap->pChunkPinFrames[chunkIdx] :
+                                   pRegmap->pChunkAllocFrames[chunkIdx];
+        if (count != 0)
+        {
+            *pChunkIdx = chunkIdx;
+            return NV_TRUE;
+        }
+    }
+
+    return NV_FALSE;
+}
+
 static NvU64 alignUpToMod(NvU64 frame, NvU64 alignment, NvU64 mod)
 {
     return ((frame - mod + alignment - 1ll) & ~(alignment - 1ll)) + mod;
@@ -395,6 +464,17 @@ pmaRegmapInit
     newMap->bProtected = bProtected;
     newMap->pPmaStats = pPmaStats;
     newMap->mapLength = PAGE_MAPIDX(numFrames-1) + 1;
+    newMap->numChunks = PAGE_CHUNKIDX(numFrames-1) + 1;
+
+    newMap->pChunkAllocFrames = portMemAllocNonPaged((NvLength)(newMap->numChunks * sizeof(NvU32)));
+    newMap->pChunkPinFrames = portMemAllocNonPaged((NvLength)(newMap->numChunks * sizeof(NvU32)));
+    if ((newMap->pChunkAllocFrames == NULL) || (newMap->pChunkPinFrames == NULL))
+    {
+        pmaRegmapDestroy(newMap);
+        return NULL;
+    }
+    portMemSet(newMap->pChunkAllocFrames, 0, (NvLength)(newMap->numChunks * sizeof(NvU32)));
+    portMemSet(newMap->pChunkPinFrames, 0, (NvLength)(newMap->numChunks * sizeof(NvU32)));
 
     for (i = 0; i < PMA_BITS_PER_PAGE; i++)
     {
@@ -434,6 +514,9 @@ pmaRegmapDestroy(void *pMap)
         portMemFree(pRegmap->map[i]);
     }
 
+    portMemFree(pRegmap->pChunkAllocFrames);
+    portMemFree(pRegmap->pChunkPinFrames);
+
     pRegmap->pPmaStats->numFreeFrames -= pRegmap->totalFrames;
 
     if (pRegmap->bProtected)
@@ -523,6 +606,12 @@ _pmaRegmapDoSingleStateChange
     pRegmap->map[MAP_IDX_ALLOC_PIN][idx] = pinOut;
     pRegmap->map[MAP_IDX_ALLOC_UNPIN][idx] = unpinOut;
 
+    // Unsigned wraparound gives the right result when frames are freed
+    pRegmap->pChunkAllocFrames[idx >> CHUNK_TO_U64_SHIFT] +=
+        (NvU32)nvPopCount64(finalState) - (NvU32)nvPopCount64(initialState);
+    pRegmap->pChunkPinFrames[idx >> CHUNK_TO_U64_SHIFT] +=
+        (NvU32)nvPopCount64(pinOut) - (NvU32)nvPopCount64(pinIn);
+
     // Update deltas
     (*delta64k) += nvPopCount64(xored);
     // Each 2M page is 32 64K pages, so we check each half of a 64-bit qword and xor them
@@ -686,6 +775,7 @@ static NvS64 _scanContiguousSearchLoop
     NvU64 frameBaseIdx = alignUpToMod(localStart, frameAlignment, frameAlignmentPadding); // this is already done by the caller
     NvU64 nextStrideStart;
     NvU64 latestFree[PMA_BITS_PER_PAGE];
+    NvU64 chunkIdx;
     NvU64 i;
 
     // can't allocate contiguous memory > stride. This is guaranteed by the caller, but be sure here
@@ -750,6 +840,15 @@ loop_begin:
     {
         return -1;
     }
+
+    // Skip past any chunk covered by this candidate that isn't entirely free
+    if ((numFrames >= CHUNK_FRAME_SIZE) &&
+        _pmaRegmapFindLastUsedChunk(pRegmap, frameBaseIdx, frameBaseIdx + numFrames - 1llu,
+                                    bSearchEvictable, &chunkIdx))
+    {
+        frameBaseIdx = alignUpToMod((chunkIdx << CHUNK_FRAME_SHIFT) + 1llu, frameAlignment, frameAlignmentPadding);
+        goto loop_begin;
+    }
     for (i = 0; i < PMA_BITS_PER_PAGE; i++)
     {
         // TODO, merge logic so we don't need multiple calls for unpin
@@ -787,6 +886,13 @@ loop_begin:
                 frameBaseIdx += FRAME_TO_U64_SIZE;
                 while (frameBaseIdx <= localEnd)
                 {
+                    if (((curMapIdx & CHUNK_TO_U64_MASK) == 0) &&
+                        _pmaRegmapChunkFull(pRegmap, curMapIdx >> CHUNK_TO_U64_SHIFT, bSearchEvictable))
+                    {
+                        frameBaseIdx += CHUNK_FRAME_SIZE;
+                        curMapIdx += CHUNK_TO_U64_MASK + 1llu;
+                        continue;
+                    }
                     curMap = pRegmap->map[i][curMapIdx];
                     if(curMap != NV_U64_MAX)
                     {
@@ -1036,6 +1142,14 @@ loop_begin:
                     frameBaseIdx += FRAME_TO_U64_SIZE;
                     while (frameBaseIdx <= localEnd)
                     {
+                        // Chunks with only pinned frames have neither free nor evictable ones
+                        if (((curMapIdx & CHUNK_TO_U64_MASK) == 0) &&
+                            _pmaRegmapChunkFull(pRegmap, curMapIdx >> CHUNK_TO_U64_SHIFT, NV_TRUE))
+                        {
+                            frameBaseIdx += CHUNK_FRAME_SIZE;
+                            curMapIdx += CHUNK_TO_U64_MASK + 1llu;
+                            continue;
+                        }
                         curMap =  pRegmap->map[i][curMapIdx];
                         if(curMap != NV_U64_MAX)
                         {
@@ -1561,7 +1675,33 @@ pmaRegmapGetLargestFree
 
     while (mapIndex <= mapMaxIndex)
     {
-        NvU64 bitmap = pRegmap->map[MAP_IDX_ALLOC_UNPIN][mapIndex] | pRegmap->map[MAP_IDX_ALLOC_PIN][mapIndex];
+        NvU64 bitmap;
+
+        // Account for whole chunks that are entirely free or allocated at once
+        if ((mapIndex & CHUNK_TO_U64_MASK) == 0)
+        {
+            NvU64 chunkIdx = mapIndex >> CHUNK_TO_U64_SHIFT;
+
+            if (_pmaRegmapChunkFrames(pRegmap, chunkIdx) == CHUNK_FRAME_SIZE)
+            {
+                if (pRegmap->pChunkAllocFrames[chunkIdx] == 0)
+                {
+                    mapTrailZeros += CHUNK_FRAME_SIZE;
+                    mapIndex += CHUNK_TO_U64_MASK + 1llu;
+                    continue;
+                }
+
+                if (pRegmap->pChunkAllocFrames[chunkIdx] == CHUNK_FRAME_SIZE)
+                {
+                    regionMaxZeros = NV_MAX(regionMaxZeros, mapTrailZeros);
+                    mapTrailZeros = 0;
+                    mapIndex += CHUNK_TO_U64_MASK + 1llu;
+                    continue;
+                }
+            }
+        }
+
+        bitmap = pRegmap->map[MAP_IDX_ALLOC_UNPIN][mapIndex] | pRegmap->map[MAP_IDX_ALLOC_PIN][mapIndex];
 
         // If the last map[] is only partially used, mask the valid bits
         if (mapIndex == mapMaxIndex && (PAGE_BITIDX(pRegmap->totalFrames) != 0))
@@ -42,6 +42,7 @@
 #include "kernel/gpu/gpu_fabric_probe.h"
 #include "rmapi/client.h"
 #include "rmapi/rs_utils.h"
+#include "rmapi/rmapi.h"
 #include "rmapi/rmapi_utils.h"
 #include "gpu/mem_mgr/mem_scrub.h"
 #include "vgpu/rpc.h"
@@ -3312,6 +3313,8 @@ kmigmgrSetGPUInstanceInfo_IMPL
             NV_PRINTF(LEVEL_INFO, "CREATING GPU instance\n");
             kmigmgrPrintGPUInstanceInfo(pGpu, pKernelMIGManager, pKernelMIGGpuInstance);
 
+            rmapiControlCacheInvalidateGpuConfig(pGpu->gpuInstance);
+
             break;
         }
     }
@@ -3739,6 +3742,9 @@ kmigmgrSetPartitioningMode_IMPL
 
     gpumgrCacheSetMIGEnabled(pGpu, pKernelMIGManager->bMIGEnabled);
 
+    // Controls cached with the previous MIG mode are stale
+    rmapiControlCacheInvalidateGpuConfig(pGpu->gpuInstance);
+
     // MIG Mode might not have been enabled yet, so load static info if enabled
     if (IS_MIG_ENABLED(pGpu))
     {
@@ -5950,6 +5956,8 @@ kmigmgrInvalidateGPUInstance_IMPL
     // Initialize gpu instance info to initial value
     kmigmgrInitGPUInstanceInfo(pGpu, pKernelMIGManager, pKernelMIGGpuInstance);
 
+    rmapiControlCacheInvalidateGpuConfig(pGpu->gpuInstance);
+
     //
     // Only partitions in which VGPU guests are booted require changing
     // engine interrupt vectors to deterministic values for migration.
@@ -41,6 +41,7 @@
 #include "compute/imex_session_api.h"
 #include "compute/fabric.h"
 #include "mem_mgr/mem_multicast_fabric.h"
+#include "rmapi/rmapi.h"
 
 /*!
  * @brief Is NVLINK topology forced? NVLink topology is considered
@@ -1642,6 +1643,8 @@ knvlinkUpdateLinkConnectionStatus_IMPL
         return status;
     }
 
+    rmapiControlCacheInvalidateGpuConfig(pGpu->gpuInstance);
+
     return NV_OK;
 }
 
@@ -30,6 +30,7 @@
 #include "gpu_mgr/gpu_mgr.h"
 #include "gpu/gpu.h"
 #include "platform/sli/sli.h"
+#include "rmapi/rmapi.h"
 
 #include "kernel/gpu/nvlink/kernel_nvlink.h"
 #include "kernel/gpu/nvlink/kernel_ioctrl.h"
@@ -1419,6 +1420,7 @@ knvlinkFloorSweep_IMPL
 
     // Redo linkMasks based on the search above being the ground truth
     pKernelNvlink->enabledLinks          = tmpEnabledLinkMask;
+    rmapiControlCacheInvalidateGpuConfig(pGpu->gpuInstance);
 
     //
     // remove any links not in active in the tmpEnabledLinkMask from all
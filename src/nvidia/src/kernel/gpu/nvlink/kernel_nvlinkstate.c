@@ -27,6 +27,7 @@
 #include "kernel/gpu/nvlink/kernel_ioctrl.h"
 #include "kernel/gpu/mem_sys/kern_mem_sys.h"
 #include "os/os.h"
+#include "rmapi/rmapi.h"
 
 static NV_STATUS _knvlinkCreateIoctrl(OBJGPU *, KernelNvlink *, NvU32);
 static NV_STATUS _knvlinkFilterDiscoveredLinks(OBJGPU *, KernelNvlink *);
@@ -1133,6 +1134,8 @@ knvlinkSetDegradedMode_IMPL
                 "GPU%d marked Degraded for error on linkId %d \n",
                 pGpu->gpuInstance, linkId);
 
+        rmapiControlCacheInvalidateGpuConfig(pGpu->gpuInstance);
+
         // shutdown all the links on this GPU
         status = knvlinkCoreShutdownDeviceLinks(pGpu, pKernelNvlink, NV_TRUE);
         if (status != NV_OK)
@@ -60,6 +60,7 @@
 #include "gpu/ce/kernel_ce_shared.h"
 #include "rmapi/resource_fwd_decls.h"
 #include "rmapi/client.h"
+#include "rmapi/rmapi.h"
 
 #include "class/cl900e.h"
 
@@ -499,6 +500,21 @@ getGpuInfos(Subdevice *pSubdevice, NV2080_CTRL_GPU_GET_INFO_V2_PARAMS *pParams,
                 // Only forward to physical if we're in the HW-access-enabled control
                 if ((IS_GSP_CLIENT(pGpu) || IS_VIRTUAL(pGpu)) && bCanAccessHw)
                 {
+                    //
+                    // Indexes already returned by the physical RM and cached
+                    // are not forwarded again, so that a list mixing them
+                    // with uncacheable indexes handled here does not need an
+                    // RPC.
+                    //
+                    if (rmapiControlCacheGetInfoIndex(RES_GET_CLIENT_HANDLE(pSubdevice),
+                                                      RES_GET_HANDLE(pSubdevice),
+                                                      NV2080_CTRL_CMD_GPU_GET_INFO_V2,
+                                                      pParams->gpuInfoList[i].index,
+                                                      &data) == NV_OK)
+                    {
+                        break;
+                    }
+
                     pParams->gpuInfoList[i].index |= INDEX_FORWARD_TO_PHYSICAL;
                     bPhysicalForward = NV_TRUE;
                 }
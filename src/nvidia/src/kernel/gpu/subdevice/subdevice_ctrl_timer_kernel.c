@@ -228,7 +228,7 @@ subdeviceCtrlCmdTimerSchedule_IMPL
 // subdeviceCtrlCmdTimerGetTime
 //
 // Lock Requirements:
-//      Assert that API lock and GPUs lock held on entry
+//      Assert that the device GPU lock is held on entry (no API lock)
 //      Timer callback list accessed in tmrService at DPC
 //
 NV_STATUS
@@ -254,7 +254,7 @@ subdeviceCtrlCmdTimerGetTime_IMPL
     }
     else
     {
-        LOCK_ASSERT_AND_RETURN(rmapiLockIsOwner() && rmDeviceGpuLockIsOwner(pGpu->gpuInstance));
+        LOCK_ASSERT_AND_RETURN(rmDeviceGpuLockIsOwner(pGpu->gpuInstance));
     }
 
     tmrGetCurrentTime(pTmr, &pParams->time_nsec);
@@ -54,7 +54,8 @@
 // local static funcs
 static void   gpumgrSetAttachInfo(OBJGPU *, GPUATTACHARG *);
 static void   gpumgrGetGpuHalFactor(NvU32 *pChipId0, NvU32 *pChipId1, NvU32 *pSocChipId0, RM_RUNTIME_VARIANT *pRmVariant, TEGRA_CHIP_TYPE *pTegraType, GPUATTACHARG *pAttachArg);
-static NvBool _gpumgrGetPcieP2PCapsFromCache(NvU32 gpuMask, NvU8* pP2PWriteCapsStatus, NvU8* pP2PReadCapsStatus);
+static NvBool _gpumgrGetPcieP2PCapsFromCache(NvU32 gpuMask, NvU8* pP2PWriteCapsStatus, NvU8* pP2PReadCapsStatus,
+                                             NvBool *pbCommonPciSwitch);
 
 static void
 _gpumgrUnregisterRmCapsForGpuUnderLock(NvU64 gpuDomainBusDevice)
@@ -4210,6 +4211,7 @@ gpumgrDestroyPcieP2PCapsCache_IMPL(OBJGPUMGR* pGpuMgr)
  * @param[in]   gpuMask             NvU32 value
  * @param[in]   p2pWriteCapsStatus  NvU8 value
  * @param[in]   pP2PReadCapsStatus  NvU8 value
+ * @param[in]   bCommonPciSwitch    NvBool value
  *
  * @return      NV_OK or NV_ERR_NO_MEMORY
  */
@@ -4218,7 +4220,8 @@ gpumgrStorePcieP2PCapsCache_IMPL
 (
     NvU32  gpuMask,
     NvU8   p2pWriteCapsStatus,
-    NvU8   p2pReadCapsStatus
+    NvU8   p2pReadCapsStatus,
+    NvBool bCommonPciSwitch
 )
 {
     OBJSYS          *pSys     = SYS_GET_INSTANCE();
@@ -4230,7 +4233,7 @@ gpumgrStorePcieP2PCapsCache_IMPL
     NvU32            status   = NV_OK;
 
     portSyncMutexAcquire(pGpuMgr->pcieP2PCapsInfoLock);
-    if (_gpumgrGetPcieP2PCapsFromCache(gpuMask, NULL, NULL))
+    if (_gpumgrGetPcieP2PCapsFromCache(gpuMask, NULL, NULL, NULL))
     {
         // Entry already present in cache
         goto exit;
@@ -4254,6 +4257,7 @@ gpumgrStorePcieP2PCapsCache_IMPL
     pPcieCapsInfo->gpuCount = gpuCount;
     pPcieCapsInfo->p2pWriteCapsStatus = p2pWriteCapsStatus;
     pPcieCapsInfo->p2pReadCapsStatus = p2pReadCapsStatus;
+    pPcieCapsInfo->bCommonPciSwitch = bCommonPciSwitch;
 
 exit:
     portSyncMutexRelease(pGpuMgr->pcieP2PCapsInfoLock);
@@ -4269,6 +4273,8 @@ exit:
  *                  Can be NULL
  * @param[out]  pP2PReadCapsStatus  NvU8* pointer
  *                  Can be NULL
+ * @param[out]  pbCommonPciSwitch   NvBool* pointer
+ *                  Can be NULL
  * Return       bFound              NvBool
  */
 static NvBool
@@ -4276,7 +4282,8 @@ _gpumgrGetPcieP2PCapsFromCache
 (
     NvU32   gpuMask,
     NvU8   *pP2PWriteCapsStatus,
-    NvU8   *pP2PReadCapsStatus)
+    NvU8   *pP2PReadCapsStatus,
+    NvBool *pbCommonPciSwitch)
 {
     OBJSYS          *pSys = SYS_GET_INSTANCE();
     OBJGPUMGR       *pGpuMgr = SYS_GET_GPUMGR(pSys);
@@ -4330,6 +4337,8 @@ _gpumgrGetPcieP2PCapsFromCache
                 *pP2PWriteCapsStatus = pPcieCapsInfo->p2pWriteCapsStatus;
             if (pP2PReadCapsStatus != NULL)
                 *pP2PReadCapsStatus = pPcieCapsInfo->p2pReadCapsStatus;
+            if (pbCommonPciSwitch != NULL)
+                *pbCommonPciSwitch = pPcieCapsInfo->bCommonPciSwitch;
             bFound = NV_TRUE;
             break;
         }
@@ -4346,6 +4355,8 @@ _gpumgrGetPcieP2PCapsFromCache
  *                  Can be NULL
  * @param[out]  pP2PReadCapsStatus  NvU8* pointer
  *                  Can be NULL
+ * @param[out]  pbCommonPciSwitch   NvBool* pointer
+ *                  Can be NULL
  *
  * return       bFound              NvBool
  */
@@ -4354,7 +4365,8 @@ gpumgrGetPcieP2PCapsFromCache_IMPL
 (
     NvU32   gpuMask,
     NvU8   *pP2PWriteCapsStatus,
-    NvU8   *pP2PReadCapsStatus
+    NvU8   *pP2PReadCapsStatus,
+    NvBool *pbCommonPciSwitch
 )
 {
     OBJSYS    *pSys    = SYS_GET_INSTANCE();
@@ -4363,7 +4375,8 @@ gpumgrGetPcieP2PCapsFromCache_IMPL
 
     portSyncMutexAcquire(pGpuMgr->pcieP2PCapsInfoLock);
 
-    bFound = _gpumgrGetPcieP2PCapsFromCache(gpuMask, pP2PWriteCapsStatus, pP2PReadCapsStatus);
+    bFound = _gpumgrGetPcieP2PCapsFromCache(gpuMask, pP2PWriteCapsStatus, pP2PReadCapsStatus,
+                                            pbCommonPciSwitch);
 
     portSyncMutexRelease(pGpuMgr->pcieP2PCapsInfoLock);
 
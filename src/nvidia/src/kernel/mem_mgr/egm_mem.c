@@ -76,7 +76,7 @@ egmmemConstruct_IMPL
 
     stdmemDumpInputAllocParams(pAllocData, pCallContext);
 
-    NV_PRINTF(LEVEL_ERROR, "EGM Allocation requested\n");
+    NV_PRINTF(LEVEL_INFO, "EGM Allocation requested\n");
 
     pAllocRequest->classNum = NV_MEMORY_EXTENDED_USER;
     pAllocRequest->pUserParams = pAllocData;
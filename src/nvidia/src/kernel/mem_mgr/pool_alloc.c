@@ -46,6 +46,13 @@
 #define PMA_CHUNK_SIZE_256K (256 * 1024)
 #define PMA_CHUNK_SIZE_64K  (64 * 1024)
 
+//
+// Amount of free memory kept in the topmost pool when it is trimmed on free,
+// so that page tables freed and allocated again (e.g. across unmap and map)
+// don't go through PMA each time.
+//
+#define RM_POOL_TRIM_ON_FREE_PRESERVE_SIZE (4 * 1024 * 1024)
+
 /*! PAGE SIZES FOR DIFFERENT POOL ALLOCATOR LEVELS
  *
  * CONTEXT BUFFER allocations
@@ -184,6 +191,11 @@ struct RM_POOL_ALLOC_MEM_RESERVE_INFO
      */
     NvBool bTrimOnFree;
 
+    /*!
+     * Number of free topmost pool chunks preserved when trimming on free.
+     */
+    NvU32 trimOnFreePreserveCount;
+
     /*!
      * Allocate pool in protected memory
      */
@@ -558,6 +570,8 @@ rmMemPoolSetup
     else
     {
         pMemReserveInfo->bTrimOnFree = NV_TRUE;
+        pMemReserveInfo->trimOnFreePreserveCount =
+            NV_MAX(1, (NvU32)(RM_POOL_TRIM_ON_FREE_PRESERVE_SIZE / pMemReserveInfo->pmaChunkSize));
     }
 done:
     if (NV_OK != status)
@@ -887,10 +901,13 @@ rmMemPoolFree
 
     rmMemPoolRemoveRef(pMemReserveInfo);
 
-    // Trim the topmost pool so that any unused pages are returned to PMA.
+    //
+    // Trim the topmost pool so that unused pages beyond the preserved ones
+    // are returned to PMA.
+    //
     if (pMemReserveInfo->bTrimOnFree)
     {
-        rmMemPoolTrim(pMemReserveInfo, 1, flags);
+        rmMemPoolTrim(pMemReserveInfo, pMemReserveInfo->trimOnFreePreserveCount, flags);
     }
 done:
     portSyncMutexRelease(pMemReserveInfo->pPoolLock);
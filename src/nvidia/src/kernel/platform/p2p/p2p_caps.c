@@ -359,8 +359,17 @@ _kp2pCapsGetStatusOverPcie
     pGpu = gpumgrGetNextGpu(gpuMask, &gpuInstance);
     if (IS_GSP_CLIENT(pGpu))
     {
-        if (gpumgrGetPcieP2PCapsFromCache(gpuMask, pP2PWriteCapStatus, pP2PReadCapStatus))
+        //
+        // The common switch result feeds the BAR1 P2P read capability, so it
+        // is cached along with the caps to answer repeat queries the same way.
+        //
+        if (gpumgrGetPcieP2PCapsFromCache(gpuMask, pP2PWriteCapStatus, pP2PReadCapStatus,
+                                          &bCommonPciSwitchFound))
         {
+            if (pbCommonPciSwitch != NULL)
+            {
+                *pbCommonPciSwitch = bCommonPciSwitchFound;
+            }
             return NV_OK;
         }
     }
@@ -551,13 +560,14 @@ done:
 
     //
     // Not fatal if failing, effect would be perf degradation as we would not hit the cache.
-    // So just assert.
+    // So just assert. Failed lookups are not cached, as they may be transient.
     //
     gpuInstance = 0;
     pGpu = gpumgrGetNextGpu(gpuMask, &gpuInstance);
-    if (IS_GSP_CLIENT(pGpu))
+    if (IS_GSP_CLIENT(pGpu) && (status == NV_OK))
     {
-       NV_ASSERT_OK(gpumgrStorePcieP2PCapsCache(gpuMask, *pP2PWriteCapStatus, *pP2PReadCapStatus));
+       NV_ASSERT_OK(gpumgrStorePcieP2PCapsCache(gpuMask, *pP2PWriteCapStatus, *pP2PReadCapStatus,
+                                                bCommonPciSwitchFound));
     }
     return status;
 }
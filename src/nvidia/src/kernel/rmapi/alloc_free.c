@@ -247,7 +247,9 @@ serverTopLock_Prologue
             if (pLockInfo->flags & RS_LOCK_FLAGS_LOW_PRIORITY)
                 flags |= RMAPI_LOCK_FLAGS_LOW_PRIORITY;
 
-            if ((status = rmapiLockAcquire(flags, RM_LOCK_MODULES_CLIENT)) != NV_OK)
+            if ((status = rmapiLockAcquireForOp(flags, RM_LOCK_MODULES_CLIENT,
+                                                pLockInfo->traceOp,
+                                                pLockInfo->traceClassId)) != NV_OK)
             {
                 return status;
             }
@@ -904,8 +904,14 @@ serverControlLookupLockFlags
     {
         if (controlFlags & RMCTRL_FLAGS_NO_API_LOCK)
         {
-            // NO_API_LOCK requires no access to GPU lock protected data
-            NV_ASSERT_OR_RETURN(((controlFlags & RMCTRL_FLAGS_NO_GPUS_LOCK) != 0),
+            //
+            // NO_API_LOCK requires either no access to GPU lock protected data,
+            // or access limited to the GPU lock of the target device. Taking
+            // all GPU locks without the API lock would serialize every client
+            // on every GPU, which is exactly what this flag is meant to avoid.
+            //
+            NV_ASSERT_OR_RETURN(((controlFlags & (RMCTRL_FLAGS_NO_GPUS_LOCK |
+                                                  RMCTRL_FLAGS_GPU_LOCK_DEVICE_ONLY)) != 0),
                 NV_ERR_INVALID_LOCK_STATE);
 
             // NO_API_LOCK used in combination with API_LOCK_READONLY does not make sense
@@ -277,6 +277,16 @@ static NV_STATUS _gpuEngineEventNotificationListNotify
     NV_STATUS status = NV_OK;
     PendingEventNotifyList *pPending =
         &pEventNotificationList->pendingEventNotifyList;
+    ENGINE_EVENT_NOTIFICATION *pEngineEventNotification;
+
+    //
+    // Most non-stall interrupts come from engines nobody registered an event
+    // on. Skip the spinlock for them. The count is read without the lock, but
+    // an event that is being registered concurrently could just as well have
+    // been registered after this interrupt.
+    //
+    if (listCount(&pEventNotificationList->eventNotificationList) == 0)
+        return NV_OK;
 
     //
     // Acquire engine list spinlock before traversing the list. Note that this
@@ -296,7 +306,7 @@ static NV_STATUS _gpuEngineEventNotificationListNotify
             listIterAll(&pEventNotificationList->eventNotificationList);
         while (listIterNext(&it))
         {
-            ENGINE_EVENT_NOTIFICATION *pEngineEventNotification = it.pValue;
+            pEngineEventNotification = it.pValue;
             if (hEvent &&
                 pEngineEventNotification->pEventNotify->hEvent != hEvent)
                 continue;
@@ -362,23 +372,16 @@ static NV_STATUS _gpuEngineEventNotificationListNotify
     portSyncSpinlockRelease(pEventNotificationList->pSpinlock);
 
     //
-    // Iterate through the pending notifications and call the OS to send them.
+    // Drain the pending notifications, calling the OS to send each one.
     // Note that osNotifyEvent may need to be preemptible, so this is done
-    // outside of the spinlock-protected critical section.
+    // outside of the spinlock-protected critical section. The nodes stay valid
+    // after being unlinked, as removals are blocked until the count is reset.
     //
-    PendingEventNotifyListIter it = listIterAll(pPending);
-    while (listIterNext(&it))
+    while ((pEngineEventNotification = listHead(pPending)) != NULL)
     {
+        listRemove(pPending, pEngineEventNotification);
         NV_ASSERT_OK_OR_CAPTURE_FIRST_ERROR(status,
-            osNotifyEvent(pGpu, it.pValue->pEventNotify, 0, 0, NV_OK));
-    }
-
-    // Remove all entries from the pending event notify list
-    ENGINE_EVENT_NOTIFICATION *pIter, *pNext;
-    for (pIter = listHead(pPending); pIter != NULL; pIter = pNext)
-    {
-        pNext = listNext(pPending, pIter);
-        listRemove(pPending, pIter);
+            osNotifyEvent(pGpu, pEngineEventNotification->pEventNotify, 0, 0, NV_OK));
     }
 
     NV_ASSERT(listCount(pPending) == 0);
@@ -3360,6 +3360,7 @@ nvGpuOpsBuildExternalAllocPtes
     NvBool         *isPLCable = NULL;
     NvU64          *guestPhysicalAddress = NULL;
     NvU64          mappingPageSize = pGpuExternalMappingInfo->mappingPageSize;
+    const GMMU_FIELD_ADDRESS *pAddrFld;
 
     NV_ASSERT(!memdescHasSubDeviceMemDescs(pMemDesc));
 
@@ -3579,15 +3580,23 @@ nvGpuOpsBuildExternalAllocPtes
 
     //
     // Both memdescGetPhysAddr() and kgmmuEncodePhysAddr() have pretty high overhead.
-    // To avoid it, allocate an array for the physical addresses and use the
-    // flavors of the APIs that work on multiple addresses at a time.
+    // To avoid it, use an array for the physical addresses and the flavors of
+    // the APIs that work on multiple addresses at a time.
     //
-    // Notably the pteBuffer array could be re-used for that, but it gets a bit
-    // tricky if skipPteCount is greater than 1 so just keep it simple.
+    // With one NvU64 per PTE the pteBuffer array is used for that, as each
+    // PTE is written only after its address has been read. Otherwise keep it
+    // simple and allocate a separate array.
     //
-    physicalAddresses = portMemAllocNonPaged((NvU32)pteCount * sizeof(*physicalAddresses));
-    if (physicalAddresses == NULL)
-        return NV_ERR_NO_MEMORY;
+    if (skipPteCount == 1)
+    {
+        physicalAddresses = pGpuExternalMappingInfo->pteBuffer;
+    }
+    else
+    {
+        physicalAddresses = portMemAllocNonPaged((NvU32)pteCount * sizeof(*physicalAddresses));
+        if (physicalAddresses == NULL)
+            return NV_ERR_NO_MEMORY;
+    }
 
     //
     // Ask for physical addresses for the GPU being mapped as it may not be the
@@ -3639,11 +3648,28 @@ nvGpuOpsBuildExternalAllocPtes
             goto done;
     }
 
+    pAddrFld = gmmuFmtPtePhysAddrFld(pPteFmt, aperture);
+
+    //
+    // Only the address differs between the PTEs of a non-compressed mapping,
+    // so fill those without the per-PTE compression handling and copies.
+    //
+    if (!isCompressedKind && (skipPteCount == 1))
+    {
+        for (iter = 0; iter < pteCount; iter++)
+        {
+            gmmuFieldSetAddress(pAddrFld, physicalAddresses[iter], pte.v8);
+            pGpuExternalMappingInfo->pteBuffer[iter] = pte.v64[0];
+        }
+
+        goto ptes_written;
+    }
+
     for (iter = 0; iter < pteCount; iter++)
     {
         physAddr = physicalAddresses[iter];
 
-        gmmuFieldSetAddress(gmmuFmtPtePhysAddrFld(pPteFmt, aperture),
+        gmmuFieldSetAddress(pAddrFld,
                             physAddr,
                             pte.v8);
 
@@ -3704,12 +3730,14 @@ nvGpuOpsBuildExternalAllocPtes
         offset += mappingPageSize;
     }
 
+ptes_written:
     pGpuExternalMappingInfo->numWrittenPtes = pteCount;
     pGpuExternalMappingInfo->numRemainingPtes = (mappingSize / mappingPageSize) - pteCount;
     pGpuExternalMappingInfo->pteSize = pLevelFmt->entrySize;
 
 done:
-    portMemFree(physicalAddresses);
+    if (physicalAddresses != pGpuExternalMappingInfo->pteBuffer)
+        portMemFree(physicalAddresses);
 
     portMemFree(guestPhysicalAddress);
 
@@ -9816,6 +9844,8 @@ ct_assert(NV_OFFSETOF(UvmPmaStatistics, numFreePages2m) == NV_OFFSETOF(PMA_STATS
 ct_assert(NV_OFFSETOF(UvmPmaStatistics, numPages2mProtected) == NV_OFFSETOF(PMA_STATS, num2mbPagesProtected));
 ct_assert(NV_OFFSETOF(UvmPmaStatistics, numFreePages64kProtected) == NV_OFFSETOF(PMA_STATS, numFreeFramesProtected));
 ct_assert(NV_OFFSETOF(UvmPmaStatistics, numFreePages2mProtected) == NV_OFFSETOF(PMA_STATS, numFree2mbPagesProtected));
+ct_assert(NV_OFFSETOF(UvmPmaStatistics, numScrubPendingPages64k) == NV_OFFSETOF(PMA_STATS, numScrubPendingFrames));
+ct_assert(NV_OFFSETOF(UvmPmaStatistics, numScrubbedPages64k) == NV_OFFSETOF(PMA_STATS, numScrubbedFrames));
 
 /*!
  *  Retrieve the PMA (Physical Memory Allocator) object initialized by RM
@@ -50,6 +50,8 @@ typedef struct
     volatile NvU64      totalWaitTime;
     volatile NvU64      totalRwHoldTime;
     volatile NvU64      totalRoHoldTime;
+    RM_LOCK_PROF_SITE  *pWriteProfSite;  // Profiler site of the write owner
+    NvU64               profTlsEntryId;  // Profiler site of each owner
 } RMAPI_LOCK;
 
 RsServer          g_resServ;
@@ -537,6 +539,7 @@ _rmapiLockAlloc(void)
         return NV_ERR_INSUFFICIENT_RESOURCES;
 
     g_RmApiLock.tlsEntryId = tlsEntryAlloc();
+    g_RmApiLock.profTlsEntryId = tlsEntryAlloc();
 
     return NV_OK;
 }
@@ -547,8 +550,8 @@ _rmapiLockFree(void)
     portSyncRwLockDestroy(g_RmApiLock.pLock);
 }
 
-NV_STATUS
-rmapiLockAcquire(NvU32 flags, NvU32 module)
+static NV_STATUS
+_rmapiLockAcquire(NvU32 flags, NvU32 module, void *ra, NvU32 traceOp, NvU32 traceId)
 {
     OBJSYS *pSys = SYS_GET_INSTANCE();
     NV_STATUS rmStatus = NV_OK;
@@ -556,6 +559,8 @@ rmapiLockAcquire(NvU32 flags, NvU32 module)
 
     NvU64 myPriority = 0;
     NvU64 startWaitTime;
+    RM_LOCK_PROF_SITE *pProfSite = NULL;
+    RM_LOCK_PROF_SITE *pProfBlocker = NULL;
 
     // Make sure lock has been created
     NV_CHECK_OR_RETURN(LEVEL_ERROR, g_RmApiLock.pLock != NULL, NV_ERR_NOT_READY);
@@ -580,7 +585,17 @@ rmapiLockAcquire(NvU32 flags, NvU32 module)
 
     // Get start wait time measuring lock wait times
     if (pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
+    {
+        pProfSite = rmLockProfGetSite(RM_LOCK_PROF_LOCK_API, ra, traceOp, traceId);
+
+        //
+        // Only a write owner can be blamed for the wait. This is a racy read,
+        // the owner may be gone by the time we try to acquire.
+        //
+        pProfBlocker = g_RmApiLock.pWriteProfSite;
+
         osGetCurrentTick(&startWaitTime);
+    }
 
     //
     // For conditional acquires and DISPATCH_LEVEL we want to exit
@@ -650,17 +665,36 @@ rmapiLockAcquire(NvU32 flags, NvU32 module)
 
         // Update total API lock wait time if measuring lock times
         if (pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
+        {
             portAtomicExAddU64(&g_RmApiLock.totalWaitTime, timestamp - startWaitTime);
+            rmLockProfRecordWait(pProfSite, pProfBlocker, timestamp - startWaitTime);
+        }
 
         if (g_RmApiLock.threadId == threadId)
+        {
             g_RmApiLock.timestamp = timestamp;
+            g_RmApiLock.pWriteProfSite = pProfSite;
+        }
+
+        //
+        // Read owners are many, so the site to account the hold time to at
+        // release goes to TLS. Only taken when there is a site, which
+        // rmapiLockRelease knows from a non-NULL entry. Recursive read
+        // acquires take a reference but keep the site of the outermost one.
+        //
+        if (pProfSite != NULL)
+        {
+            NvP64 *pProfSiteEntry = tlsEntryAcquire(g_RmApiLock.profTlsEntryId);
+            if ((pProfSiteEntry != NULL) && (*pProfSiteEntry == NvP64_NULL))
+                *pProfSiteEntry = NV_PTR_TO_NvP64(pProfSite);
+        }
 
         // save off owning thread
         RMTRACE_RMLOCK(_API_LOCK_ACQUIRE);
 
         // add api lock trace record
         INSERT_LOCK_TRACE(&g_RmApiLock.traceInfo,
-                          NV_RETURN_ADDRESS(),
+                          ra,
                           lockTraceAcquire,
                           flags, module,
                           threadId,
@@ -695,6 +729,18 @@ rmapiLockAcquire(NvU32 flags, NvU32 module)
     return rmStatus;
 }
 
+NV_STATUS
+rmapiLockAcquire(NvU32 flags, NvU32 module)
+{
+    return _rmapiLockAcquire(flags, module, NV_RETURN_ADDRESS(), 0, 0);
+}
+
+NV_STATUS
+rmapiLockAcquireForOp(NvU32 flags, NvU32 module, NvU32 traceOp, NvU32 traceId)
+{
+    return _rmapiLockAcquire(flags, module, NV_RETURN_ADDRESS(), traceOp, traceId);
+}
+
 void
 rmapiLockRelease(void)
 {
@@ -702,10 +748,14 @@ rmapiLockRelease(void)
     NvU64 threadId = portThreadGetCurrentThreadId();
     NvU64 timestamp;
     NvU64 startTime = 0;
+    RM_LOCK_PROF_SITE *pProfSite = NULL;
 
-    // Fetch start of hold time from TLS if measuring lock times
+    // Fetch start of hold time and profiler site from TLS if measuring lock times
     if (pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
+    {
         startTime = (NvU64) tlsEntryGet(g_RmApiLock.tlsEntryId);
+        pProfSite = NvP64_VALUE(tlsEntryGet(g_RmApiLock.profTlsEntryId));
+    }
 
     osGetCurrentTick(&timestamp);
 
@@ -729,6 +779,7 @@ rmapiLockRelease(void)
         //
         g_RmApiLock.threadId  = ~0ull;
         g_RmApiLock.timestamp = timestamp;
+        g_RmApiLock.pWriteProfSite = NULL;
 
         // Update total RW API lock hold time if measuring lock times
         if (pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
@@ -746,6 +797,16 @@ rmapiLockRelease(void)
         portSyncRwLockReleaseRead(g_RmApiLock.pLock);
     }
 
+    //
+    // The hold is accounted to the site of the outermost acquire when its
+    // release drops the last reference.
+    //
+    if (pProfSite != NULL)
+    {
+        if ((tlsEntryRelease(g_RmApiLock.profTlsEntryId) == 0) && (startTime != 0))
+            rmLockProfRecordHold(pProfSite, timestamp - startTime);
+    }
+
     tlsEntryRelease(g_RmApiLock.tlsEntryId);
 }
 
@@ -63,6 +63,20 @@ MAKE_MAP(ObjectToGpuAttrMap, NvU64);
 //
 MAKE_MULTIMAP(GpusControlCache, RmapiControlCacheEntry);
 
+//
+// Lookup statistics of a cacheable control command. The slots are claimed
+// with an atomic compare and swap of cmd, 0 being a free slot, and are never
+// released, so they can be updated and read without the cache lock.
+//
+typedef struct
+{
+    volatile NvU32 cmd;
+    volatile NvU64 hits;
+    volatile NvU64 misses;
+} RmapiControlCacheStats;
+
+#define CACHE_STATS_MAX_CMDS 64
+
 ct_assert(sizeof(NvHandle) <= 4);
 
 #define CLIENT_KEY_SHIFT (sizeof(NvHandle) * 8)
@@ -107,6 +121,7 @@ static struct {
     /* NOTE: Size unbounded for now */
     GpusControlCache gpusControlCache;
     ObjectToGpuAttrMap objectToGpuAttrMap;
+    RmapiControlCacheStats stats[CACHE_STATS_MAX_CMDS];
     NvU32 mode;
     PORT_RWLOCK *pLock;
 } RmapiControlCache;
@@ -626,6 +641,61 @@ typedef struct GetInfoCacheEntry {
     NvU32 data;
 } GetInfoCacheEntry;
 
+//
+// Returns NV_TRUE if every cacheable index of pInfo is already cached. Lists
+// mixing cacheable and uncacheable indexes always miss the cache, and the
+// cache set that follows the control would otherwise take the exclusive lock
+// on every call and serialize all the cache readers.
+//
+static NvBool _getInfoCacheIsPopulated
+(
+    NvHandle hClient,
+    NvHandle hObject,
+    NvU32 cmd,
+    const NVXXXX_CTRL_XXX_INFO *pInfo,
+    NvU32 listSize,
+    NvU32 listSizeLimit
+)
+{
+    NvBool bPopulated = NV_FALSE;
+    NvU32 i;
+    NvU32 gpuInst;
+    NvU32 cacheGpuFlags;
+    RmapiControlCacheEntry *entry;
+    const GetInfoCacheEntry *cachedTable;
+
+    _cacheLockAcquire(LOCK_SHARED);
+
+    if (_cacheIsDisabled())
+        goto done;
+
+    if (_rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, &cacheGpuFlags) != NV_OK)
+        goto done;
+
+    entry = _getOrInitCacheEntry(gpuInst, cmd, NV_FALSE, 0, NULL);
+    if (entry == NULL || entry->params == NULL)
+        goto done;
+
+    cachedTable = (const GetInfoCacheEntry*)entry->params;
+
+    for (i = 0; i < listSize; ++i)
+    {
+        const NvU32 index = pInfo[i].index;
+
+        if (index >= listSizeLimit)
+            goto done;
+
+        if (_isGetInfoIndexCacheable(cmd, index, cacheGpuFlags) && !cachedTable[index].valid)
+            goto done;
+    }
+
+    bPopulated = NV_TRUE;
+
+done:
+    _cacheLockRelease(LOCK_SHARED);
+    return bPopulated;
+}
+
 static NV_STATUS _getInfoCacheHandler
 (
     NvHandle hClient,
@@ -651,6 +721,14 @@ static NV_STATUS _getInfoCacheHandler
         return NV_ERR_INVALID_PARAMETER;
     }
 
+    // The verify only mode needs the exclusive path to check the values
+    if (bSet &&
+        (RmapiControlCache.mode != NV0000_CTRL_SYSTEM_RMCTRL_CACHE_MODE_CTRL_MODE_VERIFY_ONLY) &&
+        _getInfoCacheIsPopulated(hClient, hObject, cmd, pInfo, listSize, listSizeLimit))
+    {
+        return NV_OK;
+    }
+
     _cacheLockAcquire(lockType);
 
     if (_cacheIsDisabled())
@@ -985,6 +1063,37 @@ NV_STATUS _rmapiControlCacheSetByInput
     }
 }
 
+static void _cacheStatsCount(RmapiControlCacheStats *pStats, NV_STATUS status)
+{
+    if (status == NV_OK)
+        portAtomicExIncrementU64(&pStats->hits);
+    else
+        portAtomicExIncrementU64(&pStats->misses);
+}
+
+//
+// Counts a cache lookup for cmd. Slots are claimed in order, so concurrent
+// first lookups of the same command all settle on the same slot.
+//
+static void _cacheStatsUpdate(NvU32 cmd, NV_STATUS status)
+{
+    NvU32 i;
+
+    for (i = 0; i < CACHE_STATS_MAX_CMDS; i++)
+    {
+        RmapiControlCacheStats *pStats = &RmapiControlCache.stats[i];
+
+        if (pStats->cmd == 0)
+            portAtomicCompareAndSwapU32(&pStats->cmd, cmd, 0);
+
+        if (pStats->cmd == cmd)
+        {
+            _cacheStatsCount(pStats, status);
+            return;
+        }
+    }
+}
+
 NV_STATUS rmapiControlCacheGet
 (
     NvHandle hClient,
@@ -1023,11 +1132,56 @@ NV_STATUS rmapiControlCacheGet
             goto done;
     }
 
+    _cacheStatsUpdate(cmd, status);
+
 done:
     NV_PRINTF(LEVEL_INFO, "control cache get for 0x%x 0x%x 0x%x status: 0x%x\n", hClient, hObject, cmd, status);
     return status;
 }
 
+//
+// Looks up a single cached index of a GET_INFO control, so that the control
+// handler can skip forwarding it to the physical RM even when the whole list
+// is not served from the cache.
+//
+NV_STATUS rmapiControlCacheGetInfoIndex
+(
+    NvHandle hClient,
+    NvHandle hObject,
+    NvU32 cmd,
+    NvU32 index,
+    NvU32 *pData
+)
+{
+    NV_STATUS status;
+    NvU32 listSizeLimit;
+    NVXXXX_CTRL_XXX_INFO info = { index, 0 };
+
+    if (RmapiControlCache.mode == NV0000_CTRL_SYSTEM_RMCTRL_CACHE_MODE_CTRL_MODE_VERIFY_ONLY)
+        return NV_ERR_OBJECT_NOT_FOUND;
+
+    switch (cmd)
+    {
+        case NV2080_CTRL_CMD_GPU_GET_INFO_V2:
+            listSizeLimit = NV2080_CTRL_GPU_INFO_MAX_LIST_SIZE;
+            break;
+        case NV2080_CTRL_CMD_FIFO_GET_INFO:
+            listSizeLimit = NV2080_CTRL_FIFO_GET_INFO_MAX_ENTRIES;
+            break;
+        case NV2080_CTRL_CMD_BUS_GET_INFO_V2:
+            listSizeLimit = NV2080_CTRL_BUS_INFO_MAX_LIST_SIZE;
+            break;
+        default:
+            return NV_ERR_INVALID_ARGUMENT;
+    }
+
+    status = _getInfoCacheHandler(hClient, hObject, cmd, &info, 1, listSizeLimit, NV_FALSE);
+    if (status == NV_OK)
+        *pData = info.data;
+
+    return status;
+}
+
 NV_STATUS rmapiControlCacheSet
 (
     NvHandle hClient,
@@ -1107,6 +1261,77 @@ void rmapiControlCacheFreeAllCacheForGpu
     _cacheLockRelease(LOCK_EXCLUSIVE);
 }
 
+//
+// Drops the cached values of the GPU for the controls flagged with
+// RMCTRL_FLAGS_CACHE_INVALIDATE_ON_GPU_CONFIG. Called when the configuration
+// they depend on changes, e.g. on MIG reconfiguration or NVLink link state
+// changes. The next control call refills the cache.
+//
+void rmapiControlCacheInvalidateGpuConfig
+(
+    NvU32 gpuInst
+)
+{
+    GpusControlCacheSubmap *submap;
+    GpusControlCacheIter it;
+    NvU32 flags;
+
+    _cacheLockAcquire(LOCK_EXCLUSIVE);
+
+    submap = multimapFindSubmap(&RmapiControlCache.gpusControlCache, gpuInst);
+    if (submap == NULL)
+        goto done;
+
+    it = multimapSubmapIterItems(&RmapiControlCache.gpusControlCache, submap);
+    while (multimapItemIterNext(&it))
+    {
+        RmapiControlCacheEntry *entry = it.pValue;
+        NvU32 cmd = (NvU32)multimapItemKey(&RmapiControlCache.gpusControlCache, entry);
+
+        if ((entry->params == NULL) ||
+            (rmapiutilGetControlInfo(cmd, &flags, NULL, NULL) != NV_OK) ||
+            !(flags & RMCTRL_FLAGS_CACHE_INVALIDATE_ON_GPU_CONFIG))
+        {
+            continue;
+        }
+
+        //
+        // Keep the entry, a cache get treats an entry without params as not
+        // cached and a cache set allocates them again.
+        //
+        portMemFree(entry->params);
+        entry->params = NULL;
+    }
+
+done:
+    _cacheLockRelease(LOCK_EXCLUSIVE);
+}
+
+NvU32 rmapiControlCacheGetStats
+(
+    RMAPI_CONTROL_CACHE_STATS *pStats,
+    NvU32 maxCount
+)
+{
+    NvU32 i;
+    NvU32 count = 0;
+
+    for (i = 0; (i < CACHE_STATS_MAX_CMDS) && (count < maxCount); i++)
+    {
+        const RmapiControlCacheStats *pSlot = &RmapiControlCache.stats[i];
+
+        if (pSlot->cmd == 0)
+            break;
+
+        pStats[count].cmd = pSlot->cmd;
+        pStats[count].hits = pSlot->hits;
+        pStats[count].misses = pSlot->misses;
+        count++;
+    }
+
+    return count;
+}
+
 void rmapiControlCacheFreeClientEntry(NvHandle hClient)
 {
     _cacheLockAcquire(LOCK_EXCLUSIVE);
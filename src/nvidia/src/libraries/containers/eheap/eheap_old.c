@@ -138,6 +138,306 @@ _eheapFreeMemStruct
     return NV_OK;
 }
 
+//
+// Free block index.
+//
+// Besides the address ordered free list, free blocks are kept in a treap
+// ordered by begin, where each node also records the size of the largest free
+// block in its subtree. eheapAlloc uses it to go straight to the next free
+// block in scan order that is big enough for the request, and _eheapBlockFree
+// to find where a freed block goes in the free list, instead of walking the
+// free list in both cases. The free list itself is kept as is for everything
+// else that walks it.
+//
+// Nodes only ever change size in place without changing their order relative
+// to the other free blocks, so resizing a free block just needs the subtree
+// maxima on its path refreshed with _eheapFreeTreeUpdate.
+//
+#define EHEAP_BLOCK_SIZE(b)     ((b)->end - (b)->begin + 1)
+#define EHEAP_FREE_TREE_SEED    0x2545F491
+
+static NvU32
+_eheapFreeTreeRandom
+(
+    OBJEHEAP *pHeap
+)
+{
+    NvU32 x = pHeap->freeTreeSeed;
+
+    // xorshift32
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pHeap->freeTreeSeed = x;
+
+    return x;
+}
+
+static void
+_eheapFreeTreeUpdateNode
+(
+    EMEMBLOCK *pNode
+)
+{
+    NvU64 maxSize = EHEAP_BLOCK_SIZE(pNode);
+
+    if ((pNode->freeLeft != NULL) && (pNode->freeLeft->freeMaxSize > maxSize))
+        maxSize = pNode->freeLeft->freeMaxSize;
+    if ((pNode->freeRight != NULL) && (pNode->freeRight->freeMaxSize > maxSize))
+        maxSize = pNode->freeRight->freeMaxSize;
+
+    pNode->freeMaxSize = maxSize;
+}
+
+// Split the subtree at pNode into the blocks below key and the rest.
+static void
+_eheapFreeTreeSplit
+(
+    EMEMBLOCK  *pNode,
+    NvU64       key,
+    EMEMBLOCK **ppLeft,
+    EMEMBLOCK **ppRight
+)
+{
+    if (pNode == NULL)
+    {
+        *ppLeft  = NULL;
+        *ppRight = NULL;
+        return;
+    }
+
+    if (pNode->begin < key)
+    {
+        _eheapFreeTreeSplit(pNode->freeRight, key, &pNode->freeRight, ppRight);
+        *ppLeft = pNode;
+    }
+    else
+    {
+        _eheapFreeTreeSplit(pNode->freeLeft, key, ppLeft, &pNode->freeLeft);
+        *ppRight = pNode;
+    }
+
+    _eheapFreeTreeUpdateNode(pNode);
+}
+
+// Join two subtrees, all blocks of pLeft being below those of pRight.
+static EMEMBLOCK *
+_eheapFreeTreeMerge
+(
+    EMEMBLOCK *pLeft,
+    EMEMBLOCK *pRight
+)
+{
+    if (pLeft == NULL)
+        return pRight;
+    if (pRight == NULL)
+        return pLeft;
+
+    if (pLeft->freePriority > pRight->freePriority)
+    {
+        pLeft->freeRight = _eheapFreeTreeMerge(pLeft->freeRight, pRight);
+        _eheapFreeTreeUpdateNode(pLeft);
+        return pLeft;
+    }
+
+    pRight->freeLeft = _eheapFreeTreeMerge(pLeft, pRight->freeLeft);
+    _eheapFreeTreeUpdateNode(pRight);
+    return pRight;
+}
+
+static EMEMBLOCK *
+_eheapFreeTreeInsertNode
+(
+    EMEMBLOCK *pNode,
+    EMEMBLOCK *pBlock
+)
+{
+    if (pNode == NULL)
+        return pBlock;
+
+    if (pBlock->freePriority > pNode->freePriority)
+    {
+        _eheapFreeTreeSplit(pNode, pBlock->begin, &pBlock->freeLeft, &pBlock->freeRight);
+        _eheapFreeTreeUpdateNode(pBlock);
+        return pBlock;
+    }
+
+    if (pBlock->begin < pNode->begin)
+        pNode->freeLeft = _eheapFreeTreeInsertNode(pNode->freeLeft, pBlock);
+    else
+        pNode->freeRight = _eheapFreeTreeInsertNode(pNode->freeRight, pBlock);
+
+    _eheapFreeTreeUpdateNode(pNode);
+    return pNode;
+}
+
+static EMEMBLOCK *
+_eheapFreeTreeRemoveNode
+(
+    EMEMBLOCK *pNode,
+    EMEMBLOCK *pBlock
+)
+{
+    if (pNode == NULL)
+    {
+        NV_ASSERT(0);
+        return NULL;
+    }
+
+    if (pNode == pBlock)
+    {
+        pNode = _eheapFreeTreeMerge(pBlock->freeLeft, pBlock->freeRight);
+        pBlock->freeLeft  = NULL;
+        pBlock->freeRight = NULL;
+        return pNode;
+    }
+
+    if (pBlock->begin < pNode->begin)
+        pNode->freeLeft = _eheapFreeTreeRemoveNode(pNode->freeLeft, pBlock);
+    else
+        pNode->freeRight = _eheapFreeTreeRemoveNode(pNode->freeRight, pBlock);
+
+    _eheapFreeTreeUpdateNode(pNode);
+    return pNode;
+}
+
+static void
+_eheapFreeTreeUpdatePath
+(
+    EMEMBLOCK *pNode,
+    EMEMBLOCK *pBlock
+)
+{
+    if (pNode == NULL)
+    {
+        NV_ASSERT(0);
+        return;
+    }
+
+    if (pNode != pBlock)
+    {
+        _eheapFreeTreeUpdatePath((pBlock->begin < pNode->begin) ? pNode->freeLeft : pNode->freeRight,
+                                 pBlock);
+    }
+
+    _eheapFreeTreeUpdateNode(pNode);
+}
+
+//
+// Find the lowest free block at or above key (or with bDown, the highest one
+// at or below key) that is at least size bytes.
+//
+static EMEMBLOCK *
+_eheapFreeTreeFind
+(
+    EMEMBLOCK *pNode,
+    NvU64      key,
+    NvU64      size,
+    NvBool     bDown
+)
+{
+    EMEMBLOCK *pFound;
+
+    if ((pNode == NULL) || (pNode->freeMaxSize < size))
+        return NULL;
+
+    if (!bDown)
+    {
+        if (pNode->begin < key)
+            return _eheapFreeTreeFind(pNode->freeRight, key, size, bDown);
+
+        pFound = _eheapFreeTreeFind(pNode->freeLeft, key, size, bDown);
+        if (pFound != NULL)
+            return pFound;
+        if (EHEAP_BLOCK_SIZE(pNode) >= size)
+            return pNode;
+        return _eheapFreeTreeFind(pNode->freeRight, key, size, bDown);
+    }
+    else
+    {
+        if (pNode->begin > key)
+            return _eheapFreeTreeFind(pNode->freeLeft, key, size, bDown);
+
+        pFound = _eheapFreeTreeFind(pNode->freeRight, key, size, bDown);
+        if (pFound != NULL)
+            return pFound;
+        if (EHEAP_BLOCK_SIZE(pNode) >= size)
+            return pNode;
+        return _eheapFreeTreeFind(pNode->freeLeft, key, size, bDown);
+    }
+}
+
+static void
+_eheapFreeTreeInsert
+(
+    OBJEHEAP  *pHeap,
+    EMEMBLOCK *pBlock
+)
+{
+    pBlock->freeLeft     = NULL;
+    pBlock->freeRight    = NULL;
+    pBlock->freeMaxSize  = EHEAP_BLOCK_SIZE(pBlock);
+    pBlock->freePriority = _eheapFreeTreeRandom(pHeap);
+
+    pHeap->pFreeBlockTree = _eheapFreeTreeInsertNode(pHeap->pFreeBlockTree, pBlock);
+}
+
+static void
+_eheapFreeTreeRemove
+(
+    OBJEHEAP  *pHeap,
+    EMEMBLOCK *pBlock
+)
+{
+    pHeap->pFreeBlockTree = _eheapFreeTreeRemoveNode(pHeap->pFreeBlockTree, pBlock);
+}
+
+static void
+_eheapFreeTreeUpdate
+(
+    OBJEHEAP  *pHeap,
+    EMEMBLOCK *pBlock
+)
+{
+    _eheapFreeTreeUpdatePath(pHeap->pFreeBlockTree, pBlock);
+}
+
+//
+// Return the next free block of at least size bytes after pBlockFree in
+// free list order, or in reverse free list order with bGrowsDown. Starts at
+// the first (last) free block if pBlockFree is NULL.
+//
+static EMEMBLOCK *
+_eheapFreeTreeNextFit
+(
+    OBJEHEAP  *pHeap,
+    EMEMBLOCK *pBlockFree,
+    NvU64      size,
+    NvBool     bGrowsDown
+)
+{
+    NvU64 key;
+
+    if (pBlockFree == NULL)
+    {
+        key = bGrowsDown ? NV_U64_MAX : 0;
+    }
+    else if (bGrowsDown)
+    {
+        if (pBlockFree->begin == 0)
+            return NULL;
+        key = pBlockFree->begin - 1;
+    }
+    else
+    {
+        if (pBlockFree->begin == NV_U64_MAX)
+            return NULL;
+        key = pBlockFree->begin + 1;
+    }
+
+    return _eheapFreeTreeFind(pHeap->pFreeBlockTree, key, size, bGrowsDown);
+}
+
 //
 // Create a heap.  Even though we can return error here the resultant
 // object must be self consistent (zero pointers, etc) if there were
@@ -170,6 +470,8 @@ eheapInit
     pHeap->pPreAllocAddr        = NULL;
     pHeap->pBlockList           = NULL;
     pHeap->pFreeBlockList       = NULL;
+    pHeap->pFreeBlockTree       = NULL;
+    pHeap->freeTreeSeed         = EHEAP_FREE_TREE_SEED;
     pHeap->pFreeMemStructList   = NULL;
     pHeap->numBlocks            = 0;
     pHeap->pBlockTree           = NULL;
@@ -226,6 +528,7 @@ eheapInit
     pHeap->pBlockList     = block;
     pHeap->pFreeBlockList = block;
     pHeap->numBlocks      = 1;
+    _eheapFreeTreeInsert(pHeap, block);
 
     portMemSet((void *)&block->node, 0, sizeof(NODE));
     block->node.keyStart = block->begin;
@@ -287,6 +590,7 @@ eheapDestruct
         portMemFree(pHeap->pBlockList);
         pHeap->pBlockList = NULL;
     }
+    pHeap->pFreeBlockTree = NULL;
 
     return NV_OK;
 }
@@ -308,11 +612,12 @@ eheapAlloc
 )
 {
     NvU64      allocLo, allocAl, allocHi;
-    EMEMBLOCK *blockFirstFree, *blockFree;
+    EMEMBLOCK *blockFree;
     EMEMBLOCK *blockNew = NULL, *blockSplit = NULL;
     NvU64      desiredOffset;
     NvU64      allocSize;
     NvU64      rangeLo, rangeHi;
+    NvBool     bGrowsDown;
 
     if ((*flags & NVOS32_ALLOC_FLAGS_FORCE_INTERNAL_INDEX) &&
         (*flags & NVOS32_ALLOC_FLAGS_FIXED_ADDRESS_ALLOCATE))
@@ -427,77 +732,63 @@ eheapAlloc
         if (desiredOffset % offsetAlign)
             goto failed;
 
-        blockFree = pHeap->pFreeBlockList;
-
-        if (blockFree == NULL)
-        {
-            goto failed;
-        }
+        //
+        // Only the free block containing the desired offset can satisfy the
+        // request, so look it up directly rather than scanning the free list.
+        //
+        blockFree = eheapGetBlock(pHeap, desiredOffset, NV_TRUE);
 
-        do
+        // Does this block contain our desired range?
+        if ( (blockFree != NULL) &&
+             (blockFree->owner == NVOS32_BLOCK_TYPE_FREE) &&
+             (desiredOffset + allocSize - 1) <= blockFree->end )
         {
             //
-            // Allocate from the bottom of the memory block.
+            // Make sure no allocated block between ALIGN_DOWN(allocLo, granularity)
+            // and ALIGN_UP(allocHi, granularity) have a different owner than the current allocation
             //
-            blockFree = blockFree->nextFree;
-
-            // Does this block contain our desired range?
-            if ( (desiredOffset >= blockFree->begin) &&
-                 (desiredOffset + allocSize - 1) <= blockFree->end )
+            if (pHeap->bOwnerIsolation)
             {
-                //
-                // Make sure no allocated block between ALIGN_DOWN(allocLo, granularity)
-                // and ALIGN_UP(allocHi, granularity) have a different owner than the current allocation
-                //
-                if (pHeap->bOwnerIsolation)
+                NV_ASSERT(NULL != checker);
+                if (!_eheapCheckOwnership(pHeap, pIsolationID, desiredOffset,
+                         desiredOffset + allocSize - 1, blockFree, checker))
                 {
-                    NV_ASSERT(NULL != checker);
-                    if (!_eheapCheckOwnership(pHeap, pIsolationID, desiredOffset,
-                             desiredOffset + allocSize - 1, blockFree, checker))
-                    {
-                        break;
-                    }
+                    goto failed;
                 }
-
-                // we have a match, now remove it from the pool
-                allocLo = desiredOffset;
-                allocHi = desiredOffset + allocSize - 1;
-                allocAl = allocLo;
-                goto got_one;
             }
 
-        } while (blockFree != pHeap->pFreeBlockList);
+            // we have a match, now remove it from the pool
+            allocLo = desiredOffset;
+            allocHi = desiredOffset + allocSize - 1;
+            allocAl = allocLo;
+            goto got_one;
+        }
 
         // return error if can't get that particular address
         goto failed;
     }
 
-    blockFirstFree = pHeap->pFreeBlockList;
-    if (!blockFirstFree)
-        goto failed;
-
     //
-    // When scanning upwards, start at the bottom - 1 so the following loop looks symmetric.
+    // Walk the free blocks bottom up (or top down when growing down), as the
+    // free list would be, but only visit the ones large enough to hold the
+    // request. Smaller blocks can never satisfy it.
     //
-    if ( *flags & NVOS32_ALLOC_FLAGS_FORCE_MEM_GROWS_DOWN ) {
-        blockFirstFree = blockFirstFree->prevFree;
-    }
-    blockFree = blockFirstFree;
-    do
+    bGrowsDown = !!(*flags & NVOS32_ALLOC_FLAGS_FORCE_MEM_GROWS_DOWN);
+    blockFree  = _eheapFreeTreeNextFit(pHeap, NULL, allocSize, bGrowsDown);
+    while (blockFree != NULL)
     {
         NvU64 blockLo;
         NvU64 blockHi;
 
         //
         // Is this block completely out of range?
+        // Every block after one past the end of the range is too.
         //
         if ( ( blockFree->end < rangeLo ) || ( blockFree->begin > rangeHi ) )
         {
-            if ( *flags & NVOS32_ALLOC_FLAGS_FORCE_MEM_GROWS_DOWN )
-                blockFree = blockFree->prevFree;
-            else
-                blockFree = blockFree->nextFree;
-            continue;
+            if (bGrowsDown ? (blockFree->end < rangeLo) : (blockFree->begin > rangeHi))
+                break;
+            goto next_free;
         }
 
         //
@@ -599,12 +890,8 @@ alloc_done:
         }
 
 next_free:
-        if ( *flags & NVOS32_ALLOC_FLAGS_FORCE_MEM_GROWS_DOWN )
-            blockFree = blockFree->prevFree;
-        else
-            blockFree = blockFree->nextFree;
-
-    } while (blockFree != blockFirstFree);
+        blockFree = _eheapFreeTreeNextFit(pHeap, blockFree, allocSize, bGrowsDown);
+    }
 
     //
     // Out of memory.
@@ -636,6 +923,7 @@ next_free:
             else
                 pHeap->pFreeBlockList = blockFree->nextFree;
         }
+        _eheapFreeTreeRemove(pHeap, blockFree);
 
         //
         // Set owner/type values here.  Don't move because some fields are unions.
@@ -697,6 +985,8 @@ next_free:
             blockSplit->prevFree = blockFree;
             blockSplit->nextFree->prevFree = blockSplit;
             blockFree->nextFree = blockSplit;
+            _eheapFreeTreeUpdate(pHeap, blockFree);
+            _eheapFreeTreeInsert(pHeap, blockSplit);
             //
             //  Insert new and split blocks into block list.
             //
@@ -750,6 +1040,7 @@ next_free:
             // New block inserted after free block.
             //
             blockFree->end = blockNew->begin - 1;
+            _eheapFreeTreeUpdate(pHeap, blockFree);
             blockNew->next = blockFree->next;
             blockNew->prev = blockFree;
             blockFree->next->prev = blockNew;
@@ -788,6 +1079,7 @@ next_free:
             //
             blockFree->begin = blockNew->end + 1;
             blockFree->align = blockFree->begin;
+            _eheapFreeTreeUpdate(pHeap, blockFree);
             blockNew->next   = blockFree;
             blockNew->prev   = blockFree->prev;
             blockFree->prev->next = blockNew;
@@ -845,6 +1137,7 @@ _eheapBlockFree
 )
 {
     EMEMBLOCK *blockTmp;
+    EMEMBLOCK *blockPrevFree;
 
     //
     // Check for valid owner.
@@ -887,6 +1180,7 @@ _eheapBlockFree
         block->prev->next = block->next;
         block->next->prev = block->prev;
         block->prev->end  = block->end;
+        _eheapFreeTreeUpdate(pHeap, block->prev);
         blockTmp = block;
         block    = block->prev;
         pHeap->numBlocks--;
@@ -917,6 +1211,8 @@ _eheapBlockFree
         //
         // Merge with next block.
         //
+        if (block->owner == NVOS32_BLOCK_TYPE_FREE)
+            _eheapFreeTreeRemove(pHeap, block);
         block->prev->next    = block->next;
         block->next->prev    = block->prev;
         block->next->begin   = block->begin;
@@ -933,6 +1229,7 @@ _eheapBlockFree
         block    = block->next;
         pHeap->numBlocks--;
         _eheapFreeMemStruct(pHeap, &blockTmp);
+        _eheapFreeTreeUpdate(pHeap, block);
 
         // re-insert updated free block into rb-tree
         block->node.keyStart = block->begin;
@@ -955,28 +1252,28 @@ _eheapBlockFree
         }
         else
         {
-            if (blockTmp->begin > block->begin)
+            //
+            // Find the closest free block below this one, if any.
+            //
+            blockPrevFree = (block->begin != 0) ?
+                _eheapFreeTreeFind(pHeap->pFreeBlockTree, block->begin - 1, 0, NV_TRUE) : NULL;
+
+            if (blockPrevFree == NULL)
                 //
                 // Insert into beginning of free list.
                 //
                 pHeap->pFreeBlockList = block;
-            else if (blockTmp->prevFree->begin > block->begin)
+            else
                 //
-                // Insert into free list.
+                // Insert into free list, possibly at its end.
                 //
-                do
-                {
-                    blockTmp = blockTmp->nextFree;
-                } while (blockTmp->begin < block->begin);
-                /*
-            else
-                 * Insert at end of list.
-                 */
+                blockTmp = blockPrevFree->nextFree;
             block->nextFree = blockTmp;
             block->prevFree = blockTmp->prevFree;
             block->prevFree->nextFree = block;
             blockTmp->prevFree           = block;
         }
+        _eheapFreeTreeInsert(pHeap, block);
     }
     block->owner   = NVOS32_BLOCK_TYPE_FREE;
     //block->mhandle = 0x0;
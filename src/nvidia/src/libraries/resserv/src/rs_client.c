@@ -74,6 +74,202 @@ static NV_STATUS _clientUnmapBackRefMappings(RsClient *pClient, CALL_CONTEXT *pC
 static void _clientUnmapInterMappings(RsClient *pClient, CALL_CONTEXT *pCallContext, RS_LOCK_INFO *pLockInfo);
 static void _clientUnmapInterBackRefMappings(RsClient *pClient, CALL_CONTEXT *pCallContext, RS_LOCK_INFO *pLockInfo);
 
+//
+// Smallest size of a client's resource index. Every client has at least a
+// handful of resources, so start with enough slots for those not to trigger a
+// resize.
+//
+#define RS_REF_INDEX_MIN_SLOTS 64
+
+static NvU32
+_refIndexSlot
+(
+    const RsRefIndex *pIndex,
+    NvHandle hResource
+)
+{
+    // Fibonacci hashing, so that handles differing only in high bits spread out
+    return (NvU32)(hResource * 0x9E3779B9U) >> pIndex->hashShift;
+}
+
+static void
+_refIndexInsertSlot
+(
+    RsRefIndex *pIndex,
+    RsResourceRef *pResourceRef
+)
+{
+    NvU32 mask = pIndex->slotCount - 1;
+    NvU32 i = _refIndexSlot(pIndex, pResourceRef->hResource);
+
+    while (pIndex->ppSlots[i] != NULL)
+        i = (i + 1) & mask;
+
+    pIndex->ppSlots[i] = pResourceRef;
+}
+
+static NV_STATUS
+_refIndexResize
+(
+    RsRefIndex *pIndex,
+    NvU32 slotCount
+)
+{
+    RsResourceRef **ppOldSlots = pIndex->ppSlots;
+    NvU32 oldSlotCount = pIndex->slotCount;
+    RsResourceRef **ppSlots;
+    NvU32 i;
+
+    ppSlots = PORT_ALLOC(pIndex->pAllocator, sizeof(*ppSlots) * slotCount);
+    if (ppSlots == NULL)
+        return NV_ERR_NO_MEMORY;
+
+    portMemSet(ppSlots, 0, sizeof(*ppSlots) * slotCount);
+
+    pIndex->ppSlots = ppSlots;
+    pIndex->slotCount = slotCount;
+    pIndex->hashShift = 32 - portUtilCountTrailingZeros32(slotCount);
+
+    for (i = 0; i < oldSlotCount; i++)
+    {
+        if (ppOldSlots[i] != NULL)
+            _refIndexInsertSlot(pIndex, ppOldSlots[i]);
+    }
+
+    if (ppOldSlots != NULL)
+        PORT_FREE(pIndex->pAllocator, ppOldSlots);
+
+    return NV_OK;
+}
+
+static void
+_refIndexDestroy
+(
+    RsRefIndex *pIndex
+)
+{
+    if (pIndex->ppSlots != NULL)
+        PORT_FREE(pIndex->pAllocator, pIndex->ppSlots);
+
+    pIndex->ppSlots = NULL;
+    pIndex->slotCount = 0;
+    pIndex->refCount = 0;
+}
+
+static void
+_refIndexInsert
+(
+    RsRefIndex *pIndex,
+    RsResourceRef *pResourceRef
+)
+{
+    if (pIndex->bDisabled)
+        return;
+
+    // Keep the load factor at or below 1/2 so probe sequences stay short
+    if ((pIndex->refCount + 1) * 2 > pIndex->slotCount)
+    {
+        NvU32 slotCount = NV_MAX(pIndex->slotCount * 2, RS_REF_INDEX_MIN_SLOTS);
+
+        if ((slotCount < pIndex->slotCount) ||
+            (_refIndexResize(pIndex, slotCount) != NV_OK))
+        {
+            //
+            // The resourceMap is still complete, so rather than failing the
+            // allocation, stop using the index for this client.
+            //
+            NV_PRINTF(LEVEL_WARNING, "Disabling the resource index of client 0x%08x\n",
+                      pResourceRef->pClient->hClient);
+            _refIndexDestroy(pIndex);
+            pIndex->bDisabled = NV_TRUE;
+            return;
+        }
+    }
+
+    _refIndexInsertSlot(pIndex, pResourceRef);
+    pIndex->refCount++;
+}
+
+static void
+_refIndexRemove
+(
+    RsRefIndex *pIndex,
+    RsResourceRef *pResourceRef
+)
+{
+    NvU32 mask = pIndex->slotCount - 1;
+    NvU32 i;
+    NvU32 j;
+
+    if (pIndex->bDisabled || (pIndex->slotCount == 0))
+        return;
+
+    i = _refIndexSlot(pIndex, pResourceRef->hResource);
+    while (pIndex->ppSlots[i] != pResourceRef)
+    {
+        if (pIndex->ppSlots[i] == NULL)
+        {
+            NV_ASSERT(0);
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+
+    //
+    // Backward shift deletion: move later entries of the probe sequence into
+    // the hole when their home slot allows it, so that no tombstones are
+    // needed and lookups can stop at the first empty slot.
+    //
+    for (j = (i + 1) & mask; pIndex->ppSlots[j] != NULL; j = (j + 1) & mask)
+    {
+        NvU32 home = _refIndexSlot(pIndex, pIndex->ppSlots[j]->hResource);
+
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            pIndex->ppSlots[i] = pIndex->ppSlots[j];
+            i = j;
+        }
+    }
+
+    pIndex->ppSlots[i] = NULL;
+    pIndex->refCount--;
+}
+
+/**
+ * Look up a resource reference of this client by handle
+ * @param[in] pClient This client
+ * @param[in] hResource The resource's handle
+ */
+static RsResourceRef *
+_clientFindResourceRef
+(
+    RsClient *pClient,
+    NvHandle hResource
+)
+{
+    RsRefIndex *pIndex = &pClient->resourceIndex;
+    RsResourceRef *pResourceRef;
+    NvU32 mask;
+    NvU32 i;
+
+    if (pIndex->bDisabled)
+        return mapFind(&pClient->resourceMap, hResource);
+
+    if (pIndex->slotCount == 0)
+        return NULL;
+
+    mask = pIndex->slotCount - 1;
+    for (i = _refIndexSlot(pIndex, hResource);
+         (pResourceRef = pIndex->ppSlots[i]) != NULL;
+         i = (i + 1) & mask)
+    {
+        if (pResourceRef->hResource == hResource)
+            return pResourceRef;
+    }
+
+    return NULL;
+}
+
 NV_STATUS
 clientConstruct_IMPL
 (
@@ -94,6 +290,8 @@ clientConstruct_IMPL
     pClient->hClient = pParams->hClient;
 
     mapInit(&pClient->resourceMap, pAllocator);
+    portMemSet(&pClient->resourceIndex, 0, sizeof(pClient->resourceIndex));
+    pClient->resourceIndex.pAllocator = pAllocator;
     listInitIntrusive(&pClient->pendingFreeList);
 
     listInit(&pClient->accessBackRefList, pAllocator);
@@ -321,6 +519,7 @@ void clientDestruct_IMPL
 {
     NV_ASSERT(mapCount(&pClient->resourceMap) == 0);
     mapDestroy(&pClient->resourceMap);
+    _refIndexDestroy(&pClient->resourceIndex);
 
     NV_ASSERT(listCount(&pClient->accessBackRefList) == 0);
     listDestroy(&pClient->accessBackRefList);
@@ -339,7 +538,7 @@ clientGetResource_IMPL
     RsResourceRef *pResourceRef;
     RsResource    *pResource;
 
-    pResourceRef = mapFind(&pClient->resourceMap, hResource);
+    pResourceRef = _clientFindResourceRef(pClient, hResource);
     if (pResourceRef == NULL)
     {
         status = NV_ERR_OBJECT_NOT_FOUND;
@@ -387,7 +586,7 @@ clientGetResourceRef_IMPL
 {
     RsResourceRef *pResourceRef;
 
-    pResourceRef = mapFind(&pClient->resourceMap, hResource);
+    pResourceRef = _clientFindResourceRef(pClient, hResource);
     if (pResourceRef == NULL)
         return NV_ERR_OBJECT_NOT_FOUND;
 
@@ -797,7 +996,7 @@ clientFreeResource_IMPL
     RsResourceRef  *pResourceRef;
     RsResource     *pResource;
 
-    pResourceRef = mapFind(&pClient->resourceMap, pParams->hResource);
+    pResourceRef = _clientFindResourceRef(pClient, pParams->hResource);
     if (pResourceRef == NULL)
         return NV_ERR_OBJECT_NOT_FOUND;
 
@@ -861,7 +1060,7 @@ done:
                 pResourceRef->internalClassId, pResourceRef->hResource);
         }
 
-        pClientRef = mapFind(&pClient->resourceMap, pClient->hClient);
+        pClientRef = _clientFindResourceRef(pClient, pClient->hClient);
         if (pClientRef != NULL)
             refUncacheRef(pClientRef, pResourceRef);
 
@@ -1040,6 +1239,8 @@ _clientConstructResourceRef
     pResourceRef->hResource = hResource;
     pResourceRef->depth = 0;
 
+    _refIndexInsert(&pClient->resourceIndex, pResourceRef);
+
     multimapInit(&pResourceRef->childRefMap, pAllocator);
     multimapInit(&pResourceRef->cachedRefMap, pAllocator);
     multimapInit(&pResourceRef->depRefMap, pAllocator);
@@ -1090,6 +1291,7 @@ clientDestructResourceRef_IMPL
     _refCleanupDependants(pResourceRef);
     multimapDestroy(&pResourceRef->depRefMap);
 
+    _refIndexRemove(&pClient->resourceIndex, pResourceRef);
     mapRemove(&pClient->resourceMap, pResourceRef);
 
     portAtomicExDecrementU64(&pServer->activeResourceCount);
@@ -223,6 +223,8 @@ NV_STATUS serverFreeResourceTreeUnderLock(RsServer *pServer, RS_RES_FREE_PARAMS
     RsResourceRef *pResourceRef = pFreeParams->pResourceRef;
     RS_LOCK_INFO *pLockInfo = pFreeParams->pLockInfo;
     NvU32 releaseFlags = 0;
+    NvU32 *pResReleaseFlags = (pFreeParams->pResLockReleaseFlags != NULL) ?
+                              pFreeParams->pResLockReleaseFlags : &releaseFlags;
 
     NV_ASSERT_OR_RETURN(pResourceRef != NULL, NV_ERR_INVALID_OBJECT_HANDLE);
 
@@ -249,14 +251,15 @@ NV_STATUS serverFreeResourceTreeUnderLock(RsServer *pServer, RS_RES_FREE_PARAMS
         pLockInfo->flags |= RS_LOCK_FLAGS_FREE_SESSION_LOCK;
         pLockInfo->traceOp = RS_LOCK_TRACE_FREE;
         pLockInfo->traceClassId = pResourceRef->externalClassId;
-        status = serverResLock_Prologue(pServer, LOCK_ACCESS_WRITE, pLockInfo, &releaseFlags);
+        status = serverResLock_Prologue(pServer, LOCK_ACCESS_WRITE, pLockInfo, pResReleaseFlags);
         if (status != NV_OK)
             goto done;
 
         status = clientFreeResource(pResourceRef->pClient, pServer, pFreeParams);
         NV_ASSERT(status == NV_OK);
 
-        serverResLock_Epilogue(pServer, LOCK_ACCESS_WRITE, pLockInfo, &releaseFlags);
+        if (pFreeParams->pResLockReleaseFlags == NULL)
+            serverResLock_Epilogue(pServer, LOCK_ACCESS_WRITE, pLockInfo, &releaseFlags);
     }
 
 done:
@@ -512,6 +515,8 @@ _serverFreeClient_underlock
     if (pClient->bDisabled)
     {
         portSyncSpinlockAcquire(pServer->pDisabledClientListLock);
+        if (pServer->pNextDisabledClient == pClient)
+            pServer->pNextDisabledClient = listNext(&pServer->disabledClientList, pClient);
         listRemove(&pServer->disabledClientList, pClient);
         portSyncSpinlockRelease(pServer->pDisabledClientListLock);
     }
@@ -750,6 +755,8 @@ serverAllocResource
     if (status != NV_OK)
         goto done;
 
+    pLockInfo->traceOp = RS_LOCK_TRACE_ALLOC;
+    pLockInfo->traceClassId = pParams->externalClassId;
     if ((status = serverTopLock_Prologue(pServer, topLockAccess, pLockInfo, &releaseFlags)) != NV_OK)
         goto done;
 
@@ -1012,11 +1019,17 @@ serverMarkClientListDisabled
     return NV_OK;
 }
 
-// Returns pServer->pNextDisabledClient and advances it by one node ahead
+//
+// Returns the first disabled client, starting at pServer->pNextDisabledClient,
+// that isn't being freed by another thread, claims it and advances
+// pServer->pNextDisabledClient one node past it.
+//
 static RsClient *
 _getNextDisabledClient(RsServer *pServer)
 {
     RsClient *pClient;
+    NvU32 count;
+
     portSyncSpinlockAcquire(pServer->pDisabledClientListLock);
 
     pClient =
@@ -1024,6 +1037,21 @@ _getNextDisabledClient(RsServer *pServer)
             pServer->pNextDisabledClient :
             listHead(&pServer->disabledClientList);
 
+    for (count = listCount(&pServer->disabledClientList);
+         (pClient != NULL) && pClient->bFreeClaimed && (count > 0);
+         count--)
+    {
+        pClient = listNext(&pServer->disabledClientList, pClient);
+        if (pClient == NULL)
+            pClient = listHead(&pServer->disabledClientList);
+    }
+
+    if ((pClient != NULL) && pClient->bFreeClaimed)
+        pClient = NULL;
+
+    if (pClient != NULL)
+        pClient->bFreeClaimed = NV_TRUE;
+
     pServer->pNextDisabledClient =
         (pClient != NULL) ?
             listNext(&pServer->disabledClientList, pClient) :
@@ -1033,6 +1061,31 @@ _getNextDisabledClient(RsServer *pServer)
     return pClient;
 }
 
+//
+// Drops the claim taken by _getNextDisabledClient, if the client wasn't freed.
+// The client is looked up by handle as it may no longer exist.
+//
+static void
+_putDisabledClient(RsServer *pServer, NvHandle hClient)
+{
+    RsClient *pClient;
+
+    portSyncSpinlockAcquire(pServer->pDisabledClientListLock);
+
+    for (pClient = listHead(&pServer->disabledClientList);
+         pClient != NULL;
+         pClient = listNext(&pServer->disabledClientList, pClient))
+    {
+        if (pClient->hClient == hClient)
+        {
+            pClient->bFreeClaimed = NV_FALSE;
+            break;
+        }
+    }
+
+    portSyncSpinlockRelease(pServer->pDisabledClientListLock);
+}
+
 NV_STATUS serverFreeDisabledClients
 (
     RsServer *pServer,
@@ -1047,14 +1100,10 @@ NV_STATUS serverFreeDisabledClients
     NV_STATUS status = NV_OK;
 
     //
-    // Only allow one instance of this function at a time.
-    // Multiple calls can happen if one thread requested delayed free via worker,
-    // while another tries to flush disabled clients immediately.
-    // It doesn't matter which one ends up running, they all free everything
+    // Multiple calls can run at once, e.g. delayed free workers and a thread
+    // flushing disabled clients immediately. Each client is claimed by one of
+    // them at a time in _getNextDisabledClient.
     //
-    static volatile NvU32 inProgress;
-    if (!portAtomicCompareAndSwapU32(&inProgress, 1, 0))
-        return NV_ERR_IN_USE;
 
     portMemSet(&params,   0, sizeof(params));
     portMemSet(&secInfo,  0, sizeof(secInfo));
@@ -1089,6 +1138,8 @@ NV_STATUS serverFreeDisabledClients
 
         serverFreeResourceTree(pServer, &params);
 
+        _putDisabledClient(pServer, params.hClient);
+
         //
         // If limit is 0, it'll wrap-around and count down from 0xFFFFFFFF
         // But RS_CLIENT_HANDLE_MAX is well below that, so it effectively
@@ -1101,11 +1152,39 @@ NV_STATUS serverFreeDisabledClients
         }
     }
 
-    portAtomicSetU32(&inProgress, 0);
     return status;
 }
 
 
+//
+// Maximum number of resources freed back to back under one acquisition of the
+// resource lock while tearing down a client. This bounds how long other
+// threads wait on that lock.
+//
+#define RS_FREE_BATCH_MAX_RESOURCES 32
+
+/**
+ * Release the resource lock held across a batch of frees, if any
+ * @param[in]    pServer
+ * @param[inout] pLockInfo Lock state
+ * @param[inout] pBatchReleaseFlags Flags indicating the locks held by the batch
+ * @param[inout] pBatchCount Number of resources freed in the batch
+ */
+static void
+_serverFreeBatchEnd
+(
+    RsServer *pServer,
+    RS_LOCK_INFO *pLockInfo,
+    NvU32 *pBatchReleaseFlags,
+    NvU32 *pBatchCount
+)
+{
+    if (*pBatchReleaseFlags != 0)
+        serverResLock_Epilogue(pServer, LOCK_ACCESS_WRITE, pLockInfo, pBatchReleaseFlags);
+
+    *pBatchCount = 0;
+}
+
 NV_STATUS
 serverFreeResourceTree
 (
@@ -1127,6 +1206,11 @@ serverFreeResourceTree
     NvU32               initialLockState;
     NvU32               releaseFlags = 0;
     LOCK_ACCESS_TYPE    topLockAccess;
+    NvBool              bBatchFree;
+    RsResourceRef      *pBatchContextRef = NULL;
+    NvU32               batchLockFlags = 0;
+    NvU32               batchReleaseFlags = 0;
+    NvU32               batchCount = 0;
 
     if (!pServer->bConstructed)
         return NV_ERR_NOT_READY;
@@ -1142,6 +1226,9 @@ serverFreeResourceTree
     if (status != NV_OK)
         goto done;
 
+    // The class is only known once the client is locked
+    pLockInfo->traceOp = RS_LOCK_TRACE_FREE;
+    pLockInfo->traceClassId = 0;
     status = serverTopLock_Prologue(pServer, topLockAccess, pLockInfo, &releaseFlags);
     if (status != NV_OK)
         goto done;
@@ -1245,15 +1332,30 @@ serverFreeResourceTree
         NV_PRINTF(LEVEL_INFO, "PENDING FREE LIST END (0x%x)\n", pClient->hClient);
     }
 
+    //
+    // When a whole client is torn down, its resources are freed in dependency
+    // order off the pending free list. Consecutive resources that share a
+    // parent and need the same locks are freed under a single acquisition of
+    // the resource lock instead of taking and dropping it for each of them.
+    // Resources locking a session are not batched, since the session lock is
+    // taken before the resource lock.
+    //
+    bBatchFree = (pParams->hClient == pParams->hResource) && !bRecursive &&
+                 !pParams->bInvalidateOnly;
+
     while ((pTargetRef = listHead(&pClient->pendingFreeList)) != NULL)
     {
         NvBool bInvalidateOnly = NV_TRUE;
         RS_FREE_STACK *pFs = &freeStack;
         RS_RES_FREE_PARAMS_INTERNAL freeParams;
         NvHandle hTarget = pTargetRef->hResource;
+        NvBool bBatchTarget = NV_FALSE;
 
         if (bHiPriOnly && pTargetRef == pFirstLowPriRef)
+        {
+            _serverFreeBatchEnd(pServer, pLockInfo, &batchReleaseFlags, &batchCount);
             goto done;
+        }
 
         if (pServer->bDebugFreeList)
         {
@@ -1262,6 +1364,8 @@ serverFreeResourceTree
 
         if (hTarget == pParams->hResource)
         {
+            _serverFreeBatchEnd(pServer, pLockInfo, &batchReleaseFlags, &batchCount);
+
             // Target resource should always be the last one to be freed
             NV_ASSERT((listCount(&pClient->pendingFreeList) == 1) || bRecursive);
             status = serverFreeResourceTreeUnderLock(pServer, pParams);
@@ -1283,6 +1387,31 @@ serverFreeResourceTree
         freeParams.pResourceRef = pTargetRef;
         freeParams.bInvalidateOnly = bInvalidateOnly;
         freeParams.pSecInfo = pParams->pSecInfo;
+
+        if (bBatchFree && (pTargetRef->pResource != NULL) &&
+            (pTargetRef->pSession == NULL) && (pTargetRef->pDependantSession == NULL) &&
+            (serverUpdateLockFlagsForFree(pServer, &freeParams) == NV_OK))
+        {
+            bBatchTarget = NV_TRUE;
+        }
+
+        if ((batchCount != 0) &&
+            (!bBatchTarget ||
+             (pLockInfo->pContextRef != pBatchContextRef) ||
+             (pLockInfo->flags != batchLockFlags) ||
+             (batchCount >= RS_FREE_BATCH_MAX_RESOURCES)))
+        {
+            _serverFreeBatchEnd(pServer, pLockInfo, &batchReleaseFlags, &batchCount);
+        }
+
+        if (bBatchTarget)
+        {
+            pBatchContextRef = pLockInfo->pContextRef;
+            batchLockFlags = pLockInfo->flags;
+            freeParams.pResLockReleaseFlags = &batchReleaseFlags;
+            batchCount++;
+        }
+
         status = serverFreeResourceTreeUnderLock(pServer, &freeParams);
         NV_ASSERT(status == NV_OK);
 
@@ -1295,6 +1424,8 @@ serverFreeResourceTree
         }
     }
 
+    _serverFreeBatchEnd(pServer, pLockInfo, &batchReleaseFlags, &batchCount);
+
     if (bPopFreeStack)
     {
         pClient->pFreeStack = freeStack.pPrev;
@@ -1395,6 +1526,8 @@ serverControl
             goto done;
     }
 
+    pLockInfo->traceOp = RS_LOCK_TRACE_CTRL;
+    pLockInfo->traceClassId = pParams->cmd;
     status = serverTopLock_Prologue(pServer, access, pLockInfo, &releaseFlags);
     if (status != NV_OK)
         goto done;